@@ -0,0 +1,466 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_ASSET_ASSETMANAGER_HPP
+#define MOLTEN_CORE_ASSET_ASSETMANAGER_HPP
+
+#include "Molten/FileFormat/Image/ImageLoader.hpp"
+#include "Molten/FileFormat/Mesh/MeshCacheFile.hpp"
+#include "Molten/Renderer/Shader/Spirv/SpirvModule.hpp"
+#include "Molten/System/FileWatcher.hpp"
+#include "Molten/System/Result.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace Molten
+{
+
+    class ThreadPool;
+
+
+    /** Loading state of asset. */
+    enum class AssetState : uint8_t
+    {
+        Loading,
+        Loaded,
+        Failed
+    };
+
+    /** Font asset, data of a TrueType or OpenType font file. Files on disk are memory mapped. */
+    struct FontAsset
+    {
+        VirtualFile file;
+    };
+
+    /** Shader asset, SPIR-V module read from a binary shader file. */
+    struct ShaderAsset
+    {
+        Shader::Spirv::Words words;
+    };
+
+    /** Loaded asset or error message. */
+    template<typename TAsset>
+    using AssetLoadResult = Result<std::shared_ptr<const TAsset>, std::string>;
+
+    /** Context of a running asset load. */
+    class MOLTEN_API AssetLoadContext
+    {
+
+    public:
+
+        /** Constructor. Progress reported via SetProgress is ignored. */
+        AssetLoadContext();
+
+        /** Constructor, by providing the progress variable updated by SetProgress. */
+        explicit AssetLoadContext(std::atomic<double>& progress);
+
+        /** Adds file the loaded asset depends on, besides its own file. 
+         *  Hot reloaded assets are reloaded if their own file or any of their dependencies is modified.
+         */
+        void AddDependency(const std::filesystem::path& filename);
+
+        /** Get files added via AddDependency. */
+        [[nodiscard]] const std::vector<std::filesystem::path>& GetDependencies() const;
+
+        /** Reports progress of load, between 0.0 and 1.0, see AssetHandle::GetProgress. May be called from any thread. */
+        void SetProgress(const double progress);
+
+    private:
+
+        std::vector<std::filesystem::path> m_dependencies;
+        std::atomic<double>* m_progress;
+
+    };
+
+    /** Function loading asset of file. Invoked on background workers, so it must be thread safe,
+     *  and it must not block waiting for other background work of the same thread pool, such as ThreadPool::Execute does.
+     */
+    template<typename TAsset>
+    using AssetLoadFunction = std::function<AssetLoadResult<TAsset>(const std::filesystem::path& filename, AssetLoadContext& context)>;
+
+
+    /** Shared state of an asset, referenced by all handles of the asset.
+     *  The asset is loaded once, and then only reloaded by its manager if hot reload is enabled.
+     */
+    class MOLTEN_API AssetEntryBase
+    {
+
+    public:
+
+        explicit AssetEntryBase(std::filesystem::path filename);
+        virtual ~AssetEntryBase() = default;
+
+        AssetEntryBase(const AssetEntryBase&) = delete;
+        AssetEntryBase(AssetEntryBase&&) = delete;
+        AssetEntryBase& operator = (const AssetEntryBase&) = delete;
+        AssetEntryBase& operator = (AssetEntryBase&&) = delete;
+
+        /** Get normalized filename of asset. */
+        [[nodiscard]] const std::filesystem::path& GetFilename() const;
+
+        /** Get loading state of asset. */
+        [[nodiscard]] AssetState GetState() const;
+
+        /** Get error message of last failed load or reload, or empty string if none failed. */
+        [[nodiscard]] std::string GetError() const;
+
+        /** Get version of asset, incremented every time a reloaded asset replaces the current one. */
+        [[nodiscard]] uint32_t GetVersion() const;
+
+        /** Get progress of first load, between 0.0 and 1.0. Loads not reporting progress stay at 0.0 until loaded or failed. */
+        [[nodiscard]] double GetProgress() const;
+
+        /** Loads asset on calling thread, unless loading already is started.
+         *
+         * @return true if asset was loaded by this call.
+         */
+        bool TryLoad();
+
+        /** Blocks until asset is loaded or failed. Loads asset on calling thread if loading is not yet started. */
+        void Wait();
+
+    protected:
+
+        /** Loads asset, without replacing the current one. @return Error message if failed. */
+        [[nodiscard]] virtual std::optional<std::string> Load(AssetLoadContext& context) = 0;
+
+        /** Replaces current asset by the asset of last successful call to Load. */
+        virtual void ApplyLoad() = 0;
+
+    private:
+
+        friend class AssetManager;
+
+        /** Loads asset again, without replacing the current one. Called by asset manager once the asset is loaded or failed. */
+        void Reload();
+
+        /** Checks if reload is finished. */
+        [[nodiscard]] bool IsReloadFinished() const;
+
+        /** Replaces current asset and dependencies by the reloaded ones, if reload succeeded. Called by asset manager at frame boundary. */
+        void ApplyReload();
+
+        const std::filesystem::path m_filename;
+        std::atomic<AssetState> m_state;
+        std::atomic_bool m_started;
+        std::atomic_bool m_reloadFinished;
+        std::atomic_uint32_t m_version;
+        std::atomic<double> m_progress;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::string m_error;
+        std::vector<std::filesystem::path> m_dependencies; ///< Dependencies of current asset, valid once loaded or failed.
+        std::optional<std::string> m_reloadError;
+        std::vector<std::filesystem::path> m_reloadDependencies;
+        std::vector<std::string> m_watchedFilenames; ///< Files watched by asset manager for this asset, guarded by the mutex of the manager.
+
+    };
+
+    /** Shared state of an asset of specific type. */
+    template<typename TAsset>
+    class AssetEntry : public AssetEntryBase
+    {
+
+    public:
+
+        AssetEntry(std::filesystem::path filename, AssetLoadFunction<TAsset> loadFunction);
+
+        /** Get current asset, or nullptr if not loaded. */
+        [[nodiscard]] std::shared_ptr<const TAsset> GetAsset() const;
+
+    protected:
+
+        [[nodiscard]] std::optional<std::string> Load(AssetLoadContext& context) override;
+
+        void ApplyLoad() override;
+
+    private:
+
+        AssetLoadFunction<TAsset> m_loadFunction;
+        std::shared_ptr<const TAsset> m_asset; ///< Accessed atomically, since reloaded assets are swapped in while handles may read it.
+        std::shared_ptr<const TAsset> m_loadedAsset;
+
+    };
+
+
+    /** Typed, ref-counted handle of an asset loaded by AssetManager.
+     *  All handles of the same asset share its state, and the asset is released as soon as its last handle is destroyed.
+     *  Handles are cheap to copy and may be used from any thread.
+     *  Hot reloaded assets are replaced by AssetManager::Update, so pointers returned by Get are only valid until next update,
+     *  while assets of GetShared are kept alive.
+     */
+    template<typename TAsset>
+    class AssetHandle
+    {
+
+    public:
+
+        /** Constructs an empty handle, not referencing any asset. */
+        AssetHandle() = default;
+
+        /** Checks if handle references an asset. */
+        /**@{*/
+        [[nodiscard]] bool IsValid() const;
+        [[nodiscard]] explicit operator bool() const;
+        /**@}*/
+
+        /** Get loading state of asset. Handle must be valid. */
+        [[nodiscard]] AssetState GetState() const;
+
+        /** Checks if asset is loaded or failed loading. Handle must be valid. */
+        [[nodiscard]] bool IsReady() const;
+
+        /** Blocks until asset is loaded or failed, loading it on calling thread if it is still queued. Handle must be valid.
+         *
+         * @return Pointer to asset, or nullptr if loading failed.
+         */
+        const TAsset* Wait() const;
+
+        /** Get asset, or nullptr if not loaded. Never blocks. */
+        [[nodiscard]] const TAsset* Get() const;
+
+        /** Get shared pointer of asset, keeping it alive independent of handles, or nullptr if not loaded. */
+        [[nodiscard]] std::shared_ptr<const TAsset> GetShared() const;
+
+        /** Get error message of last failed load or reload. Failed reloads keep the current asset. Handle must be valid. */
+        [[nodiscard]] std::string GetError() const;
+
+        /** Get version of asset, incremented every time a hot reloaded asset replaces the current one. Handle must be valid. */
+        [[nodiscard]] uint32_t GetVersion() const;
+
+        /** Get progress of first load of asset, between 0.0 and 1.0, see AssetLoadContext::SetProgress. Handle must be valid. */
+        [[nodiscard]] double GetProgress() const;
+
+        /** Get normalized filename of asset. Handle must be valid. */
+        [[nodiscard]] const std::filesystem::path& GetFilename() const;
+
+        /** Releases reference of this handle. */
+        void Reset();
+
+        /** Checks if handles reference the same asset. */
+        /**@{*/
+        [[nodiscard]] bool operator == (const AssetHandle& rhs) const;
+        [[nodiscard]] bool operator != (const AssetHandle& rhs) const;
+        /**@}*/
+
+    private:
+
+        friend class AssetManager;
+
+        explicit AssetHandle(std::shared_ptr<AssetEntry<TAsset>> entry);
+
+        std::shared_ptr<AssetEntry<TAsset>> m_entry;
+
+    };
+
+
+    /** Asynchronous asset manager, loading assets on background workers of a thread pool.
+     *  Assets are identified by type and normalized filename.
+     *  Concurrent loads of the same asset share one in-flight load and return handles of the same asset,
+     *  and assets are released when their last handle is destroyed.
+     *  Loaders of meshes, textures, fonts and shaders are registered by default and may be replaced via SetLoader.
+     *
+     *  If hot reload is enabled, modified asset files are detected via FileWatcher and reloaded in the background,
+     *  together with all assets depending on them, such as meshes of modified material files.
+     *  Reloaded assets replace the current ones at the next call to Update, so the swap happens at frame boundary.
+     *
+     *  All functions are thread safe.
+     */
+    class MOLTEN_API AssetManager
+    {
+
+    public:
+
+        using MeshHandle = AssetHandle<MeshCacheFile>;
+        using TextureHandle = AssetHandle<Image>;
+        using FontHandle = AssetHandle<FontAsset>;
+        using ShaderHandle = AssetHandle<ShaderAsset>;
+
+        static constexpr ImageFormat TextureFormat = ImageFormat::URed8Green8Blue8Alpha8; ///< Format of textures loaded by default loader.
+
+        /** Constructor. The thread pool must outlive the manager. */
+        explicit AssetManager(ThreadPool& threadPool);
+
+        /** Destructor. Blocks until running loads are finished.
+         *  Queued loads not yet started are instead loaded by AssetHandle::Wait of handles outliving the manager.
+         */
+        ~AssetManager();
+
+        AssetManager(const AssetManager&) = delete;
+        AssetManager(AssetManager&&) = delete;
+        AssetManager& operator = (const AssetManager&) = delete;
+        AssetManager& operator = (AssetManager&&) = delete;
+
+        /** Set load function of asset type, used by following loads of that type. */
+        template<typename TAsset>
+        void SetLoader(AssetLoadFunction<TAsset> loadFunction);
+
+        /** Get handle of asset of file, queueing it for loading unless it already is loaded or being loaded. Never blocks. */
+        template<typename TAsset>
+        [[nodiscard]] AssetHandle<TAsset> Load(const std::filesystem::path& filename);
+
+        /** Get handle of asset of file, of the default asset types. */
+        /**@{*/
+        [[nodiscard]] MeshHandle LoadMesh(const std::filesystem::path& filename);
+        [[nodiscard]] TextureHandle LoadTexture(const std::filesystem::path& filename);
+        [[nodiscard]] FontHandle LoadFont(const std::filesystem::path& filename);
+        [[nodiscard]] ShaderHandle LoadShader(const std::filesystem::path& filename);
+        /**@}*/
+
+        /** Enables or disables hot reload of modified assets. Disabled by default.
+         *
+         * @return false if hot reload is not supported on this platform, see FileWatcher.
+         */
+        bool SetHotReloadEnabled(const bool enabled);
+
+        /** Checks if hot reload is enabled. */
+        [[nodiscard]] bool IsHotReloadEnabled() const;
+
+        /** Replaces assets by finished reloads, queues reloads of modified assets, hands queued loads to free background workers
+         *  and forgets released assets. Should be called once per frame, at frame boundary.
+         */
+        void Update();
+
+        /** Blocks until all queued and running loads are finished, loading queued assets on calling thread. */
+        void WaitForLoads();
+
+        /** Get number of assets referenced by any handle. */
+        [[nodiscard]] size_t GetAssetCount() const;
+
+        /** Get number of queued loads, not yet started. */
+        [[nodiscard]] size_t GetQueuedLoadCount() const;
+
+        /** Default load functions. Meshes are imported in parallel on free background workers of provided thread pool,
+         *  report their import progress and depend on their material files.
+         */
+        /**@{*/
+        [[nodiscard]] static AssetLoadResult<MeshCacheFile> LoadMeshFile(
+            const std::filesystem::path& filename,
+            AssetLoadContext& context,
+            ThreadPool& threadPool);
+        [[nodiscard]] static AssetLoadResult<Image> LoadTextureFile(const std::filesystem::path& filename, AssetLoadContext& context);
+        [[nodiscard]] static AssetLoadResult<FontAsset> LoadFontFile(const std::filesystem::path& filename, AssetLoadContext& context);
+        [[nodiscard]] static AssetLoadResult<ShaderAsset> LoadShaderFile(const std::filesystem::path& filename, AssetLoadContext& context);
+        /**@}*/
+
+        /** Get normalized absolute filename, identifying assets of file. */
+        [[nodiscard]] static std::filesystem::path NormalizeFilename(const std::filesystem::path& filename);
+
+    private:
+
+        struct Key
+        {
+            std::type_index type;
+            std::string filename;
+
+            bool operator == (const Key& rhs) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct LoaderBase
+        {
+            virtual ~LoaderBase() = default;
+        };
+
+        template<typename TAsset>
+        struct Loader : LoaderBase
+        {
+            explicit Loader(AssetLoadFunction<TAsset> function);
+
+            AssetLoadFunction<TAsset> function;
+        };
+
+        struct QueuedLoad
+        {
+            std::weak_ptr<AssetEntryBase> entry;
+            bool reload;
+        };
+
+        struct Reload
+        {
+            std::weak_ptr<AssetEntryBase> entry;
+            bool queued;
+            bool reloadAgain; ///< Files of asset were modified again while reloading.
+        };
+
+        /** Hands queued loads to free background workers. m_mutex must be locked. */
+        void ScheduleLoads();
+
+        /** Runs queued loads until queue is empty. Executed by background workers. */
+        void RunQueuedLoads();
+
+        /** Pops next queued load of a still referenced asset and runs it. m_mutex must be locked by lock, and is unlocked while loading.
+         *
+         * @return false if no load is queued.
+         */
+        bool RunNextQueuedLoad(std::unique_lock<std::mutex>& lock);
+
+        /** Replaces assets by finished reloads. m_mutex must be locked. */
+        void ApplyReloads();
+
+        /** Watches dependencies of loaded assets and queues reloads of modified assets. m_mutex must be locked. */
+        void UpdateHotReload();
+
+        /** Watches file and dependencies of asset, replacing previously watched files of asset. m_mutex must be locked. */
+        void WatchEntry(const std::shared_ptr<AssetEntryBase>& entry);
+
+        /** Removes released assets from watched files, and stops watching files without any assets. m_mutex must be locked. */
+        void RemoveReleasedWatches();
+
+        ThreadPool& m_threadPool;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_idleCondition;
+        std::unordered_map<std::type_index, std::unique_ptr<LoaderBase>> m_loaders;
+        std::unordered_map<Key, std::weak_ptr<AssetEntryBase>, KeyHash> m_entries;
+        std::deque<QueuedLoad> m_queuedLoads;
+        size_t m_runningWorkerCount;
+        std::unique_ptr<FileWatcher> m_fileWatcher;
+        std::unordered_map<std::string, std::vector<std::weak_ptr<AssetEntryBase>>> m_watchedFiles; ///< Assets per watched file, by normalized filename.
+        std::vector<std::weak_ptr<AssetEntryBase>> m_loadingEntries; ///< Assets being loaded, whose dependencies are not yet watched.
+        std::vector<Reload> m_reloads;
+
+    };
+
+}
+
+#include "Molten/Asset/AssetManager.inl"
+
+#endif
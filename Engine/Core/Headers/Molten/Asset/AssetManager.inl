@@ -0,0 +1,221 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+namespace Molten
+{
+
+    // Asset entry implementations.
+    template<typename TAsset>
+    AssetEntry<TAsset>::AssetEntry(std::filesystem::path filename, AssetLoadFunction<TAsset> loadFunction) :
+        AssetEntryBase(std::move(filename)),
+        m_loadFunction(std::move(loadFunction)),
+        m_asset{},
+        m_loadedAsset{}
+    {}
+
+    template<typename TAsset>
+    std::shared_ptr<const TAsset> AssetEntry<TAsset>::GetAsset() const
+    {
+        return std::atomic_load(&m_asset);
+    }
+
+    template<typename TAsset>
+    std::optional<std::string> AssetEntry<TAsset>::Load(AssetLoadContext& context)
+    {
+        if(!m_loadFunction)
+        {
+            return "No loader of asset type " + std::string{ typeid(TAsset).name() };
+        }
+
+        auto result = m_loadFunction(GetFilename(), context);
+        if(!result.IsValid())
+        {
+            return std::move(result.Error());
+        }
+        if(!result.Value())
+        {
+            return "Loader returned no asset";
+        }
+
+        m_loadedAsset = std::move(result.Value());
+        return std::nullopt;
+    }
+
+    template<typename TAsset>
+    void AssetEntry<TAsset>::ApplyLoad()
+    {
+        std::atomic_store(&m_asset, std::move(m_loadedAsset));
+        m_loadedAsset.reset();
+    }
+
+
+    // Asset handle implementations.
+    template<typename TAsset>
+    bool AssetHandle<TAsset>::IsValid() const
+    {
+        return m_entry != nullptr;
+    }
+
+    template<typename TAsset>
+    AssetHandle<TAsset>::operator bool() const
+    {
+        return m_entry != nullptr;
+    }
+
+    template<typename TAsset>
+    AssetState AssetHandle<TAsset>::GetState() const
+    {
+        return m_entry->GetState();
+    }
+
+    template<typename TAsset>
+    bool AssetHandle<TAsset>::IsReady() const
+    {
+        return m_entry->GetState() != AssetState::Loading;
+    }
+
+    template<typename TAsset>
+    const TAsset* AssetHandle<TAsset>::Wait() const
+    {
+        m_entry->Wait();
+        return Get();
+    }
+
+    template<typename TAsset>
+    const TAsset* AssetHandle<TAsset>::Get() const
+    {
+        if(!m_entry || m_entry->GetState() != AssetState::Loaded)
+        {
+            return nullptr;
+        }
+        return m_entry->GetAsset().get();
+    }
+
+    template<typename TAsset>
+    std::shared_ptr<const TAsset> AssetHandle<TAsset>::GetShared() const
+    {
+        if(!m_entry || m_entry->GetState() != AssetState::Loaded)
+        {
+            return nullptr;
+        }
+        return m_entry->GetAsset();
+    }
+
+    template<typename TAsset>
+    std::string AssetHandle<TAsset>::GetError() const
+    {
+        return m_entry->GetError();
+    }
+
+    template<typename TAsset>
+    uint32_t AssetHandle<TAsset>::GetVersion() const
+    {
+        return m_entry->GetVersion();
+    }
+
+    template<typename TAsset>
+    double AssetHandle<TAsset>::GetProgress() const
+    {
+        return m_entry->GetProgress();
+    }
+
+    template<typename TAsset>
+    const std::filesystem::path& AssetHandle<TAsset>::GetFilename() const
+    {
+        return m_entry->GetFilename();
+    }
+
+    template<typename TAsset>
+    void AssetHandle<TAsset>::Reset()
+    {
+        m_entry.reset();
+    }
+
+    template<typename TAsset>
+    bool AssetHandle<TAsset>::operator == (const AssetHandle& rhs) const
+    {
+        return m_entry == rhs.m_entry;
+    }
+
+    template<typename TAsset>
+    bool AssetHandle<TAsset>::operator != (const AssetHandle& rhs) const
+    {
+        return m_entry != rhs.m_entry;
+    }
+
+    template<typename TAsset>
+    AssetHandle<TAsset>::AssetHandle(std::shared_ptr<AssetEntry<TAsset>> entry) :
+        m_entry(std::move(entry))
+    {}
+
+
+    // Asset manager implementations.
+    template<typename TAsset>
+    void AssetManager::SetLoader(AssetLoadFunction<TAsset> loadFunction)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_loaders[std::type_index{ typeid(TAsset) }] = std::make_unique<Loader<TAsset>>(std::move(loadFunction));
+    }
+
+    template<typename TAsset>
+    AssetHandle<TAsset> AssetManager::Load(const std::filesystem::path& filename)
+    {
+        auto normalizedFilename = NormalizeFilename(filename);
+        auto key = Key{ std::type_index{ typeid(TAsset) }, normalizedFilename.generic_string() };
+
+        std::scoped_lock lock(m_mutex);
+
+        auto& weakEntry = m_entries[std::move(key)];
+        if(auto existingEntry = weakEntry.lock(); existingEntry)
+        {
+            return AssetHandle<TAsset>{ std::static_pointer_cast<AssetEntry<TAsset>>(std::move(existingEntry)) };
+        }
+
+        AssetLoadFunction<TAsset> loadFunction;
+        if(auto it = m_loaders.find(std::type_index{ typeid(TAsset) }); it != m_loaders.end())
+        {
+            loadFunction = static_cast<const Loader<TAsset>&>(*it->second).function;
+        }
+
+        auto entry = std::make_shared<AssetEntry<TAsset>>(std::move(normalizedFilename), std::move(loadFunction));
+        weakEntry = entry;
+        m_queuedLoads.push_back({ entry, false });
+        if(m_fileWatcher)
+        {
+            WatchEntry(entry);
+            m_loadingEntries.push_back(entry);
+        }
+        ScheduleLoads();
+
+        return AssetHandle<TAsset>{ std::move(entry) };
+    }
+
+    template<typename TAsset>
+    AssetManager::Loader<TAsset>::Loader(AssetLoadFunction<TAsset> function) :
+        function(std::move(function))
+    {}
+
+}
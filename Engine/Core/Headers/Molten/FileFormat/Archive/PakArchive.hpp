@@ -0,0 +1,171 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_FILEFORMAT_ARCHIVE_PAKARCHIVE_HPP
+#define MOLTEN_CORE_FILEFORMAT_ARCHIVE_PAKARCHIVE_HPP
+
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Compression of pak archive entries. */
+    enum class PakCompression : uint8_t
+    {
+        None, ///< Entry is stored as is and served zero-copy from the mapped archive.
+        Lz4 ///< Entry is compressed as a single Lz4 block and decompressed at every open. Entries not shrinking by compression are stored as is.
+    };
+
+
+    /** Writer of pak archives.
+     *  A pak archive is a single little-endian file of all entries, followed by an index of the entries and a hash table of their paths,
+     *  so opening an archive is a single mapping and a lookup is a hash and a few probes, without any file system calls.
+     *  Entry data is aligned, letting binary formats be read directly from the mapped archive.
+     */
+    class MOLTEN_API PakArchiveWriter
+    {
+
+    public:
+
+        static constexpr size_t DefaultAlignment = 16; ///< Default alignment of entry data in bytes.
+
+        /** Constructor. Provided alignment must be a power of two. */
+        explicit PakArchiveWriter(const size_t alignment = DefaultAlignment);
+
+        ~PakArchiveWriter() = default;
+
+        PakArchiveWriter(const PakArchiveWriter&) = delete;
+        PakArchiveWriter(PakArchiveWriter&&) = delete;
+        PakArchiveWriter& operator = (const PakArchiveWriter&) = delete;
+        PakArchiveWriter& operator = (PakArchiveWriter&&) = delete;
+
+        /** Adds file of data in memory. Path is normalized via VirtualFileSystem::NormalizePath.
+         *
+         * @return false if path is empty or already added.
+         */
+        bool AddFile(const std::string_view path, std::vector<uint8_t> data, const PakCompression compression = PakCompression::None);
+
+        /** Adds file on disk, which is read at WriteToFile(...).
+         *
+         * @return false if path is empty or already added.
+         */
+        bool AddFileFromDisk(const std::string_view path, const std::filesystem::path& filename, const PakCompression compression = PakCompression::None);
+
+        /** Recursively adds all files of directory on disk, prefixing their relative paths by archive directory.
+         *
+         * @return false if directory does not exist or any of its files is already added.
+         */
+        bool AddDirectory(const std::filesystem::path& directory, const std::string_view archiveDirectory = {}, const PakCompression compression = PakCompression::None);
+
+        /** Get number of added files. */
+        [[nodiscard]] size_t GetFileCount() const;
+
+        /** Writes archive of all added files.
+         *
+         * @return false if archive could not be written or any file on disk could not be read.
+         */
+        bool WriteToFile(const std::filesystem::path& filename) const;
+
+    private:
+
+        struct File
+        {
+            std::string path;
+            std::vector<uint8_t> data;
+            std::filesystem::path sourceFilename; ///< File on disk, read at write if not empty.
+            PakCompression compression;
+        };
+
+        bool AddFile(File&& file);
+
+        size_t m_alignment;
+        std::vector<File> m_files;
+        std::unordered_set<std::string> m_paths;
+
+    };
+
+
+    /** Memory mapped pak archive, mountable by virtual file systems. Thread safe.
+     *  Stored entries are served as zero-copy views into the mapping, while compressed entries are decompressed into memory owned by the opened file.
+     */
+    class MOLTEN_API PakArchive : public VirtualFileSystemMount
+    {
+
+    public:
+
+        /** Maps and validates archive file.
+         *
+         * @return nullptr if file cannot be mapped or is not a valid pak archive.
+         */
+        [[nodiscard]] static std::shared_ptr<PakArchive> OpenFromFile(const std::filesystem::path& filename);
+
+        [[nodiscard]] std::optional<VirtualFile> Open(const std::string_view path) const override;
+
+        [[nodiscard]] bool Exists(const std::string_view path) const override;
+
+        bool ListDirectory(const std::string_view directory, std::vector<std::string>& names) const override;
+
+        /** Get number of files in archive. */
+        [[nodiscard]] size_t GetFileCount() const;
+
+        /** Get path of file by index. */
+        [[nodiscard]] std::string_view GetFilePath(const size_t index) const;
+
+    private:
+
+        struct Entry;
+
+        PakArchive(
+            VirtualFile::MappedFile file,
+            const Entry* entries,
+            const uint32_t* slots,
+            const char* strings,
+            const uint32_t entryCount,
+            const uint32_t slotCount);
+
+        [[nodiscard]] const Entry* FindEntry(const std::string_view path) const;
+
+        [[nodiscard]] std::string_view GetEntryPath(const Entry& entry) const;
+
+        VirtualFile::MappedFile m_file;
+        const Entry* m_entries;
+        const uint32_t* m_slots;
+        const char* m_strings;
+        uint32_t m_entryCount;
+        uint32_t m_slotMask;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_BLOCKCOMPRESSOR_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_BLOCKCOMPRESSOR_HPP
+
+#include "Molten/FileFormat/Image/MipmapGenerator.hpp"
+#include <optional>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class ThreadPool;
+
+
+    /** CPU encoder of BC1, BC3, BC4, BC5 and BC7 block compressed images, for offline processing and import of textures.
+     *  Blocks of 4x4 pixels are encoded independently, in parallel per row of blocks if a thread pool is provided.
+     *  Palette index selection uses SSE2 if enabled by the compiler.
+     *  sRGB images are compressed in sRGB space, so sRGB pixels should be compressed into sRGB block compressed formats.
+     *  BC7 blocks are encoded in mode 6, a single RGBA subset with 4-bit indices.
+     *  Supported source formats are 8-bit unsigned R, RG, RGB(A), BGR(A) and sRGB(A).
+     */
+    class MOLTEN_API BlockCompressor
+    {
+
+    public:
+
+        enum class Quality : uint8_t
+        {
+            Fast,   ///< Endpoints from bounding box of block, suitable at import.
+            High    ///< Endpoints from principal axis of block, refined by least squares fitting.
+        };
+
+        /** Checks if pixels of source format can be compressed into compressed format. */
+        [[nodiscard]] static bool IsFormatSupported(const ImageFormat sourceFormat, const ImageFormat compressedFormat);
+
+        /** Compresses tightly packed pixels, padding partial blocks at the right and bottom edges by repeating edge pixels.
+         *  Only free workers of the thread pool are used, so it is safe to call from work running on a worker of the same thread pool.
+         *
+         * @return Blocks in row-major order, or nullopt if formats are unsupported or any dimension is zero.
+         */
+        [[nodiscard]] static std::optional<std::vector<uint8_t>> Compress(
+            const uint8_t* pixels,
+            const Vector2ui32& dimensions,
+            const ImageFormat sourceFormat,
+            const ImageFormat compressedFormat,
+            const Quality quality = Quality::High,
+            ThreadPool* threadPool = nullptr);
+
+        /** Compresses all levels of mip chain, into a mip chain of compressed format. */
+        [[nodiscard]] static std::optional<MipChain> Compress(
+            const MipChain& mipChain,
+            const ImageFormat compressedFormat,
+            const Quality quality = Quality::High,
+            ThreadPool* threadPool = nullptr);
+
+        /** Decompresses blocks into tightly packed pixels, of 8-bit unsigned RGBA format.
+         *  Channels missing from the compressed format are set to 0, except for alpha which is set to 255.
+         *
+         * @return Pixels, or nullopt if format is not block compressed, or if any BC7 block is of another mode than 6.
+         */
+        [[nodiscard]] static std::optional<std::vector<uint8_t>> Decompress(
+            const uint8_t* blocks,
+            const Vector2ui32& dimensions,
+            const ImageFormat compressedFormat);
+
+    };
+
+}
+
+#endif
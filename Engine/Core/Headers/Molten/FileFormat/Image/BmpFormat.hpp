@@ -27,9 +27,13 @@
 #define MOLTEN_CORE_FILEFORMAT_IMAGE_BMPFORMAT_HPP
 
 #include "Molten/Types.hpp"
+#include "Molten/Renderer/ImageFormat.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
 #include <vector>
 #include <string>
 #include <istream>
+#include <ostream>
+#include <filesystem>
 
 namespace Molten::Formats::Bmp
 {
@@ -39,6 +43,7 @@ namespace Molten::Formats::Bmp
     class InfoHeader;
     class ColorTable;
     class ReaderResult;
+    class Decoder;
 
     using Data = std::vector<uint8_t>; ///< Data type of BMP data bytes.
     
@@ -47,7 +52,23 @@ namespace Molten::Formats::Bmp
     {
         Successful,
         CannotOpenFile,
-        UnexpectedEndOfFile
+        UnexpectedEndOfFile,
+        InvalidSignature,
+        InvalidHeader,
+        UnsupportedFormat, ///< Compressed bitmap data, unsupported bit depth or unsupported decode format.
+        BufferTooSmall
+    };
+
+    /** Compression methods of bitmap data. Only uncompressed and bit field data is supported. */
+    enum class Compression : uint32_t
+    {
+        Rgb = 0,
+        Rle8 = 1,
+        Rle4 = 2,
+        Bitfields = 3,
+        Jpeg = 4,
+        Png = 5,
+        AlphaBitfields = 6
     };
 
 
@@ -57,6 +78,9 @@ namespace Molten::Formats::Bmp
 
     public:
 
+        static constexpr uint16_t Signature = 0x4D42; ///< "BM" in little endian.
+        static constexpr size_t Size = 14; ///< Size of header in file, in bytes.
+
         Header();
 
         uint16_t& GetSignature();
@@ -81,12 +105,90 @@ namespace Molten::Formats::Bmp
     };
 
 
-    /** BMP Info Header class, containing information about bitmap data. */
+    /** BMP Info Header class, containing information about bitmap data.
+     *  Core(12 bytes) and info headers of 40 bytes or larger are supported,
+     *  but fields of V4 and V5 headers beyond the alpha mask are ignored.
+     */
     class MOLTEN_API InfoHeader
     {
 
     public:
 
+        InfoHeader();
+
+        uint32_t& GetHeaderSize();
+        uint32_t GetHeaderSize() const;
+
+        /** Get width in pixels. */
+        int32_t& GetWidth();
+        int32_t GetWidth() const;
+
+        /** Get height in pixels. Negative height denotes top-down row order. */
+        int32_t& GetHeight();
+        int32_t GetHeight() const;
+
+        uint16_t& GetPlanes();
+        uint16_t GetPlanes() const;
+
+        uint16_t& GetBitsPerPixel();
+        uint16_t GetBitsPerPixel() const;
+
+        Compression& GetCompression();
+        Compression GetCompression() const;
+
+        uint32_t& GetImageSize();
+        uint32_t GetImageSize() const;
+
+        int32_t& GetXPixelsPerMeter();
+        int32_t GetXPixelsPerMeter() const;
+
+        int32_t& GetYPixelsPerMeter();
+        int32_t GetYPixelsPerMeter() const;
+
+        uint32_t& GetColorsUsed();
+        uint32_t GetColorsUsed() const;
+
+        uint32_t& GetColorsImportant();
+        uint32_t GetColorsImportant() const;
+
+        /** Get bit masks of color channels, used by bit field compression. */
+        /**@{*/
+        uint32_t& GetRedMask();
+        uint32_t GetRedMask() const;
+
+        uint32_t& GetGreenMask();
+        uint32_t GetGreenMask() const;
+
+        uint32_t& GetBlueMask();
+        uint32_t GetBlueMask() const;
+
+        uint32_t& GetAlphaMask();
+        uint32_t GetAlphaMask() const;
+        /**@}*/
+
+        /** Checks if rows are stored top-down, instead of the default bottom-up order. */
+        bool IsTopDown() const;
+
+        /** Get size in bytes of a stored row, including padding to 4 bytes. */
+        size_t GetRowStride() const;
+
+    private:
+
+        uint32_t m_headerSize;
+        int32_t m_width;
+        int32_t m_height;
+        uint16_t m_planes;
+        uint16_t m_bitsPerPixel;
+        Compression m_compression;
+        uint32_t m_imageSize;
+        int32_t m_xPixelsPerMeter;
+        int32_t m_yPixelsPerMeter;
+        uint32_t m_colorsUsed;
+        uint32_t m_colorsImportant;
+        uint32_t m_redMask;
+        uint32_t m_greenMask;
+        uint32_t m_blueMask;
+        uint32_t m_alphaMask;
 
     };
 
@@ -97,6 +199,17 @@ namespace Molten::Formats::Bmp
 
     public:
 
+        using Colors = std::vector<uint32_t>; ///< Colors stored as in file, 0x00RRGGBB.
+
+        ColorTable();
+
+        /** Get const or non-const reference to colors. */
+        Colors& GetColors();
+        const Colors& GetColors() const;
+
+    private:
+
+        Colors m_colors;
 
     };
 
@@ -121,7 +234,7 @@ namespace Molten::Formats::Bmp
         ColorTable& GetColorTable();
         const ColorTable& GetColorTable() const;
 
-        /** Get const or non-const reference raw data bytes. */
+        /** Get const or non-const reference raw data bytes. Rows are stored as in file, padded and in file row order. */
         Data& GetData();
         const Data& GetData() const;
 
@@ -136,7 +249,7 @@ namespace Molten::Formats::Bmp
 
 
     /** Result class, returned from ReadFrom*, containing the parsed BMP image and result code. */
-    class ReaderResult
+    class MOLTEN_API ReaderResult
     {
 
     public:
@@ -144,6 +257,9 @@ namespace Molten::Formats::Bmp
         /** Constructor. */
         ReaderResult();
 
+        /** Constructor of result with provided code. */
+        explicit ReaderResult(const ResultCode code);
+
         /** @return true if reader result is successful. */
         bool IsSuccessful() const;
 
@@ -161,9 +277,90 @@ namespace Molten::Formats::Bmp
     };
 
 
+    /** BMP decoder, decoding pixel data straight from a memory mapped file or from caller owned bytes
+     *  into a caller provided buffer, without intermediate copies of the bitmap data.
+     */
+    class MOLTEN_API Decoder
+    {
+
+    public:
+
+        Decoder();
+        ~Decoder() = default;
+
+        Decoder(Decoder&&) noexcept = default;
+        Decoder& operator = (Decoder&&) noexcept = default;
+
+        Decoder(const Decoder&) = delete;
+        Decoder& operator = (const Decoder&) = delete;
+
+        /** Memory maps file and parses headers. The file is kept mapped until Close() or next call to Open(...). */
+        ResultCode Open(const std::filesystem::path& filename);
+
+        /** Parses headers of BMP data in memory. Provided data must outlive any following call to Decode(...). */
+        ResultCode Open(const uint8_t* data, const size_t size);
+
+        /** Unmaps file and resets headers. */
+        void Close();
+
+        /** Checks if a BMP image is successfully opened. */
+        [[nodiscard]] bool IsOpen() const;
+
+        [[nodiscard]] const Header& GetHeader() const;
+        [[nodiscard]] const InfoHeader& GetInfoHeader() const;
+        [[nodiscard]] const ColorTable& GetColorTable() const;
+
+        /** Get dimensions of image in pixels. */
+        /**@{*/
+        [[nodiscard]] uint32_t GetWidth() const;
+        [[nodiscard]] uint32_t GetHeight() const;
+        /**@}*/
+
+        /** Decodes pixels into destination, as tightly packed top-down rows of requested format.
+         *  Use GetDecodedSize(...) for required size of destination buffer.
+         */
+        [[nodiscard]] ResultCode Decode(const ImageFormat format, uint8_t* destination, const size_t destinationSize) const;
+
+    private:
+
+        MemoryMappedFile m_mappedFile;
+        Header m_header;
+        InfoHeader m_infoHeader;
+        ColorTable m_colorTable;
+        const uint8_t* m_pixelData;
+        size_t m_pixelDataSize;
+
+    };
+
+
+    /** Checks if pixels can be decoded into or encoded from provided format.
+     *  Decoding supports 8-bit RGB(A), sRGB(A) and BGR(A) formats, encoding additionally supports URed8 as grayscale.
+     */
+    /**@{*/
+    MOLTEN_API bool IsDecodeFormatSupported(const ImageFormat format);
+    MOLTEN_API bool IsEncodeFormatSupported(const ImageFormat format);
+    /**@}*/
+
+    /** Get size in bytes of tightly packed decoded image, or 0 if format is not supported. */
+    MOLTEN_API size_t GetDecodedSize(const uint32_t width, const uint32_t height, const ImageFormat format);
+
+    /** Decodes pixel data of read BMP file into destination, same as Decoder::Decode(...). */
+    MOLTEN_API ResultCode Decode(const File& file, const ImageFormat format, uint8_t* destination, const size_t destinationSize);
+
     MOLTEN_API ReaderResult ReadFromFile(const std::string& filename);
     MOLTEN_API ReaderResult ReadFromBytes(const std::vector<uint8_t>& bytes);
-    MOLTEN_API ReaderResult ReadFromStream(const std::istream& stream);
+    MOLTEN_API ReaderResult ReadFromBytes(const uint8_t* data, const size_t size);
+    MOLTEN_API ReaderResult ReadFromStream(std::istream& stream);
+
+    /** Encodes tightly packed top-down pixels as BMP data.
+     *  RGB formats are written as 24-bit images, RGBA formats as 32-bit images with alpha bit mask
+     *  and URed8 as 8-bit images with a grayscale palette.
+     *
+     * @return Encoded bytes, or empty data if format is not supported or image is empty.
+     */
+    MOLTEN_API Data WriteToBytes(const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format);
+    MOLTEN_API bool WriteToStream(std::ostream& stream, const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format);
+    MOLTEN_API bool WriteToFile(const std::string& filename, const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format);
     
 }
 
@@ -0,0 +1,168 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_IMAGECACHE_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_IMAGECACHE_HPP
+
+#include "Molten/FileFormat/Image/ImageLoader.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Molten
+{
+
+    class VirtualFileSystem;
+
+    /** Thread safe cache of decoded images, keyed by content hash and format, 
+     *  so identical images are decoded once, even if loaded from different files.
+     *  Files are mapped to content hashes by canonical path, and are hashed again only if their size or last write time changes.
+     *  Concurrent loads of the same content are deduplicated; one caller decodes the image while the others wait for its result.
+     *  Failed loads are not cached.
+     */
+    class MOLTEN_API ImageCache
+    {
+
+    public:
+
+        static constexpr ImageFormat DefaultFormat = ImageFormat::URed8Green8Blue8Alpha8;
+
+        explicit ImageCache(
+            std::shared_ptr<const ImageLoaderRegistry> registry = ImageLoaderRegistry::GetDefault(),
+            std::shared_ptr<ImagePixelBufferPool> pool = ImagePixelBufferPool::GetShared());
+        /** Destructor. Queued asynchronous loads are dropped, their futures report a broken promise.
+         *  Blocks until running asynchronous loads are finished.
+         */
+        ~ImageCache();
+
+        ImageCache(const ImageCache&) = delete;
+        ImageCache(ImageCache&&) = delete;
+        ImageCache& operator = (const ImageCache&) = delete;
+        ImageCache& operator = (ImageCache&&) = delete;
+
+        /** Get image of file, decoding it on the calling thread if not cached. */
+        [[nodiscard]] ImageLoadResult Load(const std::filesystem::path& filename, const ImageFormat format = DefaultFormat);
+
+        /** Get image of file of virtual file system, decoding it on the calling thread if not cached.
+         *  Virtual files are keyed by virtual file system and normalized path, and are hashed again only if their size changes,
+         *  so call Clear if mounted files are modified without changing their size. Images are decoded directly from the opened file data.
+         */
+        [[nodiscard]] ImageLoadResult Load(
+            const VirtualFileSystem& virtualFileSystem,
+            const std::string& path,
+            const ImageFormat format = DefaultFormat);
+
+        /** Loads images of files in parallel, on the calling thread and free workers of thread pool.
+         *
+         * @return Results in order of filenames.
+         */
+        [[nodiscard]] std::vector<ImageLoadResult> Load(
+            const std::vector<std::filesystem::path>& filenames,
+            ThreadPool& threadPool,
+            const ImageFormat format = DefaultFormat);
+
+        /** Loads image of file on a background worker of thread pool, without blocking the calling thread.
+         *  The load is queued if no background worker is free, and is run by the next asynchronous load worker of this cache.
+         *  Queued loads are only started by ScheduleAsyncLoads or WaitForAsyncLoads if no worker of this cache is running,
+         *  so call either of them, i.e. once per frame, if all workers may have been busy.
+         */
+        [[nodiscard]] std::shared_future<ImageLoadResult> LoadAsync(
+            const std::filesystem::path& filename,
+            ThreadPool& threadPool,
+            const ImageFormat format = DefaultFormat);
+
+        /** Hands queued asynchronous loads to free background workers of thread pool. Never blocks. */
+        void ScheduleAsyncLoads(ThreadPool& threadPool);
+
+        /** Blocks until all queued and running asynchronous loads are finished, loading queued images on calling thread. */
+        void WaitForAsyncLoads();
+
+        /** Removes all cached images and file hashes. Images already handed out stay valid. */
+        void Clear();
+
+        /** Get number of cached images. */
+        [[nodiscard]] size_t GetImageCount() const;
+
+        /** Get number of images decoded by this cache, including failed decodes. */
+        [[nodiscard]] size_t GetDecodeCount() const;
+
+    private:
+
+        struct FileEntry
+        {
+            uint64_t size;
+            int64_t modifiedTime;
+            uint64_t contentHash;
+        };
+
+        struct AsyncLoad
+        {
+            std::filesystem::path filename;
+            ImageFormat format;
+            std::promise<ImageLoadResult> promise;
+        };
+
+        /** Starts asynchronous load workers, as long as there are free background workers and queued loads. m_mutex must be locked. */
+        void StartAsyncLoadWorkers(ThreadPool& threadPool);
+
+        /** Runs queued asynchronous loads until the queue is empty. Executed by background workers. */
+        void RunAsyncLoads();
+
+        /** Pops next queued asynchronous load and runs it. m_mutex must be locked by lock, and is unlocked while loading.
+         *
+         * @return false if no load is queued.
+         */
+        bool RunNextAsyncLoad(std::unique_lock<std::mutex>& lock);
+
+        /** Get cached image of content, or decodes it while concurrent loads of the same content wait for the shared result. */
+        [[nodiscard]] ImageLoadResult LoadContent(
+            const uint8_t* data,
+            const size_t size,
+            const uint64_t contentHash,
+            const std::filesystem::path& filename,
+            const ImageFormat format);
+
+        std::shared_ptr<const ImageLoaderRegistry> m_registry;
+        std::shared_ptr<ImagePixelBufferPool> m_pool;
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, FileEntry> m_files;
+        std::unordered_map<uint64_t, std::shared_future<ImageLoadResult>> m_images;
+        size_t m_decodeCount;
+        std::deque<AsyncLoad> m_asyncLoads;
+        size_t m_asyncWorkerCount;
+        std::condition_variable m_asyncIdleCondition;
+
+    };
+
+}
+
+#endif
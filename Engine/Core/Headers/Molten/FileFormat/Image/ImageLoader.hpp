@@ -0,0 +1,215 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_IMAGELOADER_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_IMAGELOADER_HPP
+
+#include "Molten/Renderer/Texture.hpp"
+#include "Molten/Math/Vector.hpp"
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace Molten
+{
+
+    class Image;
+    class ImagePixelBufferPool;
+    class VirtualFileSystem;
+
+    using ImageSharedPointer = std::shared_ptr<const Image>;
+    using ImageLoadResult = std::variant<ImageSharedPointer, std::string>; ///< Loaded image or error message.
+
+
+    /** Thread safe pool of pixel buffers, letting decoders reuse memory of destroyed images.
+     *  Unused buffers of at most max pooled size bytes in total are retained, any further released buffers are freed.
+     */
+    class MOLTEN_API ImagePixelBufferPool
+    {
+
+    public:
+
+        using Buffer = std::vector<uint8_t>;
+
+        static constexpr size_t DefaultMaxPooledSize = 64 * 1024 * 1024;
+
+        explicit ImagePixelBufferPool(const size_t maxPooledSize = DefaultMaxPooledSize);
+        ~ImagePixelBufferPool() = default;
+
+        ImagePixelBufferPool(const ImagePixelBufferPool&) = delete;
+        ImagePixelBufferPool(ImagePixelBufferPool&&) = delete;
+        ImagePixelBufferPool& operator = (const ImagePixelBufferPool&) = delete;
+        ImagePixelBufferPool& operator = (ImagePixelBufferPool&&) = delete;
+
+        /** Get process-wide pool, used by image loaders by default. */
+        [[nodiscard]] static const std::shared_ptr<ImagePixelBufferPool>& GetShared();
+
+        /** Get buffer of provided size, reusing the smallest pooled buffer of sufficient capacity if any. Content of buffer is unspecified. */
+        [[nodiscard]] Buffer Acquire(const size_t size);
+
+        /** Returns buffer to pool. */
+        void Release(Buffer&& buffer);
+
+        /** Get number of unused buffers in pool. */
+        [[nodiscard]] size_t GetPooledBufferCount() const;
+
+        /** Get total capacity in bytes of unused buffers in pool. */
+        [[nodiscard]] size_t GetPooledSize() const;
+
+    private:
+
+        mutable std::mutex m_mutex;
+        size_t m_maxPooledSize;
+        size_t m_pooledSize;
+        std::multimap<size_t, Buffer> m_buffers; ///< Unused buffers, keyed by capacity.
+
+    };
+
+
+    /** Decoded image, with tightly packed top-down rows of pixels.
+     *  The pixel buffer is returned to its pool at destruction, as long as the pool is still alive.
+     */
+    class MOLTEN_API Image
+    {
+
+    public:
+
+        Image(
+            ImagePixelBufferPool::Buffer&& pixels,
+            const Vector2ui32& dimensions,
+            const ImageFormat format,
+            std::weak_ptr<ImagePixelBufferPool> pool = {});
+        ~Image();
+
+        Image(const Image&) = delete;
+        Image(Image&&) = delete;
+        Image& operator = (const Image&) = delete;
+        Image& operator = (Image&&) = delete;
+
+        [[nodiscard]] const uint8_t* GetData() const;
+        [[nodiscard]] size_t GetDataSize() const;
+        [[nodiscard]] const Vector2ui32& GetDimensions() const;
+        [[nodiscard]] ImageFormat GetFormat() const;
+
+        /** Creates descriptor of a color texture for Renderer::CreateTexture, referencing pixels of this image.
+         *  The image must be kept alive until the texture is created.
+         */
+        [[nodiscard]] TextureDescriptor2D CreateTextureDescriptor(const TextureUsage initialUsage = TextureUsage::ReadOnly) const;
+
+    private:
+
+        ImagePixelBufferPool::Buffer m_pixels;
+        Vector2ui32 m_dimensions;
+        ImageFormat m_format;
+        std::weak_ptr<ImagePixelBufferPool> m_pool;
+
+    };
+
+
+    /** Registry of image loaders, selecting loader by file extension and by probing content.
+     *  The default registry contains loaders of BMP, TGA and PPM/PGM images.
+     */
+    class MOLTEN_API ImageLoaderRegistry
+    {
+
+    public:
+
+        /** Checks if data is of the format of a loader. */
+        using ProbeFunction = std::function<bool(const uint8_t* data, const size_t size)>;
+
+        /** Decodes data into an image of requested format, with pixels acquired from pool. Pool may be null. Must be thread safe. */
+        using DecodeFunction = std::function<ImageLoadResult(
+            const uint8_t* data,
+            const size_t size,
+            const ImageFormat format,
+            const std::shared_ptr<ImagePixelBufferPool>& pool)>;
+
+        struct Loader
+        {
+            std::string name;
+            std::vector<std::string> extensions; ///< Lower case file extensions, including leading dot, e.g. ".bmp".
+            ProbeFunction probe;
+            DecodeFunction decode;
+        };
+
+        /** Constructs registry without any loaders. */
+        ImageLoaderRegistry() = default;
+        ~ImageLoaderRegistry() = default;
+
+        /** Get process-wide registry of default loaders. */
+        [[nodiscard]] static const std::shared_ptr<const ImageLoaderRegistry>& GetDefault();
+
+        /** Registers loader. Loaders registered later take precedence over earlier ones.
+         *  Registration is not thread safe, so loaders should be registered before loading any images.
+         */
+        void Register(Loader loader);
+
+        /** Registers loaders of BMP, TGA and PPM/PGM images. */
+        void RegisterDefaultLoaders();
+
+        /** Get all registered loaders, in order of registration. */
+        [[nodiscard]] const std::vector<Loader>& GetLoaders() const;
+
+        /** Finds loader of data, preferring loaders of matching file extension. Filename may be empty.
+         *
+         * @return Pointer to loader, or nullptr if no loader accepts the data.
+         */
+        [[nodiscard]] const Loader* FindLoader(const std::filesystem::path& filename, const uint8_t* data, const size_t size) const;
+
+        /** Decodes image data in memory. Filename is only used as a hint for selecting loader and may be empty. Thread safe. */
+        [[nodiscard]] ImageLoadResult Load(
+            const uint8_t* data,
+            const size_t size,
+            const std::filesystem::path& filename,
+            const ImageFormat format,
+            const std::shared_ptr<ImagePixelBufferPool>& pool = ImagePixelBufferPool::GetShared()) const;
+
+        /** Memory maps and decodes image file. Thread safe. */
+        [[nodiscard]] ImageLoadResult LoadFromFile(
+            const std::filesystem::path& filename,
+            const ImageFormat format,
+            const std::shared_ptr<ImagePixelBufferPool>& pool = ImagePixelBufferPool::GetShared()) const;
+
+        /** Decodes image file of virtual file system, directly from the opened file data. Thread safe. */
+        [[nodiscard]] ImageLoadResult LoadFromFile(
+            const VirtualFileSystem& virtualFileSystem,
+            const std::string& path,
+            const ImageFormat format,
+            const std::shared_ptr<ImagePixelBufferPool>& pool = ImagePixelBufferPool::GetShared()) const;
+
+    private:
+
+        std::vector<Loader> m_loaders;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_MIPMAPGENERATOR_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_MIPMAPGENERATOR_HPP
+
+#include "Molten/Renderer/Texture.hpp"
+#include "Molten/Math/Vector.hpp"
+#include <optional>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class Image;
+    class ThreadPool;
+
+
+    /** Mip chain of 2D image, with tightly packed top-down rows of pixels.
+     *  All levels are stored in a single buffer, one after another, starting with the full resolution level,
+     *  which is the layout expected by TextureDescriptor2D::data when mipLevelCount is greater than 1.
+     */
+    class MOLTEN_API MipChain
+    {
+
+    public:
+
+        MipChain(
+            std::vector<uint8_t>&& data,
+            std::vector<size_t>&& levelOffsets,
+            const Vector2ui32& dimensions,
+            const ImageFormat format);
+
+        [[nodiscard]] const uint8_t* GetData() const;
+        [[nodiscard]] size_t GetDataSize() const;
+        [[nodiscard]] const Vector2ui32& GetDimensions() const;
+        [[nodiscard]] ImageFormat GetFormat() const;
+
+        [[nodiscard]] uint32_t GetLevelCount() const;
+
+        /** Get level properties. Accessing a level out of range is undefined behavior. */
+        /**@{*/
+        [[nodiscard]] Vector2ui32 GetLevelDimensions(const uint32_t level) const;
+        [[nodiscard]] const uint8_t* GetLevelData(const uint32_t level) const;
+        [[nodiscard]] size_t GetLevelSize(const uint32_t level) const;
+        /**@}*/
+
+        /** Creates descriptor of a color texture for Renderer::CreateTexture, including all levels of this mip chain.
+         *  The mip chain must be kept alive until the texture is created.
+         */
+        [[nodiscard]] TextureDescriptor2D CreateTextureDescriptor(const TextureUsage initialUsage = TextureUsage::ReadOnly) const;
+
+    private:
+
+        std::vector<uint8_t> m_data;
+        std::vector<size_t> m_levelOffsets; ///< Offset of each level in m_data, followed by size of m_data.
+        Vector2ui32 m_dimensions;
+        ImageFormat m_format;
+
+    };
+
+
+    /** Generator of mip chains on the CPU.
+     *  Each level is filtered from the previous level with a separable filter, in linear color space.
+     *  Color channels of sRGB formats are decoded to linear before filtering and encoded again after, while alpha stays linear.
+     *  Levels are processed in tiles of rows, in parallel if a thread pool is provided, and filtering uses SSE2 if enabled by the compiler.
+     *  Supported formats are 8-bit unsigned R, RG, RGB(A), BGR(A) and sRGB(A).
+     */
+    class MOLTEN_API MipmapGenerator
+    {
+
+    public:
+
+        enum class Filter : uint8_t
+        {
+            Box,    ///< Area weighted average of covered source pixels, also correct for odd dimensions.
+            Kaiser  ///< Kaiser windowed sinc, sharper than box but may ring at hard edges.
+        };
+
+        struct MOLTEN_API Settings
+        {
+            Settings();
+
+            Filter filter;
+            float kaiserWidth; ///< Radius of Kaiser filter, in destination pixels.
+            float kaiserAlpha; ///< Shape parameter of Kaiser window, higher values trade sharpness for less ringing.
+            uint32_t maxLevelCount; ///< Max number of levels to generate, including full resolution level. 0 generates a full chain.
+        };
+
+        static constexpr uint32_t TileRowCount = 16; ///< Number of destination rows processed per parallel work item.
+
+        /** Checks if format is supported by Generate. */
+        [[nodiscard]] static bool IsFormatSupported(const ImageFormat format);
+
+        /** Generates mip chain of tightly packed pixels, starting with a copy of the provided pixels.
+         *  Only free workers of the thread pool are used, so it is safe to call from work running on a worker of the same thread pool.
+         *
+         * @return Mip chain, or nullopt if format is unsupported or any dimension is zero.
+         */
+        [[nodiscard]] static std::optional<MipChain> Generate(
+            const uint8_t* pixels,
+            const Vector2ui32& dimensions,
+            const ImageFormat format,
+            const Settings& settings = Settings(),
+            ThreadPool* threadPool = nullptr);
+
+        [[nodiscard]] static std::optional<MipChain> Generate(
+            const Image& image,
+            const Settings& settings = Settings(),
+            ThreadPool* threadPool = nullptr);
+
+    };
+
+}
+
+#endif
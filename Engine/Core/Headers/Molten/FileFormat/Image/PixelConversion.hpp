@@ -0,0 +1,78 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_PIXELCONVERSION_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_PIXELCONVERSION_HPP
+
+#include "Molten/Types.hpp"
+#include "Molten/Renderer/ImageFormat.hpp"
+#include <optional>
+
+/** Conversions of 8-bit per channel pixels, shared by image decoders and encoders. */
+namespace Molten::PixelConversion
+{
+
+    /** Byte layout of 8-bit per channel color pixels. */
+    struct Layout
+    {
+        size_t channelCount; ///< 3 or 4 channels.
+        bool bgr; ///< Blue is stored in first byte.
+    };
+
+    /** Get name of instruction set used for 3 to 4 channel conversions on this CPU, "SSSE3", "NEON" or "Scalar". */
+    [[nodiscard]] MOLTEN_API const char* GetInstructionSet();
+
+    /** Get layout of 8-bit per channel unsigned RGB(A), sRGB(A) or BGR(A) format, or nullopt for any other format. */
+    [[nodiscard]] MOLTEN_API std::optional<Layout> GetLayout(const ImageFormat format);
+
+    /** Converts a row of 8-bit pixels from gray, BGR(A) or RGB(A) into BGR(A) or RGB(A), swapping red and blue if requested.
+     *  Alpha of destination is set to 255 if source lacks alpha or if opaque is true.
+     *  Uses SSSE3 or NEON for 3 to 4 channel conversions and SSE2 or NEON for 4 channel conversions.
+     *  SSSE3 support is detected at runtime, so it does not depend on compiler flags.
+     */
+    MOLTEN_API void ConvertRow(
+        const uint8_t* source,
+        const size_t sourceChannelCount,
+        uint8_t* destination,
+        const size_t destinationChannelCount,
+        const bool swapRedBlue,
+        const bool opaque,
+        const size_t pixelCount);
+
+    /** Stores a single pixel in provided layout. */
+    inline void StorePixel(uint8_t* destination, const Layout& layout, const uint8_t red, const uint8_t green, const uint8_t blue, const uint8_t alpha)
+    {
+        destination[0] = layout.bgr ? blue : red;
+        destination[1] = green;
+        destination[2] = layout.bgr ? red : blue;
+        if(layout.channelCount == 4)
+        {
+            destination[3] = alpha;
+        }
+    }
+
+}
+
+#endif
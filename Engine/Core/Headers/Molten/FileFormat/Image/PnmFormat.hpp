@@ -0,0 +1,115 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_PNMFORMAT_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_PNMFORMAT_HPP
+
+#include "Molten/Types.hpp"
+#include "Molten/Renderer/ImageFormat.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <filesystem>
+
+namespace Molten::Formats::Pnm
+{
+
+    /** Result enumerator for describing result of reading PPM or PGM image. */
+    enum class ResultCode
+    {
+        Successful,
+        CannotOpenFile,
+        UnexpectedEndOfFile,
+        InvalidSignature,
+        InvalidHeader,
+        UnsupportedFormat, ///< Bitmaps(P1, P4), arbitrary maps(P7) or unsupported decode format.
+        BufferTooSmall
+    };
+
+    /** Header of PPM(P3, P6) or PGM(P2, P5) image. */
+    struct Header
+    {
+        char type = 0; ///< Type digit of magic number, '2', '3', '5' or '6'.
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t maxValue = 0; ///< Max value of samples, 1-65535. Samples of binary images are 2 bytes if larger than 255.
+    };
+
+    /** PPM and PGM decoder, decoding pixel data straight from a memory mapped file or from caller owned bytes into a caller provided buffer.
+     *  Binary(P5, P6) and plain text(P2, P3) images are supported. Samples are scaled to 8 bits and grayscale is expanded to RGB.
+     */
+    class MOLTEN_API Decoder
+    {
+
+    public:
+
+        Decoder();
+        ~Decoder() = default;
+
+        Decoder(Decoder&&) noexcept = default;
+        Decoder& operator = (Decoder&&) noexcept = default;
+
+        Decoder(const Decoder&) = delete;
+        Decoder& operator = (const Decoder&) = delete;
+
+        /** Memory maps file and parses header. The file is kept mapped until Close() or next call to Open(...). */
+        ResultCode Open(const std::filesystem::path& filename);
+
+        /** Parses header of image data in memory. Provided data must outlive any following call to Decode(...). */
+        ResultCode Open(const uint8_t* data, const size_t size);
+
+        /** Unmaps file and resets header. */
+        void Close();
+
+        /** Checks if an image is successfully opened. */
+        [[nodiscard]] bool IsOpen() const;
+
+        [[nodiscard]] const Header& GetHeader() const;
+
+        /** Get dimensions of image in pixels. */
+        /**@{*/
+        [[nodiscard]] uint32_t GetWidth() const;
+        [[nodiscard]] uint32_t GetHeight() const;
+        /**@}*/
+
+        /** Decodes pixels into destination, as tightly packed top-down rows of requested format.
+         *  Supported formats are the same as of BMP decoding, see Bmp::IsDecodeFormatSupported.
+         */
+        [[nodiscard]] ResultCode Decode(const ImageFormat format, uint8_t* destination, const size_t destinationSize) const;
+
+    private:
+
+        MemoryMappedFile m_mappedFile;
+        Header m_header;
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pixelDataOffset;
+
+    };
+
+    /** Checks if data starts with a magic number of a supported PPM or PGM image. */
+    MOLTEN_API bool IsPnmData(const uint8_t* data, const size_t size);
+    
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_FILEFORMAT_IMAGE_TGAFORMAT_HPP
+#define MOLTEN_CORE_FILEFORMAT_IMAGE_TGAFORMAT_HPP
+
+#include "Molten/Types.hpp"
+#include "Molten/Renderer/ImageFormat.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <filesystem>
+
+namespace Molten::Formats::Tga
+{
+
+    /** Result enumerator for describing result of reading TGA image. */
+    enum class ResultCode
+    {
+        Successful,
+        CannotOpenFile,
+        UnexpectedEndOfFile,
+        InvalidSignature,
+        InvalidHeader,
+        UnsupportedFormat, ///< Unsupported image type, pixel depth, right-to-left pixel order or unsupported decode format.
+        BufferTooSmall
+    };
+
+    /** Image types of TGA files. */
+    enum class ImageType : uint8_t
+    {
+        None = 0,
+        ColorMapped = 1,
+        TrueColor = 2,
+        Grayscale = 3,
+        RleColorMapped = 9,
+        RleTrueColor = 10,
+        RleGrayscale = 11
+    };
+
+    /** TGA header, 18 bytes in file. */
+    struct Header
+    {
+        static constexpr size_t Size = 18; ///< Size of header in file, in bytes.
+
+        uint8_t idLength = 0;
+        uint8_t colorMapType = 0;
+        ImageType imageType = ImageType::None;
+        uint16_t colorMapFirstEntry = 0;
+        uint16_t colorMapLength = 0;
+        uint8_t colorMapEntrySize = 0;
+        uint16_t xOrigin = 0;
+        uint16_t yOrigin = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint8_t pixelDepth = 0;
+        uint8_t imageDescriptor = 0; ///< Bits 0-3: alpha bits, bit 4: right-to-left, bit 5: top-down.
+    };
+
+    /** TGA decoder, decoding pixel data straight from a memory mapped file or from caller owned bytes into a caller provided buffer.
+     *  Supports uncompressed and RLE compressed true color(15/16/24/32-bit), grayscale(8-bit) and color mapped(8-bit indices) images.
+     */
+    class MOLTEN_API Decoder
+    {
+
+    public:
+
+        Decoder();
+        ~Decoder() = default;
+
+        Decoder(Decoder&&) noexcept = default;
+        Decoder& operator = (Decoder&&) noexcept = default;
+
+        Decoder(const Decoder&) = delete;
+        Decoder& operator = (const Decoder&) = delete;
+
+        /** Memory maps file and parses header. The file is kept mapped until Close() or next call to Open(...). */
+        ResultCode Open(const std::filesystem::path& filename);
+
+        /** Parses header of TGA data in memory. Provided data must outlive any following call to Decode(...). */
+        ResultCode Open(const uint8_t* data, const size_t size);
+
+        /** Unmaps file and resets header. */
+        void Close();
+
+        /** Checks if a TGA image is successfully opened. */
+        [[nodiscard]] bool IsOpen() const;
+
+        [[nodiscard]] const Header& GetHeader() const;
+
+        /** Get dimensions of image in pixels. */
+        /**@{*/
+        [[nodiscard]] uint32_t GetWidth() const;
+        [[nodiscard]] uint32_t GetHeight() const;
+        /**@}*/
+
+        /** Decodes pixels into destination, as tightly packed top-down rows of requested format.
+         *  Supported formats are the same as of BMP decoding, see Bmp::IsDecodeFormatSupported.
+         */
+        [[nodiscard]] ResultCode Decode(const ImageFormat format, uint8_t* destination, const size_t destinationSize) const;
+
+    private:
+
+        MemoryMappedFile m_mappedFile;
+        Header m_header;
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_colorMapOffset;
+        size_t m_pixelDataOffset;
+
+    };
+
+    /** Checks if data starts with a plausible TGA header, since TGA files lack a signature. */
+    MOLTEN_API bool IsTgaData(const uint8_t* data, const size_t size);
+    
+}
+
+#endif
@@ -0,0 +1,250 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_FILEFORMAT_MESH_MESHCACHEFILE_HPP
+#define MOLTEN_CORE_FILEFORMAT_MESH_MESHCACHEFILE_HPP
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include "Molten/Math/Bounds.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Compact binary mesh cache file, containing GPU-ready indexed meshes.
+     *  The format is designed to be memory mapped, vertex and index data are accessed directly from the mapping without any copies.
+     *
+     * Layout, little endian and with all sections 16 byte aligned:
+     * - Header, including version and key of source file the cache was built from.
+     * - Mesh table, with name and range of sub-meshes per mesh.
+     * - Sub-mesh table, with material, bounds, vertex and index data ranges and ranges of levels of detail and meshlets per sub-mesh.
+     * - Level of detail table, with error and index data range per level of detail.
+     * - Meshlet table, with bounds, normal cone and vertex and triangle ranges per meshlet.
+     * - Material table, with names, colors, weights and texture maps of all materials used by sub-meshes.
+     * - Dependency table, with paths and keys of files the source file depends on, such as material files of obj files.
+     * - String data.
+     * - Interleaved vertex data and packed index data per sub-mesh, followed by packed index data of its levels of detail,
+     *   meshlet vertex indices and meshlet local triangle indices.
+     */
+    class MOLTEN_API MeshCacheFile
+    {
+
+    public:
+
+        static constexpr uint32_t Version = 8; ///< Current format version, files of other versions are rejected.
+
+        using Bytes = std::vector<uint8_t>;
+
+        /** Result codes of reading cache files. */
+        enum class ReadResult
+        {
+            Successful,
+            CannotOpenFile,
+            InvalidFile,
+            IncompatibleVersion
+        };
+
+        /** Key of source file, used for detecting outdated caches. */
+        struct SourceKey
+        {
+            SourceKey();
+
+            uint64_t size; ///< Size of source file in bytes.
+            int64_t modifiedTime; ///< Last write time of source file, in file clock ticks.
+            uint64_t hash; ///< Hash64 of source file content.
+            uint64_t settingsHash; ///< Hash of import settings the cache was built with.
+        };
+
+        /** File the source file depends on, such as a material file of an obj file. */
+        struct Dependency
+        {
+            std::string_view filename;
+            SourceKey key; ///< Key of file at import, for detecting outdated caches. Settings hash is not used. Default key if file was missing.
+        };
+
+        /** Texture map of material, with optional texture options. */
+        struct MaterialTexture
+        {
+            std::string_view filename;
+            std::optional<Vector2f32> modifier; ///< { brightness, contrast }
+            std::optional<Vector3f32> originOffset;
+            std::optional<Vector3f32> scale;
+            std::optional<bool> clamp;
+        };
+
+        /** Material with optional properties, as of obj material files. */
+        struct Material
+        {
+            std::string_view name;
+            std::optional<Vector3f32> ambientColor;
+            std::optional<Vector3f32> diffuseColor;
+            std::optional<Vector3f32> specularColor;
+            std::optional<float> specularWeight;
+            std::optional<float> transparency;
+            std::optional<float> opticalDensity;
+            std::optional<float> roughness;
+            std::optional<float> metallic;
+            std::optional<MaterialTexture> ambientTexture;
+            std::optional<MaterialTexture> diffuseTexture;
+            std::optional<MaterialTexture> specularTexture;
+            std::optional<MaterialTexture> specularWeightTexture;
+            std::optional<MaterialTexture> alphaTexture;
+            std::optional<MaterialTexture> displacementTexture;
+            std::optional<MaterialTexture> roughnessTexture;
+            std::optional<MaterialTexture> metallicTexture;
+        };
+
+        /** Mesh, referencing data of this file. */
+        struct Mesh
+        {
+            std::string_view name;
+            Bounds3f32 bounds;
+            uint32_t firstSubmesh;
+            uint32_t submeshCount;
+        };
+
+        /** Sub-mesh, referencing data of this file. */
+        struct MOLTEN_API Submesh
+        {
+            std::string_view material;
+            uint32_t materialIndex; ///< Index of material in GetMaterials.
+            Bounds3f32 bounds;
+            const IndexedMeshVertex* vertices;
+            uint32_t vertexCount;
+            IndexBuffer::DataType indexDataType;
+            const void* indexData;
+            uint32_t indexCount;
+            uint32_t firstLod;
+            uint32_t lodCount;
+            uint32_t firstMeshlet;
+            uint32_t meshletCount;
+            const uint32_t* meshletVertices; ///< Vertex indices of meshlets of this sub-mesh.
+            uint32_t meshletVertexCount;
+            const uint8_t* meshletTriangles; ///< Meshlet local vertex indices of meshlets of this sub-mesh, 3 per triangle.
+            uint32_t meshletTriangleIndexCount;
+
+            /** Get descriptors for creating renderer buffers, referencing data of this file. */
+            /**@{*/
+            [[nodiscard]] VertexBufferDescriptor GetVertexBufferDescriptor() const;
+            [[nodiscard]] IndexBufferDescriptor GetIndexBufferDescriptor() const;
+            /**@}*/
+        };
+
+        /** Level of detail of sub-mesh, with indices referencing vertices of its sub-mesh. */
+        struct MOLTEN_API Lod
+        {
+            float error;
+            IndexBuffer::DataType indexDataType;
+            const void* indexData;
+            uint32_t indexCount;
+
+            /** Get descriptor for creating renderer index buffer, referencing data of this file. */
+            [[nodiscard]] IndexBufferDescriptor GetIndexBufferDescriptor() const;
+        };
+
+        MeshCacheFile();
+        ~MeshCacheFile() = default;
+
+        MeshCacheFile(MeshCacheFile&&) = default;
+        MeshCacheFile& operator = (MeshCacheFile&&) = default;
+
+        MeshCacheFile(const MeshCacheFile&) = delete;
+        MeshCacheFile& operator = (const MeshCacheFile&) = delete;
+
+        /** Serializes meshes, materials and files the source file depends on into bytes of a cache file.
+         *  Materials are matched with sub-meshes by name, only materials used by sub-meshes are stored.
+         *  Materials of sub-meshes not found in materials are stored without any properties.
+         */
+        [[nodiscard]] static Bytes Serialize(
+            const IndexedMeshes& meshes,
+            const SourceKey& sourceKey,
+            const std::vector<Dependency>& dependencies = {},
+            const std::vector<Material>& materials = {});
+
+        /** Writes serialized bytes to file.
+         *  Bytes are written to a temporary file, which then replaces any existing file,
+         *  so concurrent readers never observe partially written caches.
+         *
+         * @param compress Writes bytes as an Lz4 frame, trading the zero-copy mapping at read for smaller files.
+         *
+         * @return true if file was successfully written.
+         */
+        [[nodiscard]] static bool WriteToFile(const std::filesystem::path& filename, const Bytes& bytes, const bool compress = false);
+
+        /** Memory maps and validates cache file. Previously read data is released.
+         *  Compressed cache files are decompressed into memory, and are not memory mapped after reading.
+         */
+        [[nodiscard]] ReadResult ReadFromFile(const std::filesystem::path& filename);
+
+        /** Takes ownership of and validates serialized bytes. Previously read data is released. */
+        [[nodiscard]] ReadResult ReadFromBytes(Bytes&& bytes);
+
+        /** Checks if data of this file is accessed via a memory mapping. */
+        [[nodiscard]] bool IsMemoryMapped() const;
+
+        /** Get key of source file this cache was built from. */
+        [[nodiscard]] const SourceKey& GetSourceKey() const;
+
+        /** Get meshes, sub-meshes, levels of detail, meshlets and materials of this file. Views are valid for the lifetime of this object. */
+        /**@{*/
+        [[nodiscard]] const std::vector<Mesh>& GetMeshes() const;
+        [[nodiscard]] const std::vector<Submesh>& GetSubmeshes() const;
+        [[nodiscard]] const std::vector<Lod>& GetLods() const;
+        [[nodiscard]] const std::vector<IndexedMeshlet>& GetMeshlets() const;
+        [[nodiscard]] const std::vector<Material>& GetMaterials() const;
+        /**@}*/
+
+        /** Get files the source file depends on, such as material files of obj files. Views are valid for the lifetime of this object. */
+        [[nodiscard]] const std::vector<Dependency>& GetDependencies() const;
+
+        /** Copies all data into indexed meshes. */
+        [[nodiscard]] IndexedMeshes ToIndexedMeshes() const;
+
+    private:
+
+        void Clear();
+        [[nodiscard]] ReadResult Parse(const uint8_t* data, const size_t size);
+
+        MemoryMappedFile m_mappedFile;
+        Bytes m_bytes;
+        SourceKey m_sourceKey;
+        std::vector<Mesh> m_meshes;
+        std::vector<Submesh> m_submeshes;
+        std::vector<Lod> m_lods;
+        std::vector<IndexedMeshlet> m_meshlets;
+        std::vector<Material> m_materials;
+        std::vector<Dependency> m_dependencies;
+
+    };
+
+}
+
+#endif
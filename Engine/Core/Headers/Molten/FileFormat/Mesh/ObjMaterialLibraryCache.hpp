@@ -0,0 +1,125 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_FILEFORMAT_MESH_OBJMATERIALLIBRARYCACHE_HPP
+#define MOLTEN_CORE_FILEFORMAT_MESH_OBJMATERIALLIBRARYCACHE_HPP
+
+#include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+
+namespace Molten
+{
+
+    class VirtualFileSystem;
+
+    /** Thread safe cache of parsed obj material files(mtl), shared by obj mesh file readers.
+     *  Material files are keyed by canonical path, so different relative paths to the same file share one entry,
+     *  and are parsed again only if their size or last write time changes.
+     *  Material files of virtual file systems are keyed by normalized path, and are parsed again only if their size or content hash changes.
+     *  Concurrent loads of the same file are deduplicated; one caller parses the file while the others wait for its result.
+     *  Loaded materials are shared by all obj mesh files referencing the material file, and are therefore immutable.
+     *
+     * Supported commands of material files:
+     * - newmtl, Ka, Kd, Ks, Ns, d, Tr, Ni, Pr, Pm.
+     * - map_Ka, map_Kd, map_Ks, map_Ns, map_d, disp, map_Pr, map_Pm, with texture options -mm, -o, -s and -clamp.
+     * Other commands and texture options are ignored.
+     */
+    class MOLTEN_API ObjMaterialLibraryCache
+    {
+
+    public:
+
+        using MaterialLibrarySharedPointer = ObjMeshFile::MaterialLibrarySharedPointer;
+        using LoadResult = std::variant<MaterialLibrarySharedPointer, TextFileFormatResult::Error>;
+
+        ObjMaterialLibraryCache() = default;
+        ~ObjMaterialLibraryCache() = default;
+
+        ObjMaterialLibraryCache(const ObjMaterialLibraryCache&) = delete;
+        ObjMaterialLibraryCache(ObjMaterialLibraryCache&&) = delete;
+        ObjMaterialLibraryCache& operator = (const ObjMaterialLibraryCache&) = delete;
+        ObjMaterialLibraryCache& operator = (ObjMaterialLibraryCache&&) = delete;
+
+        /** Get process-wide cache, used by obj mesh file readers by default. */
+        [[nodiscard]] static const std::shared_ptr<ObjMaterialLibraryCache>& GetShared();
+
+        /** Parses material file, without any caching. */
+        [[nodiscard]] static LoadResult ReadFromFile(const std::filesystem::path& filename);
+
+        /** Parses material file of virtual file system, without any caching. */
+        [[nodiscard]] static LoadResult ReadFromFile(const VirtualFileSystem& virtualFileSystem, const std::string& path);
+
+        /** Parses material file data in memory, without any caching. Provided name is only used in error messages. */
+        [[nodiscard]] static LoadResult ReadFromData(std::string_view text, const std::string& name);
+
+        /** Get materials of material file, parsing the file if not cached or if the cached file is outdated. Thread safe.
+         *  Failed loads are cached as well, until the file changes.
+         */
+        [[nodiscard]] LoadResult Load(const std::filesystem::path& filename);
+
+        /** Get materials of material file of virtual file system, parsing the file if not cached or if the cached file is outdated. Thread safe. */
+        [[nodiscard]] LoadResult Load(const VirtualFileSystem& virtualFileSystem, const std::string& path);
+
+        /** Removes all cached material files. Materials already handed out stay valid. */
+        void Clear();
+
+        /** Get number of cached material files. */
+        [[nodiscard]] size_t GetLibraryCount() const;
+
+    private:
+
+        struct Library
+        {
+            uint64_t size;
+            int64_t modifiedTime; ///< Last write time of files on disk, 0 for virtual files.
+            uint64_t contentHash; ///< Content hash of virtual files, 0 for files on disk.
+            std::shared_future<LoadResult> result;
+        };
+
+        /** Get cached result of library, or reads it while concurrent loads of the same library wait for the shared result. */
+        [[nodiscard]] LoadResult LoadLibrary(
+            const std::string& key,
+            const uint64_t size,
+            const int64_t modifiedTime,
+            const uint64_t contentHash,
+            const std::function<LoadResult()>& read);
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Library> m_libraries;
+
+    };
+
+}
+
+#endif
@@ -37,13 +37,17 @@
 #include <variant>
 #include <optional>
 #include <future>
+#include <functional>
 
 namespace Molten
 {
 
     /** Forward declarations. */
     class ThreadPool;
+    class MemoryMappedFile;
+    class VirtualFileSystem;
     class ObjMeshFileReader;
+    class ObjMaterialLibraryCache;
 
 
     /** Obj mesh file format.
@@ -64,7 +68,7 @@ namespace Molten
      * - g - Group.
      * - s - Smoothing group
      * - usemtl - Using material.
-     * - mtllib - Loading material file.
+     * - mtllib - Loading material file, parsed once per file and shared via ObjMaterialLibraryCache. Missing material files are skipped.
      * - v - Vertex coordinate.
      * - vn - Vertex normal.
      * - vt - Vertex texture coordinate.
@@ -104,6 +108,7 @@ namespace Molten
         /** Material with optional properties. */
         struct Material
         {
+            std::string name; ///< newmtl
             std::optional<Vector3f32> ambientColor; ///< Ka = rgb{ 0.0 - 1.0, ... }
             std::optional<Vector3f32> diffuseColor; ///< Kd = rgb{ 0.0 - 1.0, ... }
             std::optional<Vector3f32> specularColor; ///< Ks = rgb{ 0.0 - 1.0, ... }
@@ -129,8 +134,9 @@ namespace Molten
             /**@}*/
         };
 
-        using MaterialSharedPointer = std::shared_ptr<Material>;
+        using MaterialSharedPointer = std::shared_ptr<const Material>; ///< Immutable, since materials are shared by all obj files referencing the same material file.
         using MaterialSharedPointers = std::vector<MaterialSharedPointer>;
+        using MaterialLibrarySharedPointer = std::shared_ptr<const MaterialSharedPointers>; ///< Materials of one material file, shared by all referencing obj files.
 
         /** Triangle indices, pointing to Object vertices/normals/textureCoordinates. Index is set to std::numeric_limits<uint32_t>::max() if unused. */
         struct Triangle
@@ -231,6 +237,17 @@ namespace Molten
 
     public:
 
+        /** Input modes of obj files. */
+        enum class InputMode
+        {
+            Stream, ///< File is read in chunks into allocated buffers.
+            MemoryMapped ///< File is mapped read-only and commands are views into the mapping, without any copies. Falls back to Stream if mapping fails.
+        };
+
+        static constexpr size_t DefaultObjectChunkSize = 32768; ///< Default min number of commands per parallel parsed chunk of an object.
+
+        using ObjectCallback = std::function<void(ObjMeshFile::ObjectSharedPointer)>; ///< Callback of finished objects in streaming mode.
+
         Signal<double> onProgress;
 
         ObjMeshFileReader();       
@@ -251,6 +268,8 @@ namespace Molten
             const std::filesystem::path& filename);
 
         /** Read and parse obj mesh file using multiple threads from provided thread pool.
+        *  Parsing is executed with background priority, not to compete with frame critical work of the thread pool.
+        *  Work is only handed to free workers and is otherwise done on the calling thread, so it is safe to call from a worker of the same pool.
         *  Clear() is automatically called on objMeshFile,
         *  so no need to call it manually before calling this function.
         */
@@ -259,6 +278,63 @@ namespace Molten
             const std::filesystem::path& filename,
             ThreadPool& threadPool);
 
+        /** Read and parse obj mesh file in streaming mode, for importing large files with bounded memory.
+         *  Finished objects are passed to onObject as soon as they are parsed, in file order and on the calling thread,
+         *  instead of being stored in objMeshFile. Materials are still stored in objMeshFile.
+         *  Source buffers of each object are released once it is parsed, and the number of objects parsed in parallel is limited,
+         *  so peak memory depends on the size of the largest objects rather than the file size.
+         *  Face indices are global, so consumers resolving faces may need vertex data of preceding objects.
+         */
+        /**@{*/
+        [[nodiscard]] TextFileFormatResult StreamFromFile(
+            ObjMeshFile& objMeshFile,
+            const std::filesystem::path& filename,
+            const ObjectCallback& onObject);
+
+        [[nodiscard]] TextFileFormatResult StreamFromFile(
+            ObjMeshFile& objMeshFile,
+            const std::filesystem::path& filename,
+            ThreadPool& threadPool,
+            const ObjectCallback& onObject);
+        /**@}*/
+
+        /** Set input mode of following reads. Default input mode is MemoryMapped. */
+        void SetInputMode(const InputMode inputMode);
+
+        /** Get current input mode. */
+        [[nodiscard]] InputMode GetInputMode() const;
+
+        /** Set min number of commands per chunk of an object.
+         *  Objects with at least two chunks worth of commands are split into chunks, parsed in parallel by free workers of the thread pool,
+         *  so large single-object files are parsed by multiple threads. Objects are never split if objectChunkSize is 0.
+         */
+        void SetObjectChunkSize(const size_t objectChunkSize);
+
+        /** Get min number of commands per chunk of an object. */
+        [[nodiscard]] size_t GetObjectChunkSize() const;
+
+        /** Set cache of material files used by following reads, or nullptr for parsing material files of each read.
+         *  Readers use the process-wide cache of ObjMaterialLibraryCache::GetShared() by default,
+         *  so material files referenced by multiple obj files are only parsed once.
+         */
+        void SetMaterialLibraryCache(std::shared_ptr<ObjMaterialLibraryCache> materialLibraryCache);
+
+        /** Get cache of material files, nullptr if caching is disabled. */
+        [[nodiscard]] const std::shared_ptr<ObjMaterialLibraryCache>& GetMaterialLibraryCache() const;
+
+        /** Set virtual file system of following reads, or nullptr for reading files from disk.
+         *  Filenames of obj files and their material files are paths of the virtual file system if set,
+         *  and obj files are read directly from the opened file data, regardless of input mode.
+         *  Material files read via a virtual file system are cached by normalized path and content hash.
+         */
+        void SetVirtualFileSystem(std::shared_ptr<const VirtualFileSystem> virtualFileSystem);
+
+        /** Get virtual file system, nullptr if files are read from disk. */
+        [[nodiscard]] const std::shared_ptr<const VirtualFileSystem>& GetVirtualFileSystem() const;
+
+        /** Get paths of material files referenced by last read, in order of first reference. */
+        [[nodiscard]] const std::vector<std::string>& GetMaterialFilenames() const;
+
     private:
 
         enum class ObjectCommandType
@@ -302,23 +378,47 @@ namespace Molten
         };
         
         using ObjectCommands = std::vector<ObjectCommand>;
-        using Buffer = std::shared_ptr<char[]>;
+        using Buffer = std::shared_ptr<const void>; ///< Owner of memory referenced by commands, a read buffer or a memory mapped file.
         using Buffers = std::vector<Buffer>;
 
         struct ObjectBuffer
         {
             Buffers buffers;
             ObjectCommands commands;
+            const MemoryMappedFile* mappedFile; ///< Mapped file of commands, if read via MemoryMapped input mode.
         };
 
         using ObjectBufferSharedPointer = std::shared_ptr<ObjectBuffer>;
 
+        /** Grouping command of an object chunk, applied to the object when stitching chunks. */
+        struct ObjectChunkCommand
+        {
+            size_t triangleCount; ///< Number of triangles of the chunk preceding this command.
+            ObjectCommandType type;
+            std::string_view data; ///< Trimmed command data, without command token.
+            uint32_t smoothingGroupId; ///< Parsed id of smoothing group commands.
+        };
+
+        /** Parsed data of a chunk of object commands. */
+        struct ObjectChunk
+        {
+            ObjMeshFile::Vertices vertices;
+            ObjMeshFile::Normals normals;
+            ObjMeshFile::Uv textureCoordinates;
+            ObjMeshFile::Triangles triangles;
+            std::vector<ObjectChunkCommand> commands;
+        };
+
+        using ObjectChunks = std::vector<ObjectChunk>;
+
         using Material = ObjMeshFile::Material;
-        using MaterialSharedPointer = std::shared_ptr<Material>;
-        using ProcessMaterialResult = std::variant<MaterialSharedPointer, TextFileFormatResult::Error>;
+        using MaterialSharedPointer = ObjMeshFile::MaterialSharedPointer;
+        using MaterialLibrarySharedPointer = ObjMeshFile::MaterialLibrarySharedPointer;
+        using ProcessMaterialResult = std::variant<MaterialLibrarySharedPointer, TextFileFormatResult::Error>;
         using ProcessMaterialFuture = std::future<ProcessMaterialResult>;
         using ProcessMaterialFutures = std::vector<ProcessMaterialFuture>;
 
+        using Triangles = ObjMeshFile::Triangles;
         using SmoothingGroup = ObjMeshFile::SmoothingGroup;
         using Group = ObjMeshFile::Group;
         using Object = ObjMeshFile::Object;
@@ -334,18 +434,43 @@ namespace Molten
             ObjMeshFile& objMeshFile,
             const std::filesystem::path& filename);
 
+        /** Waits for all object futures after InternalReadFromFile, also if reading failed. */
+        void WaitForObjectFutures();
+
         void Prepare(
             ObjMeshFile& objMeshFile, 
             const std::filesystem::path& filename);
 
+        /** Reads and processes all lines of provided line reader, BufferedFileLineReader or MemoryMappedFileLineReader. */
+        template<typename TLineReader>
+        [[nodiscard]] TextFileFormatResult ReadLines(TLineReader& lineReader);
+
         [[nodiscard]] TextFileFormatResult ExecuteProcessMaterial(MaterialCommand&& materialCommand);
-        [[nodiscard]] ProcessMaterialResult ProcessMaterial(std::string&& filename);
+        [[nodiscard]] ProcessMaterialResult ProcessMaterial(const std::string& filename) const;
         [[nodiscard]] ProcessMaterialFuture ProcessMaterialAsync(std::string&& filename);
 
+        /** Adds materials of processed material file to obj mesh file. */
+        void AddMaterials(const MaterialLibrarySharedPointer& materials);
+
         [[nodiscard]] TextFileFormatResult ExecuteProcessObject(ObjectBufferSharedPointer objectBuffer);
         [[nodiscard]] ProcessObjectResult ProcessObject(ObjectBufferSharedPointer objectBuffer);
         [[nodiscard]] ProcessObjectFuture ProcessObjectAsync(ObjectBufferSharedPointer objectBuffer);
 
+        /** Stores finished object in obj mesh file, or passes it to the object callback in streaming mode. */
+        void DeliverObject(ObjectSharedPointer object);
+
+        /** Get max number of objects being parsed in parallel in streaming mode. */
+        [[nodiscard]] size_t GetMaxPendingObjectCount() const;
+
+        [[nodiscard]] size_t GetObjectChunkCount(const size_t commandCount) const;
+        [[nodiscard]] TextFileFormatResult ProcessObjectChunks(const ObjectCommands& commands, ObjectChunks& chunks);
+        [[nodiscard]] static TextFileFormatResult ProcessObjectChunk(
+            const ObjectCommands& commands,
+            const size_t begin,
+            const size_t end,
+            ObjectChunk& chunk);
+        [[nodiscard]] static ObjectSharedPointer StitchObjectChunks(ObjectChunks& chunks);
+
         [[nodiscard]] TextFileFormatResult HandleFutures();
         [[nodiscard]] TextFileFormatResult HandleMaterialFutures();
         [[nodiscard]] TextFileFormatResult HandleObjectFutures();
@@ -354,10 +479,15 @@ namespace Molten
         [[nodiscard]] TextFileFormatResult TryHandleMaterialFutures();
         [[nodiscard]] TextFileFormatResult TryHandleObjectFutures();
 
+        InputMode m_inputMode;
+        size_t m_objectChunkSize;
         ThreadPool* m_threadPool;
+        const ObjectCallback* m_onObject;
         ObjMeshFile* m_objMeshFile;
         std::filesystem::path m_objMeshDirectory;
-        std::vector<std::string> m_materialFilenames;
+        std::shared_ptr<ObjMaterialLibraryCache> m_materialLibraryCache;
+        std::shared_ptr<const VirtualFileSystem> m_virtualFileSystem;
+        std::vector<std::string> m_materialFilenames; ///< Material files referenced by current or last read, for skipping duplicated mtllib commands.
         ProcessMaterialFutures m_materialFutures;
         ProcessObjectFutures m_objectFutures;
 
@@ -29,7 +29,9 @@
 #include "Molten/Math/Vector.hpp"
 #include "Molten/Math/Bounds.hpp"
 #include "Molten/Math/AABB.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <map>
@@ -69,6 +71,14 @@ namespace Molten::Gui
         /** Clear all cached font paths. */
         void ClearPathCache();
 
+        /** Set virtual file system of following directories and font files, or nullptr for files on disk.
+         *  Cached font paths are cleared, but already added directories are kept.
+         */
+        void SetVirtualFileSystem(std::shared_ptr<const VirtualFileSystem> virtualFileSystem);
+
+        /** Get virtual file system, nullptr if fonts are found on disk. */
+        [[nodiscard]] const std::shared_ptr<const VirtualFileSystem>& GetVirtualFileSystem() const;
+
         /** Add font search directory. */
         bool AddDirectory(const std::string& directory);
 
@@ -78,8 +88,12 @@ namespace Molten::Gui
         /** Find font path by font name. Returns empty string if not found. */
         [[nodiscard]] std::string FindFontFamilyPath(const std::string& fontFamily);
 
+        /** Opens font file of path found by FindFontFamilyPath. Files on disk are memory mapped. Returns nullopt if not found. */
+        [[nodiscard]] std::optional<VirtualFile> OpenFontFile(const std::string& fontPath) const;
+
     private:
 
+        std::shared_ptr<const VirtualFileSystem> m_virtualFileSystem;
         std::vector<std::string> m_fontDirectories;
         std::map<std::string, std::string> m_cachedFontPaths;
 
@@ -27,14 +27,23 @@
 #define MOLTEN_CORE_LOGGER_HPP
 
 #include "Molten/Types.hpp"
+#include "Molten/System/Time.hpp"
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <fstream>
 
 namespace Molten
 {
 
-    /** Logger class. */
+    /** Logger class.
+     *
+     *  Messages are passed to the callback on the writing thread by default.
+     *  In asynchronous mode, writing threads copy messages to their own lock-free ring buffer instead,
+     *  and a background thread passes them to the callback in batches, see EnableAsync.
+     */
     class MOLTEN_API Logger
     {
 
@@ -54,6 +63,9 @@ namespace Molten
         /** Constant, containing all severity flags. */
         static const uint32_t SeverityAllFlags;
 
+        /** Default size in bytes of the ring buffer of each writing thread in asynchronous mode. */
+        static constexpr size_t DefaultAsyncBufferSize = 64 * 1024;
+
         /**
          * Default constructor.
          *
@@ -74,7 +86,7 @@ namespace Molten
          */
         Logger(const uint32_t severityFlags, Logger* parent);
 
-        /** Virtual destructor. */
+        /** Virtual destructor. Disables asynchronous mode. */
         virtual ~Logger();
 
         /** Set log severity flags. */
@@ -89,20 +101,57 @@ namespace Molten
         /** Write log message function. */
         virtual void Write(const Severity severity, const std::string& message);
 
+        /** Write log message function. Does not allocate in asynchronous mode. */
+        virtual void Write(const Severity severity, const std::string_view message);
+
         /** 
          * Helper funktion for writing log messages.
          * The funktion returns immediately if logger == nullptr.
          */
         /**@{*/
-        static void Write(Logger* logger, const Severity severity, const std::string& message);
-        static void WriteInfo(Logger * logger, const std::string& message);
-        static void WriteDebug(Logger * logger, const std::string& message);
-        static void WriteWarning(Logger * logger, const std::string& message);
-        static void WriteError(Logger * logger, const std::string& message);
+        static void Write(Logger* logger, const Severity severity, const std::string_view message);
+        static void WriteInfo(Logger * logger, const std::string_view message);
+        static void WriteDebug(Logger * logger, const std::string_view message);
+        static void WriteWarning(Logger * logger, const std::string_view message);
+        static void WriteError(Logger * logger, const std::string_view message);
         /**@}*/
+
+        /**
+         * Enables asynchronous mode.
+         * Written messages are copied to a lock-free ring buffer of the writing thread,
+         * and passed to the callback in batches by a background thread, at least once per flush interval.
+         * Messages are dropped if the ring buffer of the writing thread is full, see GetDroppedMessageCount.
+         * Order of messages is only kept per writing thread.
+         * Must not be called while other threads are writing.
+         *
+         * @param bufferSize Size in bytes of the ring buffer of each writing thread, rounded up to power of two.
+         *                   Messages longer than half of the buffer are truncated.
+         * @param flushInterval Max time between writing a message and passing it to the callback.
+         */
+        void EnableAsync(const size_t bufferSize = DefaultAsyncBufferSize, const Time flushInterval = Milliseconds(50));
+
+        /** Disables asynchronous mode, after passing all written messages to the callback. Must not be called while other threads are writing. */
+        void DisableAsync();
+
+        /** Checks if asynchronous mode is enabled. */
+        bool IsAsync() const;
+
+        /** Blocks until all messages written before this call are passed to the callback, and flushes output. */
+        void Flush();
+
+        /** Get number of messages dropped in asynchronous mode, due to full ring buffers. */
+        uint64_t GetDroppedMessageCount() const;
+
+        /** Get number of ring buffers of writing threads in asynchronous mode. Buffers of exited threads are released by the background thread once empty. */
+        size_t GetAsyncBufferCount() const;
         
     protected:
 
+        /** Flushes output of callback. Called after every message in synchronous mode, and after every batch in asynchronous mode.
+         *  Derived classes overriding this function must call DisableAsync in their destructor.
+         */
+        virtual void FlushOutput();
+
         Logger(const Logger&) = delete;
         Logger(Logger&&) = delete;
         Logger& operator=(const Logger&) = delete;
@@ -111,6 +160,15 @@ namespace Molten
         uint32_t m_severityFlags;
         Callback m_callback;
 
+    private:
+
+        struct AsyncState;
+
+        void WriteAsync(const Severity severity, const std::string_view message);
+        void RunAsync();
+
+        std::unique_ptr<AsyncState> m_async;
+
     };
 
 
@@ -148,6 +206,11 @@ namespace Molten
         /** Checks if the log file is open. */
         virtual bool IsOpen() const;
 
+    protected:
+
+        /** Flushes the log file. */
+        void FlushOutput() override;
+
     private:
 
         FileLogger(const FileLogger&) = delete;
@@ -155,6 +218,7 @@ namespace Molten
         FileLogger& operator=(const FileLogger&) = delete;
         FileLogger& operator=(FileLogger&&) = delete;
 
+        mutable std::mutex m_fileMutex;
         std::ofstream m_file;
 
     };
@@ -26,7 +26,7 @@
 namespace Molten
 {
 
-    inline void Logger::Write(Logger* logger, const Severity severity,  const std::string& message)
+    inline void Logger::Write(Logger* logger, const Severity severity,  const std::string_view message)
     {
         if (logger == nullptr)
         {
@@ -35,7 +35,7 @@ namespace Molten
         logger->Write(severity, message);
     }
 
-    inline void Logger::WriteInfo(Logger * logger, const std::string& message)
+    inline void Logger::WriteInfo(Logger * logger, const std::string_view message)
     {
         if(logger == nullptr)
         {
@@ -44,7 +44,7 @@ namespace Molten
         logger->Write(Severity::Info, message);
     }
 
-    inline void Logger::WriteDebug(Logger * logger, const std::string& message)
+    inline void Logger::WriteDebug(Logger * logger, const std::string_view message)
     {
         if(logger == nullptr)
         {
@@ -53,7 +53,7 @@ namespace Molten
         logger->Write(Severity::Debug, message);
     }
 
-    inline void Logger::WriteWarning(Logger * logger, const std::string& message)
+    inline void Logger::WriteWarning(Logger * logger, const std::string_view message)
     {
         if(logger == nullptr)
         {
@@ -62,7 +62,7 @@ namespace Molten
         logger->Write(Severity::Warning, message);
     }
 
-    inline void Logger::WriteError(Logger * logger, const std::string& message)
+    inline void Logger::WriteError(Logger * logger, const std::string_view message)
     {
         if(logger == nullptr)
         {
@@ -495,7 +495,7 @@ namespace Molten
     {
         x /= static_cast<T>(scalar);
         y /= static_cast<T>(scalar);
-        y /= static_cast<T>(scalar);
+        z /= static_cast<T>(scalar);
         return *this;
     }
 
@@ -754,7 +754,7 @@ namespace Molten
     {
         x /= static_cast<T>(scalar);
         y /= static_cast<T>(scalar);
-        y /= static_cast<T>(scalar);
+        z /= static_cast<T>(scalar);
         w /= static_cast<T>(scalar);
         return *this;
     }
@@ -0,0 +1,91 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_MEMORY_FRAMEALLOCATOR_HPP
+#define MOLTEN_CORE_MEMORY_FRAMEALLOCATOR_HPP
+
+#include "Molten/Memory/LinearAllocator.hpp"
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Molten
+{
+
+    /** Frame allocator, providing one thread-local linear allocator per thread for short-lived scratch memory.
+     *  All thread-local allocators are reset at once by calling Reset(), typically at the end of each frame.
+     *  Memory allocated from this allocator must not be used after Reset(), so work running across frame boundaries,
+     *  such as background work of a thread pool, should use its own LinearAllocator instead.
+     */
+    class MOLTEN_API FrameAllocator
+    {
+
+    public:
+
+        /** Constructor. Each thread-local linear allocator is created with provided block size. */
+        explicit FrameAllocator(const size_t blockSize = LinearAllocator::DefaultBlockSize);
+
+        /** Default destructor. */
+        ~FrameAllocator() = default;
+
+        /** Deleted copy and move constructors/operators. */
+        /**@{*/
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator(FrameAllocator&&) = delete;
+        FrameAllocator& operator = (const FrameAllocator&) = delete;
+        FrameAllocator& operator = (FrameAllocator&&) = delete;
+        /**@}*/
+
+        /** Get linear allocator of current thread. The allocator is created at first call from each thread.
+         *  Only the first call per thread is synchronized, following calls are lock free.
+         */
+        [[nodiscard]] LinearAllocator& GetThreadAllocator();
+
+        /** Allocates uninitialized memory from the linear allocator of current thread. */
+        [[nodiscard]] void* Allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+
+        /** Resets all thread-local linear allocators. Must not be called while any thread is using memory of this allocator. */
+        void Reset();
+
+        /** Get total number of allocated bytes since last reset, of all threads. */
+        [[nodiscard]] size_t GetUsedSize();
+
+        /** Get number of thread-local linear allocators. */
+        [[nodiscard]] size_t GetThreadAllocatorCount();
+
+    private:
+
+        using LinearAllocatorPointer = std::unique_ptr<LinearAllocator>;
+
+        uint64_t m_id;
+        size_t m_blockSize;
+        std::mutex m_mutex;
+        std::unordered_map<std::thread::id, LinearAllocatorPointer> m_threadAllocators;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_MEMORY_LINEARALLOCATOR_HPP
+#define MOLTEN_CORE_MEMORY_LINEARALLOCATOR_HPP
+
+#include "Molten/Types.hpp"
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+namespace Molten
+{
+
+    /** Linear(arena) allocator, handing out memory by bumping an offset in large pre-allocated blocks.
+     *  Individual allocations are never freed, all memory is released at once via Reset().
+     *  A new block is allocated if the current block is exhausted, and all blocks are merged into a single block at Reset(),
+     *  making any repeated workload, such as a frame, free from heap allocations after the first round.
+     *  This class is not thread safe, use one allocator per thread, see FrameAllocator.
+     */
+    class MOLTEN_API LinearAllocator
+    {
+
+    public:
+
+        static constexpr size_t DefaultBlockSize = 64 * 1024; ///< Default size of blocks in bytes.
+
+        /** Constructor. Initial block of blockSize bytes is allocated at construction. */
+        explicit LinearAllocator(const size_t blockSize = DefaultBlockSize);
+
+        /** Destructor. All blocks are freed, no destructors of allocated objects are called. */
+        ~LinearAllocator() = default;
+
+        /** Deleted copy and move constructors/operators. */
+        /**@{*/
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator(LinearAllocator&&) = delete;
+        LinearAllocator& operator = (const LinearAllocator&) = delete;
+        LinearAllocator& operator = (LinearAllocator&&) = delete;
+        /**@}*/
+
+        /** Allocates uninitialized memory. Alignment must be a power of two. Returned pointer is never nullptr. */
+        [[nodiscard]] void* Allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+
+        /** Allocates uninitialized memory for count elements of T. */
+        template<typename T>
+        [[nodiscard]] T* AllocateArray(const size_t count);
+
+        /** Constructs an object of T. Destructor of T is never called, so T must be trivially destructible. */
+        template<typename T, typename ... TArgs>
+        [[nodiscard]] T* New(TArgs&& ... args);
+
+        /** Releases all allocated memory at once. Any previously allocated memory is invalidated.
+         *  Blocks are merged into a single block of total capacity, if more than one block was used.
+         */
+        void Reset();
+
+        /** Get number of allocated bytes since last reset, including alignment padding. */
+        [[nodiscard]] size_t GetUsedSize() const;
+
+        /** Get total capacity of all blocks in bytes. */
+        [[nodiscard]] size_t GetCapacity() const;
+
+        /** Get number of allocated blocks. */
+        [[nodiscard]] size_t GetBlockCount() const;
+
+    private:
+
+        struct Block
+        {
+            std::unique_ptr<Byte[]> data;
+            size_t size;
+        };
+
+        [[nodiscard]] void* AllocateFromNextBlock(const size_t size, const size_t alignment);
+
+        size_t m_blockSize;
+        std::vector<Block> m_blocks;
+        size_t m_currentBlock;
+        size_t m_currentOffset;
+        size_t m_usedSize;
+
+    };
+
+
+    /** STL compatible allocator, allocating memory from a LinearAllocator. Deallocation does nothing.
+     *  @example std::vector<int, ScratchAllocator<int>> values{ ScratchAllocator<int>{ linearAllocator } };
+     */
+    template<typename T>
+    class ScratchAllocator
+    {
+
+    public:
+
+        using value_type = T;
+
+        explicit ScratchAllocator(LinearAllocator& linearAllocator) noexcept;
+
+        template<typename U>
+        ScratchAllocator(const ScratchAllocator<U>& other) noexcept;
+
+        [[nodiscard]] T* allocate(const size_t count);
+        void deallocate(T* pointer, const size_t count) noexcept;
+
+        [[nodiscard]] LinearAllocator* GetLinearAllocator() const noexcept;
+
+    private:
+
+        LinearAllocator* m_linearAllocator;
+
+    };
+
+    template<typename T, typename U>
+    bool operator == (const ScratchAllocator<T>& lhs, const ScratchAllocator<U>& rhs) noexcept;
+    template<typename T, typename U>
+    bool operator != (const ScratchAllocator<T>& lhs, const ScratchAllocator<U>& rhs) noexcept;
+
+    template<typename T>
+    using ScratchVector = std::vector<T, ScratchAllocator<T>>; ///< Vector type allocating from a LinearAllocator.
+
+}
+
+#include "Molten/Memory/LinearAllocator.inl"
+
+#endif
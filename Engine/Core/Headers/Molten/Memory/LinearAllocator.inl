@@ -0,0 +1,84 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+namespace Molten
+{
+
+    // Linear allocator implementations.
+    template<typename T>
+    T* LinearAllocator::AllocateArray(const size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<typename T, typename ... TArgs>
+    T* LinearAllocator::New(TArgs&& ... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "LinearAllocator::New: T must be trivially destructible.");
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+    }
+
+
+    // Scratch allocator implementations.
+    template<typename T>
+    ScratchAllocator<T>::ScratchAllocator(LinearAllocator& linearAllocator) noexcept :
+        m_linearAllocator(&linearAllocator)
+    {}
+
+    template<typename T>
+    template<typename U>
+    ScratchAllocator<T>::ScratchAllocator(const ScratchAllocator<U>& other) noexcept :
+        m_linearAllocator(other.GetLinearAllocator())
+    {}
+
+    template<typename T>
+    T* ScratchAllocator<T>::allocate(const size_t count)
+    {
+        return m_linearAllocator->AllocateArray<T>(count);
+    }
+
+    template<typename T>
+    void ScratchAllocator<T>::deallocate(T*, const size_t) noexcept
+    {}
+
+    template<typename T>
+    LinearAllocator* ScratchAllocator<T>::GetLinearAllocator() const noexcept
+    {
+        return m_linearAllocator;
+    }
+
+    template<typename T, typename U>
+    bool operator == (const ScratchAllocator<T>& lhs, const ScratchAllocator<U>& rhs) noexcept
+    {
+        return lhs.GetLinearAllocator() == rhs.GetLinearAllocator();
+    }
+
+    template<typename T, typename U>
+    bool operator != (const ScratchAllocator<T>& lhs, const ScratchAllocator<U>& rhs) noexcept
+    {
+        return lhs.GetLinearAllocator() != rhs.GetLinearAllocator();
+    }
+
+}
@@ -0,0 +1,143 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_INDEXEDMESH_HPP
+#define MOLTEN_CORE_MESH_INDEXEDMESH_HPP
+
+#include "Molten/Math/Vector.hpp"
+#include "Molten/Math/Bounds.hpp"
+#include "Molten/Renderer/VertexBuffer.hpp"
+#include "Molten/Renderer/IndexBuffer.hpp"
+#include <string>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Interleaved vertex of indexed meshes, ready for upload via VertexBufferDescriptor. */
+    struct IndexedMeshVertex
+    {
+        Vector3f32 position;
+        Vector3f32 normal; ///< Zero vector if not provided by source mesh.
+        Vector2f32 textureCoordinate; ///< Zero vector if not provided by source mesh.
+        Vector4f32 tangent = { 0.0f, 0.0f, 0.0f, 1.0f }; ///< Tangent in xyz and bitangent sign in w, bitangent = w * cross(normal, tangent).
+    };
+
+    using IndexedMeshVertices = std::vector<IndexedMeshVertex>;
+
+
+    /** Packed triangle list indices, stored as 16 bit integers if all indices fits, else as 32 bit integers. */
+    struct MOLTEN_API IndexedMeshIndices
+    {
+        IndexedMeshIndices();
+
+        IndexBuffer::DataType indexDataType; ///< Type of indices stored in indexData.
+        std::vector<uint8_t> indexData; ///< Packed indices of type indexDataType, 3 indices per triangle.
+
+        /** Get number of indices in indexData. */
+        [[nodiscard]] size_t GetIndexCount() const;
+
+        /** Get index at position, accessing an index out of range is undefined behavior. */
+        [[nodiscard]] uint32_t GetIndex(const size_t position) const;
+
+        /** Get all indices as 32 bit integers. */
+        [[nodiscard]] std::vector<uint32_t> GetIndices() const;
+
+        /** Packs indices into indexData, as 16 bit integers if all indices fits, else as 32 bit integers. */
+        void SetIndices(const std::vector<uint32_t>& indices);
+
+        /** Get descriptor for creating renderer index buffer, referencing indexData. */
+        [[nodiscard]] IndexBufferDescriptor GetIndexBufferDescriptor() const;
+    };
+
+
+    /** Level of detail of sub-mesh, made of simplified triangles referencing vertices of the parent sub-mesh. */
+    struct MOLTEN_API IndexedSubmeshLod : IndexedMeshIndices
+    {
+        IndexedSubmeshLod();
+
+        float error; ///< Approximate geometric deviation from the full detail sub-mesh, in mesh units.
+    };
+
+    using IndexedSubmeshLods = std::vector<IndexedSubmeshLod>;
+
+
+    /** Cluster of nearby triangles of a sub-mesh, with bounds for culling at cluster granularity.
+     *  Meshlet triangles reference vertices of the meshlet, which in turn reference vertices of the sub-mesh.
+     */
+    struct MOLTEN_API IndexedMeshlet
+    {
+        IndexedMeshlet();
+
+        uint32_t vertexOffset; ///< Offset of first vertex in meshletVertices of sub-mesh.
+        uint32_t vertexCount; ///< Number of vertices of meshlet.
+        uint32_t triangleOffset; ///< Offset of first local index in meshletTriangles of sub-mesh.
+        uint32_t triangleCount; ///< Number of triangles of meshlet, 3 local indices per triangle.
+        Vector3f32 center; ///< Center of bounding sphere.
+        float radius; ///< Radius of bounding sphere.
+        Bounds3f32 bounds; ///< Axis aligned bounding box.
+        Vector3f32 coneApex; ///< Apex of normal cone.
+        Vector3f32 coneAxis; ///< Unit axis of normal cone, zero vector if meshlet cannot be back-face culled.
+        float coneCutoff; ///< Sine of normal cone half angle, 1 if meshlet cannot be back-face culled.
+
+        /** Checks if all triangles of meshlet are back-facing, seen from view position. */
+        [[nodiscard]] bool IsBackFacing(const Vector3f32& viewPosition) const;
+    };
+
+    using IndexedMeshlets = std::vector<IndexedMeshlet>;
+
+
+    /** Indexed sub-mesh, containing all triangles of a mesh using the same material.
+     *  Each sub-mesh owns its vertex and index data, since buffers are drawn as a whole.
+     */
+    struct MOLTEN_API IndexedSubmesh : IndexedMeshIndices
+    {
+        std::string material; ///< Material name, empty if using the default material.
+        IndexedMeshVertices vertices; ///< Unique vertices of this sub-mesh.
+        IndexedSubmeshLods lods; ///< Levels of detail in order of decreasing triangle count, not including this sub-mesh itself.
+        IndexedMeshlets meshlets; ///< Meshlets of full detail triangles, empty if not built.
+        std::vector<uint32_t> meshletVertices; ///< Sub-mesh vertex indices of all meshlets.
+        std::vector<uint8_t> meshletTriangles; ///< Meshlet local vertex indices of all meshlets, 3 per triangle.
+
+        /** Get descriptor for creating renderer vertex buffer, referencing vertices of this sub-mesh. */
+        [[nodiscard]] VertexBufferDescriptor GetVertexBufferDescriptor() const;
+    };
+
+    using IndexedSubmeshes = std::vector<IndexedSubmesh>;
+
+
+    /** Indexed mesh, made of one or multiple sub-meshes. */
+    struct IndexedMesh
+    {
+        std::string name;
+        IndexedSubmeshes submeshes;
+    };
+
+    using IndexedMeshes = std::vector<IndexedMesh>;
+
+}
+
+#endif
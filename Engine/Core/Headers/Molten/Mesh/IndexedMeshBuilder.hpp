@@ -0,0 +1,73 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_INDEXEDMESHBUILDER_HPP
+#define MOLTEN_CORE_MESH_INDEXEDMESHBUILDER_HPP
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include "Molten/System/Result.hpp"
+#include <string>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class ObjMeshFile;
+    class ThreadPool;
+
+
+    /** Builder of GPU-ready indexed meshes.
+     *
+     * Building from an ObjMeshFile produces one IndexedMesh per object and one sub-mesh per used material of each object.
+     * Groups using the same material are merged into the same sub-mesh.
+     * Unique combinations of position, texture coordinate and normal indices are welded into single vertices via a hash table.
+     * Face indices of obj files are global, so faces may reference vertex data of any preceding object.
+     *
+     * Faces without normals get angle weighted smooth normals, shared by all faces of the same smoothing group id of an object,
+     * or flat face normals if smoothing is off. Tangents are generated for all sub-meshes, see MeshNormalGenerator.
+     */
+    class MOLTEN_API IndexedMeshBuilder
+    {
+
+    public:
+
+        using BuildResult = Result<IndexedMeshes, std::string>;
+
+        /** Builds indexed meshes from obj mesh file.
+         *  Sub-meshes are built in parallel if a thread pool is provided, with help of free workers only,
+         *  making it safe to call from work running on a worker of the same thread pool.
+         *
+         * @return Indexed meshes, or error message if any face is referencing vertex data out of range.
+         */
+        [[nodiscard]] static BuildResult BuildFromObjMeshFile(
+            const ObjMeshFile& objMeshFile,
+            ThreadPool* threadPool = nullptr);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_MESHNORMALGENERATOR_HPP
+#define MOLTEN_CORE_MESH_MESHNORMALGENERATOR_HPP
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include <array>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class ThreadPool;
+
+
+    /** Generator of vertex normals and tangents of triangle meshes.
+     *  Normals and tangents are averaged over all triangles sharing a vertex, weighted by the triangle corner angles,
+     *  so results do not depend on how polygons were triangulated. All functions are deterministic.
+     *
+     * Tangents follow the conventions of MikkTSpace, so normal maps baked by common tools are reproduced:
+     * tangents are orthogonalized against the vertex normal, the bitangent sign is stored in w,
+     * the bitangent is reconstructed as w * cross(normal, tangent), and vertices shared by triangles of opposite
+     * texture space handedness, i.e. mirrored texture coordinates, are split.
+     */
+    class MOLTEN_API MeshNormalGenerator
+    {
+
+    public:
+
+        /** Calculates unit normal of counter-clockwise triangle, or zero vector if triangle is degenerate. */
+        [[nodiscard]] static Vector3f32 CalculateTriangleNormal(
+            const Vector3f32& position0,
+            const Vector3f32& position1,
+            const Vector3f32& position2);
+
+        /** Calculates interior angles of triangle corners, in radians. */
+        [[nodiscard]] static std::array<float, 3> CalculateTriangleAngles(
+            const Vector3f32& position0,
+            const Vector3f32& position1,
+            const Vector3f32& position2);
+
+        /** Generates smooth normals, averaging normals of all triangles referencing the same position.
+         *
+         * @return Unit normal per position, or zero vector for positions not referenced by any non-degenerate triangle.
+         */
+        [[nodiscard]] static std::vector<Vector3f32> GenerateSmoothNormals(
+            const std::vector<Vector3f32>& positions,
+            const std::vector<uint32_t>& indices);
+
+        /** Generates tangents of vertices, from their normals and texture coordinates.
+         *  Vertices with mirrored texture coordinates are split, by appending vertices and remapping indices.
+         *  Vertices of triangles without texture coordinate area get an arbitrary tangent orthogonal to their normal.
+         */
+        static void GenerateTangents(
+            IndexedMeshVertices& vertices,
+            std::vector<uint32_t>& indices);
+
+        /** Generates tangents of sub-mesh. Levels of detail stay valid, but should be generated afterwards to reference split vertices. */
+        static void GenerateTangents(IndexedSubmesh& submesh);
+
+        /** Generates tangents of all sub-meshes of meshes, in parallel per sub-mesh if a thread pool is provided.
+         *  Only free workers of the thread pool are used, so it is safe to call from work running on a worker of the same thread pool.
+         */
+        static void GenerateTangents(IndexedMeshes& meshes, ThreadPool* threadPool = nullptr);
+
+    };
+
+}
+
+#endif
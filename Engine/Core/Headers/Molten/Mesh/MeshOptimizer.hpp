@@ -0,0 +1,104 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_MESHOPTIMIZER_HPP
+#define MOLTEN_CORE_MESH_MESHOPTIMIZER_HPP
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include <vector>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class ThreadPool;
+
+
+    /** Post-processing optimizer of indexed triangle lists, improving GPU vertex processing throughput.
+     *  All functions are deterministic, so optimized meshes can be cached.
+     *
+     * Optimizations, in the order applied by OptimizeSubmesh:
+     * - Vertex cache: Triangles are reordered for post-transform vertex cache reuse, using Tom Forsyth's linear-speed algorithm.
+     * - Overdraw: Triangles are split into clusters at cache-friendly boundaries, and clusters are sorted front-to-back
+     *   from an outside view, so fewer occluded fragments are shaded. Triangle order within clusters is kept.
+     * - Vertex fetch: Vertices are reordered by first use of the index buffer, improving memory locality of vertex fetching.
+     *
+     * Triangle winding is never changed.
+     */
+    class MOLTEN_API MeshOptimizer
+    {
+
+    public:
+
+        static constexpr size_t DefaultCacheSize = 32; ///< Simulated vertex cache size, in vertices.
+        static constexpr float DefaultOverdrawThreshold = 1.05f; ///< Max vertex cache miss ratio increase caused by overdraw optimization.
+
+        /** Reorders triangles for vertex cache efficiency.
+         *
+         * @param indices Triangle list indices, 3 indices per triangle.
+         * @param vertexCount Number of vertices referenced by indices.
+         */
+        static void OptimizeVertexCache(
+            std::vector<uint32_t>& indices,
+            const size_t vertexCount,
+            const size_t cacheSize = DefaultCacheSize);
+
+        /** Reorders clusters of triangles to reduce overdraw. Indices should be optimized for vertex cache first.
+         *
+         * @param threshold Max allowed cache miss ratio, relative to the miss ratio of the provided indices.
+         */
+        static void OptimizeOverdraw(
+            std::vector<uint32_t>& indices,
+            const IndexedMeshVertices& vertices,
+            const float threshold = DefaultOverdrawThreshold,
+            const size_t cacheSize = DefaultCacheSize);
+
+        /** Reorders vertices by first use in indices and removes unused vertices. Indices are remapped accordingly. */
+        static void OptimizeVertexFetch(
+            IndexedMeshVertices& vertices,
+            std::vector<uint32_t>& indices);
+
+        /** Runs all optimizations on sub-mesh. Indices of levels of detail are remapped to the reordered vertices. */
+        static void OptimizeSubmesh(IndexedSubmesh& submesh);
+
+        /** Runs all optimizations on all sub-meshes of meshes, in parallel per sub-mesh if a thread pool is provided.
+         *  Only free workers of the thread pool are used, so it is safe to call from work running on a worker of the same thread pool.
+         */
+        static void OptimizeMeshes(IndexedMeshes& meshes, ThreadPool* threadPool = nullptr);
+
+        /** Calculates average cache miss ratio, i.e. transformed vertices per triangle, of a FIFO vertex cache.
+         *  Optimal value is 0.5 for large regular grids, and worst value is 3.0.
+         */
+        [[nodiscard]] static float CalculateAverageCacheMissRatio(
+            const std::vector<uint32_t>& indices,
+            const size_t vertexCount,
+            const size_t cacheSize = DefaultCacheSize);
+
+    };
+
+}
+
+#endif
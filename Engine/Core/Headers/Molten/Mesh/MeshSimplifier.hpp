@@ -0,0 +1,105 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_MESHSIMPLIFIER_HPP
+#define MOLTEN_CORE_MESH_MESHSIMPLIFIER_HPP
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include <limits>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class ThreadPool;
+
+
+    /** Triangle mesh simplifier, generating levels of detail via quadric error metric edge collapses.
+     *  Vertices are never moved or created; each collapse merges a vertex into one of its neighbors,
+     *  so simplified indices reference the vertices of the source mesh and levels of detail can share vertex buffer.
+     *  All functions are deterministic, so simplified meshes can be cached.
+     *
+     * Collapses operate on positions: all vertices sharing a position, such as corners of flat shaded meshes, are collapsed together,
+     * each into the vertex of the target position with the most similar normal and texture coordinate.
+     * Collapse costs are the sum of the position quadric error of both positions,
+     * and the weighted squared difference of the attributes of their vertices.
+     * Positions on open borders, on non-manifold edges and on texture coordinate seams,
+     * i.e. positions shared by vertices of different texture coordinates, are never collapsed,
+     * so borders and UV seams of simplified meshes are kept intact.
+     */
+    class MOLTEN_API MeshSimplifier
+    {
+
+    public:
+
+        static constexpr float DefaultAttributeWeight = 0.001f; ///< Weight of attribute difference, relative to squared position error of normalized mesh.
+        static constexpr float DefaultMaxError = std::numeric_limits<float>::max(); ///< Unbounded error, only limited by target index count.
+
+        /** Result of simplification. */
+        struct Result
+        {
+            std::vector<uint32_t> indices; ///< Simplified indices, referencing vertices of the source mesh.
+            float error; ///< Approximate geometric deviation from the source mesh, in mesh units.
+        };
+
+        /** Simplifies triangle list until reaching target index count, or until no collapse below max error is possible.
+         *
+         * @param targetIndexCount Target number of indices, 3 indices per triangle. The result may contain more indices if simplification stops early.
+         * @param maxError Max error of collapses, relative to the largest extent of the mesh bounds.
+         */
+        [[nodiscard]] static Result Simplify(
+            const IndexedMeshVertices& vertices,
+            const std::vector<uint32_t>& indices,
+            const size_t targetIndexCount,
+            const float maxError = DefaultMaxError,
+            const float attributeWeight = DefaultAttributeWeight);
+
+        /** Generates levels of detail of sub-mesh, replacing any previous levels of detail.
+         *  Each level is simplified from the previous one, and is optimized for vertex cache.
+         *  Generation stops at the first level not reducing the triangle count.
+         *
+         * @param lodRatios Target triangle count of each level, relative to the full detail sub-mesh, in decreasing order, e.g. { 0.5f, 0.25f, 0.125f }.
+         */
+        static void GenerateLods(
+            IndexedSubmesh& submesh,
+            const std::vector<float>& lodRatios,
+            const float maxError = DefaultMaxError);
+
+        /** Generates levels of detail of all sub-meshes of meshes, in parallel per sub-mesh if a thread pool is provided.
+         *  Only free workers of the thread pool are used, so it is safe to call from work running on a worker of the same thread pool.
+         */
+        static void GenerateLods(
+            IndexedMeshes& meshes,
+            const std::vector<float>& lodRatios,
+            ThreadPool* threadPool = nullptr,
+            const float maxError = DefaultMaxError);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_MESHLETBUILDER_HPP
+#define MOLTEN_CORE_MESH_MESHLETBUILDER_HPP
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include <vector>
+
+namespace Molten
+{
+
+    /** Forward declarations. */
+    class ThreadPool;
+
+
+    /** Builder of meshlets, partitioning triangle lists into small clusters of nearby triangles.
+     *  Meshlets are grown greedily from a seed triangle, preferring connected triangles adding as few new vertices as possible,
+     *  and triangles facing the same direction as the meshlet, so normal cones stay narrow and back-face culling is effective.
+     *  Connectivity is based on vertex positions, so triangles split by normal or texture coordinate seams are still connected.
+     *  If no connected triangle fits, the triangle nearest to the meshlet centroid is added instead, as long as it fits.
+     *  A new meshlet is seeded by the first remaining triangle in index order, so triangle order optimized for vertex cache
+     *  also keeps meshlets spatially coherent. All functions are deterministic, so meshlets can be cached.
+     */
+    class MOLTEN_API MeshletBuilder
+    {
+
+    public:
+
+        static constexpr size_t DefaultMaxVertices = 64; ///< Max vertices per meshlet.
+        static constexpr size_t DefaultMaxTriangles = 124; ///< Max triangles per meshlet.
+        static constexpr size_t MaxVerticesLimit = 256; ///< Upper limit of max vertices, since local indices are stored as 8 bit integers.
+
+        /** Result of building meshlets. */
+        struct Result
+        {
+            IndexedMeshlets meshlets;
+            std::vector<uint32_t> vertices; ///< Vertex indices of all meshlets.
+            std::vector<uint8_t> triangles; ///< Meshlet local vertex indices of all meshlets, 3 per triangle.
+        };
+
+        /** Builds meshlets of triangle list, including bounds and normal cones of each meshlet.
+         *
+         * @param maxVertices Max vertices per meshlet, clamped to range [3, MaxVerticesLimit].
+         * @param maxTriangles Max triangles per meshlet, at least 1.
+         */
+        [[nodiscard]] static Result Build(
+            const IndexedMeshVertices& vertices,
+            const std::vector<uint32_t>& indices,
+            const size_t maxVertices = DefaultMaxVertices,
+            const size_t maxTriangles = DefaultMaxTriangles);
+
+        /** Builds meshlets of full detail triangles of sub-mesh, replacing any previous meshlets.
+         *  Meshlets reference vertices of the sub-mesh, so they must be rebuilt if vertices are reordered, i.e. by MeshOptimizer.
+         */
+        static void BuildSubmesh(
+            IndexedSubmesh& submesh,
+            const size_t maxVertices = DefaultMaxVertices,
+            const size_t maxTriangles = DefaultMaxTriangles);
+
+        /** Builds meshlets of all sub-meshes of meshes, in parallel per sub-mesh if a thread pool is provided.
+         *  Only free workers of the thread pool are used, so it is safe to call from work running on a worker of the same thread pool.
+         */
+        static void BuildMeshes(
+            IndexedMeshes& meshes,
+            ThreadPool* threadPool = nullptr,
+            const size_t maxVertices = DefaultMaxVertices,
+            const size_t maxTriangles = DefaultMaxTriangles);
+
+        /** Calculates bounding sphere, bounding box and normal cone of meshlet, from its vertices and triangles. */
+        static void CalculateBounds(
+            IndexedMeshlet& meshlet,
+            const IndexedMeshVertices& vertices,
+            const std::vector<uint32_t>& meshletVertices,
+            const std::vector<uint8_t>& meshletTriangles);
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_MESH_OBJMESHIMPORTER_HPP
+#define MOLTEN_CORE_MESH_OBJMESHIMPORTER_HPP
+
+#include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include "Molten/FileFormat/Mesh/MeshCacheFile.hpp"
+#include "Molten/System/Result.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Importer of obj mesh files into GPU-ready indexed meshes, with automatic binary caching.
+     *  The first import of an obj file parses the text file, builds and optimizes indexed meshes,
+     *  generates levels of detail and meshlets if enabled and writes a mesh cache file.
+     *  Following imports memory map the cache file instead, as long as the source file is unchanged.
+     *  A cache is considered up to date if the source size and last write time matches,
+     *  or if only the last write time differs but the source content hash matches, e.g. after a version control checkout.
+     *  Caches built with different import settings, e.g. level of detail ratios, are rebuilt.
+     */
+    class MOLTEN_API ObjMeshImporter
+    {
+
+    public:
+
+        using ImportResult = Result<MeshCacheFile, std::string>;
+
+        /** Origin of imported data. */
+        enum class ImportSource
+        {
+            None, ///< Nothing imported yet, or the import failed.
+            Cache, ///< Data was loaded from an up to date cache file.
+            Source ///< Data was parsed from the obj source file.
+        };
+
+        ObjMeshImporter();
+        ~ObjMeshImporter() = default;
+
+        ObjMeshImporter(const ObjMeshImporter&) = delete;
+        ObjMeshImporter(ObjMeshImporter&&) = delete;
+        ObjMeshImporter& operator = (const ObjMeshImporter&) = delete;
+        ObjMeshImporter& operator = (ObjMeshImporter&&) = delete;
+
+        /** Imports obj mesh file on a single thread. */
+        [[nodiscard]] ImportResult Import(const std::filesystem::path& filename);
+
+        /** Imports obj mesh file, parsing and building meshes using multiple threads from provided thread pool. */
+        [[nodiscard]] ImportResult Import(const std::filesystem::path& filename, ThreadPool& threadPool);
+
+        /** Enables or disables reading and writing of cache files. Caching is enabled by default. */
+        void SetCacheEnabled(const bool enabled);
+
+        /** Checks if reading and writing of cache files is enabled. */
+        [[nodiscard]] bool IsCacheEnabled() const;
+
+        /** Enables or disables Lz4 compression of written cache files. Compressed cache files are smaller but are not memory mapped when read.
+         *  Compression is disabled by default. Cache files of both kinds are read regardless of this setting.
+         */
+        void SetCacheCompressionEnabled(const bool enabled);
+
+        /** Checks if compression of written cache files is enabled. */
+        [[nodiscard]] bool IsCacheCompressionEnabled() const;
+
+        /** Set directory of cache files. Cache files are stored next to their source files if cache directory is empty, which is default. */
+        void SetCacheDirectory(const std::filesystem::path& cacheDirectory);
+
+        /** Get directory of cache files. */
+        [[nodiscard]] const std::filesystem::path& GetCacheDirectory() const;
+
+        /** Set target triangle ratios of generated levels of detail, relative to the full detail sub-meshes, in decreasing order.
+         *  No levels of detail are generated if lodRatios is empty, which is default.
+         *
+         * @see MeshSimplifier::GenerateLods
+         */
+        void SetLodRatios(const std::vector<float>& lodRatios);
+
+        /** Get target triangle ratios of generated levels of detail. */
+        [[nodiscard]] const std::vector<float>& GetLodRatios() const;
+
+        /** Enables or disables building of meshlets with default limits. Meshlets are disabled by default.
+         *
+         * @see MeshletBuilder
+         */
+        void SetMeshletsEnabled(const bool enabled);
+
+        /** Checks if building of meshlets is enabled. */
+        [[nodiscard]] bool IsMeshletsEnabled() const;
+
+        /** Get filename of cache file for provided source file. */
+        [[nodiscard]] std::filesystem::path GetCacheFilename(const std::filesystem::path& filename) const;
+
+        /** Get origin of last successfully imported data. */
+        [[nodiscard]] ImportSource GetLastImportSource() const;
+
+        /** Get obj mesh file reader used for parsing source files, i.e. for connecting to onProgress. */
+        [[nodiscard]] ObjMeshFileReader& GetReader();
+
+        /** Creates key of source file, without content hash unless computeHash is true.
+         *
+         * @return Source key, or nullopt if the file is not accessible.
+         */
+        [[nodiscard]] static std::optional<MeshCacheFile::SourceKey> CreateSourceKey(
+            const std::filesystem::path& filename,
+            const bool computeHash);
+
+    private:
+
+        /** Checks if file is unchanged since key was created. Content is only hashed if the last write time differs. */
+        [[nodiscard]] static bool IsSourceKeyCurrent(const std::filesystem::path& filename, const MeshCacheFile::SourceKey& key);
+
+        [[nodiscard]] uint64_t CreateSettingsHash() const;
+        [[nodiscard]] ImportResult InternalImport(const std::filesystem::path& filename, ThreadPool* threadPool);
+        [[nodiscard]] std::optional<MeshCacheFile> TryReadCache(
+            const std::filesystem::path& filename,
+            const std::filesystem::path& cacheFilename) const;
+
+        ObjMeshFileReader m_reader;
+        bool m_cacheEnabled;
+        bool m_cacheCompressionEnabled;
+        std::filesystem::path m_cacheDirectory;
+        std::vector<float> m_lodRatios;
+        bool m_meshletsEnabled;
+        ImportSource m_lastImportSource;
+
+    };
+
+}
+
+#endif
@@ -49,8 +49,30 @@ namespace Molten
 
         UBlue8Green8Red8,
         UBlue8Green8Red8Alpha8,
+
+        UBc1Rgba,       ///< BC1, RGB with 1-bit alpha, 8 bytes per block of 4x4 pixels.
+        SrgbBc1Rgba,    ///< BC1 with sRGB color.
+        UBc3Rgba,       ///< BC3, RGB with interpolated alpha, 16 bytes per block.
+        SrgbBc3Rgba,    ///< BC3 with sRGB color.
+        UBc4Red,        ///< BC4, single channel, 8 bytes per block.
+        UBc5RedGreen,   ///< BC5, two channels, 16 bytes per block.
+        UBc7Rgba,       ///< BC7, high quality RGBA, 16 bytes per block.
+        SrgbBc7Rgba     ///< BC7 with sRGB color.
     };
 
+    /** Checks if format is block compressed, storing pixels in blocks of 4x4 pixels. */
+    [[nodiscard]] MOLTEN_API bool IsBlockCompressedImageFormat(const ImageFormat format);
+
+    /** Get size in bytes of one block of 4x4 pixels of block compressed format, or of one pixel of uncompressed format. */
+    [[nodiscard]] MOLTEN_API size_t GetImageFormatBlockSize(const ImageFormat format);
+
+    /** Calculates size in bytes of tightly packed pixels of image. Partial blocks of block compressed formats are padded to whole blocks. */
+    [[nodiscard]] MOLTEN_API size_t CalculateImageDataSize(
+        const ImageFormat format,
+        const uint32_t width,
+        const uint32_t height,
+        const uint32_t depth = 1);
+
 }
 
 #endif
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "Molten/Renderer/ImageFormat.hpp"
 #include "Molten/Renderer/ImageSwizzle.hpp"
 #include "Molten/Math/Vector.hpp"
+#include <algorithm>
 
 namespace Molten
 {   
@@ -170,13 +171,14 @@ namespace Molten
         TextureDescriptor& operator =(const TextureDescriptor&) = default;
         TextureDescriptor& operator =(TextureDescriptor&&) = default;
 
-        const void* data;
+        const void* data; ///< Pixels of all mip levels, tightly packed one after another, starting with the full resolution level.
         Vector<VDimensions, uint32_t> dimensions;
         TextureType type;
         TextureUsage initialUsage;
         ImageFormat format;
         ImageFormat internalFormat;
         ImageSwizzleMapping swizzleMapping;
+        uint32_t mipLevelCount; ///< Number of mip levels in data, 1 by default. All levels are uploaded in one batch.
 
     };
 
@@ -185,6 +187,15 @@ namespace Molten
     using TextureDescriptor3D = TextureDescriptor<3>;
 
 
+    /** Calculates number of levels of a full mip chain, down to a single pixel. */
+    template<size_t VDimensions>
+    [[nodiscard]] uint32_t CalculateMipLevelCount(const Vector<VDimensions, uint32_t>& dimensions);
+
+    /** Get dimensions of mip level, halved per level, rounded down and clamped to 1. */
+    template<size_t VDimensions>
+    [[nodiscard]] Vector<VDimensions, uint32_t> GetMipLevelDimensions(const Vector<VDimensions, uint32_t>& dimensions, const uint32_t level);
+
+
     /** Descriptor class of texture update. */
     template<size_t VDimensions>
     struct TextureUpdateDescriptor
@@ -81,7 +81,8 @@ namespace Molten
         initialUsage(TextureUsage::ReadOnly),
         format(ImageFormat::URed8Green8Blue8),
         internalFormat(ImageFormat::URed8Green8Blue8),
-        swizzleMapping{}
+        swizzleMapping{},
+        mipLevelCount(1)
     {}
 
     template<size_t VDimensions>
@@ -99,7 +100,8 @@ namespace Molten
         initialUsage(initialUsage),
         format(format),
         internalFormat(format),
-        swizzleMapping(swizzleMapping)
+        swizzleMapping(swizzleMapping),
+        mipLevelCount(1)
     {}
 
     template<size_t VDimensions>
@@ -118,7 +120,8 @@ namespace Molten
         initialUsage(initialUsage),
         format(format),
         internalFormat(internalFormat),
-        swizzleMapping(swizzleMapping)
+        swizzleMapping(swizzleMapping),
+        mipLevelCount(1)
     {}
 
 
@@ -134,4 +137,36 @@ namespace Molten
         destinationOffset(destinationOffset)
     {}
 
+
+
+    // Mip level implementations.
+    template<size_t VDimensions>
+    uint32_t CalculateMipLevelCount(const Vector<VDimensions, uint32_t>& dimensions)
+    {
+        uint32_t maxDimension = 0;
+        for(size_t i = 0; i < VDimensions; i++)
+        {
+            maxDimension = std::max(maxDimension, dimensions.c[i]);
+        }
+
+        uint32_t levelCount = 1;
+        while(maxDimension > 1)
+        {
+            maxDimension >>= 1;
+            ++levelCount;
+        }
+        return levelCount;
+    }
+
+    template<size_t VDimensions>
+    Vector<VDimensions, uint32_t> GetMipLevelDimensions(const Vector<VDimensions, uint32_t>& dimensions, const uint32_t level)
+    {
+        Vector<VDimensions, uint32_t> levelDimensions;
+        for(size_t i = 0; i < VDimensions; i++)
+        {
+            levelDimensions.c[i] = level < 32 ? std::max(uint32_t{ 1 }, dimensions.c[i] >> level) : uint32_t{ 1 };
+        }
+        return levelDimensions;
+    }
+
 }
\ No newline at end of file
@@ -102,6 +102,18 @@ namespace Molten::Vulkan
         const VkBufferImageCopy& bufferImageCopy,
         const VkImageLayout finalImageLayout);
 
+    /** Copy device buffer to multiple regions of device image, in a single copy command.
+     *  All mipLevelCount levels of the image are transitioned, typically one region is provided per mip level.
+     */
+    MOLTEN_API bool CopyDeviceBufferToDeviceImage(
+        DeviceBuffer& deviceBuffer,
+        DeviceImage& deviceImage,
+        VkCommandBuffer commandBuffer,
+        const VkBufferImageCopy* bufferImageCopies,
+        const uint32_t bufferImageCopyCount,
+        const uint32_t mipLevelCount,
+        const VkImageLayout finalImageLayout);
+
 }
 
 #endif
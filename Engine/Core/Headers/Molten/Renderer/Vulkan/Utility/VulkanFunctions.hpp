@@ -120,18 +120,20 @@ namespace Molten::Vulkan
     /**@}*/
 
 
-    /** Function for changing layout of image. */
+    /** Function for changing layout of image. The first mipLevelCount levels of the image are transitioned. */
     /**@{*/
     MOLTEN_API bool TransitionImageLayout(
         VkCommandBuffer commandBuffer,
         VkImage image,
         const VkImageLayout oldLayout,
-        const VkImageLayout newLayout);
+        const VkImageLayout newLayout,
+        const uint32_t mipLevelCount = 1);
 
     MOLTEN_API bool TransitionImageLayout(
         VkCommandBuffer commandBuffer,
         DeviceImage& deviceImage,
-        const VkImageLayout newLayout);
+        const VkImageLayout newLayout,
+        const uint32_t mipLevelCount = 1);
     /**@}*/
 
 }
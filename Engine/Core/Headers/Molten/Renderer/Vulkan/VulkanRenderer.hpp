@@ -227,6 +227,8 @@ namespace Molten
             const Vector3ui32& dimensions,
             const void* data,
             const VkDeviceSize dataSize,
+            const uint32_t mipLevelCount,
+            const ImageFormat format,
             const VkImageLayout layout,
             const VkFormat imageFormat,
             const VkFormat internalImageFormat,
@@ -0,0 +1,108 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_SYSTEM_ADAPTIVESEMAPHORE_HPP
+#define MOLTEN_CORE_SYSTEM_ADAPTIVESEMAPHORE_HPP
+
+#include "Molten/Types.hpp"
+#include <atomic>
+
+#if MOLTEN_PLATFORM != MOLTEN_PLATFORM_LINUX
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Molten
+{
+
+    /** Thread safe counting semaphore, spinning for a short while before blocking the current thread.
+     *  Waiting threads spin with cpu pause instructions, up to an adaptive number of iterations, before parking.
+     *  The number of spin iterations is adjusted by how successful previous spins were, but never exceeds provided spin count.
+     *  Parking is implemented via futex on Linux, and via condition variable on other platforms.
+     *  Spinning trades CPU time for lower wake up latency, so a spin count of 0 is preferable if latency is not critical.
+     */
+    class MOLTEN_API AdaptiveSemaphore
+    {
+
+    public:
+
+        static constexpr uint32_t DefaultSpinCount = 4000; ///< Default max number of spin iterations.
+
+        /** Initializes semaphore by value and max spin count. Default value is 0. */
+        explicit AdaptiveSemaphore(
+            const int32_t value = 0,
+            const uint32_t spinCount = DefaultSpinCount);
+
+        /** Default destructor. */
+        ~AdaptiveSemaphore() = default;
+
+        /** Deleted copy and move constructors/operators. */
+        /**@{*/
+        AdaptiveSemaphore(const AdaptiveSemaphore&) = delete;
+        AdaptiveSemaphore(AdaptiveSemaphore&&) = delete;
+        AdaptiveSemaphore& operator = (const AdaptiveSemaphore&) = delete;
+        AdaptiveSemaphore& operator = (AdaptiveSemaphore&&) = delete;
+        /**@}*/
+
+        /** Get max number of spin iterations before parking. */
+        [[nodiscard]] uint32_t GetSpinCount() const;
+
+        /** Get number of spin iterations of next wait, adapted to previous waits. Never exceeds GetSpinCount. */
+        [[nodiscard]] uint32_t GetAdaptiveSpinCount() const;
+
+        /** Get current value of semaphore. */
+        [[nodiscard]] int32_t GetValue() const;
+
+        /** Increments value of semaphore and unblocks one waiting thread, if any. */
+        void NotifyOne();
+
+        /** Block current thread until value of semaphore is positive, then decrements the value. */
+        void Wait();
+
+        /** Decrements the value of semaphore if positive, without blocking.
+         *  @return true if value was decremented.
+         */
+        [[nodiscard]] bool TryWait();
+
+    private:
+
+        [[nodiscard]] bool Spin();
+        void Park();
+
+        std::atomic<int32_t> m_value;
+        std::atomic<int32_t> m_waitCount;
+        uint32_t m_spinCount;
+        std::atomic<uint32_t> m_adaptiveSpinCount;
+
+#if MOLTEN_PLATFORM != MOLTEN_PLATFORM_LINUX
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+#endif
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_SYSTEM_FILEWATCHER_HPP
+#define MOLTEN_CORE_SYSTEM_FILEWATCHER_HPP
+
+#include "Molten/Types.hpp"
+#include <filesystem>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Watches files for modifications, without blocking or polling the file system.
+     *  Files are watched via their parent directories, so files replaced by rename, as saved by many editors, are detected as well.
+     *  Only supported on Linux, via inotify. Watching files fails on other platforms.
+     *  Not thread safe.
+     */
+    class MOLTEN_API FileWatcher
+    {
+
+    public:
+
+        FileWatcher();
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher(FileWatcher&&) = delete;
+        FileWatcher& operator = (const FileWatcher&) = delete;
+        FileWatcher& operator = (FileWatcher&&) = delete;
+
+        /** Checks if file watching is supported on this platform. */
+        [[nodiscard]] static bool IsSupported();
+
+        /** Starts watching file. The file does not have to exist, but its parent directory must.
+         *  Watching an already watched file does nothing.
+         *
+         * @return true if file is watched.
+         */
+        bool Watch(const std::filesystem::path& filename);
+
+        /** Stops watching file. */
+        void Unwatch(const std::filesystem::path& filename);
+
+        /** Stops watching all files. */
+        void UnwatchAll();
+
+        /** Checks if file is watched. */
+        [[nodiscard]] bool IsWatching(const std::filesystem::path& filename) const;
+
+        /** Get number of watched files. */
+        [[nodiscard]] size_t GetWatchedFileCount() const;
+
+        /** Get normalized absolute filenames of watched files modified since last call, each reported once, in order of first modification.
+         *  Files are reported when closed after writing, or when moved or renamed into place. Never blocks.
+         */
+        [[nodiscard]] std::vector<std::filesystem::path> Poll();
+
+        /** Get normalized absolute filename, as reported by Poll. */
+        [[nodiscard]] static std::filesystem::path NormalizeFilename(const std::filesystem::path& filename);
+
+    private:
+
+        struct Directory
+        {
+            int descriptor;
+            std::set<std::string> filenames;
+        };
+
+        void EraseDirectory(const std::string& directoryName);
+
+        int m_descriptor;
+        std::unordered_map<std::string, Directory> m_directories;
+        std::unordered_map<int, std::string> m_directoryNames;
+        size_t m_fileCount;
+
+    };
+
+}
+
+#endif
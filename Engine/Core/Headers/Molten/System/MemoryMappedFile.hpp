@@ -0,0 +1,105 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_SYSTEM_MEMORYMAPPEDFILE_HPP
+#define MOLTEN_CORE_SYSTEM_MEMORYMAPPEDFILE_HPP
+
+#include "Molten/Types.hpp"
+#include <filesystem>
+#include <string_view>
+
+namespace Molten
+{
+
+    /** Read-only memory mapped file.
+     *  The whole file is mapped into the address space of the process at Open(...),
+     *  and pages are loaded by the operating system on first access, without any intermediate read buffers.
+     */
+    class MOLTEN_API MemoryMappedFile
+    {
+
+    public:
+
+        /** Constructor. No file is mapped at construction. */
+        MemoryMappedFile();
+
+        /** Destructor. Unmaps the file, if mapped. */
+        ~MemoryMappedFile();
+
+        /** Move constructor and assignment operator. */
+        /**@{*/
+        MemoryMappedFile(MemoryMappedFile&& memoryMappedFile) noexcept;
+        MemoryMappedFile& operator = (MemoryMappedFile&& memoryMappedFile) noexcept;
+        /**@}*/
+
+        /** Deleted copy constructor and assignment operator. */
+        /**@{*/
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator = (const MemoryMappedFile&) = delete;
+        /**@}*/
+
+        /** Maps file of provided filename. Currently mapped file is unmapped first.
+         *  Empty files are successfully opened, but GetData() returns nullptr.
+         *
+         *  @return true if file was successfully mapped, else false.
+         */
+        bool Open(const std::filesystem::path& filename);
+
+        /** Unmaps current file. Pointers to mapped data are invalidated. */
+        void Close();
+
+        /** Checks if a file is opened. */
+        [[nodiscard]] bool IsOpen() const;
+
+        /** Get pointer to first byte of mapped file. */
+        [[nodiscard]] const char* GetData() const;
+
+        /** Get size of mapped file in bytes. */
+        [[nodiscard]] size_t GetSize() const;
+
+        /** Get view of all mapped data. */
+        [[nodiscard]] std::string_view GetView() const;
+
+        /** Hints the operating system that mapped pages entirely within provided range are not needed for now,
+         *  releasing their physical memory. Discarded pages are reloaded from file if accessed again,
+         *  so discarding data still in use only costs performance.
+         */
+        void Discard(const char* data, const size_t size) const;
+
+    private:
+
+        bool m_open;
+        const char* m_data;
+        size_t m_size;
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
+        void* m_fileHandle;
+        void* m_mappingHandle;
+#endif
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_SYSTEM_SCHEDULERPROFILER_HPP
+#define MOLTEN_CORE_SYSTEM_SCHEDULERPROFILER_HPP
+
+#include "Molten/System/Clock.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <ostream>
+#include <filesystem>
+
+namespace Molten
+{
+
+    /** Scheduler profiler, recording timelines of thread pools and task groups.
+     *  Spans of executed jobs and tasks are recorded per thread, together with counters such as queue depth over time.
+     *  Recorded data can be exported as Chrome trace JSON, viewable in chrome://tracing or Perfetto.
+     *  All functions are thread safe.
+     */
+    class MOLTEN_API SchedulerProfiler
+    {
+
+    public:
+
+        /** Span categories recorded by the thread pool and task groups. */
+        /**@{*/
+        static constexpr const char* JobCategory = "Job"; ///< Work executed by a thread pool worker.
+        static constexpr const char* TaskCategory = "Task"; ///< Execution of a Task.
+        static constexpr const char* WaitCategory = "Wait"; ///< Time spent waiting for a free worker or for a task group to finish.
+        /**@}*/
+
+        /** Span event, covering time between start and end on a single thread. */
+        struct SpanEvent
+        {
+            std::string name;
+            const char* category;
+            size_t threadIndex;
+            Time start;
+            Time end;
+        };
+
+        /** Counter event, a sample of a named value. */
+        struct CounterEvent
+        {
+            const char* name;
+            Time time;
+            int64_t value;
+        };
+
+        /** Per thread statistics of current capture. */
+        struct ThreadStatistics
+        {
+            std::string name;
+            size_t jobCount; ///< Number of spans of category JobCategory.
+            size_t taskCount; ///< Number of spans of category TaskCategory.
+            Time busyTime; ///< Time spent executing jobs or tasks.
+            Time idleTime; ///< Time since start of capture - busy time.
+        };
+
+        /** Helper for recording a span from construction to destruction. Nothing is recorded if profiler is nullptr. */
+        class MOLTEN_API ScopedSpan
+        {
+
+        public:
+
+            ScopedSpan(
+                SchedulerProfiler* profiler,
+                std::string_view name,
+                const char* category);
+
+            ~ScopedSpan();
+
+            ScopedSpan(const ScopedSpan&) = delete;
+            ScopedSpan(ScopedSpan&&) = delete;
+            ScopedSpan& operator = (const ScopedSpan&) = delete;
+            ScopedSpan& operator = (ScopedSpan&&) = delete;
+
+        private:
+
+            SchedulerProfiler* m_profiler;
+            std::string_view m_name;
+            const char* m_category;
+            Time m_start;
+
+        };
+
+        /** Constructor. Capture is started and enabled at construction. */
+        SchedulerProfiler();
+
+        /** Default destructor. */
+        ~SchedulerProfiler() = default;
+
+        /** Deleted copy and move constructors/operators. */
+        /**@{*/
+        SchedulerProfiler(const SchedulerProfiler&) = delete;
+        SchedulerProfiler(SchedulerProfiler&&) = delete;
+        SchedulerProfiler& operator = (const SchedulerProfiler&) = delete;
+        SchedulerProfiler& operator = (SchedulerProfiler&&) = delete;
+        /**@}*/
+
+        /** Enables or disables recording. Record functions return immediately while disabled. */
+        void SetEnabled(const bool enabled);
+
+        /** Checks if recording is enabled. */
+        [[nodiscard]] bool IsEnabled() const;
+
+        /** Removes all recorded events and starts a new capture. Thread names are kept. */
+        void Clear();
+
+        /** Get time since construction of this profiler. All event times are relative to construction. */
+        [[nodiscard]] Time GetTime() const;
+
+        /** Sets name of current thread, used by statistics and export. */
+        void SetThreadName(const std::string& name);
+
+        /** Records a span on current thread. Start and end are provided by GetTime(). */
+        void RecordSpan(
+            std::string_view name,
+            const char* category,
+            const Time start,
+            const Time end);
+
+        /** Records a sample of a named counter at current time. Provided name must outlive this profiler. */
+        void RecordCounter(
+            const char* name,
+            const int64_t value);
+
+        /** Get copies of recorded events. */
+        /**@{*/
+        [[nodiscard]] std::vector<SpanEvent> GetSpanEvents() const;
+        [[nodiscard]] std::vector<CounterEvent> GetCounterEvents() const;
+        /**@}*/
+
+        /** Get statistics of all threads with recorded events, ordered by thread index. */
+        [[nodiscard]] std::vector<ThreadStatistics> GetThreadStatistics() const;
+
+        /** Exports recorded events as Chrome trace JSON. */
+        /**@{*/
+        void ExportChromeTrace(std::ostream& stream) const;
+        bool ExportChromeTrace(const std::filesystem::path& filename) const;
+        /**@}*/
+
+    private:
+
+        size_t GetThreadIndex();
+
+        std::atomic_bool m_enabled;
+        const Clock m_clock;
+        mutable std::mutex m_mutex;
+        Time m_captureStart;
+        std::unordered_map<std::thread::id, size_t> m_threadIndices;
+        std::vector<std::string> m_threadNames;
+        std::vector<SpanEvent> m_spanEvents;
+        std::vector<CounterEvent> m_counterEvents;
+
+    };
+
+}
+
+#endif
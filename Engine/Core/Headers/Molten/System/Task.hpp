@@ -75,6 +75,9 @@ namespace Molten
         /** Gets last execution time. */
         [[nodiscard]] Time GetLastExecutionTime() const;
 
+        /** Gets name of task, empty if no name was provided at construction. */
+        [[nodiscard]] const std::string& GetName() const;
+
     private:
 
         Function m_function;
@@ -108,6 +111,7 @@ namespace Molten
 
         /** Schedules and execute all tasks in parallel.
          *  Tasks are ordered by last execution time in descending order.
+         *  Each task is recorded by the profiler of provided thread pool, if any.
          *  This function is a modal function, causing the current thread to pause until all tasks are complete.
          */
         void Execute();
@@ -165,6 +169,7 @@ namespace Molten
         /**@}*/
 
         /** Schedules and execute all entries in serial.
+         *  Each task is recorded by the profiler of provided thread pool, if any.
          *  This function is a modal function, causing the current thread to pause until all tasks are complete.
          */
         void Execute();
@@ -27,19 +27,45 @@
 #define MOLTEN_CORE_SYSTEM_THREADPOOL_HPP
 
 #include "Molten/System/Semaphore.hpp"
+#include "Molten/System/AdaptiveSemaphore.hpp"
+#include "Molten/System/Time.hpp"
 #include <memory>
 #include <vector>
+#include <array>
+#include <string>
 #include <optional>
 #include <functional>
 #include <thread>
 #include <future>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <exception>
 #include <type_traits>
 
 namespace Molten
 {
 
+    /** Forward declarations. */
+    class FrameAllocator;
+    class LinearAllocator;
+    class SchedulerProfiler;
+
+
+    /** Thread pool creation descriptor. */
+    struct MOLTEN_API ThreadPoolDescriptor
+    {
+        size_t threadCount = 0; ///< Number of threads to launch, maximum number of possible concurrent threads if 0.
+        size_t minThreadCount = 1; ///< Number of launched threads is always at least minThreadCount.
+        size_t reservedThreads = 0; ///< Subtracted from number of launched threads.
+        std::optional<size_t> backgroundWorkerLimit; ///< Max number of workers running background work at the same time. Defaults to all workers but one.
+        std::string threadName; ///< Worker threads are named threadName + worker index, if not empty. Names are truncated to 15 characters on Linux.
+        std::vector<size_t> cpuAffinity; ///< Worker i is pinned to cpu cpuAffinity[i % cpuAffinity.size()]. No pinning if empty. Only supported on Linux.
+        FrameAllocator* frameAllocator = nullptr; ///< Optional frame allocator, providing scratch memory for workers via ThreadPool::GetScratchAllocator().
+        SchedulerProfiler* profiler = nullptr; ///< Optional profiler, recording executed jobs per worker, waiting time of callers and queue depth.
+        uint32_t workerSpinCount = 0; ///< Max number of spin iterations of idle workers before parking. Higher values lower dispatch latency at the cost of CPU time. See AdaptiveSemaphore.
+    };
+
     /** Thread pool class, with an interface for executing functions without having to care about individual thread,
      *  with support for future results of any movable type.
      *  All threads are launched at construction and stopped/destroyed at pool destruction.
@@ -49,6 +75,17 @@ namespace Molten
 
     public:
 
+        /** Priority classes of executed work.
+         *  A free worker is always handed to the waiting caller of highest priority,
+         *  and background work is limited to a subset of all workers, so frame critical work never has to wait for background work to finish.
+         */
+        enum class Priority : uint8_t
+        {
+            FrameCritical, ///< Work that must finish within the current frame.
+            Normal, ///< Default priority.
+            Background ///< Long running work, such as I/O, asset parsing and streaming.
+        };
+
         /** Constructor.
         *  Launching maximum number of possible concurrent threads if threadCount == 0.
         *  Provided reservedThreads is subtracted from number of launched threads,
@@ -60,6 +97,9 @@ namespace Molten
             const size_t minThreadCount = 1,
             const size_t reservedThreads = 0);
 
+        /** Constructor, by providing a descriptor. */
+        explicit ThreadPool(const ThreadPoolDescriptor& descriptor);
+
         /** Destructor. All workers are stopped. */
         ~ThreadPool();
 
@@ -74,6 +114,18 @@ namespace Molten
         /** Get number of launched workers. */
         [[nodiscard]] size_t GetWorkerCount() const;
 
+        /** Get max number of workers running background work at the same time. */
+        [[nodiscard]] size_t GetBackgroundWorkerLimit() const;
+
+        /** Get profiler provided by ThreadPoolDescriptor::profiler, or nullptr if none. */
+        [[nodiscard]] SchedulerProfiler* GetProfiler() const;
+
+        /** Get scratch memory allocator of current worker thread, provided by ThreadPoolDescriptor::frameAllocator.
+         *  Memory is valid until the frame allocator is reset.
+         *  @return Pointer to linear allocator of current worker, or nullptr if called from a thread not being a worker of a pool with a frame allocator.
+         */
+        [[nodiscard]] static LinearAllocator* GetScratchAllocator();
+
         /** Blocks current thread until a worker is free and ready for work, and then executes provided invocable type on that worker's thread.
          *  @return A future value of provided invocable types return type.
          *  @example auto result = pool.Execute([](){ return 10; });
@@ -81,6 +133,10 @@ namespace Molten
         template<typename TInvocable, typename TReturn = std::decay_t<std::invoke_result_t<TInvocable>>, typename = std::enable_if_t<std::is_invocable_v<TInvocable>>>
         [[nodiscard]] std::future<TReturn> Execute(TInvocable&& invocable);
 
+        /** Same as Execute(TInvocable&&), but with provided priority class. */
+        template<typename TInvocable, typename TReturn = std::decay_t<std::invoke_result_t<TInvocable>>, typename = std::enable_if_t<std::is_invocable_v<TInvocable>>>
+        [[nodiscard]] std::future<TReturn> Execute(const Priority priority, TInvocable&& invocable);
+
         /** Checks if a worker is available and then executes provided invocable type on that worker's thread.
          *  This function returns immediate if no worker is free.
          *  @return Optional future value of provided invocable types return type. has_value of optional return value is false if no worker is free and avilable.
@@ -89,14 +145,28 @@ namespace Molten
         template<typename TInvocable, typename TReturn = std::decay_t<std::invoke_result_t<TInvocable>>, typename = std::enable_if_t<std::is_invocable_v<TInvocable>>>
         [[nodiscard]] std::optional<std::future<TReturn>> TryExecute(TInvocable&& invocable);
 
+        /** Same as TryExecute(TInvocable&&), but with provided priority class. */
+        template<typename TInvocable, typename TReturn = std::decay_t<std::invoke_result_t<TInvocable>>, typename = std::enable_if_t<std::is_invocable_v<TInvocable>>>
+        [[nodiscard]] std::optional<std::future<TReturn>> TryExecute(const Priority priority, TInvocable&& invocable);
+
+        /** Invokes function(index) for each index in range [0, count), on current thread with help of free workers.
+         *  Indices are handed out one by one, to any free worker acquired via TryExecute, and to current thread until none are left.
+         *  This function never blocks waiting for a free worker, so it is safe to call from work running on a worker of this pool.
+         *  Exceptions thrown by function are rethrown after all indices are processed.
+         */
+        template<typename TFunction>
+        void ParallelFor(const Priority priority, const size_t count, TFunction&& function);
+
     private:
+
+        static constexpr size_t PriorityCount = 3;
         
         class Worker
         {
 
         public:
 
-            Worker();
+            explicit Worker(const uint32_t spinCount);
             ~Worker();
 
             Worker(const Worker&) = delete;
@@ -104,30 +174,54 @@ namespace Molten
             Worker& operator = (const Worker&) = delete;
             Worker& operator = (Worker&&) = delete;
 
-            void Start(std::function<void()>&& freeWorkerFunction);
+            void Start(
+                std::function<void()>&& freeWorkerFunction,
+                const std::string& name,
+                const std::optional<size_t> cpu,
+                FrameAllocator* frameAllocator,
+                SchedulerProfiler* profiler);
             void Stop();
             
             template<typename TReturn>
-            [[nodiscard]] std::future<TReturn> Execute(std::function<TReturn()>&& function);
+            [[nodiscard]] std::future<TReturn> Execute(const Priority priority, std::function<TReturn()>&& function);
+
+            [[nodiscard]] Priority GetPriority() const;
 
         private:
 
+            void RecordJobSpan();
+
             std::atomic_bool m_running;
+            Priority m_priority;
+            SchedulerProfiler* m_profiler;
+            Time m_jobStart;
             std::function<void()> m_freeFunction;
             std::thread m_thread;
             std::function<void()> m_function;
-            Semaphore m_workSemaphore;
+            AdaptiveSemaphore m_workSemaphore;
             
         };
 
         using WorkerPointer = std::unique_ptr<Worker>;
 
-        Worker* GetFreeWorker();
-        Worker* TryGetFreeWorker();
+        void LaunchWorkers(const ThreadPoolDescriptor& descriptor);
+
+        Worker* GetFreeWorker(const Priority priority);
+        Worker* TryGetFreeWorker(const Priority priority);
+        void ReleaseWorker(Worker* worker);
+
+        [[nodiscard]] bool CanAcquireWorker(const Priority priority) const;
+        [[nodiscard]] Worker* AcquireWorker(const Priority priority);
+
+        void RecordQueueDepth();
 
         std::vector<WorkerPointer> m_workers;
         std::vector<Worker*> m_freeWorkers;
-        Semaphore m_freeWorkersSemaphore;
+        std::array<size_t, PriorityCount> m_waitingCount;
+        size_t m_backgroundWorkerCount;
+        size_t m_backgroundWorkerLimit;
+        SchedulerProfiler* m_profiler;
+        std::condition_variable m_freeWorkersCondition;
         std::mutex m_workerMutex;
 
     };
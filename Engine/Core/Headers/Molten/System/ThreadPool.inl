@@ -30,46 +30,119 @@ namespace Molten
     template<typename TInvocable, typename TReturn, typename>
     std::future<TReturn> ThreadPool::Execute(TInvocable&& invocable)
     {
-        auto* worker = GetFreeWorker();
-        return worker->Execute<TReturn>(std::move(invocable));
+        return Execute(Priority::Normal, std::move(invocable));
+    }
+
+    template<typename TInvocable, typename TReturn, typename>
+    std::future<TReturn> ThreadPool::Execute(const Priority priority, TInvocable&& invocable)
+    {
+        auto* worker = GetFreeWorker(priority);
+        return worker->Execute<TReturn>(priority, std::move(invocable));
     }
 
     template<typename TInvocable, typename TReturn, typename>
     std::optional<std::future<TReturn>> ThreadPool::TryExecute(TInvocable&& invocable)
     {
-        auto* worker = TryGetFreeWorker();
+        return TryExecute(Priority::Normal, std::move(invocable));
+    }
+
+    template<typename TInvocable, typename TReturn, typename>
+    std::optional<std::future<TReturn>> ThreadPool::TryExecute(const Priority priority, TInvocable&& invocable)
+    {
+        auto* worker = TryGetFreeWorker(priority);
         if(!worker)
         {
             return {};
         }
 
-        return worker->Execute<TReturn>(std::move(invocable));
+        return worker->Execute<TReturn>(priority, std::move(invocable));
+    }
+
+    template<typename TFunction>
+    void ThreadPool::ParallelFor(const Priority priority, const size_t count, TFunction&& function)
+    {
+        std::atomic_size_t nextIndex = 0;
+        auto process = [&]()
+        {
+            for(auto index = nextIndex++; index < count; index = nextIndex++)
+            {
+                function(index);
+            }
+        };
+
+        std::vector<std::future<void>> helpers;
+        for(size_t i = 1; i < count; i++)
+        {
+            auto helper = TryExecute(priority, [&process]()
+            {
+                process();
+            });
+
+            if(!helper.has_value())
+            {
+                break;
+            }
+            helpers.push_back(std::move(helper.value()));
+        }
+
+        // Helpers are referencing this stack frame, so wait for them before propagating any exception.
+        std::exception_ptr exception;
+        try
+        {
+            process();
+        }
+        catch(...)
+        {
+            exception = std::current_exception();
+        }
+
+        for(auto& helper : helpers)
+        {
+            helper.wait();
+        }
+
+        if(exception)
+        {
+            std::rethrow_exception(exception);
+        }
+
+        for (auto& helper : helpers)
+        {
+            helper.get();
+        }
     }
 
 
     // Thread pool worker implementations.
     template<typename TReturn>
-    std::future<TReturn> ThreadPool::Worker::Execute(std::function<TReturn()>&& function)
+    std::future<TReturn> ThreadPool::Worker::Execute(const Priority priority, std::function<TReturn()>&& function)
     {
+        m_priority = priority;
+
         auto promise = std::make_shared<std::promise<TReturn>>();
         auto future = promise->get_future();
 
-        m_function = [function = std::move(function), promise]()
+        // The job span is recorded before the promise is fulfilled, so waiters always observe it.
+        m_function = [this, function = std::move(function), promise]()
         {   
             try
             {
                 if constexpr (std::is_same_v<TReturn, void> == true)
                 {
                     function();
+                    RecordJobSpan();
                     promise->set_value();
                 }
                 else
                 {
-                    promise->set_value(function());
+                    auto result = function();
+                    RecordJobSpan();
+                    promise->set_value(std::move(result));
                 }
             }
             catch(...)
             {
+                RecordJobSpan();
                 promise->set_exception(std::current_exception());
             }
         };
@@ -0,0 +1,216 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_SYSTEM_VIRTUALFILESYSTEM_HPP
+#define MOLTEN_CORE_SYSTEM_VIRTUALFILESYSTEM_HPP
+
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Molten
+{
+
+    /** Read-only view of file data opened via a virtual file system.
+     *  The view is zero-copy if the data is part of a memory mapped file, like loose files and stored archive entries,
+     *  and stays valid for as long as any copy of the virtual file exists, also if the file system is unmounted or destroyed.
+     */
+    class MOLTEN_API VirtualFile
+    {
+
+    public:
+
+        using Owner = std::shared_ptr<const void>; ///< Owner of viewed data.
+        using MappedFile = std::shared_ptr<const MemoryMappedFile>; ///< Memory mapped file of viewed data.
+
+        /** Constructs an empty file. */
+        VirtualFile();
+
+        /** Constructs a view of data within memory mapped file. */
+        VirtualFile(MappedFile mappedFile, const std::string_view data);
+
+        /** Constructs a view of data in memory owned by provided owner, e.g. a decompressed buffer. */
+        VirtualFile(Owner owner, const std::string_view data);
+
+        /** Get pointer to first byte of file data. Might be nullptr for empty files. */
+        [[nodiscard]] const char* GetData() const;
+
+        /** Get size of file data in bytes. */
+        [[nodiscard]] size_t GetSize() const;
+
+        /** Get view of all file data. */
+        [[nodiscard]] std::string_view GetView() const;
+
+        /** Get owner keeping file data alive. */
+        [[nodiscard]] const Owner& GetOwner() const;
+
+        /** Get memory mapped file containing file data, or nullptr if data is not memory mapped. */
+        [[nodiscard]] const MappedFile& GetMappedFile() const;
+
+    private:
+
+        Owner m_owner;
+        MappedFile m_mappedFile;
+        std::string_view m_data;
+
+    };
+
+
+    /** Interface of file sources mountable by virtual file systems, i.e. loose directories and packed archives.
+     *  Paths passed to mounts are normalized and relative to the mount point. Implementations must be thread safe.
+     */
+    class MOLTEN_API VirtualFileSystemMount
+    {
+
+    public:
+
+        VirtualFileSystemMount() = default;
+        virtual ~VirtualFileSystemMount() = default;
+
+        VirtualFileSystemMount(const VirtualFileSystemMount&) = delete;
+        VirtualFileSystemMount(VirtualFileSystemMount&&) = delete;
+        VirtualFileSystemMount& operator = (const VirtualFileSystemMount&) = delete;
+        VirtualFileSystemMount& operator = (VirtualFileSystemMount&&) = delete;
+
+        /** Opens file of provided path. Returns nullopt if not found. */
+        [[nodiscard]] virtual std::optional<VirtualFile> Open(const std::string_view path) const = 0;
+
+        /** Checks if file of provided path exists. */
+        [[nodiscard]] virtual bool Exists(const std::string_view path) const = 0;
+
+        /** Appends names of files directly in provided directory, an empty path being the root of the mount.
+         *
+         * @return false if directory does not exist.
+         */
+        virtual bool ListDirectory(const std::string_view directory, std::vector<std::string>& names) const = 0;
+
+    };
+
+
+    /** Mount of a loose directory. Files are memory mapped when opened. */
+    class MOLTEN_API VirtualFileSystemDirectory : public VirtualFileSystemMount
+    {
+
+    public:
+
+        explicit VirtualFileSystemDirectory(std::filesystem::path directory);
+
+        [[nodiscard]] std::optional<VirtualFile> Open(const std::string_view path) const override;
+
+        [[nodiscard]] bool Exists(const std::string_view path) const override;
+
+        bool ListDirectory(const std::string_view directory, std::vector<std::string>& names) const override;
+
+        /** Get mounted directory. */
+        [[nodiscard]] const std::filesystem::path& GetDirectory() const;
+
+    private:
+
+        std::filesystem::path m_directory;
+
+    };
+
+
+    /** Virtual file system, serving files of mounted directories and archives by generic paths.
+     *  Mounts added later take precedence over earlier mounts, so patches can override files of base archives.
+     *  Paths are case sensitive, separated by '/' or '\', and normalized before lookups, so "a/./b//c" and "a/d/../b/c" are the same path.
+     *  All functions are thread safe.
+     */
+    class MOLTEN_API VirtualFileSystem
+    {
+
+    public:
+
+        VirtualFileSystem() = default;
+        ~VirtualFileSystem() = default;
+
+        VirtualFileSystem(const VirtualFileSystem&) = delete;
+        VirtualFileSystem(VirtualFileSystem&&) = delete;
+        VirtualFileSystem& operator = (const VirtualFileSystem&) = delete;
+        VirtualFileSystem& operator = (VirtualFileSystem&&) = delete;
+
+        /** Mounts file source at provided mount point, an empty mount point being the root of the file system. */
+        void Mount(std::shared_ptr<const VirtualFileSystemMount> mount, const std::string_view mountPoint = {});
+
+        /** Mounts loose directory at provided mount point.
+         *
+         * @return false if directory does not exist.
+         */
+        bool MountDirectory(const std::filesystem::path& directory, const std::string_view mountPoint = {});
+
+        /** Unmounts file source from all of its mount points. Files already opened stay valid.
+         *
+         * @return true if mount was found.
+         */
+        bool Unmount(const std::shared_ptr<const VirtualFileSystemMount>& mount);
+
+        /** Unmounts all file sources. Files already opened stay valid. */
+        void UnmountAll();
+
+        /** Get number of mounts. */
+        [[nodiscard]] size_t GetMountCount() const;
+
+        /** Opens file of provided path, from the latest mount containing it. Returns nullopt if not found. */
+        [[nodiscard]] std::optional<VirtualFile> Open(const std::string_view path) const;
+
+        /** Checks if any mount contains file of provided path. */
+        [[nodiscard]] bool Exists(const std::string_view path) const;
+
+        /** Get sorted names of files directly in provided directory, merged from all mounts.
+         *
+         * @return nullopt if no mount contains the directory.
+         */
+        [[nodiscard]] std::optional<std::vector<std::string>> ListDirectory(const std::string_view directory) const;
+
+        /** Normalizes path by converting separators to '/', removing empty and "." segments and resolving ".." segments.
+         *  Leading and trailing separators are removed and ".." segments never escape the root.
+         */
+        [[nodiscard]] static std::string NormalizePath(const std::string_view path);
+
+    private:
+
+        struct MountPoint
+        {
+            std::string path;
+            std::shared_ptr<const VirtualFileSystemMount> mount;
+        };
+
+        /** Get path relative to mount point, or nullopt if path is outside of mount point. */
+        [[nodiscard]] static std::optional<std::string_view> GetMountRelativePath(const MountPoint& mountPoint, const std::string_view path);
+
+        mutable std::shared_mutex m_mutex;
+        std::vector<MountPoint> m_mountPoints;
+
+    };
+
+}
+
+#endif
@@ -28,12 +28,18 @@
 
 #include "Molten/Types.hpp"
 #include <functional>
-#include <vector>
-#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
 
 namespace Molten
 {
 
+    /** Multi-producer/single-consumer function dispatcher.
+     *  Any thread may add functions, without locking, via Add(...).
+     *  A single consumer thread calls Dispatch() to invoke all functions added before the call, in order of addition.
+     *  Small callables are stored inline in the queue node, larger ones are allocated on the heap.
+     */
     class MOLTEN_API FunctionDispatcher
     {
 
@@ -41,7 +47,11 @@ namespace Molten
 
         using Function = std::function<void()>; ///< Function data type.
 
-        FunctionDispatcher() = default;
+        static constexpr size_t InlineStorageSize = 48; ///< Max size in bytes of callables stored without an additional allocation.
+
+        FunctionDispatcher();
+
+        /** Destructor. Remaining functions are destroyed without being invoked. */
         ~FunctionDispatcher();
 
         FunctionDispatcher(const FunctionDispatcher&) = delete;
@@ -49,20 +59,43 @@ namespace Molten
         FunctionDispatcher& operator = (const FunctionDispatcher&) = delete;
         FunctionDispatcher& operator = (FunctionDispatcher&&) = delete;
 
-        void Add(Function&& function);
-        void Dispatch();
+        /** Adds a function to be invoked at next call to Dispatch(). Thread safe and lock-free. */
+        template<typename TFunction>
+        void Add(TFunction&& function);
+
+        /** Invokes and removes all functions added before this call.
+         *  Functions added while dispatching are invoked at next call to Dispatch().
+         *  Must not be called concurrently from multiple threads.
+         *
+         * @return Number of invoked functions.
+         */
+        size_t Dispatch();
 
     private:
 
-        [[nodiscard]] size_t LockGetFunctionCount();
-        [[nodiscard]] Function LockMoveFunction(const size_t index);
-        void LockRemoveFunctions(const size_t count);
+        struct Node
+        {
+            Node* next;
+            void (*invoke)(Node&);
+            void (*destroy)(Node&);
+            alignas(std::max_align_t) std::byte storage[InlineStorageSize];
+        };
+
+        template<typename TFunction>
+        static constexpr bool IsInlineStorable =
+            sizeof(TFunction) <= InlineStorageSize && alignof(TFunction) <= alignof(std::max_align_t);
 
-        std::vector<Function> m_functions;
-        std::mutex m_mutex;
+        void Push(Node* node);
+
+        static Node* ReverseList(Node* node);
+        static void DestroyNode(Node* node);
+
+        std::atomic<Node*> m_head;
 
     };
 
 }
 
+#include "Molten/Utility/FunctionDispatcher.inl"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include <new>
+
+namespace Molten
+{
+
+    // Function dispatcher implementations.
+    template<typename TFunction>
+    void FunctionDispatcher::Add(TFunction&& function)
+    {
+        using FunctionType = std::decay_t<TFunction>;
+        static_assert(std::is_invocable_v<FunctionType&>, "FunctionDispatcher::Add: Provided function is not invocable.");
+
+        auto* node = new Node;
+        node->next = nullptr;
+
+        if constexpr (IsInlineStorable<FunctionType>)
+        {
+            new (node->storage) FunctionType(std::forward<TFunction>(function));
+
+            node->invoke = [](Node& node)
+            {
+                (*std::launder(reinterpret_cast<FunctionType*>(node.storage)))();
+            };
+            node->destroy = [](Node& node)
+            {
+                std::launder(reinterpret_cast<FunctionType*>(node.storage))->~FunctionType();
+            };
+        }
+        else
+        {
+            auto* heapFunction = new FunctionType(std::forward<TFunction>(function));
+            new (node->storage) FunctionType*(heapFunction);
+
+            node->invoke = [](Node& node)
+            {
+                (**std::launder(reinterpret_cast<FunctionType**>(node.storage)))();
+            };
+            node->destroy = [](Node& node)
+            {
+                delete *std::launder(reinterpret_cast<FunctionType**>(node.storage));
+            };
+        }
+
+        Push(node);
+    }
+
+}
\ No newline at end of file
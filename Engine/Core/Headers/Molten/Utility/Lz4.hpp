@@ -0,0 +1,183 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#ifndef MOLTEN_CORE_UTILITY_LZ4_HPP
+#define MOLTEN_CORE_UTILITY_LZ4_HPP
+
+#include "Molten/Types.hpp"
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace Molten
+{
+    class ThreadPool;
+}
+
+/** Fast LZ77 compression, trading ratio for decompression speed of multiple GB/s per core.
+ *  Blocks use the LZ4 block format, compatible with other LZ4 implementations.
+ *  Frames are a format of this engine: a header followed by independently compressed blocks, each with an optional XXH64 checksum of its content,
+ *  an end mark and the total content size, so frames can be streamed, and decompressed in parallel if fully in memory.
+ *  Decompression validates all input and never reads or writes out of bounds, also for corrupt or malicious data.
+ */
+namespace Molten::Lz4
+{
+
+    constexpr size_t DefaultFrameBlockSize = 256 * 1024; ///< Default content size of frame blocks.
+    constexpr size_t MaxFrameBlockSize = 64 * 1024 * 1024; ///< Max content size of frame blocks.
+
+    /** Get max size of compressed block of provided content size. */
+    [[nodiscard]] MOLTEN_API size_t GetMaxCompressedBlockSize(const size_t size);
+
+    /** Compresses data into a single block. Destination should have at least GetMaxCompressedBlockSize(sourceSize) bytes of capacity.
+     *
+     * @return Size of compressed block, or 0 if destination capacity is too small.
+     */
+    [[nodiscard]] MOLTEN_API size_t CompressBlock(const void* source, const size_t sourceSize, void* destination, const size_t destinationCapacity);
+
+    /** Decompresses a single block. Content size is not stored in blocks, so the caller must know an upper bound of it.
+     *
+     * @return Size of decompressed content, or nullopt if block is invalid or destination capacity is too small.
+     */
+    [[nodiscard]] MOLTEN_API std::optional<size_t> DecompressBlock(const void* source, const size_t sourceSize, void* destination, const size_t destinationCapacity);
+
+    /** Checks if data starts with a frame header. */
+    [[nodiscard]] MOLTEN_API bool IsFrame(const void* data, const size_t size);
+
+    /** Get content size of complete frame, read from its end, or nullopt if data is not a complete frame. */
+    [[nodiscard]] MOLTEN_API std::optional<size_t> GetFrameContentSize(const void* data, const size_t size);
+
+    /** Compresses data into a frame. Blocks are compressed in parallel if a thread pool is provided.
+     *  Blocks not shrinking by compression are stored as is.
+     */
+    [[nodiscard]] MOLTEN_API std::vector<uint8_t> CompressFrame(
+        const void* data,
+        const size_t size,
+        const size_t blockSize = DefaultFrameBlockSize,
+        const bool checksum = true,
+        ThreadPool* threadPool = nullptr);
+
+    /** Decompresses complete frame. Blocks are decompressed in parallel if a thread pool is provided.
+     *
+     * @return Content, or nullopt if frame is invalid or any checksum mismatches.
+     */
+    [[nodiscard]] MOLTEN_API std::optional<std::vector<uint8_t>> DecompressFrame(const void* data, const size_t size, ThreadPool* threadPool = nullptr);
+
+
+    /** Streaming frame compressor, writing blocks to an output stream as soon as they are filled. */
+    class MOLTEN_API FrameWriter
+    {
+
+    public:
+
+        /** Constructor. Frame header is written at first write or at Finish(). */
+        explicit FrameWriter(std::ostream& stream, const size_t blockSize = DefaultFrameBlockSize, const bool checksum = true);
+
+        /** Destructor. Unfinished frames are not finished, but left incomplete. */
+        ~FrameWriter() = default;
+
+        FrameWriter(const FrameWriter&) = delete;
+        FrameWriter(FrameWriter&&) = delete;
+        FrameWriter& operator = (const FrameWriter&) = delete;
+        FrameWriter& operator = (FrameWriter&&) = delete;
+
+        /** Compresses data into the frame.
+         *
+         * @return false if writing to stream failed or frame is finished.
+         */
+        bool Write(const void* data, const size_t size);
+
+        /** Writes buffered data, end mark and content size. Following writes fail.
+         *
+         * @return false if writing to stream failed or frame is already finished.
+         */
+        bool Finish();
+
+    private:
+
+        bool WriteHeader();
+        bool WriteBlock();
+
+        std::ostream& m_stream;
+        size_t m_blockSize;
+        bool m_checksum;
+        bool m_headerWritten;
+        bool m_finished;
+        uint64_t m_contentSize;
+        std::vector<uint8_t> m_block;
+        std::vector<uint8_t> m_compressedBlock;
+
+    };
+
+
+    /** Streaming frame decompressor, reading and decompressing one block at a time from an input stream. */
+    class MOLTEN_API FrameReader
+    {
+
+    public:
+
+        explicit FrameReader(std::istream& stream);
+        ~FrameReader() = default;
+
+        FrameReader(const FrameReader&) = delete;
+        FrameReader(FrameReader&&) = delete;
+        FrameReader& operator = (const FrameReader&) = delete;
+        FrameReader& operator = (FrameReader&&) = delete;
+
+        /** Reads and decompresses content into data.
+         *
+         * @return Number of read bytes, less than size at end of frame or on error.
+         */
+        size_t Read(void* data, const size_t size);
+
+        /** Checks if whole frame has been read and validated. */
+        [[nodiscard]] bool IsFinished() const;
+
+        /** Checks if reading failed, due to stream errors, invalid data or checksum mismatches. */
+        [[nodiscard]] bool HasError() const;
+
+    private:
+
+        bool ReadHeader();
+        bool ReadBlock();
+
+        std::istream& m_stream;
+        size_t m_blockSize;
+        bool m_checksum;
+        bool m_headerRead;
+        bool m_finished;
+        bool m_error;
+        uint64_t m_contentSize;
+        std::vector<uint8_t> m_block;
+        std::vector<uint8_t> m_compressedBlock;
+        size_t m_blockPosition;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_UTILITY_MEMORYMAPPEDFILELINEREADER_HPP
+#define MOLTEN_CORE_UTILITY_MEMORYMAPPEDFILELINEREADER_HPP
+
+#include "Molten/Utility/BufferedFileLineReader.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <memory>
+#include <string_view>
+
+namespace Molten
+{
+
+    /** Zero-copy file line reader of memory mapped files.
+     *  Same interface as BufferedFileLineReader, but resulting lines are views directly into the mapped file,
+     *  so no data is copied and no buffers are allocated.
+     */
+    class MOLTEN_API MemoryMappedFileLineReader
+    {
+
+    public:
+
+        using File = std::shared_ptr<const MemoryMappedFile>; ///< File type, shared to let views outlive the reader.
+        using LineReadResult = BufferedFileLineReader::LineReadResult; ///< Line read result enumerator.
+
+        /** Constructing a line reader of provided mapped file. */
+        explicit MemoryMappedFileLineReader(File file);
+
+        /** Constructing a line reader of data within a mapped file, e.g. an entry of a packed archive.
+         *  Provided file is passed to the buffer creation callback, and may be nullptr if the data is kept alive by the caller.
+         */
+        MemoryMappedFileLineReader(const std::string_view data, File file);
+
+        /** Deleted copy/move constructors/operators. */
+        /**@{*/
+        MemoryMappedFileLineReader(const MemoryMappedFileLineReader&) = delete;
+        MemoryMappedFileLineReader(MemoryMappedFileLineReader&&) = delete;
+        MemoryMappedFileLineReader& operator = (const MemoryMappedFileLineReader&) = delete;
+        MemoryMappedFileLineReader& operator = (MemoryMappedFileLineReader&&) = delete;
+        /**@}*/
+
+        /** Default destructor.*/
+        ~MemoryMappedFileLineReader() = default;
+
+        /** Read next line from file.
+         *  Provided parameter "bufferCreationCallback" is invoked with the mapped file at first read,
+         *  so callers can keep the mapping alive the same way as buffers of BufferedFileLineReader.
+         *  This function never fails with BufferOverflow or AllocationError.
+         */
+        template<typename TBufferCreationCallback>
+        [[nodiscard]] LineReadResult ReadLine(std::string_view& line, TBufferCreationCallback&& bufferCreationCallback);
+
+        [[nodiscard]] size_t GetStreamSize() const;
+
+        [[nodiscard]] size_t GetSizeLeft() const;
+
+    private:
+
+        [[nodiscard]] LineReadResult ReadNextLine(std::string_view& line);
+
+        File m_file;
+        std::string_view m_data;
+        size_t m_position;
+
+    };
+
+}
+
+#include "Molten/Utility/MemoryMappedFileLineReader.inl"
+
+#endif
@@ -0,0 +1,64 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#ifndef MOLTEN_CORE_UTILITY_TEXTSCANNER_HPP
+#define MOLTEN_CORE_UTILITY_TEXTSCANNER_HPP
+
+#include "Molten/Types.hpp"
+#include <string_view>
+
+/** Text scanning functions, for searching newlines, whitespace and tokens in large text buffers.
+ *  Searches are vectorized using AVX2, SSE2 or NEON if enabled at compile time, with a scalar fallback.
+ *  Whitespace is defined as space or horizontal tab, and newline as line feed or carriage return.
+ */
+namespace Molten::TextScanner
+{
+
+    /** Get name of instruction set used by the scanning functions: "AVX2", "SSE2", "NEON" or "Scalar". */
+    [[nodiscard]] MOLTEN_API const char* GetInstructionSet();
+
+    /** Find functions, returning index of first matching character or std::string_view::npos if not found. */
+    /**@{*/
+    [[nodiscard]] MOLTEN_API size_t FindCharacter(const std::string_view text, const char character);
+    [[nodiscard]] MOLTEN_API size_t FindNewline(const std::string_view text);
+    [[nodiscard]] MOLTEN_API size_t FindWhitespace(const std::string_view text);
+    [[nodiscard]] MOLTEN_API size_t FindWhitespaceOr(const std::string_view text, const char separator);
+    [[nodiscard]] MOLTEN_API size_t FindNonWhitespace(const std::string_view text);
+    /**@}*/
+
+    /** Removes leading whitespace of text. */
+    MOLTEN_API void TrimWhitespaceFront(std::string_view& text);
+
+    /** Extracts next whitespace separated token of text. Leading whitespace is skipped and text is advanced to the end of the token.
+     *  @return Token, or an empty view if text contains no more tokens.
+     */
+    [[nodiscard]] MOLTEN_API std::string_view NextToken(std::string_view& text);
+
+    /** Removes comment, starting at first occurrence of comment character, and trailing whitespace of text. */
+    [[nodiscard]] MOLTEN_API std::string_view StripComment(const std::string_view text, const char commentCharacter = '#');
+
+}
+
+#endif
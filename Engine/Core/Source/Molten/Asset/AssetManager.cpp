@@ -0,0 +1,713 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Asset/AssetManager.hpp"
+#include "Molten/Mesh/ObjMeshImporter.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include "Molten/Utility/Hash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace Molten
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        constexpr Shader::Spirv::Word SpirvMagicNumber = 0x07230203;
+        constexpr size_t SpirvHeaderWordCount = 5;
+
+        bool IsFontFileSignature(const char* data, const size_t size)
+        {
+            if(size < 4)
+            {
+                return false;
+            }
+
+            static constexpr const char* signatures[] = { "\x00\x01\x00\x00", "OTTO", "true", "ttcf" };
+            for(const auto* signature : signatures)
+            {
+                if(std::memcmp(data, signature, 4) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template<typename TLoadFunction>
+        std::optional<std::string> InvokeLoad(TLoadFunction&& loadFunction)
+        {
+            try
+            {
+                return loadFunction();
+            }
+            catch(const std::exception& exception)
+            {
+                return std::string{ "Exception thrown while loading: " } + exception.what();
+            }
+            catch(...)
+            {
+                return std::string{ "Unknown exception thrown while loading" };
+            }
+        }
+
+    }
+
+
+    // Asset load context implementations.
+    AssetLoadContext::AssetLoadContext() :
+        m_progress(nullptr)
+    {}
+
+    AssetLoadContext::AssetLoadContext(std::atomic<double>& progress) :
+        m_progress(&progress)
+    {}
+
+    void AssetLoadContext::AddDependency(const std::filesystem::path& filename)
+    {
+        m_dependencies.push_back(filename);
+    }
+
+    const std::vector<std::filesystem::path>& AssetLoadContext::GetDependencies() const
+    {
+        return m_dependencies;
+    }
+
+    void AssetLoadContext::SetProgress(const double progress)
+    {
+        if(m_progress)
+        {
+            m_progress->store(std::clamp(progress, 0.0, 1.0), std::memory_order_relaxed);
+        }
+    }
+
+
+    // Asset entry base implementations.
+    AssetEntryBase::AssetEntryBase(std::filesystem::path filename) :
+        m_filename(std::move(filename)),
+        m_state(AssetState::Loading),
+        m_started(false),
+        m_reloadFinished(false),
+        m_version(0),
+        m_progress(0.0)
+    {}
+
+    const std::filesystem::path& AssetEntryBase::GetFilename() const
+    {
+        return m_filename;
+    }
+
+    AssetState AssetEntryBase::GetState() const
+    {
+        return m_state.load(std::memory_order_acquire);
+    }
+
+    std::string AssetEntryBase::GetError() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_error;
+    }
+
+    uint32_t AssetEntryBase::GetVersion() const
+    {
+        return m_version.load(std::memory_order_acquire);
+    }
+
+    double AssetEntryBase::GetProgress() const
+    {
+        return m_progress.load(std::memory_order_relaxed);
+    }
+
+    bool AssetEntryBase::TryLoad()
+    {
+        if(m_started.exchange(true))
+        {
+            return false;
+        }
+
+        AssetLoadContext context(m_progress);
+        auto error = InvokeLoad([&]() { return Load(context); });
+        if(!error.has_value())
+        {
+            ApplyLoad();
+        }
+
+        {
+            std::scoped_lock lock(m_mutex);
+            if(error.has_value())
+            {
+                m_error = std::move(error.value());
+            }
+            m_dependencies = context.GetDependencies();
+            m_progress.store(1.0, std::memory_order_relaxed);
+            m_state.store(error.has_value() ? AssetState::Failed : AssetState::Loaded, std::memory_order_release);
+        }
+        m_condition.notify_all();
+
+        return true;
+    }
+
+    void AssetEntryBase::Wait()
+    {
+        if(TryLoad())
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [&]() { return m_state.load(std::memory_order_acquire) != AssetState::Loading; });
+    }
+
+    void AssetEntryBase::Reload()
+    {
+        AssetLoadContext context;
+        m_reloadError = InvokeLoad([&]() { return Load(context); });
+        m_reloadDependencies = context.GetDependencies();
+        m_reloadFinished.store(true, std::memory_order_release);
+    }
+
+    bool AssetEntryBase::IsReloadFinished() const
+    {
+        return m_reloadFinished.load(std::memory_order_acquire);
+    }
+
+    void AssetEntryBase::ApplyReload()
+    {
+        m_reloadFinished.store(false, std::memory_order_relaxed);
+
+        std::scoped_lock lock(m_mutex);
+
+        // Failed reloads keep current asset and dependencies, so fixing the files triggers another reload.
+        if(m_reloadError.has_value())
+        {
+            m_error = std::move(m_reloadError.value());
+            m_reloadError.reset();
+            m_reloadDependencies.clear();
+            return;
+        }
+
+        ApplyLoad();
+        m_error.clear();
+        m_dependencies = std::move(m_reloadDependencies);
+        m_reloadDependencies.clear();
+        m_state.store(AssetState::Loaded, std::memory_order_release);
+        m_version.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+
+    // Asset manager implementations.
+    AssetManager::AssetManager(ThreadPool& threadPool) :
+        m_threadPool(threadPool),
+        m_runningWorkerCount(0)
+    {
+        SetLoader<MeshCacheFile>([this](const std::filesystem::path& filename, AssetLoadContext& context)
+        {
+            return LoadMeshFile(filename, context, m_threadPool);
+        });
+        SetLoader<Image>(&LoadTextureFile);
+        SetLoader<FontAsset>(&LoadFontFile);
+        SetLoader<ShaderAsset>(&LoadShaderFile);
+    }
+
+    AssetManager::~AssetManager()
+    {
+        std::unique_lock lock(m_mutex);
+        m_queuedLoads.clear();
+        m_idleCondition.wait(lock, [&]() { return m_runningWorkerCount == 0; });
+    }
+
+    AssetManager::MeshHandle AssetManager::LoadMesh(const std::filesystem::path& filename)
+    {
+        return Load<MeshCacheFile>(filename);
+    }
+
+    AssetManager::TextureHandle AssetManager::LoadTexture(const std::filesystem::path& filename)
+    {
+        return Load<Image>(filename);
+    }
+
+    AssetManager::FontHandle AssetManager::LoadFont(const std::filesystem::path& filename)
+    {
+        return Load<FontAsset>(filename);
+    }
+
+    AssetManager::ShaderHandle AssetManager::LoadShader(const std::filesystem::path& filename)
+    {
+        return Load<ShaderAsset>(filename);
+    }
+
+    bool AssetManager::SetHotReloadEnabled(const bool enabled)
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if(!enabled)
+        {
+            // Queued reloads are kept, since they may still be running, and are applied by Update.
+            m_reloads.erase(std::remove_if(m_reloads.begin(), m_reloads.end(), [](const Reload& reload) { return !reload.queued; }), m_reloads.end());
+            m_loadingEntries.clear();
+            m_watchedFiles.clear();
+            m_fileWatcher.reset();
+
+            for(auto& [key, weakEntry] : m_entries)
+            {
+                if(auto entry = weakEntry.lock(); entry)
+                {
+                    entry->m_watchedFilenames.clear();
+                }
+            }
+            return true;
+        }
+
+        if(m_fileWatcher)
+        {
+            return true;
+        }
+        if(!FileWatcher::IsSupported())
+        {
+            return false;
+        }
+
+        m_fileWatcher = std::make_unique<FileWatcher>();
+        for(auto& [key, weakEntry] : m_entries)
+        {
+            if(auto entry = weakEntry.lock(); entry)
+            {
+                WatchEntry(entry);
+                if(entry->GetState() == AssetState::Loading)
+                {
+                    m_loadingEntries.push_back(std::move(entry));
+                }
+            }
+        }
+        return true;
+    }
+
+    bool AssetManager::IsHotReloadEnabled() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_fileWatcher != nullptr;
+    }
+
+    void AssetManager::Update()
+    {
+        std::scoped_lock lock(m_mutex);
+
+        ApplyReloads();
+        if(m_fileWatcher)
+        {
+            UpdateHotReload();
+        }
+
+        ScheduleLoads();
+
+        bool released = false;
+        for(auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if(it->second.expired())
+            {
+                it = m_entries.erase(it);
+                released = true;
+                continue;
+            }
+            ++it;
+        }
+
+        if(released && m_fileWatcher)
+        {
+            RemoveReleasedWatches();
+        }
+    }
+
+    void AssetManager::WaitForLoads()
+    {
+        std::unique_lock lock(m_mutex);
+
+        while(RunNextQueuedLoad(lock))
+        {}
+
+        m_idleCondition.wait(lock, [&]() { return m_runningWorkerCount == 0; });
+    }
+
+    size_t AssetManager::GetAssetCount() const
+    {
+        std::scoped_lock lock(m_mutex);
+
+        size_t count = 0;
+        for(const auto& [key, entry] : m_entries)
+        {
+            count += entry.expired() ? 0 : 1;
+        }
+        return count;
+    }
+
+    size_t AssetManager::GetQueuedLoadCount() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_queuedLoads.size();
+    }
+
+    AssetLoadResult<MeshCacheFile> AssetManager::LoadMeshFile(
+        const std::filesystem::path& filename,
+        AssetLoadContext& context,
+        ThreadPool& threadPool)
+    {
+        ObjMeshImporter importer;
+        importer.GetReader().onProgress.Connect([&](const double progress)
+        {
+            context.SetProgress(progress);
+        });
+
+        auto result = importer.Import(filename, threadPool);
+        if(!result.IsValid())
+        {
+            return AssetLoadResult<MeshCacheFile>::CreateError(std::move(result.Error()));
+        }
+
+        auto meshCacheFile = std::make_shared<const MeshCacheFile>(std::move(result.Value()));
+        for(const auto& dependency : meshCacheFile->GetDependencies())
+        {
+            context.AddDependency(dependency.filename);
+        }
+
+        return AssetLoadResult<MeshCacheFile>::CreateSuccess(std::move(meshCacheFile));
+    }
+
+    AssetLoadResult<Image> AssetManager::LoadTextureFile(const std::filesystem::path& filename, AssetLoadContext&)
+    {
+        auto result = ImageLoaderRegistry::GetDefault()->LoadFromFile(filename, TextureFormat);
+        if(auto* error = std::get_if<std::string>(&result); error)
+        {
+            return AssetLoadResult<Image>::CreateError(std::move(*error));
+        }
+
+        return AssetLoadResult<Image>::CreateSuccess(std::move(std::get<ImageSharedPointer>(result)));
+    }
+
+    AssetLoadResult<FontAsset> AssetManager::LoadFontFile(const std::filesystem::path& filename, AssetLoadContext&)
+    {
+        auto mappedFile = std::make_shared<MemoryMappedFile>();
+        if(!mappedFile->Open(filename))
+        {
+            return AssetLoadResult<FontAsset>::CreateError("Cannot open file \"" + filename.string() + "\"");
+        }
+
+        if(!IsFontFileSignature(mappedFile->GetData(), mappedFile->GetSize()))
+        {
+            return AssetLoadResult<FontAsset>::CreateError("Unknown font format of file \"" + filename.string() + "\"");
+        }
+
+        const auto data = mappedFile->GetView();
+        auto font = std::make_shared<FontAsset>();
+        font->file = VirtualFile{ VirtualFile::MappedFile{ std::move(mappedFile) }, data };
+        return AssetLoadResult<FontAsset>::CreateSuccess(std::move(font));
+    }
+
+    AssetLoadResult<ShaderAsset> AssetManager::LoadShaderFile(const std::filesystem::path& filename, AssetLoadContext&)
+    {
+        MemoryMappedFile file;
+        if(!file.Open(filename))
+        {
+            return AssetLoadResult<ShaderAsset>::CreateError("Cannot open file \"" + filename.string() + "\"");
+        }
+
+        const auto wordSize = sizeof(Shader::Spirv::Word);
+        if(file.GetSize() % wordSize != 0 || file.GetSize() < SpirvHeaderWordCount * wordSize)
+        {
+            return AssetLoadResult<ShaderAsset>::CreateError("Invalid size of SPIR-V file \"" + filename.string() + "\"");
+        }
+
+        auto shader = std::make_shared<ShaderAsset>();
+        shader->words.resize(file.GetSize() / wordSize);
+        std::memcpy(shader->words.data(), file.GetData(), file.GetSize());
+
+        if(shader->words.front() != SpirvMagicNumber)
+        {
+            return AssetLoadResult<ShaderAsset>::CreateError("Invalid SPIR-V magic number of file \"" + filename.string() + "\"");
+        }
+
+        return AssetLoadResult<ShaderAsset>::CreateSuccess(std::move(shader));
+    }
+
+    std::filesystem::path AssetManager::NormalizeFilename(const std::filesystem::path& filename)
+    {
+        std::error_code errorCode;
+        auto absoluteFilename = std::filesystem::absolute(filename, errorCode);
+        return (errorCode ? filename : absoluteFilename).lexically_normal();
+    }
+
+    bool AssetManager::Key::operator == (const Key& rhs) const
+    {
+        return type == rhs.type && filename == rhs.filename;
+    }
+
+    size_t AssetManager::KeyHash::operator()(const Key& key) const
+    {
+        return static_cast<size_t>(Hash64(key.filename.data(), key.filename.size(), key.type.hash_code()));
+    }
+
+    void AssetManager::ScheduleLoads()
+    {
+        const auto workerLimit = m_threadPool.GetBackgroundWorkerLimit();
+        while(m_runningWorkerCount < workerLimit && m_runningWorkerCount < m_queuedLoads.size())
+        {
+            // Futures of workers are not needed, completion is tracked by m_runningWorkerCount.
+            if(!m_threadPool.TryExecute(ThreadPool::Priority::Background, [this]() { RunQueuedLoads(); }).has_value())
+            {
+                break;
+            }
+            ++m_runningWorkerCount;
+        }
+    }
+
+    void AssetManager::RunQueuedLoads()
+    {
+        std::unique_lock lock(m_mutex);
+
+        while(RunNextQueuedLoad(lock))
+        {}
+
+        --m_runningWorkerCount;
+        m_idleCondition.notify_all();
+    }
+
+    bool AssetManager::RunNextQueuedLoad(std::unique_lock<std::mutex>& lock)
+    {
+        while(!m_queuedLoads.empty())
+        {
+            auto queuedLoad = std::move(m_queuedLoads.front());
+            m_queuedLoads.pop_front();
+
+            auto entry = queuedLoad.entry.lock();
+            if(!entry)
+            {
+                continue;
+            }
+
+            lock.unlock();
+            if(queuedLoad.reload)
+            {
+                entry->Reload();
+            }
+            else
+            {
+                entry->TryLoad();
+            }
+            entry.reset();
+            lock.lock();
+
+            return true;
+        }
+        return false;
+    }
+
+    void AssetManager::ApplyReloads()
+    {
+        for(auto it = m_reloads.begin(); it != m_reloads.end();)
+        {
+            auto entry = it->entry.lock();
+            if(entry && it->queued && entry->IsReloadFinished())
+            {
+                entry->ApplyReload();
+                if(m_fileWatcher)
+                {
+                    WatchEntry(entry);
+                }
+
+                it->queued = false;
+                if(!std::exchange(it->reloadAgain, false))
+                {
+                    entry.reset();
+                }
+            }
+
+            it = entry ? std::next(it) : m_reloads.erase(it);
+        }
+    }
+
+    void AssetManager::UpdateHotReload()
+    {
+        // Dependencies are known once loaded.
+        for(auto it = m_loadingEntries.begin(); it != m_loadingEntries.end();)
+        {
+            auto entry = it->lock();
+            if(entry && entry->GetState() == AssetState::Loading)
+            {
+                ++it;
+                continue;
+            }
+
+            if(entry)
+            {
+                WatchEntry(entry);
+            }
+            it = m_loadingEntries.erase(it);
+        }
+
+        for(const auto& filename : m_fileWatcher->Poll())
+        {
+            auto watchedIt = m_watchedFiles.find(filename.generic_string());
+            if(watchedIt == m_watchedFiles.end())
+            {
+                continue;
+            }
+
+            for(const auto& weakEntry : watchedIt->second)
+            {
+                auto entry = weakEntry.lock();
+                if(!entry)
+                {
+                    continue;
+                }
+
+                auto reloadIt = std::find_if(m_reloads.begin(), m_reloads.end(), [&](const Reload& reload)
+                {
+                    return reload.entry.lock() == entry;
+                });
+
+                if(reloadIt == m_reloads.end())
+                {
+                    m_reloads.push_back({ std::move(entry), false, false });
+                }
+                else if(reloadIt->queued)
+                {
+                    reloadIt->reloadAgain = true;
+                }
+            }
+        }
+
+        // Assets still loading are reloaded once loaded, since their files may have been modified after being read.
+        for(auto& reload : m_reloads)
+        {
+            if(reload.queued)
+            {
+                continue;
+            }
+
+            if(auto entry = reload.entry.lock(); entry && entry->GetState() != AssetState::Loading)
+            {
+                m_queuedLoads.push_back({ std::move(entry), true });
+                reload.queued = true;
+            }
+        }
+    }
+
+    void AssetManager::WatchEntry(const std::shared_ptr<AssetEntryBase>& entry)
+    {
+        std::vector<std::string> filenames = { entry->GetFilename().generic_string() };
+        if(entry->GetState() != AssetState::Loading)
+        {
+            for(const auto& dependency : entry->m_dependencies)
+            {
+                filenames.push_back(NormalizeFilename(dependency).generic_string());
+            }
+        }
+        std::sort(filenames.begin(), filenames.end());
+        filenames.erase(std::unique(filenames.begin(), filenames.end()), filenames.end());
+
+        auto& watchedFilenames = entry->m_watchedFilenames;
+
+        for(const auto& filename : watchedFilenames)
+        {
+            if(std::binary_search(filenames.begin(), filenames.end(), filename))
+            {
+                continue;
+            }
+
+            auto watchedIt = m_watchedFiles.find(filename);
+            if(watchedIt == m_watchedFiles.end())
+            {
+                continue;
+            }
+
+            auto& entries = watchedIt->second;
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const std::weak_ptr<AssetEntryBase>& weakEntry)
+            {
+                auto lockedEntry = weakEntry.lock();
+                return !lockedEntry || lockedEntry == entry;
+            }), entries.end());
+
+            if(entries.empty())
+            {
+                m_fileWatcher->Unwatch(filename);
+                m_watchedFiles.erase(watchedIt);
+            }
+        }
+
+        std::vector<std::string> newWatchedFilenames;
+        newWatchedFilenames.reserve(filenames.size());
+
+        for(auto& filename : filenames)
+        {
+            if(std::binary_search(watchedFilenames.begin(), watchedFilenames.end(), filename))
+            {
+                newWatchedFilenames.push_back(std::move(filename));
+                continue;
+            }
+
+            // Files are only unwatched once the last asset is removed, so a missing entry means the file is not watched yet.
+            if(auto watchedIt = m_watchedFiles.find(filename); watchedIt != m_watchedFiles.end())
+            {
+                watchedIt->second.push_back(entry);
+            }
+            else if(m_fileWatcher->Watch(filename))
+            {
+                m_watchedFiles.emplace(filename, std::vector<std::weak_ptr<AssetEntryBase>>{ entry });
+            }
+            else
+            {
+                continue;
+            }
+            newWatchedFilenames.push_back(std::move(filename));
+        }
+
+        watchedFilenames = std::move(newWatchedFilenames);
+    }
+
+    void AssetManager::RemoveReleasedWatches()
+    {
+        for(auto it = m_watchedFiles.begin(); it != m_watchedFiles.end();)
+        {
+            auto& entries = it->second;
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [](const std::weak_ptr<AssetEntryBase>& weakEntry)
+            {
+                return weakEntry.expired();
+            }), entries.end());
+
+            if(entries.empty())
+            {
+                m_fileWatcher->Unwatch(it->first);
+                it = m_watchedFiles.erase(it);
+                continue;
+            }
+            ++it;
+        }
+    }
+
+}
@@ -0,0 +1,464 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/FileFormat/Archive/PakArchive.hpp"
+#include "Molten/Utility/Hash.hpp"
+#include "Molten/Utility/Lz4.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace Molten
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        constexpr uint32_t PakMagic = 0x4B41504D; ///< "MPAK"
+        constexpr uint32_t PakVersion = 1;
+        constexpr size_t PakIndexAlignment = 8;
+
+        /** Header at the beginning of pak archives. Entry data follows the header, and the index follows the entry data. */
+        struct PakHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t alignment; ///< Alignment of entry data.
+            uint32_t entryCount;
+            uint32_t slotCount; ///< Number of hash table slots, a power of two.
+            uint32_t reserved;
+            uint64_t indexOffset; ///< Offset of entries, followed by hash table slots.
+            uint64_t stringsOffset; ///< Offset of entry paths, not null terminated.
+            uint64_t stringsSize;
+        };
+
+        struct PakEntry
+        {
+            uint64_t pathHash;
+            uint64_t offset;
+            uint64_t storedSize;
+            uint64_t originalSize;
+            uint32_t pathOffset;
+            uint32_t pathLength;
+            PakCompression compression;
+            uint8_t reserved[7];
+        };
+
+        static_assert(sizeof(PakHeader) == 48, "Unexpected size of pak header.");
+        static_assert(sizeof(PakEntry) == 48, "Unexpected size of pak entry.");
+
+        uint64_t HashPakPath(const std::string_view path)
+        {
+            return Hash64(path.data(), path.size());
+        }
+
+        uint32_t GetPakSlotCount(const size_t entryCount)
+        {
+            // Load factor of at most 0.5 keeps probe sequences short.
+            uint32_t slotCount = 1;
+            while(slotCount < entryCount * 2)
+            {
+                slotCount <<= 1;
+            }
+            return slotCount;
+        }
+
+        size_t AlignPakOffset(const size_t offset, const size_t alignment)
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        bool IsValidPakCompression(const PakCompression compression)
+        {
+            return compression == PakCompression::None || compression == PakCompression::Lz4;
+        }
+
+        /** Checks sizes of entry, rejecting compressed entries of impossible compression ratios before allocating their content. */
+        bool IsValidPakEntrySize(const PakCompression compression, const uint64_t storedSize, const uint64_t originalSize)
+        {
+            switch(compression)
+            {
+                case PakCompression::None: return storedSize == originalSize;
+                case PakCompression::Lz4: return storedSize > 0 && originalSize / 255 <= storedSize;
+            }
+            return false;
+        }
+
+        bool WritePakPadding(std::ofstream& file, const size_t alignment)
+        {
+            static const char zeros[256] = {};
+            const auto offset = static_cast<size_t>(file.tellp());
+            auto padding = AlignPakOffset(offset, alignment) - offset;
+            while(padding > 0)
+            {
+                const auto size = std::min(padding, sizeof(zeros));
+                file.write(zeros, static_cast<std::streamsize>(size));
+                padding -= size;
+            }
+            return file.good();
+        }
+
+    }
+
+
+    // Pak archive writer implementations.
+    PakArchiveWriter::PakArchiveWriter(const size_t alignment) :
+        m_alignment(alignment > 0 && (alignment & (alignment - 1)) == 0 ? alignment : DefaultAlignment)
+    {}
+
+    bool PakArchiveWriter::AddFile(const std::string_view path, std::vector<uint8_t> data, const PakCompression compression)
+    {
+        return AddFile(File{ VirtualFileSystem::NormalizePath(path), std::move(data), {}, compression });
+    }
+
+    bool PakArchiveWriter::AddFileFromDisk(const std::string_view path, const std::filesystem::path& filename, const PakCompression compression)
+    {
+        return AddFile(File{ VirtualFileSystem::NormalizePath(path), {}, filename, compression });
+    }
+
+    bool PakArchiveWriter::AddDirectory(const std::filesystem::path& directory, const std::string_view archiveDirectory, const PakCompression compression)
+    {
+        std::error_code errorCode;
+        auto iterator = std::filesystem::recursive_directory_iterator(directory, errorCode);
+        if(errorCode)
+        {
+            return false;
+        }
+
+        // Sorted paths make archives of unchanged directories identical.
+        std::vector<std::filesystem::path> filenames;
+        for(const auto& entry : iterator)
+        {
+            if(entry.is_regular_file(errorCode))
+            {
+                filenames.push_back(entry.path());
+            }
+        }
+        std::sort(filenames.begin(), filenames.end());
+
+        bool result = true;
+        for(const auto& filename : filenames)
+        {
+            const auto relativePath = std::filesystem::relative(filename, directory, errorCode);
+            if(errorCode)
+            {
+                return false;
+            }
+
+            const auto path = std::string{ archiveDirectory } + "/" + relativePath.generic_u8string();
+            result = AddFileFromDisk(path, filename, compression) && result;
+        }
+        return result;
+    }
+
+    size_t PakArchiveWriter::GetFileCount() const
+    {
+        return m_files.size();
+    }
+
+    bool PakArchiveWriter::WriteToFile(const std::filesystem::path& filename) const
+    {
+        std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        if(!file.is_open())
+        {
+            return false;
+        }
+
+        PakHeader header = {};
+        header.magic = PakMagic;
+        header.version = PakVersion;
+        header.alignment = static_cast<uint32_t>(m_alignment);
+        header.entryCount = static_cast<uint32_t>(m_files.size());
+        header.slotCount = GetPakSlotCount(m_files.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Write entry data.
+        std::vector<PakEntry> entries(m_files.size());
+        std::string strings;
+
+        for(size_t i = 0; i < m_files.size(); i++)
+        {
+            const auto& pakFile = m_files[i];
+
+            std::string_view data{ reinterpret_cast<const char*>(pakFile.data.data()), pakFile.data.size() };
+            MemoryMappedFile mappedFile;
+            if(!pakFile.sourceFilename.empty())
+            {
+                if(!mappedFile.Open(pakFile.sourceFilename))
+                {
+                    return false;
+                }
+                data = mappedFile.GetView();
+            }
+
+            auto& entry = entries[i];
+            entry.originalSize = data.size();
+            entry.compression = PakCompression::None;
+
+            std::vector<char> compressedData;
+            if(pakFile.compression == PakCompression::Lz4 && !data.empty())
+            {
+                compressedData.resize(Lz4::GetMaxCompressedBlockSize(data.size()));
+                compressedData.resize(Lz4::CompressBlock(data.data(), data.size(), compressedData.data(), compressedData.size()));
+                if(!compressedData.empty() && compressedData.size() < data.size())
+                {
+                    data = std::string_view{ compressedData.data(), compressedData.size() };
+                    entry.compression = PakCompression::Lz4;
+                }
+            }
+
+            if(!WritePakPadding(file, m_alignment))
+            {
+                return false;
+            }
+
+            entry.pathHash = HashPakPath(pakFile.path);
+            entry.offset = static_cast<uint64_t>(file.tellp());
+            entry.storedSize = data.size();
+            entry.pathOffset = static_cast<uint32_t>(strings.size());
+            entry.pathLength = static_cast<uint32_t>(pakFile.path.size());
+
+            strings.append(pakFile.path);
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        // Write index.
+        std::vector<uint32_t> slots(header.slotCount, 0);
+        const auto slotMask = header.slotCount - 1;
+        for(size_t i = 0; i < entries.size(); i++)
+        {
+            auto slot = static_cast<uint32_t>(entries[i].pathHash) & slotMask;
+            while(slots[slot] != 0)
+            {
+                slot = (slot + 1) & slotMask;
+            }
+            slots[slot] = static_cast<uint32_t>(i + 1);
+        }
+
+        if(!WritePakPadding(file, PakIndexAlignment))
+        {
+            return false;
+        }
+
+        header.indexOffset = static_cast<uint64_t>(file.tellp());
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PakEntry)));
+        file.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(uint32_t)));
+
+        header.stringsOffset = static_cast<uint64_t>(file.tellp());
+        header.stringsSize = strings.size();
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return file.good();
+    }
+
+    bool PakArchiveWriter::AddFile(File&& file)
+    {
+        if(file.path.empty() || !IsValidPakCompression(file.compression) || m_files.size() >= std::numeric_limits<uint32_t>::max() / 2)
+        {
+            return false;
+        }
+
+        if(!m_paths.insert(file.path).second)
+        {
+            return false;
+        }
+
+        m_files.push_back(std::move(file));
+        return true;
+    }
+
+
+    // Pak archive implementations.
+    struct PakArchive::Entry : PakEntry
+    {};
+
+    std::shared_ptr<PakArchive> PakArchive::OpenFromFile(const std::filesystem::path& filename)
+    {
+        auto file = std::make_shared<MemoryMappedFile>();
+        if(!file->Open(filename) || file->GetSize() < sizeof(PakHeader))
+        {
+            return nullptr;
+        }
+
+        const auto* data = file->GetData();
+        const auto size = static_cast<uint64_t>(file->GetSize());
+
+        PakHeader header;
+        std::memcpy(&header, data, sizeof(header));
+
+        if(header.magic != PakMagic || header.version != PakVersion ||
+            header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0 || header.slotCount < header.entryCount ||
+            header.indexOffset % PakIndexAlignment != 0)
+        {
+            return nullptr;
+        }
+
+        const auto indexSize = static_cast<uint64_t>(header.entryCount) * sizeof(PakEntry) + static_cast<uint64_t>(header.slotCount) * sizeof(uint32_t);
+        if(header.indexOffset > size || indexSize > size - header.indexOffset ||
+            header.stringsOffset > size || header.stringsSize > size - header.stringsOffset)
+        {
+            return nullptr;
+        }
+
+        const auto* entries = reinterpret_cast<const Entry*>(data + header.indexOffset);
+        const auto* slots = reinterpret_cast<const uint32_t*>(data + header.indexOffset + header.entryCount * sizeof(PakEntry));
+
+        // Validate all entries and slots once, so lookups are free of bounds checks.
+        for(uint32_t i = 0; i < header.entryCount; i++)
+        {
+            const auto& entry = entries[i];
+            if(entry.offset > size || entry.storedSize > size - entry.offset ||
+                static_cast<uint64_t>(entry.pathOffset) + entry.pathLength > header.stringsSize ||
+                !IsValidPakCompression(entry.compression) ||
+                !IsValidPakEntrySize(entry.compression, entry.storedSize, entry.originalSize))
+            {
+                return nullptr;
+            }
+        }
+        for(uint32_t i = 0; i < header.slotCount; i++)
+        {
+            if(slots[i] > header.entryCount)
+            {
+                return nullptr;
+            }
+        }
+
+        return std::shared_ptr<PakArchive>(new PakArchive(
+            std::move(file), entries, slots, data + header.stringsOffset, header.entryCount, header.slotCount));
+    }
+
+    std::optional<VirtualFile> PakArchive::Open(const std::string_view path) const
+    {
+        const auto* entry = FindEntry(path);
+        if(!entry)
+        {
+            return std::nullopt;
+        }
+
+        const auto data = std::string_view{ m_file->GetData() + entry->offset, static_cast<size_t>(entry->storedSize) };
+        if(entry->compression == PakCompression::None)
+        {
+            return VirtualFile{ m_file, data };
+        }
+
+        auto content = std::make_shared<std::vector<char>>(static_cast<size_t>(entry->originalSize));
+        if(Lz4::DecompressBlock(data.data(), data.size(), content->data(), content->size()) != content->size())
+        {
+            return std::nullopt;
+        }
+
+        const auto contentView = std::string_view{ content->data(), content->size() };
+        return VirtualFile{ VirtualFile::Owner{ std::move(content) }, contentView };
+    }
+
+    bool PakArchive::Exists(const std::string_view path) const
+    {
+        return FindEntry(path) != nullptr;
+    }
+
+    bool PakArchive::ListDirectory(const std::string_view directory, std::vector<std::string>& names) const
+    {
+        bool found = directory.empty();
+        for(uint32_t i = 0; i < m_entryCount; i++)
+        {
+            auto path = GetEntryPath(m_entries[i]);
+            if(!directory.empty())
+            {
+                if(path.size() <= directory.size() || path.compare(0, directory.size(), directory) != 0 || path[directory.size()] != '/')
+                {
+                    continue;
+                }
+                path.remove_prefix(directory.size() + 1);
+                found = true;
+            }
+
+            if(path.find('/') == std::string_view::npos)
+            {
+                names.emplace_back(path);
+            }
+        }
+        return found;
+    }
+
+    size_t PakArchive::GetFileCount() const
+    {
+        return m_entryCount;
+    }
+
+    std::string_view PakArchive::GetFilePath(const size_t index) const
+    {
+        return index < m_entryCount ? GetEntryPath(m_entries[index]) : std::string_view{};
+    }
+
+    PakArchive::PakArchive(
+        VirtualFile::MappedFile file,
+        const Entry* entries,
+        const uint32_t* slots,
+        const char* strings,
+        const uint32_t entryCount,
+        const uint32_t slotCount
+    ) :
+        m_file(std::move(file)),
+        m_entries(entries),
+        m_slots(slots),
+        m_strings(strings),
+        m_entryCount(entryCount),
+        m_slotMask(slotCount - 1)
+    {}
+
+    const PakArchive::Entry* PakArchive::FindEntry(const std::string_view path) const
+    {
+        const auto hash = HashPakPath(path);
+
+        // Linear probing, ending at the first empty slot. Probes are bounded in case of corrupt archives without empty slots.
+        for(uint32_t slot = static_cast<uint32_t>(hash) & m_slotMask, probeCount = 0; probeCount <= m_slotMask; slot = (slot + 1) & m_slotMask, probeCount++)
+        {
+            const auto entryIndex = m_slots[slot];
+            if(entryIndex == 0)
+            {
+                return nullptr;
+            }
+
+            const auto& entry = m_entries[entryIndex - 1];
+            if(entry.pathHash == hash && GetEntryPath(entry) == path)
+            {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::string_view PakArchive::GetEntryPath(const Entry& entry) const
+    {
+        return { m_strings + entry.pathOffset, entry.pathLength };
+    }
+
+}
@@ -0,0 +1,1170 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/FileFormat/Image/BlockCompressor.hpp"
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOLTEN_BLOCKCOMPRESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Molten
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        constexpr size_t NoChannel = std::numeric_limits<size_t>::max();
+
+        /** Byte offsets of channels in source pixels, NoChannel for missing channels. */
+        struct SourceLayout
+        {
+            size_t channelCount;
+            std::array<size_t, 4> offsets;
+        };
+
+        std::optional<SourceLayout> GetSourceLayout(const ImageFormat format)
+        {
+            switch(format)
+            {
+                case ImageFormat::URed8: return SourceLayout{ 1, { 0, NoChannel, NoChannel, NoChannel } };
+                case ImageFormat::URed8Green8: return SourceLayout{ 2, { 0, 1, NoChannel, NoChannel } };
+                default: break;
+            }
+
+            const auto layout = PixelConversion::GetLayout(format);
+            if(!layout)
+            {
+                return std::nullopt;
+            }
+            return SourceLayout{
+                layout->channelCount,
+                {
+                    layout->bgr ? size_t{ 2 } : size_t{ 0 },
+                    size_t{ 1 },
+                    layout->bgr ? size_t{ 0 } : size_t{ 2 },
+                    layout->channelCount == 4 ? size_t{ 3 } : NoChannel
+                }
+            };
+        }
+
+        /** Pixels of block in planar layout, with values in range [0, 255]. */
+        struct Block
+        {
+            alignas(16) float channels[4][16];
+            alignas(16) float mask[16]; ///< Error weight of each pixel, 0 for pixels to ignore.
+        };
+
+        void LoadBlock(
+            const uint8_t* pixels,
+            const Vector2ui32& dimensions,
+            const SourceLayout& layout,
+            const uint32_t blockX,
+            const uint32_t blockY,
+            Block& block)
+        {
+            for(uint32_t y = 0; y < 4; y++)
+            {
+                const auto sourceY = std::min(blockY * 4 + y, dimensions.y - 1);
+                for(uint32_t x = 0; x < 4; x++)
+                {
+                    const auto sourceX = std::min(blockX * 4 + x, dimensions.x - 1);
+                    const auto* pixel = pixels + (static_cast<size_t>(sourceY) * dimensions.x + sourceX) * layout.channelCount;
+                    const auto index = y * 4 + x;
+                    for(size_t channel = 0; channel < 4; channel++)
+                    {
+                        const auto offset = layout.offsets[channel];
+                        block.channels[channel][index] = offset != NoChannel ?
+                            static_cast<float>(pixel[offset]) : (channel == 3 ? 255.0f : 0.0f);
+                    }
+                    block.mask[index] = 1.0f;
+                }
+            }
+        }
+
+        /** Selects palette entry closest to each pixel, considering the first channelCount channels.
+         *
+         * @return Sum of squared errors of pixels, weighted by block mask.
+         */
+        float SelectIndices(
+            const Block& block,
+            const size_t channelCount,
+            const float (*palette)[4],
+            const size_t paletteCount,
+            uint8_t* indices)
+        {
+            float totalError = 0.0f;
+
+        #if defined(MOLTEN_BLOCKCOMPRESSOR_SSE2)
+            for(size_t group = 0; group < 16; group += 4)
+            {
+                __m128 values[4];
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    values[channel] = _mm_load_ps(block.channels[channel] + group);
+                }
+
+                auto bestError = _mm_set1_ps(std::numeric_limits<float>::max());
+                auto bestIndex = _mm_setzero_si128();
+                for(size_t entry = 0; entry < paletteCount; entry++)
+                {
+                    auto error = _mm_setzero_ps();
+                    for(size_t channel = 0; channel < channelCount; channel++)
+                    {
+                        const auto difference = _mm_sub_ps(values[channel], _mm_set1_ps(palette[entry][channel]));
+                        error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+                    }
+
+                    const auto less = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+                    bestError = _mm_min_ps(error, bestError);
+                    bestIndex = _mm_or_si128(
+                        _mm_and_si128(less, _mm_set1_epi32(static_cast<int>(entry))),
+                        _mm_andnot_si128(less, bestIndex));
+                }
+
+                alignas(16) float errors[4];
+                alignas(16) int32_t groupIndices[4];
+                _mm_store_ps(errors, _mm_mul_ps(bestError, _mm_load_ps(block.mask + group)));
+                _mm_store_si128(reinterpret_cast<__m128i*>(groupIndices), bestIndex);
+                for(size_t i = 0; i < 4; i++)
+                {
+                    totalError += errors[i];
+                    indices[group + i] = static_cast<uint8_t>(groupIndices[i]);
+                }
+            }
+        #else
+            for(size_t i = 0; i < 16; i++)
+            {
+                float bestError = std::numeric_limits<float>::max();
+                uint8_t bestIndex = 0;
+                for(size_t entry = 0; entry < paletteCount; entry++)
+                {
+                    float error = 0.0f;
+                    for(size_t channel = 0; channel < channelCount; channel++)
+                    {
+                        const auto difference = block.channels[channel][i] - palette[entry][channel];
+                        error += difference * difference;
+                    }
+                    if(error < bestError)
+                    {
+                        bestError = error;
+                        bestIndex = static_cast<uint8_t>(entry);
+                    }
+                }
+                totalError += bestError * block.mask[i];
+                indices[i] = bestIndex;
+            }
+        #endif
+
+            return totalError;
+        }
+
+        /** Endpoints at opposite corners of bounding box of masked pixels, along the diagonal following the block's main trend. */
+        void CalculateBoundingBoxEndpoints(const Block& block, const size_t channelCount, float* endpoint0, float* endpoint1)
+        {
+            float minimum[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+            float maximum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float mean[4] = {};
+            float weightSum = 0.0f;
+            for(size_t i = 0; i < 16; i++)
+            {
+                if(block.mask[i] == 0.0f)
+                {
+                    continue;
+                }
+                weightSum += 1.0f;
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    const auto value = block.channels[channel][i];
+                    minimum[channel] = std::min(minimum[channel], value);
+                    maximum[channel] = std::max(maximum[channel], value);
+                    mean[channel] += value;
+                }
+            }
+            if(weightSum == 0.0f)
+            {
+                std::fill(endpoint0, endpoint0 + channelCount, 0.0f);
+                std::fill(endpoint1, endpoint1 + channelCount, 0.0f);
+                return;
+            }
+
+            // Flip channels varying in opposite direction of the channel of largest range.
+            size_t mainChannel = 0;
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                mean[channel] /= weightSum;
+                if(maximum[channel] - minimum[channel] > maximum[mainChannel] - minimum[mainChannel])
+                {
+                    mainChannel = channel;
+                }
+            }
+
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                float covariance = 0.0f;
+                for(size_t i = 0; i < 16; i++)
+                {
+                    covariance += block.mask[i] *
+                        (block.channels[channel][i] - mean[channel]) * (block.channels[mainChannel][i] - mean[mainChannel]);
+                }
+                endpoint0[channel] = covariance < 0.0f ? maximum[channel] : minimum[channel];
+                endpoint1[channel] = covariance < 0.0f ? minimum[channel] : maximum[channel];
+            }
+        }
+
+        /** Endpoints at extremes of masked pixels projected onto the principal axis of the block. */
+        void CalculatePrincipalAxisEndpoints(const Block& block, const size_t channelCount, float* endpoint0, float* endpoint1)
+        {
+            float mean[4] = {};
+            float weightSum = 0.0f;
+            for(size_t i = 0; i < 16; i++)
+            {
+                weightSum += block.mask[i];
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    mean[channel] += block.channels[channel][i] * block.mask[i];
+                }
+            }
+            if(weightSum == 0.0f)
+            {
+                std::fill(endpoint0, endpoint0 + channelCount, 0.0f);
+                std::fill(endpoint1, endpoint1 + channelCount, 0.0f);
+                return;
+            }
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                mean[channel] /= weightSum;
+            }
+
+            float covariance[4][4] = {};
+            for(size_t i = 0; i < 16; i++)
+            {
+                float difference[4];
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    difference[channel] = block.channels[channel][i] - mean[channel];
+                }
+                for(size_t row = 0; row < channelCount; row++)
+                {
+                    for(size_t column = 0; column < channelCount; column++)
+                    {
+                        covariance[row][column] += difference[row] * difference[column] * block.mask[i];
+                    }
+                }
+            }
+
+            // Power iteration, starting from the bounding box diagonal.
+            float axis[4];
+            CalculateBoundingBoxEndpoints(block, channelCount, endpoint0, endpoint1);
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                axis[channel] = endpoint1[channel] - endpoint0[channel];
+            }
+            for(size_t iteration = 0; iteration < 8; iteration++)
+            {
+                float next[4] = {};
+                float length = 0.0f;
+                for(size_t row = 0; row < channelCount; row++)
+                {
+                    for(size_t column = 0; column < channelCount; column++)
+                    {
+                        next[row] += covariance[row][column] * axis[column];
+                    }
+                    length = std::max(length, std::abs(next[row]));
+                }
+                if(length < 1e-6f)
+                {
+                    break;
+                }
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    axis[channel] = next[channel] / length;
+                }
+            }
+
+            float axisLengthSquared = 0.0f;
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                axisLengthSquared += axis[channel] * axis[channel];
+            }
+            if(axisLengthSquared < 1e-12f)
+            {
+                std::copy(mean, mean + channelCount, endpoint0);
+                std::copy(mean, mean + channelCount, endpoint1);
+                return;
+            }
+
+            float minimumProjection = std::numeric_limits<float>::max();
+            float maximumProjection = std::numeric_limits<float>::lowest();
+            for(size_t i = 0; i < 16; i++)
+            {
+                if(block.mask[i] == 0.0f)
+                {
+                    continue;
+                }
+                float projection = 0.0f;
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    projection += (block.channels[channel][i] - mean[channel]) * axis[channel];
+                }
+                minimumProjection = std::min(minimumProjection, projection);
+                maximumProjection = std::max(maximumProjection, projection);
+            }
+
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                const auto scale = axis[channel] / axisLengthSquared;
+                endpoint0[channel] = std::clamp(mean[channel] + minimumProjection * scale, 0.0f, 255.0f);
+                endpoint1[channel] = std::clamp(mean[channel] + maximumProjection * scale, 0.0f, 255.0f);
+            }
+        }
+
+        /** Least squares fit of endpoints to selected indices, where palette entry i is endpoint0 + (endpoint1 - endpoint0) * indexWeights[i]. */
+        bool RefineEndpoints(
+            const Block& block,
+            const size_t channelCount,
+            const uint8_t* indices,
+            const float* indexWeights,
+            float* endpoint0,
+            float* endpoint1)
+        {
+            float a = 0.0f;
+            float b = 0.0f;
+            float c = 0.0f;
+            float x0[4] = {};
+            float x1[4] = {};
+            for(size_t i = 0; i < 16; i++)
+            {
+                const auto t = indexWeights[indices[i]] * block.mask[i];
+                const auto s = (1.0f - indexWeights[indices[i]]) * block.mask[i];
+                a += s * s;
+                b += s * t;
+                c += t * t;
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    x0[channel] += s * block.channels[channel][i];
+                    x1[channel] += t * block.channels[channel][i];
+                }
+            }
+
+            const auto determinant = a * c - b * b;
+            if(std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+
+            for(size_t channel = 0; channel < channelCount; channel++)
+            {
+                endpoint0[channel] = std::clamp((c * x0[channel] - b * x1[channel]) / determinant, 0.0f, 255.0f);
+                endpoint1[channel] = std::clamp((a * x1[channel] - b * x0[channel]) / determinant, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        bool HasTransparentPixels(const Block& block)
+        {
+            for(size_t i = 0; i < 16; i++)
+            {
+                if(block.channels[3][i] < 128.0f)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+
+        // BC1 color blocks.
+        uint16_t PackRgb565(const float* color)
+        {
+            const auto red = static_cast<uint16_t>(std::lround(std::clamp(color[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+            const auto green = static_cast<uint16_t>(std::lround(std::clamp(color[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+            const auto blue = static_cast<uint16_t>(std::lround(std::clamp(color[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+            return static_cast<uint16_t>((red << 11) | (green << 5) | blue);
+        }
+
+        std::array<uint8_t, 3> UnpackRgb565(const uint16_t color)
+        {
+            const auto red = static_cast<uint8_t>((color >> 11) & 31);
+            const auto green = static_cast<uint8_t>((color >> 5) & 63);
+            const auto blue = static_cast<uint8_t>(color & 31);
+            return {
+                static_cast<uint8_t>((red << 3) | (red >> 2)),
+                static_cast<uint8_t>((green << 2) | (green >> 4)),
+                static_cast<uint8_t>((blue << 3) | (blue >> 2))
+            };
+        }
+
+        /** Palette of BC1 color block as RGBA. Three color palettes have a transparent black fourth entry. */
+        std::array<std::array<uint8_t, 4>, 4> CreateBc1Palette(const uint16_t color0, const uint16_t color1, const bool threeColor)
+        {
+            const auto rgb0 = UnpackRgb565(color0);
+            const auto rgb1 = UnpackRgb565(color1);
+
+            std::array<std::array<uint8_t, 4>, 4> palette;
+            for(size_t channel = 0; channel < 3; channel++)
+            {
+                const auto value0 = static_cast<uint32_t>(rgb0[channel]);
+                const auto value1 = static_cast<uint32_t>(rgb1[channel]);
+                palette[0][channel] = static_cast<uint8_t>(value0);
+                palette[1][channel] = static_cast<uint8_t>(value1);
+                if(threeColor)
+                {
+                    palette[2][channel] = static_cast<uint8_t>((value0 + value1 + 1) / 2);
+                    palette[3][channel] = 0;
+                }
+                else
+                {
+                    palette[2][channel] = static_cast<uint8_t>((2 * value0 + value1 + 1) / 3);
+                    palette[3][channel] = static_cast<uint8_t>((value0 + 2 * value1 + 1) / 3);
+                }
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = threeColor ? 0 : 255;
+            return palette;
+        }
+
+        float EvaluateBc1Endpoints(
+            const Block& block,
+            const float* endpoint0,
+            const float* endpoint1,
+            const bool threeColor,
+            uint16_t& color0,
+            uint16_t& color1,
+            uint8_t* indices)
+        {
+            color0 = PackRgb565(endpoint0);
+            color1 = PackRgb565(endpoint1);
+            const auto palette = CreateBc1Palette(color0, color1, threeColor);
+
+            float paletteValues[4][4];
+            for(size_t entry = 0; entry < 4; entry++)
+            {
+                for(size_t channel = 0; channel < 4; channel++)
+                {
+                    paletteValues[entry][channel] = static_cast<float>(palette[entry][channel]);
+                }
+            }
+            return SelectIndices(block, 3, paletteValues, threeColor ? 3 : 4, indices);
+        }
+
+        /** Encodes color block of BC1 or BC3. Pixels with alpha below 128 are encoded as transparent if allowTransparency is true. */
+        void EncodeBc1Block(Block block, const BlockCompressor::Quality quality, const bool allowTransparency, uint8_t* output)
+        {
+            const bool threeColor = allowTransparency && HasTransparentPixels(block);
+            bool hasOpaquePixels = !threeColor;
+            if(threeColor)
+            {
+                for(size_t i = 0; i < 16; i++)
+                {
+                    block.mask[i] = block.channels[3][i] < 128.0f ? 0.0f : 1.0f;
+                    hasOpaquePixels |= block.mask[i] != 0.0f;
+                }
+            }
+
+            uint16_t color0 = 0;
+            uint16_t color1 = 0;
+            uint8_t indices[16] = {};
+
+            if(hasOpaquePixels)
+            {
+                float endpoint0[3];
+                float endpoint1[3];
+                if(quality == BlockCompressor::Quality::Fast)
+                {
+                    CalculateBoundingBoxEndpoints(block, 3, endpoint0, endpoint1);
+                }
+                else
+                {
+                    CalculatePrincipalAxisEndpoints(block, 3, endpoint0, endpoint1);
+                }
+
+                float bestError = EvaluateBc1Endpoints(block, endpoint0, endpoint1, threeColor, color0, color1, indices);
+
+                if(quality == BlockCompressor::Quality::High)
+                {
+                    static const float fourColorWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+                    static const float threeColorWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+                    for(size_t iteration = 0; iteration < 2 && bestError > 0.0f; iteration++)
+                    {
+                        if(!RefineEndpoints(block, 3, indices, threeColor ? threeColorWeights : fourColorWeights, endpoint0, endpoint1))
+                        {
+                            break;
+                        }
+
+                        uint16_t refinedColor0 = 0;
+                        uint16_t refinedColor1 = 0;
+                        uint8_t refinedIndices[16];
+                        const auto error = EvaluateBc1Endpoints(block, endpoint0, endpoint1, threeColor, refinedColor0, refinedColor1, refinedIndices);
+                        if(error >= bestError)
+                        {
+                            break;
+                        }
+                        bestError = error;
+                        color0 = refinedColor0;
+                        color1 = refinedColor1;
+                        std::copy(refinedIndices, refinedIndices + 16, indices);
+                    }
+                }
+            }
+
+            // Order endpoints by mode, four color blocks requires color0 > color1 and three color blocks color0 <= color1.
+            if(threeColor)
+            {
+                if(color0 > color1)
+                {
+                    std::swap(color0, color1);
+                    for(auto& index : indices)
+                    {
+                        index = index < 2 ? static_cast<uint8_t>(index ^ 1) : index;
+                    }
+                }
+                for(size_t i = 0; i < 16; i++)
+                {
+                    if(block.mask[i] == 0.0f)
+                    {
+                        indices[i] = 3;
+                    }
+                }
+            }
+            else if(color0 < color1)
+            {
+                std::swap(color0, color1);
+                for(auto& index : indices)
+                {
+                    index = static_cast<uint8_t>(index ^ 1);
+                }
+            }
+            else if(color0 == color1)
+            {
+                std::fill(std::begin(indices), std::end(indices), uint8_t{ 0 });
+            }
+
+            uint32_t packedIndices = 0;
+            for(size_t i = 0; i < 16; i++)
+            {
+                packedIndices |= static_cast<uint32_t>(indices[i]) << (i * 2);
+            }
+
+            output[0] = static_cast<uint8_t>(color0);
+            output[1] = static_cast<uint8_t>(color0 >> 8);
+            output[2] = static_cast<uint8_t>(color1);
+            output[3] = static_cast<uint8_t>(color1 >> 8);
+            for(size_t i = 0; i < 4; i++)
+            {
+                output[4 + i] = static_cast<uint8_t>(packedIndices >> (i * 8));
+            }
+        }
+
+        void DecodeBc1Block(const uint8_t* input, const bool allowThreeColor, uint8_t* output, const size_t outputRowSize)
+        {
+            const auto color0 = static_cast<uint16_t>(input[0] | (input[1] << 8));
+            const auto color1 = static_cast<uint16_t>(input[2] | (input[3] << 8));
+            const auto palette = CreateBc1Palette(color0, color1, allowThreeColor && color0 <= color1);
+
+            for(size_t i = 0; i < 16; i++)
+            {
+                const auto index = (input[4 + i / 4] >> ((i % 4) * 2)) & 3;
+                std::memcpy(output + (i / 4) * outputRowSize + (i % 4) * 4, palette[index].data(), 4);
+            }
+        }
+
+
+        // BC4 single channel blocks.
+        std::array<uint8_t, 8> CreateBc4Palette(const uint8_t value0, const uint8_t value1)
+        {
+            std::array<uint8_t, 8> palette = { value0, value1 };
+            const auto a = static_cast<uint32_t>(value0);
+            const auto b = static_cast<uint32_t>(value1);
+            if(value0 > value1)
+            {
+                for(uint32_t i = 1; i < 7; i++)
+                {
+                    palette[i + 1] = static_cast<uint8_t>(((7 - i) * a + i * b + 3) / 7);
+                }
+            }
+            else
+            {
+                for(uint32_t i = 1; i < 5; i++)
+                {
+                    palette[i + 1] = static_cast<uint8_t>(((5 - i) * a + i * b + 2) / 5);
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+            return palette;
+        }
+
+        float EvaluateBc4Endpoints(const float* values, const uint8_t value0, const uint8_t value1, uint8_t* indices)
+        {
+            const auto palette = CreateBc4Palette(value0, value1);
+            float totalError = 0.0f;
+            for(size_t i = 0; i < 16; i++)
+            {
+                float bestError = std::numeric_limits<float>::max();
+                for(size_t entry = 0; entry < 8; entry++)
+                {
+                    const auto difference = values[i] - static_cast<float>(palette[entry]);
+                    if(difference * difference < bestError)
+                    {
+                        bestError = difference * difference;
+                        indices[i] = static_cast<uint8_t>(entry);
+                    }
+                }
+                totalError += bestError;
+            }
+            return totalError;
+        }
+
+        void EncodeBc4Block(const Block& block, const size_t channel, const BlockCompressor::Quality quality, uint8_t* output)
+        {
+            const auto* values = block.channels[channel];
+            const auto minimum = *std::min_element(values, values + 16);
+            const auto maximum = *std::max_element(values, values + 16);
+
+            auto value0 = static_cast<uint8_t>(maximum);
+            auto value1 = static_cast<uint8_t>(minimum);
+            uint8_t indices[16] = {};
+            float bestError = value0 == value1 ? 0.0f : EvaluateBc4Endpoints(values, value0, value1, indices);
+
+            if(quality == BlockCompressor::Quality::High && bestError > 0.0f)
+            {
+                auto tryEndpoints = [&](const uint8_t candidate0, const uint8_t candidate1)
+                {
+                    uint8_t candidateIndices[16];
+                    const auto error = EvaluateBc4Endpoints(values, candidate0, candidate1, candidateIndices);
+                    if(error < bestError)
+                    {
+                        bestError = error;
+                        value0 = candidate0;
+                        value1 = candidate1;
+                        std::copy(candidateIndices, candidateIndices + 16, indices);
+                    }
+                };
+
+                // Least squares fit of eight value palette.
+                static const float weights[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+                Block singleChannel;
+                std::copy(values, values + 16, singleChannel.channels[0]);
+                std::fill(std::begin(singleChannel.mask), std::end(singleChannel.mask), 1.0f);
+                float endpoint0 = 0.0f;
+                float endpoint1 = 0.0f;
+                if(RefineEndpoints(singleChannel, 1, indices, weights, &endpoint0, &endpoint1))
+                {
+                    const auto candidate0 = static_cast<uint8_t>(std::lround(endpoint0));
+                    const auto candidate1 = static_cast<uint8_t>(std::lround(endpoint1));
+                    if(candidate0 > candidate1)
+                    {
+                        tryEndpoints(candidate0, candidate1);
+                    }
+                }
+
+                // Six value palette with exact 0 and 255, spanning the remaining values.
+                float innerMinimum = 255.0f;
+                float innerMaximum = 0.0f;
+                for(size_t i = 0; i < 16; i++)
+                {
+                    if(values[i] > 0.0f && values[i] < 255.0f)
+                    {
+                        innerMinimum = std::min(innerMinimum, values[i]);
+                        innerMaximum = std::max(innerMaximum, values[i]);
+                    }
+                }
+                if(innerMinimum <= innerMaximum)
+                {
+                    tryEndpoints(static_cast<uint8_t>(innerMinimum), static_cast<uint8_t>(innerMaximum));
+                }
+            }
+
+            output[0] = value0;
+            output[1] = value1;
+            uint64_t packedIndices = 0;
+            for(size_t i = 0; i < 16; i++)
+            {
+                packedIndices |= static_cast<uint64_t>(indices[i]) << (i * 3);
+            }
+            for(size_t i = 0; i < 6; i++)
+            {
+                output[2 + i] = static_cast<uint8_t>(packedIndices >> (i * 8));
+            }
+        }
+
+        void DecodeBc4Block(const uint8_t* input, uint8_t* output, const size_t outputRowSize)
+        {
+            const auto palette = CreateBc4Palette(input[0], input[1]);
+            uint64_t packedIndices = 0;
+            for(size_t i = 0; i < 6; i++)
+            {
+                packedIndices |= static_cast<uint64_t>(input[2 + i]) << (i * 8);
+            }
+
+            for(size_t i = 0; i < 16; i++)
+            {
+                output[(i / 4) * outputRowSize + (i % 4) * 4] = palette[(packedIndices >> (i * 3)) & 7];
+            }
+        }
+
+
+        // BC7 mode 6 blocks.
+        constexpr uint32_t Bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        uint8_t InterpolateBc7(const uint32_t value0, const uint32_t value1, const uint32_t weight)
+        {
+            return static_cast<uint8_t>(((64 - weight) * value0 + weight * value1 + 32) >> 6);
+        }
+
+        class BitWriter
+        {
+
+        public:
+
+            explicit BitWriter(uint8_t* data) :
+                m_data(data),
+                m_position(0)
+            {
+                std::memset(m_data, 0, 16);
+            }
+
+            void Write(const uint32_t value, const size_t bitCount)
+            {
+                for(size_t i = 0; i < bitCount; i++, m_position++)
+                {
+                    m_data[m_position / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (m_position % 8));
+                }
+            }
+
+        private:
+
+            uint8_t* m_data;
+            size_t m_position;
+
+        };
+
+        class BitReader
+        {
+
+        public:
+
+            explicit BitReader(const uint8_t* data) :
+                m_data(data),
+                m_position(0)
+            {}
+
+            uint32_t Read(const size_t bitCount)
+            {
+                uint32_t value = 0;
+                for(size_t i = 0; i < bitCount; i++, m_position++)
+                {
+                    value |= static_cast<uint32_t>((m_data[m_position / 8] >> (m_position % 8)) & 1) << i;
+                }
+                return value;
+            }
+
+        private:
+
+            const uint8_t* m_data;
+            size_t m_position;
+
+        };
+
+        struct Bc7Endpoints
+        {
+            uint8_t values[2][4]; ///< 7-bit values of each endpoint.
+            uint8_t pBits[2];
+        };
+
+        float EvaluateBc7Endpoints(
+            const Block& block,
+            const float* endpoint0,
+            const float* endpoint1,
+            Bc7Endpoints& endpoints,
+            uint8_t* indices)
+        {
+            float bestError = std::numeric_limits<float>::max();
+
+            // Try all combinations of p-bits, shared by all channels of an endpoint.
+            for(uint8_t pBits = 0; pBits < 4; pBits++)
+            {
+                Bc7Endpoints candidate;
+                candidate.pBits[0] = static_cast<uint8_t>(pBits & 1);
+                candidate.pBits[1] = static_cast<uint8_t>(pBits >> 1);
+
+                uint32_t expanded[2][4];
+                for(size_t channel = 0; channel < 4; channel++)
+                {
+                    const float* sources[2] = { endpoint0, endpoint1 };
+                    for(size_t endpoint = 0; endpoint < 2; endpoint++)
+                    {
+                        const auto value = std::lround((sources[endpoint][channel] - static_cast<float>(candidate.pBits[endpoint])) * 0.5f);
+                        candidate.values[endpoint][channel] = static_cast<uint8_t>(std::clamp<long>(value, 0, 127));
+                        expanded[endpoint][channel] = (static_cast<uint32_t>(candidate.values[endpoint][channel]) << 1) | candidate.pBits[endpoint];
+                    }
+                }
+
+                float palette[16][4];
+                for(size_t entry = 0; entry < 16; entry++)
+                {
+                    for(size_t channel = 0; channel < 4; channel++)
+                    {
+                        palette[entry][channel] = static_cast<float>(InterpolateBc7(expanded[0][channel], expanded[1][channel], Bc7Weights[entry]));
+                    }
+                }
+
+                uint8_t candidateIndices[16];
+                const auto error = SelectIndices(block, 4, palette, 16, candidateIndices);
+                if(error < bestError)
+                {
+                    bestError = error;
+                    endpoints = candidate;
+                    std::copy(candidateIndices, candidateIndices + 16, indices);
+                }
+            }
+
+            return bestError;
+        }
+
+        void EncodeBc7Block(const Block& block, const BlockCompressor::Quality quality, uint8_t* output)
+        {
+            float endpoint0[4];
+            float endpoint1[4];
+            if(quality == BlockCompressor::Quality::Fast)
+            {
+                CalculateBoundingBoxEndpoints(block, 4, endpoint0, endpoint1);
+            }
+            else
+            {
+                CalculatePrincipalAxisEndpoints(block, 4, endpoint0, endpoint1);
+            }
+
+            Bc7Endpoints endpoints;
+            uint8_t indices[16];
+            float bestError = EvaluateBc7Endpoints(block, endpoint0, endpoint1, endpoints, indices);
+
+            if(quality == BlockCompressor::Quality::High)
+            {
+                static const auto weights = []()
+                {
+                    std::array<float, 16> result;
+                    for(size_t i = 0; i < 16; i++)
+                    {
+                        result[i] = static_cast<float>(Bc7Weights[i]) / 64.0f;
+                    }
+                    return result;
+                }();
+
+                for(size_t iteration = 0; iteration < 2 && bestError > 0.0f; iteration++)
+                {
+                    if(!RefineEndpoints(block, 4, indices, weights.data(), endpoint0, endpoint1))
+                    {
+                        break;
+                    }
+
+                    Bc7Endpoints refinedEndpoints;
+                    uint8_t refinedIndices[16];
+                    const auto error = EvaluateBc7Endpoints(block, endpoint0, endpoint1, refinedEndpoints, refinedIndices);
+                    if(error >= bestError)
+                    {
+                        break;
+                    }
+                    bestError = error;
+                    endpoints = refinedEndpoints;
+                    std::copy(refinedIndices, refinedIndices + 16, indices);
+                }
+            }
+
+            // The most significant index bit of the first pixel is implicitly zero.
+            if(indices[0] >= 8)
+            {
+                std::swap(endpoints.values[0], endpoints.values[1]);
+                std::swap(endpoints.pBits[0], endpoints.pBits[1]);
+                for(auto& index : indices)
+                {
+                    index = static_cast<uint8_t>(15 - index);
+                }
+            }
+
+            BitWriter writer(output);
+            writer.Write(1 << 6, 7);
+            for(size_t channel = 0; channel < 4; channel++)
+            {
+                writer.Write(endpoints.values[0][channel], 7);
+                writer.Write(endpoints.values[1][channel], 7);
+            }
+            writer.Write(endpoints.pBits[0], 1);
+            writer.Write(endpoints.pBits[1], 1);
+            writer.Write(indices[0], 3);
+            for(size_t i = 1; i < 16; i++)
+            {
+                writer.Write(indices[i], 4);
+            }
+        }
+
+        bool DecodeBc7Block(const uint8_t* input, uint8_t* output, const size_t outputRowSize)
+        {
+            if((input[0] & 0x7F) != (1 << 6))
+            {
+                return false;
+            }
+
+            BitReader reader(input);
+            reader.Read(7);
+
+            uint32_t values[2][4];
+            for(size_t channel = 0; channel < 4; channel++)
+            {
+                values[0][channel] = reader.Read(7) << 1;
+                values[1][channel] = reader.Read(7) << 1;
+            }
+            const auto pBit0 = reader.Read(1);
+            const auto pBit1 = reader.Read(1);
+            for(size_t channel = 0; channel < 4; channel++)
+            {
+                values[0][channel] |= pBit0;
+                values[1][channel] |= pBit1;
+            }
+
+            for(size_t i = 0; i < 16; i++)
+            {
+                const auto index = reader.Read(i == 0 ? 3 : 4);
+                auto* pixel = output + (i / 4) * outputRowSize + (i % 4) * 4;
+                for(size_t channel = 0; channel < 4; channel++)
+                {
+                    pixel[channel] = InterpolateBc7(values[0][channel], values[1][channel], Bc7Weights[index]);
+                }
+            }
+            return true;
+        }
+
+
+        void EncodeBlock(const Block& block, const ImageFormat format, const BlockCompressor::Quality quality, uint8_t* output)
+        {
+            switch(format)
+            {
+                case ImageFormat::UBc1Rgba:
+                case ImageFormat::SrgbBc1Rgba:
+                    EncodeBc1Block(block, quality, true, output);
+                    break;
+                case ImageFormat::UBc3Rgba:
+                case ImageFormat::SrgbBc3Rgba:
+                    EncodeBc4Block(block, 3, quality, output);
+                    EncodeBc1Block(block, quality, false, output + 8);
+                    break;
+                case ImageFormat::UBc4Red:
+                    EncodeBc4Block(block, 0, quality, output);
+                    break;
+                case ImageFormat::UBc5RedGreen:
+                    EncodeBc4Block(block, 0, quality, output);
+                    EncodeBc4Block(block, 1, quality, output + 8);
+                    break;
+                case ImageFormat::UBc7Rgba:
+                case ImageFormat::SrgbBc7Rgba:
+                    EncodeBc7Block(block, quality, output);
+                    break;
+                default: break;
+            }
+        }
+
+        bool DecodeBlock(const uint8_t* input, const ImageFormat format, uint8_t* output, const size_t outputRowSize)
+        {
+            switch(format)
+            {
+                case ImageFormat::UBc1Rgba:
+                case ImageFormat::SrgbBc1Rgba:
+                    DecodeBc1Block(input, true, output, outputRowSize);
+                    return true;
+                case ImageFormat::UBc3Rgba:
+                case ImageFormat::SrgbBc3Rgba:
+                    DecodeBc1Block(input + 8, false, output, outputRowSize);
+                    DecodeBc4Block(input, output + 3, outputRowSize);
+                    return true;
+                case ImageFormat::UBc4Red:
+                case ImageFormat::UBc5RedGreen:
+                    for(size_t i = 0; i < 16; i++)
+                    {
+                        auto* pixel = output + (i / 4) * outputRowSize + (i % 4) * 4;
+                        pixel[0] = pixel[1] = pixel[2] = 0;
+                        pixel[3] = 255;
+                    }
+                    DecodeBc4Block(input, output, outputRowSize);
+                    if(format == ImageFormat::UBc5RedGreen)
+                    {
+                        DecodeBc4Block(input + 8, output + 1, outputRowSize);
+                    }
+                    return true;
+                case ImageFormat::UBc7Rgba:
+                case ImageFormat::SrgbBc7Rgba:
+                    return DecodeBc7Block(input, output, outputRowSize);
+                default: break;
+            }
+            return false;
+        }
+
+        template<typename TFunction>
+        void ForEachBlockRow(ThreadPool* threadPool, const uint32_t blockRowCount, TFunction&& function)
+        {
+            if(threadPool != nullptr && blockRowCount > 1)
+            {
+                threadPool->ParallelFor(ThreadPool::Priority::Normal, blockRowCount, [&](const size_t blockRow)
+                {
+                    function(static_cast<uint32_t>(blockRow));
+                });
+            }
+            else
+            {
+                for(uint32_t blockRow = 0; blockRow < blockRowCount; blockRow++)
+                {
+                    function(blockRow);
+                }
+            }
+        }
+
+    }
+
+
+    // Block compressor implementations.
+    bool BlockCompressor::IsFormatSupported(const ImageFormat sourceFormat, const ImageFormat compressedFormat)
+    {
+        return GetSourceLayout(sourceFormat).has_value() && IsBlockCompressedImageFormat(compressedFormat);
+    }
+
+    std::optional<std::vector<uint8_t>> BlockCompressor::Compress(
+        const uint8_t* pixels,
+        const Vector2ui32& dimensions,
+        const ImageFormat sourceFormat,
+        const ImageFormat compressedFormat,
+        const Quality quality,
+        ThreadPool* threadPool)
+    {
+        const auto layout = GetSourceLayout(sourceFormat);
+        if(!layout || !IsBlockCompressedImageFormat(compressedFormat) || dimensions.x == 0 || dimensions.y == 0)
+        {
+            return std::nullopt;
+        }
+
+        const auto blockSize = GetImageFormatBlockSize(compressedFormat);
+        const auto blockCountX = (dimensions.x + 3) / 4;
+        const auto blockCountY = (dimensions.y + 3) / 4;
+        std::vector<uint8_t> blocks(CalculateImageDataSize(compressedFormat, dimensions.x, dimensions.y));
+
+        ForEachBlockRow(threadPool, blockCountY, [&](const uint32_t blockY)
+        {
+            Block block;
+            auto* output = blocks.data() + static_cast<size_t>(blockY) * blockCountX * blockSize;
+            for(uint32_t blockX = 0; blockX < blockCountX; blockX++, output += blockSize)
+            {
+                LoadBlock(pixels, dimensions, *layout, blockX, blockY, block);
+                EncodeBlock(block, compressedFormat, quality, output);
+            }
+        });
+
+        return blocks;
+    }
+
+    std::optional<MipChain> BlockCompressor::Compress(
+        const MipChain& mipChain,
+        const ImageFormat compressedFormat,
+        const Quality quality,
+        ThreadPool* threadPool)
+    {
+        if(!IsFormatSupported(mipChain.GetFormat(), compressedFormat))
+        {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> data;
+        std::vector<size_t> levelOffsets = { 0 };
+        for(uint32_t level = 0; level < mipChain.GetLevelCount(); level++)
+        {
+            auto blocks = Compress(
+                mipChain.GetLevelData(level),
+                mipChain.GetLevelDimensions(level),
+                mipChain.GetFormat(),
+                compressedFormat,
+                quality,
+                threadPool);
+            if(!blocks)
+            {
+                return std::nullopt;
+            }
+
+            data.insert(data.end(), blocks->begin(), blocks->end());
+            levelOffsets.push_back(data.size());
+        }
+
+        return MipChain{ std::move(data), std::move(levelOffsets), mipChain.GetDimensions(), compressedFormat };
+    }
+
+    std::optional<std::vector<uint8_t>> BlockCompressor::Decompress(
+        const uint8_t* blocks,
+        const Vector2ui32& dimensions,
+        const ImageFormat compressedFormat)
+    {
+        if(!IsBlockCompressedImageFormat(compressedFormat))
+        {
+            return std::nullopt;
+        }
+
+        const auto blockSize = GetImageFormatBlockSize(compressedFormat);
+        const auto blockCountX = (dimensions.x + 3) / 4;
+        const auto blockCountY = (dimensions.y + 3) / 4;
+        const size_t rowSize = static_cast<size_t>(dimensions.x) * 4;
+
+        std::vector<uint8_t> pixels(rowSize * dimensions.y);
+        uint8_t blockPixels[4 * 16];
+        for(uint32_t blockY = 0; blockY < blockCountY; blockY++)
+        {
+            for(uint32_t blockX = 0; blockX < blockCountX; blockX++, blocks += blockSize)
+            {
+                if(!DecodeBlock(blocks, compressedFormat, blockPixels, 16))
+                {
+                    return std::nullopt;
+                }
+
+                const auto width = std::min<uint32_t>(4, dimensions.x - blockX * 4);
+                const auto height = std::min<uint32_t>(4, dimensions.y - blockY * 4);
+                for(uint32_t y = 0; y < height; y++)
+                {
+                    std::memcpy(
+                        pixels.data() + (static_cast<size_t>(blockY) * 4 + y) * rowSize + static_cast<size_t>(blockX) * 16,
+                        blockPixels + y * 16,
+                        static_cast<size_t>(width) * 4);
+                }
+            }
+        }
+
+        return pixels;
+    }
+
+}
@@ -24,12 +24,417 @@
 */
 
 #include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
 
 namespace Molten::Formats::Bmp
 {
 
- 
-    // Header implementations
+    // Global implementations.
+    namespace
+    {
+
+        constexpr size_t CoreHeaderSize = 12;
+        constexpr size_t InfoHeaderSize = 40;
+        constexpr size_t V4InfoHeaderSize = 108;
+        constexpr int32_t DefaultPixelsPerMeter = 2835; ///< 72 DPI.
+
+        uint16_t ReadUint16(const uint8_t* data)
+        {
+            return static_cast<uint16_t>(data[0] | (data[1] << 8));
+        }
+
+        uint32_t ReadUint32(const uint8_t* data)
+        {
+            return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+                (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+        }
+
+        int32_t ReadInt32(const uint8_t* data)
+        {
+            return static_cast<int32_t>(ReadUint32(data));
+        }
+
+        void WriteUint16(uint8_t* data, const uint16_t value)
+        {
+            data[0] = static_cast<uint8_t>(value);
+            data[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        void WriteUint32(uint8_t* data, const uint32_t value)
+        {
+            data[0] = static_cast<uint8_t>(value);
+            data[1] = static_cast<uint8_t>(value >> 8);
+            data[2] = static_cast<uint8_t>(value >> 16);
+            data[3] = static_cast<uint8_t>(value >> 24);
+        }
+
+        /** Bit field channel, extracting and scaling a masked channel to 8 bits. */
+        struct BitfieldChannel
+        {
+            BitfieldChannel(const uint32_t mask, const uint8_t defaultValue) :
+                mask(mask),
+                shift(0),
+                maxValue(0),
+                defaultValue(defaultValue)
+            {
+                if(mask == 0)
+                {
+                    return;
+                }
+
+                while(((mask >> shift) & 1) == 0)
+                {
+                    ++shift;
+                }
+                maxValue = mask >> shift;
+            }
+
+            uint8_t Extract(const uint32_t pixel) const
+            {
+                if(maxValue == 0)
+                {
+                    return defaultValue;
+                }
+
+                const auto value = (pixel & mask) >> shift;
+                return static_cast<uint8_t>((static_cast<uint64_t>(value) * 255 + maxValue / 2) / maxValue);
+            }
+
+            uint32_t mask;
+            uint32_t shift;
+            uint32_t maxValue;
+            uint8_t defaultValue;
+        };
+
+        uint32_t GetEffectiveRedMask(const InfoHeader& infoHeader)
+        {
+            if(infoHeader.GetCompression() != Compression::Rgb)
+            {
+                return infoHeader.GetRedMask();
+            }
+            return infoHeader.GetBitsPerPixel() == 16 ? 0x7C00 : 0x00FF0000;
+        }
+
+        uint32_t GetEffectiveGreenMask(const InfoHeader& infoHeader)
+        {
+            if(infoHeader.GetCompression() != Compression::Rgb)
+            {
+                return infoHeader.GetGreenMask();
+            }
+            return infoHeader.GetBitsPerPixel() == 16 ? 0x03E0 : 0x0000FF00;
+        }
+
+        uint32_t GetEffectiveBlueMask(const InfoHeader& infoHeader)
+        {
+            if(infoHeader.GetCompression() != Compression::Rgb)
+            {
+                return infoHeader.GetBlueMask();
+            }
+            return infoHeader.GetBitsPerPixel() == 16 ? 0x001F : 0x000000FF;
+        }
+
+        uint32_t GetEffectiveAlphaMask(const InfoHeader& infoHeader)
+        {
+            return infoHeader.GetCompression() != Compression::Rgb ? infoHeader.GetAlphaMask() : 0;
+        }
+
+        ResultCode ParseHeaders(
+            const uint8_t* data,
+            const size_t size,
+            Header& header,
+            InfoHeader& infoHeader,
+            ColorTable& colorTable,
+            const uint8_t*& pixelData,
+            size_t& pixelDataSize)
+        {
+            if(size < Header::Size + 4)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+
+            header.GetSignature() = ReadUint16(data);
+            header.GetFileSize() = ReadUint32(data + 2);
+            header.GetReserved() = ReadUint32(data + 6);
+            header.GetDataOffset() = ReadUint32(data + 10);
+            if(header.GetSignature() != Header::Signature)
+            {
+                return ResultCode::InvalidSignature;
+            }
+
+            const auto* info = data + Header::Size;
+            const auto headerSize = ReadUint32(info);
+            if(headerSize != CoreHeaderSize && headerSize < InfoHeaderSize)
+            {
+                return ResultCode::InvalidHeader;
+            }
+            if(size - Header::Size < headerSize)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+
+            infoHeader = InfoHeader{};
+            infoHeader.GetHeaderSize() = headerSize;
+
+            size_t colorTableOffset = Header::Size + headerSize;
+            size_t colorEntrySize = 4;
+
+            if(headerSize == CoreHeaderSize)
+            {
+                infoHeader.GetWidth() = ReadUint16(info + 4);
+                infoHeader.GetHeight() = ReadUint16(info + 6);
+                infoHeader.GetPlanes() = ReadUint16(info + 8);
+                infoHeader.GetBitsPerPixel() = ReadUint16(info + 10);
+                colorEntrySize = 3;
+            }
+            else
+            {
+                infoHeader.GetWidth() = ReadInt32(info + 4);
+                infoHeader.GetHeight() = ReadInt32(info + 8);
+                infoHeader.GetPlanes() = ReadUint16(info + 12);
+                infoHeader.GetBitsPerPixel() = ReadUint16(info + 14);
+                infoHeader.GetCompression() = static_cast<Compression>(ReadUint32(info + 16));
+                infoHeader.GetImageSize() = ReadUint32(info + 20);
+                infoHeader.GetXPixelsPerMeter() = ReadInt32(info + 24);
+                infoHeader.GetYPixelsPerMeter() = ReadInt32(info + 28);
+                infoHeader.GetColorsUsed() = ReadUint32(info + 32);
+                infoHeader.GetColorsImportant() = ReadUint32(info + 36);
+
+                const auto compression = infoHeader.GetCompression();
+                const bool hasBitfields = compression == Compression::Bitfields || compression == Compression::AlphaBitfields;
+
+                // Masks of plain info headers are stored right after the header, if present.
+                const auto* masks = info + 40;
+                size_t maskSpace = headerSize - InfoHeaderSize;
+                if(headerSize == InfoHeaderSize && hasBitfields)
+                {
+                    maskSpace = compression == Compression::AlphaBitfields ? 16 : 12;
+                    if(size < colorTableOffset + maskSpace)
+                    {
+                        return ResultCode::UnexpectedEndOfFile;
+                    }
+                    colorTableOffset += maskSpace;
+                }
+
+                if(maskSpace >= 12)
+                {
+                    infoHeader.GetRedMask() = ReadUint32(masks);
+                    infoHeader.GetGreenMask() = ReadUint32(masks + 4);
+                    infoHeader.GetBlueMask() = ReadUint32(masks + 8);
+                }
+                if(maskSpace >= 16)
+                {
+                    infoHeader.GetAlphaMask() = ReadUint32(masks + 12);
+                }
+            }
+
+            const auto width = infoHeader.GetWidth();
+            const auto height = infoHeader.GetHeight();
+            const auto bitsPerPixel = infoHeader.GetBitsPerPixel();
+            if(width <= 0 || height == 0 || height == std::numeric_limits<int32_t>::min() || infoHeader.GetPlanes() != 1)
+            {
+                return ResultCode::InvalidHeader;
+            }
+
+            switch(infoHeader.GetCompression())
+            {
+                case Compression::Rgb:
+                {
+                    if(bitsPerPixel != 1 && bitsPerPixel != 4 && bitsPerPixel != 8 && 
+                       bitsPerPixel != 16 && bitsPerPixel != 24 && bitsPerPixel != 32)
+                    {
+                        return ResultCode::UnsupportedFormat;
+                    }
+                } break;
+                case Compression::Bitfields:
+                case Compression::AlphaBitfields:
+                {
+                    if(bitsPerPixel != 16 && bitsPerPixel != 32)
+                    {
+                        return ResultCode::UnsupportedFormat;
+                    }
+                } break;
+                default: return ResultCode::UnsupportedFormat;
+            }
+
+            colorTable.GetColors().clear();
+            if(bitsPerPixel <= 8)
+            {
+                const size_t maxColorCount = size_t{ 1 } << bitsPerPixel;
+                const size_t colorsUsed = infoHeader.GetColorsUsed();
+                const size_t colorCount = colorsUsed == 0 ? maxColorCount : std::min(colorsUsed, maxColorCount);
+                if(size < colorTableOffset || (size - colorTableOffset) / colorEntrySize < colorCount)
+                {
+                    return ResultCode::UnexpectedEndOfFile;
+                }
+
+                colorTable.GetColors().resize(colorCount);
+                for(size_t i = 0; i < colorCount; i++)
+                {
+                    const auto* entry = data + colorTableOffset + i * colorEntrySize;
+                    colorTable.GetColors()[i] = static_cast<uint32_t>(entry[0]) | 
+                        (static_cast<uint32_t>(entry[1]) << 8) | (static_cast<uint32_t>(entry[2]) << 16);
+                }
+            }
+
+            const auto dataOffset = static_cast<size_t>(header.GetDataOffset());
+            const auto requiredSize = infoHeader.GetRowStride() * static_cast<size_t>(height < 0 ? -height : height);
+            if(dataOffset > size || size - dataOffset < requiredSize)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+
+            pixelData = data + dataOffset;
+            pixelDataSize = requiredSize;
+            return ResultCode::Successful;
+        }
+
+        ResultCode DecodePixels(
+            const InfoHeader& infoHeader,
+            const ColorTable& colorTable,
+            const uint8_t* pixelData,
+            const size_t pixelDataSize,
+            const ImageFormat format,
+            uint8_t* destination,
+            const size_t destinationSize)
+        {
+            const auto optionalLayout = PixelConversion::GetLayout(format);
+            if(!optionalLayout)
+            {
+                return ResultCode::UnsupportedFormat;
+            }
+            const auto& layout = *optionalLayout;
+
+            const auto width = static_cast<size_t>(std::max(infoHeader.GetWidth(), int32_t{ 0 }));
+            const auto height = static_cast<size_t>(infoHeader.IsTopDown() ? -infoHeader.GetHeight() : infoHeader.GetHeight());
+            const auto stride = infoHeader.GetRowStride();
+            if(width == 0 || height == 0 || pixelDataSize < stride * height)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+            if(destination == nullptr || destinationSize < width * height * layout.channelCount)
+            {
+                return ResultCode::BufferTooSmall;
+            }
+
+            const auto destinationStride = width * layout.channelCount;
+            auto getSourceRow = [&](const size_t y)
+            {
+                return pixelData + (infoHeader.IsTopDown() ? y : height - 1 - y) * stride;
+            };
+
+            const auto bitsPerPixel = infoHeader.GetBitsPerPixel();
+            if(bitsPerPixel <= 8)
+            {
+                // Palette entries are arranged in destination order up front, leaving a single copy per pixel.
+                std::array<std::array<uint8_t, 4>, 256> palette = {};
+                for(auto& entry : palette)
+                {
+                    PixelConversion::StorePixel(entry.data(), { 4, layout.bgr }, 0, 0, 0, 255);
+                }
+                const auto& colors = colorTable.GetColors();
+                for(size_t i = 0; i < colors.size() && i < palette.size(); i++)
+                {
+                    const auto color = colors[i];
+                    PixelConversion::StorePixel(palette[i].data(), { 4, layout.bgr },
+                        static_cast<uint8_t>(color >> 16), static_cast<uint8_t>(color >> 8), static_cast<uint8_t>(color), 255);
+                }
+
+                const auto pixelsPerByte = static_cast<size_t>(8 / bitsPerPixel);
+                const auto indexMask = static_cast<uint8_t>((1 << bitsPerPixel) - 1);
+                for(size_t y = 0; y < height; y++)
+                {
+                    const auto* source = getSourceRow(y);
+                    auto* dst = destination + y * destinationStride;
+                    for(size_t x = 0; x < width; x++)
+                    {
+                        const auto byte = source[x / pixelsPerByte];
+                        const auto shift = static_cast<uint32_t>(8 - bitsPerPixel * (1 + x % pixelsPerByte));
+                        const auto index = static_cast<uint8_t>((byte >> shift) & indexMask);
+                        std::memcpy(dst + x * layout.channelCount, palette[index].data(), layout.channelCount);
+                    }
+                }
+                return ResultCode::Successful;
+            }
+
+            if(bitsPerPixel == 24)
+            {
+                for(size_t y = 0; y < height; y++)
+                {
+                    PixelConversion::ConvertRow(getSourceRow(y), 3, destination + y * destinationStride, layout.channelCount, !layout.bgr, true, width);
+                }
+                return ResultCode::Successful;
+            }
+
+            const auto redMask = GetEffectiveRedMask(infoHeader);
+            const auto greenMask = GetEffectiveGreenMask(infoHeader);
+            const auto blueMask = GetEffectiveBlueMask(infoHeader);
+            const auto alphaMask = GetEffectiveAlphaMask(infoHeader);
+
+            if(bitsPerPixel == 32 && redMask == 0x00FF0000 && greenMask == 0x0000FF00 && blueMask == 0x000000FF &&
+               (alphaMask == 0 || alphaMask == 0xFF000000))
+            {
+                for(size_t y = 0; y < height; y++)
+                {
+                    PixelConversion::ConvertRow(getSourceRow(y), 4, destination + y * destinationStride, layout.channelCount, !layout.bgr, alphaMask == 0, width);
+                }
+                return ResultCode::Successful;
+            }
+
+            const BitfieldChannel red(redMask, 0);
+            const BitfieldChannel green(greenMask, 0);
+            const BitfieldChannel blue(blueMask, 0);
+            const BitfieldChannel alpha(alphaMask, 255);
+            const size_t bytesPerPixel = bitsPerPixel / 8;
+            for(size_t y = 0; y < height; y++)
+            {
+                const auto* source = getSourceRow(y);
+                auto* dst = destination + y * destinationStride;
+                for(size_t x = 0; x < width; x++)
+                {
+                    const auto* src = source + x * bytesPerPixel;
+                    const auto pixel = bytesPerPixel == 2 ? static_cast<uint32_t>(ReadUint16(src)) : ReadUint32(src);
+                    PixelConversion::StorePixel(dst + x * layout.channelCount, layout, red.Extract(pixel), green.Extract(pixel), blue.Extract(pixel), alpha.Extract(pixel));
+                }
+            }
+            return ResultCode::Successful;
+        }
+
+    }
+
+    bool IsDecodeFormatSupported(const ImageFormat format)
+    {
+        return PixelConversion::GetLayout(format).has_value();
+    }
+
+    bool IsEncodeFormatSupported(const ImageFormat format)
+    {
+        return format == ImageFormat::URed8 || IsDecodeFormatSupported(format);
+    }
+
+    size_t GetDecodedSize(const uint32_t width, const uint32_t height, const ImageFormat format)
+    {
+        const auto layout = PixelConversion::GetLayout(format);
+        if(!layout)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(width) * static_cast<size_t>(height) * layout->channelCount;
+    }
+
+    ResultCode Decode(const File& file, const ImageFormat format, uint8_t* destination, const size_t destinationSize)
+    {
+        const auto& data = file.GetData();
+        return DecodePixels(file.GetInfoHeader(), file.GetColorTable(), data.data(), data.size(), format, destination, destinationSize);
+    }
+
+
+    // Header implementations.
     Header::Header() :
         m_signature(0),
         m_fileSize(0),
@@ -119,15 +524,185 @@ namespace Molten::Formats::Bmp
     }
 
 
-    // Header implementations.
+    // Info header implementations.
+    InfoHeader::InfoHeader() :
+        m_headerSize(0),
+        m_width(0),
+        m_height(0),
+        m_planes(1),
+        m_bitsPerPixel(0),
+        m_compression(Compression::Rgb),
+        m_imageSize(0),
+        m_xPixelsPerMeter(0),
+        m_yPixelsPerMeter(0),
+        m_colorsUsed(0),
+        m_colorsImportant(0),
+        m_redMask(0),
+        m_greenMask(0),
+        m_blueMask(0),
+        m_alphaMask(0)
+    {}
 
+    uint32_t& InfoHeader::GetHeaderSize()
+    {
+        return m_headerSize;
+    }
+    uint32_t InfoHeader::GetHeaderSize() const
+    {
+        return m_headerSize;
+    }
 
+    int32_t& InfoHeader::GetWidth()
+    {
+        return m_width;
+    }
+    int32_t InfoHeader::GetWidth() const
+    {
+        return m_width;
+    }
 
-    // Info header implementations.
+    int32_t& InfoHeader::GetHeight()
+    {
+        return m_height;
+    }
+    int32_t InfoHeader::GetHeight() const
+    {
+        return m_height;
+    }
+
+    uint16_t& InfoHeader::GetPlanes()
+    {
+        return m_planes;
+    }
+    uint16_t InfoHeader::GetPlanes() const
+    {
+        return m_planes;
+    }
+
+    uint16_t& InfoHeader::GetBitsPerPixel()
+    {
+        return m_bitsPerPixel;
+    }
+    uint16_t InfoHeader::GetBitsPerPixel() const
+    {
+        return m_bitsPerPixel;
+    }
+
+    Compression& InfoHeader::GetCompression()
+    {
+        return m_compression;
+    }
+    Compression InfoHeader::GetCompression() const
+    {
+        return m_compression;
+    }
+
+    uint32_t& InfoHeader::GetImageSize()
+    {
+        return m_imageSize;
+    }
+    uint32_t InfoHeader::GetImageSize() const
+    {
+        return m_imageSize;
+    }
+
+    int32_t& InfoHeader::GetXPixelsPerMeter()
+    {
+        return m_xPixelsPerMeter;
+    }
+    int32_t InfoHeader::GetXPixelsPerMeter() const
+    {
+        return m_xPixelsPerMeter;
+    }
+
+    int32_t& InfoHeader::GetYPixelsPerMeter()
+    {
+        return m_yPixelsPerMeter;
+    }
+    int32_t InfoHeader::GetYPixelsPerMeter() const
+    {
+        return m_yPixelsPerMeter;
+    }
+
+    uint32_t& InfoHeader::GetColorsUsed()
+    {
+        return m_colorsUsed;
+    }
+    uint32_t InfoHeader::GetColorsUsed() const
+    {
+        return m_colorsUsed;
+    }
+
+    uint32_t& InfoHeader::GetColorsImportant()
+    {
+        return m_colorsImportant;
+    }
+    uint32_t InfoHeader::GetColorsImportant() const
+    {
+        return m_colorsImportant;
+    }
+
+    uint32_t& InfoHeader::GetRedMask()
+    {
+        return m_redMask;
+    }
+    uint32_t InfoHeader::GetRedMask() const
+    {
+        return m_redMask;
+    }
+
+    uint32_t& InfoHeader::GetGreenMask()
+    {
+        return m_greenMask;
+    }
+    uint32_t InfoHeader::GetGreenMask() const
+    {
+        return m_greenMask;
+    }
+
+    uint32_t& InfoHeader::GetBlueMask()
+    {
+        return m_blueMask;
+    }
+    uint32_t InfoHeader::GetBlueMask() const
+    {
+        return m_blueMask;
+    }
+
+    uint32_t& InfoHeader::GetAlphaMask()
+    {
+        return m_alphaMask;
+    }
+    uint32_t InfoHeader::GetAlphaMask() const
+    {
+        return m_alphaMask;
+    }
 
+    bool InfoHeader::IsTopDown() const
+    {
+        return m_height < 0;
+    }
+
+    size_t InfoHeader::GetRowStride() const
+    {
+        const auto width = static_cast<size_t>(std::max(m_width, int32_t{ 0 }));
+        return ((width * m_bitsPerPixel + 31) / 32) * 4;
+    }
 
 
     // Color table implementations.
+    ColorTable::ColorTable() :
+        m_colors{}
+    {}
+
+    ColorTable::Colors& ColorTable::GetColors()
+    {
+        return m_colors;
+    }
+    const ColorTable::Colors& ColorTable::GetColors() const
+    {
+        return m_colors;
+    }
 
 
     // Reader result implementations.
@@ -136,6 +711,11 @@ namespace Molten::Formats::Bmp
         m_resultCode(ResultCode::Successful)
     {}
 
+    ReaderResult::ReaderResult(const ResultCode code) :
+        m_file(),
+        m_resultCode(code)
+    {}
+
     bool ReaderResult::IsSuccessful() const
     {
         return m_resultCode == ResultCode::Successful;
@@ -156,23 +736,262 @@ namespace Molten::Formats::Bmp
     }
 
 
-    // Reader implementations.
-    ReaderResult ReadFromFile(const std::string& /*filename*/)
+    // Decoder implementations.
+    Decoder::Decoder() :
+        m_mappedFile{},
+        m_header{},
+        m_infoHeader{},
+        m_colorTable{},
+        m_pixelData(nullptr),
+        m_pixelDataSize(0)
+    {}
+
+    ResultCode Decoder::Open(const std::filesystem::path& filename)
     {
-        ReaderResult result;
+        Close();
+
+        if(!m_mappedFile.Open(filename))
+        {
+            return ResultCode::CannotOpenFile;
+        }
+
+        const auto result = Open(reinterpret_cast<const uint8_t*>(m_mappedFile.GetData()), m_mappedFile.GetSize());
+        if(result != ResultCode::Successful)
+        {
+            m_mappedFile.Close();
+        }
         return result;
     }
 
-    ReaderResult ReadFromBytes(const std::vector<uint8_t>& /*bytes*/)
+    ResultCode Decoder::Open(const uint8_t* data, const size_t size)
     {
-        ReaderResult result;
+        m_pixelData = nullptr;
+        m_pixelDataSize = 0;
+
+        if(data == nullptr)
+        {
+            return ResultCode::UnexpectedEndOfFile;
+        }
+
+        const uint8_t* pixelData = nullptr;
+        size_t pixelDataSize = 0;
+        const auto result = ParseHeaders(data, size, m_header, m_infoHeader, m_colorTable, pixelData, pixelDataSize);
+        if(result == ResultCode::Successful)
+        {
+            m_pixelData = pixelData;
+            m_pixelDataSize = pixelDataSize;
+        }
         return result;
     }
 
-    ReaderResult ReadFromStream(const std::istream& /*stream*/)
+    void Decoder::Close()
+    {
+        m_mappedFile.Close();
+        m_header = {};
+        m_infoHeader = {};
+        m_colorTable = {};
+        m_pixelData = nullptr;
+        m_pixelDataSize = 0;
+    }
+
+    bool Decoder::IsOpen() const
     {
+        return m_pixelData != nullptr;
+    }
+
+    const Header& Decoder::GetHeader() const
+    {
+        return m_header;
+    }
+
+    const InfoHeader& Decoder::GetInfoHeader() const
+    {
+        return m_infoHeader;
+    }
+
+    const ColorTable& Decoder::GetColorTable() const
+    {
+        return m_colorTable;
+    }
+
+    uint32_t Decoder::GetWidth() const
+    {
+        return IsOpen() ? static_cast<uint32_t>(m_infoHeader.GetWidth()) : 0;
+    }
+
+    uint32_t Decoder::GetHeight() const
+    {
+        if(!IsOpen())
+        {
+            return 0;
+        }
+        const auto height = m_infoHeader.GetHeight();
+        return static_cast<uint32_t>(height < 0 ? -height : height);
+    }
+
+    ResultCode Decoder::Decode(const ImageFormat format, uint8_t* destination, const size_t destinationSize) const
+    {
+        if(!IsOpen())
+        {
+            return ResultCode::UnexpectedEndOfFile;
+        }
+        return DecodePixels(m_infoHeader, m_colorTable, m_pixelData, m_pixelDataSize, format, destination, destinationSize);
+    }
+
+
+    // Reader implementations.
+    ReaderResult ReadFromFile(const std::string& filename)
+    {
+        MemoryMappedFile mappedFile;
+        if(!mappedFile.Open(filename))
+        {
+            return ReaderResult{ ResultCode::CannotOpenFile };
+        }
+
+        return ReadFromBytes(reinterpret_cast<const uint8_t*>(mappedFile.GetData()), mappedFile.GetSize());
+    }
+
+    ReaderResult ReadFromBytes(const std::vector<uint8_t>& bytes)
+    {
+        return ReadFromBytes(bytes.data(), bytes.size());
+    }
+
+    ReaderResult ReadFromBytes(const uint8_t* data, const size_t size)
+    {
+        if(data == nullptr)
+        {
+            return ReaderResult{ ResultCode::UnexpectedEndOfFile };
+        }
+
         ReaderResult result;
+        auto& file = result.GetFile();
+
+        const uint8_t* pixelData = nullptr;
+        size_t pixelDataSize = 0;
+        const auto code = ParseHeaders(data, size, file.GetHeader(), file.GetInfoHeader(), file.GetColorTable(), pixelData, pixelDataSize);
+        if(code != ResultCode::Successful)
+        {
+            return ReaderResult{ code };
+        }
+
+        file.GetData().assign(pixelData, pixelData + pixelDataSize);
         return result;
     }
 
+    ReaderResult ReadFromStream(std::istream& stream)
+    {
+        const Data bytes{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+        return ReadFromBytes(bytes);
+    }
+
+
+    // Writer implementations.
+    Data WriteToBytes(const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format)
+    {
+        if(pixels == nullptr || width == 0 || height == 0 || 
+           width > static_cast<uint32_t>(std::numeric_limits<int32_t>::max()) || height > static_cast<uint32_t>(std::numeric_limits<int32_t>::max()))
+        {
+            return {};
+        }
+
+        const bool grayscale = format == ImageFormat::URed8;
+        const auto optionalLayout = grayscale ? PixelConversion::Layout{ 1, false } : PixelConversion::GetLayout(format);
+        if(!optionalLayout)
+        {
+            return {};
+        }
+        const auto& layout = *optionalLayout;
+
+        const bool hasAlpha = layout.channelCount == 4;
+        const uint16_t bitsPerPixel = grayscale ? 8 : (hasAlpha ? 32 : 24);
+        const size_t infoHeaderSize = hasAlpha ? V4InfoHeaderSize : InfoHeaderSize;
+        const size_t colorTableSize = grayscale ? 256 * 4 : 0;
+        const size_t dataOffset = Header::Size + infoHeaderSize + colorTableSize;
+        const size_t stride = ((static_cast<size_t>(width) * bitsPerPixel + 31) / 32) * 4;
+        const size_t imageSize = stride * height;
+        const size_t fileSize = dataOffset + imageSize;
+        if(fileSize > std::numeric_limits<uint32_t>::max())
+        {
+            return {};
+        }
+
+        Data data(fileSize, 0);
+        auto* bytes = data.data();
+
+        WriteUint16(bytes, Header::Signature);
+        WriteUint32(bytes + 2, static_cast<uint32_t>(fileSize));
+        WriteUint32(bytes + 10, static_cast<uint32_t>(dataOffset));
+
+        auto* info = bytes + Header::Size;
+        WriteUint32(info, static_cast<uint32_t>(infoHeaderSize));
+        WriteUint32(info + 4, width);
+        WriteUint32(info + 8, height);
+        WriteUint16(info + 12, 1);
+        WriteUint16(info + 14, bitsPerPixel);
+        WriteUint32(info + 16, static_cast<uint32_t>(hasAlpha ? Compression::Bitfields : Compression::Rgb));
+        WriteUint32(info + 20, static_cast<uint32_t>(imageSize));
+        WriteUint32(info + 24, static_cast<uint32_t>(DefaultPixelsPerMeter));
+        WriteUint32(info + 28, static_cast<uint32_t>(DefaultPixelsPerMeter));
+        WriteUint32(info + 32, grayscale ? 256 : 0);
+
+        if(hasAlpha)
+        {
+            WriteUint32(info + 40, 0x00FF0000);
+            WriteUint32(info + 44, 0x0000FF00);
+            WriteUint32(info + 48, 0x000000FF);
+            WriteUint32(info + 52, 0xFF000000);
+            WriteUint32(info + 56, 0x73524742); // "sRGB" color space.
+        }
+
+        if(grayscale)
+        {
+            auto* colors = bytes + Header::Size + infoHeaderSize;
+            for(size_t i = 0; i < 256; i++)
+            {
+                colors[i * 4] = colors[i * 4 + 1] = colors[i * 4 + 2] = static_cast<uint8_t>(i);
+            }
+        }
+
+        // Rows are stored bottom-up, the most widely supported row order.
+        const auto sourceStride = static_cast<size_t>(width) * layout.channelCount;
+        for(size_t y = 0; y < height; y++)
+        {
+            const auto* source = pixels + (height - 1 - y) * sourceStride;
+            auto* destination = bytes + dataOffset + y * stride;
+            if(grayscale)
+            {
+                std::memcpy(destination, source, width);
+            }
+            else
+            {
+                PixelConversion::ConvertRow(source, layout.channelCount, destination, layout.channelCount, !layout.bgr, false, width);
+            }
+        }
+
+        return data;
+    }
+
+    bool WriteToStream(std::ostream& stream, const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format)
+    {
+        const auto data = WriteToBytes(pixels, width, height, format);
+        if(data.empty())
+        {
+            return false;
+        }
+
+        stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return stream.good();
+    }
+
+    bool WriteToFile(const std::string& filename, const uint8_t* pixels, const uint32_t width, const uint32_t height, const ImageFormat format)
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+        {
+            return false;
+        }
+
+        return WriteToStream(file, pixels, width, height, format);
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,314 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/FileFormat/Image/ImageCache.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include "Molten/Utility/Hash.hpp"
+
+namespace Molten
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        uint64_t CreateImageKey(const uint64_t contentHash, const ImageFormat format)
+        {
+            return Hash64(&format, sizeof(format), contentHash);
+        }
+
+    }
+
+
+    // Image cache implementations.
+    ImageCache::ImageCache(
+        std::shared_ptr<const ImageLoaderRegistry> registry,
+        std::shared_ptr<ImagePixelBufferPool> pool
+    ) :
+        m_registry(std::move(registry)),
+        m_pool(std::move(pool)),
+        m_decodeCount(0),
+        m_asyncWorkerCount(0)
+    {}
+
+    ImageCache::~ImageCache()
+    {
+        std::unique_lock lock(m_mutex);
+        m_asyncLoads.clear();
+        m_asyncIdleCondition.wait(lock, [&]() { return m_asyncWorkerCount == 0; });
+    }
+
+    ImageLoadResult ImageCache::Load(const std::filesystem::path& filename, const ImageFormat format)
+    {
+        std::error_code errorCode;
+        const auto size = std::filesystem::file_size(filename, errorCode);
+        const auto lastWriteTime = errorCode ? std::filesystem::file_time_type{} : std::filesystem::last_write_time(filename, errorCode);
+        if(errorCode)
+        {
+            return "Cannot open image file " + filename.string() + ".";
+        }
+        const auto modifiedTime = static_cast<int64_t>(lastWriteTime.time_since_epoch().count());
+
+        const auto canonicalFilename = std::filesystem::weakly_canonical(filename, errorCode);
+        const auto fileKey = (errorCode ? filename : canonicalFilename).generic_string();
+
+        // Unchanged files of cached images are not hashed again.
+        std::shared_future<ImageLoadResult> cachedResult;
+        {
+            std::scoped_lock lock(m_mutex);
+
+            if(auto fileIt = m_files.find(fileKey); fileIt != m_files.end() && fileIt->second.size == size && fileIt->second.modifiedTime == modifiedTime)
+            {
+                if(auto imageIt = m_images.find(CreateImageKey(fileIt->second.contentHash, format)); imageIt != m_images.end())
+                {
+                    cachedResult = imageIt->second;
+                }
+            }
+        }
+        if(cachedResult.valid())
+        {
+            return cachedResult.get();
+        }
+
+        MemoryMappedFile file;
+        if(!file.Open(filename))
+        {
+            return "Cannot open image file " + filename.string() + ".";
+        }
+        const auto* data = reinterpret_cast<const uint8_t*>(file.GetData());
+        const auto contentHash = Hash64(data, file.GetSize());
+        {
+            std::scoped_lock lock(m_mutex);
+            m_files[fileKey] = FileEntry{ static_cast<uint64_t>(size), modifiedTime, contentHash };
+        }
+
+        return LoadContent(data, file.GetSize(), contentHash, filename, format);
+    }
+
+    ImageLoadResult ImageCache::Load(
+        const VirtualFileSystem& virtualFileSystem,
+        const std::string& path,
+        const ImageFormat format)
+    {
+        const auto file = virtualFileSystem.Open(path);
+        if(!file)
+        {
+            return "Cannot open image file " + path + ".";
+        }
+
+        // Virtual files have no last write time, so files of the same virtual file system are keyed by normalized path and size.
+        const auto fileKey = "vfs:" + std::to_string(reinterpret_cast<uintptr_t>(&virtualFileSystem)) + ":" + VirtualFileSystem::NormalizePath(path);
+        const auto size = static_cast<uint64_t>(file->GetSize());
+
+        std::shared_future<ImageLoadResult> cachedResult;
+        {
+            std::scoped_lock lock(m_mutex);
+
+            if(auto fileIt = m_files.find(fileKey); fileIt != m_files.end() && fileIt->second.size == size)
+            {
+                if(auto imageIt = m_images.find(CreateImageKey(fileIt->second.contentHash, format)); imageIt != m_images.end())
+                {
+                    cachedResult = imageIt->second;
+                }
+            }
+        }
+        if(cachedResult.valid())
+        {
+            return cachedResult.get();
+        }
+
+        const auto* data = reinterpret_cast<const uint8_t*>(file->GetData());
+        const auto contentHash = Hash64(data, file->GetSize());
+        {
+            std::scoped_lock lock(m_mutex);
+            m_files[fileKey] = FileEntry{ size, 0, contentHash };
+        }
+
+        return LoadContent(data, file->GetSize(), contentHash, std::filesystem::u8path(path), format);
+    }
+
+    std::vector<ImageLoadResult> ImageCache::Load(
+        const std::vector<std::filesystem::path>& filenames,
+        ThreadPool& threadPool,
+        const ImageFormat format)
+    {
+        std::vector<ImageLoadResult> results(filenames.size());
+        threadPool.ParallelFor(ThreadPool::Priority::Background, filenames.size(), [&](const size_t index)
+        {
+            results[index] = Load(filenames[index], format);
+        });
+        return results;
+    }
+
+    std::shared_future<ImageLoadResult> ImageCache::LoadAsync(
+        const std::filesystem::path& filename,
+        ThreadPool& threadPool,
+        const ImageFormat format)
+    {
+        AsyncLoad asyncLoad{ filename, format, {} };
+        auto future = asyncLoad.promise.get_future().share();
+
+        std::scoped_lock lock(m_mutex);
+        m_asyncLoads.push_back(std::move(asyncLoad));
+        StartAsyncLoadWorkers(threadPool);
+        return future;
+    }
+
+    void ImageCache::ScheduleAsyncLoads(ThreadPool& threadPool)
+    {
+        std::scoped_lock lock(m_mutex);
+        StartAsyncLoadWorkers(threadPool);
+    }
+
+    void ImageCache::WaitForAsyncLoads()
+    {
+        std::unique_lock lock(m_mutex);
+        while(RunNextAsyncLoad(lock))
+        {}
+        m_asyncIdleCondition.wait(lock, [&]() { return m_asyncWorkerCount == 0; });
+    }
+
+    void ImageCache::Clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_files.clear();
+        m_images.clear();
+    }
+
+    size_t ImageCache::GetImageCount() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_images.size();
+    }
+
+    size_t ImageCache::GetDecodeCount() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_decodeCount;
+    }
+
+    void ImageCache::StartAsyncLoadWorkers(ThreadPool& threadPool)
+    {
+        const auto workerLimit = threadPool.GetBackgroundWorkerLimit();
+        while(m_asyncWorkerCount < workerLimit && m_asyncWorkerCount < m_asyncLoads.size())
+        {
+            if(!threadPool.TryExecute(ThreadPool::Priority::Background, [this]() { RunAsyncLoads(); }).has_value())
+            {
+                break;
+            }
+            ++m_asyncWorkerCount;
+        }
+    }
+
+    void ImageCache::RunAsyncLoads()
+    {
+        std::unique_lock lock(m_mutex);
+        while(RunNextAsyncLoad(lock))
+        {}
+
+        --m_asyncWorkerCount;
+        m_asyncIdleCondition.notify_all();
+    }
+
+    bool ImageCache::RunNextAsyncLoad(std::unique_lock<std::mutex>& lock)
+    {
+        if(m_asyncLoads.empty())
+        {
+            return false;
+        }
+
+        auto asyncLoad = std::move(m_asyncLoads.front());
+        m_asyncLoads.pop_front();
+        lock.unlock();
+
+        try
+        {
+            asyncLoad.promise.set_value(Load(asyncLoad.filename, asyncLoad.format));
+        }
+        catch(...)
+        {
+            asyncLoad.promise.set_exception(std::current_exception());
+        }
+
+        lock.lock();
+        return true;
+    }
+
+    ImageLoadResult ImageCache::LoadContent(
+        const uint8_t* data,
+        const size_t size,
+        const uint64_t contentHash,
+        const std::filesystem::path& filename,
+        const ImageFormat format)
+    {
+        const auto imageKey = CreateImageKey(contentHash, format);
+
+        // Decode outside of lock, while concurrent loads of the same content wait for the shared result.
+        std::promise<ImageLoadResult> promise;
+        std::shared_future<ImageLoadResult> cachedResult;
+        {
+            std::scoped_lock lock(m_mutex);
+
+            if(auto it = m_images.find(imageKey); it != m_images.end())
+            {
+                cachedResult = it->second;
+            }
+            else
+            {
+                m_images.emplace(imageKey, promise.get_future().share());
+                ++m_decodeCount;
+            }
+        }
+        if(cachedResult.valid())
+        {
+            return cachedResult.get();
+        }
+
+        auto eraseFailedImage = [&]()
+        {
+            std::scoped_lock lock(m_mutex);
+            m_images.erase(imageKey);
+        };
+
+        try
+        {
+            auto result = m_registry->Load(data, size, filename, format, m_pool);
+            if(std::holds_alternative<std::string>(result))
+            {
+                eraseFailedImage();
+            }
+            promise.set_value(result);
+            return result;
+        }
+        catch(...)
+        {
+            eraseFailedImage();
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+}
@@ -0,0 +1,357 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/FileFormat/Image/ImageLoader.hpp"
+#include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include "Molten/FileFormat/Image/PnmFormat.hpp"
+#include "Molten/FileFormat/Image/TgaFormat.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace Molten
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        template<typename TResultCode>
+        const char* GetResultCodeDescription(const TResultCode code)
+        {
+            switch(code)
+            {
+                case TResultCode::Successful: return "successful";
+                case TResultCode::CannotOpenFile: return "cannot open file";
+                case TResultCode::UnexpectedEndOfFile: return "unexpected end of file";
+                case TResultCode::InvalidSignature: return "invalid signature";
+                case TResultCode::InvalidHeader: return "invalid header";
+                case TResultCode::UnsupportedFormat: return "unsupported format";
+                case TResultCode::BufferTooSmall: return "buffer too small";
+            }
+            return "unknown error";
+        }
+
+        /** Decodes image via format decoder, with open and decode functions of Bmp::Decoder. */
+        template<typename TDecoder>
+        ImageLoadResult DecodeImage(
+            const char* name,
+            const uint8_t* data,
+            const size_t size,
+            const ImageFormat format,
+            const std::shared_ptr<ImagePixelBufferPool>& pool)
+        {
+            TDecoder decoder;
+            if(const auto code = decoder.Open(data, size); code != decltype(code)::Successful)
+            {
+                return std::string{ name } + " image: " + GetResultCodeDescription(code) + ".";
+            }
+
+            const auto layout = PixelConversion::GetLayout(format);
+            if(!layout)
+            {
+                return std::string{ name } + " image: unsupported decode format.";
+            }
+
+            const Vector2ui32 dimensions = { decoder.GetWidth(), decoder.GetHeight() };
+            const auto decodedSize = static_cast<size_t>(dimensions.x) * dimensions.y * layout->channelCount;
+            auto pixels = pool ? pool->Acquire(decodedSize) : ImagePixelBufferPool::Buffer(decodedSize);
+
+            if(const auto code = decoder.Decode(format, pixels.data(), pixels.size()); code != decltype(code)::Successful)
+            {
+                if(pool)
+                {
+                    pool->Release(std::move(pixels));
+                }
+                return std::string{ name } + " image: " + GetResultCodeDescription(code) + ".";
+            }
+
+            return std::make_shared<const Image>(std::move(pixels), dimensions, format, pool);
+        }
+
+        std::string GetLowerCaseExtension(const std::filesystem::path& filename)
+        {
+            auto extension = filename.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](const char character)
+            {
+                return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+            });
+            return extension;
+        }
+
+    }
+
+
+    // Image pixel buffer pool implementations.
+    ImagePixelBufferPool::ImagePixelBufferPool(const size_t maxPooledSize) :
+        m_maxPooledSize(maxPooledSize),
+        m_pooledSize(0)
+    {}
+
+    const std::shared_ptr<ImagePixelBufferPool>& ImagePixelBufferPool::GetShared()
+    {
+        static const auto pool = std::make_shared<ImagePixelBufferPool>();
+        return pool;
+    }
+
+    ImagePixelBufferPool::Buffer ImagePixelBufferPool::Acquire(const size_t size)
+    {
+        Buffer buffer;
+        {
+            std::scoped_lock lock(m_mutex);
+
+            if(auto it = m_buffers.lower_bound(size); it != m_buffers.end())
+            {
+                m_pooledSize -= it->first;
+                buffer = std::move(it->second);
+                m_buffers.erase(it);
+            }
+        }
+
+        buffer.resize(size);
+        return buffer;
+    }
+
+    void ImagePixelBufferPool::Release(Buffer&& buffer)
+    {
+        const auto capacity = buffer.capacity();
+        if(capacity == 0)
+        {
+            return;
+        }
+
+        Buffer releasedBuffer = std::move(buffer);
+
+        std::scoped_lock lock(m_mutex);
+        if(m_pooledSize + capacity > m_maxPooledSize)
+        {
+            return;
+        }
+
+        m_pooledSize += capacity;
+        m_buffers.emplace(capacity, std::move(releasedBuffer));
+    }
+
+    size_t ImagePixelBufferPool::GetPooledBufferCount() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_buffers.size();
+    }
+
+    size_t ImagePixelBufferPool::GetPooledSize() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_pooledSize;
+    }
+
+
+    // Image implementations.
+    Image::Image(
+        ImagePixelBufferPool::Buffer&& pixels,
+        const Vector2ui32& dimensions,
+        const ImageFormat format,
+        std::weak_ptr<ImagePixelBufferPool> pool
+    ) :
+        m_pixels(std::move(pixels)),
+        m_dimensions(dimensions),
+        m_format(format),
+        m_pool(std::move(pool))
+    {}
+
+    Image::~Image()
+    {
+        if(auto pool = m_pool.lock(); pool)
+        {
+            pool->Release(std::move(m_pixels));
+        }
+    }
+
+    const uint8_t* Image::GetData() const
+    {
+        return m_pixels.data();
+    }
+
+    size_t Image::GetDataSize() const
+    {
+        return m_pixels.size();
+    }
+
+    const Vector2ui32& Image::GetDimensions() const
+    {
+        return m_dimensions;
+    }
+
+    ImageFormat Image::GetFormat() const
+    {
+        return m_format;
+    }
+
+    TextureDescriptor2D Image::CreateTextureDescriptor(const TextureUsage initialUsage) const
+    {
+        return TextureDescriptor2D{ m_pixels.data(), m_dimensions, TextureType::Color, initialUsage, m_format };
+    }
+
+
+    // Image loader registry implementations.
+    const std::shared_ptr<const ImageLoaderRegistry>& ImageLoaderRegistry::GetDefault()
+    {
+        static const std::shared_ptr<const ImageLoaderRegistry> registry = []()
+        {
+            auto defaultRegistry = std::make_shared<ImageLoaderRegistry>();
+            defaultRegistry->RegisterDefaultLoaders();
+            return defaultRegistry;
+        }();
+        return registry;
+    }
+
+    void ImageLoaderRegistry::Register(Loader loader)
+    {
+        m_loaders.push_back(std::move(loader));
+    }
+
+    void ImageLoaderRegistry::RegisterDefaultLoaders()
+    {
+        Register({
+            "BMP",
+            { ".bmp", ".dib" },
+            [](const uint8_t* data, const size_t size)
+            {
+                return size >= 2 && data[0] == 'B' && data[1] == 'M';
+            },
+            [](const uint8_t* data, const size_t size, const ImageFormat format, const std::shared_ptr<ImagePixelBufferPool>& pool)
+            {
+                return DecodeImage<Formats::Bmp::Decoder>("BMP", data, size, format, pool);
+            }
+        });
+
+        Register({
+            "TGA",
+            { ".tga", ".tpic" },
+            &Formats::Tga::IsTgaData,
+            [](const uint8_t* data, const size_t size, const ImageFormat format, const std::shared_ptr<ImagePixelBufferPool>& pool)
+            {
+                return DecodeImage<Formats::Tga::Decoder>("TGA", data, size, format, pool);
+            }
+        });
+
+        Register({
+            "PNM",
+            { ".ppm", ".pgm", ".pnm" },
+            &Formats::Pnm::IsPnmData,
+            [](const uint8_t* data, const size_t size, const ImageFormat format, const std::shared_ptr<ImagePixelBufferPool>& pool)
+            {
+                return DecodeImage<Formats::Pnm::Decoder>("PNM", data, size, format, pool);
+            }
+        });
+    }
+
+    const std::vector<ImageLoaderRegistry::Loader>& ImageLoaderRegistry::GetLoaders() const
+    {
+        return m_loaders;
+    }
+
+    const ImageLoaderRegistry::Loader* ImageLoaderRegistry::FindLoader(
+        const std::filesystem::path& filename,
+        const uint8_t* data,
+        const size_t size) const
+    {
+        const auto extension = GetLowerCaseExtension(filename);
+        auto accepts = [&](const Loader& loader)
+        {
+            return !loader.probe || loader.probe(data, size);
+        };
+
+        if(!extension.empty())
+        {
+            for(auto it = m_loaders.rbegin(); it != m_loaders.rend(); ++it)
+            {
+                const auto& extensions = it->extensions;
+                if(std::find(extensions.begin(), extensions.end(), extension) != extensions.end() && accepts(*it))
+                {
+                    return &*it;
+                }
+            }
+        }
+
+        // Fall back to probing, in case of missing or misleading file extensions.
+        for(auto it = m_loaders.rbegin(); it != m_loaders.rend(); ++it)
+        {
+            if(it->probe && it->probe(data, size))
+            {
+                return &*it;
+            }
+        }
+
+        return nullptr;
+    }
+
+    ImageLoadResult ImageLoaderRegistry::Load(
+        const uint8_t* data,
+        const size_t size,
+        const std::filesystem::path& filename,
+        const ImageFormat format,
+        const std::shared_ptr<ImagePixelBufferPool>& pool) const
+    {
+        const auto* loader = FindLoader(filename, data, size);
+        if(loader == nullptr || !loader->decode)
+        {
+            return std::string{ "No image loader supports " } + (filename.empty() ? std::string{ "data" } : "file " + filename.string()) + ".";
+        }
+
+        return loader->decode(data, size, format, pool);
+    }
+
+    ImageLoadResult ImageLoaderRegistry::LoadFromFile(
+        const std::filesystem::path& filename,
+        const ImageFormat format,
+        const std::shared_ptr<ImagePixelBufferPool>& pool) const
+    {
+        MemoryMappedFile file;
+        if(!file.Open(filename))
+        {
+            return "Cannot open image file " + filename.string() + ".";
+        }
+
+        return Load(reinterpret_cast<const uint8_t*>(file.GetData()), file.GetSize(), filename, format, pool);
+    }
+
+    ImageLoadResult ImageLoaderRegistry::LoadFromFile(
+        const VirtualFileSystem& virtualFileSystem,
+        const std::string& path,
+        const ImageFormat format,
+        const std::shared_ptr<ImagePixelBufferPool>& pool) const
+    {
+        const auto file = virtualFileSystem.Open(path);
+        if(!file)
+        {
+            return "Cannot open image file " + path + ".";
+        }
+
+        return Load(reinterpret_cast<const uint8_t*>(file->GetData()), file->GetSize(), std::filesystem::u8path(path), format, pool);
+    }
+
+}
@@ -0,0 +1,604 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/FileFormat/Image/MipmapGenerator.hpp"
+#include "Molten/FileFormat/Image/ImageLoader.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOLTEN_MIPMAPGENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Molten
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        constexpr double Pi = 3.14159265358979323846;
+
+        struct PixelLayout
+        {
+            size_t channelCount;
+            size_t srgbChannelCount; ///< Number of leading channels stored in sRGB.
+        };
+
+        std::optional<PixelLayout> GetPixelLayout(const ImageFormat format)
+        {
+            switch(format)
+            {
+                case ImageFormat::URed8: return PixelLayout{ 1, 0 };
+                case ImageFormat::URed8Green8: return PixelLayout{ 2, 0 };
+                case ImageFormat::URed8Green8Blue8:
+                case ImageFormat::UBlue8Green8Red8: return PixelLayout{ 3, 0 };
+                case ImageFormat::URed8Green8Blue8Alpha8:
+                case ImageFormat::UBlue8Green8Red8Alpha8: return PixelLayout{ 4, 0 };
+                case ImageFormat::SrgbRed8Green8Blue8: return PixelLayout{ 3, 3 };
+                case ImageFormat::SrgbRed8Green8Blue8Alpha8: return PixelLayout{ 4, 3 };
+                default: break;
+            }
+            return std::nullopt;
+        }
+
+        double SrgbToLinear(const double value)
+        {
+            return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+        }
+
+        /** Lookup tables of conversions between 8-bit sRGB and linear values. */
+        struct SrgbTables
+        {
+            static constexpr size_t EncodeGuessSize = 4096;
+
+            SrgbTables()
+            {
+                for(size_t i = 0; i < 256; i++)
+                {
+                    toLinear[i] = static_cast<float>(SrgbToLinear(static_cast<double>(i) / 255.0));
+                }
+
+                // Linear value v encodes to byte b if thresholds[b] <= v < thresholds[b + 1].
+                thresholds[0] = -std::numeric_limits<float>::infinity();
+                for(size_t i = 1; i < 256; i++)
+                {
+                    thresholds[i] = static_cast<float>(SrgbToLinear((static_cast<double>(i) - 0.5) / 255.0));
+                }
+                thresholds[256] = std::numeric_limits<float>::infinity();
+
+                uint8_t byte = 0;
+                for(size_t i = 0; i < EncodeGuessSize; i++)
+                {
+                    const auto value = static_cast<float>(i) / static_cast<float>(EncodeGuessSize - 1);
+                    while(value >= thresholds[byte + 1])
+                    {
+                        ++byte;
+                    }
+                    encodeGuess[i] = byte;
+                }
+            }
+
+            uint8_t Encode(const float value) const
+            {
+                const auto clamped = std::clamp(value, 0.0f, 1.0f);
+                size_t byte = encodeGuess[static_cast<size_t>(clamped * static_cast<float>(EncodeGuessSize - 1))];
+                while(clamped >= thresholds[byte + 1])
+                {
+                    ++byte;
+                }
+                while(clamped < thresholds[byte])
+                {
+                    --byte;
+                }
+                return static_cast<uint8_t>(byte);
+            }
+
+            std::array<float, 256> toLinear;
+            std::array<float, 257> thresholds;
+            std::array<uint8_t, EncodeGuessSize> encodeGuess;
+        };
+
+        const SrgbTables& GetSrgbTables()
+        {
+            static const SrgbTables tables;
+            return tables;
+        }
+
+        uint8_t EncodeUnorm(const float value)
+        {
+            return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        /** Polyphase weights of one axis, with the same number of taps for each destination pixel. */
+        struct FilterKernel
+        {
+            size_t tapCount = 0;
+            std::vector<uint32_t> starts; ///< First source pixel of each destination pixel.
+            std::vector<float> weights; ///< tapCount weights per destination pixel.
+        };
+
+        double BesselI0(const double value)
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            const double halfSquared = value * value * 0.25;
+            for(int k = 1; k < 64; k++)
+            {
+                term *= halfSquared / static_cast<double>(k * k);
+                sum += term;
+                if(term < sum * 1e-12)
+                {
+                    break;
+                }
+            }
+            return sum;
+        }
+
+        double Sinc(const double value)
+        {
+            if(std::abs(value) < 1e-9)
+            {
+                return 1.0;
+            }
+            const double x = value * Pi;
+            return std::sin(x) / x;
+        }
+
+        /** Weight of source pixel covering [sourceBegin, sourceBegin + 1), for destination pixel covering source interval [begin, end). */
+        double CalculateWeight(
+            const MipmapGenerator::Settings& settings,
+            const double sourceBegin,
+            const double begin,
+            const double end,
+            const double ratio)
+        {
+            if(settings.filter == MipmapGenerator::Filter::Box)
+            {
+                return std::max(0.0, std::min(sourceBegin + 1.0, end) - std::max(sourceBegin, begin));
+            }
+
+            const double center = (begin + end) * 0.5;
+            const double radius = static_cast<double>(settings.kaiserWidth) * ratio;
+            const double distance = (sourceBegin + 0.5) - center;
+            if(std::abs(distance) >= radius)
+            {
+                return 0.0;
+            }
+
+            const double windowPosition = distance / radius;
+            const double window =
+                BesselI0(static_cast<double>(settings.kaiserAlpha) * std::sqrt(1.0 - windowPosition * windowPosition)) /
+                BesselI0(static_cast<double>(settings.kaiserAlpha));
+            return Sinc(distance / ratio) * window;
+        }
+
+        FilterKernel CreateFilterKernel(const MipmapGenerator::Settings& settings, const uint32_t sourceSize, const uint32_t destinationSize)
+        {
+            const double ratio = static_cast<double>(sourceSize) / static_cast<double>(destinationSize);
+            const double radius = settings.filter == MipmapGenerator::Filter::Box ?
+                ratio * 0.5 :
+                std::max(0.5, static_cast<double>(settings.kaiserWidth)) * ratio;
+
+            struct Tap
+            {
+                int64_t index;
+                double weight;
+            };
+            std::vector<std::vector<Tap>> taps(destinationSize);
+
+            // Collect weights, folding samples outside of the image onto the edge pixels.
+            FilterKernel kernel;
+            for(uint32_t i = 0; i < destinationSize; i++)
+            {
+                const double begin = static_cast<double>(i) * ratio;
+                const double end = begin + ratio;
+                const double center = (begin + end) * 0.5;
+                const auto first = static_cast<int64_t>(std::floor(center - radius));
+                const auto last = static_cast<int64_t>(std::ceil(center + radius));
+
+                auto& destinationTaps = taps[i];
+                double weightSum = 0.0;
+                for(int64_t j = first; j <= last; j++)
+                {
+                    const double weight = CalculateWeight(settings, static_cast<double>(j), begin, end, ratio);
+                    if(weight == 0.0)
+                    {
+                        continue;
+                    }
+
+                    const auto index = std::clamp<int64_t>(j, 0, static_cast<int64_t>(sourceSize) - 1);
+                    if(!destinationTaps.empty() && destinationTaps.back().index == index)
+                    {
+                        destinationTaps.back().weight += weight;
+                    }
+                    else
+                    {
+                        destinationTaps.push_back({ index, weight });
+                    }
+                    weightSum += weight;
+                }
+
+                if(destinationTaps.empty() || weightSum == 0.0)
+                {
+                    destinationTaps = { { std::clamp<int64_t>(static_cast<int64_t>(center), 0, static_cast<int64_t>(sourceSize) - 1), 1.0 } };
+                    weightSum = 1.0;
+                }
+                for(auto& tap : destinationTaps)
+                {
+                    tap.weight /= weightSum;
+                }
+
+                const auto span = static_cast<size_t>(destinationTaps.back().index - destinationTaps.front().index + 1);
+                kernel.tapCount = std::max(kernel.tapCount, span);
+            }
+
+            // Pack weights with a fixed number of taps per destination pixel, padded with zero weights.
+            kernel.starts.resize(destinationSize);
+            kernel.weights.assign(static_cast<size_t>(destinationSize) * kernel.tapCount, 0.0f);
+            for(uint32_t i = 0; i < destinationSize; i++)
+            {
+                const auto& destinationTaps = taps[i];
+                const auto start = std::min<int64_t>(destinationTaps.front().index, static_cast<int64_t>(sourceSize - kernel.tapCount));
+                kernel.starts[i] = static_cast<uint32_t>(start);
+
+                auto* weights = kernel.weights.data() + static_cast<size_t>(i) * kernel.tapCount;
+                for(const auto& tap : destinationTaps)
+                {
+                    weights[tap.index - start] += static_cast<float>(tap.weight);
+                }
+            }
+
+            return kernel;
+        }
+
+        /** Accumulates weighted source rows into destination row of floats. */
+        void FilterVertical(
+            const float* source,
+            const size_t rowSize,
+            const FilterKernel& kernel,
+            const uint32_t destinationRow,
+            float* destination)
+        {
+            const auto* weights = kernel.weights.data() + static_cast<size_t>(destinationRow) * kernel.tapCount;
+            const auto* firstRow = source + static_cast<size_t>(kernel.starts[destinationRow]) * rowSize;
+
+            std::fill(destination, destination + rowSize, 0.0f);
+            for(size_t tap = 0; tap < kernel.tapCount; tap++)
+            {
+                const float weight = weights[tap];
+                if(weight == 0.0f)
+                {
+                    continue;
+                }
+
+                const auto* row = firstRow + tap * rowSize;
+                size_t i = 0;
+            #if defined(MOLTEN_MIPMAPGENERATOR_SSE2)
+                const auto weight4 = _mm_set1_ps(weight);
+                for(; i + 4 <= rowSize; i += 4)
+                {
+                    const auto sum = _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(row + i), weight4));
+                    _mm_storeu_ps(destination + i, sum);
+                }
+            #endif
+                for(; i < rowSize; i++)
+                {
+                    destination[i] += row[i] * weight;
+                }
+            }
+        }
+
+        /** Filters row of floats horizontally, into destination row of floats. */
+        void FilterHorizontal(
+            const float* source,
+            const size_t channelCount,
+            const FilterKernel& kernel,
+            const uint32_t destinationWidth,
+            float* destination)
+        {
+        #if defined(MOLTEN_MIPMAPGENERATOR_SSE2)
+            if(channelCount == 4)
+            {
+                for(uint32_t x = 0; x < destinationWidth; x++)
+                {
+                    const auto* weights = kernel.weights.data() + static_cast<size_t>(x) * kernel.tapCount;
+                    const auto* pixels = source + static_cast<size_t>(kernel.starts[x]) * 4;
+
+                    auto sum = _mm_setzero_ps();
+                    for(size_t tap = 0; tap < kernel.tapCount; tap++)
+                    {
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pixels + tap * 4), _mm_set1_ps(weights[tap])));
+                    }
+                    _mm_storeu_ps(destination + static_cast<size_t>(x) * 4, sum);
+                }
+                return;
+            }
+        #endif
+
+            for(uint32_t x = 0; x < destinationWidth; x++)
+            {
+                const auto* weights = kernel.weights.data() + static_cast<size_t>(x) * kernel.tapCount;
+                const auto* pixels = source + static_cast<size_t>(kernel.starts[x]) * channelCount;
+                auto* pixel = destination + static_cast<size_t>(x) * channelCount;
+
+                for(size_t channel = 0; channel < channelCount; channel++)
+                {
+                    float sum = 0.0f;
+                    for(size_t tap = 0; tap < kernel.tapCount; tap++)
+                    {
+                        sum += pixels[tap * channelCount + channel] * weights[tap];
+                    }
+                    pixel[channel] = sum;
+                }
+            }
+        }
+
+        void DecodeRow(const uint8_t* source, const PixelLayout& layout, const size_t pixelCount, float* destination)
+        {
+            const auto& toLinear = GetSrgbTables().toLinear;
+            for(size_t i = 0; i < pixelCount; i++)
+            {
+                for(size_t channel = 0; channel < layout.channelCount; channel++)
+                {
+                    const auto value = source[i * layout.channelCount + channel];
+                    destination[i * layout.channelCount + channel] = channel < layout.srgbChannelCount ?
+                        toLinear[value] : static_cast<float>(value) * (1.0f / 255.0f);
+                }
+            }
+        }
+
+        void EncodeRow(const float* source, const PixelLayout& layout, const size_t pixelCount, uint8_t* destination)
+        {
+            if(layout.srgbChannelCount == 0)
+            {
+                const size_t valueCount = pixelCount * layout.channelCount;
+                size_t i = 0;
+            #if defined(MOLTEN_MIPMAPGENERATOR_SSE2)
+                const auto zero = _mm_setzero_ps();
+                const auto one = _mm_set1_ps(1.0f);
+                const auto scale = _mm_set1_ps(255.0f);
+                const auto half = _mm_set1_ps(0.5f);
+                for(; i + 16 <= valueCount; i += 16)
+                {
+                    __m128i packed[4];
+                    for(size_t j = 0; j < 4; j++)
+                    {
+                        const auto clamped = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i + j * 4), zero), one);
+                        packed[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, scale), half));
+                    }
+                    const auto words0 = _mm_packs_epi32(packed[0], packed[1]);
+                    const auto words1 = _mm_packs_epi32(packed[2], packed[3]);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(words0, words1));
+                }
+            #endif
+                for(; i < valueCount; i++)
+                {
+                    destination[i] = EncodeUnorm(source[i]);
+                }
+                return;
+            }
+
+            const auto& tables = GetSrgbTables();
+            for(size_t i = 0; i < pixelCount; i++)
+            {
+                for(size_t channel = 0; channel < layout.channelCount; channel++)
+                {
+                    const auto value = source[i * layout.channelCount + channel];
+                    destination[i * layout.channelCount + channel] = channel < layout.srgbChannelCount ?
+                        tables.Encode(value) : EncodeUnorm(value);
+                }
+            }
+        }
+
+        template<typename TFunction>
+        void ForEachTile(ThreadPool* threadPool, const uint32_t rowCount, TFunction&& function)
+        {
+            const size_t tileCount = (static_cast<size_t>(rowCount) + MipmapGenerator::TileRowCount - 1) / MipmapGenerator::TileRowCount;
+            auto processTile = [&](const size_t tile)
+            {
+                const auto beginRow = static_cast<uint32_t>(tile * MipmapGenerator::TileRowCount);
+                const auto endRow = std::min(rowCount, beginRow + MipmapGenerator::TileRowCount);
+                function(beginRow, endRow);
+            };
+
+            if(threadPool != nullptr && tileCount > 1)
+            {
+                threadPool->ParallelFor(ThreadPool::Priority::Normal, tileCount, processTile);
+            }
+            else
+            {
+                for(size_t tile = 0; tile < tileCount; tile++)
+                {
+                    processTile(tile);
+                }
+            }
+        }
+
+    }
+
+
+    // Mip chain implementations.
+    MipChain::MipChain(
+        std::vector<uint8_t>&& data,
+        std::vector<size_t>&& levelOffsets,
+        const Vector2ui32& dimensions,
+        const ImageFormat format
+    ) :
+        m_data(std::move(data)),
+        m_levelOffsets(std::move(levelOffsets)),
+        m_dimensions(dimensions),
+        m_format(format)
+    {}
+
+    const uint8_t* MipChain::GetData() const
+    {
+        return m_data.data();
+    }
+
+    size_t MipChain::GetDataSize() const
+    {
+        return m_data.size();
+    }
+
+    const Vector2ui32& MipChain::GetDimensions() const
+    {
+        return m_dimensions;
+    }
+
+    ImageFormat MipChain::GetFormat() const
+    {
+        return m_format;
+    }
+
+    uint32_t MipChain::GetLevelCount() const
+    {
+        return static_cast<uint32_t>(m_levelOffsets.size() - 1);
+    }
+
+    Vector2ui32 MipChain::GetLevelDimensions(const uint32_t level) const
+    {
+        return GetMipLevelDimensions(m_dimensions, level);
+    }
+
+    const uint8_t* MipChain::GetLevelData(const uint32_t level) const
+    {
+        return m_data.data() + m_levelOffsets[level];
+    }
+
+    size_t MipChain::GetLevelSize(const uint32_t level) const
+    {
+        return m_levelOffsets[level + 1] - m_levelOffsets[level];
+    }
+
+    TextureDescriptor2D MipChain::CreateTextureDescriptor(const TextureUsage initialUsage) const
+    {
+        auto descriptor = TextureDescriptor2D{ m_data.data(), m_dimensions, TextureType::Color, initialUsage, m_format };
+        descriptor.mipLevelCount = GetLevelCount();
+        return descriptor;
+    }
+
+
+    // Mipmap generator implementations.
+    MipmapGenerator::Settings::Settings() :
+        filter(Filter::Box),
+        kaiserWidth(3.0f),
+        kaiserAlpha(4.0f),
+        maxLevelCount(0)
+    {}
+
+    bool MipmapGenerator::IsFormatSupported(const ImageFormat format)
+    {
+        return GetPixelLayout(format).has_value();
+    }
+
+    std::optional<MipChain> MipmapGenerator::Generate(
+        const uint8_t* pixels,
+        const Vector2ui32& dimensions,
+        const ImageFormat format,
+        const Settings& settings,
+        ThreadPool* threadPool)
+    {
+        const auto layout = GetPixelLayout(format);
+        if(!layout || dimensions.x == 0 || dimensions.y == 0)
+        {
+            return std::nullopt;
+        }
+
+        const auto fullLevelCount = CalculateMipLevelCount(dimensions);
+        const auto levelCount = settings.maxLevelCount == 0 ? fullLevelCount : std::min(settings.maxLevelCount, fullLevelCount);
+        const auto channelCount = layout->channelCount;
+
+        std::vector<size_t> levelOffsets(static_cast<size_t>(levelCount) + 1, 0);
+        for(uint32_t level = 0; level < levelCount; level++)
+        {
+            const auto levelDimensions = GetMipLevelDimensions(dimensions, level);
+            levelOffsets[level + 1] = levelOffsets[level] +
+                static_cast<size_t>(levelDimensions.x) * static_cast<size_t>(levelDimensions.y) * channelCount;
+        }
+
+        std::vector<uint8_t> data(levelOffsets.back());
+        std::memcpy(data.data(), pixels, levelOffsets[1]);
+
+        if(levelCount > 1)
+        {
+            // Filter each level from the linear values of the previous level.
+            const size_t sourceRowSize = static_cast<size_t>(dimensions.x) * channelCount;
+            std::vector<float> source(sourceRowSize * dimensions.y);
+            ForEachTile(threadPool, dimensions.y, [&](const uint32_t beginRow, const uint32_t endRow)
+            {
+                for(uint32_t y = beginRow; y < endRow; y++)
+                {
+                    DecodeRow(pixels + y * sourceRowSize, *layout, dimensions.x, source.data() + y * sourceRowSize);
+                }
+            });
+
+            std::vector<float> destination;
+            for(uint32_t level = 1; level < levelCount; level++)
+            {
+                const auto sourceDimensions = GetMipLevelDimensions(dimensions, level - 1);
+                const auto destinationDimensions = GetMipLevelDimensions(dimensions, level);
+                const auto horizontalKernel = CreateFilterKernel(settings, sourceDimensions.x, destinationDimensions.x);
+                const auto verticalKernel = CreateFilterKernel(settings, sourceDimensions.y, destinationDimensions.y);
+
+                const size_t levelSourceRowSize = static_cast<size_t>(sourceDimensions.x) * channelCount;
+                const size_t destinationRowSize = static_cast<size_t>(destinationDimensions.x) * channelCount;
+                destination.resize(destinationRowSize * destinationDimensions.y);
+                auto* levelData = data.data() + levelOffsets[level];
+
+                ForEachTile(threadPool, destinationDimensions.y, [&](const uint32_t beginRow, const uint32_t endRow)
+                {
+                    std::vector<float> verticalRow(levelSourceRowSize);
+                    for(uint32_t y = beginRow; y < endRow; y++)
+                    {
+                        auto* destinationRow = destination.data() + y * destinationRowSize;
+                        FilterVertical(source.data(), levelSourceRowSize, verticalKernel, y, verticalRow.data());
+                        FilterHorizontal(verticalRow.data(), channelCount, horizontalKernel, destinationDimensions.x, destinationRow);
+                        EncodeRow(destinationRow, *layout, destinationDimensions.x, levelData + y * destinationRowSize);
+                    }
+                });
+
+                std::swap(source, destination);
+            }
+        }
+
+        return MipChain{ std::move(data), std::move(levelOffsets), dimensions, format };
+    }
+
+    std::optional<MipChain> MipmapGenerator::Generate(
+        const Image& image,
+        const Settings& settings,
+        ThreadPool* threadPool)
+    {
+        return Generate(image.GetData(), image.GetDimensions(), image.GetFormat(), settings, threadPool);
+    }
+
+}
@@ -0,0 +1,235 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include <cstring>
+#include <utility>
+
+// SSSE3 is not enabled by default compiler flags, so its kernel is compiled for SSSE3 separately and selected at runtime.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MOLTEN_PIXELCONVERSION_SSSE3
+#define MOLTEN_PIXELCONVERSION_SSSE3_TARGET __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_X64))
+#define MOLTEN_PIXELCONVERSION_SSSE3
+#define MOLTEN_PIXELCONVERSION_SSSE3_TARGET
+#include <intrin.h>
+#include <tmmintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOLTEN_PIXELCONVERSION_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define MOLTEN_PIXELCONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Molten::PixelConversion
+{
+
+    // Global implementations.
+#if defined(MOLTEN_PIXELCONVERSION_SSSE3)
+    static bool IsSsse3Supported()
+    {
+        static const bool supported = []()
+        {
+#if defined(__SSSE3__)
+            return true;
+#elif defined(_MSC_VER)
+            int info[4] = {};
+            __cpuid(info, 1);
+            return (info[2] & (1 << 9)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("ssse3") != 0;
+#endif
+        }();
+        return supported;
+    }
+
+    /** Converts 3 to 4 channel pixels, 8 pixels per iteration. @return Number of converted pixels. */
+    MOLTEN_PIXELCONVERSION_SSSE3_TARGET
+    static size_t ConvertRgbToRgbaSsse3(const uint8_t* source, uint8_t* destination, const bool swapRedBlue, const size_t pixelCount)
+    {
+        const auto shuffle = swapRedBlue ?
+            _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+            _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+        // Each 16 byte load holds 4 whole pixels, so 8 pixels are converted per iteration without reading past the row.
+        size_t i = 0;
+        for(; i + 8 <= pixelCount; i += 8)
+        {
+            const auto* src = source + i * 3;
+            auto* dst = destination + i * 4;
+            const auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(_mm_shuffle_epi8(low, shuffle), alpha));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(high, 4), shuffle), alpha));
+        }
+        return i;
+    }
+#endif
+
+
+    // Pixel conversion implementations.
+    const char* GetInstructionSet()
+    {
+#if defined(MOLTEN_PIXELCONVERSION_SSSE3)
+        if(IsSsse3Supported())
+        {
+            return "SSSE3";
+        }
+#endif
+#if defined(MOLTEN_PIXELCONVERSION_NEON)
+        return "NEON";
+#else
+        return "Scalar";
+#endif
+    }
+
+    std::optional<Layout> GetLayout(const ImageFormat format)
+    {
+        switch(format)
+        {
+            case ImageFormat::URed8Green8Blue8:
+            case ImageFormat::SrgbRed8Green8Blue8: return Layout{ 3, false };
+            case ImageFormat::URed8Green8Blue8Alpha8:
+            case ImageFormat::SrgbRed8Green8Blue8Alpha8: return Layout{ 4, false };
+            case ImageFormat::UBlue8Green8Red8: return Layout{ 3, true };
+            case ImageFormat::UBlue8Green8Red8Alpha8: return Layout{ 4, true };
+            default: break;
+        }
+        return std::nullopt;
+    }
+
+    void ConvertRow(
+        const uint8_t* source,
+        const size_t sourceChannelCount,
+        uint8_t* destination,
+        const size_t destinationChannelCount,
+        const bool swapRedBlue,
+        const bool opaque,
+        const size_t pixelCount)
+    {
+        if(pixelCount == 0)
+        {
+            return;
+        }
+
+        size_t i = 0;
+
+        if(sourceChannelCount == 1)
+        {
+            for(; i < pixelCount; i++)
+            {
+                auto* dst = destination + i * destinationChannelCount;
+                dst[0] = dst[1] = dst[2] = source[i];
+                if(destinationChannelCount == 4)
+                {
+                    dst[3] = 255;
+                }
+            }
+            return;
+        }
+
+        if(sourceChannelCount == destinationChannelCount && !swapRedBlue && (sourceChannelCount == 3 || !opaque))
+        {
+            std::memcpy(destination, source, pixelCount * sourceChannelCount);
+            return;
+        }
+
+        if(sourceChannelCount == 3 && destinationChannelCount == 4)
+        {
+#if defined(MOLTEN_PIXELCONVERSION_SSSE3)
+            if(IsSsse3Supported())
+            {
+                i = ConvertRgbToRgbaSsse3(source, destination, swapRedBlue, pixelCount);
+            }
+#elif defined(MOLTEN_PIXELCONVERSION_NEON)
+            for(; i + 16 <= pixelCount; i += 16)
+            {
+                const auto bgr = vld3q_u8(source + i * 3);
+                uint8x16x4_t bgra;
+                bgra.val[0] = swapRedBlue ? bgr.val[2] : bgr.val[0];
+                bgra.val[1] = bgr.val[1];
+                bgra.val[2] = swapRedBlue ? bgr.val[0] : bgr.val[2];
+                bgra.val[3] = vdupq_n_u8(255);
+                vst4q_u8(destination + i * 4, bgra);
+            }
+#endif
+        }
+        else if(sourceChannelCount == 4 && destinationChannelCount == 4)
+        {
+#if defined(MOLTEN_PIXELCONVERSION_SSE2)
+            const auto redBlueMask = _mm_set1_epi32(0x00FF00FF);
+            const auto alpha = _mm_set1_epi32(opaque ? static_cast<int>(0xFF000000) : 0);
+            for(; i + 4 <= pixelCount; i += 4)
+            {
+                auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+                if(swapRedBlue)
+                {
+                    const auto redBlue = _mm_and_si128(pixels, redBlueMask);
+                    pixels = _mm_or_si128(
+                        _mm_andnot_si128(redBlueMask, pixels),
+                        _mm_or_si128(_mm_slli_epi32(redBlue, 16), _mm_srli_epi32(redBlue, 16)));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), _mm_or_si128(pixels, alpha));
+            }
+#elif defined(MOLTEN_PIXELCONVERSION_NEON)
+            for(; i + 16 <= pixelCount; i += 16)
+            {
+                auto bgra = vld4q_u8(source + i * 4);
+                if(swapRedBlue)
+                {
+                    std::swap(bgra.val[0], bgra.val[2]);
+                }
+                if(opaque)
+                {
+                    bgra.val[3] = vdupq_n_u8(255);
+                }
+                vst4q_u8(destination + i * 4, bgra);
+            }
+#endif
+        }
+
+        const size_t redIndex = swapRedBlue ? 2 : 0;
+        const size_t blueIndex = swapRedBlue ? 0 : 2;
+        const bool copyAlpha = sourceChannelCount == 4 && !opaque;
+        for(; i < pixelCount; i++)
+        {
+            const auto* src = source + i * sourceChannelCount;
+            auto* dst = destination + i * destinationChannelCount;
+            dst[0] = src[redIndex];
+            dst[1] = src[1];
+            dst[2] = src[blueIndex];
+            if(destinationChannelCount == 4)
+            {
+                dst[3] = copyAlpha ? src[3] : 255;
+            }
+        }
+    }
+
+}
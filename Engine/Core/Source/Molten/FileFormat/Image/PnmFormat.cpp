@@ -0,0 +1,311 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/FileFormat/Image/PnmFormat.hpp"
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include <algorithm>
+#include <array>
+
+namespace Molten::Formats::Pnm
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        bool IsWhitespace(const uint8_t character)
+        {
+            return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\v' || character == '\f';
+        }
+
+        /** Skips whitespace and comments, then reads a decimal value. Comments run from '#' to end of line. */
+        bool ReadValue(const uint8_t* data, const size_t size, size_t& offset, uint32_t& value)
+        {
+            while(offset < size)
+            {
+                if(data[offset] == '#')
+                {
+                    while(offset < size && data[offset] != '\n' && data[offset] != '\r')
+                    {
+                        ++offset;
+                    }
+                }
+                else if(IsWhitespace(data[offset]))
+                {
+                    ++offset;
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            uint64_t result = 0;
+            size_t digitCount = 0;
+            while(offset < size && data[offset] >= '0' && data[offset] <= '9')
+            {
+                result = result * 10 + static_cast<uint64_t>(data[offset] - '0');
+                if(result > 0xFFFFFFFF)
+                {
+                    return false;
+                }
+                ++offset;
+                ++digitCount;
+            }
+
+            value = static_cast<uint32_t>(result);
+            return digitCount > 0;
+        }
+
+        bool IsBinary(const char type)
+        {
+            return type == '5' || type == '6';
+        }
+
+        size_t GetChannelCount(const char type)
+        {
+            return type == '3' || type == '6' ? 3 : 1;
+        }
+
+        ResultCode ParseHeader(const uint8_t* data, const size_t size, Header& header, size_t& pixelDataOffset)
+        {
+            if(data == nullptr || size < 2)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+            if(data[0] != 'P' || data[1] < '1' || data[1] > '7')
+            {
+                return ResultCode::InvalidSignature;
+            }
+
+            header = {};
+            header.type = static_cast<char>(data[1]);
+            if(header.type != '2' && header.type != '3' && header.type != '5' && header.type != '6')
+            {
+                return ResultCode::UnsupportedFormat;
+            }
+
+            size_t offset = 2;
+            if(offset == size)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+            if(!IsWhitespace(data[offset]) && data[offset] != '#')
+            {
+                return ResultCode::InvalidSignature;
+            }
+
+            if(!ReadValue(data, size, offset, header.width) ||
+               !ReadValue(data, size, offset, header.height) ||
+               !ReadValue(data, size, offset, header.maxValue))
+            {
+                return offset >= size ? ResultCode::UnexpectedEndOfFile : ResultCode::InvalidHeader;
+            }
+            if(header.width == 0 || header.height == 0 || header.maxValue == 0 || header.maxValue > 65535)
+            {
+                return ResultCode::InvalidHeader;
+            }
+
+            // A single whitespace character separates the header from binary samples.
+            if(offset == size || !IsWhitespace(data[offset]))
+            {
+                return offset == size ? ResultCode::UnexpectedEndOfFile : ResultCode::InvalidHeader;
+            }
+            pixelDataOffset = offset + 1;
+
+            if(IsBinary(header.type))
+            {
+                const size_t sampleSize = header.maxValue > 255 ? 2 : 1;
+                const auto pixelDataSize = static_cast<size_t>(header.width) * header.height * GetChannelCount(header.type) * sampleSize;
+                if(size - pixelDataOffset < pixelDataSize)
+                {
+                    return ResultCode::UnexpectedEndOfFile;
+                }
+            }
+
+            return ResultCode::Successful;
+        }
+
+    }
+
+    bool IsPnmData(const uint8_t* data, const size_t size)
+    {
+        return data != nullptr && size >= 3 && data[0] == 'P' && 
+            (data[1] == '2' || data[1] == '3' || data[1] == '5' || data[1] == '6') && 
+            (IsWhitespace(data[2]) || data[2] == '#');
+    }
+
+
+    // Decoder implementations.
+    Decoder::Decoder() :
+        m_mappedFile{},
+        m_header{},
+        m_data(nullptr),
+        m_size(0),
+        m_pixelDataOffset(0)
+    {}
+
+    ResultCode Decoder::Open(const std::filesystem::path& filename)
+    {
+        Close();
+
+        if(!m_mappedFile.Open(filename))
+        {
+            return ResultCode::CannotOpenFile;
+        }
+
+        const auto result = Open(reinterpret_cast<const uint8_t*>(m_mappedFile.GetData()), m_mappedFile.GetSize());
+        if(result != ResultCode::Successful)
+        {
+            m_mappedFile.Close();
+        }
+        return result;
+    }
+
+    ResultCode Decoder::Open(const uint8_t* data, const size_t size)
+    {
+        m_data = nullptr;
+        m_size = 0;
+
+        const auto result = ParseHeader(data, size, m_header, m_pixelDataOffset);
+        if(result == ResultCode::Successful)
+        {
+            m_data = data;
+            m_size = size;
+        }
+        return result;
+    }
+
+    void Decoder::Close()
+    {
+        m_mappedFile.Close();
+        m_header = {};
+        m_data = nullptr;
+        m_size = 0;
+        m_pixelDataOffset = 0;
+    }
+
+    bool Decoder::IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    const Header& Decoder::GetHeader() const
+    {
+        return m_header;
+    }
+
+    uint32_t Decoder::GetWidth() const
+    {
+        return IsOpen() ? m_header.width : 0;
+    }
+
+    uint32_t Decoder::GetHeight() const
+    {
+        return IsOpen() ? m_header.height : 0;
+    }
+
+    ResultCode Decoder::Decode(const ImageFormat format, uint8_t* destination, const size_t destinationSize) const
+    {
+        if(!IsOpen())
+        {
+            return ResultCode::UnexpectedEndOfFile;
+        }
+
+        const auto optionalLayout = PixelConversion::GetLayout(format);
+        if(!optionalLayout)
+        {
+            return ResultCode::UnsupportedFormat;
+        }
+        const auto& layout = *optionalLayout;
+
+        const size_t width = m_header.width;
+        const size_t height = m_header.height;
+        const auto destinationStride = width * layout.channelCount;
+        if(destination == nullptr || destinationSize < destinationStride * height)
+        {
+            return ResultCode::BufferTooSmall;
+        }
+
+        const auto channelCount = GetChannelCount(m_header.type);
+        const auto maxValue = m_header.maxValue;
+        const auto* data = m_data + m_pixelDataOffset;
+
+        // Binary 8-bit samples of full range are converted row by row, without scaling.
+        if(IsBinary(m_header.type) && maxValue == 255)
+        {
+            const auto stride = width * channelCount;
+            for(size_t y = 0; y < height; y++)
+            {
+                PixelConversion::ConvertRow(data + y * stride, channelCount, destination + y * destinationStride, layout.channelCount, layout.bgr, true, width);
+            }
+            return ResultCode::Successful;
+        }
+
+        auto scale = [maxValue](const uint32_t sample)
+        {
+            return static_cast<uint8_t>((static_cast<uint64_t>(std::min(sample, maxValue)) * 255 + maxValue / 2) / maxValue);
+        };
+
+        size_t offset = m_pixelDataOffset;
+        auto readSample = [&](uint32_t& sample)
+        {
+            if(!IsBinary(m_header.type))
+            {
+                return ReadValue(m_data, m_size, offset, sample);
+            }
+            if(maxValue > 255)
+            {
+                sample = static_cast<uint32_t>((m_data[offset] << 8) | m_data[offset + 1]);
+                offset += 2;
+            }
+            else
+            {
+                sample = m_data[offset++];
+            }
+            return true;
+        };
+
+        const size_t pixelCount = width * height;
+        std::array<uint32_t, 3> samples = {};
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            for(size_t c = 0; c < channelCount; c++)
+            {
+                if(!readSample(samples[c]))
+                {
+                    return ResultCode::UnexpectedEndOfFile;
+                }
+            }
+
+            const auto red = scale(samples[0]);
+            const auto green = channelCount == 3 ? scale(samples[1]) : red;
+            const auto blue = channelCount == 3 ? scale(samples[2]) : red;
+            PixelConversion::StorePixel(destination + i * layout.channelCount, layout, red, green, blue, 255);
+        }
+        return ResultCode::Successful;
+    }
+
+}
@@ -0,0 +1,381 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/FileFormat/Image/TgaFormat.hpp"
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace Molten::Formats::Tga
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        constexpr uint8_t RightToLeftBit = 0x10;
+        constexpr uint8_t TopDownBit = 0x20;
+        constexpr uint8_t AlphaBitsMask = 0x0F;
+
+        uint16_t ReadUint16(const uint8_t* data)
+        {
+            return static_cast<uint16_t>(data[0] | (data[1] << 8));
+        }
+
+        bool IsRunLengthEncoded(const ImageType imageType)
+        {
+            return imageType == ImageType::RleColorMapped || imageType == ImageType::RleTrueColor || imageType == ImageType::RleGrayscale;
+        }
+
+        size_t GetBytesPerPixel(const uint8_t depth)
+        {
+            return (static_cast<size_t>(depth) + 7) / 8;
+        }
+
+        /** Decodes a 15, 16, 24 or 32-bit BGR(A) pixel. */
+        void StoreColor(uint8_t* destination, const PixelConversion::Layout& layout, const uint8_t* source, const uint8_t depth, const bool useAlpha)
+        {
+            if(depth <= 16)
+            {
+                const auto value = ReadUint16(source);
+                auto expand = [](const uint32_t channel) { return static_cast<uint8_t>((channel * 255 + 15) / 31); };
+                const uint8_t alpha = depth == 16 && useAlpha ? ((value & 0x8000) ? 255 : 0) : 255;
+                PixelConversion::StorePixel(destination, layout, expand((value >> 10) & 31), expand((value >> 5) & 31), expand(value & 31), alpha);
+                return;
+            }
+
+            PixelConversion::StorePixel(destination, layout, source[2], source[1], source[0], depth == 32 && useAlpha ? source[3] : 255);
+        }
+
+        ResultCode ParseHeader(const uint8_t* data, const size_t size, Header& header, size_t& colorMapOffset, size_t& pixelDataOffset)
+        {
+            if(data == nullptr || size < Header::Size)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+
+            header.idLength = data[0];
+            header.colorMapType = data[1];
+            header.imageType = static_cast<ImageType>(data[2]);
+            header.colorMapFirstEntry = ReadUint16(data + 3);
+            header.colorMapLength = ReadUint16(data + 5);
+            header.colorMapEntrySize = data[7];
+            header.xOrigin = ReadUint16(data + 8);
+            header.yOrigin = ReadUint16(data + 10);
+            header.width = ReadUint16(data + 12);
+            header.height = ReadUint16(data + 14);
+            header.pixelDepth = data[16];
+            header.imageDescriptor = data[17];
+
+            if(header.colorMapType > 1 || header.width == 0 || header.height == 0)
+            {
+                return ResultCode::InvalidHeader;
+            }
+
+            const auto depth = header.pixelDepth;
+            switch(header.imageType)
+            {
+                case ImageType::TrueColor:
+                case ImageType::RleTrueColor:
+                {
+                    if(depth != 15 && depth != 16 && depth != 24 && depth != 32)
+                    {
+                        return ResultCode::UnsupportedFormat;
+                    }
+                } break;
+                case ImageType::Grayscale:
+                case ImageType::RleGrayscale:
+                {
+                    if(depth != 8)
+                    {
+                        return ResultCode::UnsupportedFormat;
+                    }
+                } break;
+                case ImageType::ColorMapped:
+                case ImageType::RleColorMapped:
+                {
+                    const auto entrySize = header.colorMapEntrySize;
+                    if(header.colorMapType != 1)
+                    {
+                        return ResultCode::InvalidHeader;
+                    }
+                    if(depth != 8 || (entrySize != 15 && entrySize != 16 && entrySize != 24 && entrySize != 32))
+                    {
+                        return ResultCode::UnsupportedFormat;
+                    }
+                } break;
+                case ImageType::None: return ResultCode::InvalidHeader;
+                default: return ResultCode::UnsupportedFormat;
+            }
+
+            if(header.imageDescriptor & RightToLeftBit)
+            {
+                return ResultCode::UnsupportedFormat;
+            }
+
+            colorMapOffset = Header::Size + header.idLength;
+            const auto colorMapSize = header.colorMapType == 1 ? 
+                static_cast<size_t>(header.colorMapLength) * GetBytesPerPixel(header.colorMapEntrySize) : size_t{ 0 };
+            pixelDataOffset = colorMapOffset + colorMapSize;
+            if(size < pixelDataOffset)
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+
+            if(!IsRunLengthEncoded(header.imageType))
+            {
+                const auto pixelDataSize = static_cast<size_t>(header.width) * header.height * GetBytesPerPixel(depth);
+                if(size - pixelDataOffset < pixelDataSize)
+                {
+                    return ResultCode::UnexpectedEndOfFile;
+                }
+            }
+
+            return ResultCode::Successful;
+        }
+
+        /** Decompresses RLE packets into raw pixels, which may span multiple rows. */
+        bool Decompress(const uint8_t* data, const size_t size, const size_t bytesPerPixel, uint8_t* destination, const size_t pixelCount)
+        {
+            const auto* end = data + size;
+            size_t pixel = 0;
+            while(pixel < pixelCount)
+            {
+                if(data == end)
+                {
+                    return false;
+                }
+
+                const auto packet = *data++;
+                const auto count = std::min(static_cast<size_t>(packet & 0x7F) + 1, pixelCount - pixel);
+                auto* dst = destination + pixel * bytesPerPixel;
+
+                if(packet & 0x80)
+                {
+                    if(static_cast<size_t>(end - data) < bytesPerPixel)
+                    {
+                        return false;
+                    }
+                    for(size_t i = 0; i < count; i++)
+                    {
+                        std::memcpy(dst + i * bytesPerPixel, data, bytesPerPixel);
+                    }
+                    data += bytesPerPixel;
+                }
+                else
+                {
+                    const auto rawSize = count * bytesPerPixel;
+                    if(static_cast<size_t>(end - data) < rawSize)
+                    {
+                        return false;
+                    }
+                    std::memcpy(dst, data, rawSize);
+                    data += rawSize;
+                }
+
+                pixel += count;
+            }
+            return true;
+        }
+
+    }
+
+    bool IsTgaData(const uint8_t* data, const size_t size)
+    {
+        Header header;
+        size_t colorMapOffset = 0;
+        size_t pixelDataOffset = 0;
+        return ParseHeader(data, size, header, colorMapOffset, pixelDataOffset) == ResultCode::Successful;
+    }
+
+
+    // Decoder implementations.
+    Decoder::Decoder() :
+        m_mappedFile{},
+        m_header{},
+        m_data(nullptr),
+        m_size(0),
+        m_colorMapOffset(0),
+        m_pixelDataOffset(0)
+    {}
+
+    ResultCode Decoder::Open(const std::filesystem::path& filename)
+    {
+        Close();
+
+        if(!m_mappedFile.Open(filename))
+        {
+            return ResultCode::CannotOpenFile;
+        }
+
+        const auto result = Open(reinterpret_cast<const uint8_t*>(m_mappedFile.GetData()), m_mappedFile.GetSize());
+        if(result != ResultCode::Successful)
+        {
+            m_mappedFile.Close();
+        }
+        return result;
+    }
+
+    ResultCode Decoder::Open(const uint8_t* data, const size_t size)
+    {
+        m_data = nullptr;
+        m_size = 0;
+
+        const auto result = ParseHeader(data, size, m_header, m_colorMapOffset, m_pixelDataOffset);
+        if(result == ResultCode::Successful)
+        {
+            m_data = data;
+            m_size = size;
+        }
+        return result;
+    }
+
+    void Decoder::Close()
+    {
+        m_mappedFile.Close();
+        m_header = {};
+        m_data = nullptr;
+        m_size = 0;
+        m_colorMapOffset = 0;
+        m_pixelDataOffset = 0;
+    }
+
+    bool Decoder::IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+
+    const Header& Decoder::GetHeader() const
+    {
+        return m_header;
+    }
+
+    uint32_t Decoder::GetWidth() const
+    {
+        return IsOpen() ? m_header.width : 0;
+    }
+
+    uint32_t Decoder::GetHeight() const
+    {
+        return IsOpen() ? m_header.height : 0;
+    }
+
+    ResultCode Decoder::Decode(const ImageFormat format, uint8_t* destination, const size_t destinationSize) const
+    {
+        if(!IsOpen())
+        {
+            return ResultCode::UnexpectedEndOfFile;
+        }
+
+        const auto optionalLayout = PixelConversion::GetLayout(format);
+        if(!optionalLayout)
+        {
+            return ResultCode::UnsupportedFormat;
+        }
+        const auto& layout = *optionalLayout;
+
+        const size_t width = m_header.width;
+        const size_t height = m_header.height;
+        const auto destinationStride = width * layout.channelCount;
+        if(destination == nullptr || destinationSize < destinationStride * height)
+        {
+            return ResultCode::BufferTooSmall;
+        }
+
+        const auto depth = m_header.pixelDepth;
+        const auto bytesPerPixel = GetBytesPerPixel(depth);
+        const auto stride = width * bytesPerPixel;
+
+        const uint8_t* pixelData = m_data + m_pixelDataOffset;
+        std::vector<uint8_t> decompressed;
+        if(IsRunLengthEncoded(m_header.imageType))
+        {
+            decompressed.resize(stride * height);
+            if(!Decompress(pixelData, m_size - m_pixelDataOffset, bytesPerPixel, decompressed.data(), width * height))
+            {
+                return ResultCode::UnexpectedEndOfFile;
+            }
+            pixelData = decompressed.data();
+        }
+
+        const bool topDown = (m_header.imageDescriptor & TopDownBit) != 0;
+        const bool useAlpha = (m_header.imageDescriptor & AlphaBitsMask) != 0;
+        auto getSourceRow = [&](const size_t y)
+        {
+            return pixelData + (topDown ? y : height - 1 - y) * stride;
+        };
+
+        const auto imageType = m_header.imageType;
+        if(imageType == ImageType::ColorMapped || imageType == ImageType::RleColorMapped)
+        {
+            std::array<std::array<uint8_t, 4>, 256> palette = {};
+            const auto entrySize = GetBytesPerPixel(m_header.colorMapEntrySize);
+            for(size_t i = 0; i < palette.size(); i++)
+            {
+                const auto entry = i - m_header.colorMapFirstEntry;
+                if(i < m_header.colorMapFirstEntry || entry >= m_header.colorMapLength)
+                {
+                    PixelConversion::StorePixel(palette[i].data(), { 4, layout.bgr }, 0, 0, 0, 255);
+                    continue;
+                }
+                StoreColor(palette[i].data(), { 4, layout.bgr }, m_data + m_colorMapOffset + entry * entrySize, m_header.colorMapEntrySize, useAlpha);
+            }
+
+            for(size_t y = 0; y < height; y++)
+            {
+                const auto* source = getSourceRow(y);
+                auto* dst = destination + y * destinationStride;
+                for(size_t x = 0; x < width; x++)
+                {
+                    std::memcpy(dst + x * layout.channelCount, palette[source[x]].data(), layout.channelCount);
+                }
+            }
+            return ResultCode::Successful;
+        }
+
+        if(depth == 8 || depth == 24 || depth == 32)
+        {
+            for(size_t y = 0; y < height; y++)
+            {
+                PixelConversion::ConvertRow(getSourceRow(y), bytesPerPixel, destination + y * destinationStride, layout.channelCount, !layout.bgr, !useAlpha, width);
+            }
+            return ResultCode::Successful;
+        }
+
+        for(size_t y = 0; y < height; y++)
+        {
+            const auto* source = getSourceRow(y);
+            auto* dst = destination + y * destinationStride;
+            for(size_t x = 0; x < width; x++)
+            {
+                StoreColor(dst + x * layout.channelCount, layout, source + x * bytesPerPixel, depth, useAlpha);
+            }
+        }
+        return ResultCode::Successful;
+    }
+
+}
@@ -0,0 +1,1030 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/FileFormat/Mesh/MeshCacheFile.hpp"
+#include "Molten/Utility/Lz4.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint32_t MeshCacheMagic = 0x48534D4D; ///< "MMSH"
+    static constexpr uint64_t MeshCacheAlignment = 16;
+
+    struct MeshCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t fileSize;
+        uint64_t sourceSize;
+        int64_t sourceModifiedTime;
+        uint64_t sourceHash;
+        uint64_t settingsHash;
+        uint32_t meshCount;
+        uint32_t submeshCount;
+        uint32_t lodCount;
+        uint32_t materialCount;
+        uint32_t vertexSize;
+        uint32_t meshletCount;
+        uint32_t dependencyCount;
+        uint32_t reserved;
+        uint64_t meshTableOffset;
+        uint64_t submeshTableOffset;
+        uint64_t lodTableOffset;
+        uint64_t meshletTableOffset;
+        uint64_t materialTableOffset;
+        uint64_t dependencyTableOffset;
+        uint64_t stringDataOffset;
+        uint64_t stringDataSize;
+    };
+
+    struct MeshCacheMeshRecord
+    {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t firstSubmesh;
+        uint32_t submeshCount;
+        float boundsLow[3];
+        float boundsHigh[3];
+    };
+
+    struct MeshCacheSubmeshRecord
+    {
+        uint32_t materialIndex;
+        uint32_t indexDataType;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint64_t vertexDataOffset;
+        uint64_t indexDataOffset;
+        float boundsLow[3];
+        float boundsHigh[3];
+        uint32_t firstLod;
+        uint32_t lodCount;
+        uint32_t firstMeshlet;
+        uint32_t meshletCount;
+        uint32_t meshletVertexCount;
+        uint32_t meshletTriangleIndexCount;
+        uint64_t meshletVertexDataOffset;
+        uint64_t meshletTriangleDataOffset;
+    };
+
+    struct MeshCacheLodRecord
+    {
+        uint32_t indexDataType;
+        uint32_t indexCount;
+        uint64_t indexDataOffset;
+        float error;
+        uint32_t reserved;
+    };
+
+    struct MeshCacheMeshletRecord
+    {
+        uint32_t vertexOffset;
+        uint32_t vertexCount;
+        uint32_t triangleOffset;
+        uint32_t triangleCount;
+        float center[3];
+        float radius;
+        float boundsLow[3];
+        float boundsHigh[3];
+        float coneApex[3];
+        float coneAxis[3];
+        float coneCutoff;
+    };
+
+    static constexpr uint32_t MeshCacheMaterialAmbientColor = 1 << 0;
+    static constexpr uint32_t MeshCacheMaterialDiffuseColor = 1 << 1;
+    static constexpr uint32_t MeshCacheMaterialSpecularColor = 1 << 2;
+    static constexpr uint32_t MeshCacheMaterialSpecularWeight = 1 << 3;
+    static constexpr uint32_t MeshCacheMaterialTransparency = 1 << 4;
+    static constexpr uint32_t MeshCacheMaterialOpticalDensity = 1 << 5;
+    static constexpr uint32_t MeshCacheMaterialRoughness = 1 << 6;
+    static constexpr uint32_t MeshCacheMaterialMetallic = 1 << 7;
+    static constexpr uint32_t MeshCacheMaterialFirstTexture = 1 << 8; ///< Flag of first texture, following textures use the next bits.
+
+    static constexpr uint32_t MeshCacheTextureModifier = 1 << 0;
+    static constexpr uint32_t MeshCacheTextureOriginOffset = 1 << 1;
+    static constexpr uint32_t MeshCacheTextureScale = 1 << 2;
+    static constexpr uint32_t MeshCacheTextureClamp = 1 << 3;
+
+    /** Textures of materials, in order of texture records. */
+    static constexpr std::array<std::optional<MeshCacheFile::MaterialTexture> MeshCacheFile::Material::*, 8> MeshCacheMaterialTextures = {
+        &MeshCacheFile::Material::ambientTexture,
+        &MeshCacheFile::Material::diffuseTexture,
+        &MeshCacheFile::Material::specularTexture,
+        &MeshCacheFile::Material::specularWeightTexture,
+        &MeshCacheFile::Material::alphaTexture,
+        &MeshCacheFile::Material::displacementTexture,
+        &MeshCacheFile::Material::roughnessTexture,
+        &MeshCacheFile::Material::metallicTexture
+    };
+
+    struct MeshCacheTextureRecord
+    {
+        uint32_t pathOffset;
+        uint32_t pathSize;
+        uint32_t flags;
+        uint32_t clamp;
+        float modifier[2];
+        float originOffset[3];
+        float scale[3];
+    };
+
+    struct MeshCacheMaterialRecord
+    {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t flags;
+        uint32_t reserved;
+        float ambientColor[3];
+        float diffuseColor[3];
+        float specularColor[3];
+        float specularWeight;
+        float transparency;
+        float opticalDensity;
+        float roughness;
+        float metallic;
+        MeshCacheTextureRecord textures[MeshCacheMaterialTextures.size()];
+    };
+
+    struct MeshCacheDependencyRecord
+    {
+        uint32_t pathOffset;
+        uint32_t pathSize;
+        uint64_t size;
+        int64_t modifiedTime;
+        uint64_t hash;
+    };
+
+    static_assert(sizeof(MeshCacheHeader) == 144, "Unexpected padding of mesh cache header.");
+    static_assert(sizeof(MeshCacheMeshRecord) == 40, "Unexpected padding of mesh cache mesh record.");
+    static_assert(sizeof(MeshCacheSubmeshRecord) == 96, "Unexpected padding of mesh cache sub-mesh record.");
+    static_assert(sizeof(MeshCacheLodRecord) == 24, "Unexpected padding of mesh cache level of detail record.");
+    static_assert(sizeof(MeshCacheMeshletRecord) == 84, "Unexpected padding of mesh cache meshlet record.");
+    static_assert(sizeof(MeshCacheTextureRecord) == 48, "Unexpected padding of mesh cache texture record.");
+    static_assert(sizeof(MeshCacheMaterialRecord) == 456, "Unexpected padding of mesh cache material record.");
+    static_assert(sizeof(MeshCacheDependencyRecord) == 32, "Unexpected padding of mesh cache dependency record.");
+    static_assert(sizeof(IndexedMeshVertex) == 48, "Unexpected padding of indexed mesh vertex.");
+
+    static uint64_t AlignMeshCacheOffset(const uint64_t offset)
+    {
+        return (offset + MeshCacheAlignment - 1) & ~(MeshCacheAlignment - 1);
+    }
+
+    static bool IsMeshCacheRangeValid(const uint64_t offset, const uint64_t size, const uint64_t fileSize)
+    {
+        return offset <= fileSize && size <= fileSize - offset;
+    }
+
+    template<typename T>
+    static T ReadMeshCacheRecord(const uint8_t* data, const uint64_t offset)
+    {
+        T record;
+        std::memcpy(&record, data + offset, sizeof(T));
+        return record;
+    }
+
+    template<typename T>
+    static void WriteMeshCacheRecord(MeshCacheFile::Bytes& bytes, const uint64_t offset, const T& record)
+    {
+        std::memcpy(bytes.data() + offset, &record, sizeof(T));
+    }
+
+    static Bounds3f32 CalculateMeshCacheBounds(const IndexedMeshVertices& vertices)
+    {
+        if (vertices.empty())
+        {
+            return {};
+        }
+
+        Bounds3f32 bounds{ vertices.front().position, vertices.front().position };
+        for (const auto& vertex : vertices)
+        {
+            for (size_t i = 0; i < 3; i++)
+            {
+                bounds.low.c[i] = std::min(bounds.low.c[i], vertex.position.c[i]);
+                bounds.high.c[i] = std::max(bounds.high.c[i], vertex.position.c[i]);
+            }
+        }
+
+        return bounds;
+    }
+
+    static void StoreMeshCacheBounds(const Bounds3f32& bounds, float (&low)[3], float (&high)[3])
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            low[i] = bounds.low.c[i];
+            high[i] = bounds.high.c[i];
+        }
+    }
+
+    static Bounds3f32 LoadMeshCacheBounds(const float (&low)[3], const float (&high)[3])
+    {
+        return { { low[0], low[1], low[2] }, { high[0], high[1], high[2] } };
+    }
+
+    static void StoreMeshCacheVector(const Vector3f32& vector, float (&values)[3])
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            values[i] = vector.c[i];
+        }
+    }
+
+    static Vector3f32 LoadMeshCacheVector(const float (&values)[3])
+    {
+        return { values[0], values[1], values[2] };
+    }
+
+    static void StoreMeshCacheOptional(const std::optional<float>& value, float& stored, uint32_t& flags, const uint32_t flag)
+    {
+        if (value.has_value())
+        {
+            stored = value.value();
+            flags |= flag;
+        }
+    }
+
+    static void StoreMeshCacheOptional(const std::optional<Vector2f32>& value, float (&stored)[2], uint32_t& flags, const uint32_t flag)
+    {
+        if (value.has_value())
+        {
+            stored[0] = value->x;
+            stored[1] = value->y;
+            flags |= flag;
+        }
+    }
+
+    static void StoreMeshCacheOptional(const std::optional<Vector3f32>& value, float (&stored)[3], uint32_t& flags, const uint32_t flag)
+    {
+        if (value.has_value())
+        {
+            StoreMeshCacheVector(value.value(), stored);
+            flags |= flag;
+        }
+    }
+
+    static std::optional<float> LoadMeshCacheOptional(const float stored, const uint32_t flags, const uint32_t flag)
+    {
+        return (flags & flag) != 0 ? std::optional<float>{ stored } : std::nullopt;
+    }
+
+    static std::optional<Vector2f32> LoadMeshCacheOptional(const float (&stored)[2], const uint32_t flags, const uint32_t flag)
+    {
+        return (flags & flag) != 0 ? std::optional<Vector2f32>{ Vector2f32{ stored[0], stored[1] } } : std::nullopt;
+    }
+
+    static std::optional<Vector3f32> LoadMeshCacheOptional(const float (&stored)[3], const uint32_t flags, const uint32_t flag)
+    {
+        return (flags & flag) != 0 ? std::optional<Vector3f32>{ LoadMeshCacheVector(stored) } : std::nullopt;
+    }
+
+
+    // Mesh cache file source key implementations.
+    MeshCacheFile::SourceKey::SourceKey() :
+        size(0),
+        modifiedTime(0),
+        hash(0),
+        settingsHash(0)
+    {}
+
+
+    // Mesh cache file sub-mesh implementations.
+    VertexBufferDescriptor MeshCacheFile::Submesh::GetVertexBufferDescriptor() const
+    {
+        return { vertexCount, static_cast<uint32_t>(sizeof(IndexedMeshVertex)), vertices };
+    }
+
+    IndexBufferDescriptor MeshCacheFile::Submesh::GetIndexBufferDescriptor() const
+    {
+        return { indexCount, indexData, indexDataType };
+    }
+
+
+    // Mesh cache file level of detail implementations.
+    IndexBufferDescriptor MeshCacheFile::Lod::GetIndexBufferDescriptor() const
+    {
+        return { indexCount, indexData, indexDataType };
+    }
+
+
+    // Mesh cache file implementations.
+    MeshCacheFile::MeshCacheFile()
+    {}
+
+    MeshCacheFile::Bytes MeshCacheFile::Serialize(
+        const IndexedMeshes& meshes,
+        const SourceKey& sourceKey,
+        const std::vector<Dependency>& dependencies,
+        const std::vector<Material>& materialProperties)
+    {
+        // Collect unique materials and strings.
+        std::vector<std::string_view> materials;
+        std::vector<uint32_t> submeshMaterials;
+        std::string stringData;
+
+        auto addString = [&](const std::string_view string)
+        {
+            const auto offset = static_cast<uint32_t>(stringData.size());
+            stringData.append(string);
+            return offset;
+        };
+
+        size_t submeshCount = 0;
+        size_t lodCount = 0;
+        size_t meshletCount = 0;
+        for (const auto& mesh : meshes)
+        {
+            for (const auto& submesh : mesh.submeshes)
+            {
+                lodCount += submesh.lods.size();
+                meshletCount += submesh.meshlets.size();
+                auto it = std::find(materials.begin(), materials.end(), submesh.material);
+                if (it == materials.end())
+                {
+                    it = materials.insert(materials.end(), submesh.material);
+                }
+                submeshMaterials.push_back(static_cast<uint32_t>(std::distance(materials.begin(), it)));
+                ++submeshCount;
+            }
+        }
+
+        // Calculate layout.
+        MeshCacheHeader header = {};
+        header.magic = MeshCacheMagic;
+        header.version = Version;
+        header.sourceSize = sourceKey.size;
+        header.sourceModifiedTime = sourceKey.modifiedTime;
+        header.sourceHash = sourceKey.hash;
+        header.settingsHash = sourceKey.settingsHash;
+        header.meshCount = static_cast<uint32_t>(meshes.size());
+        header.submeshCount = static_cast<uint32_t>(submeshCount);
+        header.lodCount = static_cast<uint32_t>(lodCount);
+        header.meshletCount = static_cast<uint32_t>(meshletCount);
+        header.materialCount = static_cast<uint32_t>(materials.size());
+        header.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        header.vertexSize = static_cast<uint32_t>(sizeof(IndexedMeshVertex));
+        header.meshTableOffset = AlignMeshCacheOffset(sizeof(MeshCacheHeader));
+        header.submeshTableOffset = AlignMeshCacheOffset(header.meshTableOffset + meshes.size() * sizeof(MeshCacheMeshRecord));
+        header.lodTableOffset = AlignMeshCacheOffset(header.submeshTableOffset + submeshCount * sizeof(MeshCacheSubmeshRecord));
+        header.meshletTableOffset = AlignMeshCacheOffset(header.lodTableOffset + lodCount * sizeof(MeshCacheLodRecord));
+        header.materialTableOffset = AlignMeshCacheOffset(header.meshletTableOffset + meshletCount * sizeof(MeshCacheMeshletRecord));
+        header.dependencyTableOffset = AlignMeshCacheOffset(header.materialTableOffset + materials.size() * sizeof(MeshCacheMaterialRecord));
+
+        std::vector<MeshCacheMeshRecord> meshRecords;
+        meshRecords.reserve(meshes.size());
+        std::vector<MeshCacheMaterialRecord> materialRecords;
+        materialRecords.reserve(materials.size());
+        std::vector<MeshCacheDependencyRecord> dependencyRecords;
+        dependencyRecords.reserve(dependencies.size());
+
+        uint32_t firstSubmesh = 0;
+        for (const auto& mesh : meshes)
+        {
+            auto& record = meshRecords.emplace_back();
+            record.nameOffset = addString(mesh.name);
+            record.nameSize = static_cast<uint32_t>(mesh.name.size());
+            record.firstSubmesh = firstSubmesh;
+            record.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+            firstSubmesh += record.submeshCount;
+        }
+        for (const auto& materialName : materials)
+        {
+            auto& record = materialRecords.emplace_back();
+            record.nameOffset = addString(materialName);
+            record.nameSize = static_cast<uint32_t>(materialName.size());
+
+            const auto it = std::find_if(materialProperties.begin(), materialProperties.end(), [&](const Material& material)
+            {
+                return material.name == materialName;
+            });
+            if (it == materialProperties.end())
+            {
+                continue;
+            }
+
+            const auto& material = *it;
+            StoreMeshCacheOptional(material.ambientColor, record.ambientColor, record.flags, MeshCacheMaterialAmbientColor);
+            StoreMeshCacheOptional(material.diffuseColor, record.diffuseColor, record.flags, MeshCacheMaterialDiffuseColor);
+            StoreMeshCacheOptional(material.specularColor, record.specularColor, record.flags, MeshCacheMaterialSpecularColor);
+            StoreMeshCacheOptional(material.specularWeight, record.specularWeight, record.flags, MeshCacheMaterialSpecularWeight);
+            StoreMeshCacheOptional(material.transparency, record.transparency, record.flags, MeshCacheMaterialTransparency);
+            StoreMeshCacheOptional(material.opticalDensity, record.opticalDensity, record.flags, MeshCacheMaterialOpticalDensity);
+            StoreMeshCacheOptional(material.roughness, record.roughness, record.flags, MeshCacheMaterialRoughness);
+            StoreMeshCacheOptional(material.metallic, record.metallic, record.flags, MeshCacheMaterialMetallic);
+
+            for (size_t i = 0; i < MeshCacheMaterialTextures.size(); i++)
+            {
+                const auto& texture = material.*MeshCacheMaterialTextures[i];
+                if (!texture.has_value())
+                {
+                    continue;
+                }
+
+                auto& textureRecord = record.textures[i];
+                textureRecord.pathOffset = addString(texture->filename);
+                textureRecord.pathSize = static_cast<uint32_t>(texture->filename.size());
+                StoreMeshCacheOptional(texture->modifier, textureRecord.modifier, textureRecord.flags, MeshCacheTextureModifier);
+                StoreMeshCacheOptional(texture->originOffset, textureRecord.originOffset, textureRecord.flags, MeshCacheTextureOriginOffset);
+                StoreMeshCacheOptional(texture->scale, textureRecord.scale, textureRecord.flags, MeshCacheTextureScale);
+                if (texture->clamp.has_value())
+                {
+                    textureRecord.clamp = texture->clamp.value() ? 1 : 0;
+                    textureRecord.flags |= MeshCacheTextureClamp;
+                }
+                record.flags |= MeshCacheMaterialFirstTexture << i;
+            }
+        }
+        for (const auto& dependency : dependencies)
+        {
+            dependencyRecords.push_back({
+                addString(dependency.filename),
+                static_cast<uint32_t>(dependency.filename.size()),
+                dependency.key.size,
+                dependency.key.modifiedTime,
+                dependency.key.hash });
+        }
+
+        header.stringDataOffset = header.dependencyTableOffset + dependencies.size() * sizeof(MeshCacheDependencyRecord);
+        header.stringDataSize = stringData.size();
+
+        std::vector<MeshCacheSubmeshRecord> submeshRecords;
+        submeshRecords.reserve(submeshCount);
+        std::vector<MeshCacheLodRecord> lodRecords;
+        lodRecords.reserve(lodCount);
+        std::vector<MeshCacheMeshletRecord> meshletRecords;
+        meshletRecords.reserve(meshletCount);
+
+        uint64_t dataOffset = AlignMeshCacheOffset(header.stringDataOffset + header.stringDataSize);
+        for (size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
+        {
+            const auto& mesh = meshes[meshIndex];
+            Bounds3f32 meshBounds;
+            bool hasMeshBounds = false;
+
+            for (const auto& submesh : mesh.submeshes)
+            {
+                const auto bounds = CalculateMeshCacheBounds(submesh.vertices);
+                if (!submesh.vertices.empty())
+                {
+                    meshBounds = hasMeshBounds ? Bounds3f32::Union(meshBounds, bounds) : bounds;
+                    hasMeshBounds = true;
+                }
+
+                auto& record = submeshRecords.emplace_back();
+                record.materialIndex = submeshMaterials[submeshRecords.size() - 1];
+                record.indexDataType = static_cast<uint32_t>(submesh.indexDataType);
+                record.vertexCount = static_cast<uint32_t>(submesh.vertices.size());
+                record.indexCount = static_cast<uint32_t>(submesh.GetIndexCount());
+                record.vertexDataOffset = dataOffset;
+                dataOffset = AlignMeshCacheOffset(dataOffset + submesh.vertices.size() * sizeof(IndexedMeshVertex));
+                record.indexDataOffset = dataOffset;
+                dataOffset = AlignMeshCacheOffset(dataOffset + submesh.indexData.size());
+                StoreMeshCacheBounds(bounds, record.boundsLow, record.boundsHigh);
+
+                record.firstLod = static_cast<uint32_t>(lodRecords.size());
+                record.lodCount = static_cast<uint32_t>(submesh.lods.size());
+                for (const auto& lod : submesh.lods)
+                {
+                    auto& lodRecord = lodRecords.emplace_back();
+                    lodRecord.indexDataType = static_cast<uint32_t>(lod.indexDataType);
+                    lodRecord.indexCount = static_cast<uint32_t>(lod.GetIndexCount());
+                    lodRecord.indexDataOffset = dataOffset;
+                    lodRecord.error = lod.error;
+                    dataOffset = AlignMeshCacheOffset(dataOffset + lod.indexData.size());
+                }
+
+                record.firstMeshlet = static_cast<uint32_t>(meshletRecords.size());
+                record.meshletCount = static_cast<uint32_t>(submesh.meshlets.size());
+                record.meshletVertexCount = static_cast<uint32_t>(submesh.meshletVertices.size());
+                record.meshletTriangleIndexCount = static_cast<uint32_t>(submesh.meshletTriangles.size());
+                record.meshletVertexDataOffset = dataOffset;
+                dataOffset = AlignMeshCacheOffset(dataOffset + submesh.meshletVertices.size() * sizeof(uint32_t));
+                record.meshletTriangleDataOffset = dataOffset;
+                dataOffset = AlignMeshCacheOffset(dataOffset + submesh.meshletTriangles.size());
+
+                for (const auto& meshlet : submesh.meshlets)
+                {
+                    auto& meshletRecord = meshletRecords.emplace_back();
+                    meshletRecord.vertexOffset = meshlet.vertexOffset;
+                    meshletRecord.vertexCount = meshlet.vertexCount;
+                    meshletRecord.triangleOffset = meshlet.triangleOffset;
+                    meshletRecord.triangleCount = meshlet.triangleCount;
+                    StoreMeshCacheVector(meshlet.center, meshletRecord.center);
+                    meshletRecord.radius = meshlet.radius;
+                    StoreMeshCacheBounds(meshlet.bounds, meshletRecord.boundsLow, meshletRecord.boundsHigh);
+                    StoreMeshCacheVector(meshlet.coneApex, meshletRecord.coneApex);
+                    StoreMeshCacheVector(meshlet.coneAxis, meshletRecord.coneAxis);
+                    meshletRecord.coneCutoff = meshlet.coneCutoff;
+                }
+            }
+
+            StoreMeshCacheBounds(meshBounds, meshRecords[meshIndex].boundsLow, meshRecords[meshIndex].boundsHigh);
+        }
+
+        header.fileSize = dataOffset;
+
+        // Write data.
+        Bytes bytes(static_cast<size_t>(header.fileSize), 0);
+        WriteMeshCacheRecord(bytes, 0, header);
+
+        for (size_t i = 0; i < meshRecords.size(); i++)
+        {
+            WriteMeshCacheRecord(bytes, header.meshTableOffset + i * sizeof(MeshCacheMeshRecord), meshRecords[i]);
+        }
+        for (size_t i = 0; i < submeshRecords.size(); i++)
+        {
+            WriteMeshCacheRecord(bytes, header.submeshTableOffset + i * sizeof(MeshCacheSubmeshRecord), submeshRecords[i]);
+        }
+        for (size_t i = 0; i < lodRecords.size(); i++)
+        {
+            WriteMeshCacheRecord(bytes, header.lodTableOffset + i * sizeof(MeshCacheLodRecord), lodRecords[i]);
+        }
+        for (size_t i = 0; i < meshletRecords.size(); i++)
+        {
+            WriteMeshCacheRecord(bytes, header.meshletTableOffset + i * sizeof(MeshCacheMeshletRecord), meshletRecords[i]);
+        }
+        for (size_t i = 0; i < materialRecords.size(); i++)
+        {
+            WriteMeshCacheRecord(bytes, header.materialTableOffset + i * sizeof(MeshCacheMaterialRecord), materialRecords[i]);
+        }
+        for (size_t i = 0; i < dependencyRecords.size(); i++)
+        {
+            WriteMeshCacheRecord(bytes, header.dependencyTableOffset + i * sizeof(MeshCacheDependencyRecord), dependencyRecords[i]);
+        }
+        if (!stringData.empty())
+        {
+            std::memcpy(bytes.data() + header.stringDataOffset, stringData.data(), stringData.size());
+        }
+
+        size_t submeshIndex = 0;
+        for (const auto& mesh : meshes)
+        {
+            for (const auto& submesh : mesh.submeshes)
+            {
+                const auto& record = submeshRecords[submeshIndex++];
+                if (!submesh.vertices.empty())
+                {
+                    std::memcpy(bytes.data() + record.vertexDataOffset, submesh.vertices.data(), submesh.vertices.size() * sizeof(IndexedMeshVertex));
+                }
+                if (!submesh.indexData.empty())
+                {
+                    std::memcpy(bytes.data() + record.indexDataOffset, submesh.indexData.data(), submesh.indexData.size());
+                }
+
+                for (size_t i = 0; i < submesh.lods.size(); i++)
+                {
+                    const auto& lod = submesh.lods[i];
+                    if (!lod.indexData.empty())
+                    {
+                        std::memcpy(bytes.data() + lodRecords[record.firstLod + i].indexDataOffset, lod.indexData.data(), lod.indexData.size());
+                    }
+                }
+
+                if (!submesh.meshletVertices.empty())
+                {
+                    std::memcpy(bytes.data() + record.meshletVertexDataOffset, submesh.meshletVertices.data(), submesh.meshletVertices.size() * sizeof(uint32_t));
+                }
+                if (!submesh.meshletTriangles.empty())
+                {
+                    std::memcpy(bytes.data() + record.meshletTriangleDataOffset, submesh.meshletTriangles.data(), submesh.meshletTriangles.size());
+                }
+            }
+        }
+
+        return bytes;
+    }
+
+    bool MeshCacheFile::WriteToFile(const std::filesystem::path& filename, const Bytes& bytes, const bool compress)
+    {
+        Bytes compressedBytes;
+        if (compress)
+        {
+            compressedBytes = Lz4::CompressFrame(bytes.data(), bytes.size());
+        }
+        const auto& fileBytes = compress ? compressedBytes : bytes;
+
+        const auto threadHash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        auto temporaryFilename = filename;
+        temporaryFilename += "." + std::to_string(threadHash) + ".tmp";
+
+        {
+            std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(fileBytes.data()), static_cast<std::streamsize>(fileBytes.size()));
+            if (!file.good())
+            {
+                file.close();
+                std::error_code errorCode;
+                std::filesystem::remove(temporaryFilename, errorCode);
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(temporaryFilename, filename, errorCode);
+        if (errorCode)
+        {
+            std::filesystem::remove(temporaryFilename, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+
+    MeshCacheFile::ReadResult MeshCacheFile::ReadFromFile(const std::filesystem::path& filename)
+    {
+        Clear();
+
+        if (!m_mappedFile.Open(filename))
+        {
+            return ReadResult::CannotOpenFile;
+        }
+
+        if (Lz4::IsFrame(m_mappedFile.GetData(), m_mappedFile.GetSize()))
+        {
+            auto bytes = Lz4::DecompressFrame(m_mappedFile.GetData(), m_mappedFile.GetSize());
+            m_mappedFile.Close();
+            if (!bytes)
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            return ReadFromBytes(std::move(*bytes));
+        }
+
+        const auto result = Parse(reinterpret_cast<const uint8_t*>(m_mappedFile.GetData()), m_mappedFile.GetSize());
+        if (result != ReadResult::Successful)
+        {
+            Clear();
+        }
+
+        return result;
+    }
+
+    MeshCacheFile::ReadResult MeshCacheFile::ReadFromBytes(Bytes&& bytes)
+    {
+        Clear();
+
+        m_bytes = std::move(bytes);
+
+        const auto result = Parse(m_bytes.data(), m_bytes.size());
+        if (result != ReadResult::Successful)
+        {
+            Clear();
+        }
+
+        return result;
+    }
+
+    bool MeshCacheFile::IsMemoryMapped() const
+    {
+        return m_mappedFile.IsOpen();
+    }
+
+    const MeshCacheFile::SourceKey& MeshCacheFile::GetSourceKey() const
+    {
+        return m_sourceKey;
+    }
+
+    const std::vector<MeshCacheFile::Mesh>& MeshCacheFile::GetMeshes() const
+    {
+        return m_meshes;
+    }
+
+    const std::vector<MeshCacheFile::Submesh>& MeshCacheFile::GetSubmeshes() const
+    {
+        return m_submeshes;
+    }
+
+    const std::vector<MeshCacheFile::Lod>& MeshCacheFile::GetLods() const
+    {
+        return m_lods;
+    }
+
+    const std::vector<IndexedMeshlet>& MeshCacheFile::GetMeshlets() const
+    {
+        return m_meshlets;
+    }
+
+    const std::vector<MeshCacheFile::Material>& MeshCacheFile::GetMaterials() const
+    {
+        return m_materials;
+    }
+
+    const std::vector<MeshCacheFile::Dependency>& MeshCacheFile::GetDependencies() const
+    {
+        return m_dependencies;
+    }
+
+    IndexedMeshes MeshCacheFile::ToIndexedMeshes() const
+    {
+        IndexedMeshes meshes;
+        meshes.reserve(m_meshes.size());
+
+        for (const auto& mesh : m_meshes)
+        {
+            auto& indexedMesh = meshes.emplace_back();
+            indexedMesh.name = mesh.name;
+
+            for (uint32_t i = 0; i < mesh.submeshCount; i++)
+            {
+                const auto& submesh = m_submeshes[mesh.firstSubmesh + i];
+                const auto indexSize = submesh.indexDataType == IndexBuffer::DataType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+                const auto* indexData = static_cast<const uint8_t*>(submesh.indexData);
+
+                auto& indexedSubmesh = indexedMesh.submeshes.emplace_back();
+                indexedSubmesh.material = submesh.material;
+                indexedSubmesh.vertices.assign(submesh.vertices, submesh.vertices + submesh.vertexCount);
+                indexedSubmesh.indexDataType = submesh.indexDataType;
+                indexedSubmesh.indexData.assign(indexData, indexData + submesh.indexCount * indexSize);
+
+                for (uint32_t j = 0; j < submesh.lodCount; j++)
+                {
+                    const auto& lod = m_lods[submesh.firstLod + j];
+                    const auto lodIndexSize = lod.indexDataType == IndexBuffer::DataType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+                    const auto* lodIndexData = static_cast<const uint8_t*>(lod.indexData);
+
+                    auto& indexedLod = indexedSubmesh.lods.emplace_back();
+                    indexedLod.error = lod.error;
+                    indexedLod.indexDataType = lod.indexDataType;
+                    indexedLod.indexData.assign(lodIndexData, lodIndexData + lod.indexCount * lodIndexSize);
+                }
+
+                indexedSubmesh.meshlets.assign(
+                    m_meshlets.begin() + submesh.firstMeshlet,
+                    m_meshlets.begin() + submesh.firstMeshlet + submesh.meshletCount);
+                indexedSubmesh.meshletVertices.assign(submesh.meshletVertices, submesh.meshletVertices + submesh.meshletVertexCount);
+                indexedSubmesh.meshletTriangles.assign(submesh.meshletTriangles, submesh.meshletTriangles + submesh.meshletTriangleIndexCount);
+            }
+        }
+
+        return meshes;
+    }
+
+    void MeshCacheFile::Clear()
+    {
+        m_mappedFile.Close();
+        m_bytes.clear();
+        m_sourceKey = {};
+        m_meshes.clear();
+        m_submeshes.clear();
+        m_lods.clear();
+        m_meshlets.clear();
+        m_materials.clear();
+        m_dependencies.clear();
+    }
+
+    MeshCacheFile::ReadResult MeshCacheFile::Parse(const uint8_t* data, const size_t size)
+    {
+        if (size < sizeof(MeshCacheHeader))
+        {
+            return ReadResult::InvalidFile;
+        }
+
+        const auto header = ReadMeshCacheRecord<MeshCacheHeader>(data, 0);
+        if (header.magic != MeshCacheMagic)
+        {
+            return ReadResult::InvalidFile;
+        }
+        if (header.version != Version || header.vertexSize != sizeof(IndexedMeshVertex))
+        {
+            return ReadResult::IncompatibleVersion;
+        }
+        if (header.fileSize != size ||
+            !IsMeshCacheRangeValid(header.meshTableOffset, uint64_t{ header.meshCount } * sizeof(MeshCacheMeshRecord), size) ||
+            !IsMeshCacheRangeValid(header.submeshTableOffset, uint64_t{ header.submeshCount } * sizeof(MeshCacheSubmeshRecord), size) ||
+            !IsMeshCacheRangeValid(header.lodTableOffset, uint64_t{ header.lodCount } * sizeof(MeshCacheLodRecord), size) ||
+            !IsMeshCacheRangeValid(header.meshletTableOffset, uint64_t{ header.meshletCount } * sizeof(MeshCacheMeshletRecord), size) ||
+            !IsMeshCacheRangeValid(header.materialTableOffset, uint64_t{ header.materialCount } * sizeof(MeshCacheMaterialRecord), size) ||
+            !IsMeshCacheRangeValid(header.dependencyTableOffset, uint64_t{ header.dependencyCount } * sizeof(MeshCacheDependencyRecord), size) ||
+            !IsMeshCacheRangeValid(header.stringDataOffset, header.stringDataSize, size))
+        {
+            return ReadResult::InvalidFile;
+        }
+
+        const auto* stringData = reinterpret_cast<const char*>(data + header.stringDataOffset);
+        auto readString = [&](const uint32_t offset, const uint32_t stringSize, std::string_view& string)
+        {
+            if (!IsMeshCacheRangeValid(offset, stringSize, header.stringDataSize))
+            {
+                return false;
+            }
+            string = std::string_view{ stringData + offset, stringSize };
+            return true;
+        };
+
+        m_materials.resize(header.materialCount);
+        for (uint32_t i = 0; i < header.materialCount; i++)
+        {
+            const auto record = ReadMeshCacheRecord<MeshCacheMaterialRecord>(data, header.materialTableOffset + uint64_t{ i } * sizeof(MeshCacheMaterialRecord));
+            auto& material = m_materials[i];
+            if (!readString(record.nameOffset, record.nameSize, material.name))
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            material.ambientColor = LoadMeshCacheOptional(record.ambientColor, record.flags, MeshCacheMaterialAmbientColor);
+            material.diffuseColor = LoadMeshCacheOptional(record.diffuseColor, record.flags, MeshCacheMaterialDiffuseColor);
+            material.specularColor = LoadMeshCacheOptional(record.specularColor, record.flags, MeshCacheMaterialSpecularColor);
+            material.specularWeight = LoadMeshCacheOptional(record.specularWeight, record.flags, MeshCacheMaterialSpecularWeight);
+            material.transparency = LoadMeshCacheOptional(record.transparency, record.flags, MeshCacheMaterialTransparency);
+            material.opticalDensity = LoadMeshCacheOptional(record.opticalDensity, record.flags, MeshCacheMaterialOpticalDensity);
+            material.roughness = LoadMeshCacheOptional(record.roughness, record.flags, MeshCacheMaterialRoughness);
+            material.metallic = LoadMeshCacheOptional(record.metallic, record.flags, MeshCacheMaterialMetallic);
+
+            for (size_t j = 0; j < MeshCacheMaterialTextures.size(); j++)
+            {
+                if ((record.flags & (MeshCacheMaterialFirstTexture << j)) == 0)
+                {
+                    continue;
+                }
+
+                const auto& textureRecord = record.textures[j];
+                MaterialTexture texture;
+                if (!readString(textureRecord.pathOffset, textureRecord.pathSize, texture.filename))
+                {
+                    return ReadResult::InvalidFile;
+                }
+                texture.modifier = LoadMeshCacheOptional(textureRecord.modifier, textureRecord.flags, MeshCacheTextureModifier);
+                texture.originOffset = LoadMeshCacheOptional(textureRecord.originOffset, textureRecord.flags, MeshCacheTextureOriginOffset);
+                texture.scale = LoadMeshCacheOptional(textureRecord.scale, textureRecord.flags, MeshCacheTextureScale);
+                if ((textureRecord.flags & MeshCacheTextureClamp) != 0)
+                {
+                    texture.clamp = textureRecord.clamp != 0;
+                }
+                material.*MeshCacheMaterialTextures[j] = texture;
+            }
+        }
+
+        m_dependencies.resize(header.dependencyCount);
+        for (uint32_t i = 0; i < header.dependencyCount; i++)
+        {
+            const auto record = ReadMeshCacheRecord<MeshCacheDependencyRecord>(data, header.dependencyTableOffset + uint64_t{ i } * sizeof(MeshCacheDependencyRecord));
+            auto& dependency = m_dependencies[i];
+            if (!readString(record.pathOffset, record.pathSize, dependency.filename))
+            {
+                return ReadResult::InvalidFile;
+            }
+            dependency.key.size = record.size;
+            dependency.key.modifiedTime = record.modifiedTime;
+            dependency.key.hash = record.hash;
+        }
+
+        m_lods.resize(header.lodCount);
+        for (uint32_t i = 0; i < header.lodCount; i++)
+        {
+            const auto record = ReadMeshCacheRecord<MeshCacheLodRecord>(data, header.lodTableOffset + uint64_t{ i } * sizeof(MeshCacheLodRecord));
+            if (record.indexDataType > static_cast<uint32_t>(IndexBuffer::DataType::Uint32))
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            const auto indexDataType = static_cast<IndexBuffer::DataType>(record.indexDataType);
+            const uint64_t indexSize = indexDataType == IndexBuffer::DataType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+            if (record.indexDataOffset % MeshCacheAlignment != 0 ||
+                !IsMeshCacheRangeValid(record.indexDataOffset, uint64_t{ record.indexCount } * indexSize, size))
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            auto& lod = m_lods[i];
+            lod.error = record.error;
+            lod.indexDataType = indexDataType;
+            lod.indexData = data + record.indexDataOffset;
+            lod.indexCount = record.indexCount;
+        }
+
+        m_meshlets.resize(header.meshletCount);
+        for (uint32_t i = 0; i < header.meshletCount; i++)
+        {
+            const auto record = ReadMeshCacheRecord<MeshCacheMeshletRecord>(data, header.meshletTableOffset + uint64_t{ i } * sizeof(MeshCacheMeshletRecord));
+
+            auto& meshlet = m_meshlets[i];
+            meshlet.vertexOffset = record.vertexOffset;
+            meshlet.vertexCount = record.vertexCount;
+            meshlet.triangleOffset = record.triangleOffset;
+            meshlet.triangleCount = record.triangleCount;
+            meshlet.center = LoadMeshCacheVector(record.center);
+            meshlet.radius = record.radius;
+            meshlet.bounds = LoadMeshCacheBounds(record.boundsLow, record.boundsHigh);
+            meshlet.coneApex = LoadMeshCacheVector(record.coneApex);
+            meshlet.coneAxis = LoadMeshCacheVector(record.coneAxis);
+            meshlet.coneCutoff = record.coneCutoff;
+        }
+
+        m_submeshes.resize(header.submeshCount);
+        for (uint32_t i = 0; i < header.submeshCount; i++)
+        {
+            const auto record = ReadMeshCacheRecord<MeshCacheSubmeshRecord>(data, header.submeshTableOffset + uint64_t{ i } * sizeof(MeshCacheSubmeshRecord));
+            if (record.materialIndex >= header.materialCount || record.indexDataType > static_cast<uint32_t>(IndexBuffer::DataType::Uint32) ||
+                record.firstLod > header.lodCount || record.lodCount > header.lodCount - record.firstLod ||
+                record.firstMeshlet > header.meshletCount || record.meshletCount > header.meshletCount - record.firstMeshlet)
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            const auto indexDataType = static_cast<IndexBuffer::DataType>(record.indexDataType);
+            const uint64_t indexSize = indexDataType == IndexBuffer::DataType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+            if (record.vertexDataOffset % MeshCacheAlignment != 0 || record.indexDataOffset % MeshCacheAlignment != 0 ||
+                !IsMeshCacheRangeValid(record.vertexDataOffset, uint64_t{ record.vertexCount } * sizeof(IndexedMeshVertex), size) ||
+                !IsMeshCacheRangeValid(record.indexDataOffset, uint64_t{ record.indexCount } * indexSize, size) ||
+                record.meshletVertexDataOffset % MeshCacheAlignment != 0 ||
+                !IsMeshCacheRangeValid(record.meshletVertexDataOffset, uint64_t{ record.meshletVertexCount } * sizeof(uint32_t), size) ||
+                !IsMeshCacheRangeValid(record.meshletTriangleDataOffset, record.meshletTriangleIndexCount, size))
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            for (uint32_t j = 0; j < record.meshletCount; j++)
+            {
+                const auto& meshlet = m_meshlets[record.firstMeshlet + j];
+                if (!IsMeshCacheRangeValid(meshlet.vertexOffset, meshlet.vertexCount, record.meshletVertexCount) ||
+                    !IsMeshCacheRangeValid(meshlet.triangleOffset, uint64_t{ meshlet.triangleCount } * 3, record.meshletTriangleIndexCount))
+                {
+                    return ReadResult::InvalidFile;
+                }
+            }
+
+            auto& submesh = m_submeshes[i];
+            submesh.material = m_materials[record.materialIndex].name;
+            submesh.materialIndex = record.materialIndex;
+            submesh.bounds = LoadMeshCacheBounds(record.boundsLow, record.boundsHigh);
+            submesh.vertices = reinterpret_cast<const IndexedMeshVertex*>(data + record.vertexDataOffset);
+            submesh.vertexCount = record.vertexCount;
+            submesh.indexDataType = indexDataType;
+            submesh.indexData = data + record.indexDataOffset;
+            submesh.indexCount = record.indexCount;
+            submesh.firstLod = record.firstLod;
+            submesh.lodCount = record.lodCount;
+            submesh.firstMeshlet = record.firstMeshlet;
+            submesh.meshletCount = record.meshletCount;
+            submesh.meshletVertices = reinterpret_cast<const uint32_t*>(data + record.meshletVertexDataOffset);
+            submesh.meshletVertexCount = record.meshletVertexCount;
+            submesh.meshletTriangles = data + record.meshletTriangleDataOffset;
+            submesh.meshletTriangleIndexCount = record.meshletTriangleIndexCount;
+        }
+
+        m_meshes.resize(header.meshCount);
+        for (uint32_t i = 0; i < header.meshCount; i++)
+        {
+            const auto record = ReadMeshCacheRecord<MeshCacheMeshRecord>(data, header.meshTableOffset + uint64_t{ i } * sizeof(MeshCacheMeshRecord));
+            if (record.firstSubmesh > header.submeshCount || record.submeshCount > header.submeshCount - record.firstSubmesh)
+            {
+                return ReadResult::InvalidFile;
+            }
+
+            auto& mesh = m_meshes[i];
+            if (!readString(record.nameOffset, record.nameSize, mesh.name))
+            {
+                return ReadResult::InvalidFile;
+            }
+            mesh.bounds = LoadMeshCacheBounds(record.boundsLow, record.boundsHigh);
+            mesh.firstSubmesh = record.firstSubmesh;
+            mesh.submeshCount = record.submeshCount;
+        }
+
+        m_sourceKey.size = header.sourceSize;
+        m_sourceKey.modifiedTime = header.sourceModifiedTime;
+        m_sourceKey.hash = header.sourceHash;
+        m_sourceKey.settingsHash = header.settingsHash;
+
+        return ReadResult::Successful;
+    }
+
+}
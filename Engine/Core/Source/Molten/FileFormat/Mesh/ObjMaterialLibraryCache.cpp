@@ -0,0 +1,436 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/FileFormat/Mesh/ObjMaterialLibraryCache.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include "Molten/Utility/Hash.hpp"
+#include "Molten/Utility/TextScanner.hpp"
+#include <algorithm>
+#include <charconv>
+#include <vector>
+
+namespace Molten
+{
+
+    // Global implementations.
+    using ObjMaterial = ObjMeshFile::Material;
+    using ObjMaterialTexture = ObjMeshFile::MaterialTexture;
+
+    static bool ParseMaterialFloat(const std::string_view token, float& value)
+    {
+        return !token.empty() && std::from_chars(token.data(), token.data() + token.size(), value).ec == std::errc();
+    }
+
+    /** Parses 1 to 3 whitespace separated floats, missing components are set to the previous component. */
+    static bool ParseMaterialVector(std::string_view lineView, Vector3f32& value)
+    {
+        size_t count = 0;
+        for (auto token = TextScanner::NextToken(lineView); !token.empty(); token = TextScanner::NextToken(lineView))
+        {
+            if (count == 3 || !ParseMaterialFloat(token, value.c[count]))
+            {
+                return false;
+            }
+            ++count;
+        }
+
+        if (count == 0)
+        {
+            return false;
+        }
+        for (; count < 3; count++)
+        {
+            value.c[count] = value.c[count - 1];
+        }
+        return true;
+    }
+
+    static bool ParseMaterialScalar(std::string_view lineView, float& value)
+    {
+        const auto token = TextScanner::NextToken(lineView);
+        return ParseMaterialFloat(token, value) && TextScanner::NextToken(lineView).empty();
+    }
+
+    /** Parses texture options followed by texture filename. Unsupported options are skipped, including their arguments. */
+    static bool ParseMaterialTexture(std::string_view lineView, ObjMaterialTexture& texture)
+    {
+        std::vector<std::string_view> tokens;
+        for (auto token = TextScanner::NextToken(lineView); !token.empty(); token = TextScanner::NextToken(lineView))
+        {
+            tokens.push_back(token);
+        }
+        if (tokens.empty())
+        {
+            return false;
+        }
+
+        texture.filename = std::string{ tokens.back() };
+        tokens.pop_back();
+
+        auto isOption = [](const std::string_view token)
+        {
+            float value = 0.0f;
+            return token.size() > 1 && token.front() == '-' && !ParseMaterialFloat(token, value);
+        };
+
+        for (size_t i = 0; i < tokens.size();)
+        {
+            if (!isOption(tokens[i]))
+            {
+                return false;
+            }
+
+            const auto option = tokens[i++];
+            const auto firstArgument = i;
+            while (i < tokens.size() && !isOption(tokens[i]))
+            {
+                ++i;
+            }
+            const auto argumentCount = i - firstArgument;
+
+            auto parseArguments = [&](Vector3f32& value, const size_t minCount, const size_t maxCount)
+            {
+                if (argumentCount < minCount || argumentCount > maxCount)
+                {
+                    return false;
+                }
+                for (size_t j = 0; j < argumentCount; j++)
+                {
+                    if (!ParseMaterialFloat(tokens[firstArgument + j], value.c[j]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+
+            if (option == "-mm")
+            {
+                Vector3f32 value = { 0.0f, 1.0f, 0.0f };
+                if (!parseArguments(value, 1, 2))
+                {
+                    return false;
+                }
+                texture.options.modifier = Vector2f32{ value.x, value.y };
+            }
+            else if (option == "-o")
+            {
+                Vector3f32 value = { 0.0f, 0.0f, 0.0f };
+                if (!parseArguments(value, 1, 3))
+                {
+                    return false;
+                }
+                texture.options.originOffset = value;
+            }
+            else if (option == "-s")
+            {
+                Vector3f32 value = { 1.0f, 1.0f, 1.0f };
+                if (!parseArguments(value, 1, 3))
+                {
+                    return false;
+                }
+                texture.options.scale = value;
+            }
+            else if (option == "-clamp")
+            {
+                if (argumentCount != 1 || (tokens[firstArgument] != "on" && tokens[firstArgument] != "off"))
+                {
+                    return false;
+                }
+                texture.options.clamp = tokens[firstArgument] == "on";
+            }
+        }
+
+        return true;
+    }
+
+    static TextFileFormatResult ParseMaterialLine(
+        std::string_view line,
+        const size_t lineNumber,
+        std::vector<ObjMaterial>& materials)
+    {
+        line = TextScanner::StripComment(line);
+        const auto command = TextScanner::NextToken(line);
+        if (command.empty())
+        {
+            return {};
+        }
+
+        if (command == "newmtl")
+        {
+            TextScanner::TrimWhitespaceFront(line);
+            if (line.empty())
+            {
+                return { TextFileFormatResult::ParseError, lineNumber, "Expecting material name" };
+            }
+
+            materials.emplace_back().name = std::string{ line };
+            return {};
+        }
+
+        using ColorMember = std::optional<Vector3f32> ObjMaterial::*;
+        using ScalarMember = std::optional<float> ObjMaterial::*;
+        using TextureMember = std::optional<ObjMaterialTexture> ObjMaterial::*;
+
+        ColorMember colorMember = nullptr;
+        ScalarMember scalarMember = nullptr;
+        TextureMember textureMember = nullptr;
+
+        if (command == "Ka") { colorMember = &ObjMaterial::ambientColor; }
+        else if (command == "Kd") { colorMember = &ObjMaterial::diffuseColor; }
+        else if (command == "Ks") { colorMember = &ObjMaterial::specularColor; }
+        else if (command == "Ns") { scalarMember = &ObjMaterial::specularWeight; }
+        else if (command == "d" || command == "Tr") { scalarMember = &ObjMaterial::transparency; }
+        else if (command == "Ni") { scalarMember = &ObjMaterial::opticalDensity; }
+        else if (command == "Pr") { scalarMember = &ObjMaterial::roughness; }
+        else if (command == "Pm") { scalarMember = &ObjMaterial::metallic; }
+        else if (command == "map_Ka") { textureMember = &ObjMaterial::ambientTexture; }
+        else if (command == "map_Kd") { textureMember = &ObjMaterial::diffuseTexture; }
+        else if (command == "map_Ks") { textureMember = &ObjMaterial::specularTexture; }
+        else if (command == "map_Ns") { textureMember = &ObjMaterial::specularWeightTexture; }
+        else if (command == "map_d") { textureMember = &ObjMaterial::alphaTexture; }
+        else if (command == "disp") { textureMember = &ObjMaterial::displacementTexture; }
+        else if (command == "map_Pr") { textureMember = &ObjMaterial::roughnessTexture; }
+        else if (command == "map_Pm") { textureMember = &ObjMaterial::metallicTexture; }
+        else
+        {
+            // Unsupported command, i.e. illum, Ke or bump.
+            return {};
+        }
+
+        if (materials.empty())
+        {
+            return { TextFileFormatResult::ParseError, lineNumber, "Material property without newmtl" };
+        }
+        auto& material = materials.back();
+
+        if (colorMember)
+        {
+            // Colors of spectral curves and CIE XYZ are not supported.
+            auto colorView = line;
+            if (const auto firstToken = TextScanner::NextToken(colorView); firstToken == "spectral" || firstToken == "xyz")
+            {
+                return {};
+            }
+
+            Vector3f32 color;
+            if (!ParseMaterialVector(line, color))
+            {
+                return { TextFileFormatResult::ParseError, lineNumber, "Invalid color value" };
+            }
+            material.*colorMember = color;
+        }
+        else if (scalarMember)
+        {
+            float value = 0.0f;
+            if (!ParseMaterialScalar(line, value))
+            {
+                return { TextFileFormatResult::ParseError, lineNumber, "Invalid scalar value" };
+            }
+            material.*scalarMember = command == "Tr" ? 1.0f - value : value;
+        }
+        else
+        {
+            ObjMaterialTexture texture;
+            if (!ParseMaterialTexture(line, texture))
+            {
+                return { TextFileFormatResult::ParseError, lineNumber, "Invalid texture command" };
+            }
+            material.*textureMember = std::move(texture);
+        }
+
+        return {};
+    }
+
+    static bool GetMaterialFileStamp(const std::filesystem::path& filename, uint64_t& size, int64_t& modifiedTime)
+    {
+        std::error_code errorCode;
+        size = static_cast<uint64_t>(std::filesystem::file_size(filename, errorCode));
+        if (errorCode)
+        {
+            return false;
+        }
+
+        const auto lastWriteTime = std::filesystem::last_write_time(filename, errorCode);
+        if (errorCode)
+        {
+            return false;
+        }
+
+        modifiedTime = static_cast<int64_t>(lastWriteTime.time_since_epoch().count());
+        return true;
+    }
+
+
+    // Obj material library cache implementations.
+    const std::shared_ptr<ObjMaterialLibraryCache>& ObjMaterialLibraryCache::GetShared()
+    {
+        static const auto sharedCache = std::make_shared<ObjMaterialLibraryCache>();
+        return sharedCache;
+    }
+
+    ObjMaterialLibraryCache::LoadResult ObjMaterialLibraryCache::ReadFromFile(const std::filesystem::path& filename)
+    {
+        MemoryMappedFile file;
+        if (!file.Open(filename))
+        {
+            return TextFileFormatResult::Error{ TextFileFormatResult::OpenFileError, 0, "Failed to open material file " + filename.string() };
+        }
+
+        return ReadFromData(file.GetView(), filename.string());
+    }
+
+    ObjMaterialLibraryCache::LoadResult ObjMaterialLibraryCache::ReadFromFile(const VirtualFileSystem& virtualFileSystem, const std::string& path)
+    {
+        const auto file = virtualFileSystem.Open(path);
+        if (!file)
+        {
+            return TextFileFormatResult::Error{ TextFileFormatResult::OpenFileError, 0, "Failed to open material file " + path };
+        }
+
+        return ReadFromData(file->GetView(), path);
+    }
+
+    ObjMaterialLibraryCache::LoadResult ObjMaterialLibraryCache::ReadFromData(std::string_view text, const std::string& name)
+    {
+        std::vector<ObjMaterial> materials;
+
+        size_t lineNumber = 0;
+        while (!text.empty())
+        {
+            ++lineNumber;
+
+            const auto lineEnd = std::min(TextScanner::FindNewline(text), text.size());
+            const auto line = text.substr(0, lineEnd);
+
+            // CRLF line endings are a single newline.
+            const auto isCrlf = text.size() > lineEnd + 1 && text[lineEnd] == '\r' && text[lineEnd + 1] == '\n';
+            text.remove_prefix(std::min(lineEnd + (isCrlf ? 2 : 1), text.size()));
+
+            if (auto result = ParseMaterialLine(line, lineNumber, materials); !result)
+            {
+                auto& error = result.GetError();
+                error.message = "Material file " + name + ": " + error.message;
+                return std::move(error);
+            }
+        }
+
+        // Materials are only modified while parsing, then shared as immutable.
+        auto sharedMaterials = std::make_shared<ObjMeshFile::MaterialSharedPointers>();
+        sharedMaterials->reserve(materials.size());
+        for (auto& material : materials)
+        {
+            sharedMaterials->push_back(std::make_shared<const ObjMaterial>(std::move(material)));
+        }
+
+        return MaterialLibrarySharedPointer{ std::move(sharedMaterials) };
+    }
+
+    ObjMaterialLibraryCache::LoadResult ObjMaterialLibraryCache::Load(const std::filesystem::path& filename)
+    {
+        uint64_t size = 0;
+        int64_t modifiedTime = 0;
+        if (!GetMaterialFileStamp(filename, size, modifiedTime))
+        {
+            return TextFileFormatResult::Error{ TextFileFormatResult::OpenFileError, 0, "Failed to open material file " + filename.string() };
+        }
+
+        std::error_code errorCode;
+        const auto canonicalFilename = std::filesystem::weakly_canonical(filename, errorCode);
+        const auto key = (errorCode ? filename : canonicalFilename).generic_string();
+
+        return LoadLibrary(key, size, modifiedTime, 0, [&]()
+        {
+            return ReadFromFile(filename);
+        });
+    }
+
+    ObjMaterialLibraryCache::LoadResult ObjMaterialLibraryCache::Load(const VirtualFileSystem& virtualFileSystem, const std::string& path)
+    {
+        const auto file = virtualFileSystem.Open(path);
+        if (!file)
+        {
+            return TextFileFormatResult::Error{ TextFileFormatResult::OpenFileError, 0, "Failed to open material file " + path };
+        }
+
+        // Material files are small, so hashing is cheap compared to parsing, and also detects modifications not changing the size.
+        const auto key = "vfs:" + VirtualFileSystem::NormalizePath(path);
+        const auto contentHash = Hash64(file->GetData(), file->GetSize());
+
+        return LoadLibrary(key, file->GetSize(), 0, contentHash, [&]()
+        {
+            return ReadFromData(file->GetView(), path);
+        });
+    }
+
+    ObjMaterialLibraryCache::LoadResult ObjMaterialLibraryCache::LoadLibrary(
+        const std::string& key,
+        const uint64_t size,
+        const int64_t modifiedTime,
+        const uint64_t contentHash,
+        const std::function<LoadResult()>& read)
+    {
+        // Parse outside of lock, while concurrent loads of the same file wait for the shared result.
+        std::promise<LoadResult> promise;
+        std::shared_future<LoadResult> cachedResult;
+        {
+            std::scoped_lock lock(m_mutex);
+
+            if (auto it = m_libraries.find(key); it != m_libraries.end() &&
+                it->second.size == size && it->second.modifiedTime == modifiedTime && it->second.contentHash == contentHash)
+            {
+                cachedResult = it->second.result;
+            }
+            else
+            {
+                m_libraries[key] = Library{ size, modifiedTime, contentHash, promise.get_future().share() };
+            }
+        }
+
+        if (cachedResult.valid())
+        {
+            return cachedResult.get();
+        }
+
+        auto result = read();
+        promise.set_value(result);
+        return result;
+    }
+
+    void ObjMaterialLibraryCache::Clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_libraries.clear();
+    }
+
+    size_t ObjMaterialLibraryCache::GetLibraryCount() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_libraries.size();
+    }
+
+}
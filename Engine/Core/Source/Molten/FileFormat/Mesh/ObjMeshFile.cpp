@@ -24,16 +24,30 @@
 */
 
 #include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include "Molten/FileFormat/Mesh/ObjMaterialLibraryCache.hpp"
 #include "Molten/System/ThreadPool.hpp"
 #include "Molten/Utility/StringUtility.hpp"
+#include "Molten/Utility/TextScanner.hpp"
 #include "Molten/Utility/BufferedFileLineReader.hpp"
+#include "Molten/Utility/MemoryMappedFileLineReader.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
 #include <fstream>
 #include <charconv>
+#include <algorithm>
+#include <type_traits>
 
 namespace Molten
 {
 
     // Global implementations.
+    template<typename T>
+    static std::future<T> CreateReadyFuture(T&& value)
+    {
+        std::promise<T> promise;
+        promise.set_value(std::move(value));
+        return promise.get_future();
+    }
+
     static bool IsWhitespace(const size_t index, const std::string_view& stringView)
     {
         return index < stringView.size() && (stringView[index] == ' ' || stringView[index] == '\t');
@@ -50,10 +64,11 @@ namespace Molten
                 return false;
             }
 
-            StringUtility::TrimFront(lineView);
-            const auto end = lineView.find_first_of(" \t");
-            auto element = lineView.substr(0, end);
-            lineView = lineView.substr(element.size());
+            const auto element = TextScanner::NextToken(lineView);
+            if(element.empty())
+            {
+                break;
+            }
 
             if(std::from_chars(element.data(), element.data() + element.size(), value.c[index]).ec != std::errc())
             {
@@ -65,6 +80,125 @@ namespace Molten
         return true;
     }
 
+    template<typename TChunks, typename TData, typename TChunkMember>
+    static void AppendChunkData(TChunks& chunks, TData& data, TChunkMember chunkMember)
+    {
+        size_t size = 0;
+        for(auto& chunk : chunks)
+        {
+            size += (chunk.*chunkMember).size();
+        }
+
+        data = std::move(chunks.front().*chunkMember);
+        data.reserve(size);
+        for(auto it = std::next(chunks.begin()); it != chunks.end(); ++it)
+        {
+            auto& chunkData = (*it).*chunkMember;
+            data.insert(data.end(), chunkData.begin(), chunkData.end());
+        }
+    }
+
+    static TextFileFormatResult ReadFace(std::string_view lineView, ObjMeshFile::Triangles& triangles)
+    {
+        enum class FaceFlags : uint8_t
+        {
+            Vertex = 1,
+            Uv = 2,
+            Normal = 4
+        };
+
+        static const uint8_t indexedFlags[3] = {
+            static_cast<uint8_t>(FaceFlags::Vertex),
+            static_cast<uint8_t>(FaceFlags::Uv),
+            static_cast<uint8_t>(FaceFlags::Normal) };
+
+        static std::array<uint32_t, 3> ObjMeshFile::Triangle::* const triangleMembers[3] = {
+            &ObjMeshFile::Triangle::vertexIndices,
+            &ObjMeshFile::Triangle::textureCoordinateIndices,
+            &ObjMeshFile::Triangle::normalIndices
+        };
+
+        auto readElement = [&](ObjMeshFile::Triangle& triangle, const size_t index) -> uint8_t
+        {
+            uint8_t faceFlags = 0;
+
+            for (size_t i = 0; i < 3; i++)
+            {
+                TextScanner::TrimWhitespaceFront(lineView);
+
+                const size_t endPos = TextScanner::FindWhitespaceOr(lineView, '/');
+
+                auto element = lineView.substr(0, endPos);
+                lineView = std::string_view{ lineView.data() + element.size(), lineView.size() - element.size() };
+
+                if (!element.empty())
+                {
+                    uint32_t value = 0;
+                    if (std::from_chars(element.data(), element.data() + element.size(), value).ec == std::errc())
+                    {
+                        faceFlags |= indexedFlags[i];
+                        (triangle.*triangleMembers[i])[index] = value;
+                    }
+                }
+
+                TextScanner::TrimWhitespaceFront(lineView);
+                if (lineView.empty() || lineView.front() != '/')
+                {
+                    break;
+                }
+                lineView = lineView.substr(1);
+            }
+
+            return faceFlags;
+        };
+
+        auto& triangle = triangles.emplace_back();
+
+        const auto elementLayout = readElement(triangle, 0);
+        if (elementLayout == 0)
+        {
+            return { TextFileFormatResult::ParseError, "Invalid face layout" };
+        }
+
+        for (size_t i = 1; i < 3; i++)
+        {
+            if (auto flags = readElement(triangle, i); flags != elementLayout)
+            {
+                if (flags == 0)
+                {
+                    return { TextFileFormatResult::ParseError, "Invalid face layout" };
+                }
+
+                return { TextFileFormatResult::ParseError, "Mismatching face layout" };
+            }
+        }
+
+        if (!lineView.empty())
+        {
+            auto& nextTriangle = triangles.emplace_back();
+            auto& prevTriangle = triangles[triangles.size() - 2];
+            if (auto flags = readElement(nextTriangle, 0); flags != elementLayout)
+            {
+                if (flags == 0)
+                {
+                    return { TextFileFormatResult::ParseError, "Invalid face layout" };
+                }
+
+                return { TextFileFormatResult::ParseError, "Mismatching face layout" };
+            }
+
+            nextTriangle.vertexIndices[1] = prevTriangle.vertexIndices[0];
+            nextTriangle.textureCoordinateIndices[1] = prevTriangle.textureCoordinateIndices[0];
+            nextTriangle.normalIndices[1] = prevTriangle.normalIndices[0];
+
+            nextTriangle.vertexIndices[2] = prevTriangle.vertexIndices[2];
+            nextTriangle.textureCoordinateIndices[2] = prevTriangle.textureCoordinateIndices[2];
+            nextTriangle.normalIndices[2] = prevTriangle.normalIndices[2];
+        }
+
+        return {};
+    }
+
 
     // Triangle implementations.
     ObjMeshFile::Triangle::Triangle() :
@@ -123,13 +257,19 @@ namespace Molten
 
     void ObjMeshFile::Clear()
     {
+        materials.clear();
+        objects.clear();
     }
 
 
     // Obj mesh file reader implementations.
     ObjMeshFileReader::ObjMeshFileReader() :
+        m_inputMode(InputMode::MemoryMapped),
+        m_objectChunkSize(DefaultObjectChunkSize),
         m_threadPool(nullptr),
-        m_objMeshFile(nullptr)
+        m_onObject(nullptr),
+        m_objMeshFile(nullptr),
+        m_materialLibraryCache(ObjMaterialLibraryCache::GetShared())
     {}
 
     TextFileFormatResult ObjMeshFileReader::ReadFromFile(
@@ -137,14 +277,10 @@ namespace Molten
         const std::filesystem::path& filename)
     {
         m_threadPool = nullptr;
+        m_onObject = nullptr;
 
         auto result = InternalReadFromFile(objMeshFile, filename);
-
-        for (auto& future : m_objectFutures)
-        {
-            future.wait();
-        }
-
+        WaitForObjectFutures();
         return result;
     }
 
@@ -154,17 +290,87 @@ namespace Molten
         ThreadPool& threadPool)
     {
         m_threadPool = &threadPool;
+        m_onObject = nullptr;
 
         auto result = InternalReadFromFile(objMeshFile, filename);
+        WaitForObjectFutures();
+        return result;
+    }
 
-        for (auto& future : m_objectFutures)
-        {
-            future.wait();
-        }
+    TextFileFormatResult ObjMeshFileReader::StreamFromFile(
+        ObjMeshFile& objMeshFile,
+        const std::filesystem::path& filename,
+        const ObjectCallback& onObject)
+    {
+        m_threadPool = nullptr;
+        m_onObject = &onObject;
 
+        auto result = InternalReadFromFile(objMeshFile, filename);
+        WaitForObjectFutures();
+        m_onObject = nullptr;
         return result;
     }
 
+    TextFileFormatResult ObjMeshFileReader::StreamFromFile(
+        ObjMeshFile& objMeshFile,
+        const std::filesystem::path& filename,
+        ThreadPool& threadPool,
+        const ObjectCallback& onObject)
+    {
+        m_threadPool = &threadPool;
+        m_onObject = &onObject;
+
+        auto result = InternalReadFromFile(objMeshFile, filename);
+        WaitForObjectFutures();
+        m_onObject = nullptr;
+        return result;
+    }
+
+    void ObjMeshFileReader::SetInputMode(const InputMode inputMode)
+    {
+        m_inputMode = inputMode;
+    }
+
+    ObjMeshFileReader::InputMode ObjMeshFileReader::GetInputMode() const
+    {
+        return m_inputMode;
+    }
+
+    void ObjMeshFileReader::SetObjectChunkSize(const size_t objectChunkSize)
+    {
+        m_objectChunkSize = objectChunkSize;
+    }
+
+    size_t ObjMeshFileReader::GetObjectChunkSize() const
+    {
+        return m_objectChunkSize;
+    }
+
+    void ObjMeshFileReader::SetMaterialLibraryCache(std::shared_ptr<ObjMaterialLibraryCache> materialLibraryCache)
+    {
+        m_materialLibraryCache = std::move(materialLibraryCache);
+    }
+
+    const std::shared_ptr<ObjMaterialLibraryCache>& ObjMeshFileReader::GetMaterialLibraryCache() const
+    {
+        return m_materialLibraryCache;
+    }
+
+    void ObjMeshFileReader::SetVirtualFileSystem(std::shared_ptr<const VirtualFileSystem> virtualFileSystem)
+    {
+        m_virtualFileSystem = std::move(virtualFileSystem);
+    }
+
+    const std::shared_ptr<const VirtualFileSystem>& ObjMeshFileReader::GetVirtualFileSystem() const
+    {
+        return m_virtualFileSystem;
+    }
+
+    const std::vector<std::string>& ObjMeshFileReader::GetMaterialFilenames() const
+    {
+        return m_materialFilenames;
+    }
+
     ObjMeshFileReader::MaterialCommand::MaterialCommand(
         const size_t lineNumber,
         std::string line
@@ -189,7 +395,39 @@ namespace Molten
     {
         objMeshFile.Clear();
 
-        // Open file and prepare obj mesh file reader.
+        // Read lines directly from data of virtual file.
+        if(m_virtualFileSystem)
+        {
+            const auto file = m_virtualFileSystem->Open(filename.generic_u8string());
+            if(!file)
+            {
+                return { TextFileFormatResult::OpenFileError, "Failed to open file " + filename.string() };
+            }
+
+            Prepare(objMeshFile, filename);
+
+            MemoryMappedFileLineReader lineReader(file->GetView(), file->GetMappedFile());
+            auto result = ReadLines(lineReader);
+
+            // Data of unmapped files, e.g. decompressed archive entries, is only kept alive by the opened file.
+            WaitForObjectFutures();
+            return result;
+        }
+
+        // Map file and read lines directly from mapped memory.
+        if(m_inputMode == InputMode::MemoryMapped)
+        {
+            auto mappedFile = std::make_shared<MemoryMappedFile>();
+            if(mappedFile->Open(filename))
+            {
+                Prepare(objMeshFile, filename);
+
+                MemoryMappedFileLineReader lineReader(std::move(mappedFile));
+                return ReadLines(lineReader);
+            }
+        }
+
+        // Open file and read lines via buffers.
         std::ifstream file(filename, std::ifstream::binary);
         if (!file.is_open())
         {
@@ -198,6 +436,35 @@ namespace Molten
 
         Prepare(objMeshFile, filename);
 
+        BufferedFileLineReader lineReader(file, 2048, 1048576);
+        return ReadLines(lineReader);
+    }
+
+    void ObjMeshFileReader::WaitForObjectFutures()
+    {
+        for (auto& future : m_objectFutures)
+        {
+            future.wait();
+        }
+        m_objectFutures.clear();
+    }
+
+    void ObjMeshFileReader::Prepare(
+        ObjMeshFile& objMeshFile,
+        const std::filesystem::path& filename)
+    {
+        m_objMeshFile = &objMeshFile;
+        m_objMeshDirectory = filename.parent_path();
+        m_materialFilenames.clear();
+        m_materialFutures.clear();
+        m_objectFutures.clear();
+    }
+
+    template<typename TLineReader>
+    TextFileFormatResult ObjMeshFileReader::ReadLines(TLineReader& lineReader)
+    {
+        using LineReadResult = typename TLineReader::LineReadResult;
+
         // Helper function for creating error values.
         size_t lineNumber = 0;
 
@@ -215,26 +482,29 @@ namespace Molten
         ObjectBufferSharedPointer currentObjectBuffer = std::make_shared<ObjectBuffer>();
         auto addNewBuffer = [&currentObjectBuffer](auto& buffer)
         {
+            if constexpr (std::is_same_v<std::decay_t<decltype(buffer)>, MemoryMappedFileLineReader::File>)
+            {
+                currentObjectBuffer->mappedFile = buffer.get();
+            }
             currentObjectBuffer->buffers.push_back(buffer);
         };
 
         // Read lines from file and process them.
-        BufferedFileLineReader lineReader(file, 2048, 1048576);
-        BufferedFileLineReader::LineReadResult readResult = BufferedFileLineReader::LineReadResult::Successful;
+        LineReadResult readResult = LineReadResult::Successful;
 
         onProgress(0.0);
 
-        while(readResult == BufferedFileLineReader::LineReadResult::Successful)
+        while(readResult == LineReadResult::Successful)
         {
             std::string_view line;
             readResult = lineReader.ReadLine(line, addNewBuffer);
 
             switch(readResult)
             {                
-                case BufferedFileLineReader::LineReadResult::BufferOverflow: return { TextFileFormatResult::ParseError, lineNumber, "Row is too long for an obj file" };
-                case BufferedFileLineReader::LineReadResult::AllocationError: return { TextFileFormatResult::ParseError, lineNumber, "Failed to allocate required memory" };
-                case BufferedFileLineReader::LineReadResult::Successful:
-                case BufferedFileLineReader::LineReadResult::EndOfFile: break;
+                case LineReadResult::BufferOverflow: return { TextFileFormatResult::ParseError, lineNumber, "Row is too long for an obj file" };
+                case LineReadResult::AllocationError: return { TextFileFormatResult::ParseError, lineNumber, "Failed to allocate required memory" };
+                case LineReadResult::Successful:
+                case LineReadResult::EndOfFile: break;
             }
 
             StringUtility::Trim(line);
@@ -287,6 +557,7 @@ namespace Molten
                         {
                             newObjectBuffer->buffers.push_back(currentObjectBuffer->buffers.back());
                         }
+                        newObjectBuffer->mappedFile = currentObjectBuffer->mappedFile;
                         currentObjectBuffer = newObjectBuffer;
                     }
 
@@ -306,10 +577,12 @@ namespace Molten
                     {
                         return createMissingCommandDataError();
                     }
-                    currentObjectBuffer->commands.emplace_back(lineNumber, ObjectCommandType::SmoothingGroup, line);
+                    currentObjectBuffer->commands.emplace_back(lineNumber, ObjectCommandType::SmoothingGroup, TextScanner::StripComment(line));
                 } break;
                 case 'v': // Vertex / Normal / UV
                 {
+                    // Numeric commands never contain '#', so trailing comments are stripped. Names of objects, groups and materials may contain '#'.
+                    line = TextScanner::StripComment(line);
                     if (line.size() < 4)
                     {
                         return createUnknownCommandError();
@@ -351,6 +624,7 @@ namespace Molten
                 } break;
                 case 'f':
                 {
+                    line = TextScanner::StripComment(line);
                     if (line.size() < 4)
                     {
                         return createUnknownCommandError();
@@ -384,17 +658,6 @@ namespace Molten
         return {};
     }
 
-    void ObjMeshFileReader::Prepare(
-        ObjMeshFile& objMeshFile,
-        const std::filesystem::path& filename)
-    {
-        m_objMeshFile = &objMeshFile;
-        m_objMeshDirectory = filename.parent_path();
-        m_materialFilenames.clear();
-        m_materialFutures.clear();
-        m_objectFutures.clear();
-    }
-
     TextFileFormatResult ObjMeshFileReader::ExecuteProcessMaterial(MaterialCommand&& materialCommand)
     {
         // Handle all futures and check for errors.
@@ -410,20 +673,28 @@ namespace Molten
         std::vector<std::string> filenames;
         while (!lineView.empty())
         {
-            StringUtility::TrimFront(lineView);
-            const auto end = lineView.find_first_of(" \t");
-            auto filename = lineView.substr(0, end);
-            lineView = std::string_view{ lineView.data() + filename.size(), lineView.size() - filename.size() };
+            const auto filename = TextScanner::NextToken(lineView);
+            if (filename.empty())
+            {
+                continue;
+            }
 
-            if (!filename.empty())
+            // Material files referenced multiple times by the same obj file are only processed once.
+            auto path = (m_objMeshDirectory / std::string{ filename }).generic_string();
+            if (std::find(m_materialFilenames.begin(), m_materialFilenames.end(), path) == m_materialFilenames.end())
             {
-                filenames.push_back((m_objMeshDirectory / std::string{ filename }).generic_string());
+                m_materialFilenames.push_back(path);
+                filenames.push_back(std::move(path));
             }
         }
 
         if (filenames.empty())
         {
-            return { TextFileFormatResult::ParseError, materialCommand.lineNumber, "Expecting one or more material file names" };
+            if (m_materialFilenames.empty())
+            {
+                return { TextFileFormatResult::ParseError, materialCommand.lineNumber, "Expecting one or more material file names" };
+            }
+            return {};
         }
 
         // Use thread pool.
@@ -441,11 +712,10 @@ namespace Molten
         // Execute material processing on this thread.
         for (auto& filename : filenames)
         {
-            auto result = ProcessMaterial(std::move(filename));
+            auto result = ProcessMaterial(filename);
             if (result.index() == 0)
             {
-                auto& material = std::get<MaterialSharedPointer>(result);
-                m_objMeshFile->materials.push_back(material);
+                AddMaterials(std::get<MaterialLibrarySharedPointer>(result));
             }
             else
             {
@@ -457,18 +727,48 @@ namespace Molten
 
         return {};
     }
-    ObjMeshFileReader::ProcessMaterialResult ObjMeshFileReader::ProcessMaterial(std::string&& /*filename*/)
+    ObjMeshFileReader::ProcessMaterialResult ObjMeshFileReader::ProcessMaterial(const std::string& filename) const
     {
-        return { nullptr };
+        auto result = m_virtualFileSystem ?
+            (m_materialLibraryCache ?
+                m_materialLibraryCache->Load(*m_virtualFileSystem, filename) :
+                ObjMaterialLibraryCache::ReadFromFile(*m_virtualFileSystem, filename)) :
+            (m_materialLibraryCache ?
+                m_materialLibraryCache->Load(filename) :
+                ObjMaterialLibraryCache::ReadFromFile(filename));
+
+        // Missing material files are skipped, since the mesh is still usable without its materials.
+        if(result.index() == 1 && std::get<TextFileFormatResult::Error>(result).code == TextFileFormatResult::OpenFileError)
+        {
+            std::error_code errorCode;
+            const auto isMissing = m_virtualFileSystem ?
+                !m_virtualFileSystem->Exists(filename) :
+                !std::filesystem::exists(filename, errorCode) && !errorCode;
+
+            if(isMissing)
+            {
+                return std::make_shared<const ObjMeshFile::MaterialSharedPointers>();
+            }
+        }
+
+        return result;
     }
 
     ObjMeshFileReader::ProcessMaterialFuture ObjMeshFileReader::ProcessMaterialAsync(std::string&& filename)
     {
-        return m_threadPool->Execute(
-            [this, filename = std::move(filename)]() mutable
+        // Processes on this thread if no worker is free, so reading from a worker of the same pool cannot deadlock.
+        auto future = m_threadPool->TryExecute(ThreadPool::Priority::Background,
+            [this, filename]()
         {
-            return ProcessMaterial(std::move(filename));
+            return ProcessMaterial(filename);
         });
+        return future ? std::move(*future) : CreateReadyFuture(ProcessMaterial(filename));
+    }
+
+    void ObjMeshFileReader::AddMaterials(const MaterialLibrarySharedPointer& materials)
+    {
+        auto& objMaterials = m_objMeshFile->materials;
+        objMaterials.insert(objMaterials.end(), materials->begin(), materials->end());
     }
 
     TextFileFormatResult ObjMeshFileReader::ExecuteProcessObject(ObjectBufferSharedPointer objectBuffer)
@@ -482,6 +782,19 @@ namespace Molten
         // Use thread pool.
         if(m_threadPool)
         {
+            // Bound memory of streaming by waiting for the oldest object, instead of reading further ahead.
+            while(m_onObject && m_objectFutures.size() >= GetMaxPendingObjectCount())
+            {
+                auto result = m_objectFutures.front().get();
+                m_objectFutures.erase(m_objectFutures.begin());
+
+                if(result.index() != 0)
+                {
+                    return { std::move(std::get<TextFileFormatResult::Error>(result)) };
+                }
+                DeliverObject(std::move(std::get<ObjectSharedPointer>(result)));
+            }
+
             auto future = ProcessObjectAsync(std::move(objectBuffer));
             m_objectFutures.push_back(std::move(future));
             return {};
@@ -491,8 +804,7 @@ namespace Molten
         auto result = ProcessObject(std::move(objectBuffer));
         if(result.index() == 0)
         {
-            auto& object = std::get<ObjectSharedPointer>(result);
-            m_objMeshFile->objects.push_back(object);
+            DeliverObject(std::move(std::get<ObjectSharedPointer>(result)));
             return {};
         }
 
@@ -503,150 +815,100 @@ namespace Molten
     
     ObjMeshFileReader::ProcessObjectResult ObjMeshFileReader::ProcessObject(ObjectBufferSharedPointer objectBuffer)
     {
-        auto object = std::make_shared<Object>();
+        const auto& commands = objectBuffer->commands;
 
-        auto currentGroup = std::make_shared<Group>();
-        object->groups.push_back(currentGroup);
+        ObjectChunks chunks(GetObjectChunkCount(commands.size()));
+        if(auto result = ProcessObjectChunks(commands, chunks); !result)
+        {
+            return std::move(result.GetError());
+        }
 
-        auto currentSmoothingGroup = std::make_shared<SmoothingGroup>();
-        currentGroup->smoothingGroups.push_back(currentSmoothingGroup);
-        
-        // Create new smooth group lambda.
-        auto createNewSmoothingGroup = [&]()
+        auto object = StitchObjectChunks(chunks);
+
+        // Release source data of streamed objects. Read buffers are released with the object buffer.
+        if(m_onObject && objectBuffer->mappedFile && !commands.empty())
         {
-            currentSmoothingGroup = std::make_shared<SmoothingGroup>();
-            currentGroup->smoothingGroups.push_back(currentSmoothingGroup);
-        };
+            const auto* begin = commands.front().line.data();
+            const auto* end = commands.back().line.data() + commands.back().line.size();
+            objectBuffer->mappedFile->Discard(begin, static_cast<size_t>(end - begin));
+        }
 
-        // Create new group lambda.
-        auto createNewGroup = [&]()
+        return object;
+    }
+
+    size_t ObjMeshFileReader::GetObjectChunkCount(const size_t commandCount) const
+    {
+        if(!m_threadPool || m_objectChunkSize == 0 || commandCount < m_objectChunkSize * 2)
         {
-            const auto prevGroup = object->groups.back();
-            currentGroup = std::make_shared<Group>();
-            object->groups.push_back(currentGroup);
+            return 1;
+        }
 
-            createNewSmoothingGroup();
+        const auto maxChunkCount = m_threadPool->GetWorkerCount() * 4;
+        return std::clamp(commandCount / m_objectChunkSize, size_t{ 1 }, maxChunkCount);
+    }
 
-            if (!prevGroup->material.empty())
-            {
-                currentGroup->material = prevGroup->material;
-            }
-        };
+    TextFileFormatResult ObjMeshFileReader::ProcessObjectChunks(const ObjectCommands& commands, ObjectChunks& chunks)
+    {
+        const auto chunkCount = chunks.size();
+        std::vector<TextFileFormatResult> results(chunkCount);
 
-        // Helper lambda for extracting data from string view.
-        auto createDataView = [](const ObjectCommand& command, const size_t offset)
+        auto processChunk = [&](const size_t index)
         {
-            auto dataView = std::string_view{ command.line.data() + offset, command.line.size() - offset };
-            StringUtility::TrimFront(dataView);
-            return dataView;
+            const auto begin = (commands.size() * index) / chunkCount;
+            const auto end = (commands.size() * (index + 1)) / chunkCount;
+            results[index] = ProcessObjectChunk(commands, begin, end, chunks[index]);
         };
 
-        // Lambda for reading face data.
-        auto readFace = [&](std::string_view lineView) -> TextFileFormatResult
+        // Free workers help out by taking chunks, while this thread processes chunks until none are left.
+        // This function is commonly called by a worker itself, so it must never block waiting for a free worker.
+        if(m_threadPool)
         {
-            enum class FaceFlags : uint8_t
-            {
-                Vertex = 1,
-                Uv = 2,
-                Normal = 4
-            };
-
-            static const uint8_t indexedFlags[3] = {
-                static_cast<uint8_t>(FaceFlags::Vertex),
-                static_cast<uint8_t>(FaceFlags::Uv),
-                static_cast<uint8_t>(FaceFlags::Normal) };
-
-            static std::array<uint32_t, 3> ObjMeshFile::Triangle::* const triangleMembers[3] = {
-                &ObjMeshFile::Triangle::vertexIndices,
-                &ObjMeshFile::Triangle::textureCoordinateIndices,
-                &ObjMeshFile::Triangle::normalIndices
-            };
-
-            auto readElement = [&](ObjMeshFile::Triangle& triangle, const size_t index) -> uint8_t
-            {
-                uint8_t faceFlags = 0;
-
-                for (size_t i = 0; i < 3; i++)
-                {
-                    StringUtility::TrimFront(lineView);
-
-                    const size_t endPos = lineView.find_first_of(" /\t");
-
-                    auto element = lineView.substr(0, endPos);
-                    lineView = std::string_view{ lineView.data() + element.size(), lineView.size() - element.size() };
-
-                    if (!element.empty())
-                    {
-                        uint32_t value = 0;
-                        if (std::from_chars(element.data(), element.data() + element.size(), value).ec == std::errc())
-                        {
-                            faceFlags |= indexedFlags[i];
-                            (triangle.*triangleMembers[i])[index] = value;
-                        }
-                    }
-
-                    StringUtility::TrimFront(lineView);
-                    if (lineView.empty() || lineView.front() != '/')
-                    {
-                        break;
-                    }
-                    lineView = lineView.substr(1);
-                }
-
-                return faceFlags;
-            };
-
-            auto& triangle = currentSmoothingGroup->triangles.emplace_back();
-
-            const auto elementLayout = readElement(triangle, 0);
-            if (elementLayout == 0)
+            m_threadPool->ParallelFor(ThreadPool::Priority::Background, chunkCount, processChunk);
+        }
+        else
+        {
+            for(size_t i = 0; i < chunkCount; i++)
             {
-                return { TextFileFormatResult::ParseError, "Invalid face layout" };
+                processChunk(i);
             }
+        }
 
-            for (size_t i = 1; i < 3; i++)
+        // Report first error in file order.
+        for(auto& result : results)
+        {
+            if(!result)
             {
-                if (auto flags = readElement(triangle, i); flags != elementLayout)
-                {
-                    if (flags == 0)
-                    {
-                        return { TextFileFormatResult::ParseError, "Invalid face layout" };
-                    }
-
-                    return { TextFileFormatResult::ParseError, "Mismatching face layout" };
-                }
+                return result;
             }
+        }
 
-            if (!lineView.empty())
-            {
-                auto& nextTriangle = currentSmoothingGroup->triangles.emplace_back();
-                auto& prevTriangle = currentSmoothingGroup->triangles[currentSmoothingGroup->triangles.size() - 2];
-                if (auto flags = readElement(nextTriangle, 0); flags != elementLayout)
-                {
-                    if (flags == 0)
-                    {
-                        return { TextFileFormatResult::ParseError, "Invalid face layout" };
-                    }
-
-                    return { TextFileFormatResult::ParseError, "Mismatching face layout" };
-                }
-
-                nextTriangle.vertexIndices[1] = prevTriangle.vertexIndices[0];
-                nextTriangle.textureCoordinateIndices[1] = prevTriangle.textureCoordinateIndices[0];
-                nextTriangle.normalIndices[1] = prevTriangle.normalIndices[0];
-
-                nextTriangle.vertexIndices[2] = prevTriangle.vertexIndices[2];
-                nextTriangle.textureCoordinateIndices[2] = prevTriangle.textureCoordinateIndices[2];
-                nextTriangle.normalIndices[2] = prevTriangle.normalIndices[2];
-            }
+        return {};
+    }
 
-            return {};
+    TextFileFormatResult ObjMeshFileReader::ProcessObjectChunk(
+        const ObjectCommands& commands,
+        const size_t begin,
+        const size_t end,
+        ObjectChunk& chunk)
+    {
+        // Helper lambda for extracting data from string view.
+        auto createDataView = [](const ObjectCommand& command, const size_t offset)
+        {
+            auto dataView = std::string_view{ command.line.data() + offset, command.line.size() - offset };
+            TextScanner::TrimWhitespaceFront(dataView);
+            return dataView;
         };
 
+        auto addChunkCommand = [&](const ObjectCommand& command, const std::string_view data, const uint32_t smoothingGroupId = 0)
+        {
+            chunk.commands.push_back({ chunk.triangles.size(), command.type, data, smoothingGroupId });
+        };
 
-        // Run all object commands.
-        for(auto& command : objectBuffer->commands)
+        // Run all object commands of chunk. Vertex data and faces are parsed, other commands are validated and stitched later.
+        for(size_t i = begin; i < end; i++)
         {
+            const auto& command = commands[i];
+
             switch(command.type)
             {
                 case ObjectCommandType::Object: ///< o
@@ -654,24 +916,24 @@ namespace Molten
                     auto lineView = createDataView(command, 2);
                     if(lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting an object name" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting an object name" };
                     }
-                    object->name = std::string{ lineView };
+                    addChunkCommand(command, lineView);
                 } break;
                 case ObjectCommandType::Vertex: ///< v
                 {
                     auto lineView = createDataView(command, 2);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting vertex data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting vertex data" };
                     }
 
                     Vector3f32 vertex;
                     if(!ParseVector(lineView, vertex))
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Invalid vertex data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Invalid vertex data" };
                     }
-                    object->vertices.push_back(vertex);
+                    chunk.vertices.push_back(vertex);
                     
                 } break;
                 case ObjectCommandType::Normal: ///< vn
@@ -679,80 +941,67 @@ namespace Molten
                     auto lineView = createDataView(command, 3);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting vertex normal data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting vertex normal data" };
                     }
 
                     Vector3f32 normal;
                     if (!ParseVector(lineView, normal))
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Invalid vertex normal data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Invalid vertex normal data" };
                     }
-                    object->normals.push_back(normal);
+                    chunk.normals.push_back(normal);
                 } break;
                 case ObjectCommandType::Uv: ///< vt
                 {
                     auto lineView = createDataView(command, 3);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting texture coordinate data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting texture coordinate data" };
                     }
 
                     Vector2f32 textureCoordinate;
                     if (!ParseVector(lineView, textureCoordinate))
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Invalid texture coordinate data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Invalid texture coordinate data" };
                     }
-                    object->textureCoordinates.push_back(textureCoordinate);
+                    chunk.textureCoordinates.push_back(textureCoordinate);
                 } break;
                 case ObjectCommandType::Group: ///< g
                 {
                     auto lineView = createDataView(command, 2);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting group name" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting group name" };
                     }
-
-                    if (!currentGroup->IsEmpty())
-                    {
-                        createNewGroup();
-                    }
-
-                    currentGroup->name = lineView;
+                    addChunkCommand(command, lineView);
                 } break;
                 case ObjectCommandType::SmoothingGroup: ///< s
                 {
                     auto lineView = createDataView(command, 2);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting smoothing group id" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting smoothing group id" };
                     }
 
-                    if (!currentSmoothingGroup->IsEmpty())
+                    uint32_t id = 0;
+                    if (lineView != "off")
                     {
-                        createNewSmoothingGroup();
-                    }
-
-                    if (lineView == "off")
-                    {
-                        currentSmoothingGroup->id = 0;
-                    }
-                    else
-                    {
-                        if (std::from_chars(lineView.data(), lineView.data() + lineView.size(), currentSmoothingGroup->id).ec != std::errc())
+                        if (std::from_chars(lineView.data(), lineView.data() + lineView.size(), id).ec != std::errc())
                         {
-                            return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Invalid smoothing group id" };
+                            return { TextFileFormatResult::ParseError, command.lineNumber, "Invalid smoothing group id" };
                         }
                     }
+                    addChunkCommand(command, lineView, id);
                 } break;
                 case ObjectCommandType::Face: ///< f
                 {
                     auto lineView = createDataView(command, 2);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting face data" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting face data" };
                     }
 
-                    if (auto result = readFace(lineView); !result)
+                    if (auto result = ReadFace(lineView, chunk.triangles); !result)
                     {
                         TextFileFormatResult::Error error = result.GetError();
                         error.lineNumber = command.lineNumber;
@@ -765,28 +1014,150 @@ namespace Molten
                     auto lineView = createDataView(command, 7);
                     if (lineView.empty())
                     {
-                        return TextFileFormatResult::Error{ TextFileFormatResult::ParseError, command.lineNumber, "Expecting material name" };
+                        return { TextFileFormatResult::ParseError, command.lineNumber, "Expecting material name" };
                     }
+                    addChunkCommand(command, lineView);
+                } break;
+            }
+        }
+
+        return {};
+    }
+
+    ObjMeshFileReader::ObjectSharedPointer ObjMeshFileReader::StitchObjectChunks(ObjectChunks& chunks)
+    {
+        auto object = std::make_shared<Object>();
+
+        // Vertex data is concatenated in chunk order. Face indices of obj files are global, so they are kept as is.
+        AppendChunkData(chunks, object->vertices, &ObjectChunk::vertices);
+        AppendChunkData(chunks, object->normals, &ObjectChunk::normals);
+        AppendChunkData(chunks, object->textureCoordinates, &ObjectChunk::textureCoordinates);
+
+        auto currentGroup = std::make_shared<Group>();
+        object->groups.push_back(currentGroup);
 
-                    if (!currentGroup->IsEmpty())
+        auto currentSmoothingGroup = std::make_shared<SmoothingGroup>();
+        currentGroup->smoothingGroups.push_back(currentSmoothingGroup);
+        
+        // Create new smooth group lambda.
+        auto createNewSmoothingGroup = [&]()
+        {
+            currentSmoothingGroup = std::make_shared<SmoothingGroup>();
+            currentGroup->smoothingGroups.push_back(currentSmoothingGroup);
+        };
+
+        // Create new group lambda.
+        auto createNewGroup = [&]()
+        {
+            const auto prevGroup = object->groups.back();
+            const auto smoothingGroupId = currentSmoothingGroup->id;
+            currentGroup = std::make_shared<Group>();
+            object->groups.push_back(currentGroup);
+
+            // Smoothing group state is not reset by group or material changes.
+            createNewSmoothingGroup();
+            currentSmoothingGroup->id = smoothingGroupId;
+
+            if (!prevGroup->material.empty())
+            {
+                currentGroup->material = prevGroup->material;
+            }
+        };
+
+        // Append triangles to current smoothing group. Whole chunks are moved if possible.
+        auto appendTriangles = [&](Triangles& triangles, const size_t begin, const size_t end)
+        {
+            if(begin == end)
+            {
+                return;
+            }
+
+            auto& destination = currentSmoothingGroup->triangles;
+            if(destination.empty() && begin == 0 && end == triangles.size())
+            {
+                destination = std::move(triangles);
+                return;
+            }
+
+            destination.insert(destination.end(), triangles.begin() + begin, triangles.begin() + end);
+        };
+
+        // Replay commands of all chunks in order, assigning triangles to groups and smoothing groups.
+        for(auto& chunk : chunks)
+        {
+            const auto triangleCount = chunk.triangles.size();
+            size_t triangleIndex = 0;
+
+            for(auto& command : chunk.commands)
+            {
+                appendTriangles(chunk.triangles, triangleIndex, command.triangleCount);
+                triangleIndex = command.triangleCount;
+
+                switch(command.type)
+                {
+                    case ObjectCommandType::Object: ///< o
                     {
-                        createNewGroup();
-                    }
-                    currentGroup->material = lineView;
-                } break;
+                        object->name = std::string{ command.data };
+                    } break;
+                    case ObjectCommandType::Group: ///< g
+                    {
+                        if (!currentGroup->IsEmpty())
+                        {
+                            createNewGroup();
+                        }
+                        currentGroup->name = command.data;
+                    } break;
+                    case ObjectCommandType::SmoothingGroup: ///< s
+                    {
+                        if (!currentSmoothingGroup->IsEmpty())
+                        {
+                            createNewSmoothingGroup();
+                        }
+                        currentSmoothingGroup->id = command.smoothingGroupId;
+                    } break;
+                    case ObjectCommandType::UseMaterial: ///< usemtl
+                    {
+                        if (!currentGroup->IsEmpty())
+                        {
+                            createNewGroup();
+                        }
+                        currentGroup->material = command.data;
+                    } break;
+                    default: break;
+                }
             }
+
+            appendTriangles(chunk.triangles, triangleIndex, triangleCount);
         }
 
-        return { object };
+        return object;
     }
 
     ObjMeshFileReader::ProcessObjectFuture ObjMeshFileReader::ProcessObjectAsync(ObjectBufferSharedPointer objectBuffer)
     {
-        return m_threadPool->Execute(
-            [this, objectBuffer = std::move(objectBuffer)]() mutable
+        // Processes on this thread if no worker is free, so reading from a worker of the same pool cannot deadlock.
+        auto future = m_threadPool->TryExecute(ThreadPool::Priority::Background,
+            [this, objectBuffer]() mutable
         {
             return ProcessObject(std::move(objectBuffer));
         });
+        return future ? std::move(*future) : CreateReadyFuture(ProcessObject(std::move(objectBuffer)));
+    }
+
+    void ObjMeshFileReader::DeliverObject(ObjectSharedPointer object)
+    {
+        if(m_onObject)
+        {
+            (*m_onObject)(std::move(object));
+            return;
+        }
+
+        m_objMeshFile->objects.push_back(std::move(object));
+    }
+
+    size_t ObjMeshFileReader::GetMaxPendingObjectCount() const
+    {
+        return m_threadPool ? m_threadPool->GetWorkerCount() + 1 : 1;
     }
 
     TextFileFormatResult ObjMeshFileReader::HandleFutures()
@@ -812,8 +1183,7 @@ namespace Molten
 
             if (auto result = future.get(); result.index() == 0)
             {
-                auto& material = std::get<MaterialSharedPointer>(result);
-                m_objMeshFile->materials.push_back(material);
+                AddMaterials(std::get<MaterialLibrarySharedPointer>(result));
                 it = m_materialFutures.erase(it);
             }
             else
@@ -838,8 +1208,7 @@ namespace Molten
 
             if (auto result = future.get(); result.index() == 0)
             {
-                auto& object = std::get<ObjectSharedPointer>(result);
-                m_objMeshFile->objects.push_back(object);
+                DeliverObject(std::move(std::get<ObjectSharedPointer>(result)));
                 it = m_objectFutures.erase(it);
             }
             else
@@ -877,9 +1246,7 @@ namespace Molten
             {
                 if (auto result = future.get(); result.index() == 0)
                 {
-                    auto& material = std::get<MaterialSharedPointer>(result);
-                    m_objMeshFile->materials.push_back(material);
-
+                    AddMaterials(std::get<MaterialLibrarySharedPointer>(result));
                     it = m_materialFutures.erase(it);
                 }
                 else
@@ -908,8 +1275,7 @@ namespace Molten
             {
                 if (auto result = future.get(); result.index() == 0)
                 {
-                    auto& object = std::get<ObjectSharedPointer>(result);
-                    m_objMeshFile->objects.push_back(object);
+                    DeliverObject(std::move(std::get<ObjectSharedPointer>(result)));
 
                     it = m_objectFutures.erase(it);
                 }
@@ -924,7 +1290,8 @@ namespace Molten
             }
             else
             {
-                ++it;
+                // Objects are stored in file order, since face indices are global and offset by preceding objects.
+                break;
             }
         }
 
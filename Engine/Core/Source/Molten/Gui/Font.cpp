@@ -29,7 +29,6 @@
 #include "ThirdParty/FreeType2/include/freetype/freetype.h"
 #include "ThirdParty/FreeType2/include/freetype/ftcache.h"
 #include <vector>
-#include <fstream>
 #include <algorithm>
 #include <filesystem>
 #include <cstring>
@@ -66,8 +65,6 @@ namespace Molten::Gui
 
         Font* GetOrCreateFont(const std::string& fontFamily);
 
-        static std::vector<uint8_t> ReadFontFile(const std::string& filename);
-
         bool AddAtlasNewEvent(FontAtlas* atlas);
         bool AddAtlasUpdateEvent(FontAtlas* atlas);
 
@@ -89,7 +86,7 @@ namespace Molten::Gui
     {
         FontImpl(
             FontRepositoryImpl& fontRepositoryImpl,
-            const std::vector<uint8_t>&& fontData);
+            VirtualFile fontFile);
 
         FT_Error LoadFont();
 
@@ -107,7 +104,7 @@ namespace Molten::Gui
              FT_Face* face);
 
         FontRepositoryImpl& fontRepositoryImpl;
-        const std::vector<uint8_t> data;
+        const VirtualFile file;
         FTC_Manager ftCacheManager;
         FTC_CMapCache ftCMapCache;
         FTC_ImageCache ftImageCache;    
@@ -158,13 +155,13 @@ namespace Molten::Gui
             return nullptr;
         }
 
-        auto fontData = ReadFontFile(fontPath);
-        if (fontData.empty())
+        auto fontFile = nameRepository.OpenFontFile(fontPath);
+        if (!fontFile || fontFile->GetSize() == 0)
         {
             return nullptr;
         }
 
-        auto fontImpl = std::make_unique<FontImpl>(*this, std::move(fontData));
+        auto fontImpl = std::make_unique<FontImpl>(*this, std::move(*fontFile));
         if(fontImpl->LoadFont() != 0)
         {
             return nullptr;
@@ -178,28 +175,6 @@ namespace Molten::Gui
         return newFontPtr;
     }
 
-    std::vector<uint8_t> FontRepositoryImpl::ReadFontFile(const std::string& filename)
-    {
-        std::ifstream file(filename, std::ifstream::binary);
-        if (!file.is_open())
-        {
-            return {};
-        }
-
-        file.seekg(0, std::fstream::end);
-        const auto fileSize = static_cast<size_t>(file.tellg());
-        if (!fileSize)
-        {
-            return {};
-        }
-        file.seekg(0, std::fstream::beg);
-
-        std::vector<uint8_t> fontData;
-        fontData.resize(fileSize);
-        file.read(reinterpret_cast<char*>(fontData.data()), fileSize);
-        return fontData;
-    }
-
     bool FontRepositoryImpl::AddAtlasNewEvent(FontAtlas* atlas)
     {
         for (auto* eventNew : atlasNewEvents)
@@ -249,10 +224,10 @@ namespace Molten::Gui
 
     FontImpl::FontImpl(
         FontRepositoryImpl& fontRepositoryImpl,
-        const std::vector<uint8_t>&& fontData
+        VirtualFile fontFile
     ) :
         fontRepositoryImpl(fontRepositoryImpl),
-        data(fontData),
+        file(std::move(fontFile)),
         ftCacheManager(nullptr),
         ftCMapCache(nullptr),
         ftImageCache(nullptr)
@@ -512,8 +487,8 @@ namespace Molten::Gui
         // Load face from memory.
         if ((error = FT_New_Memory_Face(
             library,
-            reinterpret_cast<const FT_Byte*>(fontImpl->data.data()),
-            static_cast<FT_Long>(fontImpl->data.size()),
+            reinterpret_cast<const FT_Byte*>(fontImpl->file.GetData()),
+            static_cast<FT_Long>(fontImpl->file.GetSize()),
             0,
             face)) != 0)
         {
@@ -538,8 +513,34 @@ namespace Molten::Gui
         m_cachedFontPaths.clear();
     }
 
+    void FontNameRepository::SetVirtualFileSystem(std::shared_ptr<const VirtualFileSystem> virtualFileSystem)
+    {
+        m_virtualFileSystem = std::move(virtualFileSystem);
+        m_cachedFontPaths.clear();
+    }
+
+    const std::shared_ptr<const VirtualFileSystem>& FontNameRepository::GetVirtualFileSystem() const
+    {
+        return m_virtualFileSystem;
+    }
+
     bool FontNameRepository::AddDirectory(const std::string& directory)
     {
+        if (m_virtualFileSystem)
+        {
+            auto virtualDirectory = VirtualFileSystem::NormalizePath(directory);
+            if (!m_virtualFileSystem->ListDirectory(virtualDirectory))
+            {
+                return false;
+            }
+
+            if (std::find(m_fontDirectories.begin(), m_fontDirectories.end(), virtualDirectory) == m_fontDirectories.end())
+            {
+                m_fontDirectories.push_back(std::move(virtualDirectory));
+            }
+            return true;
+        }
+
         std::filesystem::path path{ directory };
         if(!std::filesystem::is_directory(path))
         {
@@ -598,17 +599,49 @@ namespace Molten::Gui
 
     std::string FontNameRepository::FindFontFamilyPath(const std::string& fontFamily)
     {
-        auto lowercaseFontFamily = fontFamily;
-        std::transform(lowercaseFontFamily.begin(), lowercaseFontFamily.end(), lowercaseFontFamily.begin(), [](const auto c)
+        auto toLowercase = [](std::string& string)
         {
-            return static_cast<char>(std::tolower(static_cast<int>(c)));
-        });
+            std::transform(string.begin(), string.end(), string.begin(), [](const auto c)
+            {
+                return static_cast<char>(std::tolower(static_cast<int>(c)));
+            });
+        };
 
-        if (auto it = m_cachedFontPaths.find(fontFamily); it != m_cachedFontPaths.end())
+        auto lowercaseFontFamily = fontFamily;
+        toLowercase(lowercaseFontFamily);
+
+        if (auto it = m_cachedFontPaths.find(lowercaseFontFamily); it != m_cachedFontPaths.end())
         {
             return it->second;
         }
 
+        if (m_virtualFileSystem)
+        {
+            for (const auto& fontDirectory : m_fontDirectories)
+            {
+                const auto names = m_virtualFileSystem->ListDirectory(fontDirectory);
+                if (!names)
+                {
+                    continue;
+                }
+
+                for (const auto& name : *names)
+                {
+                    auto stem = name.substr(0, name.find_last_of('.'));
+                    toLowercase(stem);
+
+                    if (stem == lowercaseFontFamily)
+                    {
+                        auto fontPath = fontDirectory.empty() ? name : fontDirectory + "/" + name;
+                        m_cachedFontPaths.insert({ lowercaseFontFamily, fontPath });
+                        return fontPath;
+                    }
+                }
+            }
+
+            return "";
+        }
+
         for(const auto& fontDirectory : m_fontDirectories)
         {
             for (auto& dirEntry : std::filesystem::directory_iterator(fontDirectory))
@@ -619,10 +652,7 @@ namespace Molten::Gui
                 }
 
                 auto dirEntryName = dirEntry.path().stem().u8string();
-                std::transform(dirEntryName.begin(), dirEntryName.end(), dirEntryName.begin(), [](const auto c)
-                {
-                    return static_cast<char>(std::tolower(static_cast<int>(c)));
-                });
+                toLowercase(dirEntryName);
 
                 if(dirEntryName == lowercaseFontFamily)
                 {
@@ -636,6 +666,23 @@ namespace Molten::Gui
         return "";
     }
 
+    std::optional<VirtualFile> FontNameRepository::OpenFontFile(const std::string& fontPath) const
+    {
+        if (m_virtualFileSystem)
+        {
+            return m_virtualFileSystem->Open(fontPath);
+        }
+
+        auto mappedFile = std::make_shared<MemoryMappedFile>();
+        if (!mappedFile->Open(fontPath))
+        {
+            return std::nullopt;
+        }
+
+        const auto data = mappedFile->GetView();
+        return VirtualFile{ VirtualFile::MappedFile{ std::move(mappedFile) }, data };
+    }
+
 
     // Font atlas implementations.
     FontAtlas::FontAtlas(
@@ -24,7 +24,14 @@
 */
 
 #include "Molten/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
 
 namespace Molten
 {
@@ -67,6 +74,221 @@ namespace Molten
         return mode;
     }
 
+    // Global implementations.
+    namespace
+    {
+
+        struct LogRecordHeader
+        {
+            uint32_t size; ///< Size of message, excluding null terminator, or PaddingRecordSize.
+            uint32_t severity;
+        };
+
+        constexpr uint32_t PaddingRecordSize = std::numeric_limits<uint32_t>::max();
+        constexpr size_t LogRecordAlignment = sizeof(LogRecordHeader);
+        constexpr size_t MinAsyncBufferSize = 256;
+
+        constexpr size_t GetLogRecordSize(const size_t messageSize)
+        {
+            return (sizeof(LogRecordHeader) + messageSize + 1 + LogRecordAlignment - 1) & ~(LogRecordAlignment - 1);
+        }
+
+        /** Single-producer/single-consumer ring buffer of null terminated log messages, written by a single thread.
+         *  Records are contiguous, padding records fill the end of the buffer if the next record does not fit.
+         */
+        class LogRingBuffer
+        {
+
+        public:
+
+            explicit LogRingBuffer(const size_t capacity) :
+                closed(false),
+                m_data(new char[capacity]),
+                m_capacity(capacity),
+                m_maxMessageSize(capacity / 2 - sizeof(LogRecordHeader) - 1),
+                m_cachedReadPosition(0),
+                m_writePosition(0),
+                m_readPosition(0)
+            {}
+
+            /** Copies message to buffer. Messages longer than half of the buffer are truncated. Called by producer.
+             *
+             * @return false if buffer is full.
+             */
+            bool TryPush(const Logger::Severity severity, std::string_view message)
+            {
+                message = message.substr(0, m_maxMessageSize);
+                const auto recordSize = GetLogRecordSize(message.size());
+
+                auto writePosition = m_writePosition.load(std::memory_order_relaxed);
+                const auto offset = static_cast<size_t>(writePosition & (m_capacity - 1));
+                const auto contiguousSize = m_capacity - offset;
+                const auto paddingSize = contiguousSize < recordSize ? contiguousSize : size_t{ 0 };
+                const auto requiredSize = paddingSize + recordSize;
+
+                if(writePosition + requiredSize - m_cachedReadPosition > m_capacity)
+                {
+                    m_cachedReadPosition = m_readPosition.load(std::memory_order_acquire);
+                    if(writePosition + requiredSize - m_cachedReadPosition > m_capacity)
+                    {
+                        return false;
+                    }
+                }
+
+                if(paddingSize > 0)
+                {
+                    const LogRecordHeader padding = { PaddingRecordSize, 0 };
+                    std::memcpy(m_data.get() + offset, &padding, sizeof(padding));
+                    writePosition += paddingSize;
+                }
+
+                auto* record = m_data.get() + static_cast<size_t>(writePosition & (m_capacity - 1));
+                const LogRecordHeader header = { static_cast<uint32_t>(message.size()), static_cast<uint32_t>(severity) };
+                std::memcpy(record, &header, sizeof(header));
+                std::memcpy(record + sizeof(header), message.data(), message.size());
+                record[sizeof(header) + message.size()] = '\0';
+
+                m_writePosition.store(writePosition + recordSize, std::memory_order_release);
+                return true;
+            }
+
+            /** Checks if more than half of buffer is used. Called by producer, after push. */
+            bool IsHalfFull() const
+            {
+                return m_writePosition.load(std::memory_order_relaxed) - m_cachedReadPosition > m_capacity / 2;
+            }
+
+            /** Invokes function for each message, in order of writing. Called by consumer.
+             *
+             * @return Number of consumed messages.
+             */
+            template<typename TFunction>
+            size_t Consume(TFunction&& function)
+            {
+                auto readPosition = m_readPosition.load(std::memory_order_relaxed);
+                const auto writePosition = m_writePosition.load(std::memory_order_acquire);
+
+                size_t count = 0;
+                while(readPosition != writePosition)
+                {
+                    const auto offset = static_cast<size_t>(readPosition & (m_capacity - 1));
+                    LogRecordHeader header;
+                    std::memcpy(&header, m_data.get() + offset, sizeof(header));
+
+                    if(header.size == PaddingRecordSize)
+                    {
+                        readPosition += m_capacity - offset;
+                    }
+                    else
+                    {
+                        function(static_cast<Logger::Severity>(header.severity), m_data.get() + offset + sizeof(header));
+                        readPosition += GetLogRecordSize(header.size);
+                        ++count;
+                    }
+
+                    // Released per record, so producers may reuse space while the callback is slow.
+                    m_readPosition.store(readPosition, std::memory_order_release);
+                }
+
+                return count;
+            }
+
+            /** Checks if buffer is empty. Called by consumer. */
+            bool IsEmpty() const
+            {
+                return m_readPosition.load(std::memory_order_relaxed) == m_writePosition.load(std::memory_order_acquire);
+            }
+
+            std::atomic_bool closed; ///< Set when logger disabled asynchronous mode, so producer threads may release it.
+
+        private:
+
+            std::unique_ptr<char[]> m_data;
+            const size_t m_capacity;
+            const size_t m_maxMessageSize;
+            uint64_t m_cachedReadPosition; ///< Read position last seen by producer, avoiding cache line transfers of m_readPosition.
+            alignas(64) std::atomic<uint64_t> m_writePosition;
+            alignas(64) std::atomic<uint64_t> m_readPosition;
+
+        };
+
+        struct ThreadLogRingBuffer
+        {
+            uint64_t asyncId;
+            std::shared_ptr<LogRingBuffer> buffer;
+        };
+
+        /** Ring buffers of current thread, per logger in asynchronous mode. */
+        thread_local std::vector<ThreadLogRingBuffer> t_logRingBuffers;
+
+        std::atomic<uint64_t> g_nextAsyncId = 1;
+
+        size_t GetPowerOfTwoSize(const size_t size)
+        {
+            size_t powerOfTwo = MinAsyncBufferSize;
+            while(powerOfTwo < size)
+            {
+                powerOfTwo <<= 1;
+            }
+            return powerOfTwo;
+        }
+
+    }
+
+    // Logger async state implementations.
+    struct Logger::AsyncState
+    {
+        AsyncState(const size_t bufferSize, const Time flushInterval) :
+            id(g_nextAsyncId.fetch_add(1, std::memory_order_relaxed)),
+            bufferSize(GetPowerOfTwoSize(bufferSize)),
+            flushInterval(flushInterval),
+            stopping(false),
+            wakeRequested(false),
+            flushRequestCount(0),
+            flushedCount(0),
+            droppedCount(0)
+        {}
+
+        LogRingBuffer& GetThreadBuffer()
+        {
+            for(auto& threadBuffer : t_logRingBuffers)
+            {
+                if(threadBuffer.asyncId == id)
+                {
+                    return *threadBuffer.buffer;
+                }
+            }
+
+            // First message of this thread, also releasing buffers of loggers no longer in asynchronous mode.
+            t_logRingBuffers.erase(std::remove_if(t_logRingBuffers.begin(), t_logRingBuffers.end(), [](const ThreadLogRingBuffer& threadBuffer)
+            {
+                return threadBuffer.buffer->closed.load(std::memory_order_relaxed);
+            }), t_logRingBuffers.end());
+
+            auto buffer = std::make_shared<LogRingBuffer>(bufferSize);
+            {
+                std::scoped_lock lock(mutex);
+                buffers.push_back(buffer);
+            }
+            t_logRingBuffers.push_back({ id, buffer });
+            return *buffer;
+        }
+
+        const uint64_t id;
+        const size_t bufferSize;
+        const Time flushInterval;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::condition_variable flushedCondition;
+        std::vector<std::shared_ptr<LogRingBuffer>> buffers;
+        bool stopping;
+        std::atomic_bool wakeRequested;
+        uint64_t flushRequestCount;
+        uint64_t flushedCount;
+        std::atomic<uint64_t> droppedCount;
+        std::thread thread;
+    };
+
     // Logger implementations.
     const uint32_t Logger::SeverityAllFlags = 
         static_cast<uint32_t>(Logger::Severity::Info) |
@@ -92,7 +314,9 @@ namespace Molten
     { }
 
     Logger::~Logger()
-    { }
+    {
+        DisableAsync();
+    }
 
     void Logger::SetSeverityFlags(const uint32_t severityFlags)
     {
@@ -108,7 +332,14 @@ namespace Molten
     {
         if (m_severityFlags & static_cast<uint32_t>(severity))
         {
+            if(m_async)
+            {
+                WriteAsync(severity, message);
+                return;
+            }
+
             m_callback(severity, message);
+            FlushOutput();
         }
     }
 
@@ -116,16 +347,194 @@ namespace Molten
     {
         if (m_severityFlags & static_cast<uint32_t>(severity))
         {
+            if(m_async)
+            {
+                WriteAsync(severity, message);
+                return;
+            }
+
             m_callback(severity, message.c_str());
+            FlushOutput();
+        }
+    }
+
+    void Logger::Write(const Severity severity, const std::string_view message)
+    {
+        if (m_severityFlags & static_cast<uint32_t>(severity))
+        {
+            if(m_async)
+            {
+                WriteAsync(severity, message);
+                return;
+            }
+
+            // Callback requires null terminated messages, the buffer is reused to avoid allocations.
+            thread_local std::string nullTerminatedMessage;
+            nullTerminatedMessage.assign(message);
+            m_callback(severity, nullTerminatedMessage.c_str());
+            FlushOutput();
+        }
+    }
+
+    void Logger::EnableAsync(const size_t bufferSize, const Time flushInterval)
+    {
+        if(m_async)
+        {
+            return;
+        }
+
+        m_async = std::make_unique<AsyncState>(bufferSize, flushInterval);
+        m_async->thread = std::thread([this]() { RunAsync(); });
+    }
+
+    void Logger::DisableAsync()
+    {
+        if(!m_async)
+        {
+            return;
+        }
+
+        {
+            std::scoped_lock lock(m_async->mutex);
+            m_async->stopping = true;
+        }
+        m_async->condition.notify_all();
+        m_async->thread.join();
+
+        for(auto& buffer : m_async->buffers)
+        {
+            buffer->closed.store(true, std::memory_order_relaxed);
+        }
+        m_async.reset();
+    }
+
+    bool Logger::IsAsync() const
+    {
+        return m_async != nullptr;
+    }
+
+    void Logger::Flush()
+    {
+        if(!m_async)
+        {
+            FlushOutput();
+            return;
+        }
+
+        std::unique_lock lock(m_async->mutex);
+        const auto flushRequest = ++m_async->flushRequestCount;
+        m_async->condition.notify_all();
+        m_async->flushedCondition.wait(lock, [&]() { return m_async->flushedCount >= flushRequest; });
+    }
+
+    uint64_t Logger::GetDroppedMessageCount() const
+    {
+        return m_async ? m_async->droppedCount.load(std::memory_order_relaxed) : 0;
+    }
+
+    size_t Logger::GetAsyncBufferCount() const
+    {
+        if(!m_async)
+        {
+            return 0;
+        }
+
+        std::scoped_lock lock(m_async->mutex);
+        return m_async->buffers.size();
+    }
+
+    void Logger::FlushOutput()
+    {}
+
+    void Logger::WriteAsync(const Severity severity, const std::string_view message)
+    {
+        auto& buffer = m_async->GetThreadBuffer();
+        if(!buffer.TryPush(severity, message))
+        {
+            m_async->droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Background thread is woken up early if buffer is filling up, notified without locking since a missed wake up only delays until flush interval.
+        if(buffer.IsHalfFull() && !m_async->wakeRequested.exchange(true, std::memory_order_relaxed))
+        {
+            m_async->condition.notify_one();
+        }
+    }
+
+    void Logger::RunAsync()
+    {
+        auto& async = *m_async;
+        const auto flushInterval = std::chrono::microseconds{ async.flushInterval.AsMicroseconds<int64_t>() };
+
+        uint64_t reportedDroppedCount = 0;
+        bool stopping = false;
+
+        while(!stopping)
+        {
+            // Snapshot is released every iteration, or buffers of exited threads would never be pruned.
+            std::vector<std::shared_ptr<LogRingBuffer>> buffers;
+            uint64_t flushRequestCount = 0;
+            bool flushRequested = false;
+            {
+                std::unique_lock lock(async.mutex);
+                async.condition.wait_for(lock, flushInterval, [&]()
+                {
+                    return async.stopping || async.wakeRequested.load(std::memory_order_relaxed) || async.flushRequestCount != async.flushedCount;
+                });
+
+                stopping = async.stopping;
+                flushRequestCount = async.flushRequestCount;
+                flushRequested = flushRequestCount != async.flushedCount;
+
+                // Buffers only referenced by this thread belong to exited threads.
+                async.buffers.erase(std::remove_if(async.buffers.begin(), async.buffers.end(), [](const std::shared_ptr<LogRingBuffer>& buffer)
+                {
+                    return buffer.use_count() == 1 && buffer->IsEmpty();
+                }), async.buffers.end());
+                buffers = async.buffers;
+            }
+            async.wakeRequested.store(false, std::memory_order_relaxed);
+
+            size_t messageCount = 0;
+            for(auto& buffer : buffers)
+            {
+                messageCount += buffer->Consume([&](const Severity severity, const char* message)
+                {
+                    m_callback(severity, message);
+                });
+            }
+
+            if(const auto droppedCount = async.droppedCount.load(std::memory_order_relaxed); droppedCount != reportedDroppedCount)
+            {
+                if(m_severityFlags & static_cast<uint32_t>(Severity::Warning))
+                {
+                    const auto message = "Dropped " + std::to_string(droppedCount - reportedDroppedCount) + " log messages, due to full buffers.";
+                    m_callback(Severity::Warning, message.c_str());
+                    ++messageCount;
+                }
+                reportedDroppedCount = droppedCount;
+            }
+
+            if(messageCount > 0 || flushRequested)
+            {
+                FlushOutput();
+            }
+
+            {
+                std::scoped_lock lock(async.mutex);
+                async.flushedCount = flushRequestCount;
+            }
+            async.flushedCondition.notify_all();
         }
     }
 
     // File logger implementations.
     FileLogger::FileLogger(const std::string& filename, const OpenMode openMode, const uint32_t severityFlags) :
-        Logger([this](const Severity severity, const std::string& message)
+        Logger([this](const Severity severity, const char* message)
         {
+            std::scoped_lock lock(m_fileMutex);
             m_file << GetSeverityString(severity) << message << "\n";
-            m_file.flush();
         },
         severityFlags)
     {
@@ -135,6 +544,7 @@ namespace Molten
 
     FileLogger::~FileLogger()
     {
+        DisableAsync();
         Close();
     }
 
@@ -146,6 +556,9 @@ namespace Molten
             return false;
         }
 
+        Flush();
+        std::scoped_lock lock(m_fileMutex);
+
         if (m_file.is_open())
         {
             m_file.close();
@@ -165,14 +578,23 @@ namespace Molten
 
     void FileLogger::Close()
     {
+        Flush();
+        std::scoped_lock lock(m_fileMutex);
         m_file.close();
     }
 
 
     bool FileLogger::IsOpen() const
     {
+        std::scoped_lock lock(m_fileMutex);
         return m_file.is_open();
     }
 
+    void FileLogger::FlushOutput()
+    {
+        std::scoped_lock lock(m_fileMutex);
+        m_file.flush();
+    }
+
 
 }
@@ -0,0 +1,102 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/Memory/FrameAllocator.hpp"
+#include <atomic>
+
+namespace Molten
+{
+
+    // Global implementations.
+    /** Cache of last used thread allocator. Frame allocators are identified by a unique id, not by address, since addresses can be reused. */
+    struct ThreadAllocatorCache
+    {
+        uint64_t frameAllocatorId = 0;
+        LinearAllocator* linearAllocator = nullptr;
+    };
+
+    static thread_local ThreadAllocatorCache threadAllocatorCache;
+
+    static std::atomic<uint64_t> frameAllocatorIdCounter = 0;
+
+
+    // Frame allocator implementations.
+    FrameAllocator::FrameAllocator(const size_t blockSize) :
+        m_id(++frameAllocatorIdCounter),
+        m_blockSize(blockSize)
+    {}
+
+    LinearAllocator& FrameAllocator::GetThreadAllocator()
+    {
+        if(threadAllocatorCache.frameAllocatorId == m_id)
+        {
+            return *threadAllocatorCache.linearAllocator;
+        }
+
+        std::lock_guard lock(m_mutex);
+
+        auto& linearAllocator = m_threadAllocators[std::this_thread::get_id()];
+        if(!linearAllocator)
+        {
+            linearAllocator = std::make_unique<LinearAllocator>(m_blockSize);
+        }
+
+        threadAllocatorCache = { m_id, linearAllocator.get() };
+        return *linearAllocator;
+    }
+
+    void* FrameAllocator::Allocate(const size_t size, const size_t alignment)
+    {
+        return GetThreadAllocator().Allocate(size, alignment);
+    }
+
+    void FrameAllocator::Reset()
+    {
+        std::lock_guard lock(m_mutex);
+        for(auto& [threadId, linearAllocator] : m_threadAllocators)
+        {
+            linearAllocator->Reset();
+        }
+    }
+
+    size_t FrameAllocator::GetUsedSize()
+    {
+        std::lock_guard lock(m_mutex);
+
+        size_t usedSize = 0;
+        for (auto& [threadId, linearAllocator] : m_threadAllocators)
+        {
+            usedSize += linearAllocator->GetUsedSize();
+        }
+        return usedSize;
+    }
+
+    size_t FrameAllocator::GetThreadAllocatorCount()
+    {
+        std::lock_guard lock(m_mutex);
+        return m_threadAllocators.size();
+    }
+
+}
@@ -0,0 +1,122 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/Memory/LinearAllocator.hpp"
+#include <algorithm>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static std::unique_ptr<Byte[]> AllocateBlockData(const size_t size)
+    {
+        return std::unique_ptr<Byte[]>(new Byte[size]); // Not value-initialized, unlike std::make_unique.
+    }
+
+    static size_t AlignOffset(const Byte* base, const size_t offset, const size_t alignment)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(base + offset);
+        const auto alignedAddress = (address + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+        return offset + static_cast<size_t>(alignedAddress - address);
+    }
+
+
+    // Linear allocator implementations.
+    LinearAllocator::LinearAllocator(const size_t blockSize) :
+        m_blockSize(std::max(blockSize, size_t{ 64 })),
+        m_currentBlock(0),
+        m_currentOffset(0),
+        m_usedSize(0)
+    {
+        m_blocks.push_back({ AllocateBlockData(m_blockSize), m_blockSize });
+    }
+
+    void* LinearAllocator::Allocate(const size_t size, const size_t alignment)
+    {
+        auto& block = m_blocks[m_currentBlock];
+        if(const auto alignedOffset = AlignOffset(block.data.get(), m_currentOffset, alignment); alignedOffset + size <= block.size)
+        {
+            m_usedSize += (alignedOffset - m_currentOffset) + size;
+            m_currentOffset = alignedOffset + size;
+            return block.data.get() + alignedOffset;
+        }
+
+        return AllocateFromNextBlock(size, alignment);
+    }
+
+    void LinearAllocator::Reset()
+    {
+        if(m_blocks.size() > 1)
+        {
+            const auto capacity = GetCapacity();
+            m_blocks.clear();
+            m_blocks.push_back({ AllocateBlockData(capacity), capacity });
+        }
+
+        m_currentBlock = 0;
+        m_currentOffset = 0;
+        m_usedSize = 0;
+    }
+
+    size_t LinearAllocator::GetUsedSize() const
+    {
+        return m_usedSize;
+    }
+
+    size_t LinearAllocator::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for(const auto& block : m_blocks)
+        {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    size_t LinearAllocator::GetBlockCount() const
+    {
+        return m_blocks.size();
+    }
+
+    void* LinearAllocator::AllocateFromNextBlock(const size_t size, const size_t alignment)
+    {
+        // Use next block if already allocated and large enough, else allocate a new one.
+        const auto requiredSize = size + alignment - 1;
+        ++m_currentBlock;
+        if(m_currentBlock >= m_blocks.size() || m_blocks[m_currentBlock].size < requiredSize)
+        {
+            const auto newBlockSize = std::max(m_blockSize, requiredSize);
+            m_blocks.insert(m_blocks.begin() + m_currentBlock, Block{ AllocateBlockData(newBlockSize), newBlockSize });
+        }
+
+        auto& block = m_blocks[m_currentBlock];
+        const auto alignedOffset = AlignOffset(block.data.get(), 0, alignment);
+
+        m_usedSize += alignedOffset + size;
+        m_currentOffset = alignedOffset + size;
+        return block.data.get() + alignedOffset;
+    }
+
+}
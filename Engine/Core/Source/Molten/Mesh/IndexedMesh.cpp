@@ -0,0 +1,151 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/IndexedMesh.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Molten
+{
+
+    // Indexed mesh indices implementations.
+    IndexedMeshIndices::IndexedMeshIndices() :
+        indexDataType(IndexBuffer::DataType::Uint16)
+    {}
+
+    size_t IndexedMeshIndices::GetIndexCount() const
+    {
+        return indexDataType == IndexBuffer::DataType::Uint16 ?
+            indexData.size() / sizeof(uint16_t) :
+            indexData.size() / sizeof(uint32_t);
+    }
+
+    uint32_t IndexedMeshIndices::GetIndex(const size_t position) const
+    {
+        if (indexDataType == IndexBuffer::DataType::Uint16)
+        {
+            uint16_t index = 0;
+            std::memcpy(&index, indexData.data() + (position * sizeof(uint16_t)), sizeof(uint16_t));
+            return index;
+        }
+
+        uint32_t index = 0;
+        std::memcpy(&index, indexData.data() + (position * sizeof(uint32_t)), sizeof(uint32_t));
+        return index;
+    }
+
+    std::vector<uint32_t> IndexedMeshIndices::GetIndices() const
+    {
+        const auto indexCount = GetIndexCount();
+
+        std::vector<uint32_t> indices(indexCount);
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            indices[i] = GetIndex(i);
+        }
+
+        return indices;
+    }
+
+    void IndexedMeshIndices::SetIndices(const std::vector<uint32_t>& indices)
+    {
+        const auto maxIndex = indices.empty() ? uint32_t{ 0 } : *std::max_element(indices.begin(), indices.end());
+
+        if (maxIndex <= std::numeric_limits<uint16_t>::max())
+        {
+            indexDataType = IndexBuffer::DataType::Uint16;
+            indexData.resize(indices.size() * sizeof(uint16_t));
+
+            auto* data = indexData.data();
+            for (const auto index : indices)
+            {
+                const auto index16 = static_cast<uint16_t>(index);
+                std::memcpy(data, &index16, sizeof(uint16_t));
+                data += sizeof(uint16_t);
+            }
+        }
+        else
+        {
+            indexDataType = IndexBuffer::DataType::Uint32;
+            indexData.resize(indices.size() * sizeof(uint32_t));
+
+            if (!indices.empty())
+            {
+                std::memcpy(indexData.data(), indices.data(), indexData.size());
+            }
+        }
+    }
+
+    IndexBufferDescriptor IndexedMeshIndices::GetIndexBufferDescriptor() const
+    {
+        return {
+            static_cast<uint32_t>(GetIndexCount()),
+            indexData.data(),
+            indexDataType
+        };
+    }
+
+
+    // Indexed sub-mesh LOD implementations.
+    IndexedSubmeshLod::IndexedSubmeshLod() :
+        error(0.0f)
+    {}
+
+
+    // Indexed meshlet implementations.
+    IndexedMeshlet::IndexedMeshlet() :
+        vertexOffset(0),
+        vertexCount(0),
+        triangleOffset(0),
+        triangleCount(0),
+        radius(0.0f),
+        coneCutoff(1.0f)
+    {}
+
+    bool IndexedMeshlet::IsBackFacing(const Vector3f32& viewPosition) const
+    {
+        if (coneCutoff >= 1.0f)
+        {
+            return false;
+        }
+
+        const auto direction = (coneApex - viewPosition).Normal();
+        return direction.Dot(coneAxis) >= coneCutoff;
+    }
+
+
+    // Indexed sub-mesh implementations.
+    VertexBufferDescriptor IndexedSubmesh::GetVertexBufferDescriptor() const
+    {
+        return {
+            static_cast<uint32_t>(vertices.size()),
+            static_cast<uint32_t>(sizeof(IndexedMeshVertex)),
+            vertices.data()
+        };
+    }
+
+}
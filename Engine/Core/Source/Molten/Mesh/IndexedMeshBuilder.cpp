@@ -0,0 +1,528 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/IndexedMeshBuilder.hpp"
+#include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include "Molten/Mesh/MeshNormalGenerator.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint32_t UnusedObjIndex = std::numeric_limits<uint32_t>::max();
+
+    /** Smoothing groups of one object, using the same material. */
+    struct ObjSubmeshSource
+    {
+        size_t objectIndex;
+        std::vector<const ObjMeshFile::SmoothingGroup*> smoothingGroups;
+        size_t triangleCount;
+    };
+
+    /** Generated normals of all faces without normals, sharing smoothing group id within an object. */
+    struct ObjSmoothingGroupNormals
+    {
+        size_t objectIndex;
+        uint32_t id;
+        std::vector<const ObjMeshFile::Triangles*> triangles;
+        std::vector<uint32_t> vertexIndices; ///< Sorted and unique global obj vertex indices.
+        std::vector<Vector3f32> normals; ///< Normal of each vertex index.
+
+        [[nodiscard]] bool operator < (const ObjSmoothingGroupNormals& rhs) const
+        {
+            return objectIndex < rhs.objectIndex || (objectIndex == rhs.objectIndex && id < rhs.id);
+        }
+
+        [[nodiscard]] const Vector3f32* Find(const uint32_t vertexIndex) const
+        {
+            const auto it = std::lower_bound(vertexIndices.begin(), vertexIndices.end(), vertexIndex);
+            if (it == vertexIndices.end() || *it != vertexIndex)
+            {
+                return nullptr;
+            }
+            return &normals[static_cast<size_t>(std::distance(vertexIndices.begin(), it))];
+        }
+    };
+
+    using ObjSmoothingGroupNormalsList = std::vector<ObjSmoothingGroupNormals>;
+
+    /** Offsets of object vertex data, in number of elements preceding each object. */
+    using ObjDataOffsets = std::vector<size_t>;
+
+    template<typename TData>
+    struct ObjDataLookup
+    {
+        const ObjMeshFile::ObjectSharedPointers& objects;
+        const ObjDataOffsets& offsets;
+        TData ObjMeshFile::Object::* member;
+
+        /** Finds data of global 1-based index, starting search at object of current face. */
+        [[nodiscard]] const auto* Find(const size_t objectIndex, const uint32_t index) const
+        {
+            using ValueType = typename TData::value_type;
+
+            if (index == 0)
+            {
+                return static_cast<const ValueType*>(nullptr);
+            }
+            const size_t globalIndex = index - 1;
+
+            if (const auto& data = (*objects[objectIndex]).*member; globalIndex >= offsets[objectIndex])
+            {
+                if (const auto localIndex = globalIndex - offsets[objectIndex]; localIndex < data.size())
+                {
+                    return &data[localIndex];
+                }
+            }
+
+            // Objects without data of this type share offset with following object, so the last object with a matching offset is the owner.
+            const auto it = std::upper_bound(offsets.begin(), offsets.end(), globalIndex);
+            if (it == offsets.begin())
+            {
+                return static_cast<const ValueType*>(nullptr);
+            }
+
+            const auto ownerIndex = static_cast<size_t>(std::distance(offsets.begin(), it)) - 1;
+            const auto& data = (*objects[ownerIndex]).*member;
+            if (const auto localIndex = globalIndex - offsets[ownerIndex]; localIndex < data.size())
+            {
+                return &data[localIndex];
+            }
+
+            return static_cast<const ValueType*>(nullptr);
+        }
+    };
+
+    /** Open addressing hash table of welded vertices, keyed by obj face indices and smoothing group of generated normals. */
+    class ObjVertexWelder
+    {
+
+    public:
+
+        explicit ObjVertexWelder(const size_t maxVertexCount) :
+            m_mask(0)
+        {
+            size_t capacity = 16;
+            while (capacity < maxVertexCount * 2)
+            {
+                capacity *= 2;
+            }
+
+            m_entries.resize(capacity, Entry{ UnusedObjIndex, 0, 0, 0, 0 });
+            m_mask = capacity - 1;
+        }
+
+        /** Finds welded vertex index of face element, or inserts newVertexIndex if not found.
+         *
+         * @return Pair of welded vertex index and true if inserted.
+         */
+        std::pair<uint32_t, bool> FindOrInsert(
+            const uint32_t vertex,
+            const uint32_t textureCoordinate,
+            const uint32_t normal,
+            const uint32_t smoothingGroupId,
+            const uint32_t newVertexIndex)
+        {
+            uint64_t hash = (static_cast<uint64_t>(vertex) * 0x9E3779B97F4A7C15ULL) ^
+                (static_cast<uint64_t>(textureCoordinate) * 0xC2B2AE3D27D4EB4FULL) ^
+                (static_cast<uint64_t>(normal) * 0x165667B19E3779F9ULL) ^
+                (static_cast<uint64_t>(smoothingGroupId) * 0x27D4EB2F165667C5ULL);
+            hash ^= hash >> 29;
+
+            for (size_t slot = static_cast<size_t>(hash) & m_mask;; slot = (slot + 1) & m_mask)
+            {
+                auto& entry = m_entries[slot];
+                if (entry.vertex == UnusedObjIndex)
+                {
+                    entry = Entry{ vertex, textureCoordinate, normal, smoothingGroupId, newVertexIndex };
+                    return { newVertexIndex, true };
+                }
+                if (entry.vertex == vertex && entry.textureCoordinate == textureCoordinate && entry.normal == normal &&
+                    entry.smoothingGroupId == smoothingGroupId)
+                {
+                    return { entry.vertexIndex, false };
+                }
+            }
+        }
+
+    private:
+
+        struct Entry
+        {
+            uint32_t vertex;
+            uint32_t textureCoordinate;
+            uint32_t normal;
+            uint32_t smoothingGroupId;
+            uint32_t vertexIndex;
+        };
+
+        std::vector<Entry> m_entries;
+        size_t m_mask;
+
+    };
+
+    static ObjDataOffsets CreateObjDataOffsets(
+        const ObjMeshFile::ObjectSharedPointers& objects,
+        size_t (*getSize)(const ObjMeshFile::Object&))
+    {
+        ObjDataOffsets offsets;
+        offsets.reserve(objects.size());
+
+        size_t offset = 0;
+        for (const auto& object : objects)
+        {
+            offsets.push_back(offset);
+            offset += getSize(*object);
+        }
+
+        return offsets;
+    }
+
+    static bool IsMissingObjNormal(const ObjMeshFile::Triangle& triangle)
+    {
+        return triangle.normalIndices[0] == UnusedObjIndex ||
+            triangle.normalIndices[1] == UnusedObjIndex ||
+            triangle.normalIndices[2] == UnusedObjIndex;
+    }
+
+    static std::string CreateObjVertexIndexError(const uint32_t vertexIndex)
+    {
+        return vertexIndex == UnusedObjIndex ?
+            "Face is missing vertex index" :
+            "Face vertex index " + std::to_string(vertexIndex) + " is out of range";
+    }
+
+    /** Generates angle weighted normals of faces without normals in smoothing group.
+     *  Positions out of range are ignored here and reported while building sub-meshes.
+     */
+    static void GenerateObjSmoothingGroupNormals(
+        ObjSmoothingGroupNormals& smoothingGroupNormals,
+        const ObjDataLookup<ObjMeshFile::Vertices>& vertexLookup)
+    {
+        auto& vertexIndices = smoothingGroupNormals.vertexIndices;
+        for (const auto* triangles : smoothingGroupNormals.triangles)
+        {
+            for (const auto& triangle : *triangles)
+            {
+                if (IsMissingObjNormal(triangle))
+                {
+                    vertexIndices.insert(vertexIndices.end(), triangle.vertexIndices.begin(), triangle.vertexIndices.end());
+                }
+            }
+        }
+
+        std::sort(vertexIndices.begin(), vertexIndices.end());
+        vertexIndices.erase(std::unique(vertexIndices.begin(), vertexIndices.end()), vertexIndices.end());
+
+        std::vector<Vector3f32> positions;
+        positions.reserve(vertexIndices.size());
+        for (const auto vertexIndex : vertexIndices)
+        {
+            const auto* position = vertexLookup.Find(smoothingGroupNormals.objectIndex, vertexIndex);
+            positions.push_back(position != nullptr ? *position : Vector3f32{ 0.0f, 0.0f, 0.0f });
+        }
+
+        std::vector<uint32_t> indices;
+        for (const auto* triangles : smoothingGroupNormals.triangles)
+        {
+            for (const auto& triangle : *triangles)
+            {
+                if (!IsMissingObjNormal(triangle))
+                {
+                    continue;
+                }
+
+                for (const auto vertexIndex : triangle.vertexIndices)
+                {
+                    const auto it = std::lower_bound(vertexIndices.begin(), vertexIndices.end(), vertexIndex);
+                    indices.push_back(static_cast<uint32_t>(std::distance(vertexIndices.begin(), it)));
+                }
+            }
+        }
+
+        smoothingGroupNormals.normals = MeshNormalGenerator::GenerateSmoothNormals(positions, indices);
+    }
+
+    /** Welds and packs triangles of source into submesh.
+     *  Faces without normals get generated smooth normals if part of a smoothing group, else flat face normals.
+     *
+     * @return Empty string on success, else error message.
+     */
+    static std::string BuildObjSubmesh(
+        const ObjSubmeshSource& source,
+        const ObjDataLookup<ObjMeshFile::Vertices>& vertexLookup,
+        const ObjDataLookup<ObjMeshFile::Uv>& textureCoordinateLookup,
+        const ObjDataLookup<ObjMeshFile::Normals>& normalLookup,
+        const ObjSmoothingGroupNormalsList& smoothingGroupNormalsList,
+        IndexedSubmesh& submesh)
+    {
+        const auto indexCount = source.triangleCount * 3;
+        ObjVertexWelder welder(indexCount);
+
+        auto& vertices = submesh.vertices;
+        vertices.reserve(indexCount);
+
+        std::vector<uint32_t> indices;
+        indices.reserve(indexCount);
+
+        for (const auto* smoothingGroup : source.smoothingGroups)
+        {
+            const auto smoothingGroupId = smoothingGroup->id;
+
+            const ObjSmoothingGroupNormals* smoothingGroupNormals = nullptr;
+            if (smoothingGroupId != 0)
+            {
+                const ObjSmoothingGroupNormals key{ source.objectIndex, smoothingGroupId, {}, {}, {} };
+                const auto it = std::lower_bound(smoothingGroupNormalsList.begin(), smoothingGroupNormalsList.end(), key);
+                if (it != smoothingGroupNormalsList.end() && it->objectIndex == source.objectIndex && it->id == smoothingGroupId)
+                {
+                    smoothingGroupNormals = &*it;
+                }
+            }
+
+            for (const auto& triangle : smoothingGroup->triangles)
+            {
+                // Flat shaded faces are not welded, since the face normal is unique to each triangle.
+                const auto flatShaded = smoothingGroupId == 0 && IsMissingObjNormal(triangle);
+                Vector3f32 faceNormal = { 0.0f, 0.0f, 0.0f };
+                if (flatShaded)
+                {
+                    const Vector3f32* positions[3] = {};
+                    for (size_t i = 0; i < 3; i++)
+                    {
+                        positions[i] = vertexLookup.Find(source.objectIndex, triangle.vertexIndices[i]);
+                        if (positions[i] == nullptr)
+                        {
+                            return CreateObjVertexIndexError(triangle.vertexIndices[i]);
+                        }
+                    }
+                    faceNormal = MeshNormalGenerator::CalculateTriangleNormal(*positions[0], *positions[1], *positions[2]);
+                }
+
+                for (size_t i = 0; i < 3; i++)
+                {
+                    const auto vertexIndex = triangle.vertexIndices[i];
+                    const auto textureCoordinateIndex = triangle.textureCoordinateIndices[i];
+                    const auto normalIndex = triangle.normalIndices[i];
+                    const auto generatedNormal = normalIndex == UnusedObjIndex && !flatShaded;
+
+                    const auto [index, inserted] = flatShaded && normalIndex == UnusedObjIndex ?
+                        std::pair<uint32_t, bool>{ static_cast<uint32_t>(vertices.size()), true } :
+                        welder.FindOrInsert(vertexIndex, textureCoordinateIndex, normalIndex,
+                            generatedNormal ? smoothingGroupId : 0, static_cast<uint32_t>(vertices.size()));
+                    indices.push_back(index);
+
+                    if (!inserted)
+                    {
+                        continue;
+                    }
+
+                    const auto* position = vertexLookup.Find(source.objectIndex, vertexIndex);
+                    if (position == nullptr)
+                    {
+                        return CreateObjVertexIndexError(vertexIndex);
+                    }
+
+                    auto& vertex = vertices.emplace_back(IndexedMeshVertex{ *position, faceNormal, { 0.0f, 0.0f } });
+
+                    if (textureCoordinateIndex != UnusedObjIndex)
+                    {
+                        const auto* textureCoordinate = textureCoordinateLookup.Find(source.objectIndex, textureCoordinateIndex);
+                        if (textureCoordinate == nullptr)
+                        {
+                            return "Face texture coordinate index " + std::to_string(textureCoordinateIndex) + " is out of range";
+                        }
+                        vertex.textureCoordinate = *textureCoordinate;
+                    }
+
+                    if (normalIndex != UnusedObjIndex)
+                    {
+                        const auto* normal = normalLookup.Find(source.objectIndex, normalIndex);
+                        if (normal == nullptr)
+                        {
+                            return "Face normal index " + std::to_string(normalIndex) + " is out of range";
+                        }
+                        vertex.normal = *normal;
+                    }
+                    else if (generatedNormal && smoothingGroupNormals != nullptr)
+                    {
+                        if (const auto* normal = smoothingGroupNormals->Find(vertexIndex); normal != nullptr)
+                        {
+                            vertex.normal = *normal;
+                        }
+                    }
+                }
+            }
+        }
+
+        vertices.shrink_to_fit();
+        submesh.SetIndices(indices);
+        return {};
+    }
+
+    /** Calls function for each index in range [0, count), in parallel if thread pool is provided. */
+    template<typename TFunction>
+    static void ObjParallelFor(ThreadPool* threadPool, const size_t count, TFunction&& function)
+    {
+        if (threadPool)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Background, count, function);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                function(i);
+            }
+        }
+    }
+
+
+    // Indexed mesh builder implementations.
+    IndexedMeshBuilder::BuildResult IndexedMeshBuilder::BuildFromObjMeshFile(
+        const ObjMeshFile& objMeshFile,
+        ThreadPool* threadPool)
+    {
+        const auto& objects = objMeshFile.objects;
+
+        const auto vertexOffsets = CreateObjDataOffsets(objects, [](const ObjMeshFile::Object& object) { return object.vertices.size(); });
+        const auto textureCoordinateOffsets = CreateObjDataOffsets(objects, [](const ObjMeshFile::Object& object) { return object.textureCoordinates.size(); });
+        const auto normalOffsets = CreateObjDataOffsets(objects, [](const ObjMeshFile::Object& object) { return object.normals.size(); });
+
+        const ObjDataLookup<ObjMeshFile::Vertices> vertexLookup{ objects, vertexOffsets, &ObjMeshFile::Object::vertices };
+        const ObjDataLookup<ObjMeshFile::Uv> textureCoordinateLookup{ objects, textureCoordinateOffsets, &ObjMeshFile::Object::textureCoordinates };
+        const ObjDataLookup<ObjMeshFile::Normals> normalLookup{ objects, normalOffsets, &ObjMeshFile::Object::normals };
+
+        // Collect triangles of each sub-mesh, merging groups of the same material.
+        IndexedMeshes meshes(objects.size());
+        std::vector<ObjSubmeshSource> sources;
+        std::vector<IndexedSubmesh*> submeshes;
+        ObjSmoothingGroupNormalsList smoothingGroupNormalsList;
+
+        for (size_t objectIndex = 0; objectIndex < objects.size(); objectIndex++)
+        {
+            const auto& object = *objects[objectIndex];
+            auto& mesh = meshes[objectIndex];
+            mesh.name = object.name;
+
+            // Sources of this object are stored in the same order as its sub-meshes.
+            const auto firstSource = sources.size();
+            const auto firstSmoothingGroupNormals = smoothingGroupNormalsList.size();
+            for (const auto& group : object.groups)
+            {
+                size_t submeshIndex = 0;
+                while (submeshIndex < mesh.submeshes.size() && mesh.submeshes[submeshIndex].material != group->material)
+                {
+                    ++submeshIndex;
+                }
+
+                for (const auto& smoothingGroup : group->smoothingGroups)
+                {
+                    if (smoothingGroup->triangles.empty())
+                    {
+                        continue;
+                    }
+
+                    if (submeshIndex == mesh.submeshes.size())
+                    {
+                        mesh.submeshes.emplace_back().material = group->material;
+                        sources.push_back(ObjSubmeshSource{ objectIndex, {}, 0 });
+                    }
+
+                    auto& source = sources[firstSource + submeshIndex];
+                    source.smoothingGroups.push_back(smoothingGroup.get());
+                    source.triangleCount += smoothingGroup->triangles.size();
+
+                    // Smoothing groups of the same id are smoothed together, across groups and materials of the object.
+                    const auto& triangles = smoothingGroup->triangles;
+                    if (smoothingGroup->id == 0 || std::none_of(triangles.begin(), triangles.end(), IsMissingObjNormal))
+                    {
+                        continue;
+                    }
+
+                    auto smoothingGroupNormalsIt = std::find_if(
+                        smoothingGroupNormalsList.begin() + static_cast<std::ptrdiff_t>(firstSmoothingGroupNormals),
+                        smoothingGroupNormalsList.end(),
+                        [&](const auto& smoothingGroupNormals) { return smoothingGroupNormals.id == smoothingGroup->id; });
+
+                    if (smoothingGroupNormalsIt == smoothingGroupNormalsList.end())
+                    {
+                        smoothingGroupNormalsIt = smoothingGroupNormalsList.insert(
+                            smoothingGroupNormalsList.end(),
+                            ObjSmoothingGroupNormals{ objectIndex, smoothingGroup->id, {}, {}, {} });
+                    }
+                    smoothingGroupNormalsIt->triangles.push_back(&triangles);
+                }
+            }
+        }
+
+        for (auto& mesh : meshes)
+        {
+            for (auto& submesh : mesh.submeshes)
+            {
+                submeshes.push_back(&submesh);
+            }
+        }
+
+        // Generate missing normals of smoothing groups, before sub-meshes are built, since they may span multiple sub-meshes.
+        std::sort(smoothingGroupNormalsList.begin(), smoothingGroupNormalsList.end());
+
+        ObjParallelFor(threadPool, smoothingGroupNormalsList.size(), [&](const size_t index)
+        {
+            GenerateObjSmoothingGroupNormals(smoothingGroupNormalsList[index], vertexLookup);
+        });
+
+        // Build sub-meshes, reporting first error in file order.
+        std::vector<std::string> errors(sources.size());
+
+        ObjParallelFor(threadPool, sources.size(), [&](const size_t index)
+        {
+            auto& submesh = *submeshes[index];
+            errors[index] = BuildObjSubmesh(
+                sources[index], vertexLookup, textureCoordinateLookup, normalLookup, smoothingGroupNormalsList, submesh);
+
+            if (errors[index].empty())
+            {
+                MeshNormalGenerator::GenerateTangents(submesh);
+            }
+        });
+
+        for (size_t i = 0; i < errors.size(); i++)
+        {
+            if (!errors[i].empty())
+            {
+                const auto& objectName = objects[sources[i].objectIndex]->name;
+                return BuildResult::CreateError("Object \"" + objectName + "\": " + errors[i]);
+            }
+        }
+
+        return BuildResult::CreateSuccess(std::move(meshes));
+    }
+
+}
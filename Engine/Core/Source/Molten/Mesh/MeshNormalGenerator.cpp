@@ -0,0 +1,250 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/MeshNormalGenerator.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint32_t InvalidNormalGeneratorIndex = std::numeric_limits<uint32_t>::max();
+    static constexpr float MinTextureSpaceArea = 1.0e-12f;
+
+    static float CalculateVectorAngle(const Vector3f32& lhs, const Vector3f32& rhs)
+    {
+        const auto lengths = lhs.Length() * rhs.Length();
+        if (lengths <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        return std::acos(std::clamp(lhs.Dot(rhs) / lengths, -1.0f, 1.0f));
+    }
+
+    /** Projects vector onto plane of unit normal. */
+    static Vector3f32 ProjectOnNormalPlane(const Vector3f32& vector, const Vector3f32& normal)
+    {
+        return vector - (normal * normal.Dot(vector));
+    }
+
+    /** Creates arbitrary unit vector orthogonal to normal. */
+    static Vector3f32 CreateOrthogonalVector(const Vector3f32& normal)
+    {
+        const Vector3f32 axis = std::abs(normal.x) < 0.9f ? Vector3f32{ 1.0f, 0.0f, 0.0f } : Vector3f32{ 0.0f, 1.0f, 0.0f };
+        const auto orthogonal = ProjectOnNormalPlane(axis, normal);
+        return orthogonal.Length() > 0.0f ? orthogonal.Normal() : Vector3f32{ 1.0f, 0.0f, 0.0f };
+    }
+
+
+    // Mesh normal generator implementations.
+    Vector3f32 MeshNormalGenerator::CalculateTriangleNormal(
+        const Vector3f32& position0,
+        const Vector3f32& position1,
+        const Vector3f32& position2)
+    {
+        return (position1 - position0).Cross(position2 - position0).Normal();
+    }
+
+    std::array<float, 3> MeshNormalGenerator::CalculateTriangleAngles(
+        const Vector3f32& position0,
+        const Vector3f32& position1,
+        const Vector3f32& position2)
+    {
+        return {
+            CalculateVectorAngle(position1 - position0, position2 - position0),
+            CalculateVectorAngle(position2 - position1, position0 - position1),
+            CalculateVectorAngle(position0 - position2, position1 - position2)
+        };
+    }
+
+    std::vector<Vector3f32> MeshNormalGenerator::GenerateSmoothNormals(
+        const std::vector<Vector3f32>& positions,
+        const std::vector<uint32_t>& indices)
+    {
+        std::vector<Vector3f32> normals(positions.size(), Vector3f32{ 0.0f, 0.0f, 0.0f });
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const auto& position0 = positions[indices[i]];
+            const auto& position1 = positions[indices[i + 1]];
+            const auto& position2 = positions[indices[i + 2]];
+
+            const auto normal = CalculateTriangleNormal(position0, position1, position2);
+            const auto angles = CalculateTriangleAngles(position0, position1, position2);
+            for (size_t j = 0; j < 3; j++)
+            {
+                normals[indices[i + j]] += normal * angles[j];
+            }
+        }
+
+        for (auto& normal : normals)
+        {
+            normal = normal.Normal();
+        }
+
+        return normals;
+    }
+
+    void MeshNormalGenerator::GenerateTangents(
+        IndexedMeshVertices& vertices,
+        std::vector<uint32_t>& indices)
+    {
+        const auto triangleCount = indices.size() / 3;
+
+        // Unit tangent and handedness of each triangle, where handedness is zero if texture coordinates are degenerate.
+        std::vector<Vector3f32> triangleTangents(triangleCount);
+        std::vector<float> triangleSigns(triangleCount, 0.0f);
+
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            const auto& vertex0 = vertices[indices[triangle * 3]];
+            const auto& vertex1 = vertices[indices[triangle * 3 + 1]];
+            const auto& vertex2 = vertices[indices[triangle * 3 + 2]];
+
+            const auto edge1 = vertex1.position - vertex0.position;
+            const auto edge2 = vertex2.position - vertex0.position;
+            const auto textureEdge1 = vertex1.textureCoordinate - vertex0.textureCoordinate;
+            const auto textureEdge2 = vertex2.textureCoordinate - vertex0.textureCoordinate;
+
+            const auto signedArea = (textureEdge1.x * textureEdge2.y) - (textureEdge2.x * textureEdge1.y);
+            const auto tangent = (edge1 * textureEdge2.y) - (edge2 * textureEdge1.y);
+            if (std::abs(signedArea) <= MinTextureSpaceArea || tangent.Length() <= 0.0f)
+            {
+                continue;
+            }
+
+            const auto sign = signedArea > 0.0f ? 1.0f : -1.0f;
+            triangleTangents[triangle] = tangent.Normal() * sign;
+            triangleSigns[triangle] = sign;
+        }
+
+        // Split vertices shared by triangles of both handedness.
+        std::vector<uint8_t> handedness(vertices.size(), 0);
+        for (size_t i = 0; i < triangleCount * 3; i++)
+        {
+            const auto sign = triangleSigns[i / 3];
+            handedness[indices[i]] |= sign > 0.0f ? 1 : (sign < 0.0f ? 2 : 0);
+        }
+
+        std::vector<uint32_t> mirroredVertices(vertices.size(), InvalidNormalGeneratorIndex);
+        for (size_t i = 0; i < triangleCount * 3; i++)
+        {
+            const auto vertexIndex = indices[i];
+            if (handedness[vertexIndex] != 3 || triangleSigns[i / 3] >= 0.0f)
+            {
+                continue;
+            }
+
+            if (mirroredVertices[vertexIndex] == InvalidNormalGeneratorIndex)
+            {
+                mirroredVertices[vertexIndex] = static_cast<uint32_t>(vertices.size());
+                const auto vertex = vertices[vertexIndex];
+                vertices.push_back(vertex);
+            }
+            indices[i] = mirroredVertices[vertexIndex];
+        }
+
+        // Accumulate angle weighted triangle tangents, projected onto the normal plane of each vertex.
+        std::vector<Vector3f32> tangents(vertices.size(), Vector3f32{ 0.0f, 0.0f, 0.0f });
+        std::vector<float> signs(vertices.size(), 0.0f);
+
+        for (size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            const auto sign = triangleSigns[triangle];
+            if (sign == 0.0f)
+            {
+                continue;
+            }
+
+            const uint32_t triangleIndices[3] = { indices[triangle * 3], indices[triangle * 3 + 1], indices[triangle * 3 + 2] };
+            const auto angles = CalculateTriangleAngles(
+                vertices[triangleIndices[0]].position, vertices[triangleIndices[1]].position, vertices[triangleIndices[2]].position);
+
+            for (size_t i = 0; i < 3; i++)
+            {
+                const auto vertexIndex = triangleIndices[i];
+                const auto tangent = ProjectOnNormalPlane(triangleTangents[triangle], vertices[vertexIndex].normal.Normal());
+                if (tangent.Length() > 0.0f)
+                {
+                    tangents[vertexIndex] += tangent.Normal() * angles[i];
+                    signs[vertexIndex] += sign * angles[i];
+                }
+            }
+        }
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            auto& vertex = vertices[i];
+            const auto normal = vertex.normal.Normal();
+
+            auto tangent = ProjectOnNormalPlane(tangents[i], normal);
+            tangent = tangent.Length() > 0.0f ? tangent.Normal() : CreateOrthogonalVector(normal);
+
+            vertex.tangent = { tangent.x, tangent.y, tangent.z, signs[i] < 0.0f ? -1.0f : 1.0f };
+        }
+    }
+
+    void MeshNormalGenerator::GenerateTangents(IndexedSubmesh& submesh)
+    {
+        auto indices = submesh.GetIndices();
+        GenerateTangents(submesh.vertices, indices);
+        submesh.SetIndices(indices);
+    }
+
+    void MeshNormalGenerator::GenerateTangents(IndexedMeshes& meshes, ThreadPool* threadPool)
+    {
+        std::vector<IndexedSubmesh*> submeshes;
+        for (auto& mesh : meshes)
+        {
+            for (auto& submesh : mesh.submeshes)
+            {
+                submeshes.push_back(&submesh);
+            }
+        }
+
+        auto generateTangents = [&](const size_t index)
+        {
+            GenerateTangents(*submeshes[index]);
+        };
+
+        if (threadPool)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Background, submeshes.size(), generateTangents);
+        }
+        else
+        {
+            for (size_t i = 0; i < submeshes.size(); i++)
+            {
+                generateTangents(i);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,494 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/MeshOptimizer.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint32_t InvalidOptimizerIndex = std::numeric_limits<uint32_t>::max();
+    static constexpr float ForsythCacheDecayPower = 1.5f;
+    static constexpr float ForsythLastTriangleScore = 0.75f;
+    static constexpr float ForsythValenceBoostScale = 2.0f;
+    static constexpr float ForsythValenceBoostPower = 0.5f;
+    static constexpr size_t ForsythValenceTableSize = 64;
+
+    /** FIFO vertex cache simulation, tracking insertion time of each vertex. */
+    class FifoVertexCache
+    {
+
+    public:
+
+        FifoVertexCache(const size_t vertexCount, const size_t cacheSize) :
+            m_timestamps(vertexCount, 0),
+            m_time(cacheSize + 1),
+            m_cacheSize(cacheSize)
+        {}
+
+        /** Accesses vertex, inserting it if not cached. @return 1 if vertex was missed, else 0. */
+        size_t Access(const uint32_t vertex)
+        {
+            if (m_time - m_timestamps[vertex] < m_cacheSize)
+            {
+                return 0;
+            }
+
+            m_timestamps[vertex] = ++m_time;
+            return 1;
+        }
+
+        size_t AccessTriangle(const uint32_t* triangle)
+        {
+            return Access(triangle[0]) + Access(triangle[1]) + Access(triangle[2]);
+        }
+
+        void Flush()
+        {
+            m_time += m_cacheSize + 1;
+        }
+
+    private:
+
+        std::vector<size_t> m_timestamps;
+        size_t m_time;
+        size_t m_cacheSize;
+
+    };
+
+    static size_t GetVertexCount(const std::vector<uint32_t>& indices)
+    {
+        return indices.empty() ? 0 : static_cast<size_t>(*std::max_element(indices.begin(), indices.end())) + 1;
+    }
+
+    /** Creates map from old to new vertex index, ordered by first use in indices. Unused vertices are mapped to InvalidOptimizerIndex. */
+    static std::vector<uint32_t> CreateVertexFetchRemap(const IndexedMeshVertices& vertices, const std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), InvalidOptimizerIndex);
+        uint32_t vertexCount = 0;
+
+        for (const auto index : indices)
+        {
+            if (auto& newIndex = remap[index]; newIndex == InvalidOptimizerIndex)
+            {
+                newIndex = vertexCount++;
+            }
+        }
+
+        return remap;
+    }
+
+    static void RemapVertices(IndexedMeshVertices& vertices, std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap)
+    {
+        IndexedMeshVertices output(vertices.size() - static_cast<size_t>(std::count(remap.begin(), remap.end(), InvalidOptimizerIndex)));
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            if (remap[i] != InvalidOptimizerIndex)
+            {
+                output[remap[i]] = vertices[i];
+            }
+        }
+
+        for (auto& index : indices)
+        {
+            index = remap[index];
+        }
+
+        vertices = std::move(output);
+    }
+
+
+    // Mesh optimizer implementations.
+    void MeshOptimizer::OptimizeVertexCache(
+        std::vector<uint32_t>& indices,
+        const size_t vertexCount,
+        const size_t cacheSize)
+    {
+        const auto triangleCount = indices.size() / 3;
+        if (triangleCount < 2 || cacheSize < 4)
+        {
+            return;
+        }
+
+        // Score tables.
+        std::vector<float> cacheScores(cacheSize);
+        for (size_t i = 0; i < cacheSize; i++)
+        {
+            cacheScores[i] = i < 3 ?
+                ForsythLastTriangleScore :
+                std::pow(1.0f - (static_cast<float>(i - 3) / static_cast<float>(cacheSize - 3)), ForsythCacheDecayPower);
+        }
+
+        std::vector<float> valenceScores(ForsythValenceTableSize);
+        for (size_t i = 1; i < ForsythValenceTableSize; i++)
+        {
+            valenceScores[i] = ForsythValenceBoostScale * std::pow(static_cast<float>(i), -ForsythValenceBoostPower);
+        }
+
+        auto calculateVertexScore = [&](const int32_t cachePosition, const uint32_t remainingTriangles)
+        {
+            if (remainingTriangles == 0)
+            {
+                return -1.0f;
+            }
+
+            const auto cacheScore = cachePosition >= 0 ? cacheScores[static_cast<size_t>(cachePosition)] : 0.0f;
+            const auto valenceScore = remainingTriangles < ForsythValenceTableSize ?
+                valenceScores[remainingTriangles] :
+                ForsythValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ForsythValenceBoostPower);
+            return cacheScore + valenceScore;
+        };
+
+        // Vertex to triangle adjacency. Emitted triangles are swapped to the end of each vertex range.
+        std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+        for (const auto index : indices)
+        {
+            ++remainingTriangles[index];
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingTriangles[i];
+        }
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            auto cursors = adjacencyOffsets;
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            vertexScores[i] = calculateVertexScore(-1, remainingTriangles[i]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        uint32_t bestTriangle = 0;
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            const auto* triangle = &indices[i * 3];
+            triangleScores[i] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+            if (triangleScores[i] > triangleScores[bestTriangle])
+            {
+                bestTriangle = static_cast<uint32_t>(i);
+            }
+        }
+
+        // Emit triangles, greedily picking the best scoring triangle adjacent to the cache.
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> newCache;
+        cache.reserve(cacheSize + 3);
+        newCache.reserve(cacheSize + 3);
+
+        size_t inputCursor = 0;
+
+        for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+        {
+            // Continue with next triangle in input order when no triangle is adjacent to the cache.
+            if (bestTriangle == InvalidOptimizerIndex)
+            {
+                while (emitted[inputCursor])
+                {
+                    ++inputCursor;
+                }
+                bestTriangle = static_cast<uint32_t>(inputCursor);
+            }
+
+            const uint32_t triangle[3] = {
+                indices[bestTriangle * 3],
+                indices[bestTriangle * 3 + 1],
+                indices[bestTriangle * 3 + 2]
+            };
+
+            output.insert(output.end(), triangle, triangle + 3);
+            emitted[bestTriangle] = 1;
+
+            for (const auto vertex : triangle)
+            {
+                auto* begin = adjacency.data() + adjacencyOffsets[vertex];
+                auto* end = begin + remainingTriangles[vertex];
+                auto* it = std::find(begin, end, bestTriangle);
+                if (it != end)
+                {
+                    std::swap(*it, *(end - 1));
+                    --remainingTriangles[vertex];
+                }
+            }
+
+            // Move triangle vertices to front of LRU cache.
+            newCache.assign(triangle, triangle + 3);
+            for (const auto vertex : cache)
+            {
+                if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                {
+                    newCache.push_back(vertex);
+                }
+            }
+
+            for (size_t i = 0; i < newCache.size(); i++)
+            {
+                const auto vertex = newCache[i];
+                cachePositions[vertex] = i < cacheSize ? static_cast<int32_t>(i) : -1;
+                vertexScores[vertex] = calculateVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+            }
+
+            // Rescore triangles of touched vertices, including vertices evicted from the cache.
+            bestTriangle = InvalidOptimizerIndex;
+            float bestScore = -std::numeric_limits<float>::max();
+
+            for (const auto vertex : newCache)
+            {
+                const auto* begin = adjacency.data() + adjacencyOffsets[vertex];
+                const auto* end = begin + remainingTriangles[vertex];
+                for (const auto* it = begin; it != end; ++it)
+                {
+                    const auto adjacentTriangle = *it;
+                    const auto* adjacentIndices = &indices[adjacentTriangle * 3];
+                    const auto score = vertexScores[adjacentIndices[0]] + vertexScores[adjacentIndices[1]] + vertexScores[adjacentIndices[2]];
+                    triangleScores[adjacentTriangle] = score;
+
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        bestTriangle = adjacentTriangle;
+                    }
+                }
+            }
+
+            newCache.resize(std::min(newCache.size(), cacheSize));
+            std::swap(cache, newCache);
+        }
+
+        indices = std::move(output);
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(
+        std::vector<uint32_t>& indices,
+        const IndexedMeshVertices& vertices,
+        const float threshold,
+        const size_t cacheSize)
+    {
+        const auto triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        const auto meshMissRatio = CalculateAverageCacheMissRatio(indices, vertices.size(), cacheSize);
+        const auto maxMissRatio = meshMissRatio * threshold;
+
+        // Split triangles into clusters at hard boundaries, where no vertex is cached,
+        // and at soft boundaries, where the miss ratio of the cluster so far is low enough to start over with a cold cache.
+        std::vector<size_t> clusterStarts = { 0 };
+        FifoVertexCache cache(vertices.size(), cacheSize);
+        size_t clusterMisses = 0;
+
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            const auto misses = cache.AccessTriangle(&indices[i * 3]);
+            if (misses == 3 && i > clusterStarts.back())
+            {
+                clusterStarts.push_back(i);
+                clusterMisses = 0;
+            }
+
+            clusterMisses += misses;
+
+            const auto clusterTriangleCount = i + 1 - clusterStarts.back();
+            if (i + 1 < triangleCount && static_cast<float>(clusterMisses) <= maxMissRatio * static_cast<float>(clusterTriangleCount))
+            {
+                clusterStarts.push_back(i + 1);
+                clusterMisses = 0;
+                cache.Flush();
+            }
+        }
+        clusterStarts.push_back(triangleCount);
+
+        const auto clusterCount = clusterStarts.size() - 1;
+        if (clusterCount < 2)
+        {
+            return;
+        }
+
+        // Sort clusters by how much they face away from the mesh center, drawing outer front-facing clusters first.
+        std::vector<Vector3f32> clusterCentroids(clusterCount, Vector3f32{ 0.0f, 0.0f, 0.0f });
+        std::vector<Vector3f32> clusterNormals(clusterCount, Vector3f32{ 0.0f, 0.0f, 0.0f });
+        Vector3f32 meshCentroid = { 0.0f, 0.0f, 0.0f };
+        float meshArea = 0.0f;
+
+        for (size_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            float clusterArea = 0.0f;
+            for (size_t i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; i++)
+            {
+                const auto& p0 = vertices[indices[i * 3]].position;
+                const auto& p1 = vertices[indices[i * 3 + 1]].position;
+                const auto& p2 = vertices[indices[i * 3 + 2]].position;
+
+                const auto normal = (p1 - p0).Cross(p2 - p0);
+                const auto area = normal.Length();
+                const auto centroid = (p0 + p1 + p2) / 3.0f;
+
+                clusterCentroids[cluster] += centroid * area;
+                clusterNormals[cluster] += normal;
+                clusterArea += area;
+            }
+
+            meshCentroid += clusterCentroids[cluster];
+            meshArea += clusterArea;
+
+            if (clusterArea > 0.0f)
+            {
+                clusterCentroids[cluster] /= clusterArea;
+            }
+        }
+
+        if (meshArea > 0.0f)
+        {
+            meshCentroid /= meshArea;
+        }
+
+        std::vector<float> clusterSortKeys(clusterCount);
+        for (size_t cluster = 0; cluster < clusterCount; cluster++)
+        {
+            clusterSortKeys[cluster] = (clusterCentroids[cluster] - meshCentroid).Dot(clusterNormals[cluster].Normal());
+        }
+
+        std::vector<size_t> clusterOrder(clusterCount);
+        std::iota(clusterOrder.begin(), clusterOrder.end(), size_t{ 0 });
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](const size_t lhs, const size_t rhs)
+        {
+            return clusterSortKeys[lhs] > clusterSortKeys[rhs];
+        });
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for (const auto cluster : clusterOrder)
+        {
+            output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[cluster] * 3),
+                indices.begin() + static_cast<std::ptrdiff_t>(clusterStarts[cluster + 1] * 3));
+        }
+
+        indices = std::move(output);
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(
+        IndexedMeshVertices& vertices,
+        std::vector<uint32_t>& indices)
+    {
+        const auto remap = CreateVertexFetchRemap(vertices, indices);
+        RemapVertices(vertices, indices, remap);
+    }
+
+    void MeshOptimizer::OptimizeSubmesh(IndexedSubmesh& submesh)
+    {
+        auto indices = submesh.GetIndices();
+        OptimizeVertexCache(indices, submesh.vertices.size());
+        OptimizeOverdraw(indices, submesh.vertices);
+
+        const auto remap = CreateVertexFetchRemap(submesh.vertices, indices);
+        RemapVertices(submesh.vertices, indices, remap);
+        submesh.SetIndices(indices);
+
+        // Levels of detail only reference vertices used by the full detail indices, so all of them are remapped.
+        for (auto& lod : submesh.lods)
+        {
+            auto lodIndices = lod.GetIndices();
+            for (auto& index : lodIndices)
+            {
+                index = remap[index];
+            }
+            lod.SetIndices(lodIndices);
+        }
+    }
+
+    void MeshOptimizer::OptimizeMeshes(IndexedMeshes& meshes, ThreadPool* threadPool)
+    {
+        std::vector<IndexedSubmesh*> submeshes;
+        for (auto& mesh : meshes)
+        {
+            for (auto& submesh : mesh.submeshes)
+            {
+                submeshes.push_back(&submesh);
+            }
+        }
+
+        auto optimizeSubmesh = [&](const size_t index)
+        {
+            OptimizeSubmesh(*submeshes[index]);
+        };
+
+        if (threadPool)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Background, submeshes.size(), optimizeSubmesh);
+        }
+        else
+        {
+            for (size_t i = 0; i < submeshes.size(); i++)
+            {
+                optimizeSubmesh(i);
+            }
+        }
+    }
+
+    float MeshOptimizer::CalculateAverageCacheMissRatio(
+        const std::vector<uint32_t>& indices,
+        const size_t vertexCount,
+        const size_t cacheSize)
+    {
+        const auto triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+        {
+            return 0.0f;
+        }
+
+        FifoVertexCache cache(std::max(vertexCount, GetVertexCount(indices)), cacheSize);
+
+        size_t misses = 0;
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            misses += cache.AccessTriangle(&indices[i * 3]);
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(triangleCount);
+    }
+
+}
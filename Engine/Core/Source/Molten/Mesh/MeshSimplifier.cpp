@@ -0,0 +1,742 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/MeshSimplifier.hpp"
+#include "Molten/Mesh/MeshOptimizer.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint32_t InvalidSimplifierIndex = std::numeric_limits<uint32_t>::max();
+
+    /** Symmetric 4x4 error quadric, accumulating area weighted squared distances to planes. */
+    struct SimplifierQuadric
+    {
+        double a00, a01, a02, a11, a12, a22;
+        double b0, b1, b2;
+        double c;
+        double weight;
+    };
+
+    /** Candidate of collapsing vertex "from" into vertex "to". */
+    struct SimplifierCollapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+        double positionError;
+    };
+
+    static void AddSimplifierPlane(SimplifierQuadric& quadric, const Vector3f64& normal, const double distance, const double weight)
+    {
+        quadric.a00 += weight * normal.x * normal.x;
+        quadric.a01 += weight * normal.x * normal.y;
+        quadric.a02 += weight * normal.x * normal.z;
+        quadric.a11 += weight * normal.y * normal.y;
+        quadric.a12 += weight * normal.y * normal.z;
+        quadric.a22 += weight * normal.z * normal.z;
+        quadric.b0 += weight * normal.x * distance;
+        quadric.b1 += weight * normal.y * distance;
+        quadric.b2 += weight * normal.z * distance;
+        quadric.c += weight * distance * distance;
+        quadric.weight += weight;
+    }
+
+    static void AddSimplifierQuadric(SimplifierQuadric& lhs, const SimplifierQuadric& rhs)
+    {
+        lhs.a00 += rhs.a00;
+        lhs.a01 += rhs.a01;
+        lhs.a02 += rhs.a02;
+        lhs.a11 += rhs.a11;
+        lhs.a12 += rhs.a12;
+        lhs.a22 += rhs.a22;
+        lhs.b0 += rhs.b0;
+        lhs.b1 += rhs.b1;
+        lhs.b2 += rhs.b2;
+        lhs.c += rhs.c;
+        lhs.weight += rhs.weight;
+    }
+
+    /** Evaluates sum of area weighted squared distances of point to planes of quadric. */
+    static double EvaluateSimplifierQuadric(const SimplifierQuadric& quadric, const Vector3f64& point)
+    {
+        const auto& p = point;
+        const auto error =
+            (quadric.a00 * p.x * p.x) + (quadric.a11 * p.y * p.y) + (quadric.a22 * p.z * p.z) +
+            2.0 * ((quadric.a01 * p.x * p.y) + (quadric.a02 * p.x * p.z) + (quadric.a12 * p.y * p.z)) +
+            2.0 * ((quadric.b0 * p.x) + (quadric.b1 * p.y) + (quadric.b2 * p.z)) +
+            quadric.c;
+
+        return std::max(error, 0.0);
+    }
+
+    static double CalculateSimplifierAttributeDistance(const IndexedMeshVertex& lhs, const IndexedMeshVertex& rhs)
+    {
+        const auto normal = lhs.normal - rhs.normal;
+        const auto textureCoordinate = lhs.textureCoordinate - rhs.textureCoordinate;
+        return static_cast<double>(normal.Dot(normal) + textureCoordinate.Dot(textureCoordinate));
+    }
+
+    /** Vertex to triangle adjacency, stored as compressed rows. */
+    struct SimplifierAdjacency
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+    };
+
+    static void BuildSimplifierAdjacency(SimplifierAdjacency& adjacency, const std::vector<uint32_t>& indices, const size_t vertexCount)
+    {
+        adjacency.offsets.assign(vertexCount + 1, 0);
+        for (const auto index : indices)
+        {
+            ++adjacency.offsets[index + 1];
+        }
+        std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+        adjacency.triangles.resize(indices.size());
+        std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    static bool SimplifierTriangleContains(const std::vector<uint32_t>& indices, const uint32_t triangle, const uint32_t vertex)
+    {
+        const auto* corners = indices.data() + (size_t{ triangle } * 3);
+        return corners[0] == vertex || corners[1] == vertex || corners[2] == vertex;
+    }
+
+    /** Assigns each vertex the lowest index of all referenced vertices sharing its position. */
+    static std::vector<uint32_t> CreateSimplifierPositionIds(
+        const IndexedMeshVertices& vertices,
+        const std::vector<uint8_t>& referenced)
+    {
+        struct PositionKey
+        {
+            float x, y, z;
+            uint32_t vertex;
+        };
+
+        std::vector<PositionKey> keys;
+        keys.reserve(vertices.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(vertices.size()); i++)
+        {
+            if (referenced[i])
+            {
+                const auto& position = vertices[i].position;
+                keys.push_back({ position.x, position.y, position.z, i });
+            }
+        }
+
+        std::sort(keys.begin(), keys.end(), [](const PositionKey& lhs, const PositionKey& rhs)
+        {
+            if (lhs.x != rhs.x) return lhs.x < rhs.x;
+            if (lhs.y != rhs.y) return lhs.y < rhs.y;
+            if (lhs.z != rhs.z) return lhs.z < rhs.z;
+            return lhs.vertex < rhs.vertex;
+        });
+
+        std::vector<uint32_t> positionIds(vertices.size(), InvalidSimplifierIndex);
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            const auto& key = keys[i];
+            const auto isShared = i > 0 && keys[i - 1].x == key.x && keys[i - 1].y == key.y && keys[i - 1].z == key.z;
+            positionIds[key.vertex] = isShared ? positionIds[keys[i - 1].vertex] : key.vertex;
+        }
+
+        return positionIds;
+    }
+
+    /** Vertices of each position, stored as compressed rows indexed by position id. */
+    struct SimplifierWedges
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> vertices;
+    };
+
+    static void BuildSimplifierWedges(SimplifierWedges& wedges, const std::vector<uint32_t>& positionIds)
+    {
+        const auto vertexCount = positionIds.size();
+        wedges.offsets.assign(vertexCount + 1, 0);
+        for (const auto positionId : positionIds)
+        {
+            if (positionId != InvalidSimplifierIndex)
+            {
+                ++wedges.offsets[positionId + 1];
+            }
+        }
+        std::partial_sum(wedges.offsets.begin(), wedges.offsets.end(), wedges.offsets.begin());
+
+        wedges.vertices.resize(wedges.offsets.back());
+        std::vector<uint32_t> fill(wedges.offsets.begin(), wedges.offsets.end() - 1);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(vertexCount); i++)
+        {
+            if (positionIds[i] != InvalidSimplifierIndex)
+            {
+                wedges.vertices[fill[positionIds[i]]++] = i;
+            }
+        }
+    }
+
+    /** Finds vertex of position with the most similar attributes to provided vertex. */
+    static uint32_t FindSimplifierWedge(
+        const IndexedMeshVertices& vertices,
+        const SimplifierWedges& wedges,
+        const uint32_t vertex,
+        const uint32_t positionId,
+        double& distance)
+    {
+        auto bestVertex = wedges.vertices[wedges.offsets[positionId]];
+        distance = std::numeric_limits<double>::max();
+        for (auto i = wedges.offsets[positionId]; i < wedges.offsets[positionId + 1]; i++)
+        {
+            const auto wedge = wedges.vertices[i];
+            if (const auto wedgeDistance = CalculateSimplifierAttributeDistance(vertices[vertex], vertices[wedge]); wedgeDistance < distance)
+            {
+                distance = wedgeDistance;
+                bestVertex = wedge;
+            }
+        }
+        return bestVertex;
+    }
+
+    /** Finds vertex of position "to" replacing vertex of position "from" in a collapse.
+     *  Vertices sharing a triangle with the collapsed vertex are preferred, so vertices stay on their side of texture coordinate seams.
+     */
+    static uint32_t FindSimplifierCollapseWedge(
+        const IndexedMeshVertices& vertices,
+        const SimplifierWedges& wedges,
+        const std::vector<uint32_t>& indices,
+        const std::vector<uint32_t>& positionIndices,
+        const SimplifierAdjacency& adjacency,
+        const uint32_t fromPositionId,
+        const uint32_t toPositionId,
+        const uint32_t vertex,
+        double& distance)
+    {
+        auto bestVertex = InvalidSimplifierIndex;
+        distance = std::numeric_limits<double>::max();
+        for (auto i = adjacency.offsets[fromPositionId]; i < adjacency.offsets[fromPositionId + 1]; i++)
+        {
+            const auto firstCorner = size_t{ adjacency.triangles[i] } * 3;
+            const auto* corners = indices.data() + firstCorner;
+            if (corners[0] != vertex && corners[1] != vertex && corners[2] != vertex)
+            {
+                continue;
+            }
+
+            for (size_t j = 0; j < 3; j++)
+            {
+                if (positionIndices[firstCorner + j] != toPositionId)
+                {
+                    continue;
+                }
+
+                if (const auto wedgeDistance = CalculateSimplifierAttributeDistance(vertices[vertex], vertices[corners[j]]); wedgeDistance < distance)
+                {
+                    distance = wedgeDistance;
+                    bestVertex = corners[j];
+                }
+            }
+        }
+
+        return bestVertex != InvalidSimplifierIndex ? bestVertex : FindSimplifierWedge(vertices, wedges, vertex, toPositionId, distance);
+    }
+
+    /** Calculates attribute difference of collapsing all vertices of a position into vertices of another position. */
+    static double CalculateSimplifierAttributeCost(
+        const IndexedMeshVertices& vertices,
+        const SimplifierWedges& wedges,
+        const std::vector<uint32_t>& indices,
+        const std::vector<uint32_t>& positionIndices,
+        const SimplifierAdjacency& adjacency,
+        const uint32_t fromPositionId,
+        const uint32_t toPositionId)
+    {
+        double cost = 0.0;
+        for (auto i = wedges.offsets[fromPositionId]; i < wedges.offsets[fromPositionId + 1]; i++)
+        {
+            double distance = 0.0;
+            FindSimplifierCollapseWedge(vertices, wedges, indices, positionIndices, adjacency, fromPositionId, toPositionId, wedges.vertices[i], distance);
+            cost = std::max(cost, distance);
+        }
+        return cost;
+    }
+
+    /** Locks positions of open borders, non-manifold edges and texture coordinate seams.
+     *  Positions only split by normals, such as corners of flat shaded meshes, are not locked, since all their vertices are collapsed together.
+     */
+    static std::vector<uint8_t> CreateSimplifierLocks(
+        const IndexedMeshVertices& vertices,
+        const std::vector<uint32_t>& positionIndices,
+        const SimplifierWedges& wedges)
+    {
+        const auto vertexCount = vertices.size();
+
+        SimplifierAdjacency adjacency;
+        BuildSimplifierAdjacency(adjacency, positionIndices, vertexCount);
+
+        std::vector<uint8_t> locked(vertexCount, 0);
+        for (size_t i = 0; i < positionIndices.size(); i++)
+        {
+            const auto first = positionIndices[i];
+            const auto second = positionIndices[i - (i % 3) + ((i + 1) % 3)];
+            if (first == second)
+            {
+                continue;
+            }
+
+            size_t edgeTriangleCount = 0;
+            for (auto j = adjacency.offsets[first]; j < adjacency.offsets[first + 1]; j++)
+            {
+                edgeTriangleCount += SimplifierTriangleContains(positionIndices, adjacency.triangles[j], second) ? 1 : 0;
+            }
+
+            if (edgeTriangleCount != 2)
+            {
+                locked[first] = 1;
+                locked[second] = 1;
+            }
+        }
+
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            const auto firstWedge = wedges.offsets[i];
+            for (auto j = firstWedge + 1; j < wedges.offsets[i + 1]; j++)
+            {
+                if (vertices[wedges.vertices[j]].textureCoordinate != vertices[wedges.vertices[firstWedge]].textureCoordinate)
+                {
+                    locked[i] = 1;
+                    break;
+                }
+            }
+        }
+
+        return locked;
+    }
+
+    /** Stamps of positions, for counting positions shared by neighborhoods of two vertices without sorting. */
+    struct SimplifierRingMarks
+    {
+        std::vector<uint32_t> stamps;
+        uint32_t stamp;
+    };
+
+    /** Checks if collapse keeps the mesh manifold and does not flip any triangle.
+     *
+     * @return Number of triangles removed by collapse, or 0 if the collapse is rejected.
+     */
+    static size_t ValidateSimplifierCollapse(
+        const SimplifierCollapse& collapse,
+        const std::vector<uint32_t>& indices,
+        const SimplifierAdjacency& adjacency,
+        const std::vector<Vector3f64>& positions,
+        const std::vector<uint32_t>& positionIds,
+        SimplifierRingMarks& ringMarks)
+    {
+        size_t removedTriangleCount = 0;
+        for (auto i = adjacency.offsets[collapse.from]; i < adjacency.offsets[collapse.from + 1]; i++)
+        {
+            const auto triangle = adjacency.triangles[i];
+            if (SimplifierTriangleContains(indices, triangle, collapse.to))
+            {
+                ++removedTriangleCount;
+                continue;
+            }
+
+            const auto* corners = indices.data() + (size_t{ triangle } * 3);
+            Vector3f64 oldPositions[3];
+            Vector3f64 newPositions[3];
+            for (size_t j = 0; j < 3; j++)
+            {
+                oldPositions[j] = positions[corners[j]];
+                newPositions[j] = corners[j] == collapse.from ? positions[collapse.to] : oldPositions[j];
+            }
+
+            const auto oldNormal = (oldPositions[1] - oldPositions[0]).Cross(oldPositions[2] - oldPositions[0]);
+            const auto newNormal = (newPositions[1] - newPositions[0]).Cross(newPositions[2] - newPositions[0]);
+            if (oldNormal.Dot(newNormal) <= 0.0)
+            {
+                return 0;
+            }
+        }
+
+        if (removedTriangleCount == 0)
+        {
+            return 0;
+        }
+
+        // Link condition: vertices connected to both endpoints must be opposite to the collapsed edge,
+        // else the collapse folds the surface into non-manifold edges.
+        const auto toStamp = ringMarks.stamp + 1;
+        const auto sharedStamp = ringMarks.stamp + 2;
+        ringMarks.stamp += 2;
+
+        auto forEachRingPosition = [&](const uint32_t vertex, auto&& callback)
+        {
+            for (auto i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1]; i++)
+            {
+                const auto* corners = indices.data() + (size_t{ adjacency.triangles[i] } * 3);
+                for (size_t j = 0; j < 3; j++)
+                {
+                    if (corners[j] != collapse.from && corners[j] != collapse.to)
+                    {
+                        callback(positionIds[corners[j]]);
+                    }
+                }
+            }
+        };
+
+        forEachRingPosition(collapse.to, [&](const uint32_t positionId)
+        {
+            ringMarks.stamps[positionId] = toStamp;
+        });
+
+        size_t sharedCount = 0;
+        forEachRingPosition(collapse.from, [&](const uint32_t positionId)
+        {
+            if (auto& stamp = ringMarks.stamps[positionId]; stamp == toStamp)
+            {
+                stamp = sharedStamp;
+                ++sharedCount;
+            }
+        });
+
+        return sharedCount <= removedTriangleCount ? removedTriangleCount : 0;
+    }
+
+
+    // Mesh simplifier implementations.
+    MeshSimplifier::Result MeshSimplifier::Simplify(
+        const IndexedMeshVertices& vertices,
+        const std::vector<uint32_t>& indices,
+        const size_t targetIndexCount,
+        const float maxError,
+        const float attributeWeight)
+    {
+        Result result = { indices, 0.0f };
+        auto& currentIndices = result.indices;
+        currentIndices.resize(indices.size() - (indices.size() % 3));
+
+        if (currentIndices.size() <= targetIndexCount)
+        {
+            return result;
+        }
+
+        const auto vertexCount = vertices.size();
+        std::vector<uint8_t> referenced(vertexCount, 0);
+        for (const auto index : currentIndices)
+        {
+            referenced[index] = 1;
+        }
+
+        // Normalize positions, so errors are relative to mesh extent.
+        Vector3f64 low = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+        Vector3f64 high = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+        for (const auto index : currentIndices)
+        {
+            for (size_t i = 0; i < 3; i++)
+            {
+                low.c[i] = std::min(low.c[i], static_cast<double>(vertices[index].position.c[i]));
+                high.c[i] = std::max(high.c[i], static_cast<double>(vertices[index].position.c[i]));
+            }
+        }
+
+        const auto extent = std::max({ high.x - low.x, high.y - low.y, high.z - low.z });
+        if (extent <= 0.0)
+        {
+            return result;
+        }
+
+        std::vector<Vector3f64> positions(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            const auto& position = vertices[i].position;
+            const Vector3f64 position64 = { static_cast<double>(position.x), static_cast<double>(position.y), static_cast<double>(position.z) };
+            positions[i] = (position64 - low) / extent;
+        }
+
+        // Topology is tracked per position, and all vertices of a position are collapsed together,
+        // so vertices split by normals or texture coordinates never open cracks.
+        const auto positionIds = CreateSimplifierPositionIds(vertices, referenced);
+
+        SimplifierWedges wedges;
+        BuildSimplifierWedges(wedges, positionIds);
+
+        std::vector<uint32_t> positionIndices(currentIndices.size());
+        for (size_t i = 0; i < currentIndices.size(); i++)
+        {
+            positionIndices[i] = positionIds[currentIndices[i]];
+        }
+
+        const auto locked = CreateSimplifierLocks(vertices, positionIndices, wedges);
+
+        // Quadrics are accumulated per position, so wedges of seams share their surface.
+        std::vector<SimplifierQuadric> quadrics(vertexCount, SimplifierQuadric{});
+        for (size_t i = 0; i < currentIndices.size(); i += 3)
+        {
+            const auto& p0 = positions[currentIndices[i]];
+            const auto& p1 = positions[currentIndices[i + 1]];
+            const auto& p2 = positions[currentIndices[i + 2]];
+
+            auto normal = (p1 - p0).Cross(p2 - p0);
+            const auto length = normal.Length();
+            if (length <= 0.0)
+            {
+                continue;
+            }
+            normal /= length;
+
+            const auto distance = -normal.Dot(p0);
+            const auto area = length * 0.5;
+            for (size_t j = 0; j < 3; j++)
+            {
+                AddSimplifierPlane(quadrics[positionIds[currentIndices[i + j]]], normal, distance, area);
+            }
+        }
+
+        const auto maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+        double maxPositionError = 0.0;
+
+        std::vector<uint32_t> wedgeTargets(vertexCount, InvalidSimplifierIndex);
+        std::vector<uint8_t> touched(vertexCount, 0);
+        std::vector<SimplifierCollapse> collapses;
+        SimplifierRingMarks ringMarks = { std::vector<uint32_t>(vertexCount, 0), 0 };
+        SimplifierAdjacency adjacency;
+        std::vector<double> vertexErrors(vertexCount, 0.0);
+
+        while (currentIndices.size() > targetIndexCount)
+        {
+            // Gather cheapest collapse of each unlocked position.
+            BuildSimplifierAdjacency(adjacency, positionIndices, vertexCount);
+
+            // Error of merged quadrics is the sum of the errors of both quadrics, so the error of each target position is evaluated once.
+            for (size_t i = 0; i < vertexCount; i++)
+            {
+                if (positionIds[i] == i)
+                {
+                    vertexErrors[i] = EvaluateSimplifierQuadric(quadrics[i], positions[i]);
+                }
+            }
+
+            collapses.clear();
+            for (uint32_t from = 0; from < static_cast<uint32_t>(vertexCount); from++)
+            {
+                if (locked[from] || adjacency.offsets[from] == adjacency.offsets[from + 1])
+                {
+                    continue;
+                }
+
+                const auto& fromQuadric = quadrics[from];
+
+                SimplifierCollapse bestCollapse = { from, InvalidSimplifierIndex, std::numeric_limits<double>::max(), 0.0 };
+                for (auto i = adjacency.offsets[from]; i < adjacency.offsets[from + 1]; i++)
+                {
+                    const auto* corners = positionIndices.data() + (size_t{ adjacency.triangles[i] } * 3);
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        const auto to = corners[j];
+                        if (to == from)
+                        {
+                            continue;
+                        }
+
+                        const auto weight = fromQuadric.weight + quadrics[to].weight;
+                        const auto positionError = weight > 0.0 ?
+                            (EvaluateSimplifierQuadric(fromQuadric, positions[to]) + vertexErrors[to]) / weight : 0.0;
+                        const auto cost = positionError +
+                            static_cast<double>(attributeWeight) * CalculateSimplifierAttributeCost(
+                                vertices, wedges, currentIndices, positionIndices, adjacency, from, to);
+
+                        if (cost < bestCollapse.cost || (cost == bestCollapse.cost && to < bestCollapse.to))
+                        {
+                            bestCollapse = { from, to, cost, positionError };
+                        }
+                    }
+                }
+
+                collapses.push_back(bestCollapse);
+            }
+
+            std::sort(collapses.begin(), collapses.end(), [](const auto& lhs, const auto& rhs)
+            {
+                return lhs.cost != rhs.cost ? lhs.cost < rhs.cost : lhs.from < rhs.from;
+            });
+
+            // Apply cheapest collapses of independent neighborhoods, until reaching the target triangle count.
+            std::fill(touched.begin(), touched.end(), uint8_t{ 0 });
+
+            const auto targetRemovedTriangleCount = (currentIndices.size() - targetIndexCount + 2) / 3;
+            size_t removedTriangleCount = 0;
+
+            for (const auto& collapse : collapses)
+            {
+                if (collapse.cost > maxCost || removedTriangleCount >= targetRemovedTriangleCount)
+                {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to])
+                {
+                    continue;
+                }
+
+                const auto collapseTriangleCount = ValidateSimplifierCollapse(
+                    collapse, positionIndices, adjacency, positions, positionIds, ringMarks);
+                if (collapseTriangleCount == 0)
+                {
+                    continue;
+                }
+
+                for (auto i = adjacency.offsets[collapse.from]; i < adjacency.offsets[collapse.from + 1]; i++)
+                {
+                    const auto* corners = positionIndices.data() + (size_t{ adjacency.triangles[i] } * 3);
+                    touched[corners[0]] = touched[corners[1]] = touched[corners[2]] = 1;
+                }
+
+                for (auto i = wedges.offsets[collapse.from]; i < wedges.offsets[collapse.from + 1]; i++)
+                {
+                    double distance = 0.0;
+                    const auto wedge = wedges.vertices[i];
+                    wedgeTargets[wedge] = FindSimplifierCollapseWedge(
+                        vertices, wedges, currentIndices, positionIndices, adjacency, collapse.from, collapse.to, wedge, distance);
+                }
+
+                AddSimplifierQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+                maxPositionError = std::max(maxPositionError, collapse.positionError);
+                removedTriangleCount += collapseTriangleCount;
+            }
+
+            if (removedTriangleCount == 0)
+            {
+                break;
+            }
+
+            // Remap collapsed vertices and remove triangles degenerated by position.
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < currentIndices.size(); i += 3)
+            {
+                uint32_t corners[3];
+                uint32_t cornerPositionIds[3];
+                for (size_t j = 0; j < 3; j++)
+                {
+                    const auto index = currentIndices[i + j];
+                    corners[j] = wedgeTargets[index] != InvalidSimplifierIndex ? wedgeTargets[index] : index;
+                    cornerPositionIds[j] = positionIds[corners[j]];
+                }
+
+                if (cornerPositionIds[0] != cornerPositionIds[1] && cornerPositionIds[1] != cornerPositionIds[2] && cornerPositionIds[0] != cornerPositionIds[2])
+                {
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        positionIndices[writeIndex] = cornerPositionIds[j];
+                        currentIndices[writeIndex++] = corners[j];
+                    }
+                }
+            }
+            currentIndices.resize(writeIndex);
+            positionIndices.resize(writeIndex);
+        }
+
+        result.error = static_cast<float>(std::sqrt(maxPositionError) * extent);
+        return result;
+    }
+
+    void MeshSimplifier::GenerateLods(
+        IndexedSubmesh& submesh,
+        const std::vector<float>& lodRatios,
+        const float maxError)
+    {
+        submesh.lods.clear();
+
+        const auto triangleCount = submesh.GetIndexCount() / 3;
+        auto indices = submesh.GetIndices();
+        float error = 0.0f;
+
+        for (const auto lodRatio : lodRatios)
+        {
+            const auto targetTriangleCount = static_cast<size_t>(static_cast<double>(triangleCount) * std::clamp(lodRatio, 0.0f, 1.0f));
+
+            auto result = Simplify(submesh.vertices, indices, targetTriangleCount * 3, maxError);
+            if (result.indices.size() >= indices.size())
+            {
+                break;
+            }
+
+            MeshOptimizer::OptimizeVertexCache(result.indices, submesh.vertices.size());
+
+            // Each level is simplified from the previous one, so the deviation from full detail is bounded by the sum of errors.
+            error += result.error;
+
+            auto& lod = submesh.lods.emplace_back();
+            lod.SetIndices(result.indices);
+            lod.error = error;
+
+            indices = std::move(result.indices);
+        }
+    }
+
+    void MeshSimplifier::GenerateLods(
+        IndexedMeshes& meshes,
+        const std::vector<float>& lodRatios,
+        ThreadPool* threadPool,
+        const float maxError)
+    {
+        std::vector<IndexedSubmesh*> submeshes;
+        for (auto& mesh : meshes)
+        {
+            for (auto& submesh : mesh.submeshes)
+            {
+                submeshes.push_back(&submesh);
+            }
+        }
+
+        auto generateLods = [&](const size_t index)
+        {
+            GenerateLods(*submeshes[index], lodRatios, maxError);
+        };
+
+        if (threadPool)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Background, submeshes.size(), generateLods);
+        }
+        else
+        {
+            for (size_t i = 0; i < submeshes.size(); i++)
+            {
+                generateLods(i);
+            }
+        }
+    }
+
+}
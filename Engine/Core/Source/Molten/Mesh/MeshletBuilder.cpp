@@ -0,0 +1,525 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/MeshletBuilder.hpp"
+#include "Molten/Mesh/MeshNormalGenerator.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint32_t InvalidMeshletIndex = std::numeric_limits<uint32_t>::max();
+    static constexpr float MeshletConeWeight = 0.5f; ///< Weight of normal deviation, relative to the cost of one new vertex.
+    static constexpr float MeshletMinConeDot = 0.1f; ///< Min dot product of normals and cone axis, below which cones are too wide for culling.
+
+    static constexpr uint32_t MeshletKdLeafSize = 8; ///< Max triangles per leaf of triangle kd-tree.
+
+    /** Assigns each vertex the lowest index of all vertices sharing its position,
+     *  so triangles split by normal or texture coordinate seams are still connected.
+     */
+    static std::vector<uint32_t> CreateMeshletPositionIds(const IndexedMeshVertices& vertices)
+    {
+        std::vector<uint32_t> order(vertices.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(order.size()); i++)
+        {
+            order[i] = i;
+        }
+
+        std::sort(order.begin(), order.end(), [&](const uint32_t lhs, const uint32_t rhs)
+        {
+            const auto& lhsPosition = vertices[lhs].position;
+            const auto& rhsPosition = vertices[rhs].position;
+            if (lhsPosition.x != rhsPosition.x) return lhsPosition.x < rhsPosition.x;
+            if (lhsPosition.y != rhsPosition.y) return lhsPosition.y < rhsPosition.y;
+            if (lhsPosition.z != rhsPosition.z) return lhsPosition.z < rhsPosition.z;
+            return lhs < rhs;
+        });
+
+        std::vector<uint32_t> positionIds(vertices.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const auto vertex = order[i];
+            const auto isShared = i > 0 && vertices[order[i - 1]].position == vertices[vertex].position;
+            positionIds[vertex] = isShared ? positionIds[order[i - 1]] : vertex;
+        }
+
+        return positionIds;
+    }
+
+    /** Position to triangle adjacency, in compressed sparse row format. */
+    struct MeshletAdjacency
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+        std::vector<uint32_t> liveCounts; ///< Number of triangles per position not yet added to any meshlet.
+    };
+
+    static MeshletAdjacency CreateMeshletAdjacency(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& positionIds)
+    {
+        const auto positionCount = positionIds.size();
+
+        MeshletAdjacency adjacency;
+        adjacency.offsets.resize(positionCount + 1, 0);
+        adjacency.liveCounts.resize(positionCount, 0);
+
+        for (const auto index : indices)
+        {
+            ++adjacency.liveCounts[positionIds[index]];
+        }
+        for (size_t i = 0; i < positionCount; i++)
+        {
+            adjacency.offsets[i + 1] = adjacency.offsets[i] + adjacency.liveCounts[i];
+        }
+
+        adjacency.triangles.resize(indices.size());
+        auto cursors = adjacency.offsets;
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            adjacency.triangles[cursors[positionIds[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        return adjacency;
+    }
+
+    /** Node of kd-tree of triangle centroids. Leaves have no children and store a range of triangles. */
+    struct MeshletKdNode
+    {
+        uint32_t begin;
+        uint32_t end;
+        uint32_t left;
+        uint32_t right;
+        size_t axis;
+        float split;
+    };
+
+    /** Kd-tree of triangle centroids, used for finding the nearest triangle not connected to a meshlet. */
+    struct MeshletKdTree
+    {
+        std::vector<MeshletKdNode> nodes;
+        std::vector<uint32_t> triangles;
+    };
+
+    static uint32_t BuildMeshletKdNode(
+        MeshletKdTree& tree,
+        const std::vector<Vector3f32>& centroids,
+        const uint32_t begin,
+        const uint32_t end)
+    {
+        const auto nodeIndex = static_cast<uint32_t>(tree.nodes.size());
+        tree.nodes.push_back({ begin, end, InvalidMeshletIndex, InvalidMeshletIndex, 0, 0.0f });
+        if (end - begin <= MeshletKdLeafSize)
+        {
+            return nodeIndex;
+        }
+
+        auto low = centroids[tree.triangles[begin]];
+        auto high = low;
+        for (auto i = begin + 1; i < end; i++)
+        {
+            const auto& centroid = centroids[tree.triangles[i]];
+            for (size_t j = 0; j < 3; j++)
+            {
+                low.c[j] = std::min(low.c[j], centroid.c[j]);
+                high.c[j] = std::max(high.c[j], centroid.c[j]);
+            }
+        }
+
+        const auto extent = high - low;
+        const size_t axis = extent.x >= extent.y ? (extent.x >= extent.z ? 0 : 2) : (extent.y >= extent.z ? 1 : 2);
+        if (extent.c[axis] <= 0.0f)
+        {
+            return nodeIndex;
+        }
+
+        const auto middle = begin + (end - begin) / 2;
+        std::nth_element(tree.triangles.begin() + begin, tree.triangles.begin() + middle, tree.triangles.begin() + end,
+            [&](const uint32_t lhs, const uint32_t rhs)
+        {
+            return centroids[lhs].c[axis] < centroids[rhs].c[axis];
+        });
+
+        const auto split = centroids[tree.triangles[middle]].c[axis];
+        const auto left = BuildMeshletKdNode(tree, centroids, begin, middle);
+        const auto right = BuildMeshletKdNode(tree, centroids, middle, end);
+
+        auto& node = tree.nodes[nodeIndex];
+        node.left = left;
+        node.right = right;
+        node.axis = axis;
+        node.split = split;
+        return nodeIndex;
+    }
+
+    static MeshletKdTree CreateMeshletKdTree(const std::vector<Vector3f32>& centroids)
+    {
+        MeshletKdTree tree;
+        tree.triangles.resize(centroids.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(centroids.size()); i++)
+        {
+            tree.triangles[i] = i;
+        }
+
+        if (!centroids.empty())
+        {
+            BuildMeshletKdNode(tree, centroids, 0, static_cast<uint32_t>(centroids.size()));
+        }
+        return tree;
+    }
+
+    /** Finds triangle not yet emitted with centroid nearest to point, ties broken by lowest triangle index. */
+    static void FindNearestMeshletTriangle(
+        const MeshletKdTree& tree,
+        const std::vector<Vector3f32>& centroids,
+        const std::vector<uint8_t>& emitted,
+        const uint32_t nodeIndex,
+        const Vector3f32& point,
+        uint32_t& nearestTriangle,
+        float& nearestDistance)
+    {
+        const auto& node = tree.nodes[nodeIndex];
+        if (node.left == InvalidMeshletIndex)
+        {
+            for (auto i = node.begin; i < node.end; i++)
+            {
+                const auto triangle = tree.triangles[i];
+                if (emitted[triangle] != 0)
+                {
+                    continue;
+                }
+
+                const auto delta = centroids[triangle] - point;
+                const auto distance = delta.Dot(delta);
+                if (distance < nearestDistance || (distance == nearestDistance && triangle < nearestTriangle))
+                {
+                    nearestDistance = distance;
+                    nearestTriangle = triangle;
+                }
+            }
+            return;
+        }
+
+        const auto delta = point.c[node.axis] - node.split;
+        const auto first = delta <= 0.0f ? node.left : node.right;
+        const auto second = delta <= 0.0f ? node.right : node.left;
+
+        FindNearestMeshletTriangle(tree, centroids, emitted, first, point, nearestTriangle, nearestDistance);
+        if (delta * delta <= nearestDistance)
+        {
+            FindNearestMeshletTriangle(tree, centroids, emitted, second, point, nearestTriangle, nearestDistance);
+        }
+    }
+
+
+    // Meshlet builder implementations.
+    MeshletBuilder::Result MeshletBuilder::Build(
+        const IndexedMeshVertices& vertices,
+        const std::vector<uint32_t>& indices,
+        size_t maxVertices,
+        size_t maxTriangles)
+    {
+        maxVertices = std::clamp(maxVertices, size_t{ 3 }, MaxVerticesLimit);
+        maxTriangles = std::max(maxTriangles, size_t{ 1 });
+
+        const auto triangleCount = indices.size() / 3;
+
+        Result result;
+        result.vertices.reserve(indices.size());
+        result.triangles.reserve(triangleCount * 3);
+
+        std::vector<Vector3f32> triangleNormals(triangleCount);
+        std::vector<Vector3f32> triangleCentroids(triangleCount);
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            const auto& position0 = vertices[indices[i * 3]].position;
+            const auto& position1 = vertices[indices[i * 3 + 1]].position;
+            const auto& position2 = vertices[indices[i * 3 + 2]].position;
+            triangleNormals[i] = MeshNormalGenerator::CalculateTriangleNormal(position0, position1, position2);
+            triangleCentroids[i] = (position0 + position1 + position2) / 3.0f;
+        }
+
+        const auto positionIds = CreateMeshletPositionIds(vertices);
+        auto adjacency = CreateMeshletAdjacency(indices, positionIds);
+        const auto kdTree = CreateMeshletKdTree(triangleCentroids);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> localIndices(vertices.size(), InvalidMeshletIndex);
+
+        size_t seedCursor = 0;
+        while (true)
+        {
+            while (seedCursor < triangleCount && emitted[seedCursor] != 0)
+            {
+                ++seedCursor;
+            }
+            if (seedCursor == triangleCount)
+            {
+                break;
+            }
+
+            IndexedMeshlet meshlet;
+            meshlet.vertexOffset = static_cast<uint32_t>(result.vertices.size());
+            meshlet.triangleOffset = static_cast<uint32_t>(result.triangles.size());
+            Vector3f32 normalSum = { 0.0f, 0.0f, 0.0f };
+            Vector3f32 centroidSum = { 0.0f, 0.0f, 0.0f };
+
+            for (auto triangle = seedCursor; triangle != InvalidMeshletIndex;)
+            {
+                for (size_t i = 0; i < 3; i++)
+                {
+                    const auto vertex = indices[triangle * 3 + i];
+                    if (localIndices[vertex] == InvalidMeshletIndex)
+                    {
+                        localIndices[vertex] = meshlet.vertexCount++;
+                        result.vertices.push_back(vertex);
+                    }
+                    result.triangles.push_back(static_cast<uint8_t>(localIndices[vertex]));
+                    --adjacency.liveCounts[positionIds[vertex]];
+                }
+
+                emitted[triangle] = 1;
+                normalSum += triangleNormals[triangle];
+                centroidSum += triangleCentroids[triangle];
+                if (++meshlet.triangleCount == maxTriangles)
+                {
+                    break;
+                }
+
+                // Find connected triangle, adding the fewest vertices and deviating the least from the meshlet normal.
+                const auto meshletNormal = normalSum.Normal();
+                auto bestScore = std::numeric_limits<float>::max();
+                triangle = InvalidMeshletIndex;
+
+                for (size_t i = meshlet.vertexOffset; i < result.vertices.size(); i++)
+                {
+                    const auto position = positionIds[result.vertices[i]];
+                    if (adjacency.liveCounts[position] == 0)
+                    {
+                        continue;
+                    }
+
+                    for (auto j = adjacency.offsets[position]; j < adjacency.offsets[position + 1]; j++)
+                    {
+                        const auto candidate = adjacency.triangles[j];
+                        if (emitted[candidate] != 0)
+                        {
+                            continue;
+                        }
+
+                        uint32_t newVertexCount = 0;
+                        for (size_t k = 0; k < 3; k++)
+                        {
+                            newVertexCount += localIndices[indices[candidate * 3 + k]] == InvalidMeshletIndex ? 1 : 0;
+                        }
+                        if (meshlet.vertexCount + newVertexCount > maxVertices)
+                        {
+                            continue;
+                        }
+
+                        const auto score = static_cast<float>(newVertexCount) +
+                            MeshletConeWeight * (1.0f - triangleNormals[candidate].Dot(meshletNormal));
+
+                        if (score < bestScore || (score == bestScore && candidate < triangle))
+                        {
+                            bestScore = score;
+                            triangle = candidate;
+                        }
+                    }
+                }
+
+                // No connected triangle fits, continue with the triangle nearest to the meshlet centroid, if it fits.
+                if (triangle == InvalidMeshletIndex)
+                {
+                    const auto centroid = centroidSum / static_cast<float>(meshlet.triangleCount);
+                    auto nearestTriangle = InvalidMeshletIndex;
+                    auto nearestDistance = std::numeric_limits<float>::max();
+                    FindNearestMeshletTriangle(kdTree, triangleCentroids, emitted, 0, centroid, nearestTriangle, nearestDistance);
+                    triangle = nearestTriangle;
+
+                    if (triangle != InvalidMeshletIndex && meshlet.vertexCount + 3 > maxVertices)
+                    {
+                        uint32_t newVertexCount = 0;
+                        for (size_t k = 0; k < 3; k++)
+                        {
+                            newVertexCount += localIndices[indices[triangle * 3 + k]] == InvalidMeshletIndex ? 1 : 0;
+                        }
+                        if (meshlet.vertexCount + newVertexCount > maxVertices)
+                        {
+                            triangle = InvalidMeshletIndex;
+                        }
+                    }
+                }
+            }
+
+            for (size_t i = meshlet.vertexOffset; i < result.vertices.size(); i++)
+            {
+                localIndices[result.vertices[i]] = InvalidMeshletIndex;
+            }
+
+            CalculateBounds(meshlet, vertices, result.vertices, result.triangles);
+            result.meshlets.push_back(meshlet);
+        }
+
+        result.vertices.shrink_to_fit();
+        result.triangles.shrink_to_fit();
+        return result;
+    }
+
+    void MeshletBuilder::BuildSubmesh(
+        IndexedSubmesh& submesh,
+        const size_t maxVertices,
+        const size_t maxTriangles)
+    {
+        auto result = Build(submesh.vertices, submesh.GetIndices(), maxVertices, maxTriangles);
+        submesh.meshlets = std::move(result.meshlets);
+        submesh.meshletVertices = std::move(result.vertices);
+        submesh.meshletTriangles = std::move(result.triangles);
+    }
+
+    void MeshletBuilder::BuildMeshes(
+        IndexedMeshes& meshes,
+        ThreadPool* threadPool,
+        const size_t maxVertices,
+        const size_t maxTriangles)
+    {
+        std::vector<IndexedSubmesh*> submeshes;
+        for (auto& mesh : meshes)
+        {
+            for (auto& submesh : mesh.submeshes)
+            {
+                submeshes.push_back(&submesh);
+            }
+        }
+
+        auto buildSubmesh = [&](const size_t index)
+        {
+            BuildSubmesh(*submeshes[index], maxVertices, maxTriangles);
+        };
+
+        if (threadPool)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Background, submeshes.size(), buildSubmesh);
+        }
+        else
+        {
+            for (size_t i = 0; i < submeshes.size(); i++)
+            {
+                buildSubmesh(i);
+            }
+        }
+    }
+
+    void MeshletBuilder::CalculateBounds(
+        IndexedMeshlet& meshlet,
+        const IndexedMeshVertices& vertices,
+        const std::vector<uint32_t>& meshletVertices,
+        const std::vector<uint8_t>& meshletTriangles)
+    {
+        if (meshlet.vertexCount == 0)
+        {
+            return;
+        }
+
+        auto getPosition = [&](const size_t localIndex) -> const Vector3f32&
+        {
+            return vertices[meshletVertices[meshlet.vertexOffset + localIndex]].position;
+        };
+
+        // Bounding box and bounding sphere, centered in the bounding box.
+        meshlet.bounds = { getPosition(0), getPosition(0) };
+        for (uint32_t i = 1; i < meshlet.vertexCount; i++)
+        {
+            const auto& position = getPosition(i);
+            for (size_t j = 0; j < 3; j++)
+            {
+                meshlet.bounds.low.c[j] = std::min(meshlet.bounds.low.c[j], position.c[j]);
+                meshlet.bounds.high.c[j] = std::max(meshlet.bounds.high.c[j], position.c[j]);
+            }
+        }
+
+        meshlet.center = (meshlet.bounds.low + meshlet.bounds.high) * 0.5f;
+        meshlet.radius = 0.0f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            meshlet.radius = std::max(meshlet.radius, (getPosition(i) - meshlet.center).Length());
+        }
+
+        // Normal cone, with axis as average of triangle normals and apex placed so all triangles are in front of it.
+        meshlet.coneApex = meshlet.center;
+        meshlet.coneAxis = { 0.0f, 0.0f, 0.0f };
+        meshlet.coneCutoff = 1.0f;
+
+        std::vector<Vector3f32> normals;
+        normals.reserve(meshlet.triangleCount);
+        Vector3f32 normalSum = { 0.0f, 0.0f, 0.0f };
+        for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+        {
+            const auto* triangle = &meshletTriangles[meshlet.triangleOffset + i * 3];
+            const auto normal = MeshNormalGenerator::CalculateTriangleNormal(
+                getPosition(triangle[0]), getPosition(triangle[1]), getPosition(triangle[2]));
+
+            normals.push_back(normal);
+            normalSum += normal;
+        }
+
+        const auto axis = normalSum.Normal();
+        if (axis.Length() == 0.0f)
+        {
+            return;
+        }
+
+        auto minDot = 1.0f;
+        for (const auto& normal : normals)
+        {
+            if (normal.Length() > 0.0f)
+            {
+                minDot = std::min(minDot, normal.Dot(axis));
+            }
+        }
+        if (minDot <= MeshletMinConeDot)
+        {
+            return;
+        }
+
+        auto maxDistance = 0.0f;
+        for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+        {
+            const auto& normal = normals[i];
+            if (normal.Length() > 0.0f)
+            {
+                const auto& position = getPosition(meshletTriangles[meshlet.triangleOffset + i * 3]);
+                maxDistance = std::max(maxDistance, (meshlet.center - position).Dot(normal) / axis.Dot(normal));
+            }
+        }
+
+        meshlet.coneApex = meshlet.center - (axis * maxDistance);
+        meshlet.coneAxis = axis;
+        meshlet.coneCutoff = std::sqrt(1.0f - (minDot * minDot));
+    }
+
+}
@@ -0,0 +1,385 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Mesh/ObjMeshImporter.hpp"
+#include "Molten/Mesh/IndexedMeshBuilder.hpp"
+#include "Molten/Mesh/MeshOptimizer.hpp"
+#include "Molten/Mesh/MeshSimplifier.hpp"
+#include "Molten/Mesh/MeshletBuilder.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include "Molten/Utility/Hash.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static std::optional<MeshCacheFile::MaterialTexture> CreateMeshCacheTexture(const std::optional<ObjMeshFile::MaterialTexture>& texture)
+    {
+        if (!texture.has_value())
+        {
+            return std::nullopt;
+        }
+
+        MeshCacheFile::MaterialTexture cacheTexture;
+        cacheTexture.filename = texture->filename;
+        cacheTexture.modifier = texture->options.modifier;
+        cacheTexture.originOffset = texture->options.originOffset;
+        cacheTexture.scale = texture->options.scale;
+        cacheTexture.clamp = texture->options.clamp;
+        return cacheTexture;
+    }
+
+    /** Creates mesh cache materials, referencing strings of obj materials. The first material of each name is used. */
+    static std::vector<MeshCacheFile::Material> CreateMeshCacheMaterials(const ObjMeshFile::MaterialSharedPointers& materials)
+    {
+        std::vector<MeshCacheFile::Material> cacheMaterials;
+        cacheMaterials.reserve(materials.size());
+
+        for (const auto& material : materials)
+        {
+            const auto isDuplicate = std::any_of(cacheMaterials.begin(), cacheMaterials.end(), [&](const MeshCacheFile::Material& cacheMaterial)
+            {
+                return cacheMaterial.name == material->name;
+            });
+            if (isDuplicate)
+            {
+                continue;
+            }
+
+            auto& cacheMaterial = cacheMaterials.emplace_back();
+            cacheMaterial.name = material->name;
+            cacheMaterial.ambientColor = material->ambientColor;
+            cacheMaterial.diffuseColor = material->diffuseColor;
+            cacheMaterial.specularColor = material->specularColor;
+            cacheMaterial.specularWeight = material->specularWeight;
+            cacheMaterial.transparency = material->transparency;
+            cacheMaterial.opticalDensity = material->opticalDensity;
+            cacheMaterial.roughness = material->roughness;
+            cacheMaterial.metallic = material->metallic;
+            cacheMaterial.ambientTexture = CreateMeshCacheTexture(material->ambientTexture);
+            cacheMaterial.diffuseTexture = CreateMeshCacheTexture(material->diffuseTexture);
+            cacheMaterial.specularTexture = CreateMeshCacheTexture(material->specularTexture);
+            cacheMaterial.specularWeightTexture = CreateMeshCacheTexture(material->specularWeightTexture);
+            cacheMaterial.alphaTexture = CreateMeshCacheTexture(material->alphaTexture);
+            cacheMaterial.displacementTexture = CreateMeshCacheTexture(material->displacementTexture);
+            cacheMaterial.roughnessTexture = CreateMeshCacheTexture(material->roughnessTexture);
+            cacheMaterial.metallicTexture = CreateMeshCacheTexture(material->metallicTexture);
+        }
+
+        return cacheMaterials;
+    }
+
+
+    // Obj mesh importer implementations.
+    ObjMeshImporter::ObjMeshImporter() :
+        m_cacheEnabled(true),
+        m_cacheCompressionEnabled(false),
+        m_meshletsEnabled(false),
+        m_lastImportSource(ImportSource::None)
+    {}
+
+    ObjMeshImporter::ImportResult ObjMeshImporter::Import(const std::filesystem::path& filename)
+    {
+        return InternalImport(filename, nullptr);
+    }
+
+    ObjMeshImporter::ImportResult ObjMeshImporter::Import(const std::filesystem::path& filename, ThreadPool& threadPool)
+    {
+        return InternalImport(filename, &threadPool);
+    }
+
+    void ObjMeshImporter::SetCacheEnabled(const bool enabled)
+    {
+        m_cacheEnabled = enabled;
+    }
+
+    bool ObjMeshImporter::IsCacheEnabled() const
+    {
+        return m_cacheEnabled;
+    }
+
+    void ObjMeshImporter::SetCacheCompressionEnabled(const bool enabled)
+    {
+        m_cacheCompressionEnabled = enabled;
+    }
+
+    bool ObjMeshImporter::IsCacheCompressionEnabled() const
+    {
+        return m_cacheCompressionEnabled;
+    }
+
+    void ObjMeshImporter::SetCacheDirectory(const std::filesystem::path& cacheDirectory)
+    {
+        m_cacheDirectory = cacheDirectory;
+    }
+
+    const std::filesystem::path& ObjMeshImporter::GetCacheDirectory() const
+    {
+        return m_cacheDirectory;
+    }
+
+    void ObjMeshImporter::SetLodRatios(const std::vector<float>& lodRatios)
+    {
+        m_lodRatios = lodRatios;
+    }
+
+    const std::vector<float>& ObjMeshImporter::GetLodRatios() const
+    {
+        return m_lodRatios;
+    }
+
+    void ObjMeshImporter::SetMeshletsEnabled(const bool enabled)
+    {
+        m_meshletsEnabled = enabled;
+    }
+
+    bool ObjMeshImporter::IsMeshletsEnabled() const
+    {
+        return m_meshletsEnabled;
+    }
+
+    std::filesystem::path ObjMeshImporter::GetCacheFilename(const std::filesystem::path& filename) const
+    {
+        if (m_cacheDirectory.empty())
+        {
+            auto cacheFilename = filename;
+            cacheFilename += ".mcache";
+            return cacheFilename;
+        }
+
+        // Source files of different directories may share filename, so the full source path is part of the cache filename.
+        std::error_code errorCode;
+        auto absoluteFilename = std::filesystem::absolute(filename, errorCode);
+        const auto sourcePath = (errorCode ? filename : absoluteFilename).generic_string();
+        const auto pathHash = Hash64(sourcePath.data(), sourcePath.size());
+
+        char pathHashString[17] = {};
+        std::snprintf(pathHashString, sizeof(pathHashString), "%016llx", static_cast<unsigned long long>(pathHash));
+
+        return m_cacheDirectory / (filename.filename().string() + "." + pathHashString + ".mcache");
+    }
+
+    ObjMeshImporter::ImportSource ObjMeshImporter::GetLastImportSource() const
+    {
+        return m_lastImportSource;
+    }
+
+    ObjMeshFileReader& ObjMeshImporter::GetReader()
+    {
+        return m_reader;
+    }
+
+    std::optional<MeshCacheFile::SourceKey> ObjMeshImporter::CreateSourceKey(
+        const std::filesystem::path& filename,
+        const bool computeHash)
+    {
+        std::error_code errorCode;
+
+        MeshCacheFile::SourceKey sourceKey;
+        sourceKey.size = static_cast<uint64_t>(std::filesystem::file_size(filename, errorCode));
+        if (errorCode)
+        {
+            return std::nullopt;
+        }
+
+        const auto modifiedTime = std::filesystem::last_write_time(filename, errorCode);
+        if (errorCode)
+        {
+            return std::nullopt;
+        }
+        sourceKey.modifiedTime = static_cast<int64_t>(modifiedTime.time_since_epoch().count());
+
+        if (computeHash)
+        {
+            MemoryMappedFile file;
+            if (!file.Open(filename))
+            {
+                return std::nullopt;
+            }
+            sourceKey.hash = Hash64(file.GetData(), file.GetSize());
+        }
+
+        return sourceKey;
+    }
+
+    bool ObjMeshImporter::IsSourceKeyCurrent(const std::filesystem::path& filename, const MeshCacheFile::SourceKey& key)
+    {
+        const auto sourceKey = CreateSourceKey(filename, false);
+        if (!sourceKey.has_value() || sourceKey->size != key.size)
+        {
+            return false;
+        }
+
+        if (sourceKey->modifiedTime != key.modifiedTime)
+        {
+            const auto hashedSourceKey = CreateSourceKey(filename, true);
+            return hashedSourceKey.has_value() && hashedSourceKey->hash == key.hash;
+        }
+
+        return true;
+    }
+
+    uint64_t ObjMeshImporter::CreateSettingsHash() const
+    {
+        const auto lodRatiosHash = Hash64(m_lodRatios.data(), m_lodRatios.size() * sizeof(float));
+        const uint8_t meshletsEnabled = m_meshletsEnabled ? 1 : 0;
+        return Hash64(&meshletsEnabled, sizeof(meshletsEnabled), lodRatiosHash);
+    }
+
+    ObjMeshImporter::ImportResult ObjMeshImporter::InternalImport(const std::filesystem::path& filename, ThreadPool* threadPool)
+    {
+        m_lastImportSource = ImportSource::None;
+
+        const auto cacheFilename = m_cacheEnabled ? GetCacheFilename(filename) : std::filesystem::path{};
+        if (m_cacheEnabled)
+        {
+            if (auto cacheFile = TryReadCache(filename, cacheFilename); cacheFile.has_value())
+            {
+                m_lastImportSource = ImportSource::Cache;
+                return ImportResult::CreateSuccess(std::move(cacheFile.value()));
+            }
+        }
+
+        // Hash source before parsing, so a source modified while importing results in an outdated cache.
+        auto sourceKey = CreateSourceKey(filename, true);
+        if (!sourceKey.has_value())
+        {
+            return ImportResult::CreateError("Cannot open file \"" + filename.string() + "\"");
+        }
+        sourceKey->settingsHash = CreateSettingsHash();
+
+        ObjMeshFile objMeshFile;
+        const auto readResult = threadPool ?
+            m_reader.ReadFromFile(objMeshFile, filename, *threadPool) :
+            m_reader.ReadFromFile(objMeshFile, filename);
+
+        if (!readResult.IsSuccessful())
+        {
+            const auto& error = readResult.GetError();
+            return ImportResult::CreateError(error.message + " (line " + std::to_string(error.lineNumber) + ")");
+        }
+
+        auto buildResult = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile, threadPool);
+        if (!buildResult.IsValid())
+        {
+            return ImportResult::CreateError(std::move(buildResult.Error()));
+        }
+
+        auto& meshes = buildResult.Value();
+        MeshOptimizer::OptimizeMeshes(meshes, threadPool);
+        if (!m_lodRatios.empty())
+        {
+            MeshSimplifier::GenerateLods(meshes, m_lodRatios, threadPool);
+        }
+        if (m_meshletsEnabled)
+        {
+            MeshletBuilder::BuildMeshes(meshes, threadPool);
+        }
+
+        // Material files are keyed after reading, since their names are only known by parsing the source.
+        const auto& materialFilenames = m_reader.GetMaterialFilenames();
+        std::vector<MeshCacheFile::Dependency> dependencies;
+        dependencies.reserve(materialFilenames.size());
+        for (const auto& materialFilename : materialFilenames)
+        {
+            // Missing material files are skipped by the reader, but still invalidate the cache once created.
+            if (auto dependencyKey = CreateSourceKey(materialFilename, true); dependencyKey.has_value())
+            {
+                dependencies.push_back({ materialFilename, dependencyKey.value() });
+            }
+            else if (std::error_code errorCode; !std::filesystem::exists(materialFilename, errorCode) && !errorCode)
+            {
+                dependencies.push_back({ materialFilename, {} });
+            }
+        }
+
+        const auto materials = CreateMeshCacheMaterials(objMeshFile.materials);
+        auto bytes = MeshCacheFile::Serialize(meshes, sourceKey.value(), dependencies, materials);
+
+        if (m_cacheEnabled)
+        {
+            if (const auto& cacheDirectory = cacheFilename.parent_path(); !cacheDirectory.empty())
+            {
+                std::error_code errorCode;
+                std::filesystem::create_directories(cacheDirectory, errorCode);
+            }
+
+            // Failing to write a cache file only costs performance of next import, so it is not an error.
+            [[maybe_unused]] const auto written = MeshCacheFile::WriteToFile(cacheFilename, bytes, m_cacheCompressionEnabled);
+        }
+
+        MeshCacheFile meshCacheFile;
+        if (meshCacheFile.ReadFromBytes(std::move(bytes)) != MeshCacheFile::ReadResult::Successful)
+        {
+            return ImportResult::CreateError("Failed to serialize meshes");
+        }
+
+        m_lastImportSource = ImportSource::Source;
+        return ImportResult::CreateSuccess(std::move(meshCacheFile));
+    }
+
+    std::optional<MeshCacheFile> ObjMeshImporter::TryReadCache(
+        const std::filesystem::path& filename,
+        const std::filesystem::path& cacheFilename) const
+    {
+        MeshCacheFile cacheFile;
+        if (cacheFile.ReadFromFile(cacheFilename) != MeshCacheFile::ReadResult::Successful)
+        {
+            return std::nullopt;
+        }
+
+        const auto& cacheKey = cacheFile.GetSourceKey();
+        if (cacheKey.settingsHash != CreateSettingsHash() || !IsSourceKeyCurrent(filename, cacheKey))
+        {
+            return std::nullopt;
+        }
+
+        // Modified material files change the imported meshes as well.
+        for (const auto& dependency : cacheFile.GetDependencies())
+        {
+            const auto dependencyFilename = std::filesystem::path{ dependency.filename };
+            const auto& key = dependency.key;
+            if (key.size == 0 && key.modifiedTime == 0 && key.hash == 0)
+            {
+                // File was missing at import.
+                std::error_code errorCode;
+                if (std::filesystem::exists(dependencyFilename, errorCode) || errorCode)
+                {
+                    return std::nullopt;
+                }
+            }
+            else if (!IsSourceKeyCurrent(dependencyFilename, key))
+            {
+                return std::nullopt;
+            }
+        }
+
+        return cacheFile;
+    }
+
+}
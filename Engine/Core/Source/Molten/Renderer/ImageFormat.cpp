@@ -0,0 +1,94 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Renderer/ImageFormat.hpp"
+
+namespace Molten
+{
+
+    bool IsBlockCompressedImageFormat(const ImageFormat format)
+    {
+        switch(format)
+        {
+            case ImageFormat::UBc1Rgba:
+            case ImageFormat::SrgbBc1Rgba:
+            case ImageFormat::UBc3Rgba:
+            case ImageFormat::SrgbBc3Rgba:
+            case ImageFormat::UBc4Red:
+            case ImageFormat::UBc5RedGreen:
+            case ImageFormat::UBc7Rgba:
+            case ImageFormat::SrgbBc7Rgba: return true;
+            default: break;
+        }
+        return false;
+    }
+
+    size_t GetImageFormatBlockSize(const ImageFormat format)
+    {
+        switch(format)
+        {
+            case ImageFormat::URed8:
+            case ImageFormat::SRed8: return 1;
+            case ImageFormat::URed8Green8:
+            case ImageFormat::SRed8Green8: return 2;
+            case ImageFormat::URed8Green8Blue8:
+            case ImageFormat::SRed8Green8Blue8:
+            case ImageFormat::SrgbRed8Green8Blue8:
+            case ImageFormat::UBlue8Green8Red8: return 3;
+            case ImageFormat::URed8Green8Blue8Alpha8:
+            case ImageFormat::SRed8Green8Blue8Alpha8:
+            case ImageFormat::SDepthFloat24StencilUint8:
+            case ImageFormat::SrgbRed8Green8Blue8Alpha8:
+            case ImageFormat::UBlue8Green8Red8Alpha8: return 4;
+            case ImageFormat::UBc1Rgba:
+            case ImageFormat::SrgbBc1Rgba:
+            case ImageFormat::UBc4Red: return 8;
+            case ImageFormat::UBc3Rgba:
+            case ImageFormat::SrgbBc3Rgba:
+            case ImageFormat::UBc5RedGreen:
+            case ImageFormat::UBc7Rgba:
+            case ImageFormat::SrgbBc7Rgba: return 16;
+        }
+        return 0;
+    }
+
+    size_t CalculateImageDataSize(
+        const ImageFormat format,
+        const uint32_t width,
+        const uint32_t height,
+        const uint32_t depth)
+    {
+        const auto blockSize = GetImageFormatBlockSize(format);
+        if(IsBlockCompressedImageFormat(format))
+        {
+            const size_t blockCountX = (static_cast<size_t>(width) + 3) / 4;
+            const size_t blockCountY = (static_cast<size_t>(height) + 3) / 4;
+            return blockCountX * blockCountY * static_cast<size_t>(depth) * blockSize;
+        }
+        return static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * blockSize;
+    }
+
+}
@@ -99,7 +99,19 @@ namespace Molten::Vulkan
         const VkBufferImageCopy& bufferImageCopy,
         const VkImageLayout finalImageLayout)
     {
-        if (!TransitionImageLayout(commandBuffer, deviceImage, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL))
+        return CopyDeviceBufferToDeviceImage(deviceBuffer, deviceImage, commandBuffer, &bufferImageCopy, 1, 1, finalImageLayout);
+    }
+
+    bool CopyDeviceBufferToDeviceImage(
+        DeviceBuffer& deviceBuffer,
+        DeviceImage& deviceImage,
+        VkCommandBuffer commandBuffer,
+        const VkBufferImageCopy* bufferImageCopies,
+        const uint32_t bufferImageCopyCount,
+        const uint32_t mipLevelCount,
+        const VkImageLayout finalImageLayout)
+    {
+        if (!TransitionImageLayout(commandBuffer, deviceImage, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevelCount))
         {
             return false;
         }
@@ -109,12 +121,12 @@ namespace Molten::Vulkan
             deviceBuffer.buffer,
             deviceImage.image,
             deviceImage.layout,
-            1,
-            &bufferImageCopy);
+            bufferImageCopyCount,
+            bufferImageCopies);
 
         if (deviceImage.layout != finalImageLayout)
         {
-            if (!TransitionImageLayout(commandBuffer, deviceImage, finalImageLayout))
+            if (!TransitionImageLayout(commandBuffer, deviceImage, finalImageLayout, mipLevelCount))
             {
                 return false;
             }
@@ -294,7 +294,8 @@ namespace Molten::Vulkan
         VkCommandBuffer commandBuffer,
         VkImage image,
         const VkImageLayout oldLayout,
-        const VkImageLayout newLayout)
+        const VkImageLayout newLayout,
+        const uint32_t mipLevelCount)
     {
         VkImageMemoryBarrier barrier = {};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -305,7 +306,7 @@ namespace Molten::Vulkan
         barrier.image = image;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.levelCount = mipLevelCount;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -419,9 +420,10 @@ namespace Molten::Vulkan
     bool TransitionImageLayout(
         VkCommandBuffer commandBuffer,
         DeviceImage& deviceImage,
-        const VkImageLayout newLayout)
+        const VkImageLayout newLayout,
+        const uint32_t mipLevelCount)
     {
-        if(!TransitionImageLayout(commandBuffer, deviceImage.image, deviceImage.layout, newLayout))
+        if(!TransitionImageLayout(commandBuffer, deviceImage.image, deviceImage.layout, newLayout, mipLevelCount))
         {
             return false;
         }
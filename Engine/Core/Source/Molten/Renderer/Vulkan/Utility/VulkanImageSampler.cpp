@@ -94,7 +94,7 @@ namespace Molten::Vulkan
         samplerInfo.mipmapMode = VkSamplerMipmapMode::VK_SAMPLER_MIPMAP_MODE_LINEAR;
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = 0.0f;
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
         return vkCreateSampler(logicalDeviceHandle, &samplerInfo, nullptr, &m_handle);
     }
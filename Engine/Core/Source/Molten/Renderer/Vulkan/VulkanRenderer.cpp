@@ -136,6 +136,16 @@ namespace Molten
 
             case ImageFormat::UBlue8Green8Red8: bytesPerPixel = 3; return VkFormat::VK_FORMAT_B8G8R8_UNORM;
             case ImageFormat::UBlue8Green8Red8Alpha8: bytesPerPixel = 4; return VkFormat::VK_FORMAT_B8G8R8A8_UNORM;
+
+            // Block compressed formats have no size per pixel.
+            case ImageFormat::UBc1Rgba: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case ImageFormat::SrgbBc1Rgba: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            case ImageFormat::UBc3Rgba: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC3_UNORM_BLOCK;
+            case ImageFormat::SrgbBc3Rgba: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC3_SRGB_BLOCK;
+            case ImageFormat::UBc4Red: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC4_UNORM_BLOCK;
+            case ImageFormat::UBc5RedGreen: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC5_UNORM_BLOCK;
+            case ImageFormat::UBc7Rgba: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC7_UNORM_BLOCK;
+            case ImageFormat::SrgbBc7Rgba: bytesPerPixel = 0; return VkFormat::VK_FORMAT_BC7_SRGB_BLOCK;
         }
         throw Exception("Provided image format is not supported by the Vulkan renderer.");
     }
@@ -161,6 +171,15 @@ namespace Molten
             case VkFormat::VK_FORMAT_B8G8R8_UNORM: return ImageFormat::UBlue8Green8Red8;
             case VkFormat::VK_FORMAT_B8G8R8A8_UNORM: return ImageFormat::UBlue8Green8Red8Alpha8;
 
+            case VkFormat::VK_FORMAT_BC1_RGBA_UNORM_BLOCK: return ImageFormat::UBc1Rgba;
+            case VkFormat::VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return ImageFormat::SrgbBc1Rgba;
+            case VkFormat::VK_FORMAT_BC3_UNORM_BLOCK: return ImageFormat::UBc3Rgba;
+            case VkFormat::VK_FORMAT_BC3_SRGB_BLOCK: return ImageFormat::SrgbBc3Rgba;
+            case VkFormat::VK_FORMAT_BC4_UNORM_BLOCK: return ImageFormat::UBc4Red;
+            case VkFormat::VK_FORMAT_BC5_UNORM_BLOCK: return ImageFormat::UBc5RedGreen;
+            case VkFormat::VK_FORMAT_BC7_UNORM_BLOCK: return ImageFormat::UBc7Rgba;
+            case VkFormat::VK_FORMAT_BC7_SRGB_BLOCK: return ImageFormat::SrgbBc7Rgba;
+
             default: break;
         }
         throw Exception("Provided Culkan image format is not supported by the Vulkan renderer.");
@@ -383,6 +402,17 @@ namespace Molten
 
     MOLTEN_UNSCOPED_ENUM_END
 
+    static VkDeviceSize GetMipChainDataSize(const Vector3ui32& dimensions, const uint32_t mipLevelCount, const ImageFormat format)
+    {
+        VkDeviceSize dataSize = 0;
+        for(uint32_t level = 0; level < mipLevelCount; level++)
+        {
+            const auto levelDimensions = GetMipLevelDimensions(dimensions, level);
+            dataSize += static_cast<VkDeviceSize>(CalculateImageDataSize(format, levelDimensions.x, levelDimensions.y, levelDimensions.z));
+        }
+        return dataSize;
+    }
+
     static VkDeviceSize GetIndexBufferDataTypeSize(const IndexBuffer::DataType dataType)
     {
         switch (dataType)
@@ -1706,9 +1736,14 @@ namespace Molten
             return {};
         }
 
+        if (descriptor.mipLevelCount == 0 || descriptor.mipLevelCount > CalculateMipLevelCount(descriptor.dimensions))
+        {
+            Logger::WriteError(m_logger, "Invalid mip level count of texture: " + std::to_string(descriptor.mipLevelCount));
+            return {};
+        }
+
         const auto dimensions = Vector3ui32{ descriptor.dimensions.c[0], 1, 1 };
-        const auto dataSize =
-            static_cast<VkDeviceSize>(descriptor.dimensions.c[0]) * static_cast<VkDeviceSize>(bytesPerPixel);
+        const auto dataSize = GetMipChainDataSize(dimensions, descriptor.mipLevelCount, descriptor.format);
 
         Vulkan::DeviceImage deviceImage;
         Vulkan::DeviceImageGuard deviceImageGuard(m_memoryAllocator, deviceImage);
@@ -1720,6 +1755,8 @@ namespace Molten
             dimensions,
             descriptor.data,
             dataSize,
+            descriptor.mipLevelCount,
+            descriptor.format,
             VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
             imageFormat,
             internalImageFormat,
@@ -1754,10 +1791,14 @@ namespace Molten
             return {};
         }
 
+        if (descriptor.mipLevelCount == 0 || descriptor.mipLevelCount > CalculateMipLevelCount(descriptor.dimensions))
+        {
+            Logger::WriteError(m_logger, "Invalid mip level count of texture: " + std::to_string(descriptor.mipLevelCount));
+            return {};
+        }
+
         const auto dimensions = Vector3ui32{ descriptor.dimensions.x, descriptor.dimensions.y, 1 };
-        const auto dataSize =
-            static_cast<VkDeviceSize>(descriptor.dimensions.x) *
-            static_cast<VkDeviceSize>(descriptor.dimensions.y) * static_cast<VkDeviceSize>(bytesPerPixel);
+        const auto dataSize = GetMipChainDataSize(dimensions, descriptor.mipLevelCount, descriptor.format);
 
         Vulkan::DeviceImage deviceImage;
         Vulkan::DeviceImageGuard deviceImageGuard(m_memoryAllocator, deviceImage);
@@ -1769,6 +1810,8 @@ namespace Molten
             dimensions,
             descriptor.data,
             dataSize,
+            descriptor.mipLevelCount,
+            descriptor.format,
             VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
             imageFormat,
             internalImageFormat,
@@ -1803,11 +1846,14 @@ namespace Molten
             return {};
         }
 
+        if (descriptor.mipLevelCount == 0 || descriptor.mipLevelCount > CalculateMipLevelCount(descriptor.dimensions))
+        {
+            Logger::WriteError(m_logger, "Invalid mip level count of texture: " + std::to_string(descriptor.mipLevelCount));
+            return {};
+        }
+
         const auto dimensions = descriptor.dimensions;
-        const auto dataSize =
-            static_cast<VkDeviceSize>(descriptor.dimensions.x) *
-            static_cast<VkDeviceSize>(descriptor.dimensions.y) *
-            static_cast<VkDeviceSize>(descriptor.dimensions.z) * static_cast<VkDeviceSize>(bytesPerPixel);
+        const auto dataSize = GetMipChainDataSize(dimensions, descriptor.mipLevelCount, descriptor.format);
 
         Vulkan::DeviceImage deviceImage;
         Vulkan::DeviceImageGuard deviceImageGuard(m_memoryAllocator, deviceImage);
@@ -1819,6 +1865,8 @@ namespace Molten
             dimensions,
             descriptor.data,
             dataSize,
+            descriptor.mipLevelCount,
+            descriptor.format,
             VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
             imageFormat,
             internalImageFormat,
@@ -2510,7 +2558,8 @@ namespace Molten
         };
 
         m_optionalDeviceFeatures = {
-            &VkPhysicalDeviceFeatures::samplerAnisotropy
+            &VkPhysicalDeviceFeatures::samplerAnisotropy,
+            &VkPhysicalDeviceFeatures::textureCompressionBC
         };
 
         // Debug extensions and layers
@@ -3084,6 +3133,8 @@ namespace Molten
         const Vector3ui32& dimensions,
         const void* data,
         const VkDeviceSize dataSize,
+        const uint32_t mipLevelCount,
+        const ImageFormat format,
         const VkImageLayout /*layout*/, // TODO: Use this!
         const VkFormat imageFormat,
         const VkFormat internalImageFormat,
@@ -3091,6 +3142,25 @@ namespace Molten
         const VkImageViewType imageViewType,
         const VkComponentMapping& componentMapping)
     {
+        // Block compressed formats are an optional device feature, enabled only if available.
+        if (IsBlockCompressedImageFormat(format))
+        {
+            if (!m_logicalDevice.GetEnabledFeatures().textureCompressionBC)
+            {
+                Logger::WriteError(m_logger, "Cannot create block compressed texture, device feature textureCompressionBC is not enabled.");
+                return false;
+            }
+
+            VkFormatProperties formatProperties = {};
+            vkGetPhysicalDeviceFormatProperties(m_logicalDevice.GetPhysicalDevice().GetHandle(), imageFormat, &formatProperties);
+            if ((formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0)
+            {
+                Logger::WriteError(m_logger, "Cannot create block compressed texture, format is not supported for sampling by device: " +
+                    std::to_string(static_cast<int32_t>(imageFormat)));
+                return false;
+            }
+        }
+
         Vulkan::DeviceBuffer stagingBuffer;
         Vulkan::DeviceBufferGuard stagingBufferGuard(m_memoryAllocator, stagingBuffer);
 
@@ -3120,7 +3190,7 @@ namespace Molten
         imageInfo.extent.width = dimensions.x;
         imageInfo.extent.height = dimensions.y;
         imageInfo.extent.depth = dimensions.z;
-        imageInfo.mipLevels = 1;
+        imageInfo.mipLevels = mipLevelCount;
         imageInfo.arrayLayers = 1;
         imageInfo.format = imageFormat;
         imageInfo.tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL;
@@ -3138,11 +3208,23 @@ namespace Molten
             return false;
         }
 
-        // Transfer staging buffer to image memory.
-        VkBufferImageCopy copyRegion = {};
-        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.layerCount = 1;
-        copyRegion.imageExtent = { dimensions.x, dimensions.y, dimensions.z };
+        // Transfer staging buffer to image memory, one copy region per mip level.
+        std::vector<VkBufferImageCopy> copyRegions(mipLevelCount);
+        VkDeviceSize bufferOffset = 0;
+        for(uint32_t level = 0; level < mipLevelCount; level++)
+        {
+            const auto levelDimensions = GetMipLevelDimensions(dimensions, level);
+
+            auto& copyRegion = copyRegions[level];
+            copyRegion = {};
+            copyRegion.bufferOffset = bufferOffset;
+            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.mipLevel = level;
+            copyRegion.imageSubresource.layerCount = 1;
+            copyRegion.imageExtent = { levelDimensions.x, levelDimensions.y, levelDimensions.z };
+
+            bufferOffset += static_cast<VkDeviceSize>(CalculateImageDataSize(format, levelDimensions.x, levelDimensions.y, levelDimensions.z));
+        }
 
         VkCommandBuffer commandBuffer = nullptr;
         if (const auto result = Vulkan::BeginSingleTimeCommands(commandBuffer, m_logicalDevice, m_commandPool); !result.IsSuccessful())
@@ -3155,7 +3237,9 @@ namespace Molten
             stagingBuffer,
             deviceImage,
             commandBuffer,
-            copyRegion,
+            copyRegions.data(),
+            static_cast<uint32_t>(copyRegions.size()),
+            mipLevelCount,
             VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL))
         {
             Logger::WriteError(m_logger, "Failed to copy staging buffer to image for texture creation.");
@@ -3176,7 +3260,7 @@ namespace Molten
         viewInfo.format = internalImageFormat;
         viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.levelCount = mipLevelCount;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount = 1;
         viewInfo.components = componentMapping;
@@ -3335,6 +3419,12 @@ namespace Molten
         const Vector3ui32& destinationDimensions,
         const Vector3ui32& destinationOffset)
     {
+        if(bytesPerPixel == 0)
+        {
+            Logger::WriteError(m_logger, "Updating block compressed textures is not supported.");
+            return false;
+        }
+
         const auto dataSize = 
             static_cast<VkDeviceSize>(destinationDimensions.x) *
             static_cast<VkDeviceSize>(destinationDimensions.y) *
@@ -0,0 +1,172 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/System/AdaptiveSemaphore.hpp"
+#include <algorithm>
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_AMD64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace Molten
+{
+
+    // Global implementations.
+    static inline void CpuPause()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_AMD64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    static constexpr uint32_t minAdaptiveSpinCount = 16;
+
+
+    // Adaptive semaphore implementations.
+    AdaptiveSemaphore::AdaptiveSemaphore(
+        const int32_t value,
+        const uint32_t spinCount
+    ) :
+        m_value(value),
+        m_waitCount(0),
+        m_spinCount(spinCount),
+        m_adaptiveSpinCount(spinCount)
+    {}
+
+    uint32_t AdaptiveSemaphore::GetSpinCount() const
+    {
+        return m_spinCount;
+    }
+
+    uint32_t AdaptiveSemaphore::GetAdaptiveSpinCount() const
+    {
+        return m_adaptiveSpinCount.load(std::memory_order_relaxed);
+    }
+
+    int32_t AdaptiveSemaphore::GetValue() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+    void AdaptiveSemaphore::NotifyOne()
+    {
+        m_value.fetch_add(1, std::memory_order_seq_cst);
+
+        if (m_waitCount.load(std::memory_order_seq_cst) == 0)
+        {
+            return;
+        }
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        syscall(SYS_futex, reinterpret_cast<int32_t*>(&m_value), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        { std::lock_guard lock(m_mutex); }
+        m_condition.notify_one();
+#endif
+    }
+
+    void AdaptiveSemaphore::Wait()
+    {
+        if (TryWait())
+        {
+            return;
+        }
+
+        if (m_spinCount > 0 && Spin())
+        {
+            return;
+        }
+
+        Park();
+    }
+
+    bool AdaptiveSemaphore::TryWait()
+    {
+        auto value = m_value.load(std::memory_order_relaxed);
+        while (value > 0)
+        {
+            if (m_value.compare_exchange_weak(value, value - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool AdaptiveSemaphore::Spin()
+    {
+        const auto spinCount = m_adaptiveSpinCount.load(std::memory_order_relaxed);
+
+        for (uint32_t i = 0; i < spinCount; i++)
+        {
+            CpuPause();
+
+            if (m_value.load(std::memory_order_relaxed) > 0 && TryWait())
+            {
+                // Successful spin, allow twice the number of iterations it took, smoothed over previous waits.
+                const auto target = std::clamp(i * 2, std::min(minAdaptiveSpinCount, m_spinCount), m_spinCount);
+                const auto newSpinCount = static_cast<int64_t>(spinCount) + (static_cast<int64_t>(target) - static_cast<int64_t>(spinCount)) / 8;
+                m_adaptiveSpinCount.store(static_cast<uint32_t>(newSpinCount), std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Failed spin, spin less next time. Never go below minAdaptiveSpinCount, or we would never recover.
+        m_adaptiveSpinCount.store(std::max(std::min(minAdaptiveSpinCount, m_spinCount), spinCount - spinCount / 8), std::memory_order_relaxed);
+        return false;
+    }
+
+    void AdaptiveSemaphore::Park()
+    {
+        m_waitCount.fetch_add(1, std::memory_order_seq_cst);
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        while (!TryWait())
+        {
+            // Futex returns immediately if the value has changed since loaded.
+            if (const auto value = m_value.load(std::memory_order_relaxed); value <= 0)
+            {
+                syscall(SYS_futex, reinterpret_cast<int32_t*>(&m_value), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+            }
+        }
+#else
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [&]() { return TryWait(); });
+        }
+#endif
+
+        m_waitCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+}
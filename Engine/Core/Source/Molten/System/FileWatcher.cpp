@@ -0,0 +1,259 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/System/FileWatcher.hpp"
+#include <algorithm>
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace Molten
+{
+
+    // File watcher implementations.
+    FileWatcher::FileWatcher() :
+        m_descriptor(-1),
+        m_fileCount(0)
+    {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        m_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    FileWatcher::~FileWatcher()
+    {
+        UnwatchAll();
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        if(m_descriptor >= 0)
+        {
+            close(m_descriptor);
+        }
+#endif
+    }
+
+    bool FileWatcher::IsSupported()
+    {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool FileWatcher::Watch(const std::filesystem::path& filename)
+    {
+        if(m_descriptor < 0)
+        {
+            return false;
+        }
+
+        const auto normalizedFilename = NormalizeFilename(filename);
+        const auto directoryName = normalizedFilename.parent_path().string();
+        const auto name = normalizedFilename.filename().string();
+        if(name.empty())
+        {
+            return false;
+        }
+
+        auto it = m_directories.find(directoryName);
+        if(it == m_directories.end())
+        {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+            const auto descriptor = inotify_add_watch(m_descriptor, directoryName.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+            if(descriptor < 0)
+            {
+                return false;
+            }
+
+            it = m_directories.emplace(directoryName, Directory{ descriptor, {} }).first;
+            m_directoryNames[descriptor] = directoryName;
+#else
+            return false;
+#endif
+        }
+
+        if(it->second.filenames.insert(name).second)
+        {
+            ++m_fileCount;
+        }
+        return true;
+    }
+
+    void FileWatcher::Unwatch(const std::filesystem::path& filename)
+    {
+        const auto normalizedFilename = NormalizeFilename(filename);
+        const auto directoryName = normalizedFilename.parent_path().string();
+
+        auto it = m_directories.find(directoryName);
+        if(it == m_directories.end())
+        {
+            return;
+        }
+
+        if(it->second.filenames.erase(normalizedFilename.filename().string()) > 0)
+        {
+            --m_fileCount;
+        }
+        if(it->second.filenames.empty())
+        {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+            inotify_rm_watch(m_descriptor, it->second.descriptor);
+#endif
+            EraseDirectory(directoryName);
+        }
+    }
+
+    void FileWatcher::UnwatchAll()
+    {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        for(const auto& [directoryName, directory] : m_directories)
+        {
+            inotify_rm_watch(m_descriptor, directory.descriptor);
+        }
+#endif
+        m_directories.clear();
+        m_directoryNames.clear();
+        m_fileCount = 0;
+    }
+
+    bool FileWatcher::IsWatching(const std::filesystem::path& filename) const
+    {
+        const auto normalizedFilename = NormalizeFilename(filename);
+        const auto it = m_directories.find(normalizedFilename.parent_path().string());
+        return it != m_directories.end() && it->second.filenames.find(normalizedFilename.filename().string()) != it->second.filenames.end();
+    }
+
+    size_t FileWatcher::GetWatchedFileCount() const
+    {
+        return m_fileCount;
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::Poll()
+    {
+        std::vector<std::filesystem::path> modifiedFilenames;
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        if(m_descriptor < 0)
+        {
+            return modifiedFilenames;
+        }
+
+        auto addModifiedFilename = [&](std::filesystem::path filename)
+        {
+            if(std::find(modifiedFilenames.begin(), modifiedFilenames.end(), filename) == modifiedFilenames.end())
+            {
+                modifiedFilenames.push_back(std::move(filename));
+            }
+        };
+
+        alignas(inotify_event) char buffer[4096];
+        while(true)
+        {
+            const auto readSize = read(m_descriptor, buffer, sizeof(buffer));
+            if(readSize <= 0)
+            {
+                if(readSize < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+
+            for(ssize_t offset = 0; offset < readSize;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                // Events were dropped, so any watched file may have been modified.
+                if(event->mask & IN_Q_OVERFLOW)
+                {
+                    for(const auto& [directoryName, directory] : m_directories)
+                    {
+                        for(const auto& name : directory.filenames)
+                        {
+                            addModifiedFilename(std::filesystem::path{ directoryName } / name);
+                        }
+                    }
+                    continue;
+                }
+
+                const auto directoryIt = m_directoryNames.find(event->wd);
+                if(directoryIt == m_directoryNames.end())
+                {
+                    continue;
+                }
+
+                // Watch is removed by the system, i.e. if the directory is deleted.
+                if(event->mask & IN_IGNORED)
+                {
+                    const auto directoryName = directoryIt->second;
+                    EraseDirectory(directoryName);
+                    continue;
+                }
+
+                if(event->len == 0)
+                {
+                    continue;
+                }
+
+                const auto& directory = m_directories.at(directoryIt->second);
+                const std::string name = event->name;
+                if(directory.filenames.find(name) != directory.filenames.end())
+                {
+                    addModifiedFilename(std::filesystem::path{ directoryIt->second } / name);
+                }
+            }
+        }
+#endif
+
+        return modifiedFilenames;
+    }
+
+    std::filesystem::path FileWatcher::NormalizeFilename(const std::filesystem::path& filename)
+    {
+        std::error_code errorCode;
+        auto absoluteFilename = std::filesystem::absolute(filename, errorCode);
+        return (errorCode ? filename : absoluteFilename).lexically_normal();
+    }
+
+    void FileWatcher::EraseDirectory(const std::string& directoryName)
+    {
+        const auto it = m_directories.find(directoryName);
+        if(it == m_directories.end())
+        {
+            return;
+        }
+
+        m_fileCount -= it->second.filenames.size();
+        m_directoryNames.erase(it->second.descriptor);
+        m_directories.erase(it);
+    }
+
+}
@@ -0,0 +1,262 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <utility>
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
+#include "Molten/Platform/Win32Headers.hpp"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Molten
+{
+
+    // Memory mapped file implementations.
+    MemoryMappedFile::MemoryMappedFile() :
+        m_open(false),
+        m_data(nullptr),
+        m_size(0)
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
+        , m_fileHandle(nullptr),
+        m_mappingHandle(nullptr)
+#endif
+    {}
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        Close();
+    }
+
+    MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& memoryMappedFile) noexcept :
+        m_open(std::exchange(memoryMappedFile.m_open, false)),
+        m_data(std::exchange(memoryMappedFile.m_data, nullptr)),
+        m_size(std::exchange(memoryMappedFile.m_size, 0))
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
+        , m_fileHandle(std::exchange(memoryMappedFile.m_fileHandle, nullptr)),
+        m_mappingHandle(std::exchange(memoryMappedFile.m_mappingHandle, nullptr))
+#endif
+    {}
+
+    MemoryMappedFile& MemoryMappedFile::operator = (MemoryMappedFile&& memoryMappedFile) noexcept
+    {
+        if(this != &memoryMappedFile)
+        {
+            Close();
+            m_open = std::exchange(memoryMappedFile.m_open, false);
+            m_data = std::exchange(memoryMappedFile.m_data, nullptr);
+            m_size = std::exchange(memoryMappedFile.m_size, 0);
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
+            m_fileHandle = std::exchange(memoryMappedFile.m_fileHandle, nullptr);
+            m_mappingHandle = std::exchange(memoryMappedFile.m_mappingHandle, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
+
+    bool MemoryMappedFile::Open(const std::filesystem::path& filename)
+    {
+        Close();
+
+        auto fileHandle = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(fileHandle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if(!GetFileSizeEx(fileHandle, &fileSize))
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        if(fileSize.QuadPart == 0)
+        {
+            m_fileHandle = fileHandle;
+            m_open = true;
+            return true;
+        }
+
+        auto mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mappingHandle == nullptr)
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        auto* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if(data == nullptr)
+        {
+            CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        m_fileHandle = fileHandle;
+        m_mappingHandle = mappingHandle;
+        m_data = static_cast<const char*>(data);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        m_open = true;
+        return true;
+    }
+
+    void MemoryMappedFile::Close()
+    {
+        if(m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if(m_mappingHandle)
+        {
+            CloseHandle(m_mappingHandle);
+        }
+        if(m_fileHandle)
+        {
+            CloseHandle(m_fileHandle);
+        }
+
+        m_open = false;
+        m_data = nullptr;
+        m_size = 0;
+        m_fileHandle = nullptr;
+        m_mappingHandle = nullptr;
+    }
+
+    void MemoryMappedFile::Discard(const char* data, const size_t size) const
+    {
+        if(m_data == nullptr || data < m_data || data + size > m_data + m_size || size == 0)
+        {
+            return;
+        }
+
+        // Unlocking pages which are not locked removes them from the working set of the process.
+        VirtualUnlock(const_cast<char*>(data), size);
+    }
+
+#else
+
+    bool MemoryMappedFile::Open(const std::filesystem::path& filename)
+    {
+        Close();
+
+        const auto fileDescriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStatus;
+        if(fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode))
+        {
+            close(fileDescriptor);
+            return false;
+        }
+
+        const auto fileSize = static_cast<size_t>(fileStatus.st_size);
+        if(fileSize == 0)
+        {
+            close(fileDescriptor);
+            m_open = true;
+            return true;
+        }
+
+        auto* data = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        
+        // The mapping keeps its own reference to the file.
+        close(fileDescriptor);
+
+        if(data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        madvise(data, fileSize, MADV_SEQUENTIAL);
+
+        m_data = static_cast<const char*>(data);
+        m_size = fileSize;
+        m_open = true;
+        return true;
+    }
+
+    void MemoryMappedFile::Close()
+    {
+        if(m_data)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+
+        m_open = false;
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    void MemoryMappedFile::Discard(const char* data, const size_t size) const
+    {
+        if(m_data == nullptr || data < m_data || data + size > m_data + m_size)
+        {
+            return;
+        }
+
+        const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto begin = (reinterpret_cast<uintptr_t>(data) + pageSize - 1) & ~(pageSize - 1);
+        const auto end = (reinterpret_cast<uintptr_t>(data) + size) & ~(pageSize - 1);
+
+        // Pages of private read-only mappings are never modified, so they are reloaded from file if accessed again.
+        if(begin < end)
+        {
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+        }
+    }
+
+#endif
+
+    bool MemoryMappedFile::IsOpen() const
+    {
+        return m_open;
+    }
+
+    const char* MemoryMappedFile::GetData() const
+    {
+        return m_data;
+    }
+
+    size_t MemoryMappedFile::GetSize() const
+    {
+        return m_size;
+    }
+
+    std::string_view MemoryMappedFile::GetView() const
+    {
+        return m_data ? std::string_view{ m_data, m_size } : std::string_view{};
+    }
+
+}
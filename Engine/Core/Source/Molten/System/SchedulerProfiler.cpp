@@ -0,0 +1,320 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/System/SchedulerProfiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static void WriteJsonString(std::ostream& stream, const std::string_view string)
+    {
+        stream << '"';
+        for(const auto c : string)
+        {
+            switch(c)
+            {
+                case '"': stream << "\\\""; break;
+                case '\\': stream << "\\\\"; break;
+                case '\n': stream << "\\n"; break;
+                case '\r': stream << "\\r"; break;
+                case '\t': stream << "\\t"; break;
+                default:
+                {
+                    if(static_cast<unsigned char>(c) < 0x20)
+                    {
+                        stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') 
+                            << static_cast<int>(c) << std::dec << std::setfill(' ');
+                    }
+                    else
+                    {
+                        stream << c;
+                    }
+                } break;
+            }
+        }
+        stream << '"';
+    }
+
+    static void WriteJsonMicroseconds(std::ostream& stream, const Time time)
+    {
+        stream << std::fixed << std::setprecision(3) << time.AsMicroseconds<double>();
+    }
+
+
+    // Scheduler profiler scoped span implementations.
+    SchedulerProfiler::ScopedSpan::ScopedSpan(
+        SchedulerProfiler* profiler,
+        std::string_view name,
+        const char* category
+    ) :
+        m_profiler(profiler),
+        m_name(name),
+        m_category(category),
+        m_start(profiler ? profiler->GetTime() : Time::Zero)
+    {}
+
+    SchedulerProfiler::ScopedSpan::~ScopedSpan()
+    {
+        if(m_profiler)
+        {
+            m_profiler->RecordSpan(m_name, m_category, m_start, m_profiler->GetTime());
+        }
+    }
+
+
+    // Scheduler profiler implementations.
+    SchedulerProfiler::SchedulerProfiler() :
+        m_enabled(true),
+        m_captureStart(Time::Zero)
+    {}
+
+    void SchedulerProfiler::SetEnabled(const bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    bool SchedulerProfiler::IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    void SchedulerProfiler::Clear()
+    {
+        std::lock_guard lock(m_mutex);
+        m_spanEvents.clear();
+        m_counterEvents.clear();
+        m_captureStart = m_clock.GetTime();
+    }
+
+    Time SchedulerProfiler::GetTime() const
+    {
+        return m_clock.GetTime();
+    }
+
+    void SchedulerProfiler::SetThreadName(const std::string& name)
+    {
+        std::lock_guard lock(m_mutex);
+        m_threadNames[GetThreadIndex()] = name;
+    }
+
+    void SchedulerProfiler::RecordSpan(
+        std::string_view name,
+        const char* category,
+        const Time start,
+        const Time end)
+    {
+        if(!m_enabled)
+        {
+            return;
+        }
+
+        std::lock_guard lock(m_mutex);
+        if(start < m_captureStart)
+        {
+            return;
+        }
+
+        m_spanEvents.push_back({ std::string{ name }, category, GetThreadIndex(), start, end });
+    }
+
+    void SchedulerProfiler::RecordCounter(
+        const char* name,
+        const int64_t value)
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        const auto time = GetTime();
+
+        std::lock_guard lock(m_mutex);
+        if(time < m_captureStart)
+        {
+            return;
+        }
+
+        m_counterEvents.push_back({ name, time, value });
+    }
+
+    std::vector<SchedulerProfiler::SpanEvent> SchedulerProfiler::GetSpanEvents() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_spanEvents;
+    }
+
+    std::vector<SchedulerProfiler::CounterEvent> SchedulerProfiler::GetCounterEvents() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_counterEvents;
+    }
+
+    std::vector<SchedulerProfiler::ThreadStatistics> SchedulerProfiler::GetThreadStatistics() const
+    {
+        std::lock_guard lock(m_mutex);
+
+        const auto captureTime = GetTime() - m_captureStart;
+
+        std::vector<ThreadStatistics> statistics(m_threadNames.size(), ThreadStatistics{ {}, 0, 0, Time::Zero, Time::Zero });
+        std::vector<std::vector<const SpanEvent*>> busySpans(m_threadNames.size());
+        std::vector<bool> hasEvents(m_threadNames.size(), false);
+
+        for(const auto& spanEvent : m_spanEvents)
+        {
+            auto& threadStatistics = statistics[spanEvent.threadIndex];
+            hasEvents[spanEvent.threadIndex] = true;
+
+            const auto isJob = std::strcmp(spanEvent.category, JobCategory) == 0;
+            const auto isTask = std::strcmp(spanEvent.category, TaskCategory) == 0;
+            threadStatistics.jobCount += isJob ? 1 : 0;
+            threadStatistics.taskCount += isTask ? 1 : 0;
+
+            if(isJob || isTask)
+            {
+                busySpans[spanEvent.threadIndex].push_back(&spanEvent);
+            }
+        }
+
+        // Tasks are commonly nested in jobs, so busy time is the union of all job and task spans.
+        for(size_t i = 0; i < statistics.size(); i++)
+        {
+            auto& spans = busySpans[i];
+            std::sort(spans.begin(), spans.end(), [](const auto* lhs, const auto* rhs)
+            {
+                return lhs->start < rhs->start;
+            });
+
+            auto& threadStatistics = statistics[i];
+            Time coveredEnd = Time::Zero;
+            for(const auto* span : spans)
+            {
+                const auto start = std::max(span->start, coveredEnd);
+                if(span->end > start)
+                {
+                    threadStatistics.busyTime += span->end - start;
+                    coveredEnd = span->end;
+                }
+            }
+
+            threadStatistics.name = m_threadNames[i];
+            threadStatistics.idleTime = captureTime > threadStatistics.busyTime ? captureTime - threadStatistics.busyTime : Time::Zero;
+        }
+
+        std::vector<ThreadStatistics> result;
+        for(size_t i = 0; i < statistics.size(); i++)
+        {
+            if(hasEvents[i])
+            {
+                result.push_back(std::move(statistics[i]));
+            }
+        }
+        return result;
+    }
+
+    void SchedulerProfiler::ExportChromeTrace(std::ostream& stream) const
+    {
+        std::lock_guard lock(m_mutex);
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool firstEvent = true;
+        auto beginEvent = [&]()
+        {
+            stream << (firstEvent ? "\n" : ",\n");
+            firstEvent = false;
+        };
+
+        for(size_t i = 0; i < m_threadNames.size(); i++)
+        {
+            if(m_threadNames[i].empty())
+            {
+                continue;
+            }
+
+            beginEvent();
+            stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i << ",\"args\":{\"name\":";
+            WriteJsonString(stream, m_threadNames[i]);
+            stream << "}}";
+        }
+
+        for(const auto& spanEvent : m_spanEvents)
+        {
+            beginEvent();
+            stream << "{\"name\":";
+            WriteJsonString(stream, spanEvent.name);
+            stream << ",\"cat\":";
+            WriteJsonString(stream, spanEvent.category);
+            stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << spanEvent.threadIndex << ",\"ts\":";
+            WriteJsonMicroseconds(stream, spanEvent.start - m_captureStart);
+            stream << ",\"dur\":";
+            WriteJsonMicroseconds(stream, spanEvent.end > spanEvent.start ? spanEvent.end - spanEvent.start : Time::Zero);
+            stream << "}";
+        }
+
+        for(const auto& counterEvent : m_counterEvents)
+        {
+            beginEvent();
+            stream << "{\"name\":";
+            WriteJsonString(stream, counterEvent.name);
+            stream << ",\"ph\":\"C\",\"pid\":0,\"ts\":";
+            WriteJsonMicroseconds(stream, counterEvent.time - m_captureStart);
+            stream << ",\"args\":{\"value\":" << counterEvent.value << "}}";
+        }
+
+        stream << "\n]}\n";
+    }
+
+    bool SchedulerProfiler::ExportChromeTrace(const std::filesystem::path& filename) const
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+        {
+            return false;
+        }
+
+        ExportChromeTrace(file);
+        return file.good();
+    }
+
+    size_t SchedulerProfiler::GetThreadIndex()
+    {
+        const auto threadId = std::this_thread::get_id();
+        if(const auto it = m_threadIndices.find(threadId); it != m_threadIndices.end())
+        {
+            return it->second;
+        }
+
+        const auto threadIndex = m_threadNames.size();
+        m_threadIndices.insert({ threadId, threadIndex });
+        m_threadNames.emplace_back();
+        return threadIndex;
+    }
+
+}
@@ -25,11 +25,21 @@
 
 #include "Molten/System/Task.hpp"
 #include "Molten/System/Clock.hpp"
+#include "Molten/System/SchedulerProfiler.hpp"
 #include <algorithm>
 
 namespace Molten
 {
 
+    // Global implementations.
+    static void ExecuteTask(Task& task, SchedulerProfiler* profiler)
+    {
+        const auto& name = task.GetName();
+        SchedulerProfiler::ScopedSpan span(profiler, name.empty() ? std::string_view{ "Task" } : std::string_view{ name }, SchedulerProfiler::TaskCategory);
+        task();
+    }
+
+
     // Task implementations.
     Task::Task(Function&& function) :
         m_function(std::move(function))
@@ -56,6 +66,11 @@ namespace Molten
         return m_executionTime;
     }
 
+    const std::string& Task::GetName() const
+    {
+        return m_name;
+    }
+
 
     // Parallel task group implementations.
     ParallelTaskGroup::ParallelTaskGroup(ThreadPool& threadPool) :
@@ -83,18 +98,20 @@ namespace Molten
         });
    
         auto& futures = CreateFutures(m_tasks.size());
+        auto* profiler = m_threadPool.GetProfiler();
 
-        // Execute threads in parallel.
+        // Execute threads in parallel. Task groups are run every frame, so they preempt any background work of the thread pool.
         for (size_t i = 0; i < m_tasks.size(); i++)
         {
             auto& task = m_tasks[i];
-            *futures[i] = m_threadPool.Execute([&task]()
+            *futures[i] = m_threadPool.Execute(ThreadPool::Priority::FrameCritical, [&task, profiler]()
             {
-                (*task)();
+                ExecuteTask(*task, profiler);
             });
         }
 
         // Wait for all task to finish. Call get() in order to check for exceptions.
+        SchedulerProfiler::ScopedSpan waitSpan(profiler, "Parallel task group", SchedulerProfiler::WaitCategory);
         for(size_t i = 0; i < m_tasks.size(); i++)
         {
             futures[i]->get();
@@ -156,6 +173,8 @@ namespace Molten
 
     void SerialTaskGroup::Execute()
     {
+        auto* profiler = m_threadPool.GetProfiler();
+
         for(auto& entry : m_entries)
         {
             std::visit([&](auto variant)
@@ -163,7 +182,7 @@ namespace Molten
                 using VariantType = std::decay_t<decltype(variant)>;
                 if constexpr (std::is_same_v<VariantType, TaskSharedPointer> == true)
                 {
-                    (*variant)();
+                    ExecuteTask(*variant, profiler);
                 }
                 else
                 {
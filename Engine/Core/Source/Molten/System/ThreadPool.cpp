@@ -24,11 +24,21 @@
 */
 
 #include "Molten/System/ThreadPool.hpp"
+#include "Molten/Memory/FrameAllocator.hpp"
+#include "Molten/System/SchedulerProfiler.hpp"
+#include <algorithm>
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace Molten
 {
 
     // Global implementations.
+    static thread_local LinearAllocator* workerScratchAllocator = nullptr;
+
     static size_t CalculateWorkerCount(
         const size_t threadCount,
         const size_t minThreadCount,
@@ -48,92 +58,280 @@ namespace Molten
         return std::max(count - reservedThreads, minThreadCount);
     }
 
+    static const char* GetPriorityName(const ThreadPool::Priority priority)
+    {
+        switch(priority)
+        {
+            case ThreadPool::Priority::FrameCritical: return "Frame critical";
+            case ThreadPool::Priority::Normal: return "Normal";
+            case ThreadPool::Priority::Background: return "Background";
+        }
+        return "Unknown";
+    }
+
+    static void SetThreadName([[maybe_unused]] std::thread& thread, [[maybe_unused]] const std::string& name)
+    {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        const auto truncatedName = name.substr(0, 15);
+        pthread_setname_np(thread.native_handle(), truncatedName.c_str());
+#endif
+    }
+
+    static void SetThreadAffinity([[maybe_unused]] std::thread& thread, [[maybe_unused]] const size_t cpu)
+    {
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        if(cpu >= CPU_SETSIZE)
+        {
+            return;
+        }
+
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+#endif
+    }
+
 
     // Thread pool implementations.
     ThreadPool::ThreadPool(
         const size_t threadCount,
         const size_t minThreadCount,
-        const size_t reservedThreads)
+        const size_t reservedThreads
+    ) :
+        m_waitingCount{},
+        m_backgroundWorkerCount(0),
+        m_backgroundWorkerLimit(0),
+        m_profiler(nullptr)
     {
-        const auto workerCount = CalculateWorkerCount(threadCount, minThreadCount, reservedThreads);
+        ThreadPoolDescriptor descriptor;
+        descriptor.threadCount = threadCount;
+        descriptor.minThreadCount = minThreadCount;
+        descriptor.reservedThreads = reservedThreads;
+        LaunchWorkers(descriptor);
+    }
+
+    ThreadPool::ThreadPool(const ThreadPoolDescriptor& descriptor) :
+        m_waitingCount{},
+        m_backgroundWorkerCount(0),
+        m_backgroundWorkerLimit(0),
+        m_profiler(nullptr)
+    {
+        LaunchWorkers(descriptor);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        for(auto& worker : m_workers)
+        {
+            worker->Stop();
+        }
+
+        for (auto& worker : m_workers)
+        {
+            worker.reset();
+        }
+    }
+
+    size_t ThreadPool::GetWorkerCount() const
+    {
+        return m_workers.size();
+    }
+
+    size_t ThreadPool::GetBackgroundWorkerLimit() const
+    {
+        return m_backgroundWorkerLimit;
+    }
+
+    SchedulerProfiler* ThreadPool::GetProfiler() const
+    {
+        return m_profiler;
+    }
+
+    LinearAllocator* ThreadPool::GetScratchAllocator()
+    {
+        return workerScratchAllocator;
+    }
+
+    void ThreadPool::LaunchWorkers(const ThreadPoolDescriptor& descriptor)
+    {
+        const auto workerCount = CalculateWorkerCount(descriptor.threadCount, descriptor.minThreadCount, descriptor.reservedThreads);
+
+        m_profiler = descriptor.profiler;
+
+        m_backgroundWorkerLimit = std::clamp(
+            descriptor.backgroundWorkerLimit.value_or(workerCount > 1 ? workerCount - 1 : workerCount), 
+            size_t{ 1 }, 
+            workerCount);
 
         m_workers.reserve(workerCount);
         m_freeWorkers.reserve(workerCount);
 
         for (size_t i = 0; i < workerCount; i++)
         {
-            auto worker = std::make_unique<Worker>();
+            auto worker = std::make_unique<Worker>(descriptor.workerSpinCount);
 
             auto freeWorkerFunction = [this, worker = worker.get()]()
             {
-                std::lock_guard workerLock(m_workerMutex);
-                m_freeWorkers.push_back(worker);
-                m_freeWorkersSemaphore.NotifyOne();
+                ReleaseWorker(worker);
             };
 
-            worker->Start(freeWorkerFunction);
+            const auto name = descriptor.threadName.empty() ? std::string{} : descriptor.threadName + std::to_string(i);
+            const auto cpu = descriptor.cpuAffinity.empty() ? 
+                std::optional<size_t>{} : std::optional<size_t>{ descriptor.cpuAffinity[i % descriptor.cpuAffinity.size()] };
+
+            worker->Start(freeWorkerFunction, name, cpu, descriptor.frameAllocator, descriptor.profiler);
             m_workers.push_back(std::move(worker));
         }
     }
 
-    ThreadPool::~ThreadPool()
+    ThreadPool::Worker* ThreadPool::GetFreeWorker(const Priority priority)
     {
-        for(auto& worker : m_workers)
+        const auto priorityIndex = static_cast<size_t>(priority);
+
+        std::unique_lock workerLock(m_workerMutex);
+
+        ++m_waitingCount[priorityIndex];
+
+        const auto waiting = m_profiler && !CanAcquireWorker(priority);
+        const auto waitStart = waiting ? m_profiler->GetTime() : Time::Zero;
+        if(waiting)
         {
-            worker->Stop();
+            RecordQueueDepth();
         }
 
-        for (auto& worker : m_workers)
+        m_freeWorkersCondition.wait(workerLock, [&]() { return CanAcquireWorker(priority); });
+        --m_waitingCount[priorityIndex];
+
+        auto* worker = AcquireWorker(priority);
+
+        // Lower priority waiters may be able to proceed now.
+        if(!m_freeWorkers.empty())
         {
-            worker.reset();
+            m_freeWorkersCondition.notify_all();
         }
-    }
 
-    size_t ThreadPool::GetWorkerCount() const
-    {
-        return m_workers.size();
+        if(m_profiler)
+        {
+            RecordQueueDepth();
+            workerLock.unlock();
+
+            if(waiting)
+            {
+                m_profiler->RecordSpan(GetPriorityName(priority), SchedulerProfiler::WaitCategory, waitStart, m_profiler->GetTime());
+            }
+        }
+
+        return worker;
     }
 
-    ThreadPool::Worker* ThreadPool::GetFreeWorker()
+    ThreadPool::Worker* ThreadPool::TryGetFreeWorker(const Priority priority)
     {
-        m_freeWorkersSemaphore.Wait();
-
         std::lock_guard workerLock(m_workerMutex);
 
-        auto* worker = m_freeWorkers.back();
-        m_freeWorkers.pop_back();
+        if(!CanAcquireWorker(priority))
+        {
+            return nullptr;
+        }
 
+        auto* worker = AcquireWorker(priority);
+        RecordQueueDepth();
         return worker;
     }
 
-    ThreadPool::Worker* ThreadPool::TryGetFreeWorker()
+    void ThreadPool::ReleaseWorker(Worker* worker)
     {
-        std::lock_guard workerLock(m_workerMutex);
+        {
+            std::lock_guard workerLock(m_workerMutex);
+
+            if (worker->GetPriority() == Priority::Background && m_backgroundWorkerCount > 0)
+            {
+                --m_backgroundWorkerCount;
+            }
+
+            m_freeWorkers.push_back(worker);
+            RecordQueueDepth();
+        }
+
+        m_freeWorkersCondition.notify_all();
+    }
 
+    bool ThreadPool::CanAcquireWorker(const Priority priority) const
+    {
         if(m_freeWorkers.empty())
         {
-            return nullptr;
+            return false;
+        }
+
+        // Callers of higher priority are always served first.
+        for(size_t i = 0; i < static_cast<size_t>(priority); i++)
+        {
+            if(m_waitingCount[i] > 0)
+            {
+                return false;
+            }
         }
 
+        return priority != Priority::Background || m_backgroundWorkerCount < m_backgroundWorkerLimit;
+    }
+
+    ThreadPool::Worker* ThreadPool::AcquireWorker(const Priority priority)
+    {
         auto* worker = m_freeWorkers.back();
         m_freeWorkers.pop_back();
 
+        if(priority == Priority::Background)
+        {
+            ++m_backgroundWorkerCount;
+        }
+
         return worker;
     }
 
+    void ThreadPool::RecordQueueDepth()
+    {
+        if(!m_profiler)
+        {
+            return;
+        }
+
+        const auto waitingCount = m_waitingCount[0] + m_waitingCount[1] + m_waitingCount[2];
+        m_profiler->RecordCounter("Queue depth", static_cast<int64_t>(waitingCount));
+        m_profiler->RecordCounter("Free workers", static_cast<int64_t>(m_freeWorkers.size()));
+        m_profiler->RecordCounter("Background workers", static_cast<int64_t>(m_backgroundWorkerCount));
+    }
+
 
     // Thread pool worker implementations.
-    ThreadPool::Worker::Worker() :
-        m_running(false)
+    ThreadPool::Worker::Worker(const uint32_t spinCount) :
+        m_running(false),
+        m_priority(Priority::Normal),
+        m_profiler(nullptr),
+        m_workSemaphore(0, spinCount)
     {}
 
-    void ThreadPool::Worker::Start(std::function<void()>&& freeWorkerFunction)
+    void ThreadPool::Worker::Start(
+        std::function<void()>&& freeWorkerFunction,
+        const std::string& name,
+        const std::optional<size_t> cpu,
+        FrameAllocator* frameAllocator,
+        SchedulerProfiler* profiler)
     {
         m_freeFunction = std::move(freeWorkerFunction);
+        m_profiler = profiler;
         m_running = true;
 
-        m_thread = std::thread([this]()
+        m_thread = std::thread([this, frameAllocator, profiler, name]()
         {
+            if(frameAllocator)
+            {
+                workerScratchAllocator = &frameAllocator->GetThreadAllocator();
+            }
+            if(profiler)
+            {
+                profiler->SetThreadName(name.empty() ? std::string{ "Thread pool worker" } : name);
+            }
+
             m_freeFunction();
 
             while(m_running)
@@ -144,10 +342,24 @@ namespace Molten
                     return;
                 }
 
+                if(profiler)
+                {
+                    m_jobStart = profiler->GetTime();
+                }
                 m_function();
+
                 m_freeFunction();
             }
         });
+
+        if(!name.empty())
+        {
+            SetThreadName(m_thread, name);
+        }
+        if(cpu.has_value())
+        {
+            SetThreadAffinity(m_thread, cpu.value());
+        }
     }
 
     void ThreadPool::Worker::Stop()
@@ -156,6 +368,19 @@ namespace Molten
         m_workSemaphore.NotifyOne();
     }
 
+    ThreadPool::Priority ThreadPool::Worker::GetPriority() const
+    {
+        return m_priority;
+    }
+
+    void ThreadPool::Worker::RecordJobSpan()
+    {
+        if(m_profiler)
+        {
+            m_profiler->RecordSpan(GetPriorityName(m_priority), SchedulerProfiler::JobCategory, m_jobStart, m_profiler->GetTime());
+        }
+    }
+
     ThreadPool::Worker::~Worker()
     {
         if(m_thread.joinable())
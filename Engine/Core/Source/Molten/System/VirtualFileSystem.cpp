@@ -0,0 +1,298 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace Molten
+{
+
+    // Virtual file implementations.
+    VirtualFile::VirtualFile() = default;
+
+    VirtualFile::VirtualFile(MappedFile mappedFile, const std::string_view data) :
+        m_owner(mappedFile),
+        m_mappedFile(std::move(mappedFile)),
+        m_data(data)
+    {}
+
+    VirtualFile::VirtualFile(Owner owner, const std::string_view data) :
+        m_owner(std::move(owner)),
+        m_mappedFile{},
+        m_data(data)
+    {}
+
+    const char* VirtualFile::GetData() const
+    {
+        return m_data.data();
+    }
+
+    size_t VirtualFile::GetSize() const
+    {
+        return m_data.size();
+    }
+
+    std::string_view VirtualFile::GetView() const
+    {
+        return m_data;
+    }
+
+    const VirtualFile::Owner& VirtualFile::GetOwner() const
+    {
+        return m_owner;
+    }
+
+    const VirtualFile::MappedFile& VirtualFile::GetMappedFile() const
+    {
+        return m_mappedFile;
+    }
+
+
+    // Virtual file system directory implementations.
+    VirtualFileSystemDirectory::VirtualFileSystemDirectory(std::filesystem::path directory) :
+        m_directory(std::move(directory))
+    {}
+
+    std::optional<VirtualFile> VirtualFileSystemDirectory::Open(const std::string_view path) const
+    {
+        auto mappedFile = std::make_shared<MemoryMappedFile>();
+        if(!mappedFile->Open(m_directory / std::filesystem::u8path(path)))
+        {
+            return std::nullopt;
+        }
+
+        const auto data = mappedFile->GetView();
+        return VirtualFile{ VirtualFile::MappedFile{ std::move(mappedFile) }, data };
+    }
+
+    bool VirtualFileSystemDirectory::Exists(const std::string_view path) const
+    {
+        std::error_code errorCode;
+        return std::filesystem::is_regular_file(m_directory / std::filesystem::u8path(path), errorCode);
+    }
+
+    bool VirtualFileSystemDirectory::ListDirectory(const std::string_view directory, std::vector<std::string>& names) const
+    {
+        std::error_code errorCode;
+        auto iterator = std::filesystem::directory_iterator(m_directory / std::filesystem::u8path(directory), errorCode);
+        if(errorCode)
+        {
+            return false;
+        }
+
+        for(const auto& entry : iterator)
+        {
+            if(entry.is_regular_file(errorCode))
+            {
+                names.push_back(entry.path().filename().u8string());
+            }
+        }
+        return true;
+    }
+
+    const std::filesystem::path& VirtualFileSystemDirectory::GetDirectory() const
+    {
+        return m_directory;
+    }
+
+
+    // Virtual file system implementations.
+    void VirtualFileSystem::Mount(std::shared_ptr<const VirtualFileSystemMount> mount, const std::string_view mountPoint)
+    {
+        if(!mount)
+        {
+            return;
+        }
+
+        auto path = NormalizePath(mountPoint);
+
+        std::unique_lock lock(m_mutex);
+        m_mountPoints.push_back({ std::move(path), std::move(mount) });
+    }
+
+    bool VirtualFileSystem::MountDirectory(const std::filesystem::path& directory, const std::string_view mountPoint)
+    {
+        std::error_code errorCode;
+        if(!std::filesystem::is_directory(directory, errorCode))
+        {
+            return false;
+        }
+
+        Mount(std::make_shared<VirtualFileSystemDirectory>(directory), mountPoint);
+        return true;
+    }
+
+    bool VirtualFileSystem::Unmount(const std::shared_ptr<const VirtualFileSystemMount>& mount)
+    {
+        std::unique_lock lock(m_mutex);
+
+        const auto it = std::remove_if(m_mountPoints.begin(), m_mountPoints.end(), [&](const auto& mountPoint)
+        {
+            return mountPoint.mount == mount;
+        });
+
+        const bool found = it != m_mountPoints.end();
+        m_mountPoints.erase(it, m_mountPoints.end());
+        return found;
+    }
+
+    void VirtualFileSystem::UnmountAll()
+    {
+        std::unique_lock lock(m_mutex);
+        m_mountPoints.clear();
+    }
+
+    size_t VirtualFileSystem::GetMountCount() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_mountPoints.size();
+    }
+
+    std::optional<VirtualFile> VirtualFileSystem::Open(const std::string_view path) const
+    {
+        const auto normalizedPath = NormalizePath(path);
+
+        std::shared_lock lock(m_mutex);
+        for(auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+        {
+            if(const auto relativePath = GetMountRelativePath(*it, normalizedPath); relativePath)
+            {
+                if(auto file = it->mount->Open(*relativePath); file)
+                {
+                    return file;
+                }
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    bool VirtualFileSystem::Exists(const std::string_view path) const
+    {
+        const auto normalizedPath = NormalizePath(path);
+
+        std::shared_lock lock(m_mutex);
+        return std::any_of(m_mountPoints.begin(), m_mountPoints.end(), [&](const auto& mountPoint)
+        {
+            const auto relativePath = GetMountRelativePath(mountPoint, normalizedPath);
+            return relativePath && mountPoint.mount->Exists(*relativePath);
+        });
+    }
+
+    std::optional<std::vector<std::string>> VirtualFileSystem::ListDirectory(const std::string_view directory) const
+    {
+        const auto normalizedDirectory = NormalizePath(directory);
+
+        std::vector<std::string> names;
+        bool found = false;
+        {
+            std::shared_lock lock(m_mutex);
+            for(const auto& mountPoint : m_mountPoints)
+            {
+                if(const auto relativePath = GetMountRelativePath(mountPoint, normalizedDirectory); relativePath)
+                {
+                    found = mountPoint.mount->ListDirectory(*relativePath, names) || found;
+                }
+            }
+        }
+
+        if(!found)
+        {
+            return std::nullopt;
+        }
+
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        return names;
+    }
+
+    std::string VirtualFileSystem::NormalizePath(const std::string_view path)
+    {
+        std::string result;
+        result.reserve(path.size());
+
+        size_t position = 0;
+        while(position < path.size())
+        {
+            auto end = path.find_first_of("/\\", position);
+            if(end == std::string_view::npos)
+            {
+                end = path.size();
+            }
+
+            const auto segment = path.substr(position, end - position);
+            position = end + 1;
+
+            if(segment.empty() || segment == ".")
+            {
+                continue;
+            }
+
+            if(segment == "..")
+            {
+                const auto parentEnd = result.find_last_of('/');
+                result.resize(parentEnd == std::string::npos ? 0 : parentEnd);
+                continue;
+            }
+
+            if(!result.empty())
+            {
+                result.push_back('/');
+            }
+            result.append(segment);
+        }
+
+        return result;
+    }
+
+    std::optional<std::string_view> VirtualFileSystem::GetMountRelativePath(const MountPoint& mountPoint, const std::string_view path)
+    {
+        const auto& mountPath = mountPoint.path;
+        if(mountPath.empty())
+        {
+            return path;
+        }
+
+        if(path.size() < mountPath.size() || path.compare(0, mountPath.size(), mountPath) != 0)
+        {
+            return std::nullopt;
+        }
+
+        if(path.size() == mountPath.size())
+        {
+            return std::string_view{};
+        }
+
+        if(path[mountPath.size()] != '/')
+        {
+            return std::nullopt;
+        }
+
+        return path.substr(mountPath.size() + 1);
+    }
+
+}
@@ -24,6 +24,7 @@
 */
 
 #include "Molten/Utility/BufferedFileLineReader.hpp"
+#include "Molten/Utility/TextScanner.hpp"
 
 namespace Molten
 {
@@ -68,7 +69,7 @@ namespace Molten
 
     size_t BufferedFileLineReader::FindNextNewline(const std::string_view& line)
     {
-        const auto newline = line.find_first_of("\r\n");
+        const auto newline = TextScanner::FindNewline(line);
         if (newline == std::string_view::npos)
         {
             return newline;
@@ -28,53 +28,82 @@
 namespace Molten
 {
 
-    FunctionDispatcher::~FunctionDispatcher()
-    {
-        const std::lock_guard lock(m_mutex);
-        m_functions.clear();
-    }
+    FunctionDispatcher::FunctionDispatcher() :
+        m_head(nullptr)
+    {}
 
-    void FunctionDispatcher::Add(Function&& function)
+    FunctionDispatcher::~FunctionDispatcher()
     {
-        const std::lock_guard lock(m_mutex);
-        m_functions.push_back(std::move(function));
+        auto* node = m_head.exchange(nullptr, std::memory_order_acquire);
+        while(node)
+        {
+            auto* next = node->next;
+            DestroyNode(node);
+            node = next;
+        }
     }
 
-    void FunctionDispatcher::Dispatch()
+    size_t FunctionDispatcher::Dispatch()
     {
-        const auto count = LockGetFunctionCount();
+        // Swap out all pending functions at once, producers continue pushing to an empty list.
+        auto* node = ReverseList(m_head.exchange(nullptr, std::memory_order_acquire));
 
-        for(size_t i = 0; i < count; i++)
+        size_t count = 0;
+        while(node)
         {
-            auto function = LockMoveFunction(i);
-            function();
+            auto* next = node->next;
+
+            try
+            {
+                node->invoke(*node);
+            }
+            catch (...)
+            {
+                // Remaining functions of this dispatch are discarded.
+                while (node)
+                {
+                    next = node->next;
+                    DestroyNode(node);
+                    node = next;
+                }
+                throw;
+            }
+
+            DestroyNode(node);
+            node = next;
+            ++count;
         }
 
-        LockRemoveFunctions(count);
+        return count;
     }
 
-    size_t FunctionDispatcher::LockGetFunctionCount()
+    void FunctionDispatcher::Push(Node* node)
     {
-        const std::lock_guard lock(m_mutex);
-        return m_functions.size();
+        auto* head = m_head.load(std::memory_order_relaxed);
+        do
+        {
+            node->next = head;
+        }
+        while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
     }
 
-    FunctionDispatcher::Function FunctionDispatcher::LockMoveFunction(const size_t index)
+    FunctionDispatcher::Node* FunctionDispatcher::ReverseList(Node* node)
     {
-        const std::lock_guard lock(m_mutex);
-        return std::move(m_functions[index]);
+        Node* prev = nullptr;
+        while (node)
+        {
+            auto* next = node->next;
+            node->next = prev;
+            prev = node;
+            node = next;
+        }
+        return prev;
     }
 
-    void FunctionDispatcher::LockRemoveFunctions(const size_t count)
+    void FunctionDispatcher::DestroyNode(Node* node)
     {
-	    if(count == 0)
-	    {
-            return;
-	    }
-
-        const std::lock_guard lock(m_mutex);
-        m_functions.erase(m_functions.begin(), m_functions.begin() + count);
+        node->destroy(*node);
+        delete node;
     }
 
-
-}
\ No newline at end of file
+}
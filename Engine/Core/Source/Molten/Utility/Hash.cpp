@@ -0,0 +1,136 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Utility/Hash.hpp"
+#include <cstring>
+
+namespace Molten
+{
+
+    // Global implementations.
+    static constexpr uint64_t HashPrime1 = 11400714785074694791ULL;
+    static constexpr uint64_t HashPrime2 = 14029467366897019727ULL;
+    static constexpr uint64_t HashPrime3 = 1609587929392839161ULL;
+    static constexpr uint64_t HashPrime4 = 9650029242287828579ULL;
+    static constexpr uint64_t HashPrime5 = 2870177450012600261ULL;
+
+    static uint64_t RotateLeft(const uint64_t value, const int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static uint64_t Read64(const uint8_t* data)
+    {
+        uint64_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static uint32_t Read32(const uint8_t* data)
+    {
+        uint32_t value = 0;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static uint64_t HashRound(uint64_t accumulator, const uint64_t input)
+    {
+        accumulator += input * HashPrime2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * HashPrime1;
+    }
+
+    static uint64_t HashMergeRound(uint64_t accumulator, const uint64_t value)
+    {
+        accumulator ^= HashRound(0, value);
+        return accumulator * HashPrime1 + HashPrime4;
+    }
+
+    uint64_t Hash64(const void* data, const size_t size, const uint64_t seed)
+    {
+        const auto* current = static_cast<const uint8_t*>(data);
+        const auto* end = current + size;
+
+        uint64_t hash = 0;
+
+        if (size >= 32)
+        {
+            uint64_t lanes[4] = {
+                seed + HashPrime1 + HashPrime2,
+                seed + HashPrime2,
+                seed,
+                seed - HashPrime1
+            };
+
+            for (const auto* limit = end - 32; current <= limit; current += 32)
+            {
+                lanes[0] = HashRound(lanes[0], Read64(current));
+                lanes[1] = HashRound(lanes[1], Read64(current + 8));
+                lanes[2] = HashRound(lanes[2], Read64(current + 16));
+                lanes[3] = HashRound(lanes[3], Read64(current + 24));
+            }
+
+            hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+            for (const auto lane : lanes)
+            {
+                hash = HashMergeRound(hash, lane);
+            }
+        }
+        else
+        {
+            hash = seed + HashPrime5;
+        }
+
+        hash += static_cast<uint64_t>(size);
+
+        for (; current + 8 <= end; current += 8)
+        {
+            hash ^= HashRound(0, Read64(current));
+            hash = RotateLeft(hash, 27) * HashPrime1 + HashPrime4;
+        }
+
+        if (current + 4 <= end)
+        {
+            hash ^= static_cast<uint64_t>(Read32(current)) * HashPrime1;
+            hash = RotateLeft(hash, 23) * HashPrime2 + HashPrime3;
+            current += 4;
+        }
+
+        for (; current < end; ++current)
+        {
+            hash ^= static_cast<uint64_t>(*current) * HashPrime5;
+            hash = RotateLeft(hash, 11) * HashPrime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= HashPrime2;
+        hash ^= hash >> 29;
+        hash *= HashPrime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+}
@@ -0,0 +1,861 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Molten/Utility/Lz4.hpp"
+#include "Molten/Utility/Hash.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Molten::Lz4
+{
+
+    // Global implementations.
+    namespace
+    {
+
+        constexpr size_t MinMatchLength = 4;
+        constexpr size_t LastLiteralCount = 5; ///< Last bytes of blocks are always literals.
+        constexpr size_t MatchFindLimit = 12; ///< Matches never start within last bytes of blocks.
+        constexpr size_t MaxOffset = 65535;
+        constexpr uint32_t HashLog = 12;
+        constexpr uint32_t SkipTrigger = 6; ///< Search step grows every 2^SkipTrigger failed searches, skipping incompressible data quickly.
+        constexpr size_t MaxLengthCode = 15;
+
+        constexpr uint32_t FrameMagic = 0x345A4C4D; ///< "MLZ4"
+        constexpr uint16_t FrameVersion = 1;
+        constexpr uint16_t FrameChecksumFlag = 1;
+        constexpr size_t FrameHeaderSize = 16;
+        constexpr size_t FrameTrailerSize = 8;
+        constexpr size_t BlockHeaderSize = 4;
+        constexpr size_t BlockChecksumSize = 8;
+        constexpr uint32_t StoredBlockFlag = 0x80000000;
+
+        // Data is stored in little endian, matching all supported platforms.
+        template<typename T>
+        T ReadValue(const uint8_t* data)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        void WriteValue(uint8_t* data, const T value)
+        {
+            std::memcpy(data, &value, sizeof(T));
+        }
+
+        size_t CountTrailingZeros(const uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward64(&index, value);
+            return static_cast<size_t>(index);
+#else
+            return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+        }
+
+        uint32_t HashSequence(const uint32_t sequence)
+        {
+            return (sequence * 2654435761U) >> (32 - HashLog);
+        }
+
+        /** Copies 8 or 16 bytes at a time, writing up to chunk size - 1 bytes past destination + size. */
+        template<size_t VChunkSize>
+        void WildCopy(uint8_t* destination, const uint8_t* source, const size_t size)
+        {
+            const auto* destinationEnd = destination + size;
+            do
+            {
+                std::memcpy(destination, source, VChunkSize);
+                destination += VChunkSize;
+                source += VChunkSize;
+            }
+            while(destination < destinationEnd);
+        }
+
+        size_t CountMatchLength(const uint8_t* current, const uint8_t* match, const uint8_t* limit)
+        {
+            const auto* start = current;
+            while(current + 8 <= limit)
+            {
+                if(const auto difference = ReadValue<uint64_t>(current) ^ ReadValue<uint64_t>(match); difference != 0)
+                {
+                    return static_cast<size_t>(current - start) + CountTrailingZeros(difference) / 8;
+                }
+                current += 8;
+                match += 8;
+            }
+            while(current < limit && *current == *match)
+            {
+                ++current;
+                ++match;
+            }
+            return static_cast<size_t>(current - start);
+        }
+
+        /** Searches next match, with a step growing while searches fail. Positions of searched sequences are added to the hash table.
+         *
+         * @return false if no match was found before search limit.
+         */
+        bool FindMatch(const uint8_t* input, uint32_t* table, const uint8_t* searchLimit, const uint8_t*& current, const uint8_t*& match)
+        {
+            uint32_t searchCount = 1U << SkipTrigger;
+            for(const auto* next = current;;)
+            {
+                current = next;
+                next += searchCount++ >> SkipTrigger;
+                if(next > searchLimit)
+                {
+                    return false;
+                }
+
+                const auto sequence = ReadValue<uint32_t>(current);
+                const auto hash = HashSequence(sequence);
+                match = input + table[hash];
+                table[hash] = static_cast<uint32_t>(current - input);
+
+                if(static_cast<size_t>(current - match) <= MaxOffset && ReadValue<uint32_t>(match) == sequence)
+                {
+                    return true;
+                }
+            }
+        }
+
+        size_t GetLengthSize(const size_t length)
+        {
+            return length >= MaxLengthCode ? (length - MaxLengthCode) / 255 + 1 : 0;
+        }
+
+        uint8_t* WriteLength(uint8_t* output, size_t length)
+        {
+            if(length < MaxLengthCode)
+            {
+                return output;
+            }
+
+            length -= MaxLengthCode;
+            for(; length >= 255; length -= 255)
+            {
+                *output++ = 255;
+            }
+            *output++ = static_cast<uint8_t>(length);
+            return output;
+        }
+
+        bool ReadLength(const uint8_t*& input, const uint8_t* inputEnd, size_t& length)
+        {
+            if(length != MaxLengthCode)
+            {
+                return true;
+            }
+
+            uint8_t value = 0;
+            do
+            {
+                if(input >= inputEnd)
+                {
+                    return false;
+                }
+                value = *input++;
+                length += value;
+            }
+            while(value == 255);
+
+            return true;
+        }
+
+        /** Copies match of offset less than 8 bytes, i.e. runs of repeated patterns.
+         *  Bytes are periodic with the offset, so after copying the first bytes, the rest is copied from a multiple of the offset of at least 8 bytes.
+         */
+        void CopyShortOffsetMatch(uint8_t* output, const uint8_t* match, const size_t offset, const size_t length, const bool hasMargin)
+        {
+            const auto distance = offset * ((8 + offset - 1) / offset);
+            const auto headLength = std::min(length, distance);
+            for(size_t i = 0; i < headLength; i++)
+            {
+                output[i] = match[i];
+            }
+
+            if(length > headLength)
+            {
+                if(hasMargin)
+                {
+                    WildCopy<8>(output + headLength, output + headLength - distance, length - headLength);
+                }
+                else
+                {
+                    for(size_t i = headLength; i < length; i++)
+                    {
+                        output[i] = output[i - distance];
+                    }
+                }
+            }
+        }
+
+        size_t GetMaxBlockRecordSize(const size_t blockSize)
+        {
+            return BlockHeaderSize + GetMaxCompressedBlockSize(blockSize) + BlockChecksumSize;
+        }
+
+        /** Writes frame block record of content into record, with capacity of GetMaxBlockRecordSize(size).
+         *
+         * @return Size of record.
+         */
+        size_t EncodeBlockRecord(const uint8_t* content, const size_t size, const bool checksum, uint8_t* record)
+        {
+            auto* data = record + BlockHeaderSize;
+            auto storedSize = CompressBlock(content, size, data, GetMaxCompressedBlockSize(size));
+
+            uint32_t header = static_cast<uint32_t>(storedSize);
+            if(storedSize == 0 || storedSize >= size)
+            {
+                std::memcpy(data, content, size);
+                storedSize = size;
+                header = static_cast<uint32_t>(size) | StoredBlockFlag;
+            }
+            WriteValue<uint32_t>(record, header);
+
+            if(checksum)
+            {
+                WriteValue<uint64_t>(data + storedSize, Hash64(content, size));
+            }
+
+            return BlockHeaderSize + storedSize + (checksum ? BlockChecksumSize : 0);
+        }
+
+        /** Decodes data of block record into output, with capacity of expected max content size.
+         *
+         * @return Size of content, or nullopt if block is invalid or checksum mismatches.
+         */
+        std::optional<size_t> DecodeBlockRecord(
+            const uint8_t* data,
+            const uint32_t header,
+            const uint8_t* checksum,
+            uint8_t* output,
+            const size_t outputCapacity)
+        {
+            const size_t storedSize = header & ~StoredBlockFlag;
+
+            std::optional<size_t> size;
+            if((header & StoredBlockFlag) != 0)
+            {
+                if(storedSize <= outputCapacity)
+                {
+                    std::memcpy(output, data, storedSize);
+                    size = storedSize;
+                }
+            }
+            else
+            {
+                size = DecompressBlock(data, storedSize, output, outputCapacity);
+            }
+
+            if(size && checksum && ReadValue<uint64_t>(checksum) != Hash64(output, *size))
+            {
+                return std::nullopt;
+            }
+            return size;
+        }
+
+        void WriteFrameHeader(uint8_t* data, const size_t blockSize, const bool checksum)
+        {
+            WriteValue<uint32_t>(data, FrameMagic);
+            WriteValue<uint16_t>(data + 4, FrameVersion);
+            WriteValue<uint16_t>(data + 6, checksum ? FrameChecksumFlag : uint16_t{ 0 });
+            WriteValue<uint32_t>(data + 8, static_cast<uint32_t>(blockSize));
+            WriteValue<uint32_t>(data + 12, 0);
+        }
+
+        bool ReadFrameHeader(const uint8_t* data, size_t& blockSize, bool& checksum)
+        {
+            const auto flags = ReadValue<uint16_t>(data + 6);
+            blockSize = ReadValue<uint32_t>(data + 8);
+            checksum = (flags & FrameChecksumFlag) != 0;
+
+            return ReadValue<uint32_t>(data) == FrameMagic &&
+                ReadValue<uint16_t>(data + 4) == FrameVersion &&
+                (flags & ~FrameChecksumFlag) == 0 &&
+                blockSize > 0 && blockSize <= MaxFrameBlockSize &&
+                ReadValue<uint32_t>(data + 12) == 0;
+        }
+
+        size_t ClampFrameBlockSize(const size_t blockSize)
+        {
+            return std::clamp(blockSize, size_t{ 1 }, MaxFrameBlockSize);
+        }
+
+    }
+
+    size_t GetMaxCompressedBlockSize(const size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    size_t CompressBlock(const void* source, const size_t sourceSize, void* destination, const size_t destinationCapacity)
+    {
+        const auto* input = static_cast<const uint8_t*>(source);
+        const auto* inputEnd = input + sourceSize;
+        auto* outputBegin = static_cast<uint8_t*>(destination);
+        auto* output = outputBegin;
+        const auto* outputEnd = output + destinationCapacity;
+        const auto* anchor = input;
+
+        if(sourceSize > MatchFindLimit)
+        {
+            const auto* matchLimit = inputEnd - LastLiteralCount;
+            const auto* searchLimit = inputEnd - MatchFindLimit;
+
+            // Positions relative to input, of last occurrence of each hashed 4 byte sequence.
+            uint32_t table[size_t{ 1 } << HashLog] = {};
+
+            const auto* current = input + 1;
+            const uint8_t* match = nullptr;
+            while(FindMatch(input, table, searchLimit, current, match))
+            {
+                // Extend match backwards over pending literals.
+                while(current > anchor && match > input && current[-1] == match[-1])
+                {
+                    --current;
+                    --match;
+                }
+
+                const auto literalCount = static_cast<size_t>(current - anchor);
+                const auto matchLength = MinMatchLength + CountMatchLength(current + MinMatchLength, match + MinMatchLength, matchLimit);
+                const auto matchCode = matchLength - MinMatchLength;
+                const auto offset = static_cast<uint16_t>(current - match);
+
+                const auto sequenceSize = 1 + GetLengthSize(literalCount) + literalCount + 2 + GetLengthSize(matchCode);
+                if(sequenceSize > static_cast<size_t>(outputEnd - output))
+                {
+                    return 0;
+                }
+
+                *output++ = static_cast<uint8_t>((std::min(literalCount, MaxLengthCode) << 4) | std::min(matchCode, MaxLengthCode));
+                output = WriteLength(output, literalCount);
+                std::memcpy(output, anchor, literalCount);
+                output += literalCount;
+                WriteValue<uint16_t>(output, offset);
+                output += 2;
+                output = WriteLength(output, matchCode);
+
+                current += matchLength;
+                anchor = current;
+
+                const auto previous = current - 2;
+                table[HashSequence(ReadValue<uint32_t>(previous))] = static_cast<uint32_t>(previous - input);
+            }
+        }
+
+        // Last literals.
+        const auto literalCount = static_cast<size_t>(inputEnd - anchor);
+        if(1 + GetLengthSize(literalCount) + literalCount > static_cast<size_t>(outputEnd - output))
+        {
+            return 0;
+        }
+
+        *output++ = static_cast<uint8_t>(std::min(literalCount, MaxLengthCode) << 4);
+        output = WriteLength(output, literalCount);
+        if(literalCount > 0)
+        {
+            std::memcpy(output, anchor, literalCount);
+            output += literalCount;
+        }
+
+        return static_cast<size_t>(output - outputBegin);
+    }
+
+    std::optional<size_t> DecompressBlock(const void* source, const size_t sourceSize, void* destination, const size_t destinationCapacity)
+    {
+        const auto* input = static_cast<const uint8_t*>(source);
+        const auto* inputEnd = input + sourceSize;
+        auto* outputBegin = static_cast<uint8_t*>(destination);
+        auto* output = outputBegin;
+        auto* outputEnd = output + destinationCapacity;
+
+        while(true)
+        {
+            if(input >= inputEnd)
+            {
+                return std::nullopt;
+            }
+            const auto token = *input++;
+
+            // Literals. Short literals far from the end of input and output are copied as a fixed size chunk,
+            // and such sequences are never the last sequence, since at least 2 bytes of input remain.
+            size_t literalCount = token >> 4;
+            if(literalCount != MaxLengthCode && static_cast<size_t>(inputEnd - input) >= 16 && static_cast<size_t>(outputEnd - output) >= 32)
+            {
+                std::memcpy(output, input, 16);
+                input += literalCount;
+                output += literalCount;
+            }
+            else
+            {
+                if(!ReadLength(input, inputEnd, literalCount) ||
+                    literalCount > static_cast<size_t>(inputEnd - input) ||
+                    literalCount > static_cast<size_t>(outputEnd - output))
+                {
+                    return std::nullopt;
+                }
+
+                if(literalCount + 16 <= static_cast<size_t>(inputEnd - input) && literalCount + 16 <= static_cast<size_t>(outputEnd - output))
+                {
+                    WildCopy<16>(output, input, literalCount);
+                }
+                else if(literalCount > 0)
+                {
+                    std::memcpy(output, input, literalCount);
+                }
+                input += literalCount;
+                output += literalCount;
+
+                // Last sequence has no match.
+                if(input == inputEnd)
+                {
+                    break;
+                }
+                if(inputEnd - input < 2)
+                {
+                    return std::nullopt;
+                }
+            }
+
+            // Match.
+            const size_t offset = ReadValue<uint16_t>(input);
+            input += 2;
+            if(offset == 0 || offset > static_cast<size_t>(output - outputBegin))
+            {
+                return std::nullopt;
+            }
+            const auto* match = output - offset;
+
+            // Short matches of non-overlapping 8 byte chunks are copied as a fixed size chunk.
+            size_t matchLength = token & 0x0F;
+            if(matchLength != MaxLengthCode && offset >= 8 && static_cast<size_t>(outputEnd - output) >= 18)
+            {
+                std::memcpy(output, match, 8);
+                std::memcpy(output + 8, match + 8, 8);
+                std::memcpy(output + 16, match + 16, 2);
+                output += matchLength + MinMatchLength;
+                continue;
+            }
+
+            if(!ReadLength(input, inputEnd, matchLength))
+            {
+                return std::nullopt;
+            }
+            matchLength += MinMatchLength;
+            if(matchLength > static_cast<size_t>(outputEnd - output))
+            {
+                return std::nullopt;
+            }
+
+            const auto margin = static_cast<size_t>(outputEnd - output) - matchLength;
+            if(offset >= 16 && margin >= 16)
+            {
+                WildCopy<16>(output, match, matchLength);
+            }
+            else if(offset >= 8 && margin >= 8)
+            {
+                WildCopy<8>(output, match, matchLength);
+            }
+            else if(offset < 8)
+            {
+                CopyShortOffsetMatch(output, match, offset, matchLength, margin >= 8);
+            }
+            else
+            {
+                for(size_t i = 0; i < matchLength; i++)
+                {
+                    output[i] = match[i];
+                }
+            }
+            output += matchLength;
+        }
+
+        return static_cast<size_t>(output - outputBegin);
+    }
+
+    bool IsFrame(const void* data, const size_t size)
+    {
+        return size >= FrameHeaderSize && ReadValue<uint32_t>(static_cast<const uint8_t*>(data)) == FrameMagic;
+    }
+
+    std::optional<size_t> GetFrameContentSize(const void* data, const size_t size)
+    {
+        if(!IsFrame(data, size) || size < FrameHeaderSize + BlockHeaderSize + FrameTrailerSize)
+        {
+            return std::nullopt;
+        }
+
+        const auto contentSize = ReadValue<uint64_t>(static_cast<const uint8_t*>(data) + size - FrameTrailerSize);
+        if(contentSize > std::numeric_limits<size_t>::max())
+        {
+            return std::nullopt;
+        }
+        return static_cast<size_t>(contentSize);
+    }
+
+    std::vector<uint8_t> CompressFrame(
+        const void* data,
+        const size_t size,
+        const size_t blockSize,
+        const bool checksum,
+        ThreadPool* threadPool)
+    {
+        const auto* content = static_cast<const uint8_t*>(data);
+        const auto frameBlockSize = ClampFrameBlockSize(blockSize);
+        const auto blockCount = (size + frameBlockSize - 1) / frameBlockSize;
+        const auto recordCapacity = GetMaxBlockRecordSize(frameBlockSize);
+
+        // Blocks are encoded into fixed slots, then moved together.
+        std::vector<uint8_t> frame(FrameHeaderSize + blockCount * recordCapacity + BlockHeaderSize + FrameTrailerSize);
+        std::vector<size_t> recordSizes(blockCount);
+
+        auto encodeBlock = [&](const size_t index)
+        {
+            const auto offset = index * frameBlockSize;
+            const auto blockContentSize = std::min(frameBlockSize, size - offset);
+            recordSizes[index] = EncodeBlockRecord(content + offset, blockContentSize, checksum, frame.data() + FrameHeaderSize + index * recordCapacity);
+        };
+
+        if(threadPool && blockCount > 1)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Normal, blockCount, encodeBlock);
+        }
+        else
+        {
+            for(size_t i = 0; i < blockCount; i++)
+            {
+                encodeBlock(i);
+            }
+        }
+
+        WriteFrameHeader(frame.data(), frameBlockSize, checksum);
+
+        auto position = FrameHeaderSize;
+        for(size_t i = 0; i < blockCount; i++)
+        {
+            std::memmove(frame.data() + position, frame.data() + FrameHeaderSize + i * recordCapacity, recordSizes[i]);
+            position += recordSizes[i];
+        }
+
+        WriteValue<uint32_t>(frame.data() + position, 0);
+        WriteValue<uint64_t>(frame.data() + position + BlockHeaderSize, static_cast<uint64_t>(size));
+        frame.resize(position + BlockHeaderSize + FrameTrailerSize);
+        return frame;
+    }
+
+    std::optional<std::vector<uint8_t>> DecompressFrame(const void* data, const size_t size, ThreadPool* threadPool)
+    {
+        const auto* frame = static_cast<const uint8_t*>(data);
+        const auto contentSize = GetFrameContentSize(data, size);
+        size_t blockSize = 0;
+        bool checksum = false;
+        if(!contentSize || !ReadFrameHeader(frame, blockSize, checksum))
+        {
+            return std::nullopt;
+        }
+
+        // Locate all blocks before allocating content, so corrupt content sizes are rejected without allocations.
+        struct Block
+        {
+            const uint8_t* data;
+            uint32_t header;
+        };
+        std::vector<Block> blocks;
+
+        const auto checksumSize = checksum ? BlockChecksumSize : 0;
+        const auto blocksEnd = size - FrameTrailerSize - BlockHeaderSize;
+        auto position = FrameHeaderSize;
+        while(position < blocksEnd)
+        {
+            if(blocksEnd - position < BlockHeaderSize)
+            {
+                return std::nullopt;
+            }
+
+            const auto header = ReadValue<uint32_t>(frame + position);
+            const size_t storedSize = header & ~StoredBlockFlag;
+            position += BlockHeaderSize;
+            if(header == 0 || storedSize + checksumSize > blocksEnd - position)
+            {
+                return std::nullopt;
+            }
+
+            blocks.push_back({ frame + position, header });
+            position += storedSize + checksumSize;
+        }
+
+        if(position != blocksEnd || ReadValue<uint32_t>(frame + position) != 0 ||
+            blocks.size() != (*contentSize + blockSize - 1) / blockSize)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> content(*contentSize);
+        std::atomic<bool> valid = true;
+
+        auto decodeBlock = [&](const size_t index)
+        {
+            const auto& block = blocks[index];
+            const auto offset = index * blockSize;
+            const auto expectedSize = std::min(blockSize, content.size() - offset);
+            const size_t storedSize = block.header & ~StoredBlockFlag;
+
+            const auto decodedSize = DecodeBlockRecord(
+                block.data, block.header, checksum ? block.data + storedSize : nullptr, content.data() + offset, expectedSize);
+            if(decodedSize != expectedSize)
+            {
+                valid = false;
+            }
+        };
+
+        if(threadPool && blocks.size() > 1)
+        {
+            threadPool->ParallelFor(ThreadPool::Priority::Normal, blocks.size(), decodeBlock);
+        }
+        else
+        {
+            for(size_t i = 0; i < blocks.size() && valid; i++)
+            {
+                decodeBlock(i);
+            }
+        }
+
+        if(!valid)
+        {
+            return std::nullopt;
+        }
+        return content;
+    }
+
+
+    // Frame writer implementations.
+    FrameWriter::FrameWriter(std::ostream& stream, const size_t blockSize, const bool checksum) :
+        m_stream(stream),
+        m_blockSize(ClampFrameBlockSize(blockSize)),
+        m_checksum(checksum),
+        m_headerWritten(false),
+        m_finished(false),
+        m_contentSize(0)
+    {}
+
+    bool FrameWriter::Write(const void* data, const size_t size)
+    {
+        if(m_finished || (!m_headerWritten && !WriteHeader()))
+        {
+            return false;
+        }
+
+        const auto* content = static_cast<const uint8_t*>(data);
+        for(size_t position = 0; position < size;)
+        {
+            const auto copySize = std::min(size - position, m_blockSize - m_block.size());
+            m_block.insert(m_block.end(), content + position, content + position + copySize);
+            position += copySize;
+
+            if(m_block.size() == m_blockSize && !WriteBlock())
+            {
+                return false;
+            }
+        }
+
+        m_contentSize += size;
+        return true;
+    }
+
+    bool FrameWriter::Finish()
+    {
+        if(m_finished || (!m_headerWritten && !WriteHeader()))
+        {
+            return false;
+        }
+        m_finished = true;
+
+        if(!m_block.empty() && !WriteBlock())
+        {
+            return false;
+        }
+
+        uint8_t trailer[BlockHeaderSize + FrameTrailerSize];
+        WriteValue<uint32_t>(trailer, 0);
+        WriteValue<uint64_t>(trailer + BlockHeaderSize, m_contentSize);
+        m_stream.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+        m_stream.flush();
+        return m_stream.good();
+    }
+
+    bool FrameWriter::WriteHeader()
+    {
+        uint8_t header[FrameHeaderSize];
+        WriteFrameHeader(header, m_blockSize, m_checksum);
+        m_stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        m_block.reserve(m_blockSize);
+        m_headerWritten = true;
+        return m_stream.good();
+    }
+
+    bool FrameWriter::WriteBlock()
+    {
+        m_compressedBlock.resize(GetMaxBlockRecordSize(m_blockSize));
+        const auto recordSize = EncodeBlockRecord(m_block.data(), m_block.size(), m_checksum, m_compressedBlock.data());
+        m_block.clear();
+
+        m_stream.write(reinterpret_cast<const char*>(m_compressedBlock.data()), static_cast<std::streamsize>(recordSize));
+        return m_stream.good();
+    }
+
+
+    // Frame reader implementations.
+    FrameReader::FrameReader(std::istream& stream) :
+        m_stream(stream),
+        m_blockSize(0),
+        m_checksum(false),
+        m_headerRead(false),
+        m_finished(false),
+        m_error(false),
+        m_contentSize(0),
+        m_blockPosition(0)
+    {}
+
+    size_t FrameReader::Read(void* data, const size_t size)
+    {
+        if(!m_headerRead && !m_error && !ReadHeader())
+        {
+            m_error = true;
+        }
+
+        auto* output = static_cast<uint8_t*>(data);
+        size_t readSize = 0;
+        while(readSize < size)
+        {
+            if(m_blockPosition == m_block.size())
+            {
+                if(m_finished || m_error || !ReadBlock())
+                {
+                    break;
+                }
+                continue;
+            }
+
+            const auto copySize = std::min(size - readSize, m_block.size() - m_blockPosition);
+            std::memcpy(output + readSize, m_block.data() + m_blockPosition, copySize);
+            m_blockPosition += copySize;
+            readSize += copySize;
+        }
+
+        return readSize;
+    }
+
+    bool FrameReader::IsFinished() const
+    {
+        return m_finished;
+    }
+
+    bool FrameReader::HasError() const
+    {
+        return m_error;
+    }
+
+    bool FrameReader::ReadHeader()
+    {
+        uint8_t header[FrameHeaderSize];
+        if(!m_stream.read(reinterpret_cast<char*>(header), sizeof(header)) || !ReadFrameHeader(header, m_blockSize, m_checksum))
+        {
+            return false;
+        }
+
+        m_headerRead = true;
+        return true;
+    }
+
+    bool FrameReader::ReadBlock()
+    {
+        uint8_t headerData[BlockHeaderSize];
+        if(!m_stream.read(reinterpret_cast<char*>(headerData), sizeof(headerData)))
+        {
+            m_error = true;
+            return false;
+        }
+
+        // End mark, followed by content size.
+        const auto header = ReadValue<uint32_t>(headerData);
+        if(header == 0)
+        {
+            uint8_t trailer[FrameTrailerSize];
+            if(!m_stream.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) || ReadValue<uint64_t>(trailer) != m_contentSize)
+            {
+                m_error = true;
+                return false;
+            }
+
+            m_finished = true;
+            return false;
+        }
+
+        const size_t storedSize = header & ~StoredBlockFlag;
+        const auto checksumSize = m_checksum ? BlockChecksumSize : 0;
+        if(storedSize > GetMaxCompressedBlockSize(m_blockSize))
+        {
+            m_error = true;
+            return false;
+        }
+
+        m_compressedBlock.resize(storedSize + checksumSize);
+        if(!m_stream.read(reinterpret_cast<char*>(m_compressedBlock.data()), static_cast<std::streamsize>(m_compressedBlock.size())))
+        {
+            m_error = true;
+            return false;
+        }
+
+        m_block.resize(m_blockSize);
+        const auto size = DecodeBlockRecord(
+            m_compressedBlock.data(), header, m_checksum ? m_compressedBlock.data() + storedSize : nullptr, m_block.data(), m_block.size());
+        if(!size)
+        {
+            m_block.clear();
+            m_error = true;
+            return false;
+        }
+
+        m_block.resize(*size);
+        m_blockPosition = 0;
+        m_contentSize += *size;
+        return true;
+    }
+
+}
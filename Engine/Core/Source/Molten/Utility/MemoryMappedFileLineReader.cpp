@@ -0,0 +1,85 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/Utility/MemoryMappedFileLineReader.hpp"
+#include "Molten/Utility/TextScanner.hpp"
+
+namespace Molten
+{
+
+    // Memory mapped file line reader implementations.
+    MemoryMappedFileLineReader::MemoryMappedFileLineReader(File file) :
+        m_file(std::move(file)),
+        m_data(m_file ? m_file->GetView() : std::string_view{}),
+        m_position(0)
+    {}
+
+    MemoryMappedFileLineReader::MemoryMappedFileLineReader(const std::string_view data, File file) :
+        m_file(std::move(file)),
+        m_data(data),
+        m_position(0)
+    {}
+
+    size_t MemoryMappedFileLineReader::GetStreamSize() const
+    {
+        return m_data.size();
+    }
+
+    size_t MemoryMappedFileLineReader::GetSizeLeft() const
+    {
+        return m_position < m_data.size() ? m_data.size() - m_position : 0;
+    }
+
+    MemoryMappedFileLineReader::LineReadResult MemoryMappedFileLineReader::ReadNextLine(std::string_view& line)
+    {
+        if(m_position > m_data.size())
+        {
+            line = std::string_view{ m_data.data() + m_data.size(), 0 };
+            return LineReadResult::EndOfFile;
+        }
+
+        const auto view = m_data.substr(m_position);
+        const auto newline = TextScanner::FindNewline(view);
+
+        // Last line, without trailing newline.
+        if(newline == std::string_view::npos)
+        {
+            line = view;
+            m_position = m_data.size() + 1;
+            return LineReadResult::Successful;
+        }
+
+        line = view.substr(0, newline);
+        m_position += newline + 1;
+
+        if(view[newline] == '\r' && newline + 1 < view.size() && view[newline + 1] == '\n')
+        {
+            ++m_position;
+        }
+
+        return LineReadResult::Successful;
+    }
+
+}
@@ -0,0 +1,271 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Molten/Utility/TextScanner.hpp"
+
+#if defined(__AVX2__)
+#define MOLTEN_TEXTSCANNER_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOLTEN_TEXTSCANNER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define MOLTEN_TEXTSCANNER_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Molten::TextScanner
+{
+
+    // Global implementations.
+    static size_t CountTrailingZeros(const uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward64(&index, value);
+        return static_cast<size_t>(index);
+#else
+        return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    static bool IsWhitespace(const char character)
+    {
+        return character == ' ' || character == '\t';
+    }
+
+#if defined(MOLTEN_TEXTSCANNER_AVX2)
+
+    /** Vector kernel, returning a bit mask of 1 bit per matching byte. */
+    struct Kernel
+    {
+        static constexpr size_t BlockSize = 32;
+        static constexpr size_t BitsPerByte = 1;
+        static constexpr uint64_t FullMask = 0xFFFFFFFF;
+        using Vector = __m256i;
+
+        static Vector Load(const char* data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+        static Vector Splat(const char character) { return _mm256_set1_epi8(character); }
+        static Vector Equal(const Vector lhs, const Vector rhs) { return _mm256_cmpeq_epi8(lhs, rhs); }
+        static Vector Or(const Vector lhs, const Vector rhs) { return _mm256_or_si256(lhs, rhs); }
+        static uint64_t Mask(const Vector vector) { return static_cast<uint32_t>(_mm256_movemask_epi8(vector)); }
+    };
+
+#elif defined(MOLTEN_TEXTSCANNER_SSE2)
+
+    /** Vector kernel, returning a bit mask of 1 bit per matching byte. */
+    struct Kernel
+    {
+        static constexpr size_t BlockSize = 16;
+        static constexpr size_t BitsPerByte = 1;
+        static constexpr uint64_t FullMask = 0xFFFF;
+        using Vector = __m128i;
+
+        static Vector Load(const char* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+        static Vector Splat(const char character) { return _mm_set1_epi8(character); }
+        static Vector Equal(const Vector lhs, const Vector rhs) { return _mm_cmpeq_epi8(lhs, rhs); }
+        static Vector Or(const Vector lhs, const Vector rhs) { return _mm_or_si128(lhs, rhs); }
+        static uint64_t Mask(const Vector vector) { return static_cast<uint32_t>(_mm_movemask_epi8(vector)); }
+    };
+
+#elif defined(MOLTEN_TEXTSCANNER_NEON)
+
+    /** Vector kernel, returning a bit mask of 4 bits per matching byte, since NEON lacks a movemask instruction. */
+    struct Kernel
+    {
+        static constexpr size_t BlockSize = 16;
+        static constexpr size_t BitsPerByte = 4;
+        static constexpr uint64_t FullMask = ~uint64_t{ 0 };
+        using Vector = uint8x16_t;
+
+        static Vector Load(const char* data) { return vld1q_u8(reinterpret_cast<const uint8_t*>(data)); }
+        static Vector Splat(const char character) { return vdupq_n_u8(static_cast<uint8_t>(character)); }
+        static Vector Equal(const Vector lhs, const Vector rhs) { return vceqq_u8(lhs, rhs); }
+        static Vector Or(const Vector lhs, const Vector rhs) { return vorrq_u8(lhs, rhs); }
+        static uint64_t Mask(const Vector vector) 
+        {
+            return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vector), 4)), 0);
+        }
+    };
+
+#else
+
+    /** Scalar kernel, searching a single byte per block. */
+    struct Kernel
+    {
+        static constexpr size_t BlockSize = 1;
+        static constexpr size_t BitsPerByte = 8;
+        static constexpr uint64_t FullMask = 0xFF;
+        using Vector = uint8_t;
+
+        static Vector Load(const char* data) { return static_cast<uint8_t>(*data); }
+        static Vector Splat(const char character) { return static_cast<uint8_t>(character); }
+        static Vector Equal(const Vector lhs, const Vector rhs) { return lhs == rhs ? uint8_t{ 0xFF } : uint8_t{ 0 }; }
+        static Vector Or(const Vector lhs, const Vector rhs) { return static_cast<uint8_t>(lhs | rhs); }
+        static uint64_t Mask(const Vector vector) { return vector; }
+    };
+
+#endif
+
+    /** Finds first character of text, where provided block matcher returns a non-zero mask or scalar matcher returns true.
+     *  Full blocks are searched using the vector kernel, and remaining characters one by one.
+     */
+    template<typename TBlockMatcher, typename TScalarMatcher>
+    static size_t Find(
+        const std::string_view text,
+        TBlockMatcher&& blockMatcher,
+        TScalarMatcher&& scalarMatcher)
+    {
+        const auto* data = text.data();
+        const auto size = text.size();
+        size_t index = 0;
+
+        for(; index + Kernel::BlockSize <= size; index += Kernel::BlockSize)
+        {
+            if(const auto mask = blockMatcher(Kernel::Load(data + index)); mask != 0)
+            {
+                return index + (CountTrailingZeros(mask) / Kernel::BitsPerByte);
+            }
+        }
+
+        for(; index < size; index++)
+        {
+            if(scalarMatcher(data[index]))
+            {
+                return index;
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+
+    // Text scanner implementations.
+    const char* GetInstructionSet()
+    {
+#if defined(MOLTEN_TEXTSCANNER_AVX2)
+        return "AVX2";
+#elif defined(MOLTEN_TEXTSCANNER_SSE2)
+        return "SSE2";
+#elif defined(MOLTEN_TEXTSCANNER_NEON)
+        return "NEON";
+#else
+        return "Scalar";
+#endif
+    }
+
+    size_t FindCharacter(const std::string_view text, const char character)
+    {
+        return Find(text,
+            [&](const auto block) { return Kernel::Mask(Kernel::Equal(block, Kernel::Splat(character))); },
+            [&](const char value) { return value == character; });
+    }
+
+    size_t FindNewline(const std::string_view text)
+    {
+        return Find(text,
+            [](const auto block) 
+            { 
+                return Kernel::Mask(Kernel::Or(Kernel::Equal(block, Kernel::Splat('\n')), Kernel::Equal(block, Kernel::Splat('\r'))));
+            },
+            [](const char value) { return value == '\n' || value == '\r'; });
+    }
+
+    size_t FindWhitespace(const std::string_view text)
+    {
+        return Find(text,
+            [](const auto block)
+            {
+                return Kernel::Mask(Kernel::Or(Kernel::Equal(block, Kernel::Splat(' ')), Kernel::Equal(block, Kernel::Splat('\t'))));
+            },
+            [](const char value) { return IsWhitespace(value); });
+    }
+
+    size_t FindWhitespaceOr(const std::string_view text, const char separator)
+    {
+        return Find(text,
+            [&](const auto block)
+            {
+                const auto whitespace = Kernel::Or(Kernel::Equal(block, Kernel::Splat(' ')), Kernel::Equal(block, Kernel::Splat('\t')));
+                return Kernel::Mask(Kernel::Or(whitespace, Kernel::Equal(block, Kernel::Splat(separator))));
+            },
+            [&](const char value) { return IsWhitespace(value) || value == separator; });
+    }
+
+    size_t FindNonWhitespace(const std::string_view text)
+    {
+        return Find(text,
+            [](const auto block)
+            {
+                const auto whitespace = Kernel::Or(Kernel::Equal(block, Kernel::Splat(' ')), Kernel::Equal(block, Kernel::Splat('\t')));
+                return ~Kernel::Mask(whitespace) & Kernel::FullMask;
+            },
+            [](const char value) { return !IsWhitespace(value); });
+    }
+
+    void TrimWhitespaceFront(std::string_view& text)
+    {
+        // Leading whitespace is commonly short, so check first character before doing a full search.
+        if(text.empty() || !IsWhitespace(text.front()))
+        {
+            return;
+        }
+
+        const auto start = FindNonWhitespace(text);
+        text = start == std::string_view::npos ? std::string_view{ text.data() + text.size(), 0 } : text.substr(start);
+    }
+
+    std::string_view NextToken(std::string_view& text)
+    {
+        TrimWhitespaceFront(text);
+
+        const auto end = FindWhitespace(text);
+        if(end == std::string_view::npos)
+        {
+            const auto token = text;
+            text = std::string_view{ text.data() + text.size(), 0 };
+            return token;
+        }
+
+        const auto token = text.substr(0, end);
+        text = text.substr(end);
+        return token;
+    }
+
+    std::string_view StripComment(const std::string_view text, const char commentCharacter)
+    {
+        auto result = text.substr(0, FindCharacter(text, commentCharacter));
+        while(!result.empty() && IsWhitespace(result.back()))
+        {
+            result.remove_suffix(1);
+        }
+        return result;
+    }
+
+}
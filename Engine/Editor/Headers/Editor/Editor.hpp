@@ -34,6 +34,7 @@
 #include "Molten/System/Clock.hpp"
 #include "Molten/Utility/FpsTracker.hpp"
 #include "Molten/System/ThreadPool.hpp"
+#include "Molten/Asset/AssetManager.hpp"
 #include "Molten/Utility/FunctionDispatcher.hpp"
 #include "Molten/Utility/BufferCapacityPolicy.hpp"
 #include <optional>
@@ -100,6 +101,7 @@ namespace Molten::Editor
 
         bool ValidateFileDrops(const std::vector<std::filesystem::path>& files);
         bool ProcessFileDrops(const std::vector<std::filesystem::path>& files);
+        void UpdateLoadingMeshes();
 
         void OnSceneViewportResize(Gui::Viewport<Gui::EditorTheme>* viewport, const Vector2ui32 size);
         bool LoadSceneViewport();
@@ -153,6 +155,22 @@ namespace Molten::Editor
         FunctionDispatcher m_preUpdateCallbacks;
         FunctionDispatcher m_postUpdateCallbacks;
 
+        struct LoadingMesh
+        {
+            AssetManager::MeshHandle handle;
+            Clock clock;
+        };
+
+        struct LoadedMesh
+        {
+            AssetManager::MeshHandle handle;
+            uint32_t version; ///< Last logged version, for logging hot reloads.
+        };
+
+        AssetManager m_assetManager;
+        std::vector<LoadingMesh> m_loadingMeshes;
+        std::vector<LoadedMesh> m_meshes;
+
     };
 
 }
@@ -152,7 +152,9 @@ namespace Molten::Editor
         
         auto createDefaultLogger = [&]()
         {
-            return std::make_shared<Logger>(loggerSeverityFlags);
+            auto logger = std::make_shared<Logger>(loggerSeverityFlags);
+            logger->EnableAsync();
+            return logger;
         };
 
         auto createFileLogger = [&]() -> std::shared_ptr<FileLogger>
@@ -163,6 +165,7 @@ namespace Molten::Editor
                 return nullptr;
             }
 
+            fileLogger->EnableAsync();
             return fileLogger;
         };
 
@@ -173,8 +176,8 @@ namespace Molten::Editor
             {
                 m_logger = createDefaultLogger();
                 m_logger->Write(Logger::Severity::Error, "Failed to open log file \"" + *filename + "\"");
-                return;
             }
+            return;
         }
 
         m_logger = createDefaultLogger();    
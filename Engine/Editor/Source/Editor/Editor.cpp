@@ -36,8 +36,8 @@
 #include "Molten/Gui/Widgets/LabelWidget.hpp"
 #include "Molten/Gui/Widgets/ViewportWidget.hpp"
 #include "Molten/Gui/Widgets/MenuBarWidget.hpp"
+#include <algorithm>
 
-#include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
 
 namespace Molten::Editor
 {
@@ -52,8 +52,11 @@ namespace Molten::Editor
             BufferCapacityPolicy{ BufferCapacityScalarPolicy{ 100 } }
         },
         m_fpsTracker(8),
-        m_threadPool(0, 2, 0)
-    {}
+        m_threadPool(0, 2, 0),
+        m_assetManager(m_threadPool)
+    {
+        m_assetManager.SetHotReloadEnabled(true);
+    }
 
     Editor::~Editor()
     {
@@ -321,6 +324,9 @@ namespace Molten::Editor
     {
         m_preUpdateCallbacks.Dispatch();
 
+        m_assetManager.Update();
+        UpdateLoadingMeshes();
+
         if(!UpdateWindow())
         {
             return false;
@@ -438,41 +444,66 @@ namespace Molten::Editor
         const auto& file = files.front();
         Logger::WriteInfo(m_logger.get(), "Dropping obj file: " + file.string());
 
-        [[maybe_unused]] auto dummy = m_threadPool.Execute([&, filename = file]() {
-            ObjMeshFile objFile;
-            ObjMeshFileReader objFileReader;
+        m_loadingProgressBar->value = 0.0;
+        m_loadingMeshes.push_back({ m_assetManager.LoadMesh(file), Clock{} });
 
-            m_preUpdateCallbacks.Add([&]() {
-                m_loadingProgressBar->value = 0.0;
-            });
+        return true;
+    }
 
-            auto onProgressConnection = objFileReader.onProgress.Connect([&](const double progress) {
-                m_postUpdateCallbacks.Add([this, progress]() {
-                    m_loadingProgressBar->value = progress;
-                });
-            });
+    void Editor::UpdateLoadingMeshes()
+    {
+        // Progress bar shows the least progressed of all loading meshes.
+        if(!m_loadingMeshes.empty())
+        {
+            double progress = 1.0;
+            for(const auto& loadingMesh : m_loadingMeshes)
+            {
+                progress = std::min(progress, loadingMesh.handle.IsReady() ? 1.0 : loadingMesh.handle.GetProgress());
+            }
+            m_loadingProgressBar->value = progress;
+        }
 
-            const Clock clock;
-            const auto result = objFileReader.ReadFromFile(objFile, filename, m_threadPool);
-            const auto readTime = clock.GetTime();
+        for(auto it = m_loadingMeshes.begin(); it != m_loadingMeshes.end();)
+        {
+            auto& [handle, clock] = *it;
+            if(!handle.IsReady())
+            {
+                ++it;
+                continue;
+            }
 
-            onProgressConnection.Disconnect();
+            if(const auto* mesh = handle.Get(); mesh)
+            {
+                Logger::WriteInfo(m_logger.get(), "Read file in: " + std::to_string(clock.GetTime().AsSeconds<float>()) + "s.");
+                Logger::WriteInfo(m_logger.get(), "Objects: " + std::to_string(mesh->GetMeshes().size()));
+                Logger::WriteInfo(m_logger.get(), "Model successfully loaded!");
 
-            if (!result.IsSuccessful())
+                auto meshIt = std::find_if(m_meshes.begin(), m_meshes.end(), [&](const LoadedMesh& loadedMesh)
+                {
+                    return loadedMesh.handle == handle;
+                });
+                if(meshIt == m_meshes.end())
+                {
+                    const auto version = handle.GetVersion();
+                    m_meshes.push_back({ std::move(handle), version });
+                }
+            }
+            else
             {
-                Logger::WriteError(m_logger.get(), "Model loading failed:" + result.GetError().message);
-                return;
+                Logger::WriteError(m_logger.get(), "Model loading failed:" + handle.GetError());
             }
 
-            Logger::WriteInfo(m_logger.get(), "Read file in: " + std::to_string(readTime.AsSeconds<float>()) + "s.");
-            Logger::WriteInfo(m_logger.get(), "Objects: " + std::to_string(objFile.objects.size()));
-
-            m_postUpdateCallbacks.Add([&]() {
-                Logger::WriteInfo(m_logger.get(), "Model successfully loaded!");
-            });
-        });
+            it = m_loadingMeshes.erase(it);
+        }
 
-        return true;
+        for(auto& [handle, version] : m_meshes)
+        {
+            if(const auto newVersion = handle.GetVersion(); newVersion != version)
+            {
+                version = newVersion;
+                Logger::WriteInfo(m_logger.get(), "Model reloaded: " + handle.GetFilename().string());
+            }
+        }
     }
 
     void Editor::OnSceneViewportResize(Gui::Viewport<Gui::EditorTheme>* viewport, const Vector2ui32 size)
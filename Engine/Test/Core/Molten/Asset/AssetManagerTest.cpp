@@ -0,0 +1,445 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Asset/AssetManager.hpp"
+#include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Molten
+{
+
+    struct AssetManagerTestAsset
+    {
+        std::string content;
+    };
+
+    TEST(Asset, AssetManager_Deduplicate)
+    {
+        ThreadPool threadPool(2);
+        AssetManager assetManager(threadPool);
+
+        std::atomic_bool released = false;
+        std::atomic_size_t loadCount = 0;
+        assetManager.SetLoader<AssetManagerTestAsset>([&](const std::filesystem::path& filename, AssetLoadContext&)
+        {
+            ++loadCount;
+            while(!released)
+            {
+                std::this_thread::yield();
+            }
+            auto asset = std::make_shared<AssetManagerTestAsset>();
+            asset->content = filename.filename().string();
+            return AssetLoadResult<AssetManagerTestAsset>::CreateSuccess(std::move(asset));
+        });
+
+        auto first = assetManager.Load<AssetManagerTestAsset>("dir/asset.txt");
+        auto second = assetManager.Load<AssetManagerTestAsset>("dir/../dir/./asset.txt");
+        auto other = assetManager.Load<AssetManagerTestAsset>("dir/other.txt");
+        ASSERT_TRUE(first);
+        EXPECT_EQ(first, second);
+        EXPECT_NE(first, other);
+        EXPECT_EQ(first.GetFilename(), AssetManager::NormalizeFilename("dir/asset.txt"));
+        EXPECT_EQ(assetManager.GetAssetCount(), size_t{ 2 });
+        EXPECT_FALSE(first.IsReady());
+        EXPECT_EQ(first.Get(), nullptr);
+
+        released = true;
+        ASSERT_NE(second.Wait(), nullptr);
+        EXPECT_EQ(first.Get(), second.Get());
+        EXPECT_EQ(first.GetState(), AssetState::Loaded);
+        EXPECT_EQ(first.Get()->content, "asset.txt");
+        EXPECT_EQ(other.Wait()->content, "other.txt");
+
+        // Loads of loaded assets return handles of the same asset without loading again.
+        auto third = assetManager.Load<AssetManagerTestAsset>("dir/asset.txt");
+        EXPECT_TRUE(third.IsReady());
+        EXPECT_EQ(third.Get(), first.Get());
+
+        assetManager.WaitForLoads();
+        EXPECT_EQ(loadCount, size_t{ 2 });
+
+        // Concurrent loads from multiple threads.
+        std::vector<std::thread> threads;
+        std::vector<AssetHandle<AssetManagerTestAsset>> handles(8);
+        for(size_t i = 0; i < handles.size(); i++)
+        {
+            threads.emplace_back([&, i]()
+            {
+                handles[i] = assetManager.Load<AssetManagerTestAsset>("concurrent.txt");
+                handles[i].Wait();
+            });
+        }
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+        for(const auto& handle : handles)
+        {
+            EXPECT_EQ(handle, handles.front());
+            EXPECT_EQ(handle.Get()->content, "concurrent.txt");
+        }
+        EXPECT_EQ(loadCount, size_t{ 3 });
+    }
+
+    TEST(Asset, AssetManager_Release)
+    {
+        ThreadPool threadPool(2);
+        AssetManager assetManager(threadPool);
+
+        std::atomic_size_t loadCount = 0;
+        assetManager.SetLoader<AssetManagerTestAsset>([&](const std::filesystem::path&, AssetLoadContext&)
+        {
+            ++loadCount;
+            return AssetLoadResult<AssetManagerTestAsset>::CreateSuccess(std::make_shared<AssetManagerTestAsset>());
+        });
+
+        auto first = assetManager.Load<AssetManagerTestAsset>("asset.txt");
+        auto second = first;
+        ASSERT_NE(first.Wait(), nullptr);
+
+        std::weak_ptr<const AssetManagerTestAsset> weakAsset = first.GetShared();
+        first.Reset();
+        EXPECT_FALSE(first);
+        EXPECT_FALSE(weakAsset.expired());
+        EXPECT_EQ(assetManager.GetAssetCount(), size_t{ 1 });
+
+        second.Reset();
+        EXPECT_TRUE(weakAsset.expired());
+        EXPECT_EQ(assetManager.GetAssetCount(), size_t{ 0 });
+        assetManager.Update();
+
+        // Released assets are loaded again.
+        auto third = assetManager.Load<AssetManagerTestAsset>("asset.txt");
+        ASSERT_NE(third.Wait(), nullptr);
+        EXPECT_EQ(loadCount, size_t{ 2 });
+
+        // Queued loads of released assets are skipped.
+        for(size_t i = 0; i < 100; i++)
+        {
+            [[maybe_unused]] auto handle = assetManager.Load<AssetManagerTestAsset>("released" + std::to_string(i) + ".txt");
+        }
+        assetManager.WaitForLoads();
+        EXPECT_LE(loadCount, size_t{ 102 });
+        EXPECT_EQ(assetManager.GetQueuedLoadCount(), size_t{ 0 });
+        EXPECT_EQ(assetManager.GetAssetCount(), size_t{ 1 });
+    }
+
+    TEST(Asset, AssetManager_Failed)
+    {
+        ThreadPool threadPool(2);
+        AssetManager assetManager(threadPool);
+
+        assetManager.SetLoader<AssetManagerTestAsset>([&](const std::filesystem::path& filename, AssetLoadContext&) -> AssetLoadResult<AssetManagerTestAsset>
+        {
+            if(filename.filename() == "throw.txt")
+            {
+                throw std::runtime_error("Thrown");
+            }
+            return AssetLoadResult<AssetManagerTestAsset>::CreateError("Failed " + filename.filename().string());
+        });
+
+        auto failed = assetManager.Load<AssetManagerTestAsset>("failed.txt");
+        EXPECT_EQ(failed.Wait(), nullptr);
+        EXPECT_EQ(failed.GetState(), AssetState::Failed);
+        EXPECT_EQ(failed.GetError(), "Failed failed.txt");
+
+        auto thrown = assetManager.Load<AssetManagerTestAsset>("throw.txt");
+        EXPECT_EQ(thrown.Wait(), nullptr);
+        EXPECT_NE(thrown.GetError().find("Thrown"), std::string::npos);
+
+        auto noLoader = assetManager.Load<int>("int.txt");
+        EXPECT_EQ(noLoader.Wait(), nullptr);
+        EXPECT_FALSE(noLoader.GetError().empty());
+
+        auto missingMesh = assetManager.LoadMesh("AssetManagerTestMissing.obj");
+        EXPECT_EQ(missingMesh.Wait(), nullptr);
+        EXPECT_FALSE(missingMesh.GetError().empty());
+    }
+
+    TEST(Asset, AssetManager_DefaultLoaders)
+    {
+        const std::filesystem::path directory = "AssetManagerTestDirectory";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        {
+            std::ofstream file(directory / "triangle.obj", std::ofstream::binary);
+            file << "o Triangle\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        }
+        {
+            const std::vector<uint8_t> pixels(4 * 4 * 3, 20);
+            ASSERT_TRUE(Formats::Bmp::WriteToFile((directory / "gray.bmp").string(), pixels.data(), 4, 4, ImageFormat::URed8Green8Blue8));
+        }
+        {
+            std::ofstream file(directory / "font.ttf", std::ofstream::binary);
+            file.write("\x00\x01\x00\x00\x00\x00", 6);
+        }
+        {
+            const std::vector<uint32_t> words = { 0x07230203, 0x00010000, 0, 1, 0, 42 };
+            std::ofstream file(directory / "shader.spv", std::ofstream::binary);
+            file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+        }
+        {
+            std::ofstream file(directory / "invalid.spv", std::ofstream::binary);
+            file << "Not a shader";
+        }
+
+        {
+            ThreadPool threadPool(2);
+            AssetManager assetManager(threadPool);
+
+            auto mesh = assetManager.LoadMesh(directory / "triangle.obj");
+            auto texture = assetManager.LoadTexture(directory / "gray.bmp");
+            auto font = assetManager.LoadFont(directory / "font.ttf");
+            auto shader = assetManager.LoadShader(directory / "shader.spv");
+            auto invalidShader = assetManager.LoadShader(directory / "invalid.spv");
+            auto invalidFont = assetManager.LoadFont(directory / "gray.bmp");
+            assetManager.WaitForLoads();
+
+            ASSERT_TRUE(mesh.IsReady());
+            ASSERT_NE(mesh.Get(), nullptr);
+            ASSERT_EQ(mesh.Get()->GetMeshes().size(), size_t{ 1 });
+            EXPECT_EQ(mesh.Get()->GetMeshes()[0].name, "Triangle");
+
+            ASSERT_NE(texture.Get(), nullptr);
+            EXPECT_EQ(texture.Get()->GetDimensions(), (Vector2ui32{ 4, 4 }));
+            EXPECT_EQ(texture.Get()->GetFormat(), AssetManager::TextureFormat);
+            EXPECT_EQ(texture.Get()->GetData()[0], 20);
+
+            ASSERT_NE(font.Get(), nullptr);
+            EXPECT_EQ(font.Get()->file.GetSize(), size_t{ 6 });
+
+            ASSERT_NE(shader.Get(), nullptr);
+            ASSERT_EQ(shader.Get()->words.size(), size_t{ 6 });
+            EXPECT_EQ(shader.Get()->words[5], uint32_t{ 42 });
+
+            EXPECT_EQ(invalidShader.GetState(), AssetState::Failed);
+            EXPECT_EQ(invalidFont.GetState(), AssetState::Failed);
+
+            // Handles of the same file but different asset types are different assets.
+            EXPECT_EQ(assetManager.GetAssetCount(), size_t{ 6 });
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST(Asset, AssetManager_Progress)
+    {
+        ThreadPool threadPool(2);
+        AssetManager assetManager(threadPool);
+
+        std::atomic_bool released = false;
+        assetManager.SetLoader<AssetManagerTestAsset>([&](const std::filesystem::path&, AssetLoadContext& context)
+        {
+            context.SetProgress(0.5);
+            while(!released)
+            {
+                std::this_thread::yield();
+            }
+            return AssetLoadResult<AssetManagerTestAsset>::CreateSuccess(std::make_shared<AssetManagerTestAsset>());
+        });
+
+        auto handle = assetManager.Load<AssetManagerTestAsset>("progress.txt");
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(handle.GetProgress() < 0.5 && std::chrono::steady_clock::now() < timeout)
+        {
+            assetManager.Update();
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(handle.GetProgress(), 0.5);
+        EXPECT_FALSE(handle.IsReady());
+
+        released = true;
+        ASSERT_NE(handle.Wait(), nullptr);
+        EXPECT_EQ(handle.GetProgress(), 1.0);
+    }
+
+    TEST(Asset, AssetManager_MeshImportWorkers)
+    {
+        const std::filesystem::path directory = "AssetManagerMeshTestDirectory";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        const size_t fileCount = 4;
+        const size_t objectCount = 16;
+        {
+            std::ofstream file(directory / "material.mtl", std::ofstream::binary);
+            file << "newmtl Gray\nKd 0.5 0.5 0.5\n";
+        }
+        for(size_t i = 0; i < fileCount; i++)
+        {
+            std::ofstream file(directory / ("mesh" + std::to_string(i) + ".obj"), std::ofstream::binary);
+            file << "mtllib material.mtl\n";
+            for(size_t j = 0; j < objectCount; j++)
+            {
+                const auto index = j * 3;
+                file << "o Object" << j << "\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl Gray\n";
+                file << "f " << index + 1 << " " << index + 2 << " " << index + 3 << "\n";
+            }
+        }
+
+        {
+            // Mesh imports hand work to free workers of the same pool, and must not wait for workers busy with other imports.
+            ThreadPool threadPool(3);
+            AssetManager assetManager(threadPool);
+
+            std::vector<AssetManager::MeshHandle> meshes;
+            for(size_t i = 0; i < fileCount; i++)
+            {
+                meshes.push_back(assetManager.LoadMesh(directory / ("mesh" + std::to_string(i) + ".obj")));
+            }
+            assetManager.WaitForLoads();
+
+            for(const auto& mesh : meshes)
+            {
+                ASSERT_NE(mesh.Get(), nullptr) << mesh.GetError();
+                EXPECT_EQ(mesh.Get()->GetMeshes().size(), objectCount);
+                EXPECT_EQ(mesh.GetProgress(), 1.0);
+            }
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+
+    TEST(Asset, AssetManager_HotReload)
+    {
+        const std::filesystem::path directory = "AssetManagerTestHotReloadDirectory";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        const auto writeFile = [](const std::filesystem::path& filename, const std::string& content)
+        {
+            std::ofstream file(filename, std::ofstream::binary);
+            file << content;
+        };
+        const auto readFile = [](const std::filesystem::path& filename)
+        {
+            std::ifstream file(filename, std::ifstream::binary);
+            std::stringstream stream;
+            stream << file.rdbuf();
+            return stream.str();
+        };
+
+        writeFile(directory / "asset.txt", "first");
+        writeFile(directory / "material.txt", "A");
+        writeFile(directory / "triangle.obj", "mtllib triangle.mtl\no Triangle\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl Red\nf 1 2 3\n");
+        writeFile(directory / "triangle.mtl", "newmtl Red\nKd 1 0 0\n");
+
+        {
+            ThreadPool threadPool(2);
+            AssetManager assetManager(threadPool);
+            ASSERT_TRUE(assetManager.SetHotReloadEnabled(true));
+            EXPECT_TRUE(assetManager.IsHotReloadEnabled());
+
+            assetManager.SetLoader<AssetManagerTestAsset>([&](const std::filesystem::path& filename, AssetLoadContext& context)
+                -> AssetLoadResult<AssetManagerTestAsset>
+            {
+                const auto materialFilename = filename.parent_path() / "material.txt";
+                context.AddDependency(materialFilename);
+
+                auto content = readFile(filename);
+                if(content == "fail")
+                {
+                    return AssetLoadResult<AssetManagerTestAsset>::CreateError("Failed");
+                }
+
+                auto asset = std::make_shared<AssetManagerTestAsset>();
+                asset->content = content + readFile(materialFilename);
+                return AssetLoadResult<AssetManagerTestAsset>::CreateSuccess(std::move(asset));
+            });
+
+            const auto updateUntil = [&](auto condition)
+            {
+                const auto endTime = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                while(!condition() && std::chrono::steady_clock::now() < endTime)
+                {
+                    assetManager.Update();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                return condition();
+            };
+
+            auto asset = assetManager.Load<AssetManagerTestAsset>(directory / "asset.txt");
+            auto mesh = assetManager.LoadMesh(directory / "triangle.obj");
+            ASSERT_NE(asset.Wait(), nullptr);
+            ASSERT_NE(mesh.Wait(), nullptr);
+            EXPECT_EQ(asset.Get()->content, "firstA");
+            EXPECT_EQ(asset.GetVersion(), uint32_t{ 0 });
+            assetManager.Update();
+
+            // Reloaded assets are swapped in by Update, while shared pointers keep previous assets alive.
+            const auto previousAsset = asset.GetShared();
+            writeFile(directory / "asset.txt", "second");
+            ASSERT_TRUE(updateUntil([&]() { return asset.GetVersion() == 1; }));
+            EXPECT_EQ(asset.Get()->content, "secondA");
+            EXPECT_EQ(previousAsset->content, "firstA");
+
+            // Modified dependencies reload dependent assets.
+            writeFile(directory / "material.txt", "B");
+            ASSERT_TRUE(updateUntil([&]() { return asset.GetVersion() == 2; }));
+            EXPECT_EQ(asset.Get()->content, "secondB");
+
+            writeFile(directory / "triangle.mtl", "newmtl Red\nKd 0 1 0\n");
+            ASSERT_TRUE(updateUntil([&]() { return mesh.GetVersion() == 1; }));
+            ASSERT_NE(mesh.Get(), nullptr);
+            EXPECT_EQ(mesh.Get()->GetMeshes().size(), size_t{ 1 });
+
+            // Failed reloads keep current asset.
+            writeFile(directory / "asset.txt", "fail");
+            ASSERT_TRUE(updateUntil([&]() { return !asset.GetError().empty(); }));
+            EXPECT_EQ(asset.GetState(), AssetState::Loaded);
+            EXPECT_EQ(asset.GetVersion(), uint32_t{ 2 });
+            EXPECT_EQ(asset.Get()->content, "secondB");
+
+            writeFile(directory / "asset.txt", "third");
+            ASSERT_TRUE(updateUntil([&]() { return asset.GetVersion() == 3; }));
+            EXPECT_EQ(asset.Get()->content, "thirdB");
+            EXPECT_TRUE(asset.GetError().empty());
+
+            // Released assets are not reloaded.
+            asset.Reset();
+            mesh.Reset();
+            assetManager.Update();
+            writeFile(directory / "asset.txt", "fourth");
+            assetManager.Update();
+            EXPECT_EQ(assetManager.GetQueuedLoadCount(), size_t{ 0 });
+
+            EXPECT_TRUE(assetManager.SetHotReloadEnabled(false));
+            EXPECT_FALSE(assetManager.IsHotReloadEnabled());
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+#endif
+
+}
@@ -0,0 +1,268 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Archive/PakArchive.hpp"
+#include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include "Molten/FileFormat/Image/ImageCache.hpp"
+#include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include <fstream>
+
+namespace Molten
+{
+
+    static std::vector<uint8_t> CreatePakArchiveTestData(const std::string& content)
+    {
+        return { content.begin(), content.end() };
+    }
+
+    TEST(FileFormat, PakArchive_ReadWrite)
+    {
+        const std::filesystem::path filename = "PakArchiveTest.pak";
+
+        PakArchiveWriter writer(64);
+        EXPECT_TRUE(writer.AddFile("a.txt", CreatePakArchiveTestData("File a")));
+        EXPECT_TRUE(writer.AddFile("/dir\\b.txt", CreatePakArchiveTestData("File b")));
+        EXPECT_TRUE(writer.AddFile("dir/sub/c.txt", CreatePakArchiveTestData("File c")));
+        EXPECT_TRUE(writer.AddFile("dir/empty.txt", {}));
+        EXPECT_FALSE(writer.AddFile("dir/./b.txt", CreatePakArchiveTestData("Duplicate")));
+        EXPECT_FALSE(writer.AddFile("", CreatePakArchiveTestData("No path")));
+        for(size_t i = 0; i < 500; i++)
+        {
+            EXPECT_TRUE(writer.AddFile("many/" + std::to_string(i) + ".txt", CreatePakArchiveTestData(std::to_string(i * 7))));
+        }
+        EXPECT_EQ(writer.GetFileCount(), size_t{ 504 });
+        ASSERT_TRUE(writer.WriteToFile(filename));
+
+        auto archive = PakArchive::OpenFromFile(filename);
+        ASSERT_TRUE(archive);
+        ASSERT_EQ(archive->GetFileCount(), size_t{ 504 });
+        EXPECT_EQ(archive->GetFilePath(1), "dir/b.txt");
+        EXPECT_EQ(archive->GetFilePath(504), "");
+
+        auto fileA = archive->Open("a.txt");
+        ASSERT_TRUE(fileA);
+        EXPECT_EQ(fileA->GetView(), "File a");
+        EXPECT_EQ(fileA->GetMappedFile(), archive->Open("dir/b.txt")->GetMappedFile());
+
+        for(const auto* path : { "a.txt", "dir/b.txt", "dir/sub/c.txt", "dir/empty.txt" })
+        {
+            const auto file = archive->Open(path);
+            ASSERT_TRUE(file) << path;
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(file->GetData()) % 64, uintptr_t{ 0 }) << path;
+        }
+        for(size_t i = 0; i < 500; i++)
+        {
+            const auto file = archive->Open("many/" + std::to_string(i) + ".txt");
+            ASSERT_TRUE(file) << i;
+            EXPECT_EQ(file->GetView(), std::to_string(i * 7));
+        }
+
+        EXPECT_EQ(archive->Open("dir/empty.txt")->GetSize(), size_t{ 0 });
+        EXPECT_FALSE(archive->Open("dir"));
+        EXPECT_FALSE(archive->Open("missing.txt"));
+        EXPECT_FALSE(archive->Open("many/500.txt"));
+        EXPECT_TRUE(archive->Exists("dir/sub/c.txt"));
+        EXPECT_FALSE(archive->Exists("dir/sub/d.txt"));
+
+        std::vector<std::string> names;
+        EXPECT_TRUE(archive->ListDirectory("dir", names));
+        EXPECT_EQ(names, (std::vector<std::string>{ "b.txt", "empty.txt" }));
+        names.clear();
+        EXPECT_TRUE(archive->ListDirectory("", names));
+        EXPECT_EQ(names, (std::vector<std::string>{ "a.txt" }));
+        EXPECT_FALSE(archive->ListDirectory("di", names));
+
+        // Opened files outlive the archive.
+        archive.reset();
+        EXPECT_EQ(fileA->GetView(), "File a");
+        fileA.reset();
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, PakArchive_Lz4)
+    {
+        const std::filesystem::path filename = "PakArchiveTestLz4.pak";
+
+        std::string repeated;
+        for(size_t i = 0; i < 1000; i++)
+        {
+            repeated += "v " + std::to_string(i % 10) + ".0 1.0 2.0\n";
+        }
+        std::string random(4096, '\0');
+        uint32_t seed = 12345;
+        for(auto& c : random)
+        {
+            seed = seed * 1664525 + 1013904223;
+            c = static_cast<char>(seed >> 24);
+        }
+
+        PakArchiveWriter writer;
+        EXPECT_TRUE(writer.AddFile("repeated.obj", CreatePakArchiveTestData(repeated), PakCompression::Lz4));
+        EXPECT_TRUE(writer.AddFile("random.bin", CreatePakArchiveTestData(random), PakCompression::Lz4));
+        EXPECT_TRUE(writer.AddFile("empty.txt", {}, PakCompression::Lz4));
+        EXPECT_TRUE(writer.AddFile("stored.txt", CreatePakArchiveTestData(repeated), PakCompression::None));
+        ASSERT_TRUE(writer.WriteToFile(filename));
+
+        auto archive = PakArchive::OpenFromFile(filename);
+        ASSERT_TRUE(archive);
+        EXPECT_LT(std::filesystem::file_size(filename), repeated.size() + random.size() + repeated.size() / 4);
+
+        auto repeatedFile = archive->Open("repeated.obj");
+        ASSERT_TRUE(repeatedFile);
+        EXPECT_EQ(repeatedFile->GetView(), repeated);
+        EXPECT_FALSE(repeatedFile->GetMappedFile());
+
+        // Incompressible entries are stored as is and served from the mapping.
+        const auto randomFile = archive->Open("random.bin");
+        ASSERT_TRUE(randomFile);
+        EXPECT_EQ(randomFile->GetView(), random);
+        EXPECT_TRUE(randomFile->GetMappedFile());
+
+        ASSERT_TRUE(archive->Open("empty.txt"));
+        EXPECT_EQ(archive->Open("empty.txt")->GetSize(), size_t{ 0 });
+        EXPECT_EQ(archive->Open("stored.txt")->GetView(), repeated);
+
+        archive.reset();
+        EXPECT_EQ(repeatedFile->GetView(), repeated);
+        repeatedFile.reset();
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, PakArchive_Invalid)
+    {
+        const std::filesystem::path filename = "PakArchiveTestInvalid.pak";
+
+        EXPECT_FALSE(PakArchive::OpenFromFile("ThisFileDoesNotExist.pak"));
+
+        PakArchiveWriter writer;
+        EXPECT_TRUE(writer.AddFile("a.txt", CreatePakArchiveTestData("File a")));
+        ASSERT_TRUE(writer.WriteToFile(filename));
+        EXPECT_TRUE(PakArchive::OpenFromFile(filename));
+
+        const auto fileSize = std::filesystem::file_size(filename);
+        std::vector<char> data(fileSize);
+        {
+            std::ifstream file(filename, std::ifstream::binary);
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        auto writeData = [&](const std::vector<char>& newData)
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+            file.write(newData.data(), static_cast<std::streamsize>(newData.size()));
+        };
+
+        // Truncated archive.
+        writeData({ data.begin(), data.begin() + static_cast<std::ptrdiff_t>(data.size() / 2) });
+        EXPECT_FALSE(PakArchive::OpenFromFile(filename));
+
+        // Invalid magic.
+        auto invalidData = data;
+        invalidData[0] = 'X';
+        writeData(invalidData);
+        EXPECT_FALSE(PakArchive::OpenFromFile(filename));
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, PakArchive_VirtualFileSystem)
+    {
+        const std::filesystem::path directory = "PakArchiveTestDirectory";
+        const std::filesystem::path filename = "PakArchiveTestAssets.pak";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory / "meshes");
+        std::filesystem::create_directories(directory / "materials");
+        std::filesystem::create_directories(directory / "textures");
+        {
+            std::ofstream file(directory / "meshes" / "triangle.obj", std::ofstream::binary);
+            file << "mtllib ../materials/red.mtl\no Triangle\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl Red\nf 1 2 3\n";
+        }
+        {
+            std::ofstream file(directory / "materials" / "red.mtl", std::ofstream::binary);
+            file << "newmtl Red\nKd 1.0 0.0 0.0\n";
+        }
+        const std::vector<uint8_t> pixels(4 * 4 * 3, 20);
+        ASSERT_TRUE(Formats::Bmp::WriteToFile((directory / "textures" / "gray.bmp").string(), pixels.data(), 4, 4, ImageFormat::URed8Green8Blue8));
+
+        PakArchiveWriter writer;
+        ASSERT_TRUE(writer.AddDirectory(directory, "assets"));
+        EXPECT_FALSE(writer.AddDirectory(directory / "missing"));
+        EXPECT_EQ(writer.GetFileCount(), size_t{ 3 });
+        ASSERT_TRUE(writer.WriteToFile(filename));
+        std::filesystem::remove_all(directory);
+
+        auto fileSystem = std::make_shared<VirtualFileSystem>();
+        auto archive = PakArchive::OpenFromFile(filename);
+        ASSERT_TRUE(archive);
+        fileSystem->Mount(archive, "data");
+
+        const auto names = fileSystem->ListDirectory("data/assets/meshes");
+        ASSERT_TRUE(names);
+        EXPECT_EQ(*names, std::vector<std::string>{ "triangle.obj" });
+
+        // Obj and material files are read from the archive.
+        ObjMeshFileReader reader;
+        reader.SetVirtualFileSystem(fileSystem);
+        EXPECT_EQ(reader.GetVirtualFileSystem(), fileSystem);
+
+        ObjMeshFile objFile;
+        ASSERT_TRUE(reader.ReadFromFile(objFile, "data/assets/meshes/triangle.obj"));
+        ASSERT_EQ(objFile.objects.size(), size_t{ 1 });
+        EXPECT_EQ(objFile.objects[0]->name, "Triangle");
+        EXPECT_EQ(objFile.objects[0]->vertices.size(), size_t{ 3 });
+        ASSERT_EQ(objFile.materials.size(), size_t{ 1 });
+        EXPECT_EQ(objFile.materials[0]->name, "Red");
+
+        ThreadPool threadPool;
+        ObjMeshFile parallelObjFile;
+        ASSERT_TRUE(reader.ReadFromFile(parallelObjFile, "data/assets/meshes/triangle.obj", threadPool));
+        ASSERT_EQ(parallelObjFile.materials.size(), size_t{ 1 });
+
+        EXPECT_FALSE(reader.ReadFromFile(objFile, "data/assets/meshes/missing.obj"));
+
+        // Images are decoded directly from the archive.
+        ImageCache imageCache;
+        for(size_t i = 0; i < 2; i++)
+        {
+            auto result = imageCache.Load(*fileSystem, "data/assets/textures/gray.bmp");
+            ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result));
+            EXPECT_EQ(std::get<ImageSharedPointer>(result)->GetData()[0], 20);
+        }
+        EXPECT_EQ(imageCache.GetDecodeCount(), size_t{ 1 });
+        EXPECT_TRUE(std::holds_alternative<std::string>(imageCache.Load(*fileSystem, "data/assets/textures/missing.bmp")));
+
+        auto registryResult = ImageLoaderRegistry::GetDefault()->LoadFromFile(*fileSystem, "data/assets/textures/gray.bmp", ImageFormat::URed8Green8Blue8Alpha8);
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(registryResult));
+
+        fileSystem->UnmountAll();
+        archive.reset();
+        std::filesystem::remove(filename);
+    }
+
+}
@@ -0,0 +1,252 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/BlockCompressor.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace Molten
+{
+
+    static std::vector<uint8_t> CreateBlockCompressorTestImage(const uint32_t width, const uint32_t height)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+        for(uint32_t y = 0; y < height; y++)
+        {
+            for(uint32_t x = 0; x < width; x++)
+            {
+                auto* pixel = pixels.data() + (static_cast<size_t>(y) * width + x) * 4;
+                pixel[0] = static_cast<uint8_t>(x * 255 / (width - 1));
+                pixel[1] = static_cast<uint8_t>(y * 255 / (height - 1));
+                pixel[2] = static_cast<uint8_t>(128 + 100 * std::sin(static_cast<double>(x + y) * 0.2));
+                pixel[3] = static_cast<uint8_t>(255 - (x + y));
+            }
+        }
+        return pixels;
+    }
+
+    static double CalculateBlockCompressorError(
+        const std::vector<uint8_t>& pixels,
+        const std::vector<uint8_t>& decompressed,
+        const size_t firstChannel,
+        const size_t channelCount)
+    {
+        double error = 0.0;
+        for(size_t i = 0; i < pixels.size(); i += 4)
+        {
+            for(size_t channel = firstChannel; channel < firstChannel + channelCount; channel++)
+            {
+                const auto difference = static_cast<double>(pixels[i + channel]) - static_cast<double>(decompressed[i + channel]);
+                error += difference * difference;
+            }
+        }
+        return std::sqrt(error / static_cast<double>(pixels.size() / 4 * channelCount));
+    }
+
+    TEST(FileFormat, BlockCompressor_DataSize)
+    {
+        EXPECT_FALSE(IsBlockCompressedImageFormat(ImageFormat::URed8Green8Blue8Alpha8));
+        EXPECT_TRUE(IsBlockCompressedImageFormat(ImageFormat::SrgbBc7Rgba));
+        EXPECT_EQ(GetImageFormatBlockSize(ImageFormat::URed8Green8Blue8), size_t{ 3 });
+        EXPECT_EQ(GetImageFormatBlockSize(ImageFormat::UBc1Rgba), size_t{ 8 });
+        EXPECT_EQ(GetImageFormatBlockSize(ImageFormat::UBc5RedGreen), size_t{ 16 });
+        EXPECT_EQ(CalculateImageDataSize(ImageFormat::URed8Green8, 5, 3), size_t{ 30 });
+        EXPECT_EQ(CalculateImageDataSize(ImageFormat::UBc1Rgba, 5, 3), size_t{ 2 * 8 });
+        EXPECT_EQ(CalculateImageDataSize(ImageFormat::UBc7Rgba, 64, 64), size_t{ 16 * 16 * 16 });
+        EXPECT_EQ(CalculateImageDataSize(ImageFormat::UBc4Red, 1, 1, 2), size_t{ 16 });
+
+        const std::vector<uint8_t> pixels(5 * 3 * 4, 0);
+        EXPECT_FALSE(BlockCompressor::Compress(pixels.data(), { 5, 3 }, ImageFormat::URed8Green8Blue8Alpha8, ImageFormat::URed8).has_value());
+        EXPECT_FALSE(BlockCompressor::Compress(pixels.data(), { 5, 3 }, ImageFormat::SRed8, ImageFormat::UBc1Rgba).has_value());
+        EXPECT_FALSE(BlockCompressor::Compress(pixels.data(), { 0, 3 }, ImageFormat::URed8Green8Blue8Alpha8, ImageFormat::UBc1Rgba).has_value());
+        EXPECT_FALSE(BlockCompressor::Decompress(pixels.data(), { 4, 4 }, ImageFormat::URed8).has_value());
+
+        const auto blocks = BlockCompressor::Compress(pixels.data(), { 5, 3 }, ImageFormat::URed8Green8Blue8Alpha8, ImageFormat::UBc3Rgba);
+        ASSERT_TRUE(blocks.has_value());
+        EXPECT_EQ(blocks->size(), size_t{ 2 * 16 });
+    }
+
+    TEST(FileFormat, BlockCompressor_SolidColor)
+    {
+        std::vector<uint8_t> pixels(6 * 5 * 4);
+        for(size_t i = 0; i < pixels.size(); i += 4)
+        {
+            pixels[i + 0] = 200;
+            pixels[i + 1] = 100;
+            pixels[i + 2] = 50;
+            pixels[i + 3] = 180;
+        }
+
+        for(const auto format : {
+            ImageFormat::UBc1Rgba, ImageFormat::UBc3Rgba, ImageFormat::UBc4Red, ImageFormat::UBc5RedGreen, ImageFormat::UBc7Rgba })
+        {
+            for(const auto quality : { BlockCompressor::Quality::Fast, BlockCompressor::Quality::High })
+            {
+                const auto blocks = BlockCompressor::Compress(pixels.data(), { 6, 5 }, ImageFormat::URed8Green8Blue8Alpha8, format, quality);
+                ASSERT_TRUE(blocks.has_value());
+                const auto decompressed = BlockCompressor::Decompress(blocks->data(), { 6, 5 }, format);
+                ASSERT_TRUE(decompressed.has_value());
+                ASSERT_EQ(decompressed->size(), pixels.size());
+
+                for(size_t i = 0; i < decompressed->size(); i += 4)
+                {
+                    const auto* pixel = decompressed->data() + i;
+                    EXPECT_NEAR(pixel[0], 200, 4);
+                    if(format == ImageFormat::UBc4Red)
+                    {
+                        EXPECT_EQ(pixel[1], 0);
+                        EXPECT_EQ(pixel[3], 255);
+                        continue;
+                    }
+                    EXPECT_NEAR(pixel[1], 100, 4);
+                    if(format == ImageFormat::UBc5RedGreen)
+                    {
+                        EXPECT_EQ(pixel[2], 0);
+                        continue;
+                    }
+                    EXPECT_NEAR(pixel[2], 50, 4);
+                    if(format == ImageFormat::UBc1Rgba)
+                    {
+                        EXPECT_EQ(pixel[3], 255);
+                        continue;
+                    }
+                    EXPECT_NEAR(pixel[3], 180, 1);
+                }
+            }
+        }
+    }
+
+    TEST(FileFormat, BlockCompressor_Quality)
+    {
+        const auto pixels = CreateBlockCompressorTestImage(64, 64);
+
+        struct Expectation
+        {
+            ImageFormat format;
+            size_t firstChannel;
+            size_t channelCount;
+            double maxError;
+        };
+        const Expectation expectations[] = {
+            { ImageFormat::UBc1Rgba, 0, 3, 6.0 },
+            { ImageFormat::UBc3Rgba, 0, 4, 6.0 },
+            { ImageFormat::UBc4Red, 0, 1, 2.0 },
+            { ImageFormat::UBc5RedGreen, 0, 2, 2.0 },
+            { ImageFormat::UBc7Rgba, 0, 4, 4.0 }
+        };
+
+        for(const auto& expectation : expectations)
+        {
+            double errors[2];
+            for(const auto quality : { BlockCompressor::Quality::Fast, BlockCompressor::Quality::High })
+            {
+                const auto blocks = BlockCompressor::Compress(pixels.data(), { 64, 64 }, ImageFormat::URed8Green8Blue8Alpha8, expectation.format, quality);
+                ASSERT_TRUE(blocks.has_value());
+                const auto decompressed = BlockCompressor::Decompress(blocks->data(), { 64, 64 }, expectation.format);
+                ASSERT_TRUE(decompressed.has_value());
+                errors[static_cast<size_t>(quality)] = CalculateBlockCompressorError(
+                    pixels, *decompressed, expectation.firstChannel, expectation.channelCount);
+            }
+
+            EXPECT_LT(errors[1], expectation.maxError) << static_cast<int>(expectation.format);
+            EXPECT_LE(errors[1], errors[0] + 0.01) << static_cast<int>(expectation.format);
+        }
+    }
+
+    TEST(FileFormat, BlockCompressor_Bc1Transparency)
+    {
+        std::vector<uint8_t> pixels(4 * 4 * 3);
+        for(size_t i = 0; i < 16; i++)
+        {
+            pixels[i * 3 + 0] = static_cast<uint8_t>(i * 16);
+            pixels[i * 3 + 1] = 50;
+            pixels[i * 3 + 2] = 255;
+        }
+
+        // Sources without alpha are opaque.
+        const auto opaqueBlocks = BlockCompressor::Compress(pixels.data(), { 4, 4 }, ImageFormat::UBlue8Green8Red8, ImageFormat::UBc1Rgba);
+        ASSERT_TRUE(opaqueBlocks.has_value());
+        const auto opaque = BlockCompressor::Decompress(opaqueBlocks->data(), { 4, 4 }, ImageFormat::UBc1Rgba);
+        ASSERT_TRUE(opaque.has_value());
+        for(size_t i = 0; i < 16; i++)
+        {
+            EXPECT_EQ((*opaque)[i * 4 + 0], 255);
+            EXPECT_NEAR((*opaque)[i * 4 + 2], static_cast<int>(i * 16), 40);
+            EXPECT_EQ((*opaque)[i * 4 + 3], 255);
+        }
+
+        std::vector<uint8_t> transparentPixels(4 * 4 * 4);
+        for(size_t i = 0; i < 16; i++)
+        {
+            transparentPixels[i * 4 + 0] = 255;
+            transparentPixels[i * 4 + 1] = static_cast<uint8_t>(i * 16);
+            transparentPixels[i * 4 + 3] = i % 3 == 0 ? 0 : 255;
+        }
+        const auto transparentBlocks = BlockCompressor::Compress(transparentPixels.data(), { 4, 4 }, ImageFormat::URed8Green8Blue8Alpha8, ImageFormat::UBc1Rgba);
+        ASSERT_TRUE(transparentBlocks.has_value());
+        const auto transparent = BlockCompressor::Decompress(transparentBlocks->data(), { 4, 4 }, ImageFormat::UBc1Rgba);
+        ASSERT_TRUE(transparent.has_value());
+        for(size_t i = 0; i < 16; i++)
+        {
+            EXPECT_EQ((*transparent)[i * 4 + 3], i % 3 == 0 ? 0 : 255);
+            if(i % 3 != 0)
+            {
+                EXPECT_NEAR((*transparent)[i * 4 + 0], 255, 4);
+                EXPECT_NEAR((*transparent)[i * 4 + 1], static_cast<int>(i * 16), 40);
+            }
+        }
+    }
+
+    TEST(FileFormat, BlockCompressor_MipChain)
+    {
+        const auto pixels = CreateBlockCompressorTestImage(37, 21);
+        const auto mipChain = MipmapGenerator::Generate(pixels.data(), { 37, 21 }, ImageFormat::SrgbRed8Green8Blue8Alpha8);
+        ASSERT_TRUE(mipChain.has_value());
+
+        ThreadPool threadPool(4);
+        const auto serial = BlockCompressor::Compress(*mipChain, ImageFormat::SrgbBc7Rgba);
+        const auto parallel = BlockCompressor::Compress(*mipChain, ImageFormat::SrgbBc7Rgba, BlockCompressor::Quality::High, &threadPool);
+        ASSERT_TRUE(serial.has_value());
+        ASSERT_TRUE(parallel.has_value());
+        ASSERT_EQ(serial->GetLevelCount(), mipChain->GetLevelCount());
+        ASSERT_EQ(serial->GetDataSize(), parallel->GetDataSize());
+        EXPECT_EQ(std::memcmp(serial->GetData(), parallel->GetData(), serial->GetDataSize()), 0);
+
+        EXPECT_EQ(serial->GetFormat(), ImageFormat::SrgbBc7Rgba);
+        EXPECT_EQ(serial->GetLevelSize(0), size_t{ 10 * 6 * 16 });
+        EXPECT_EQ(serial->GetLevelSize(1), size_t{ 5 * 3 * 16 });
+        EXPECT_EQ(serial->GetLevelSize(serial->GetLevelCount() - 1), size_t{ 16 });
+
+        const auto descriptor = serial->CreateTextureDescriptor();
+        EXPECT_EQ(descriptor.format, ImageFormat::SrgbBc7Rgba);
+        EXPECT_EQ(descriptor.mipLevelCount, mipChain->GetLevelCount());
+
+        EXPECT_FALSE(BlockCompressor::Compress(*serial, ImageFormat::UBc1Rgba).has_value());
+    }
+
+}
@@ -0,0 +1,298 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include <sstream>
+
+namespace Molten
+{
+
+    static std::vector<uint8_t> CreateBmpTestPixels(const uint32_t width, const uint32_t height, const size_t channelCount)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * channelCount);
+        for(size_t i = 0; i < pixels.size(); i++)
+        {
+            pixels[i] = static_cast<uint8_t>((i * 7 + i / 5) & 0xFF);
+        }
+        return pixels;
+    }
+
+    /** Creates BMP bytes with a 40 byte info header, optional masks and palette, followed by provided rows in file order. */
+    static std::vector<uint8_t> CreateBmpTestBytes(
+        const int32_t width,
+        const int32_t height,
+        const uint16_t bitsPerPixel,
+        const Formats::Bmp::Compression compression,
+        const std::vector<uint32_t>& masks,
+        const std::vector<uint32_t>& palette,
+        const std::vector<uint8_t>& pixelData)
+    {
+        std::vector<uint8_t> bytes;
+        auto write16 = [&](const uint32_t value)
+        {
+            bytes.push_back(static_cast<uint8_t>(value));
+            bytes.push_back(static_cast<uint8_t>(value >> 8));
+        };
+        auto write32 = [&](const uint32_t value)
+        {
+            write16(value & 0xFFFF);
+            write16(value >> 16);
+        };
+
+        const auto dataOffset = static_cast<uint32_t>(14 + 40 + masks.size() * 4 + palette.size() * 4);
+        write16(0x4D42);
+        write32(dataOffset + static_cast<uint32_t>(pixelData.size()));
+        write32(0);
+        write32(dataOffset);
+
+        write32(40);
+        write32(static_cast<uint32_t>(width));
+        write32(static_cast<uint32_t>(height));
+        write16(1);
+        write16(bitsPerPixel);
+        write32(static_cast<uint32_t>(compression));
+        write32(static_cast<uint32_t>(pixelData.size()));
+        write32(0);
+        write32(0);
+        write32(static_cast<uint32_t>(palette.size()));
+        write32(0);
+
+        for(const auto mask : masks)
+        {
+            write32(mask);
+        }
+        for(const auto color : palette)
+        {
+            write32(color);
+        }
+        bytes.insert(bytes.end(), pixelData.begin(), pixelData.end());
+        return bytes;
+    }
+
+    TEST(FileFormat, BmpFormat_RoundTrip)
+    {
+        // Odd widths exercise row padding and the scalar tails of vectorized conversions.
+        for(const uint32_t width : { 1, 3, 8, 17, 37 })
+        {
+            const uint32_t height = 5;
+
+            for(const auto format : { ImageFormat::URed8Green8Blue8, ImageFormat::UBlue8Green8Red8, ImageFormat::URed8Green8Blue8Alpha8, ImageFormat::UBlue8Green8Red8Alpha8, ImageFormat::URed8 })
+            {
+                const size_t channelCount = format == ImageFormat::URed8 ? 1 : 
+                    ((format == ImageFormat::URed8Green8Blue8 || format == ImageFormat::UBlue8Green8Red8) ? 3 : 4);
+                const auto pixels = CreateBmpTestPixels(width, height, channelCount);
+
+                const auto bytes = Formats::Bmp::WriteToBytes(pixels.data(), width, height, format);
+                ASSERT_FALSE(bytes.empty());
+
+                Formats::Bmp::Decoder decoder;
+                ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Bmp::ResultCode::Successful);
+                EXPECT_EQ(decoder.GetWidth(), width);
+                EXPECT_EQ(decoder.GetHeight(), height);
+                EXPECT_FALSE(decoder.GetInfoHeader().IsTopDown());
+
+                if(format == ImageFormat::URed8)
+                {
+                    std::vector<uint8_t> decoded(Formats::Bmp::GetDecodedSize(width, height, ImageFormat::URed8Green8Blue8));
+                    ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+                    for(size_t i = 0; i < pixels.size(); i++)
+                    {
+                        ASSERT_EQ(decoded[i * 3], pixels[i]);
+                        ASSERT_EQ(decoded[i * 3 + 1], pixels[i]);
+                        ASSERT_EQ(decoded[i * 3 + 2], pixels[i]);
+                    }
+                    continue;
+                }
+
+                std::vector<uint8_t> decoded(Formats::Bmp::GetDecodedSize(width, height, format));
+                ASSERT_EQ(decoded.size(), pixels.size());
+                ASSERT_EQ(decoder.Decode(format, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+                EXPECT_EQ(decoded, pixels);
+            }
+        }
+    }
+
+    TEST(FileFormat, BmpFormat_Swizzle)
+    {
+        const uint32_t width = 19;
+        const uint32_t height = 3;
+        const auto pixels = CreateBmpTestPixels(width, height, 3);
+        const auto bytes = Formats::Bmp::WriteToBytes(pixels.data(), width, height, ImageFormat::URed8Green8Blue8);
+
+        Formats::Bmp::Decoder decoder;
+        ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Bmp::ResultCode::Successful);
+
+        std::vector<uint8_t> rgba(Formats::Bmp::GetDecodedSize(width, height, ImageFormat::URed8Green8Blue8Alpha8));
+        ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, rgba.data(), rgba.size()), Formats::Bmp::ResultCode::Successful);
+
+        std::vector<uint8_t> bgra(rgba.size());
+        ASSERT_EQ(decoder.Decode(ImageFormat::UBlue8Green8Red8Alpha8, bgra.data(), bgra.size()), Formats::Bmp::ResultCode::Successful);
+
+        for(size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+        {
+            ASSERT_EQ(rgba[i * 4], pixels[i * 3]);
+            ASSERT_EQ(rgba[i * 4 + 1], pixels[i * 3 + 1]);
+            ASSERT_EQ(rgba[i * 4 + 2], pixels[i * 3 + 2]);
+            ASSERT_EQ(rgba[i * 4 + 3], 255);
+
+            ASSERT_EQ(bgra[i * 4], pixels[i * 3 + 2]);
+            ASSERT_EQ(bgra[i * 4 + 1], pixels[i * 3 + 1]);
+            ASSERT_EQ(bgra[i * 4 + 2], pixels[i * 3]);
+            ASSERT_EQ(bgra[i * 4 + 3], 255);
+        }
+
+        EXPECT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, rgba.data(), rgba.size() - 1), Formats::Bmp::ResultCode::BufferTooSmall);
+        EXPECT_EQ(decoder.Decode(ImageFormat::SDepthFloat24StencilUint8, rgba.data(), rgba.size()), Formats::Bmp::ResultCode::UnsupportedFormat);
+    }
+
+    TEST(FileFormat, BmpFormat_Palette)
+    {
+        // 4-bit, top-down, 3x2 image with 3 palette colors.
+        const std::vector<uint32_t> palette = { 0x00FF0000, 0x0000FF00, 0x000000FF };
+        const std::vector<uint8_t> pixelData = {
+            0x01, 0x20, 0x00, 0x00,
+            0x21, 0x00, 0x00, 0x00 };
+        const auto bytes = CreateBmpTestBytes(3, -2, 4, Formats::Bmp::Compression::Rgb, {}, palette, pixelData);
+
+        const auto result = Formats::Bmp::ReadFromBytes(bytes);
+        ASSERT_TRUE(result.IsSuccessful());
+        const auto& file = result.GetFile();
+        EXPECT_TRUE(file.GetInfoHeader().IsTopDown());
+        EXPECT_EQ(file.GetColorTable().GetColors(), palette);
+        EXPECT_EQ(file.GetData(), pixelData);
+
+        std::vector<uint8_t> decoded(Formats::Bmp::GetDecodedSize(3, 2, ImageFormat::URed8Green8Blue8));
+        ASSERT_EQ(Formats::Bmp::Decode(file, ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+
+        const std::vector<uint8_t> expected = {
+            255, 0, 0,   0, 255, 0,   0, 0, 255,
+            0, 0, 255,   0, 255, 0,   255, 0, 0 };
+        EXPECT_EQ(decoded, expected);
+    }
+
+    TEST(FileFormat, BmpFormat_Bitfields)
+    {
+        { // 16-bit RGB565, bottom-up.
+            const std::vector<uint8_t> pixelData = {
+                0x1F, 0x00, 0xE0, 0x07, // Bottom row: blue, green.
+                0x00, 0xF8, 0xFF, 0xFF  // Top row: red, white.
+            };
+            const auto bytes = CreateBmpTestBytes(2, 2, 16, Formats::Bmp::Compression::Bitfields, { 0xF800, 0x07E0, 0x001F }, {}, pixelData);
+
+            Formats::Bmp::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Bmp::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(Formats::Bmp::GetDecodedSize(2, 2, ImageFormat::URed8Green8Blue8Alpha8));
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+
+            const std::vector<uint8_t> expected = {
+                255, 0, 0, 255,   255, 255, 255, 255,
+                0, 0, 255, 255,   0, 255, 0, 255 };
+            EXPECT_EQ(decoded, expected);
+        }
+        { // 32-bit with alpha bit fields in RGBA byte order.
+            const std::vector<uint8_t> pixelData = { 10, 20, 30, 40 };
+            const auto bytes = CreateBmpTestBytes(1, 1, 32, Formats::Bmp::Compression::AlphaBitfields, 
+                { 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000 }, {}, pixelData);
+
+            Formats::Bmp::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Bmp::ResultCode::Successful);
+            EXPECT_EQ(decoder.GetInfoHeader().GetAlphaMask(), uint32_t{ 0xFF000000 });
+
+            std::vector<uint8_t> decoded(4);
+            ASSERT_EQ(decoder.Decode(ImageFormat::UBlue8Green8Red8Alpha8, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+            EXPECT_EQ(decoded, std::vector<uint8_t>({ 30, 20, 10, 40 }));
+        }
+        { // 32-bit without compression ignores the fourth byte.
+            const std::vector<uint8_t> pixelData = { 10, 20, 30, 40 };
+            const auto bytes = CreateBmpTestBytes(1, 1, 32, Formats::Bmp::Compression::Rgb, {}, {}, pixelData);
+
+            Formats::Bmp::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Bmp::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(4);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+            EXPECT_EQ(decoded, std::vector<uint8_t>({ 30, 20, 10, 255 }));
+        }
+    }
+
+    TEST(FileFormat, BmpFormat_Errors)
+    {
+        const auto pixels = CreateBmpTestPixels(4, 4, 3);
+        auto bytes = Formats::Bmp::WriteToBytes(pixels.data(), 4, 4, ImageFormat::URed8Green8Blue8);
+        ASSERT_FALSE(bytes.empty());
+
+        EXPECT_EQ(Formats::Bmp::ReadFromBytes(std::vector<uint8_t>(bytes.begin(), bytes.end() - 1)).GetCode(), Formats::Bmp::ResultCode::UnexpectedEndOfFile);
+        EXPECT_EQ(Formats::Bmp::ReadFromBytes(std::vector<uint8_t>(bytes.begin(), bytes.begin() + 20)).GetCode(), Formats::Bmp::ResultCode::UnexpectedEndOfFile);
+        EXPECT_EQ(Formats::Bmp::ReadFromFile("BmpFormatTestMissing.bmp").GetCode(), Formats::Bmp::ResultCode::CannotOpenFile);
+
+        auto invalidSignature = bytes;
+        invalidSignature[0] = 'X';
+        EXPECT_EQ(Formats::Bmp::ReadFromBytes(invalidSignature).GetCode(), Formats::Bmp::ResultCode::InvalidSignature);
+
+        auto compressed = bytes;
+        compressed[14 + 16] = static_cast<uint8_t>(Formats::Bmp::Compression::Rle8);
+        EXPECT_EQ(Formats::Bmp::ReadFromBytes(compressed).GetCode(), Formats::Bmp::ResultCode::UnsupportedFormat);
+
+        EXPECT_TRUE(Formats::Bmp::WriteToBytes(pixels.data(), 4, 4, ImageFormat::SDepthFloat24StencilUint8).empty());
+        EXPECT_TRUE(Formats::Bmp::WriteToBytes(pixels.data(), 0, 4, ImageFormat::URed8Green8Blue8).empty());
+    }
+
+    TEST(FileFormat, BmpFormat_File)
+    {
+        const std::string filename = "BmpFormatTest.bmp";
+        const uint32_t width = 13;
+        const uint32_t height = 7;
+        const auto pixels = CreateBmpTestPixels(width, height, 4);
+        ASSERT_TRUE(Formats::Bmp::WriteToFile(filename, pixels.data(), width, height, ImageFormat::URed8Green8Blue8Alpha8));
+
+        {
+            Formats::Bmp::Decoder decoder;
+            ASSERT_EQ(decoder.Open(filename), Formats::Bmp::ResultCode::Successful);
+            EXPECT_EQ(decoder.GetInfoHeader().GetCompression(), Formats::Bmp::Compression::Bitfields);
+
+            std::vector<uint8_t> decoded(Formats::Bmp::GetDecodedSize(width, height, ImageFormat::URed8Green8Blue8Alpha8));
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size()), Formats::Bmp::ResultCode::Successful);
+            EXPECT_EQ(decoded, pixels);
+        }
+        {
+            const auto result = Formats::Bmp::ReadFromFile(filename);
+            ASSERT_TRUE(result.IsSuccessful());
+            EXPECT_EQ(result.GetFile().GetInfoHeader().GetWidth(), static_cast<int32_t>(width));
+            EXPECT_EQ(result.GetFile().GetData().size(), size_t{ width } * height * 4);
+        }
+        {
+            std::stringstream stream;
+            ASSERT_TRUE(Formats::Bmp::WriteToStream(stream, pixels.data(), width, height, ImageFormat::URed8Green8Blue8Alpha8));
+            const auto result = Formats::Bmp::ReadFromStream(stream);
+            ASSERT_TRUE(result.IsSuccessful());
+            EXPECT_EQ(result.GetFile().GetInfoHeader().GetHeight(), static_cast<int32_t>(height));
+        }
+
+        std::filesystem::remove(filename);
+    }
+
+}
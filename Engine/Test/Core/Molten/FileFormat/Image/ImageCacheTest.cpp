@@ -0,0 +1,196 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/ImageCache.hpp"
+#include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <chrono>
+
+namespace Molten
+{
+
+    static void WriteImageCacheTestFile(const std::filesystem::path& filename, const uint8_t value, const uint32_t size = 8)
+    {
+        const std::vector<uint8_t> pixels(size * size * 3, value);
+        ASSERT_TRUE(Formats::Bmp::WriteToFile(filename.string(), pixels.data(), size, size, ImageFormat::URed8Green8Blue8));
+    }
+
+    TEST(FileFormat, ImageCache_Load)
+    {
+        const std::filesystem::path filename1 = "ImageCacheTest1.bmp";
+        const std::filesystem::path filename2 = "ImageCacheTest2.bmp";
+        WriteImageCacheTestFile(filename1, 10);
+        WriteImageCacheTestFile(filename2, 10);
+
+        ImageCache cache;
+        auto result1 = cache.Load(filename1);
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result1));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result1)->GetData()[0], 10);
+
+        // Same file and same content of another file share one decoded image.
+        auto result2 = cache.Load(filename1);
+        auto result3 = cache.Load(filename2);
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result3));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result2), std::get<ImageSharedPointer>(result1));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result3), std::get<ImageSharedPointer>(result1));
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 1 });
+
+        // Other formats are decoded separately.
+        auto result4 = cache.Load(filename1, ImageFormat::UBlue8Green8Red8);
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result4));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result4)->GetDataSize(), size_t{ 8 * 8 * 3 });
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 2 });
+        EXPECT_EQ(cache.GetImageCount(), size_t{ 2 });
+
+        // Changed files are decoded again.
+        WriteImageCacheTestFile(filename2, 20);
+        std::filesystem::last_write_time(filename2, std::filesystem::last_write_time(filename2) + std::chrono::seconds(2));
+        auto result5 = cache.Load(filename2);
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result5));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result5)->GetData()[0], 20);
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 3 });
+
+        EXPECT_TRUE(std::holds_alternative<std::string>(cache.Load("ImageCacheTestMissing.bmp")));
+
+        cache.Clear();
+        EXPECT_EQ(cache.GetImageCount(), size_t{ 0 });
+        EXPECT_EQ(std::get<ImageSharedPointer>(result1)->GetData()[0], 10);
+
+        std::filesystem::remove(filename1);
+        std::filesystem::remove(filename2);
+    }
+
+    TEST(FileFormat, ImageCache_LoadVirtualFile)
+    {
+        const std::filesystem::path directory = "ImageCacheVirtual";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        WriteImageCacheTestFile(directory / "image.bmp", 10);
+
+        VirtualFileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.MountDirectory(directory, "data"));
+
+        ImageCache cache;
+        auto result1 = cache.Load(fileSystem, "data/image.bmp");
+        auto result2 = cache.Load(fileSystem, "data/./image.bmp");
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result1));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result2), std::get<ImageSharedPointer>(result1));
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 1 });
+
+        // Virtual files are only hashed again if their size changes.
+        WriteImageCacheTestFile(directory / "image.bmp", 20);
+        auto result3 = cache.Load(fileSystem, "data/image.bmp");
+        EXPECT_EQ(std::get<ImageSharedPointer>(result3), std::get<ImageSharedPointer>(result1));
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 1 });
+
+        WriteImageCacheTestFile(directory / "image.bmp", 30, 16);
+        auto result4 = cache.Load(fileSystem, "data/image.bmp");
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result4));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result4)->GetData()[0], 30);
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 2 });
+
+        EXPECT_TRUE(std::holds_alternative<std::string>(cache.Load(fileSystem, "data/missing.bmp")));
+
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST(FileFormat, ImageCache_Parallel)
+    {
+        std::vector<std::filesystem::path> filenames;
+        for(size_t i = 0; i < 8; i++)
+        {
+            filenames.push_back("ImageCacheParallel" + std::to_string(i) + ".bmp");
+            WriteImageCacheTestFile(filenames.back(), static_cast<uint8_t>(i % 4));
+        }
+
+        ThreadPool threadPool;
+        ImageCache cache;
+
+        const auto results = cache.Load(filenames, threadPool);
+        ASSERT_EQ(results.size(), filenames.size());
+        for(size_t i = 0; i < results.size(); i++)
+        {
+            ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(results[i]));
+            EXPECT_EQ(std::get<ImageSharedPointer>(results[i])->GetData()[0], static_cast<uint8_t>(i % 4));
+        }
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 4 });
+        EXPECT_EQ(cache.GetImageCount(), size_t{ 4 });
+
+        auto future = cache.LoadAsync(filenames[5], threadPool);
+        cache.WaitForAsyncLoads();
+        const auto& result = future.get();
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result), std::get<ImageSharedPointer>(results[1]));
+        EXPECT_EQ(cache.GetDecodeCount(), size_t{ 4 });
+
+        for(const auto& filename : filenames)
+        {
+            std::filesystem::remove(filename);
+        }
+    }
+
+    TEST(FileFormat, ImageCache_LoadAsyncBusyWorkers)
+    {
+        const std::filesystem::path filename = "ImageCacheAsyncTest.bmp";
+        WriteImageCacheTestFile(filename, 20);
+
+        ThreadPool threadPool(1, 1);
+        ImageCache cache;
+
+        // Loads are queued, instead of blocking, while all background workers are busy.
+        std::promise<void> releasePromise;
+        auto releaseFuture = releasePromise.get_future().share();
+        auto busyFuture = threadPool.Execute(ThreadPool::Priority::Background, [releaseFuture]() { releaseFuture.wait(); });
+
+        auto future = cache.LoadAsync(filename, threadPool);
+        EXPECT_EQ(future.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+        // Queued loads of destroyed caches are dropped.
+        std::shared_future<ImageLoadResult> droppedFuture;
+        {
+            ImageCache droppedCache;
+            droppedFuture = droppedCache.LoadAsync(filename, threadPool);
+        }
+        EXPECT_THROW(droppedFuture.get(), std::future_error);
+
+        releasePromise.set_value();
+        busyFuture.wait();
+
+        // Worker may not yet be free again, just after finishing its task, so schedule like a frame loop would.
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(future.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready && std::chrono::steady_clock::now() < timeout)
+        {
+            cache.ScheduleAsyncLoads(threadPool);
+        }
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+        const auto& result = future.get();
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result)->GetData()[0], 20);
+
+        std::filesystem::remove(filename);
+    }
+
+}
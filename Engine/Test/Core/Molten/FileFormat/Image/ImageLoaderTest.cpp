@@ -0,0 +1,142 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/ImageLoader.hpp"
+#include "Molten/FileFormat/Image/BmpFormat.hpp"
+#include <string>
+
+namespace Molten
+{
+
+    TEST(FileFormat, ImageLoader_DefaultLoaders)
+    {
+        const auto& registry = ImageLoaderRegistry::GetDefault();
+        ASSERT_EQ(registry->GetLoaders().size(), size_t{ 3 });
+
+        const std::vector<uint8_t> pixels = { 1, 2, 3,  4, 5, 6 };
+        const auto bmp = Formats::Bmp::WriteToBytes(pixels.data(), 2, 1, ImageFormat::URed8Green8Blue8);
+        const std::vector<uint8_t> ppm = { 'P', '6', ' ', '2', ' ', '1', ' ', '2', '5', '5', '\n',  1, 2, 3,  4, 5, 6 };
+        const std::vector<uint8_t> tga = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 1, 0, 24, 0,  3, 2, 1,  6, 5, 4 };
+
+        const std::vector<std::pair<std::string, const std::vector<uint8_t>*>> images = {
+            { "Image.BMP", &bmp }, { "Image.ppm", &ppm }, { "Image.tga", &tga },
+            { "", &bmp }, { "Image.png", &ppm }
+        };
+
+        for(const auto& [filename, bytes] : images)
+        {
+            auto result = registry->Load(bytes->data(), bytes->size(), filename, ImageFormat::URed8Green8Blue8Alpha8);
+            ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result)) << filename;
+
+            const auto& image = std::get<ImageSharedPointer>(result);
+            EXPECT_EQ(image->GetDimensions(), Vector2ui32(2, 1));
+            EXPECT_EQ(image->GetFormat(), ImageFormat::URed8Green8Blue8Alpha8);
+            ASSERT_EQ(image->GetDataSize(), size_t{ 8 });
+            EXPECT_EQ(std::vector<uint8_t>(image->GetData(), image->GetData() + 8), std::vector<uint8_t>({ 1, 2, 3, 255,  4, 5, 6, 255 }));
+
+            const auto descriptor = image->CreateTextureDescriptor();
+            EXPECT_EQ(descriptor.data, static_cast<const void*>(image->GetData()));
+            EXPECT_EQ(descriptor.dimensions, Vector2ui32(2, 1));
+            EXPECT_EQ(descriptor.format, ImageFormat::URed8Green8Blue8Alpha8);
+            EXPECT_EQ(descriptor.internalFormat, ImageFormat::URed8Green8Blue8Alpha8);
+            EXPECT_EQ(descriptor.initialUsage, TextureUsage::ReadOnly);
+        }
+
+        const std::vector<uint8_t> unknown = { 'G', 'I', 'F', '8', '9', 'a' };
+        auto result = registry->Load(unknown.data(), unknown.size(), "Image.gif", ImageFormat::URed8Green8Blue8Alpha8);
+        EXPECT_TRUE(std::holds_alternative<std::string>(result));
+
+        auto unsupportedFormat = registry->Load(bmp.data(), bmp.size(), "Image.bmp", ImageFormat::SDepthFloat24StencilUint8);
+        EXPECT_TRUE(std::holds_alternative<std::string>(unsupportedFormat));
+    }
+
+    TEST(FileFormat, ImageLoader_CustomLoader)
+    {
+        ImageLoaderRegistry registry;
+        registry.RegisterDefaultLoaders();
+        registry.Register({
+            "Solid",
+            { ".bmp" },
+            [](const uint8_t*, const size_t size) { return size == 1; },
+            [](const uint8_t* data, const size_t, const ImageFormat format, const std::shared_ptr<ImagePixelBufferPool>&) -> ImageLoadResult
+            {
+                return std::make_shared<const Image>(ImagePixelBufferPool::Buffer(4, data[0]), Vector2ui32(1, 1), format);
+            }
+        });
+
+        const std::vector<uint8_t> solid = { 7 };
+        const auto* loader = registry.FindLoader("Image.bmp", solid.data(), solid.size());
+        ASSERT_NE(loader, nullptr);
+        EXPECT_EQ(loader->name, "Solid");
+
+        const std::vector<uint8_t> pixels = { 1, 2, 3 };
+        const auto bmp = Formats::Bmp::WriteToBytes(pixels.data(), 1, 1, ImageFormat::URed8Green8Blue8);
+        loader = registry.FindLoader("Image.bmp", bmp.data(), bmp.size());
+        ASSERT_NE(loader, nullptr);
+        EXPECT_EQ(loader->name, "BMP");
+
+        auto result = registry.Load(solid.data(), solid.size(), "Image.bmp", ImageFormat::URed8Green8Blue8Alpha8);
+        ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result));
+        EXPECT_EQ(std::get<ImageSharedPointer>(result)->GetData()[0], 7);
+    }
+
+    TEST(FileFormat, ImageLoader_PixelBufferPool)
+    {
+        auto pool = std::make_shared<ImagePixelBufferPool>(1024);
+
+        const std::vector<uint8_t> pixels(16 * 4 * 3, 100);
+        const auto bmp = Formats::Bmp::WriteToBytes(pixels.data(), 16, 4, ImageFormat::URed8Green8Blue8);
+        const auto& registry = ImageLoaderRegistry::GetDefault();
+
+        const uint8_t* firstData = nullptr;
+        {
+            auto result = registry->Load(bmp.data(), bmp.size(), "Image.bmp", ImageFormat::URed8Green8Blue8Alpha8, pool);
+            ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result));
+            firstData = std::get<ImageSharedPointer>(result)->GetData();
+            EXPECT_EQ(pool->GetPooledBufferCount(), size_t{ 0 });
+        }
+        EXPECT_EQ(pool->GetPooledBufferCount(), size_t{ 1 });
+        EXPECT_GE(pool->GetPooledSize(), size_t{ 256 });
+
+        {
+            // Smaller decodes reuse the pooled buffer.
+            auto result = registry->Load(bmp.data(), bmp.size(), "Image.bmp", ImageFormat::URed8Green8Blue8, pool);
+            ASSERT_TRUE(std::holds_alternative<ImageSharedPointer>(result));
+            EXPECT_EQ(std::get<ImageSharedPointer>(result)->GetData(), firstData);
+            EXPECT_EQ(std::get<ImageSharedPointer>(result)->GetDataSize(), size_t{ 192 });
+            EXPECT_EQ(pool->GetPooledBufferCount(), size_t{ 0 });
+        }
+
+        // Buffers beyond max pooled size are freed.
+        pool->Release(ImagePixelBufferPool::Buffer(2048));
+        EXPECT_EQ(pool->GetPooledBufferCount(), size_t{ 1 });
+
+        auto buffer = pool->Acquire(512);
+        EXPECT_EQ(buffer.size(), size_t{ 512 });
+        EXPECT_EQ(pool->GetPooledBufferCount(), size_t{ 1 });
+    }
+
+}
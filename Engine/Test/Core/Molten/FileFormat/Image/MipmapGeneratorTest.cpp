@@ -0,0 +1,212 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/MipmapGenerator.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <cstring>
+
+namespace Molten
+{
+
+    TEST(FileFormat, MipmapGenerator_LevelDimensions)
+    {
+        EXPECT_EQ(CalculateMipLevelCount(Vector2ui32{ 1, 1 }), uint32_t{ 1 });
+        EXPECT_EQ(CalculateMipLevelCount(Vector2ui32{ 256, 256 }), uint32_t{ 9 });
+        EXPECT_EQ(CalculateMipLevelCount(Vector2ui32{ 5, 3 }), uint32_t{ 3 });
+        EXPECT_EQ(CalculateMipLevelCount(Vector3ui32{ 1, 2, 17 }), uint32_t{ 5 });
+        EXPECT_EQ(GetMipLevelDimensions(Vector2ui32{ 5, 3 }, 1), (Vector2ui32{ 2, 1 }));
+        EXPECT_EQ(GetMipLevelDimensions(Vector2ui32{ 5, 3 }, 2), (Vector2ui32{ 1, 1 }));
+
+        const std::vector<uint8_t> pixels(5 * 3 * 4, 100);
+        const auto mipChain = MipmapGenerator::Generate(pixels.data(), { 5, 3 }, ImageFormat::URed8Green8Blue8Alpha8);
+        ASSERT_TRUE(mipChain.has_value());
+        ASSERT_EQ(mipChain->GetLevelCount(), uint32_t{ 3 });
+        EXPECT_EQ(mipChain->GetLevelSize(0), size_t{ 5 * 3 * 4 });
+        EXPECT_EQ(mipChain->GetLevelSize(1), size_t{ 2 * 1 * 4 });
+        EXPECT_EQ(mipChain->GetLevelSize(2), size_t{ 4 });
+        EXPECT_EQ(mipChain->GetDataSize(), size_t{ (15 + 2 + 1) * 4 });
+        EXPECT_EQ(mipChain->GetLevelData(2), mipChain->GetData() + (15 + 2) * 4);
+        for(size_t i = 0; i < mipChain->GetDataSize(); i++)
+        {
+            ASSERT_EQ(mipChain->GetData()[i], 100);
+        }
+
+        const auto descriptor = mipChain->CreateTextureDescriptor();
+        EXPECT_EQ(descriptor.data, mipChain->GetData());
+        EXPECT_EQ(descriptor.dimensions, (Vector2ui32{ 5, 3 }));
+        EXPECT_EQ(descriptor.format, ImageFormat::URed8Green8Blue8Alpha8);
+        EXPECT_EQ(descriptor.mipLevelCount, uint32_t{ 3 });
+        EXPECT_EQ(TextureDescriptor2D{}.mipLevelCount, uint32_t{ 1 });
+
+        MipmapGenerator::Settings settings;
+        settings.maxLevelCount = 2;
+        const auto limitedMipChain = MipmapGenerator::Generate(pixels.data(), { 5, 3 }, ImageFormat::URed8Green8Blue8Alpha8, settings);
+        ASSERT_TRUE(limitedMipChain.has_value());
+        EXPECT_EQ(limitedMipChain->GetLevelCount(), uint32_t{ 2 });
+
+        EXPECT_FALSE(MipmapGenerator::Generate(pixels.data(), { 0, 3 }, ImageFormat::URed8Green8Blue8Alpha8).has_value());
+        EXPECT_FALSE(MipmapGenerator::Generate(pixels.data(), { 5, 3 }, ImageFormat::SDepthFloat24StencilUint8).has_value());
+        EXPECT_FALSE(MipmapGenerator::IsFormatSupported(ImageFormat::SRed8));
+        EXPECT_TRUE(MipmapGenerator::IsFormatSupported(ImageFormat::SrgbRed8Green8Blue8Alpha8));
+    }
+
+    TEST(FileFormat, MipmapGenerator_Box)
+    {
+        {
+            const std::vector<uint8_t> pixels = {
+                0, 10, 20, 30,
+                40, 50, 60, 70
+            };
+            const auto mipChain = MipmapGenerator::Generate(pixels.data(), { 4, 2 }, ImageFormat::URed8);
+            ASSERT_TRUE(mipChain.has_value());
+            ASSERT_EQ(mipChain->GetLevelCount(), uint32_t{ 3 });
+            EXPECT_EQ(mipChain->GetLevelData(1)[0], 25);
+            EXPECT_EQ(mipChain->GetLevelData(1)[1], 45);
+            EXPECT_EQ(mipChain->GetLevelData(2)[0], 35);
+        }
+        {
+            // Odd width, each destination pixel covers 1.5 source pixels.
+            const std::vector<uint8_t> pixels = { 0, 90, 180 };
+            const auto mipChain = MipmapGenerator::Generate(pixels.data(), { 3, 1 }, ImageFormat::URed8);
+            ASSERT_TRUE(mipChain.has_value());
+            EXPECT_EQ(mipChain->GetLevelData(1)[0], 90);
+        }
+        {
+            const std::vector<uint8_t> pixels = { 0, 60, 120, 180, 240 };
+            const auto mipChain = MipmapGenerator::Generate(pixels.data(), { 5, 1 }, ImageFormat::URed8);
+            ASSERT_TRUE(mipChain.has_value());
+            ASSERT_EQ(mipChain->GetLevelCount(), uint32_t{ 3 });
+            EXPECT_EQ(mipChain->GetLevelData(1)[0], 48);
+            EXPECT_EQ(mipChain->GetLevelData(1)[1], 192);
+            EXPECT_EQ(mipChain->GetLevelData(2)[0], 120);
+        }
+    }
+
+    TEST(FileFormat, MipmapGenerator_Srgb)
+    {
+        const std::vector<uint8_t> pixels = {
+            0, 0, 0, 0, 255, 255, 255, 255,
+            0, 0, 0, 0, 255, 255, 255, 255
+        };
+
+        const auto unormMipChain = MipmapGenerator::Generate(pixels.data(), { 2, 2 }, ImageFormat::URed8Green8Blue8Alpha8);
+        ASSERT_TRUE(unormMipChain.has_value());
+        const auto* unormPixel = unormMipChain->GetLevelData(1);
+        EXPECT_EQ(unormPixel[0], 128);
+        EXPECT_EQ(unormPixel[3], 128);
+
+        // Average of black and white is linear 0.5, which is encoded as 188 in sRGB. Alpha is always linear.
+        const auto srgbMipChain = MipmapGenerator::Generate(pixels.data(), { 2, 2 }, ImageFormat::SrgbRed8Green8Blue8Alpha8);
+        ASSERT_TRUE(srgbMipChain.has_value());
+        const auto* srgbPixel = srgbMipChain->GetLevelData(1);
+        EXPECT_EQ(srgbPixel[0], 188);
+        EXPECT_EQ(srgbPixel[1], 188);
+        EXPECT_EQ(srgbPixel[2], 188);
+        EXPECT_EQ(srgbPixel[3], 128);
+
+        // Uniform sRGB colors are preserved exactly.
+        std::vector<uint8_t> uniformPixels(16 * 16 * 3);
+        for(size_t i = 0; i < uniformPixels.size(); i += 3)
+        {
+            uniformPixels[i + 0] = 1;
+            uniformPixels[i + 1] = 128;
+            uniformPixels[i + 2] = 254;
+        }
+        const auto uniformMipChain = MipmapGenerator::Generate(uniformPixels.data(), { 16, 16 }, ImageFormat::SrgbRed8Green8Blue8);
+        ASSERT_TRUE(uniformMipChain.has_value());
+        const auto* lastPixel = uniformMipChain->GetLevelData(uniformMipChain->GetLevelCount() - 1);
+        EXPECT_EQ(lastPixel[0], 1);
+        EXPECT_EQ(lastPixel[1], 128);
+        EXPECT_EQ(lastPixel[2], 254);
+    }
+
+    TEST(FileFormat, MipmapGenerator_Kaiser)
+    {
+        std::vector<uint8_t> pixels(32 * 32 * 2);
+        for(size_t y = 0; y < 32; y++)
+        {
+            for(size_t x = 0; x < 32; x++)
+            {
+                pixels[(y * 32 + x) * 2 + 0] = 77;
+                pixels[(y * 32 + x) * 2 + 1] = x < 16 ? 0 : 255;
+            }
+        }
+
+        MipmapGenerator::Settings settings;
+        settings.filter = MipmapGenerator::Filter::Kaiser;
+        const auto mipChain = MipmapGenerator::Generate(pixels.data(), { 32, 32 }, ImageFormat::URed8Green8, settings);
+        ASSERT_TRUE(mipChain.has_value());
+        ASSERT_EQ(mipChain->GetLevelCount(), uint32_t{ 6 });
+
+        // Flat areas are preserved, while the windowed sinc blurs the edge slightly, unlike the box filter.
+        const auto* level = mipChain->GetLevelData(1);
+        for(size_t i = 0; i < 16 * 16; i++)
+        {
+            ASSERT_EQ(level[i * 2], 77);
+        }
+        EXPECT_EQ(level[0 * 2 + 1], 0);
+        EXPECT_EQ(level[15 * 2 + 1], 255);
+        EXPECT_GT(level[7 * 2 + 1], 0);
+        EXPECT_LT(level[7 * 2 + 1], 32);
+        EXPECT_GT(level[8 * 2 + 1], 223);
+        EXPECT_LT(level[8 * 2 + 1], 255);
+        EXPECT_EQ(mipChain->GetLevelData(5)[0], 77);
+        EXPECT_EQ(mipChain->GetLevelData(5)[1], 128);
+
+        const auto boxMipChain = MipmapGenerator::Generate(pixels.data(), { 32, 32 }, ImageFormat::URed8Green8);
+        ASSERT_TRUE(boxMipChain.has_value());
+        EXPECT_EQ(boxMipChain->GetLevelData(1)[7 * 2 + 1], 0);
+        EXPECT_EQ(boxMipChain->GetLevelData(1)[8 * 2 + 1], 255);
+    }
+
+    TEST(FileFormat, MipmapGenerator_Parallel)
+    {
+        std::vector<uint8_t> pixels(131 * 97 * 4);
+        uint32_t state = 12345;
+        for(auto& value : pixels)
+        {
+            state = state * 1103515245 + 12345;
+            value = static_cast<uint8_t>(state >> 16);
+        }
+
+        ThreadPool threadPool(4);
+        for(const auto filter : { MipmapGenerator::Filter::Box, MipmapGenerator::Filter::Kaiser })
+        {
+            MipmapGenerator::Settings settings;
+            settings.filter = filter;
+
+            const auto serial = MipmapGenerator::Generate(pixels.data(), { 131, 97 }, ImageFormat::SrgbRed8Green8Blue8Alpha8, settings);
+            const auto parallel = MipmapGenerator::Generate(pixels.data(), { 131, 97 }, ImageFormat::SrgbRed8Green8Blue8Alpha8, settings, &threadPool);
+            ASSERT_TRUE(serial.has_value());
+            ASSERT_TRUE(parallel.has_value());
+            ASSERT_EQ(serial->GetLevelCount(), uint32_t{ 8 });
+            ASSERT_EQ(serial->GetDataSize(), parallel->GetDataSize());
+            EXPECT_EQ(std::memcmp(serial->GetData(), parallel->GetData(), serial->GetDataSize()), 0);
+        }
+    }
+
+}
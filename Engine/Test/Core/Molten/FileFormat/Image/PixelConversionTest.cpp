@@ -0,0 +1,92 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/PixelConversion.hpp"
+#include <string>
+#include <vector>
+
+namespace Molten
+{
+
+    TEST(FileFormat, PixelConversion_ConvertRow)
+    {
+        Molten::Test::PrintInfo(std::string{ "Pixel conversion instruction set: " } + PixelConversion::GetInstructionSet());
+
+        // Every row length up to several vector blocks, to cover vector loops of the active instruction set and scalar tails.
+        for(size_t pixelCount = 0; pixelCount < 70; pixelCount++)
+        {
+            for(const size_t sourceChannelCount : { size_t{ 1 }, size_t{ 3 }, size_t{ 4 } })
+            {
+                for(const size_t destinationChannelCount : { size_t{ 3 }, size_t{ 4 } })
+                {
+                    for(const bool swapRedBlue : { false, true })
+                    {
+                        for(const bool opaque : { false, true })
+                        {
+                            std::vector<uint8_t> source(pixelCount * sourceChannelCount);
+                            for(size_t i = 0; i < source.size(); i++)
+                            {
+                                source[i] = static_cast<uint8_t>(i * 7 + 3);
+                            }
+
+                            std::vector<uint8_t> expected(pixelCount * destinationChannelCount);
+                            for(size_t i = 0; i < pixelCount; i++)
+                            {
+                                const auto* src = source.data() + i * sourceChannelCount;
+                                auto* dst = expected.data() + i * destinationChannelCount;
+                                const bool gray = sourceChannelCount == 1;
+                                dst[0] = gray ? src[0] : src[swapRedBlue ? 2 : 0];
+                                dst[1] = gray ? src[0] : src[1];
+                                dst[2] = gray ? src[0] : src[swapRedBlue ? 0 : 2];
+                                if(destinationChannelCount == 4)
+                                {
+                                    dst[3] = sourceChannelCount == 4 && !opaque ? src[3] : 255;
+                                }
+                            }
+
+                            // Guard bytes detect writes past the row.
+                            std::vector<uint8_t> destination(expected.size() + 16, 0xCD);
+                            PixelConversion::ConvertRow(
+                                source.data(), sourceChannelCount,
+                                destination.data(), destinationChannelCount,
+                                swapRedBlue, opaque, pixelCount);
+
+                            ASSERT_EQ(std::vector<uint8_t>(destination.begin(), destination.begin() + expected.size()), expected)
+                                << pixelCount << " pixels, " << sourceChannelCount << " to " << destinationChannelCount << " channels"
+                                << ", swap: " << swapRedBlue << ", opaque: " << opaque;
+                            for(size_t i = expected.size(); i < destination.size(); i++)
+                            {
+                                ASSERT_EQ(destination[i], 0xCD);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+}
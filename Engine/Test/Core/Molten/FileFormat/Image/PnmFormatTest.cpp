@@ -0,0 +1,107 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/PnmFormat.hpp"
+#include <string>
+#include <vector>
+
+namespace Molten
+{
+
+    static std::vector<uint8_t> CreatePnmTestBytes(const std::string& header, const std::vector<uint8_t>& samples = {})
+    {
+        std::vector<uint8_t> bytes(header.begin(), header.end());
+        bytes.insert(bytes.end(), samples.begin(), samples.end());
+        return bytes;
+    }
+
+    TEST(FileFormat, PnmFormat_Binary)
+    {
+        { // P6 with comments.
+            const auto bytes = CreatePnmTestBytes("P6\n# Comment\n2 1 # Size\n255\n", { 1, 2, 3,  4, 5, 6 });
+            EXPECT_TRUE(Formats::Pnm::IsPnmData(bytes.data(), bytes.size()));
+
+            Formats::Pnm::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Pnm::ResultCode::Successful);
+            EXPECT_EQ(decoder.GetWidth(), uint32_t{ 2 });
+            EXPECT_EQ(decoder.GetHeight(), uint32_t{ 1 });
+
+            std::vector<uint8_t> decoded(2 * 4);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size()), Formats::Pnm::ResultCode::Successful);
+            EXPECT_EQ(decoded, std::vector<uint8_t>({ 1, 2, 3, 255,  4, 5, 6, 255 }));
+
+            ASSERT_EQ(decoder.Decode(ImageFormat::UBlue8Green8Red8, decoded.data(), decoded.size()), Formats::Pnm::ResultCode::Successful);
+            EXPECT_EQ(std::vector<uint8_t>(decoded.begin(), decoded.begin() + 6), std::vector<uint8_t>({ 3, 2, 1,  6, 5, 4 }));
+        }
+        { // P5 with 16-bit big endian samples.
+            const auto bytes = CreatePnmTestBytes("P5 2 1 65535\n", { 0xFF, 0xFF,  0x80, 0x00 });
+
+            Formats::Pnm::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Pnm::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(2 * 3);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Pnm::ResultCode::Successful);
+            EXPECT_EQ(decoded, std::vector<uint8_t>({ 255, 255, 255,  128, 128, 128 }));
+        }
+    }
+
+    TEST(FileFormat, PnmFormat_Plain)
+    {
+        const auto bytes = CreatePnmTestBytes("P3\n2 1\n15\n15 0 0\n0 # Comment\n 15 0\n");
+
+        Formats::Pnm::Decoder decoder;
+        ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Pnm::ResultCode::Successful);
+
+        std::vector<uint8_t> decoded(2 * 3);
+        ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Pnm::ResultCode::Successful);
+        EXPECT_EQ(decoded, std::vector<uint8_t>({ 255, 0, 0,  0, 255, 0 }));
+
+        const auto truncated = CreatePnmTestBytes("P2\n2 1\n255\n10\n");
+        ASSERT_EQ(decoder.Open(truncated.data(), truncated.size()), Formats::Pnm::ResultCode::Successful);
+        EXPECT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Pnm::ResultCode::UnexpectedEndOfFile);
+    }
+
+    TEST(FileFormat, PnmFormat_Errors)
+    {
+        Formats::Pnm::Decoder decoder;
+
+        const auto invalidSignature = CreatePnmTestBytes("Q6\n1 1\n255\n", { 0, 0, 0 });
+        EXPECT_EQ(decoder.Open(invalidSignature.data(), invalidSignature.size()), Formats::Pnm::ResultCode::InvalidSignature);
+        EXPECT_FALSE(Formats::Pnm::IsPnmData(invalidSignature.data(), invalidSignature.size()));
+
+        const auto bitmap = CreatePnmTestBytes("P4\n1 1\n", { 0 });
+        EXPECT_EQ(decoder.Open(bitmap.data(), bitmap.size()), Formats::Pnm::ResultCode::UnsupportedFormat);
+
+        const auto truncated = CreatePnmTestBytes("P6\n2 2\n255\n", { 0, 0, 0 });
+        EXPECT_EQ(decoder.Open(truncated.data(), truncated.size()), Formats::Pnm::ResultCode::UnexpectedEndOfFile);
+
+        const auto invalidMaxValue = CreatePnmTestBytes("P6\n1 1\n70000\n", { 0, 0, 0 });
+        EXPECT_EQ(decoder.Open(invalidMaxValue.data(), invalidMaxValue.size()), Formats::Pnm::ResultCode::InvalidHeader);
+
+        EXPECT_EQ(decoder.Open("PnmFormatTestMissing.ppm"), Formats::Pnm::ResultCode::CannotOpenFile);
+    }
+
+}
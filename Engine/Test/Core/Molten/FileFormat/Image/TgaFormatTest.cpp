@@ -0,0 +1,168 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Image/TgaFormat.hpp"
+#include <vector>
+
+namespace Molten
+{
+
+    static std::vector<uint8_t> CreateTgaTestBytes(
+        const Formats::Tga::ImageType imageType,
+        const uint16_t width,
+        const uint16_t height,
+        const uint8_t pixelDepth,
+        const uint8_t imageDescriptor,
+        const std::vector<uint8_t>& colorMap,
+        const uint8_t colorMapEntrySize,
+        const std::vector<uint8_t>& pixelData)
+    {
+        const auto colorMapLength = colorMapEntrySize == 0 ? 0 : static_cast<uint16_t>(colorMap.size() / (colorMapEntrySize / 8));
+        std::vector<uint8_t> bytes = {
+            1, // Id length.
+            static_cast<uint8_t>(colorMap.empty() ? 0 : 1),
+            static_cast<uint8_t>(imageType),
+            0, 0,
+            static_cast<uint8_t>(colorMapLength), static_cast<uint8_t>(colorMapLength >> 8),
+            colorMapEntrySize,
+            0, 0, 0, 0,
+            static_cast<uint8_t>(width), static_cast<uint8_t>(width >> 8),
+            static_cast<uint8_t>(height), static_cast<uint8_t>(height >> 8),
+            pixelDepth,
+            imageDescriptor,
+            42 // Image id.
+        };
+        bytes.insert(bytes.end(), colorMap.begin(), colorMap.end());
+        bytes.insert(bytes.end(), pixelData.begin(), pixelData.end());
+        return bytes;
+    }
+
+    TEST(FileFormat, TgaFormat_TrueColor)
+    {
+        { // 24-bit, bottom-up.
+            const auto bytes = CreateTgaTestBytes(Formats::Tga::ImageType::TrueColor, 2, 2, 24, 0, {}, 0, {
+                1, 2, 3,  4, 5, 6,
+                7, 8, 9,  10, 11, 12 });
+
+            Formats::Tga::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Tga::ResultCode::Successful);
+            EXPECT_EQ(decoder.GetWidth(), uint32_t{ 2 });
+            EXPECT_EQ(decoder.GetHeight(), uint32_t{ 2 });
+
+            std::vector<uint8_t> decoded(2 * 2 * 4);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::Successful);
+            const std::vector<uint8_t> expected = {
+                9, 8, 7, 255,  12, 11, 10, 255,
+                3, 2, 1, 255,  6, 5, 4, 255 };
+            EXPECT_EQ(decoded, expected);
+        }
+        { // RLE 32-bit with alpha, top-down, with a run crossing rows.
+            const auto bytes = CreateTgaTestBytes(Formats::Tga::ImageType::RleTrueColor, 3, 2, 32, 0x28, {}, 0, {
+                0x83, 10, 20, 30, 40,
+                0x01, 1, 2, 3, 4,  5, 6, 7, 8 });
+
+            Formats::Tga::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Tga::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(3 * 2 * 4);
+            ASSERT_EQ(decoder.Decode(ImageFormat::UBlue8Green8Red8Alpha8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::Successful);
+            const std::vector<uint8_t> expected = {
+                10, 20, 30, 40,  10, 20, 30, 40,  10, 20, 30, 40,
+                10, 20, 30, 40,  1, 2, 3, 4,  5, 6, 7, 8 };
+            EXPECT_EQ(decoded, expected);
+
+            const auto truncated = std::vector<uint8_t>(bytes.begin(), bytes.end() - 1);
+            ASSERT_EQ(decoder.Open(truncated.data(), truncated.size()), Formats::Tga::ResultCode::Successful);
+            EXPECT_EQ(decoder.Decode(ImageFormat::UBlue8Green8Red8Alpha8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::UnexpectedEndOfFile);
+        }
+        { // 16-bit, top-down.
+            const auto bytes = CreateTgaTestBytes(Formats::Tga::ImageType::TrueColor, 2, 1, 16, 0x21, {}, 0, {
+                0x00, 0xFC,  0x1F, 0x00 });
+
+            Formats::Tga::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Tga::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(2 * 4);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::Successful);
+            const std::vector<uint8_t> expected = { 255, 0, 0, 255,  0, 0, 255, 0 };
+            EXPECT_EQ(decoded, expected);
+        }
+    }
+
+    TEST(FileFormat, TgaFormat_GrayscaleAndColorMapped)
+    {
+        { // Grayscale, top-down.
+            const auto bytes = CreateTgaTestBytes(Formats::Tga::ImageType::Grayscale, 3, 1, 8, 0x20, {}, 0, { 0, 128, 255 });
+
+            Formats::Tga::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Tga::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(3 * 3);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::Successful);
+            const std::vector<uint8_t> expected = { 0, 0, 0,  128, 128, 128,  255, 255, 255 };
+            EXPECT_EQ(decoded, expected);
+        }
+        { // RLE color mapped, with 24-bit entries.
+            const auto bytes = CreateTgaTestBytes(Formats::Tga::ImageType::RleColorMapped, 4, 1, 8, 0x20, { 255, 0, 0,  0, 0, 255 }, 24, {
+                0x82, 1,
+                0x00, 0 });
+
+            Formats::Tga::Decoder decoder;
+            ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Tga::ResultCode::Successful);
+
+            std::vector<uint8_t> decoded(4 * 3);
+            ASSERT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::Successful);
+            const std::vector<uint8_t> expected = { 255, 0, 0,  255, 0, 0,  255, 0, 0,  0, 0, 255 };
+            EXPECT_EQ(decoded, expected);
+        }
+    }
+
+    TEST(FileFormat, TgaFormat_Errors)
+    {
+        const auto bytes = CreateTgaTestBytes(Formats::Tga::ImageType::TrueColor, 2, 2, 24, 0, {}, 0, std::vector<uint8_t>(12, 0));
+        EXPECT_TRUE(Formats::Tga::IsTgaData(bytes.data(), bytes.size()));
+
+        Formats::Tga::Decoder decoder;
+        EXPECT_EQ(decoder.Open(bytes.data(), bytes.size() - 1), Formats::Tga::ResultCode::UnexpectedEndOfFile);
+        EXPECT_EQ(decoder.Open(bytes.data(), 10), Formats::Tga::ResultCode::UnexpectedEndOfFile);
+        EXPECT_EQ(decoder.Open("TgaFormatTestMissing.tga"), Formats::Tga::ResultCode::CannotOpenFile);
+
+        auto unsupportedDepth = bytes;
+        unsupportedDepth[16] = 12;
+        EXPECT_EQ(decoder.Open(unsupportedDepth.data(), unsupportedDepth.size()), Formats::Tga::ResultCode::UnsupportedFormat);
+        EXPECT_FALSE(Formats::Tga::IsTgaData(unsupportedDepth.data(), unsupportedDepth.size()));
+
+        auto rightToLeft = bytes;
+        rightToLeft[17] = 0x10;
+        EXPECT_EQ(decoder.Open(rightToLeft.data(), rightToLeft.size()), Formats::Tga::ResultCode::UnsupportedFormat);
+
+        ASSERT_EQ(decoder.Open(bytes.data(), bytes.size()), Formats::Tga::ResultCode::Successful);
+        std::vector<uint8_t> decoded(2 * 2 * 4);
+        EXPECT_EQ(decoder.Decode(ImageFormat::URed8Green8Blue8Alpha8, decoded.data(), decoded.size() - 1), Formats::Tga::ResultCode::BufferTooSmall);
+        EXPECT_EQ(decoder.Decode(ImageFormat::URed8, decoded.data(), decoded.size()), Formats::Tga::ResultCode::UnsupportedFormat);
+    }
+
+}
@@ -0,0 +1,314 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Mesh/MeshCacheFile.hpp"
+#include <fstream>
+
+namespace Molten
+{
+
+    static IndexedMeshes CreateMeshCacheTestMeshes()
+    {
+        IndexedMeshes meshes(2);
+
+        meshes[0].name = "First";
+        meshes[0].submeshes.reserve(2); // Keeps references of submeshes valid while adding more.
+        auto& first = meshes[0].submeshes.emplace_back();
+        first.material = "Red";
+        first.vertices = {
+            { { -1.0f, 0.0f, 2.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+            { { 1.0f, 3.0f, 2.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f } },
+            { { 0.0f, 1.0f, -4.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f } } };
+        first.SetIndices({ 0, 1, 2 });
+
+        auto& second = meshes[0].submeshes.emplace_back();
+        second.material = "Blue";
+        second.vertices = first.vertices;
+        second.vertices[0].position = { -5.0f, 0.0f, 0.0f };
+        second.SetIndices({ 2, 1, 0, 0, 1, 70000 });
+        second.lods.resize(2);
+        second.lods[0].SetIndices({ 0, 1, 70000 });
+        second.lods[0].error = 0.5f;
+        second.lods[1].SetIndices({ 2, 1, 0 });
+        second.lods[1].error = 1.5f;
+
+        second.meshlets.resize(2);
+        second.meshlets[0].vertexCount = 3;
+        second.meshlets[0].triangleCount = 1;
+        second.meshlets[0].center = { 1.0f, 2.0f, 3.0f };
+        second.meshlets[0].radius = 4.0f;
+        second.meshlets[0].bounds = { { -1.0f, -2.0f, -3.0f }, { 1.0f, 2.0f, 3.0f } };
+        second.meshlets[0].coneApex = { 0.0f, 1.0f, 0.0f };
+        second.meshlets[0].coneAxis = { 0.0f, 0.0f, 1.0f };
+        second.meshlets[0].coneCutoff = 0.25f;
+        second.meshlets[1].vertexOffset = 3;
+        second.meshlets[1].vertexCount = 1;
+        second.meshlets[1].triangleOffset = 3;
+        second.meshlets[1].triangleCount = 1;
+        second.meshletVertices = { 2, 1, 0, 70000 };
+        second.meshletTriangles = { 0, 1, 2, 0, 0, 0 };
+
+        meshes[1].name = "Second";
+        auto& third = meshes[1].submeshes.emplace_back();
+        third.material = "Red";
+        third.vertices = first.vertices;
+        third.SetIndices({ 1, 2, 0 });
+
+        return meshes;
+    }
+
+    TEST(FileFormat, MeshCacheFile)
+    {
+        const auto meshes = CreateMeshCacheTestMeshes();
+
+        MeshCacheFile::SourceKey sourceKey;
+        sourceKey.size = 1234;
+        sourceKey.modifiedTime = -5678;
+        sourceKey.hash = 0x0123456789ABCDEFULL;
+        sourceKey.settingsHash = 42;
+
+        MeshCacheFile::SourceKey dependencyKey;
+        dependencyKey.size = 12;
+        dependencyKey.modifiedTime = 34;
+        dependencyKey.hash = 56;
+
+        // Unused materials are not stored, materials without properties are stored by name.
+        MeshCacheFile::Material red;
+        red.name = "Red";
+        red.diffuseColor = { 1.0f, 0.0f, 0.0f };
+        red.transparency = 0.25f;
+        red.metallic = 0.0f;
+        red.diffuseTexture = MeshCacheFile::MaterialTexture{ "textures/red.png", Vector2f32{ 0.5f, 2.0f }, std::nullopt, Vector3f32{ 2.0f, 2.0f, 1.0f }, true };
+        red.roughnessTexture = MeshCacheFile::MaterialTexture{ "textures/red_roughness.png", std::nullopt, std::nullopt, std::nullopt, false };
+        MeshCacheFile::Material green;
+        green.name = "Green";
+        green.diffuseColor = { 0.0f, 1.0f, 0.0f };
+
+        auto bytes = MeshCacheFile::Serialize(meshes, sourceKey, { { "materials/first.mtl", dependencyKey }, { "second.mtl", {} } }, { green, red });
+
+        const std::filesystem::path filename = "MeshCacheFileTest.mcache";
+        ASSERT_TRUE(MeshCacheFile::WriteToFile(filename, bytes));
+
+        MeshCacheFile fromBytes;
+        ASSERT_EQ(fromBytes.ReadFromBytes(std::move(bytes)), MeshCacheFile::ReadResult::Successful);
+        EXPECT_FALSE(fromBytes.IsMemoryMapped());
+
+        MeshCacheFile fromFile;
+        ASSERT_EQ(fromFile.ReadFromFile(filename), MeshCacheFile::ReadResult::Successful);
+        EXPECT_TRUE(fromFile.IsMemoryMapped());
+
+        for (const auto* cacheFile : { &fromBytes, &fromFile })
+        {
+            EXPECT_EQ(cacheFile->GetSourceKey().size, sourceKey.size);
+            EXPECT_EQ(cacheFile->GetSourceKey().modifiedTime, sourceKey.modifiedTime);
+            EXPECT_EQ(cacheFile->GetSourceKey().hash, sourceKey.hash);
+            EXPECT_EQ(cacheFile->GetSourceKey().settingsHash, sourceKey.settingsHash);
+
+            const auto& materials = cacheFile->GetMaterials();
+            ASSERT_EQ(materials.size(), size_t{ 2 });
+            EXPECT_EQ(materials[0].name, "Red");
+            EXPECT_EQ(materials[0].diffuseColor, (Vector3f32{ 1.0f, 0.0f, 0.0f }));
+            EXPECT_EQ(materials[0].transparency, 0.25f);
+            EXPECT_EQ(materials[0].metallic, 0.0f);
+            EXPECT_FALSE(materials[0].ambientColor.has_value());
+            EXPECT_FALSE(materials[0].roughness.has_value());
+            EXPECT_FALSE(materials[0].ambientTexture.has_value());
+            ASSERT_TRUE(materials[0].diffuseTexture.has_value());
+            EXPECT_EQ(materials[0].diffuseTexture->filename, "textures/red.png");
+            EXPECT_EQ(materials[0].diffuseTexture->modifier, (Vector2f32{ 0.5f, 2.0f }));
+            EXPECT_FALSE(materials[0].diffuseTexture->originOffset.has_value());
+            EXPECT_EQ(materials[0].diffuseTexture->scale, (Vector3f32{ 2.0f, 2.0f, 1.0f }));
+            EXPECT_EQ(materials[0].diffuseTexture->clamp, true);
+            ASSERT_TRUE(materials[0].roughnessTexture.has_value());
+            EXPECT_EQ(materials[0].roughnessTexture->filename, "textures/red_roughness.png");
+            EXPECT_EQ(materials[0].roughnessTexture->clamp, false);
+            EXPECT_FALSE(materials[0].roughnessTexture->scale.has_value());
+            EXPECT_EQ(materials[1].name, "Blue");
+            EXPECT_FALSE(materials[1].diffuseColor.has_value());
+            EXPECT_FALSE(materials[1].diffuseTexture.has_value());
+
+            ASSERT_EQ(cacheFile->GetDependencies().size(), size_t{ 2 });
+            EXPECT_EQ(cacheFile->GetDependencies()[0].filename, "materials/first.mtl");
+            EXPECT_EQ(cacheFile->GetDependencies()[0].key.size, uint64_t{ 12 });
+            EXPECT_EQ(cacheFile->GetDependencies()[0].key.modifiedTime, int64_t{ 34 });
+            EXPECT_EQ(cacheFile->GetDependencies()[0].key.hash, uint64_t{ 56 });
+            EXPECT_EQ(cacheFile->GetDependencies()[1].filename, "second.mtl");
+            EXPECT_EQ(cacheFile->GetDependencies()[1].key.size, uint64_t{ 0 });
+
+            const auto& cachedMeshes = cacheFile->GetMeshes();
+            ASSERT_EQ(cachedMeshes.size(), size_t{ 2 });
+            EXPECT_EQ(cachedMeshes[0].name, "First");
+            EXPECT_EQ(cachedMeshes[0].submeshCount, uint32_t{ 2 });
+            EXPECT_EQ(cachedMeshes[0].bounds.low, (Vector3f32{ -5.0f, 0.0f, -4.0f }));
+            EXPECT_EQ(cachedMeshes[0].bounds.high, (Vector3f32{ 1.0f, 3.0f, 2.0f }));
+            EXPECT_EQ(cachedMeshes[1].name, "Second");
+            EXPECT_EQ(cachedMeshes[1].firstSubmesh, uint32_t{ 2 });
+
+            const auto& submeshes = cacheFile->GetSubmeshes();
+            ASSERT_EQ(submeshes.size(), size_t{ 3 });
+            EXPECT_EQ(submeshes[0].material, "Red");
+            EXPECT_EQ(submeshes[0].bounds.low, (Vector3f32{ -1.0f, 0.0f, -4.0f }));
+            EXPECT_EQ(submeshes[0].indexDataType, IndexBuffer::DataType::Uint16);
+            EXPECT_EQ(submeshes[1].material, "Blue");
+            EXPECT_EQ(submeshes[1].materialIndex, uint32_t{ 1 });
+            EXPECT_EQ(submeshes[1].indexDataType, IndexBuffer::DataType::Uint32);
+            EXPECT_EQ(submeshes[1].GetIndexBufferDescriptor().indexCount, uint32_t{ 6 });
+            EXPECT_EQ(submeshes[1].GetVertexBufferDescriptor().vertexCount, uint32_t{ 3 });
+            EXPECT_EQ(submeshes[1].vertices[0].position, (Vector3f32{ -5.0f, 0.0f, 0.0f }));
+            EXPECT_EQ(submeshes[2].material, "Red");
+            EXPECT_EQ(submeshes[0].lodCount, uint32_t{ 0 });
+            EXPECT_EQ(submeshes[1].firstLod, uint32_t{ 0 });
+            EXPECT_EQ(submeshes[1].lodCount, uint32_t{ 2 });
+
+            const auto& lods = cacheFile->GetLods();
+            ASSERT_EQ(lods.size(), size_t{ 2 });
+            EXPECT_EQ(lods[0].indexDataType, IndexBuffer::DataType::Uint32);
+            EXPECT_EQ(lods[0].GetIndexBufferDescriptor().indexCount, uint32_t{ 3 });
+            EXPECT_EQ(lods[0].error, 0.5f);
+            EXPECT_EQ(lods[1].indexDataType, IndexBuffer::DataType::Uint16);
+            EXPECT_EQ(lods[1].error, 1.5f);
+
+            EXPECT_EQ(submeshes[0].meshletCount, uint32_t{ 0 });
+            EXPECT_EQ(submeshes[1].firstMeshlet, uint32_t{ 0 });
+            ASSERT_EQ(submeshes[1].meshletCount, uint32_t{ 2 });
+            ASSERT_EQ(submeshes[1].meshletVertexCount, uint32_t{ 4 });
+            EXPECT_EQ(submeshes[1].meshletVertices[3], uint32_t{ 70000 });
+            ASSERT_EQ(submeshes[1].meshletTriangleIndexCount, uint32_t{ 6 });
+            EXPECT_EQ(submeshes[1].meshletTriangles[2], uint8_t{ 2 });
+
+            const auto& meshlets = cacheFile->GetMeshlets();
+            ASSERT_EQ(meshlets.size(), size_t{ 2 });
+            EXPECT_EQ(meshlets[0].center, (Vector3f32{ 1.0f, 2.0f, 3.0f }));
+            EXPECT_EQ(meshlets[0].radius, 4.0f);
+            EXPECT_EQ(meshlets[0].bounds.low, (Vector3f32{ -1.0f, -2.0f, -3.0f }));
+            EXPECT_EQ(meshlets[0].bounds.high, (Vector3f32{ 1.0f, 2.0f, 3.0f }));
+            EXPECT_EQ(meshlets[0].coneApex, (Vector3f32{ 0.0f, 1.0f, 0.0f }));
+            EXPECT_EQ(meshlets[0].coneAxis, (Vector3f32{ 0.0f, 0.0f, 1.0f }));
+            EXPECT_EQ(meshlets[0].coneCutoff, 0.25f);
+            EXPECT_EQ(meshlets[1].vertexOffset, uint32_t{ 3 });
+            EXPECT_EQ(meshlets[1].triangleOffset, uint32_t{ 3 });
+            EXPECT_EQ(meshlets[1].coneCutoff, 1.0f);
+
+            const auto indexedMeshes = cacheFile->ToIndexedMeshes();
+            ASSERT_EQ(indexedMeshes.size(), meshes.size());
+            for (size_t i = 0; i < meshes.size(); i++)
+            {
+                EXPECT_EQ(indexedMeshes[i].name, meshes[i].name);
+                ASSERT_EQ(indexedMeshes[i].submeshes.size(), meshes[i].submeshes.size());
+                for (size_t j = 0; j < meshes[i].submeshes.size(); j++)
+                {
+                    EXPECT_EQ(indexedMeshes[i].submeshes[j].material, meshes[i].submeshes[j].material);
+                    EXPECT_EQ(indexedMeshes[i].submeshes[j].GetIndices(), meshes[i].submeshes[j].GetIndices());
+                    EXPECT_EQ(indexedMeshes[i].submeshes[j].vertices.size(), meshes[i].submeshes[j].vertices.size());
+
+                    const auto& indexedLods = indexedMeshes[i].submeshes[j].lods;
+                    ASSERT_EQ(indexedLods.size(), meshes[i].submeshes[j].lods.size());
+                    for (size_t k = 0; k < indexedLods.size(); k++)
+                    {
+                        EXPECT_EQ(indexedLods[k].GetIndices(), meshes[i].submeshes[j].lods[k].GetIndices());
+                        EXPECT_EQ(indexedLods[k].error, meshes[i].submeshes[j].lods[k].error);
+                    }
+
+                    EXPECT_EQ(indexedMeshes[i].submeshes[j].meshlets.size(), meshes[i].submeshes[j].meshlets.size());
+                    EXPECT_EQ(indexedMeshes[i].submeshes[j].meshletVertices, meshes[i].submeshes[j].meshletVertices);
+                    EXPECT_EQ(indexedMeshes[i].submeshes[j].meshletTriangles, meshes[i].submeshes[j].meshletTriangles);
+                }
+            }
+        }
+
+        fromFile = MeshCacheFile{};
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, MeshCacheFile_Compressed)
+    {
+        const auto meshes = CreateMeshCacheTestMeshes();
+
+        MeshCacheFile::SourceKey sourceKey;
+        sourceKey.hash = 1234;
+
+        const auto bytes = MeshCacheFile::Serialize(meshes, sourceKey);
+
+        const std::filesystem::path filename = "MeshCacheFileTestCompressed.mcache";
+        ASSERT_TRUE(MeshCacheFile::WriteToFile(filename, bytes, true));
+        EXPECT_LT(std::filesystem::file_size(filename), bytes.size());
+
+        MeshCacheFile cacheFile;
+        ASSERT_EQ(cacheFile.ReadFromFile(filename), MeshCacheFile::ReadResult::Successful);
+        EXPECT_FALSE(cacheFile.IsMemoryMapped());
+        EXPECT_EQ(cacheFile.GetSourceKey().hash, sourceKey.hash);
+        ASSERT_EQ(cacheFile.GetSubmeshes().size(), size_t{ 3 });
+        EXPECT_EQ(cacheFile.GetSubmeshes()[1].vertices[0].position, (Vector3f32{ -5.0f, 0.0f, 0.0f }));
+        EXPECT_EQ(cacheFile.GetLods().size(), size_t{ 2 });
+        EXPECT_EQ(cacheFile.GetMeshlets().size(), size_t{ 2 });
+
+        // Truncated frames are rejected.
+        {
+            std::vector<char> fileData(std::filesystem::file_size(filename));
+            {
+                std::ifstream file(filename, std::ios::binary);
+                file.read(fileData.data(), static_cast<std::streamsize>(fileData.size()));
+            }
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(fileData.data(), static_cast<std::streamsize>(fileData.size() - 4));
+        }
+        EXPECT_EQ(cacheFile.ReadFromFile(filename), MeshCacheFile::ReadResult::InvalidFile);
+        EXPECT_TRUE(cacheFile.GetSubmeshes().empty());
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, MeshCacheFile_Invalid)
+    {
+        const auto meshes = CreateMeshCacheTestMeshes();
+        const auto bytes = MeshCacheFile::Serialize(meshes, {});
+
+        MeshCacheFile cacheFile;
+        EXPECT_EQ(cacheFile.ReadFromFile("ThisFileDoesNotExist.mcache"), MeshCacheFile::ReadResult::CannotOpenFile);
+        EXPECT_EQ(cacheFile.ReadFromBytes({}), MeshCacheFile::ReadResult::InvalidFile);
+
+        {
+            auto truncated = bytes;
+            truncated.resize(truncated.size() - 1);
+            EXPECT_EQ(cacheFile.ReadFromBytes(std::move(truncated)), MeshCacheFile::ReadResult::InvalidFile);
+        }
+        {
+            auto wrongVersion = bytes;
+            wrongVersion[4] = static_cast<uint8_t>(MeshCacheFile::Version + 1);
+            EXPECT_EQ(cacheFile.ReadFromBytes(std::move(wrongVersion)), MeshCacheFile::ReadResult::IncompatibleVersion);
+        }
+        {
+            auto wrongMagic = bytes;
+            wrongMagic[0] ^= 0xFF;
+            EXPECT_EQ(cacheFile.ReadFromBytes(std::move(wrongMagic)), MeshCacheFile::ReadResult::InvalidFile);
+        }
+
+        EXPECT_TRUE(cacheFile.GetMeshes().empty());
+        EXPECT_TRUE(cacheFile.GetSubmeshes().empty());
+    }
+
+}
@@ -0,0 +1,296 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/FileFormat/Mesh/ObjMaterialLibraryCache.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <chrono>
+#include <fstream>
+#include <type_traits>
+
+namespace Molten
+{
+
+    static void WriteMaterialLibraryTestFile(const std::filesystem::path& filename, const std::string& content)
+    {
+        std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        file << content;
+    }
+
+    static void WriteMaterialLibraryTestObjFile(const std::filesystem::path& filename, const std::string& materialFilename)
+    {
+        std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        file << "mtllib " << materialFilename << " " << materialFilename << "\n";
+        file << "o Object\n";
+        file << "v 0.0 0.0 0.0\n";
+        file << "v 1.0 0.0 0.0\n";
+        file << "v 0.0 1.0 0.0\n";
+        file << "usemtl Red\n";
+        file << "f 1 2 3\n";
+    }
+
+    TEST(FileFormat, ObjMaterialLibraryCache_ReadFromFile)
+    {
+        const std::filesystem::path filename = "ObjMaterialLibraryCacheRead.mtl";
+        WriteMaterialLibraryTestFile(filename,
+            "# Comment\r\n"
+            "newmtl Red # Name comment\r\n"
+            "Ka 0.1\r\n"
+            "Kd 1.0 0.0 0.5\r\n"
+            "Ks spectral curve.rfl\r\n"
+            "Tr 0.25\r\n"
+            "illum 2\r\n"
+            "Pr 0.75\r\n"
+            "map_Kd -clamp on -o 0.5 0.25 -blendu off -s 2 red.png\r\n"
+            "\r\n"
+            "newmtl Blue\r\n"
+            "Ns 300\r\n"
+            "map_Pm blue_metallic.png");
+
+        const auto result = ObjMaterialLibraryCache::ReadFromFile(filename);
+        ASSERT_EQ(result.index(), size_t{ 0 });
+        const auto& materials = *std::get<0>(result);
+        ASSERT_EQ(materials.size(), size_t{ 2 });
+
+        const auto& red = *materials[0];
+        EXPECT_EQ(red.name, "Red");
+        ASSERT_TRUE(red.ambientColor.has_value());
+        EXPECT_EQ(red.ambientColor.value(), Vector3f32(0.1f, 0.1f, 0.1f));
+        ASSERT_TRUE(red.diffuseColor.has_value());
+        EXPECT_EQ(red.diffuseColor.value(), Vector3f32(1.0f, 0.0f, 0.5f));
+        EXPECT_FALSE(red.specularColor.has_value());
+        ASSERT_TRUE(red.transparency.has_value());
+        EXPECT_NEAR(red.transparency.value(), 0.75f, 1e-5f);
+        ASSERT_TRUE(red.roughness.has_value());
+        EXPECT_NEAR(red.roughness.value(), 0.75f, 1e-5f);
+
+        ASSERT_TRUE(red.diffuseTexture.has_value());
+        const auto& texture = red.diffuseTexture.value();
+        EXPECT_EQ(texture.filename, "red.png");
+        ASSERT_TRUE(texture.options.clamp.has_value());
+        EXPECT_TRUE(texture.options.clamp.value());
+        ASSERT_TRUE(texture.options.originOffset.has_value());
+        EXPECT_EQ(texture.options.originOffset.value(), Vector3f32(0.5f, 0.25f, 0.0f));
+        ASSERT_TRUE(texture.options.scale.has_value());
+        EXPECT_EQ(texture.options.scale.value(), Vector3f32(2.0f, 1.0f, 1.0f));
+
+        const auto& blue = *materials[1];
+        EXPECT_EQ(blue.name, "Blue");
+        ASSERT_TRUE(blue.specularWeight.has_value());
+        EXPECT_EQ(blue.specularWeight.value(), 300.0f);
+        ASSERT_TRUE(blue.metallicTexture.has_value());
+        EXPECT_EQ(blue.metallicTexture.value().filename, "blue_metallic.png");
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, ObjMaterialLibraryCache_ReadFromFileError)
+    {
+        const std::filesystem::path filename = "ObjMaterialLibraryCacheError.mtl";
+        {
+            WriteMaterialLibraryTestFile(filename, "Kd 1.0 1.0 1.0\n");
+            const auto result = ObjMaterialLibraryCache::ReadFromFile(filename);
+            ASSERT_EQ(result.index(), size_t{ 1 });
+            EXPECT_EQ(std::get<1>(result).lineNumber, size_t{ 1 });
+        }
+        {
+            WriteMaterialLibraryTestFile(filename, "newmtl Red\n\nKd 1.0 one 1.0\n");
+            const auto result = ObjMaterialLibraryCache::ReadFromFile(filename);
+            ASSERT_EQ(result.index(), size_t{ 1 });
+            EXPECT_EQ(std::get<1>(result).code, TextFileFormatResult::ParseError);
+            EXPECT_EQ(std::get<1>(result).lineNumber, size_t{ 3 });
+        }
+        {
+            std::filesystem::remove(filename);
+            const auto result = ObjMaterialLibraryCache::ReadFromFile(filename);
+            ASSERT_EQ(result.index(), size_t{ 1 });
+            EXPECT_EQ(std::get<1>(result).code, TextFileFormatResult::OpenFileError);
+        }
+    }
+
+    TEST(FileFormat, ObjMaterialLibraryCache_Load)
+    {
+        const std::filesystem::path filename = "ObjMaterialLibraryCacheLoad.mtl";
+        WriteMaterialLibraryTestFile(filename, "newmtl Red\nKd 1.0 0.0 0.0\n");
+
+        ObjMaterialLibraryCache cache;
+        const auto first = cache.Load(filename);
+        ASSERT_EQ(first.index(), size_t{ 0 });
+        EXPECT_EQ(cache.GetLibraryCount(), size_t{ 1 });
+
+        // Different paths of the same file share materials.
+        const auto second = cache.Load(std::filesystem::path{ "." } / filename);
+        ASSERT_EQ(second.index(), size_t{ 0 });
+        EXPECT_EQ(std::get<0>(first), std::get<0>(second));
+        EXPECT_EQ(cache.GetLibraryCount(), size_t{ 1 });
+
+        // Modified files are parsed again.
+        WriteMaterialLibraryTestFile(filename, "newmtl Red\nKd 1.0 0.0 0.0\nnewmtl Blue\n");
+        std::filesystem::last_write_time(filename, std::filesystem::last_write_time(filename) + std::chrono::hours(1));
+
+        const auto modified = cache.Load(filename);
+        ASSERT_EQ(modified.index(), size_t{ 0 });
+        EXPECT_NE(std::get<0>(modified), std::get<0>(first));
+        EXPECT_EQ(std::get<0>(modified)->size(), size_t{ 2 });
+        EXPECT_EQ(std::get<0>(first)->size(), size_t{ 1 });
+
+        cache.Clear();
+        EXPECT_EQ(cache.GetLibraryCount(), size_t{ 0 });
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, ObjMaterialLibraryCache_SharedByReaders)
+    {
+        const std::filesystem::path materialFilename = "ObjMaterialLibraryCacheShared.mtl";
+        const std::filesystem::path firstFilename = "ObjMaterialLibraryCacheSharedFirst.obj";
+        const std::filesystem::path secondFilename = "ObjMaterialLibraryCacheSharedSecond.obj";
+        WriteMaterialLibraryTestFile(materialFilename, "newmtl Red\nKd 1.0 0.0 0.0\n");
+        WriteMaterialLibraryTestObjFile(firstFilename, materialFilename.string());
+        WriteMaterialLibraryTestObjFile(secondFilename, materialFilename.string());
+
+        auto cache = std::make_shared<ObjMaterialLibraryCache>();
+        ThreadPool threadPool;
+
+        ObjMeshFileReader firstReader;
+        EXPECT_EQ(firstReader.GetMaterialLibraryCache(), ObjMaterialLibraryCache::GetShared());
+        firstReader.SetMaterialLibraryCache(cache);
+        ObjMeshFile firstFile;
+        ASSERT_TRUE(firstReader.ReadFromFile(firstFile, firstFilename));
+
+        ObjMeshFileReader secondReader;
+        secondReader.SetMaterialLibraryCache(cache);
+        ObjMeshFile secondFile;
+        ASSERT_TRUE(secondReader.ReadFromFile(secondFile, secondFilename, threadPool));
+
+        // Duplicated file names of a mtllib command are only loaded once.
+        static_assert(std::is_const_v<ObjMeshFile::MaterialSharedPointer::element_type>, "Shared materials must be immutable.");
+        ASSERT_EQ(firstFile.materials.size(), size_t{ 1 });
+        ASSERT_EQ(secondFile.materials.size(), size_t{ 1 });
+        EXPECT_EQ(firstFile.materials[0], secondFile.materials[0]);
+        EXPECT_EQ(firstFile.materials[0]->name, "Red");
+        EXPECT_EQ(cache->GetLibraryCount(), size_t{ 1 });
+
+        // Without cache, materials are parsed by each read.
+        secondReader.SetMaterialLibraryCache(nullptr);
+        ASSERT_TRUE(secondReader.ReadFromFile(secondFile, secondFilename));
+        ASSERT_EQ(secondFile.materials.size(), size_t{ 1 });
+        EXPECT_NE(firstFile.materials[0], secondFile.materials[0]);
+
+        std::filesystem::remove(materialFilename);
+        std::filesystem::remove(firstFilename);
+        std::filesystem::remove(secondFilename);
+    }
+
+    TEST(FileFormat, ObjMaterialLibraryCache_VirtualFileSystem)
+    {
+        const std::filesystem::path directory = "ObjMaterialLibraryCacheVirtual";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        WriteMaterialLibraryTestFile(directory / "red.mtl", "newmtl Red\nKd 1.0 0.0 0.0\n");
+        WriteMaterialLibraryTestObjFile(directory / "first.obj", "red.mtl");
+        WriteMaterialLibraryTestObjFile(directory / "second.obj", "./red.mtl");
+
+        auto fileSystem = std::make_shared<VirtualFileSystem>();
+        ASSERT_TRUE(fileSystem->MountDirectory(directory, "data"));
+
+        auto cache = std::make_shared<ObjMaterialLibraryCache>();
+        ObjMeshFileReader reader;
+        reader.SetMaterialLibraryCache(cache);
+        reader.SetVirtualFileSystem(fileSystem);
+
+        // Material files of virtual file systems are cached by normalized path.
+        ObjMeshFile firstFile;
+        ASSERT_TRUE(reader.ReadFromFile(firstFile, "data/first.obj"));
+        ObjMeshFile secondFile;
+        ASSERT_TRUE(reader.ReadFromFile(secondFile, "data/second.obj"));
+        ASSERT_EQ(firstFile.materials.size(), size_t{ 1 });
+        ASSERT_EQ(secondFile.materials.size(), size_t{ 1 });
+        EXPECT_EQ(firstFile.materials[0], secondFile.materials[0]);
+        EXPECT_EQ(cache->GetLibraryCount(), size_t{ 1 });
+
+        // Modified content of same size is parsed again.
+        WriteMaterialLibraryTestFile(directory / "red.mtl", "newmtl Red\nKd 0.0 1.0 0.0\n");
+        ObjMeshFile modifiedFile;
+        ASSERT_TRUE(reader.ReadFromFile(modifiedFile, "data/first.obj"));
+        ASSERT_EQ(modifiedFile.materials.size(), size_t{ 1 });
+        EXPECT_NE(modifiedFile.materials[0], firstFile.materials[0]);
+        EXPECT_EQ(modifiedFile.materials[0]->diffuseColor, Vector3f32(0.0f, 1.0f, 0.0f));
+        EXPECT_EQ(cache->GetLibraryCount(), size_t{ 1 });
+
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST(FileFormat, ObjMaterialLibraryCache_MissingLibrary)
+    {
+        const std::filesystem::path materialFilename = "ObjMaterialLibraryCacheMissing.mtl";
+        const std::filesystem::path filename = "ObjMaterialLibraryCacheMissing.obj";
+        std::filesystem::remove(materialFilename);
+        WriteMaterialLibraryTestObjFile(filename, materialFilename.string());
+
+        ThreadPool threadPool;
+        ObjMeshFileReader reader;
+        reader.SetMaterialLibraryCache(std::make_shared<ObjMaterialLibraryCache>());
+
+        // Missing material files are skipped.
+        {
+            ObjMeshFile objFile;
+            ASSERT_TRUE(reader.ReadFromFile(objFile, filename));
+            EXPECT_TRUE(objFile.materials.empty());
+            ASSERT_EQ(objFile.objects.size(), size_t{ 1 });
+        }
+        {
+            reader.SetMaterialLibraryCache(nullptr);
+            ObjMeshFile objFile;
+            ASSERT_TRUE(reader.ReadFromFile(objFile, filename, threadPool));
+            EXPECT_TRUE(objFile.materials.empty());
+        }
+        {
+            auto fileSystem = std::make_shared<VirtualFileSystem>();
+            ASSERT_TRUE(fileSystem->MountDirectory("."));
+            reader.SetVirtualFileSystem(fileSystem);
+
+            ObjMeshFile objFile;
+            ASSERT_TRUE(reader.ReadFromFile(objFile, filename.string()));
+            EXPECT_TRUE(objFile.materials.empty());
+            reader.SetVirtualFileSystem(nullptr);
+        }
+
+        // Invalid material files are still errors.
+        {
+            WriteMaterialLibraryTestFile(materialFilename, "Kd 1.0 1.0 1.0\n");
+            ObjMeshFile objFile;
+            const auto result = reader.ReadFromFile(objFile, filename);
+            ASSERT_FALSE(result);
+            EXPECT_EQ(result.GetError().code, TextFileFormatResult::ParseError);
+        }
+
+        std::filesystem::remove(materialFilename);
+        std::filesystem::remove(filename);
+    }
+
+}
@@ -26,6 +26,7 @@
 #include "Test.hpp"
 #include "Molten/System/ThreadPool.hpp"
 #include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include <fstream>
 
 namespace Molten
 {
@@ -50,6 +51,14 @@ namespace Molten
         EXPECT_NO_THROW(result = objFile.ReadFromFile("../Engine/Test/Data/ObjMesh/TestCubes.obj", threadPool));
         ASSERT_TRUE(result.IsSuccessful());
 
+        ASSERT_EQ(objFile.materials.size(), size_t{ 2 });
+        EXPECT_EQ(objFile.materials[0]->name, "Material.001");
+        ASSERT_TRUE(objFile.materials[0]->specularWeight.has_value());
+        EXPECT_NEAR(objFile.materials[0]->specularWeight.value(), 16.5f, 1e-4f);
+        EXPECT_EQ(objFile.materials[1]->name, "Material.002");
+        ASSERT_TRUE(objFile.materials[1]->diffuseColor.has_value());
+        EXPECT_VECTOR3_NEAR(objFile.materials[1]->diffuseColor.value(), Vector3f32(0.8f, 0.8f, 0.8f), 1e-4);
+
         ASSERT_EQ(objFile.objects.size(), size_t{ 3 });
         {
             auto& object = objFile.objects[0];
@@ -253,6 +262,256 @@ namespace Molten
         }
     }
 
+    static void ExpectEqualObjMeshFiles(const ObjMeshFile& lhs, const ObjMeshFile& rhs)
+    {
+        ASSERT_EQ(lhs.objects.size(), rhs.objects.size());
+        for(size_t i = 0; i < lhs.objects.size(); i++)
+        {
+            const auto& lhsObject = *lhs.objects[i];
+            const auto& rhsObject = *rhs.objects[i];
+            EXPECT_EQ(lhsObject.name, rhsObject.name);
+            EXPECT_EQ(lhsObject.vertices, rhsObject.vertices);
+            EXPECT_EQ(lhsObject.normals, rhsObject.normals);
+            EXPECT_EQ(lhsObject.textureCoordinates, rhsObject.textureCoordinates);
+
+            ASSERT_EQ(lhsObject.groups.size(), rhsObject.groups.size());
+            for(size_t j = 0; j < lhsObject.groups.size(); j++)
+            {
+                const auto& lhsGroup = *lhsObject.groups[j];
+                const auto& rhsGroup = *rhsObject.groups[j];
+                EXPECT_EQ(lhsGroup.name, rhsGroup.name);
+                EXPECT_EQ(lhsGroup.material, rhsGroup.material);
+
+                ASSERT_EQ(lhsGroup.smoothingGroups.size(), rhsGroup.smoothingGroups.size());
+                for(size_t k = 0; k < lhsGroup.smoothingGroups.size(); k++)
+                {
+                    const auto& lhsTriangles = lhsGroup.smoothingGroups[k]->triangles;
+                    const auto& rhsTriangles = rhsGroup.smoothingGroups[k]->triangles;
+                    EXPECT_EQ(lhsGroup.smoothingGroups[k]->id, rhsGroup.smoothingGroups[k]->id);
+
+                    ASSERT_EQ(lhsTriangles.size(), rhsTriangles.size());
+                    for(size_t l = 0; l < lhsTriangles.size(); l++)
+                    {
+                        EXPECT_EQ(lhsTriangles[l].vertexIndices, rhsTriangles[l].vertexIndices);
+                        EXPECT_EQ(lhsTriangles[l].textureCoordinateIndices, rhsTriangles[l].textureCoordinateIndices);
+                        EXPECT_EQ(lhsTriangles[l].normalIndices, rhsTriangles[l].normalIndices);
+                    }
+                }
+            }
+        }
+    }
+
+    TEST(FileFormat, ObjMeshFile_InputModes)
+    {
+        const std::filesystem::path filename = "../Engine/Test/Data/ObjMesh/TestCubes.obj";
+        ThreadPool threadPool(2);
+
+        ObjMeshFileReader streamReader;
+        streamReader.SetInputMode(ObjMeshFileReader::InputMode::Stream);
+        EXPECT_EQ(streamReader.GetInputMode(), ObjMeshFileReader::InputMode::Stream);
+
+        ObjMeshFile streamObjFile;
+        ASSERT_TRUE(streamReader.ReadFromFile(streamObjFile, filename, threadPool).IsSuccessful());
+
+        ObjMeshFileReader mappedReader;
+        EXPECT_EQ(mappedReader.GetInputMode(), ObjMeshFileReader::InputMode::MemoryMapped);
+
+        ObjMeshFile mappedObjFile;
+        ASSERT_TRUE(mappedReader.ReadFromFile(mappedObjFile, filename, threadPool).IsSuccessful());
+        ExpectEqualObjMeshFiles(streamObjFile, mappedObjFile);
+
+        ObjMeshFile mappedSingleThreadObjFile;
+        ASSERT_TRUE(mappedReader.ReadFromFile(mappedSingleThreadObjFile, filename).IsSuccessful());
+        ExpectEqualObjMeshFiles(streamObjFile, mappedSingleThreadObjFile);
+
+        ObjMeshFile missingObjFile;
+        const auto result = mappedReader.ReadFromFile(missingObjFile, "../Engine/Test/Data/ObjMesh/ThisFileDoesNotExist.obj");
+        ASSERT_FALSE(result.IsSuccessful());
+        EXPECT_EQ(result.GetError().code, TextFileFormatResult::OpenFileError);
+    }
+
+    static void WriteGridObjMeshFile(const std::filesystem::path& filename, const size_t gridSize, const size_t invalidRow = 0)
+    {
+        std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        file << "o Grid\n";
+
+        for(size_t y = 0; y <= gridSize; y++)
+        {
+            for(size_t x = 0; x <= gridSize; x++)
+            {
+                file << "v " << x << " " << y << " 0\n";
+                file << "vt " << static_cast<float>(x) / gridSize << " " << static_cast<float>(y) / gridSize << "\n";
+            }
+        }
+        file << "vn 0 0 1\n";
+
+        for(size_t y = 0; y < gridSize; y++)
+        {
+            if(y % 7 == 0)
+            {
+                file << "g Row " << y << "\n";
+            }
+            if(y % 5 == 0)
+            {
+                file << "usemtl Material" << (y % 3) << "\n";
+            }
+            if(y % 3 == 0)
+            {
+                file << "s " << (y % 2 == 0 ? "off" : "1") << "\n";
+            }
+            if(invalidRow > 0 && y == invalidRow)
+            {
+                file << "v 1 2 three\n";
+            }
+
+            for(size_t x = 0; x < gridSize; x++)
+            {
+                const auto index = y * (gridSize + 1) + x + 1;
+                const auto nextIndex = index + gridSize + 1;
+                file << "f " << index << "/" << index << "/1 " << index + 1 << "/" << index + 1 << "/1 "
+                    << nextIndex + 1 << "/" << nextIndex + 1 << "/1 " << nextIndex << "/" << nextIndex << "/1\n";
+            }
+        }
+    }
+
+    TEST(FileFormat, ObjMeshFile_ObjectChunks)
+    {
+        const std::filesystem::path filename = "ObjMeshFileObjectChunks.obj";
+        WriteGridObjMeshFile(filename, 64);
+
+        ThreadPool threadPool(4);
+
+        ObjMeshFileReader serialReader;
+        serialReader.SetObjectChunkSize(0);
+        EXPECT_EQ(serialReader.GetObjectChunkSize(), size_t{ 0 });
+
+        ObjMeshFile serialObjFile;
+        ASSERT_TRUE(serialReader.ReadFromFile(serialObjFile, filename, threadPool).IsSuccessful());
+
+        ASSERT_EQ(serialObjFile.objects.size(), size_t{ 1 });
+        EXPECT_EQ(serialObjFile.objects[0]->vertices.size(), size_t{ 65 * 65 });
+        EXPECT_EQ(serialObjFile.objects[0]->groups.size(), size_t{ 21 });
+
+        for(const size_t chunkSize : { size_t{ 1 }, size_t{ 17 }, size_t{ 1000 } })
+        {
+            ObjMeshFileReader chunkReader;
+            chunkReader.SetObjectChunkSize(chunkSize);
+
+            ObjMeshFile chunkObjFile;
+            ASSERT_TRUE(chunkReader.ReadFromFile(chunkObjFile, filename, threadPool).IsSuccessful());
+            ExpectEqualObjMeshFiles(serialObjFile, chunkObjFile);
+        }
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, ObjMeshFile_ObjectChunksError)
+    {
+        const std::filesystem::path filename = "ObjMeshFileObjectChunksError.obj";
+        WriteGridObjMeshFile(filename, 32, 20);
+
+        ThreadPool threadPool(4);
+
+        ObjMeshFileReader serialReader;
+        serialReader.SetObjectChunkSize(0);
+
+        ObjMeshFile serialObjFile;
+        const auto serialResult = serialReader.ReadFromFile(serialObjFile, filename, threadPool);
+        ASSERT_FALSE(serialResult.IsSuccessful());
+
+        ObjMeshFileReader chunkReader;
+        chunkReader.SetObjectChunkSize(10);
+
+        ObjMeshFile chunkObjFile;
+        const auto chunkResult = chunkReader.ReadFromFile(chunkObjFile, filename, threadPool);
+        ASSERT_FALSE(chunkResult.IsSuccessful());
+
+        EXPECT_EQ(chunkResult.GetError().code, TextFileFormatResult::ParseError);
+        EXPECT_EQ(chunkResult.GetError().lineNumber, serialResult.GetError().lineNumber);
+        EXPECT_EQ(chunkResult.GetError().message, serialResult.GetError().message);
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(FileFormat, ObjMeshFile_TrailingComments)
+    {
+        const std::filesystem::path filename = "ObjMeshFileTrailingComments.obj";
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+            file << "# Comment\n";
+            file << "o Object#1\n";
+            file << "v 1.0 2.0 3.0 # Vertex comment\n";
+            file << "v 4.0 5.0 6.0\t#\n";
+            file << "v 7.0 8.0 9.0\n";
+            file << "usemtl Material #25\n";
+            file << "s 1 # Smoothing\n";
+            file << "f 1 2 3 # Face comment\n";
+        }
+
+        ObjMeshFileReader reader;
+        ObjMeshFile objFile;
+        const auto result = reader.ReadFromFile(objFile, filename);
+        std::filesystem::remove(filename);
+        ASSERT_TRUE(result.IsSuccessful());
+
+        ASSERT_EQ(objFile.objects.size(), size_t{ 1 });
+        const auto& object = objFile.objects[0];
+        EXPECT_EQ(object->name, "Object#1");
+
+        ASSERT_EQ(object->vertices.size(), size_t{ 3 });
+        EXPECT_VECTOR3_NEAR(object->vertices[0], Vector3f32(1.0f, 2.0f, 3.0f), 1e-4);
+        EXPECT_VECTOR3_NEAR(object->vertices[1], Vector3f32(4.0f, 5.0f, 6.0f), 1e-4);
+
+        ASSERT_FALSE(object->groups.empty());
+        const auto& group = object->groups.back();
+        EXPECT_EQ(group->material, "Material #25");
+        ASSERT_FALSE(group->smoothingGroups.empty());
+        EXPECT_EQ(group->smoothingGroups.back()->id, uint32_t{ 1 });
+        ASSERT_EQ(group->smoothingGroups.back()->triangles.size(), size_t{ 1 });
+        EXPECT_EQ(group->smoothingGroups.back()->triangles[0].vertexIndices[2], uint32_t{ 3 });
+    }
+
+    TEST(FileFormat, ObjMeshFile_SmoothingGroupState)
+    {
+        const std::filesystem::path filename = "ObjMeshFileSmoothingGroupState.obj";
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+            file << "o Object\n";
+            file << "v 1.0 2.0 3.0\n";
+            file << "v 4.0 5.0 6.0\n";
+            file << "v 7.0 8.0 9.0\n";
+            file << "s 2\n";
+            file << "usemtl First\n";
+            file << "f 1 2 3\n";
+            file << "usemtl Second\n";
+            file << "f 3 2 1\n";
+            file << "g Group\n";
+            file << "f 1 3 2\n";
+        }
+
+        ObjMeshFileReader reader;
+        ObjMeshFile objFile;
+        const auto result = reader.ReadFromFile(objFile, filename);
+        std::filesystem::remove(filename);
+        ASSERT_TRUE(result.IsSuccessful());
+
+        // Smoothing group state is kept across material and group changes.
+        ASSERT_EQ(objFile.objects.size(), size_t{ 1 });
+        size_t triangleCount = 0;
+        for (const auto& group : objFile.objects[0]->groups)
+        {
+            for (const auto& smoothingGroup : group->smoothingGroups)
+            {
+                if (!smoothingGroup->triangles.empty())
+                {
+                    EXPECT_EQ(smoothingGroup->id, uint32_t{ 2 });
+                    triangleCount += smoothingGroup->triangles.size();
+                }
+            }
+        }
+        EXPECT_EQ(triangleCount, size_t{ 3 });
+    }
+
    /* TEST(FileFormat, ObjMeshFile_Benchmark)
     {
         ThreadPool threadPool;
@@ -263,4 +522,59 @@ namespace Molten
         EXPECT_TRUE(result.IsSuccessful());
     }*/
 
-}
\ No newline at end of file
+    TEST(FileFormat, ObjMeshFile_Stream)
+    {
+        const std::filesystem::path filename = "ObjMeshFileStream.obj";
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+            size_t vertexOffset = 0;
+            for(size_t i = 0; i < 24; i++)
+            {
+                file << "o Object" << i << "\n";
+                for(size_t j = 0; j < 300; j++)
+                {
+                    file << "v " << i << " " << j << " 0.5\n";
+                }
+                file << "usemtl Material" << (i % 3) << "\n";
+                for(size_t j = 1; j + 1 < 300; j++)
+                {
+                    file << "f " << vertexOffset + 1 << " " << vertexOffset + j + 1 << " " << vertexOffset + j + 2 << "\n";
+                }
+                vertexOffset += 300;
+            }
+        }
+
+        ThreadPool threadPool(2);
+
+        for(const auto inputMode : { ObjMeshFileReader::InputMode::Stream, ObjMeshFileReader::InputMode::MemoryMapped })
+        {
+            ObjMeshFileReader reader;
+            reader.SetInputMode(inputMode);
+
+            ObjMeshFile expectedObjFile;
+            ASSERT_TRUE(reader.ReadFromFile(expectedObjFile, filename).IsSuccessful());
+            ASSERT_EQ(expectedObjFile.objects.size(), size_t{ 24 });
+
+            for(auto* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+            {
+                ObjMeshFile streamedObjFile;
+                ObjMeshFile objects;
+                auto onObject = [&](ObjMeshFile::ObjectSharedPointer object)
+                {
+                    objects.objects.push_back(std::move(object));
+                };
+
+                const auto result = pool ?
+                    reader.StreamFromFile(streamedObjFile, filename, *pool, onObject) :
+                    reader.StreamFromFile(streamedObjFile, filename, onObject);
+                ASSERT_TRUE(result.IsSuccessful());
+
+                EXPECT_TRUE(streamedObjFile.objects.empty());
+                ExpectEqualObjMeshFiles(expectedObjFile, objects);
+            }
+        }
+
+        std::filesystem::remove(filename);
+    }
+
+}
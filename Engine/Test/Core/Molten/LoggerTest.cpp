@@ -26,7 +26,13 @@
 #include "Test.hpp"
 #include "Molten/System/FileSystem.hpp"
 #include "Molten/Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 #if MOLTEN_PLATFORM == MOLTEN_PLATFORM_WINDOWS
 
@@ -60,4 +66,217 @@ namespace Molten
 
 }
 
-#endif
\ No newline at end of file
+#endif
+
+
+namespace Molten
+{
+
+    TEST(Core, Logger_StringView)
+    {
+        std::vector<std::string> messages;
+        Logger logger([&](const Logger::Severity, const char* message) { messages.emplace_back(message); });
+
+        const std::string_view message = "First message, not null terminated";
+        logger.Write(Logger::Severity::Info, message.substr(0, 5));
+        Logger::WriteError(&logger, message.substr(6, 7));
+        Logger::WriteError(nullptr, message);
+
+        ASSERT_EQ(messages.size(), size_t{ 2 });
+        EXPECT_EQ(messages[0], "First");
+        EXPECT_EQ(messages[1], "message");
+    }
+
+    TEST(Core, Logger_Async)
+    {
+        std::vector<std::pair<Logger::Severity, std::string>> messages;
+        std::thread::id callbackThreadId;
+        Logger logger([&](const Logger::Severity severity, const char* message)
+        {
+            callbackThreadId = std::this_thread::get_id();
+            messages.emplace_back(severity, message);
+        },
+        static_cast<uint32_t>(Logger::Severity::Info) | static_cast<uint32_t>(Logger::Severity::Warning));
+
+        logger.EnableAsync(1024 * 1024);
+        EXPECT_TRUE(logger.IsAsync());
+
+        const size_t threadCount = 4;
+        const size_t messageCount = 1000;
+        std::vector<std::thread> threads;
+        for(size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([&, i]()
+            {
+                for(size_t j = 0; j < messageCount; j++)
+                {
+                    Logger::WriteInfo(&logger, std::to_string(i) + " " + std::to_string(j));
+                    Logger::WriteDebug(&logger, "Filtered");
+                }
+            });
+        }
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        logger.Write(Logger::Severity::Warning, "Last");
+        logger.Flush();
+
+        ASSERT_EQ(messages.size(), threadCount * messageCount + 1);
+        EXPECT_NE(callbackThreadId, std::this_thread::get_id());
+        EXPECT_EQ(logger.GetDroppedMessageCount(), uint64_t{ 0 });
+        EXPECT_EQ(messages.back().first, Logger::Severity::Warning);
+        EXPECT_EQ(messages.back().second, "Last");
+
+        // Order is kept per writing thread.
+        std::vector<size_t> nextMessages(threadCount, 0);
+        for(size_t i = 0; i < messages.size() - 1; i++)
+        {
+            const auto& [severity, message] = messages[i];
+            EXPECT_EQ(severity, Logger::Severity::Info);
+
+            const auto separator = message.find(' ');
+            ASSERT_NE(separator, std::string::npos);
+            const auto threadIndex = std::stoul(message.substr(0, separator));
+            ASSERT_LT(threadIndex, threadCount);
+            EXPECT_EQ(std::stoul(message.substr(separator + 1)), nextMessages[threadIndex]++);
+        }
+
+        logger.DisableAsync();
+        EXPECT_FALSE(logger.IsAsync());
+
+        logger.Write(Logger::Severity::Info, "Synchronous");
+        ASSERT_EQ(messages.size(), threadCount * messageCount + 2);
+        EXPECT_EQ(callbackThreadId, std::this_thread::get_id());
+    }
+
+    TEST(Core, Logger_AsyncDrop)
+    {
+        std::atomic_bool blocking = false;
+        std::atomic_bool released = false;
+        std::vector<std::string> messages;
+        Logger logger([&](const Logger::Severity, const char* message)
+        {
+            blocking = true;
+            while(!released)
+            {
+                std::this_thread::yield();
+            }
+            messages.emplace_back(message);
+        });
+
+        logger.EnableAsync(256);
+        logger.Write(Logger::Severity::Info, "First");
+        while(!blocking)
+        {
+            std::this_thread::yield();
+        }
+
+        // Messages longer than half of the buffer are truncated, and messages not fitting in the buffer are dropped.
+        const std::string longMessage(1000, 'a');
+        const size_t messageCount = 100;
+        for(size_t i = 0; i < messageCount; i++)
+        {
+            logger.Write(Logger::Severity::Info, longMessage);
+        }
+
+        const auto droppedCount = logger.GetDroppedMessageCount();
+        EXPECT_GT(droppedCount, uint64_t{ 0 });
+
+        released = true;
+        logger.Flush();
+
+        // Dropped messages are reported as a warning.
+        auto droppedIt = std::find_if(messages.begin(), messages.end(), [](const std::string& message)
+        {
+            return message.find("Dropped ") != std::string::npos;
+        });
+        ASSERT_NE(droppedIt, messages.end());
+        EXPECT_NE(droppedIt->find("Dropped " + std::to_string(droppedCount) + " "), std::string::npos);
+        messages.erase(droppedIt);
+
+        ASSERT_EQ(messages.size(), messageCount + 1 - droppedCount);
+        EXPECT_EQ(messages.front(), "First");
+        for(size_t i = 1; i < messages.size(); i++)
+        {
+            EXPECT_LT(messages[i].size(), size_t{ 128 });
+            EXPECT_EQ(messages[i], longMessage.substr(0, messages[i].size()));
+        }
+    }
+
+    TEST(Core, Logger_AsyncExitedThreads)
+    {
+        std::atomic<size_t> messageCount = 0;
+        Logger logger([&](const Logger::Severity, const char*)
+        {
+            ++messageCount;
+        });
+
+        logger.EnableAsync(4096, Milliseconds(1));
+
+        const size_t threadCount = 8;
+        for(size_t i = 0; i < threadCount; i++)
+        {
+            std::thread([&]() { logger.Write(Logger::Severity::Info, "Exiting thread"); }).join();
+        }
+        logger.Flush();
+        EXPECT_EQ(messageCount.load(), threadCount);
+
+        // Buffers of exited threads are released by the background thread.
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(logger.GetAsyncBufferCount() > 0 && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(logger.GetAsyncBufferCount(), size_t{ 0 });
+
+        logger.Write(Logger::Severity::Info, "Current thread");
+        EXPECT_EQ(logger.GetAsyncBufferCount(), size_t{ 1 });
+        logger.DisableAsync();
+        EXPECT_EQ(messageCount.load(), threadCount + 1);
+    }
+
+    TEST(Core, FileLogger_Async)
+    {
+        const std::filesystem::path logFilename = "FileLoggerAsyncTest.txt";
+        std::filesystem::remove(logFilename);
+
+        {
+            FileLogger logger(logFilename.string(), FileLogger::OpenMode::Truncate);
+            ASSERT_TRUE(logger.IsOpen());
+            logger.EnableAsync();
+
+            logger.Write(Logger::Severity::Info, "Test info message.");
+            logger.Write(Logger::Severity::Error, std::string{ "Test error message." });
+            logger.Flush();
+
+            std::ifstream file(logFilename);
+            std::string line;
+            std::getline(file, line);
+            EXPECT_EQ(line, "[Info] - Test info message.");
+            std::getline(file, line);
+            EXPECT_EQ(line, "[Error] - Test error message.");
+
+            // Destruction writes remaining messages.
+            logger.Write(Logger::Severity::Warning, "Test warning message.");
+        }
+
+        {
+            std::ifstream file(logFilename);
+            std::string line;
+            std::string lastLine;
+            size_t lineCount = 0;
+            while(std::getline(file, line))
+            {
+                lastLine = line;
+                ++lineCount;
+            }
+            EXPECT_EQ(lastLine, "[Warning] - Test warning message.");
+            EXPECT_EQ(lineCount, size_t{ 3 });
+        }
+
+        std::filesystem::remove(logFilename);
+    }
+
+}
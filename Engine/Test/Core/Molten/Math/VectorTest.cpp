@@ -474,6 +474,11 @@ namespace Molten
             EXPECT_EQ(Vector3i32(0, 0, 6) - Vector3i32(0, 10, 1), Vector3i32(0, -10, 5));
             EXPECT_EQ(Vector3i32(0, 0, 10) - Vector3i32(10, -10, -10), Vector3i32(-10, 10, 20));
         }
+        {
+            Vector3i32 vec(100, 200, 300);
+            vec /= int32_t{ 4 };
+            EXPECT_EQ(vec, Vector3i32(25, 50, 75));
+        }
         {
             EXPECT_FALSE(Vector3i32(100, 200, 300) != Vector3i32(100, 200, 300));
             EXPECT_TRUE(Vector3i32(101, 200, 300) != Vector3i32(100, 200, 300));
@@ -0,0 +1,188 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/Memory/FrameAllocator.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <set>
+
+namespace Molten
+{
+
+    TEST(Memory, LinearAllocator)
+    {
+        LinearAllocator allocator(256);
+        EXPECT_EQ(allocator.GetCapacity(), size_t{ 256 });
+        EXPECT_EQ(allocator.GetBlockCount(), size_t{ 1 });
+        EXPECT_EQ(allocator.GetUsedSize(), size_t{ 0 });
+
+        auto* a = allocator.AllocateArray<uint8_t>(3);
+        auto* b = allocator.AllocateArray<uint64_t>(2);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(uint64_t), uintptr_t{ 0 });
+        EXPECT_GE(reinterpret_cast<uint8_t*>(b), a + 3);
+        EXPECT_GE(allocator.GetUsedSize(), size_t{ 19 });
+
+        auto* aligned = allocator.Allocate(16, 64);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, uintptr_t{ 0 });
+
+        struct Point { int32_t x; int32_t y; };
+        auto* point = allocator.New<Point>(Point{ 1, 2 });
+        EXPECT_EQ(point->x, 1);
+        EXPECT_EQ(point->y, 2);
+    }
+
+    TEST(Memory, LinearAllocator_GrowAndReset)
+    {
+        LinearAllocator allocator(128);
+
+        for(size_t i = 0; i < 10; i++)
+        {
+            [[maybe_unused]] auto* data = allocator.Allocate(100);
+        }
+        [[maybe_unused]] auto* large = allocator.Allocate(1000);
+        EXPECT_GT(allocator.GetBlockCount(), size_t{ 1 });
+
+        const auto capacity = allocator.GetCapacity();
+        EXPECT_GE(capacity, size_t{ 2000 });
+
+        // Blocks are merged at reset, so the same workload fits in a single block.
+        allocator.Reset();
+        EXPECT_EQ(allocator.GetBlockCount(), size_t{ 1 });
+        EXPECT_EQ(allocator.GetCapacity(), capacity);
+        EXPECT_EQ(allocator.GetUsedSize(), size_t{ 0 });
+
+        for (size_t i = 0; i < 10; i++)
+        {
+            [[maybe_unused]] auto* data = allocator.Allocate(100);
+        }
+        large = allocator.Allocate(1000);
+        EXPECT_EQ(allocator.GetBlockCount(), size_t{ 1 });
+    }
+
+    TEST(Memory, LinearAllocator_ScratchVector)
+    {
+        LinearAllocator allocator(64);
+
+        ScratchVector<uint32_t> values{ ScratchAllocator<uint32_t>{ allocator } };
+        for(uint32_t i = 0; i < 1000; i++)
+        {
+            values.push_back(i);
+        }
+
+        ASSERT_EQ(values.size(), size_t{ 1000 });
+        for (uint32_t i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(values[i], i);
+        }
+        EXPECT_GE(allocator.GetUsedSize(), sizeof(uint32_t) * 1000);
+    }
+
+    TEST(Memory, FrameAllocator)
+    {
+        FrameAllocator frameAllocator(1024);
+
+        auto& allocator1 = frameAllocator.GetThreadAllocator();
+        auto& allocator2 = frameAllocator.GetThreadAllocator();
+        EXPECT_EQ(&allocator1, &allocator2);
+        EXPECT_EQ(frameAllocator.GetThreadAllocatorCount(), size_t{ 1 });
+
+        LinearAllocator* otherThreadAllocator = nullptr;
+        std::thread thread([&]()
+        {
+            otherThreadAllocator = &frameAllocator.GetThreadAllocator();
+            [[maybe_unused]] auto* data = frameAllocator.Allocate(100);
+        });
+        thread.join();
+
+        EXPECT_NE(otherThreadAllocator, &allocator1);
+        EXPECT_EQ(frameAllocator.GetThreadAllocatorCount(), size_t{ 2 });
+
+        [[maybe_unused]] auto* data = frameAllocator.Allocate(100);
+        EXPECT_GE(frameAllocator.GetUsedSize(), size_t{ 200 });
+
+        frameAllocator.Reset();
+        EXPECT_EQ(frameAllocator.GetUsedSize(), size_t{ 0 });
+
+        { // Another frame allocator on the same thread has its own linear allocators.
+            FrameAllocator frameAllocator2(1024);
+            EXPECT_NE(&frameAllocator2.GetThreadAllocator(), &allocator1);
+        }
+        EXPECT_EQ(&frameAllocator.GetThreadAllocator(), &allocator1);
+    }
+
+    TEST(Memory, FrameAllocator_ThreadPool)
+    {
+        EXPECT_EQ(ThreadPool::GetScratchAllocator(), nullptr);
+
+        FrameAllocator frameAllocator;
+
+        ThreadPoolDescriptor descriptor;
+        descriptor.threadCount = 2;
+        descriptor.frameAllocator = &frameAllocator;
+        ThreadPool pool(descriptor);
+
+        for(size_t frame = 0; frame < 3; frame++)
+        {
+            std::vector<std::future<size_t>> results;
+            for(size_t i = 0; i < 8; i++)
+            {
+                results.push_back(pool.Execute(ThreadPool::Priority::FrameCritical, [i]()
+                {
+                    auto* scratchAllocator = ThreadPool::GetScratchAllocator();
+                    if(!scratchAllocator)
+                    {
+                        return size_t{ 0 };
+                    }
+
+                    ScratchVector<size_t> values{ ScratchAllocator<size_t>{ *scratchAllocator } };
+                    for(size_t j = 0; j <= i; j++)
+                    {
+                        values.push_back(j);
+                    }
+
+                    size_t sum = 0;
+                    for(auto value : values)
+                    {
+                        sum += value;
+                    }
+                    return sum;
+                }));
+            }
+
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                EXPECT_EQ(results[i].get(), (i * (i + 1)) / 2);
+            }
+
+            EXPECT_GT(frameAllocator.GetUsedSize(), size_t{ 0 });
+            frameAllocator.Reset();
+        }
+
+        EXPECT_EQ(frameAllocator.GetThreadAllocatorCount(), size_t{ 2 });
+    }
+
+}
@@ -0,0 +1,263 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Mesh/IndexedMeshBuilder.hpp"
+#include "Molten/FileFormat/Mesh/ObjMeshFile.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <cmath>
+
+namespace Molten
+{
+
+    static ObjMeshFile::Triangle CreateObjTriangle(
+        const std::array<uint32_t, 3>& vertexIndices,
+        const std::array<uint32_t, 3>& textureCoordinateIndices,
+        const std::array<uint32_t, 3>& normalIndices)
+    {
+        ObjMeshFile::Triangle triangle;
+        triangle.vertexIndices = vertexIndices;
+        triangle.textureCoordinateIndices = textureCoordinateIndices;
+        triangle.normalIndices = normalIndices;
+        return triangle;
+    }
+
+    static void AddObjGroup(
+        ObjMeshFile::Object& object,
+        const std::string& material,
+        ObjMeshFile::Triangles triangles,
+        const uint32_t smoothingGroupId = 0)
+    {
+        auto group = std::make_shared<ObjMeshFile::Group>();
+        group->material = material;
+
+        auto smoothingGroup = std::make_shared<ObjMeshFile::SmoothingGroup>();
+        smoothingGroup->id = smoothingGroupId;
+        smoothingGroup->triangles = std::move(triangles);
+        group->smoothingGroups.push_back(smoothingGroup);
+
+        object.groups.push_back(group);
+    }
+
+    static ObjMeshFile CreateIndexedTestObjMeshFile()
+    {
+        ObjMeshFile objMeshFile;
+
+        auto quad = std::make_shared<ObjMeshFile::Object>();
+        quad->name = "Quad";
+        quad->vertices = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+        quad->textureCoordinates = { { 0.0f, 0.0f }, { 1.0f, 1.0f } };
+        quad->normals = { { 0.0f, 0.0f, 1.0f } };
+        AddObjGroup(*quad, "Red", {
+            CreateObjTriangle({ 1, 2, 3 }, { 1, 1, 1 }, { 1, 1, 1 }),
+            CreateObjTriangle({ 1, 3, 4 }, { 1, 1, 1 }, { 1, 1, 1 }) });
+        AddObjGroup(*quad, "Blue", {
+            CreateObjTriangle({ 1, 2, 3 }, { 2, 2, 2 }, { 1, 1, 1 }) });
+        AddObjGroup(*quad, "Red", {
+            CreateObjTriangle({ 3, 2, 1 }, { 1, 1, 1 }, { 1, 1, 1 }) });
+        objMeshFile.objects.push_back(quad);
+
+        // Face indices are global and may reference vertices of preceding objects.
+        auto triangle = std::make_shared<ObjMeshFile::Object>();
+        triangle->name = "Triangle";
+        triangle->vertices = { { 5.0f, 0.0f, 0.0f }, { 6.0f, 0.0f, 0.0f } };
+        triangle->normals = { { 0.0f, 1.0f, 0.0f } };
+        AddObjGroup(*triangle, "", {
+            CreateObjTriangle({ 5, 6, 1 }, { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF }, { 2, 2, 2 }) });
+        objMeshFile.objects.push_back(triangle);
+
+        return objMeshFile;
+    }
+
+    static void ExpectIndexedTestMeshes(const IndexedMeshes& meshes)
+    {
+        ASSERT_EQ(meshes.size(), size_t{ 2 });
+
+        const auto& quad = meshes[0];
+        EXPECT_STREQ(quad.name.c_str(), "Quad");
+        ASSERT_EQ(quad.submeshes.size(), size_t{ 2 });
+
+        const auto& red = quad.submeshes[0];
+        EXPECT_STREQ(red.material.c_str(), "Red");
+        EXPECT_EQ(red.vertices.size(), size_t{ 4 });
+        EXPECT_EQ(red.indexDataType, IndexBuffer::DataType::Uint16);
+        EXPECT_EQ(red.GetIndices(), (std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3, 2, 1, 0 }));
+        EXPECT_EQ(red.vertices[2].position, (Vector3f32{ 1.0f, 1.0f, 0.0f }));
+        EXPECT_EQ(red.vertices[2].normal, (Vector3f32{ 0.0f, 0.0f, 1.0f }));
+        EXPECT_EQ(red.vertices[2].textureCoordinate, (Vector2f32{ 0.0f, 0.0f }));
+
+        const auto& blue = quad.submeshes[1];
+        EXPECT_STREQ(blue.material.c_str(), "Blue");
+        EXPECT_EQ(blue.vertices.size(), size_t{ 3 });
+        EXPECT_EQ(blue.GetIndices(), (std::vector<uint32_t>{ 0, 1, 2 }));
+        EXPECT_EQ(blue.vertices[0].textureCoordinate, (Vector2f32{ 1.0f, 1.0f }));
+
+        const auto& triangle = meshes[1];
+        EXPECT_STREQ(triangle.name.c_str(), "Triangle");
+        ASSERT_EQ(triangle.submeshes.size(), size_t{ 1 });
+
+        const auto& white = triangle.submeshes[0];
+        EXPECT_TRUE(white.material.empty());
+        ASSERT_EQ(white.vertices.size(), size_t{ 3 });
+        EXPECT_EQ(white.vertices[0].position, (Vector3f32{ 5.0f, 0.0f, 0.0f }));
+        EXPECT_EQ(white.vertices[1].position, (Vector3f32{ 6.0f, 0.0f, 0.0f }));
+        EXPECT_EQ(white.vertices[2].position, (Vector3f32{ 0.0f, 0.0f, 0.0f }));
+        EXPECT_EQ(white.vertices[2].normal, (Vector3f32{ 0.0f, 1.0f, 0.0f }));
+        EXPECT_EQ(white.vertices[2].textureCoordinate, (Vector2f32{ 0.0f, 0.0f }));
+    }
+
+    TEST(Mesh, IndexedMeshBuilder_ObjMeshFile)
+    {
+        const auto objMeshFile = CreateIndexedTestObjMeshFile();
+
+        {
+            auto result = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            ExpectIndexedTestMeshes(result.Value());
+        }
+        {
+            ThreadPool threadPool;
+            auto result = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile, &threadPool);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            ExpectIndexedTestMeshes(result.Value());
+        }
+    }
+
+    TEST(Mesh, IndexedMeshBuilder_ObjMeshFileError)
+    {
+        {
+            auto objMeshFile = CreateIndexedTestObjMeshFile();
+            objMeshFile.objects[1]->groups[0]->smoothingGroups[0]->triangles[0].vertexIndices[1] = 7;
+
+            const auto result = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile);
+            ASSERT_FALSE(result.IsValid());
+            EXPECT_STREQ(result.Error().c_str(), "Object \"Triangle\": Face vertex index 7 is out of range");
+        }
+        {
+            auto objMeshFile = CreateIndexedTestObjMeshFile();
+            objMeshFile.objects[0]->groups[1]->smoothingGroups[0]->triangles[0].normalIndices[0] = 3;
+
+            const auto result = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile);
+            ASSERT_FALSE(result.IsValid());
+            EXPECT_STREQ(result.Error().c_str(), "Object \"Quad\": Face normal index 3 is out of range");
+        }
+    }
+
+    TEST(Mesh, IndexedMeshBuilder_ObjMeshFileSmoothingGroups)
+    {
+        static constexpr uint32_t unused = 0xFFFFFFFF;
+
+        // Roof of two slopes without normals, smoothed across materials, and a flat shaded gable.
+        ObjMeshFile objMeshFile;
+        auto roof = std::make_shared<ObjMeshFile::Object>();
+        roof->name = "Roof";
+        roof->vertices = {
+            { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }, { 2.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 1.0f }
+        };
+        AddObjGroup(*roof, "Left", {
+            CreateObjTriangle({ 1, 2, 3 }, { unused, unused, unused }, { unused, unused, unused }),
+            CreateObjTriangle({ 3, 2, 4 }, { unused, unused, unused }, { unused, unused, unused }) }, 1);
+        AddObjGroup(*roof, "Right", {
+            CreateObjTriangle({ 3, 4, 5 }, { unused, unused, unused }, { unused, unused, unused }),
+            CreateObjTriangle({ 5, 4, 6 }, { unused, unused, unused }, { unused, unused, unused }) }, 1);
+        AddObjGroup(*roof, "Left", {
+            CreateObjTriangle({ 1, 5, 3 }, { unused, unused, unused }, { unused, unused, unused }) }, 0);
+        objMeshFile.objects.push_back(roof);
+
+        auto expectMeshes = [](const IndexedMeshes& meshes)
+        {
+            ASSERT_EQ(meshes.size(), size_t{ 1 });
+            ASSERT_EQ(meshes[0].submeshes.size(), size_t{ 2 });
+
+            // Smooth vertices are welded, flat shaded vertices are not.
+            const auto& left = meshes[0].submeshes[0];
+            ASSERT_EQ(left.vertices.size(), size_t{ 7 });
+            EXPECT_EQ(left.GetIndices(), (std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3, 4, 5, 6 }));
+
+            const auto slope = 1.0f / std::sqrt(2.0f);
+            EXPECT_NEAR(left.vertices[0].normal.x, -slope, 1.0e-5f);
+            EXPECT_NEAR(left.vertices[0].normal.y, slope, 1.0e-5f);
+            EXPECT_NEAR(left.vertices[2].normal.x, 0.0f, 1.0e-5f);
+            EXPECT_NEAR(left.vertices[2].normal.y, 1.0f, 1.0e-5f);
+            for (size_t i = 4; i < 7; i++)
+            {
+                EXPECT_EQ(left.vertices[i].normal, (Vector3f32{ 0.0f, 0.0f, 1.0f }));
+            }
+
+            const auto& right = meshes[0].submeshes[1];
+            ASSERT_EQ(right.vertices.size(), size_t{ 4 });
+            EXPECT_EQ(right.vertices[0].position, (Vector3f32{ 1.0f, 1.0f, 0.0f }));
+            EXPECT_NEAR(right.vertices[0].normal.x, 0.0f, 1.0e-5f);
+            EXPECT_NEAR(right.vertices[0].normal.y, 1.0f, 1.0e-5f);
+            EXPECT_NEAR(right.vertices[2].normal.x, slope, 1.0e-5f);
+            EXPECT_NEAR(right.vertices[2].normal.y, slope, 1.0e-5f);
+
+            for (const auto& vertex : left.vertices)
+            {
+                EXPECT_NEAR(vertex.normal.Dot(Vector3f32{ vertex.tangent.x, vertex.tangent.y, vertex.tangent.z }), 0.0f, 1.0e-5f);
+            }
+        };
+
+        {
+            auto result = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            expectMeshes(result.Value());
+        }
+        {
+            ThreadPool threadPool;
+            auto result = IndexedMeshBuilder::BuildFromObjMeshFile(objMeshFile, &threadPool);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            expectMeshes(result.Value());
+        }
+    }
+
+    TEST(Mesh, IndexedSubmesh_Indices)
+    {
+        IndexedSubmesh submesh;
+        submesh.vertices.resize(3);
+
+        submesh.SetIndices({ 0, 1, 2, 65535 });
+        EXPECT_EQ(submesh.indexDataType, IndexBuffer::DataType::Uint16);
+        EXPECT_EQ(submesh.indexData.size(), size_t{ 8 });
+        EXPECT_EQ(submesh.GetIndex(3), uint32_t{ 65535 });
+
+        submesh.SetIndices({ 0, 1, 2, 65536 });
+        EXPECT_EQ(submesh.indexDataType, IndexBuffer::DataType::Uint32);
+        EXPECT_EQ(submesh.indexData.size(), size_t{ 16 });
+        EXPECT_EQ(submesh.GetIndices(), (std::vector<uint32_t>{ 0, 1, 2, 65536 }));
+
+        const auto vertexDescriptor = submesh.GetVertexBufferDescriptor();
+        EXPECT_EQ(vertexDescriptor.vertexCount, uint32_t{ 3 });
+        EXPECT_EQ(vertexDescriptor.vertexSize, uint32_t{ 48 });
+        EXPECT_EQ(vertexDescriptor.data, submesh.vertices.data());
+
+        const auto indexDescriptor = submesh.GetIndexBufferDescriptor();
+        EXPECT_EQ(indexDescriptor.indexCount, uint32_t{ 4 });
+        EXPECT_EQ(indexDescriptor.data, submesh.indexData.data());
+        EXPECT_EQ(indexDescriptor.dataType, IndexBuffer::DataType::Uint32);
+    }
+
+}
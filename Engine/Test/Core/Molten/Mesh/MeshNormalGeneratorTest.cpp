@@ -0,0 +1,165 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Mesh/MeshNormalGenerator.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <cmath>
+
+namespace Molten
+{
+
+    static void ExpectNearVector(const Vector3f32& value, const Vector3f32& expected)
+    {
+        EXPECT_NEAR(value.x, expected.x, 1.0e-5f);
+        EXPECT_NEAR(value.y, expected.y, 1.0e-5f);
+        EXPECT_NEAR(value.z, expected.z, 1.0e-5f);
+    }
+
+    static IndexedMeshVertex CreateTangentTestVertex(const Vector3f32& position, const Vector2f32& textureCoordinate)
+    {
+        return IndexedMeshVertex{ position, { 0.0f, 0.0f, 1.0f }, textureCoordinate };
+    }
+
+    TEST(Mesh, MeshNormalGenerator_SmoothNormals)
+    {
+        // Roof of two slopes, meeting at the ridge, where normals are averaged.
+        const std::vector<Vector3f32> positions = {
+            { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }, { 2.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 1.0f }
+        };
+        const std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5 };
+
+        const auto normals = MeshNormalGenerator::GenerateSmoothNormals(positions, indices);
+        ASSERT_EQ(normals.size(), positions.size());
+
+        const auto slope = 1.0f / std::sqrt(2.0f);
+        ExpectNearVector(normals[0], { -slope, slope, 0.0f });
+        ExpectNearVector(normals[2], { 0.0f, 1.0f, 0.0f });
+        ExpectNearVector(normals[3], { 0.0f, 1.0f, 0.0f });
+        ExpectNearVector(normals[5], { slope, slope, 0.0f });
+
+        ExpectNearVector(MeshNormalGenerator::CalculateTriangleNormal(positions[0], positions[0], positions[1]), { 0.0f, 0.0f, 0.0f });
+    }
+
+    TEST(Mesh, MeshNormalGenerator_Tangents)
+    {
+        IndexedMeshVertices vertices = {
+            CreateTangentTestVertex({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }),
+            CreateTangentTestVertex({ 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f }),
+            CreateTangentTestVertex({ 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f }),
+            CreateTangentTestVertex({ 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f })
+        };
+        std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+
+        MeshNormalGenerator::GenerateTangents(vertices, indices);
+        ASSERT_EQ(vertices.size(), size_t{ 4 });
+        EXPECT_EQ(indices, (std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3 }));
+
+        for (const auto& vertex : vertices)
+        {
+            ExpectNearVector({ vertex.tangent.x, vertex.tangent.y, vertex.tangent.z }, { 1.0f, 0.0f, 0.0f });
+            EXPECT_EQ(vertex.tangent.w, 1.0f);
+
+            // Reconstructed bitangent follows the v axis of texture space.
+            const auto bitangent = vertex.normal.Cross(Vector3f32{ vertex.tangent.x, vertex.tangent.y, vertex.tangent.z }) * vertex.tangent.w;
+            ExpectNearVector(bitangent, { 0.0f, 1.0f, 0.0f });
+        }
+    }
+
+    TEST(Mesh, MeshNormalGenerator_TangentsMirrored)
+    {
+        // Right half of the quad mirrors the texture coordinates of the left half, around the center line.
+        IndexedMeshVertices vertices = {
+            CreateTangentTestVertex({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }),
+            CreateTangentTestVertex({ 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f }),
+            CreateTangentTestVertex({ 1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f }),
+            CreateTangentTestVertex({ 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f }),
+            CreateTangentTestVertex({ 2.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }),
+            CreateTangentTestVertex({ 2.0f, 1.0f, 0.0f }, { 0.0f, 1.0f })
+        };
+        std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3, 1, 4, 5, 1, 5, 2 };
+
+        MeshNormalGenerator::GenerateTangents(vertices, indices);
+
+        // Center line vertices are split.
+        ASSERT_EQ(vertices.size(), size_t{ 8 });
+        EXPECT_EQ(indices, (std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3, 6, 4, 5, 6, 5, 7 }));
+        EXPECT_EQ(vertices[6].position, vertices[1].position);
+        EXPECT_EQ(vertices[7].position, vertices[2].position);
+
+        for (const size_t i : { 0, 1, 2, 3 })
+        {
+            ExpectNearVector({ vertices[i].tangent.x, vertices[i].tangent.y, vertices[i].tangent.z }, { 1.0f, 0.0f, 0.0f });
+            EXPECT_EQ(vertices[i].tangent.w, 1.0f);
+        }
+        for (const size_t i : { 4, 5, 6, 7 })
+        {
+            ExpectNearVector({ vertices[i].tangent.x, vertices[i].tangent.y, vertices[i].tangent.z }, { -1.0f, 0.0f, 0.0f });
+            EXPECT_EQ(vertices[i].tangent.w, -1.0f);
+
+            const auto bitangent = vertices[i].normal.Cross(Vector3f32{ vertices[i].tangent.x, vertices[i].tangent.y, vertices[i].tangent.z }) * vertices[i].tangent.w;
+            ExpectNearVector(bitangent, { 0.0f, 1.0f, 0.0f });
+        }
+    }
+
+    TEST(Mesh, MeshNormalGenerator_TangentsParallel)
+    {
+        IndexedMeshes meshes(2);
+        for (auto& mesh : meshes)
+        {
+            auto& submesh = mesh.submeshes.emplace_back();
+            submesh.vertices = {
+                CreateTangentTestVertex({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }),
+                CreateTangentTestVertex({ 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f }),
+                CreateTangentTestVertex({ 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f }),
+                CreateTangentTestVertex({ 5.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }),
+                CreateTangentTestVertex({ 6.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }),
+                CreateTangentTestVertex({ 5.0f, 1.0f, 0.0f }, { 0.0f, 0.0f })
+            };
+            submesh.SetIndices({ 0, 1, 2, 3, 4, 5 });
+        }
+
+        ThreadPool threadPool;
+        MeshNormalGenerator::GenerateTangents(meshes, &threadPool);
+
+        for (const auto& mesh : meshes)
+        {
+            const auto& vertices = mesh.submeshes[0].vertices;
+            ASSERT_EQ(vertices.size(), size_t{ 6 });
+
+            // Texture coordinates swapped, tangent follows y with negative handedness.
+            ExpectNearVector({ vertices[0].tangent.x, vertices[0].tangent.y, vertices[0].tangent.z }, { 0.0f, 1.0f, 0.0f });
+            EXPECT_EQ(vertices[0].tangent.w, -1.0f);
+
+            // Degenerate texture coordinates get a tangent orthogonal to the normal.
+            const Vector3f32 tangent = { vertices[3].tangent.x, vertices[3].tangent.y, vertices[3].tangent.z };
+            EXPECT_NEAR(tangent.Length(), 1.0f, 1.0e-5f);
+            EXPECT_NEAR(tangent.Dot(vertices[3].normal), 0.0f, 1.0e-5f);
+            EXPECT_EQ(vertices[3].tangent.w, 1.0f);
+        }
+    }
+
+}
@@ -0,0 +1,176 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Mesh/MeshOptimizer.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+
+namespace Molten
+{
+
+    /** Creates grid sub-mesh, with triangles in shuffled order. */
+    static IndexedSubmesh CreateOptimizerTestSubmesh(const uint32_t gridSize)
+    {
+        IndexedSubmesh submesh;
+        for (uint32_t y = 0; y <= gridSize; y++)
+        {
+            for (uint32_t x = 0; x <= gridSize; x++)
+            {
+                submesh.vertices.push_back({ { static_cast<float>(x), static_cast<float>(y), 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } });
+            }
+        }
+
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t y = 0; y < gridSize; y++)
+        {
+            for (uint32_t x = 0; x < gridSize; x++)
+            {
+                const auto i = y * (gridSize + 1) + x;
+                triangles.push_back({ i, i + 1, i + gridSize + 2 });
+                triangles.push_back({ i, i + gridSize + 2, i + gridSize + 1 });
+            }
+        }
+
+        // Deterministic shuffle.
+        uint32_t seed = 12345;
+        for (size_t i = triangles.size() - 1; i > 0; i--)
+        {
+            seed = seed * 1664525 + 1013904223;
+            std::swap(triangles[i], triangles[seed % (i + 1)]);
+        }
+
+        std::vector<uint32_t> indices;
+        for (const auto& triangle : triangles)
+        {
+            indices.insert(indices.end(), triangle.begin(), triangle.end());
+        }
+        submesh.SetIndices(indices);
+
+        return submesh;
+    }
+
+    /** Get sorted list of triangles, as positions, rotated to start with lowest vertex. */
+    static std::vector<std::array<float, 9>> GetOptimizerTestTriangles(const IndexedSubmesh& submesh)
+    {
+        const auto indices = submesh.GetIndices();
+
+        std::vector<std::array<float, 9>> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            std::array<uint32_t, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end(), [&](auto lhs, auto rhs)
+            {
+                const auto& lhsPosition = submesh.vertices[lhs].position;
+                const auto& rhsPosition = submesh.vertices[rhs].position;
+                return std::make_pair(lhsPosition.x, lhsPosition.y) < std::make_pair(rhsPosition.x, rhsPosition.y);
+            }), triangle.end());
+
+            auto& positions = triangles.emplace_back();
+            for (size_t j = 0; j < 3; j++)
+            {
+                const auto& position = submesh.vertices[triangle[j]].position;
+                positions[j * 3] = position.x;
+                positions[j * 3 + 1] = position.y;
+                positions[j * 3 + 2] = position.z;
+            }
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    TEST(Mesh, MeshOptimizer_VertexCache)
+    {
+        const auto submesh = CreateOptimizerTestSubmesh(32);
+        auto indices = submesh.GetIndices();
+
+        const auto originalMissRatio = MeshOptimizer::CalculateAverageCacheMissRatio(indices, submesh.vertices.size());
+        MeshOptimizer::OptimizeVertexCache(indices, submesh.vertices.size());
+        const auto optimizedMissRatio = MeshOptimizer::CalculateAverageCacheMissRatio(indices, submesh.vertices.size());
+
+        EXPECT_GT(originalMissRatio, 2.0f);
+        EXPECT_LT(optimizedMissRatio, 0.8f);
+
+        auto overdrawIndices = indices;
+        MeshOptimizer::OptimizeOverdraw(overdrawIndices, submesh.vertices);
+        const auto overdrawMissRatio = MeshOptimizer::CalculateAverageCacheMissRatio(overdrawIndices, submesh.vertices.size());
+        EXPECT_LT(overdrawMissRatio, optimizedMissRatio * 1.25f);
+    }
+
+    TEST(Mesh, MeshOptimizer_VertexFetch)
+    {
+        IndexedMeshVertices vertices(5);
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            vertices[i].position = { static_cast<float>(i), 0.0f, 0.0f };
+        }
+        std::vector<uint32_t> indices = { 3, 1, 4, 4, 1, 0 };
+
+        MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+        EXPECT_EQ(indices, (std::vector<uint32_t>{ 0, 1, 2, 2, 1, 3 }));
+        ASSERT_EQ(vertices.size(), size_t{ 4 });
+        EXPECT_EQ(vertices[0].position.x, 3.0f);
+        EXPECT_EQ(vertices[1].position.x, 1.0f);
+        EXPECT_EQ(vertices[2].position.x, 4.0f);
+        EXPECT_EQ(vertices[3].position.x, 0.0f);
+    }
+
+    TEST(Mesh, MeshOptimizer_Meshes)
+    {
+        IndexedMeshes meshes(2);
+        meshes[0].submeshes.push_back(CreateOptimizerTestSubmesh(16));
+        meshes[0].submeshes.push_back(CreateOptimizerTestSubmesh(24));
+        meshes[1].submeshes.push_back(CreateOptimizerTestSubmesh(40));
+        const auto originalMeshes = meshes;
+
+        auto parallelMeshes = meshes;
+        MeshOptimizer::OptimizeMeshes(meshes);
+
+        ThreadPool threadPool(2);
+        MeshOptimizer::OptimizeMeshes(parallelMeshes, &threadPool);
+
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            for (size_t j = 0; j < meshes[i].submeshes.size(); j++)
+            {
+                const auto& original = originalMeshes[i].submeshes[j];
+                const auto& optimized = meshes[i].submeshes[j];
+
+                // Deterministic and triangle preserving.
+                EXPECT_EQ(optimized.GetIndices(), parallelMeshes[i].submeshes[j].GetIndices());
+                EXPECT_EQ(optimized.vertices.size(), original.vertices.size());
+                EXPECT_EQ(GetOptimizerTestTriangles(optimized), GetOptimizerTestTriangles(original));
+                EXPECT_LT(
+                    MeshOptimizer::CalculateAverageCacheMissRatio(optimized.GetIndices(), optimized.vertices.size()),
+                    MeshOptimizer::CalculateAverageCacheMissRatio(original.GetIndices(), original.vertices.size()));
+            }
+        }
+    }
+
+}
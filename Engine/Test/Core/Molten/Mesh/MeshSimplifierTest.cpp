@@ -0,0 +1,296 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Mesh/MeshSimplifier.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Molten
+{
+
+    /** Creates grid sub-mesh of height function, with an optional texture coordinate seam at column seamColumn. */
+    template<typename THeightFunction>
+    static IndexedSubmesh CreateSimplifierTestSubmesh(const uint32_t gridSize, const uint32_t seamColumn, THeightFunction&& heightFunction)
+    {
+        IndexedSubmesh submesh;
+        std::vector<uint32_t> vertexIndices((gridSize + 1) * (gridSize + 1));
+        std::vector<uint32_t> seamVertexIndices(gridSize + 1);
+
+        for (uint32_t y = 0; y <= gridSize; y++)
+        {
+            for (uint32_t x = 0; x <= gridSize; x++)
+            {
+                const auto fx = static_cast<float>(x);
+                const auto fy = static_cast<float>(y);
+                const Vector3f32 position = { fx, fy, heightFunction(fx, fy) };
+                const Vector2f32 textureCoordinate = { fx / static_cast<float>(gridSize), fy / static_cast<float>(gridSize) };
+
+                vertexIndices[y * (gridSize + 1) + x] = static_cast<uint32_t>(submesh.vertices.size());
+                submesh.vertices.push_back({ position, { 0.0f, 0.0f, 1.0f }, textureCoordinate });
+
+                if (x == seamColumn)
+                {
+                    seamVertexIndices[y] = static_cast<uint32_t>(submesh.vertices.size());
+                    submesh.vertices.push_back({ position, { 0.0f, 0.0f, 1.0f }, textureCoordinate + Vector2f32{ 1.0f, 0.0f } });
+                }
+            }
+        }
+
+        // Triangles right of the seam column use the seam vertices.
+        auto getVertex = [&](const uint32_t x, const uint32_t y, const uint32_t cellX)
+        {
+            return x == seamColumn && cellX >= seamColumn ? seamVertexIndices[y] : vertexIndices[y * (gridSize + 1) + x];
+        };
+
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < gridSize; y++)
+        {
+            for (uint32_t x = 0; x < gridSize; x++)
+            {
+                const auto v0 = getVertex(x, y, x);
+                const auto v1 = getVertex(x + 1, y, x);
+                const auto v2 = getVertex(x + 1, y + 1, x);
+                const auto v3 = getVertex(x, y + 1, x);
+                indices.insert(indices.end(), { v0, v1, v2, v0, v2, v3 });
+            }
+        }
+        submesh.SetIndices(indices);
+
+        return submesh;
+    }
+
+    static IndexedSubmesh CreateSimplifierTestSubmesh(const uint32_t gridSize, const uint32_t seamColumn = std::numeric_limits<uint32_t>::max())
+    {
+        return CreateSimplifierTestSubmesh(gridSize, seamColumn, [](const float, const float) { return 0.0f; });
+    }
+
+    /** Creates flat shaded copy of sub-mesh, with separate vertices and face normal per triangle, as imported from obj files without normals.
+     *  Source vertex of each vertex is stored in sourceVertices.
+     */
+    static IndexedSubmesh CreateSimplifierTestFlatSubmesh(const IndexedSubmesh& source, std::vector<uint32_t>& sourceVertices)
+    {
+        const auto sourceIndices = source.GetIndices();
+
+        IndexedSubmesh submesh;
+        std::vector<uint32_t> indices;
+        sourceVertices.clear();
+        for (size_t i = 0; i < sourceIndices.size(); i += 3)
+        {
+            const auto& p0 = source.vertices[sourceIndices[i]].position;
+            const auto& p1 = source.vertices[sourceIndices[i + 1]].position;
+            const auto& p2 = source.vertices[sourceIndices[i + 2]].position;
+            const auto normal = (p1 - p0).Cross(p2 - p0).Normal();
+
+            for (size_t j = 0; j < 3; j++)
+            {
+                auto vertex = source.vertices[sourceIndices[i + j]];
+                vertex.normal = normal;
+                indices.push_back(static_cast<uint32_t>(submesh.vertices.size()));
+                sourceVertices.push_back(sourceIndices[i + j]);
+                submesh.vertices.push_back(vertex);
+            }
+        }
+        submesh.SetIndices(indices);
+
+        return submesh;
+    }
+
+    /** Get sorted list of edges used by a single triangle. */
+    static std::vector<std::pair<uint32_t, uint32_t>> GetSimplifierTestBorderEdges(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (size_t j = 0; j < 3; j++)
+            {
+                const auto first = indices[i + j];
+                const auto second = indices[i + ((j + 1) % 3)];
+                edges.emplace_back(std::min(first, second), std::max(first, second));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<std::pair<uint32_t, uint32_t>> borderEdges;
+        for (size_t i = 0; i < edges.size();)
+        {
+            const auto end = static_cast<size_t>(std::upper_bound(edges.begin() + static_cast<std::ptrdiff_t>(i), edges.end(), edges[i]) - edges.begin());
+            if (end - i == 1)
+            {
+                borderEdges.push_back(edges[i]);
+            }
+            i = end;
+        }
+
+        return borderEdges;
+    }
+
+    TEST(Mesh, MeshSimplifier_LodChain)
+    {
+        auto submesh = CreateSimplifierTestSubmesh(32);
+        const auto indices = submesh.GetIndices();
+        const auto triangleCount = indices.size() / 3;
+        const auto borderEdges = GetSimplifierTestBorderEdges(indices);
+
+        const std::vector<float> lodRatios = { 0.5f, 0.25f, 0.125f };
+        MeshSimplifier::GenerateLods(submesh, lodRatios);
+        ASSERT_EQ(submesh.lods.size(), lodRatios.size());
+
+        for (size_t i = 0; i < submesh.lods.size(); i++)
+        {
+            const auto& lod = submesh.lods[i];
+            const auto lodIndices = lod.GetIndices();
+            const auto lodTriangleCount = lodIndices.size() / 3;
+
+            EXPECT_LE(lodTriangleCount, static_cast<size_t>(static_cast<float>(triangleCount) * lodRatios[i]));
+            EXPECT_GE(lodTriangleCount, static_cast<size_t>(static_cast<float>(triangleCount) * lodRatios[i] * 0.9f));
+            EXPECT_LT(lod.error, 1.0e-3f);
+            EXPECT_EQ(GetSimplifierTestBorderEdges(lodIndices), borderEdges);
+
+            // No triangle of the flat grid may be flipped or degenerate.
+            for (size_t j = 0; j < lodIndices.size(); j += 3)
+            {
+                ASSERT_LT(lodIndices[j], submesh.vertices.size());
+                const auto& p0 = submesh.vertices[lodIndices[j]].position;
+                const auto& p1 = submesh.vertices[lodIndices[j + 1]].position;
+                const auto& p2 = submesh.vertices[lodIndices[j + 2]].position;
+                EXPECT_GT((p1 - p0).Cross(p2 - p0).z, 0.0f);
+            }
+        }
+    }
+
+    TEST(Mesh, MeshSimplifier_Seam)
+    {
+        const uint32_t gridSize = 32;
+        const uint32_t seamColumn = 16;
+        auto submesh = CreateSimplifierTestSubmesh(gridSize, seamColumn);
+
+        MeshSimplifier::GenerateLods(submesh, { 0.25f });
+        ASSERT_EQ(submesh.lods.size(), size_t{ 1 });
+
+        const auto lodIndices = submesh.lods[0].GetIndices();
+        EXPECT_LE(lodIndices.size(), submesh.GetIndexCount() / 4);
+
+        // Both sides of the seam keep all of their seam vertices.
+        size_t seamVertexCount = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(submesh.vertices.size()); i++)
+        {
+            if (submesh.vertices[i].position.x == static_cast<float>(seamColumn))
+            {
+                ++seamVertexCount;
+                EXPECT_NE(std::find(lodIndices.begin(), lodIndices.end(), i), lodIndices.end());
+            }
+        }
+        EXPECT_EQ(seamVertexCount, size_t{ (gridSize + 1) * 2 });
+    }
+
+    TEST(Mesh, MeshSimplifier_MaxError)
+    {
+        const auto submesh = CreateSimplifierTestSubmesh(32, std::numeric_limits<uint32_t>::max(), [](const float x, const float y)
+        {
+            return std::sin(x * 0.5f) * std::cos(y * 0.5f) * 4.0f;
+        });
+        const auto indices = submesh.GetIndices();
+
+        const auto unbounded = MeshSimplifier::Simplify(submesh.vertices, indices, indices.size() / 4);
+        EXPECT_LE(unbounded.indices.size(), indices.size() / 4);
+        EXPECT_GT(unbounded.error, 0.0f);
+
+        const auto bounded = MeshSimplifier::Simplify(submesh.vertices, indices, indices.size() / 4, 0.01f);
+        EXPECT_GT(bounded.indices.size(), unbounded.indices.size());
+        EXPECT_LT(bounded.indices.size(), indices.size());
+        EXPECT_LE(bounded.error, 0.01f * 32.0f);
+        EXPECT_LT(bounded.error, unbounded.error);
+    }
+
+    TEST(Mesh, MeshSimplifier_Parallel)
+    {
+        IndexedMeshes meshes(2);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            meshes[0].submeshes.push_back(CreateSimplifierTestSubmesh(16 + i * 4, 8));
+            meshes[1].submeshes.push_back(CreateSimplifierTestSubmesh(12 + i * 4));
+        }
+        auto parallelMeshes = meshes;
+
+        const std::vector<float> lodRatios = { 0.5f, 0.25f };
+        MeshSimplifier::GenerateLods(meshes, lodRatios);
+
+        ThreadPool threadPool;
+        MeshSimplifier::GenerateLods(parallelMeshes, lodRatios, &threadPool);
+
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            for (size_t j = 0; j < meshes[i].submeshes.size(); j++)
+            {
+                const auto& lods = meshes[i].submeshes[j].lods;
+                const auto& parallelLods = parallelMeshes[i].submeshes[j].lods;
+                ASSERT_EQ(lods.size(), lodRatios.size());
+                ASSERT_EQ(parallelLods.size(), lods.size());
+                for (size_t k = 0; k < lods.size(); k++)
+                {
+                    EXPECT_EQ(parallelLods[k].GetIndices(), lods[k].GetIndices());
+                    EXPECT_EQ(parallelLods[k].error, lods[k].error);
+                }
+            }
+        }
+    }
+
+    TEST(Mesh, MeshSimplifier_FlatShaded)
+    {
+        const auto smoothSubmesh = CreateSimplifierTestSubmesh(20, std::numeric_limits<uint32_t>::max(), [](const float x, const float y)
+        {
+            return std::sin(x * 0.5f) * std::cos(y * 0.5f);
+        });
+
+        std::vector<uint32_t> sourceVertices;
+        auto submesh = CreateSimplifierTestFlatSubmesh(smoothSubmesh, sourceVertices);
+        const auto triangleCount = submesh.GetIndexCount() / 3;
+        ASSERT_EQ(submesh.vertices.size(), triangleCount * 3);
+
+        // Vertices only split by normals are collapsed together, so flat shaded meshes are simplified too.
+        const std::vector<float> lodRatios = { 0.5f, 0.25f };
+        MeshSimplifier::GenerateLods(submesh, lodRatios);
+        ASSERT_EQ(submesh.lods.size(), lodRatios.size());
+
+        const auto borderEdges = GetSimplifierTestBorderEdges(smoothSubmesh.GetIndices());
+        for (size_t i = 0; i < submesh.lods.size(); i++)
+        {
+            auto lodIndices = submesh.lods[i].GetIndices();
+            EXPECT_LE(lodIndices.size() / 3, static_cast<size_t>(static_cast<float>(triangleCount) * lodRatios[i]));
+
+            // Welded by position, the simplified mesh has no cracks and keeps its borders.
+            for (auto& index : lodIndices)
+            {
+                index = sourceVertices[index];
+            }
+            EXPECT_EQ(GetSimplifierTestBorderEdges(lodIndices), borderEdges);
+        }
+    }
+
+}
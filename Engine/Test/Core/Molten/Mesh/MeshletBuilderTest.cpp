@@ -0,0 +1,247 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Mesh/MeshletBuilder.hpp"
+#include "Molten/Mesh/MeshOptimizer.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+
+namespace Molten
+{
+
+    /** Creates flat grid sub-mesh facing +z, optimized for vertex cache. */
+    static IndexedSubmesh CreateMeshletTestSubmesh(const uint32_t gridSize)
+    {
+        IndexedSubmesh submesh;
+        for (uint32_t y = 0; y <= gridSize; y++)
+        {
+            for (uint32_t x = 0; x <= gridSize; x++)
+            {
+                submesh.vertices.push_back({ { static_cast<float>(x), static_cast<float>(y), 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } });
+            }
+        }
+
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y < gridSize; y++)
+        {
+            for (uint32_t x = 0; x < gridSize; x++)
+            {
+                const auto v0 = y * (gridSize + 1) + x;
+                const auto v1 = v0 + 1;
+                const auto v2 = v1 + gridSize + 1;
+                const auto v3 = v0 + gridSize + 1;
+                indices.insert(indices.end(), { v0, v1, v2, v0, v2, v3 });
+            }
+        }
+
+        MeshOptimizer::OptimizeVertexCache(indices, submesh.vertices.size());
+        submesh.SetIndices(indices);
+        return submesh;
+    }
+
+    /** Creates sub-mesh of separate vertices per triangle, as of a flat shaded mesh. */
+    static IndexedSubmesh CreateMeshletTestUnweldedSubmesh(const IndexedSubmesh& source)
+    {
+        IndexedSubmesh submesh;
+        std::vector<uint32_t> indices;
+        for (const auto index : source.GetIndices())
+        {
+            indices.push_back(static_cast<uint32_t>(submesh.vertices.size()));
+            submesh.vertices.push_back(source.vertices[index]);
+        }
+
+        submesh.SetIndices(indices);
+        return submesh;
+    }
+
+    static std::vector<std::array<uint32_t, 3>> GetMeshletTestTriangles(const std::vector<uint32_t>& indices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    TEST(Mesh, MeshletBuilder_Build)
+    {
+        const auto submesh = CreateMeshletTestSubmesh(32);
+        const auto indices = submesh.GetIndices();
+
+        const auto result = MeshletBuilder::Build(submesh.vertices, indices);
+        ASSERT_FALSE(result.meshlets.empty());
+
+        // Full meshlets of a regular grid are limited by vertices, at about 90 triangles per meshlet.
+        EXPECT_LE(result.meshlets.size(), size_t{ 32 });
+
+        std::vector<uint32_t> meshletIndices;
+        for (const auto& meshlet : result.meshlets)
+        {
+            EXPECT_LE(meshlet.vertexCount, uint32_t{ MeshletBuilder::DefaultMaxVertices });
+            EXPECT_LE(meshlet.triangleCount, uint32_t{ MeshletBuilder::DefaultMaxTriangles });
+            ASSERT_LE(meshlet.vertexOffset + meshlet.vertexCount, result.vertices.size());
+            ASSERT_LE(meshlet.triangleOffset + meshlet.triangleCount * 3, result.triangles.size());
+
+            for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++)
+            {
+                const auto localIndex = result.triangles[meshlet.triangleOffset + i];
+                ASSERT_LT(localIndex, meshlet.vertexCount);
+                meshletIndices.push_back(result.vertices[meshlet.vertexOffset + localIndex]);
+            }
+
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+            {
+                const auto& position = submesh.vertices[result.vertices[meshlet.vertexOffset + i]].position;
+                EXPECT_LE((position - meshlet.center).Length(), meshlet.radius + 1.0e-5f);
+                for (size_t j = 0; j < 3; j++)
+                {
+                    EXPECT_GE(position.c[j], meshlet.bounds.low.c[j]);
+                    EXPECT_LE(position.c[j], meshlet.bounds.high.c[j]);
+                }
+            }
+        }
+
+        // Every triangle is part of exactly one meshlet, with winding kept.
+        EXPECT_EQ(GetMeshletTestTriangles(meshletIndices), GetMeshletTestTriangles(indices));
+    }
+
+    TEST(Mesh, MeshletBuilder_Limits)
+    {
+        const auto submesh = CreateMeshletTestSubmesh(8);
+        const auto result = MeshletBuilder::Build(submesh.vertices, submesh.GetIndices(), 16, 8);
+
+        uint32_t triangleCount = 0;
+        for (const auto& meshlet : result.meshlets)
+        {
+            EXPECT_LE(meshlet.vertexCount, uint32_t{ 16 });
+            EXPECT_LE(meshlet.triangleCount, uint32_t{ 8 });
+            triangleCount += meshlet.triangleCount;
+        }
+        EXPECT_EQ(triangleCount, uint32_t{ 128 });
+        EXPECT_GE(result.meshlets.size(), size_t{ 16 });
+    }
+
+    TEST(Mesh, MeshletBuilder_Cone)
+    {
+        const auto submesh = CreateMeshletTestSubmesh(16);
+        const auto result = MeshletBuilder::Build(submesh.vertices, submesh.GetIndices());
+
+        for (const auto& meshlet : result.meshlets)
+        {
+            EXPECT_NEAR(meshlet.coneAxis.z, 1.0f, 1.0e-5f);
+            EXPECT_NEAR(meshlet.coneCutoff, 0.0f, 1.0e-3f);
+            EXPECT_TRUE(meshlet.IsBackFacing({ 8.0f, 8.0f, -10.0f }));
+            EXPECT_FALSE(meshlet.IsBackFacing({ 8.0f, 8.0f, 10.0f }));
+        }
+
+        // Triangles facing opposite directions cannot be culled.
+        const IndexedMeshVertices vertices = {
+            { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+            { { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } },
+            { { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } }
+        };
+        const auto doubleSided = MeshletBuilder::Build(vertices, { 0, 1, 2, 0, 2, 1 });
+        ASSERT_EQ(doubleSided.meshlets.size(), size_t{ 1 });
+        EXPECT_EQ(doubleSided.meshlets[0].coneCutoff, 1.0f);
+        EXPECT_FALSE(doubleSided.meshlets[0].IsBackFacing({ 0.0f, 0.0f, -10.0f }));
+        EXPECT_FALSE(doubleSided.meshlets[0].IsBackFacing({ 0.0f, 0.0f, 10.0f }));
+    }
+
+    TEST(Mesh, MeshletBuilder_Unwelded)
+    {
+        const auto submesh = CreateMeshletTestUnweldedSubmesh(CreateMeshletTestSubmesh(20));
+        const auto indices = submesh.GetIndices();
+        const auto result = MeshletBuilder::Build(submesh.vertices, indices);
+
+        // 800 triangles of 3 unique vertices each, at most 21 triangles fit in 64 vertices.
+        EXPECT_LE(result.meshlets.size(), size_t{ 39 });
+
+        std::vector<uint32_t> meshletIndices;
+        for (const auto& meshlet : result.meshlets)
+        {
+            EXPECT_LE(meshlet.vertexCount, uint32_t{ MeshletBuilder::DefaultMaxVertices });
+            EXPECT_LE(meshlet.radius, 5.0f);
+            for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++)
+            {
+                meshletIndices.push_back(result.vertices[meshlet.vertexOffset + result.triangles[meshlet.triangleOffset + i]]);
+            }
+        }
+        EXPECT_EQ(GetMeshletTestTriangles(meshletIndices), GetMeshletTestTriangles(indices));
+    }
+
+    TEST(Mesh, MeshletBuilder_Disconnected)
+    {
+        // Separate triangles along a line, nearest triangles are added to meshlets instead.
+        IndexedMeshVertices vertices;
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            const auto x = static_cast<float>(i) * 2.0f;
+            for (const auto& position : { Vector3f32{ x, 0.0f, 0.0f }, Vector3f32{ x + 1.0f, 0.0f, 0.0f }, Vector3f32{ x, 1.0f, 0.0f } })
+            {
+                indices.push_back(static_cast<uint32_t>(vertices.size()));
+                vertices.push_back({ position, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f } });
+            }
+        }
+
+        const auto result = MeshletBuilder::Build(vertices, indices, 16, 4);
+        ASSERT_EQ(result.meshlets.size(), size_t{ 25 });
+        for (const auto& meshlet : result.meshlets)
+        {
+            EXPECT_EQ(meshlet.triangleCount, uint32_t{ 4 });
+            EXPECT_LE(meshlet.bounds.high.x - meshlet.bounds.low.x, 7.0f);
+        }
+    }
+
+    TEST(Mesh, MeshletBuilder_Parallel)
+    {
+        IndexedMeshes meshes(3);
+        for (auto& mesh : meshes)
+        {
+            mesh.submeshes.push_back(CreateMeshletTestSubmesh(24));
+        }
+        auto serialMeshes = meshes;
+
+        ThreadPool threadPool;
+        MeshletBuilder::BuildMeshes(meshes, &threadPool);
+        MeshletBuilder::BuildMeshes(serialMeshes);
+
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            const auto& submesh = meshes[i].submeshes[0];
+            const auto& serialSubmesh = serialMeshes[i].submeshes[0];
+            EXPECT_FALSE(submesh.meshlets.empty());
+            EXPECT_EQ(submesh.meshlets.size(), serialSubmesh.meshlets.size());
+            EXPECT_EQ(submesh.meshletVertices, serialSubmesh.meshletVertices);
+            EXPECT_EQ(submesh.meshletTriangles, serialSubmesh.meshletTriangles);
+        }
+    }
+
+}
@@ -0,0 +1,239 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Mesh/ObjMeshImporter.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace Molten
+{
+
+    static void WriteImporterTestObjMeshFile(const std::filesystem::path& filename, const float offset)
+    {
+        std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        file << "o Quad\n";
+        file << "v " << offset << " 0.0 0.0\n";
+        file << "v 1.0 0.0 0.0\n";
+        file << "v 1.0 1.0 0.0\n";
+        file << "v 0.0 1.0 0.0\n";
+        file << "vn 0.0 0.0 1.0\n";
+        file << "usemtl Red\n";
+        file << "f 1//1 2//1 3//1 4//1\n";
+    }
+
+    TEST(Mesh, ObjMeshImporter_Cache)
+    {
+        const std::filesystem::path filename = "ObjMeshImporterTest.obj";
+        const std::filesystem::path cacheDirectory = "ObjMeshImporterTestCache";
+        std::filesystem::remove_all(cacheDirectory);
+        WriteImporterTestObjMeshFile(filename, 0.0f);
+
+        ThreadPool threadPool;
+        ObjMeshImporter importer;
+        importer.SetCacheDirectory(cacheDirectory);
+
+        const auto cacheFilename = importer.GetCacheFilename(filename);
+        EXPECT_EQ(cacheFilename.parent_path(), cacheDirectory);
+
+        {
+            auto result = importer.Import(filename, threadPool);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            EXPECT_TRUE(std::filesystem::exists(cacheFilename));
+
+            ASSERT_EQ(result.Value().GetSubmeshes().size(), size_t{ 1 });
+            const auto& submesh = result.Value().GetSubmeshes()[0];
+            EXPECT_EQ(submesh.material, "Red");
+            EXPECT_EQ(submesh.vertexCount, uint32_t{ 4 });
+            EXPECT_EQ(submesh.indexCount, uint32_t{ 6 });
+        }
+        {
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+            EXPECT_TRUE(result.Value().IsMemoryMapped());
+            ASSERT_EQ(result.Value().GetMeshes().size(), size_t{ 1 });
+            EXPECT_EQ(result.Value().GetMeshes()[0].name, "Quad");
+        }
+        {
+            // Touching the source without modifying it keeps the cache valid, via content hash.
+            std::filesystem::last_write_time(filename, std::filesystem::last_write_time(filename) + std::chrono::hours(1));
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+        }
+        {
+            // Changed import settings invalidates the cache.
+            importer.SetLodRatios({ 0.5f });
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+
+            auto cachedResult = importer.Import(filename);
+            ASSERT_TRUE(cachedResult.IsValid()) << cachedResult.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+        }
+        {
+            importer.SetMeshletsEnabled(true);
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            ASSERT_EQ(result.Value().GetSubmeshes().size(), size_t{ 1 });
+            EXPECT_EQ(result.Value().GetSubmeshes()[0].meshletCount, uint32_t{ 1 });
+            ASSERT_EQ(result.Value().GetMeshlets().size(), size_t{ 1 });
+            EXPECT_EQ(result.Value().GetMeshlets()[0].triangleCount, uint32_t{ 2 });
+        }
+        {
+            // Modified source of same size invalidates the cache.
+            WriteImporterTestObjMeshFile(filename, 5.0f);
+            std::filesystem::last_write_time(filename, std::filesystem::last_write_time(filename) + std::chrono::hours(2));
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            const auto& submesh = result.Value().GetSubmeshes()[0];
+            EXPECT_TRUE(std::any_of(submesh.vertices, submesh.vertices + submesh.vertexCount, [](const auto& vertex)
+            {
+                return vertex.position == Vector3f32{ 5.0f, 0.0f, 0.0f };
+            }));
+        }
+        {
+            importer.SetCacheEnabled(false);
+            std::filesystem::remove_all(cacheDirectory);
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            EXPECT_FALSE(std::filesystem::exists(cacheFilename));
+        }
+
+        std::filesystem::remove(filename);
+        std::filesystem::remove_all(cacheDirectory);
+    }
+
+    TEST(Mesh, ObjMeshImporter_CacheDependencies)
+    {
+        const std::filesystem::path directory = "ObjMeshImporterTestDependencies";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        const auto filename = directory / "quad.obj";
+        const auto materialFilename = directory / "quad.mtl";
+        {
+            std::ofstream file(filename, std::ofstream::binary);
+            file << "mtllib quad.mtl\no Quad\nv 0 0 0\nv 1 0 0\nv 1 1 0\nusemtl Red\nf 1 2 3\n";
+        }
+        const auto writeMaterialFile = [&](const std::string& diffuseColor)
+        {
+            std::ofstream file(materialFilename, std::ofstream::binary | std::ofstream::trunc);
+            file << "newmtl Red\nKd " << diffuseColor << "\n";
+        };
+        writeMaterialFile("1 0 0");
+
+        ObjMeshImporter importer;
+        {
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            ASSERT_EQ(result.Value().GetDependencies().size(), size_t{ 1 });
+            EXPECT_EQ(std::filesystem::path{ result.Value().GetDependencies()[0].filename }.filename(), "quad.mtl");
+        }
+        {
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+
+            // Material properties are kept in the cache.
+            ASSERT_EQ(result.Value().GetMaterials().size(), size_t{ 1 });
+            const auto& material = result.Value().GetMaterials()[0];
+            EXPECT_EQ(material.name, "Red");
+            ASSERT_TRUE(material.diffuseColor.has_value());
+            EXPECT_EQ(material.diffuseColor.value(), (Vector3f32{ 1.0f, 0.0f, 0.0f }));
+            EXPECT_FALSE(material.ambientColor.has_value());
+        }
+        {
+            // Touching a material file without modifying it keeps the cache valid.
+            std::filesystem::last_write_time(materialFilename, std::filesystem::last_write_time(materialFilename) + std::chrono::hours(1));
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+        }
+        {
+            // Modified material file of same size invalidates the cache.
+            writeMaterialFile("0 1 0");
+            std::filesystem::last_write_time(materialFilename, std::filesystem::last_write_time(materialFilename) + std::chrono::hours(2));
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+
+            auto cachedResult = importer.Import(filename);
+            ASSERT_TRUE(cachedResult.IsValid()) << cachedResult.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+            ASSERT_EQ(cachedResult.Value().GetMaterials().size(), size_t{ 1 });
+            EXPECT_EQ(cachedResult.Value().GetMaterials()[0].diffuseColor, (Vector3f32{ 0.0f, 1.0f, 0.0f }));
+        }
+        {
+            // Missing material files are skipped, and invalidate the cache once created again.
+            std::filesystem::remove(materialFilename);
+
+            auto result = importer.Import(filename);
+            ASSERT_TRUE(result.IsValid()) << result.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            ASSERT_EQ(result.Value().GetMaterials().size(), size_t{ 1 });
+            EXPECT_EQ(result.Value().GetMaterials()[0].name, "Red");
+            EXPECT_FALSE(result.Value().GetMaterials()[0].diffuseColor.has_value());
+
+            auto cachedResult = importer.Import(filename);
+            ASSERT_TRUE(cachedResult.IsValid()) << cachedResult.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Cache);
+
+            writeMaterialFile("0 0 1");
+            auto createdResult = importer.Import(filename);
+            ASSERT_TRUE(createdResult.IsValid()) << createdResult.Error();
+            EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::Source);
+            EXPECT_EQ(createdResult.Value().GetMaterials()[0].diffuseColor, (Vector3f32{ 0.0f, 0.0f, 1.0f }));
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST(Mesh, ObjMeshImporter_Error)
+    {
+        ObjMeshImporter importer;
+        auto result = importer.Import("ThisFileDoesNotExist.obj");
+        ASSERT_FALSE(result.IsValid());
+        EXPECT_EQ(importer.GetLastImportSource(), ObjMeshImporter::ImportSource::None);
+    }
+
+}
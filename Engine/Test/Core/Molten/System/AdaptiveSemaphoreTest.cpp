@@ -0,0 +1,156 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/System/AdaptiveSemaphore.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <array>
+#include <vector>
+
+namespace Molten
+{
+
+    TEST(System, AdaptiveSemaphore)
+    {
+        {
+            AdaptiveSemaphore sem;
+            EXPECT_EQ(sem.GetSpinCount(), AdaptiveSemaphore::DefaultSpinCount);
+            EXPECT_EQ(sem.GetValue(), int32_t{ 0 });
+            EXPECT_FALSE(sem.TryWait());
+            sem.NotifyOne();
+            EXPECT_EQ(sem.GetValue(), int32_t{ 1 });
+            sem.Wait();
+            EXPECT_EQ(sem.GetValue(), int32_t{ 0 });
+        }
+        {
+            AdaptiveSemaphore sem(2, 0);
+            EXPECT_EQ(sem.GetSpinCount(), uint32_t{ 0 });
+            EXPECT_TRUE(sem.TryWait());
+            EXPECT_TRUE(sem.TryWait());
+            EXPECT_FALSE(sem.TryWait());
+        }
+    }
+
+    TEST(System, AdaptiveSemaphore_NotifyOne)
+    {
+        for(const uint32_t spinCount : { uint32_t{ 0 }, uint32_t{ 100 }, AdaptiveSemaphore::DefaultSpinCount })
+        {
+            AdaptiveSemaphore sem(0, spinCount);
+            std::array<std::thread, 3> threads;
+            std::array<size_t, 3> values = { 0 };
+
+            for (size_t i = 0; i < threads.size(); i++)
+            {
+                threads[i] = std::thread([&sem, &values, i]()
+                {
+                    sem.Wait();
+                    values[i] = i + 1;
+                });
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            for (size_t i = 0; i < threads.size(); i++)
+            {
+                sem.NotifyOne();
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            EXPECT_EQ(values[0], size_t{ 1 });
+            EXPECT_EQ(values[1], size_t{ 2 });
+            EXPECT_EQ(values[2], size_t{ 3 });
+            EXPECT_EQ(sem.GetValue(), int32_t{ 0 });
+        }
+    }
+
+    TEST(System, AdaptiveSemaphore_PingPong)
+    {
+        for (const uint32_t spinCount : { uint32_t{ 0 }, AdaptiveSemaphore::DefaultSpinCount })
+        {
+            AdaptiveSemaphore ping(0, spinCount);
+            AdaptiveSemaphore pong(0, spinCount);
+            const size_t iterations = 10000;
+            size_t counter = 0;
+
+            std::thread thread([&]()
+            {
+                for (size_t i = 0; i < iterations; i++)
+                {
+                    ping.Wait();
+                    ++counter;
+                    pong.NotifyOne();
+                }
+            });
+
+            for (size_t i = 0; i < iterations; i++)
+            {
+                ping.NotifyOne();
+                pong.Wait();
+            }
+
+            thread.join();
+            EXPECT_EQ(counter, iterations);
+        }
+    }
+
+    TEST(System, AdaptiveSemaphore_SmallSpinCount)
+    {
+        // Spin counts below the min adaptive spin count must never be exceeded by successful spins.
+        for (const uint32_t spinCount : { uint32_t{ 1 }, uint32_t{ 4 }, uint32_t{ 8 } })
+        {
+            AdaptiveSemaphore sem(0, spinCount);
+            const size_t iterations = 20000;
+            std::atomic_bool waiting = false;
+            uint32_t maxAdaptiveSpinCount = 0;
+
+            // Notifies right after the waiter starts waiting, so waits are likely to succeed while spinning.
+            std::thread thread([&]()
+            {
+                for (size_t i = 0; i < iterations; i++)
+                {
+                    while (!waiting.exchange(false))
+                    {}
+                    sem.NotifyOne();
+                }
+            });
+
+            for (size_t i = 0; i < iterations; i++)
+            {
+                waiting = true;
+                sem.Wait();
+                maxAdaptiveSpinCount = std::max(maxAdaptiveSpinCount, sem.GetAdaptiveSpinCount());
+            }
+
+            thread.join();
+            EXPECT_LE(maxAdaptiveSpinCount, spinCount);
+        }
+    }
+
+}
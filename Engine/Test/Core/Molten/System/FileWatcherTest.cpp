@@ -0,0 +1,101 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/System/FileWatcher.hpp"
+#include <fstream>
+
+namespace Molten
+{
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+
+    TEST(System, FileWatcher_Poll)
+    {
+        const std::filesystem::path directory = "FileWatcherTestDirectory";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory / "sub");
+
+        const auto writeFile = [](const std::filesystem::path& filename, const std::string& content)
+        {
+            std::ofstream file(filename, std::ofstream::binary);
+            file << content;
+        };
+        writeFile(directory / "first.txt", "first");
+
+        {
+            ASSERT_TRUE(FileWatcher::IsSupported());
+            FileWatcher fileWatcher;
+
+            EXPECT_TRUE(fileWatcher.Watch(directory / "first.txt"));
+            EXPECT_TRUE(fileWatcher.Watch(directory / "sub/../first.txt"));
+            EXPECT_TRUE(fileWatcher.Watch(directory / "second.txt"));
+            EXPECT_TRUE(fileWatcher.Watch(directory / "sub/third.txt"));
+            EXPECT_FALSE(fileWatcher.Watch(directory / "missing/fourth.txt"));
+            EXPECT_EQ(fileWatcher.GetWatchedFileCount(), size_t{ 3 });
+            EXPECT_TRUE(fileWatcher.IsWatching(directory / "./first.txt"));
+            EXPECT_FALSE(fileWatcher.IsWatching(directory / "unwatched.txt"));
+            EXPECT_TRUE(fileWatcher.Poll().empty());
+
+            // Modified files are reported once, in order of first modification.
+            writeFile(directory / "second.txt", "second");
+            writeFile(directory / "first.txt", "first modified");
+            writeFile(directory / "second.txt", "second modified");
+            writeFile(directory / "unwatched.txt", "unwatched");
+            {
+                const auto modified = fileWatcher.Poll();
+                ASSERT_EQ(modified.size(), size_t{ 2 });
+                EXPECT_EQ(modified[0], FileWatcher::NormalizeFilename(directory / "second.txt"));
+                EXPECT_EQ(modified[1], FileWatcher::NormalizeFilename(directory / "first.txt"));
+                EXPECT_TRUE(fileWatcher.Poll().empty());
+            }
+
+            // Files replaced by rename.
+            writeFile(directory / "sub/third.tmp", "third");
+            std::filesystem::rename(directory / "sub/third.tmp", directory / "sub/third.txt");
+            {
+                const auto modified = fileWatcher.Poll();
+                ASSERT_EQ(modified.size(), size_t{ 1 });
+                EXPECT_EQ(modified[0], FileWatcher::NormalizeFilename(directory / "sub/third.txt"));
+            }
+
+            fileWatcher.Unwatch(directory / "first.txt");
+            EXPECT_EQ(fileWatcher.GetWatchedFileCount(), size_t{ 2 });
+            writeFile(directory / "first.txt", "first unwatched");
+            EXPECT_TRUE(fileWatcher.Poll().empty());
+
+            fileWatcher.UnwatchAll();
+            EXPECT_EQ(fileWatcher.GetWatchedFileCount(), size_t{ 0 });
+            writeFile(directory / "second.txt", "second unwatched");
+            EXPECT_TRUE(fileWatcher.Poll().empty());
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+#endif
+
+}
@@ -0,0 +1,85 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/System/MemoryMappedFile.hpp"
+#include <fstream>
+
+namespace Molten
+{
+
+    TEST(System, MemoryMappedFile)
+    {
+        const std::filesystem::path filename = "MemoryMappedFileTest.txt";
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+            file << "Hello world";
+        }
+
+        MemoryMappedFile mappedFile;
+        EXPECT_FALSE(mappedFile.IsOpen());
+        ASSERT_TRUE(mappedFile.Open(filename));
+        EXPECT_TRUE(mappedFile.IsOpen());
+        EXPECT_EQ(mappedFile.GetSize(), size_t{ 11 });
+        EXPECT_EQ(mappedFile.GetView(), "Hello world");
+
+        MemoryMappedFile movedFile = std::move(mappedFile);
+        EXPECT_FALSE(mappedFile.IsOpen());
+        EXPECT_EQ(mappedFile.GetData(), nullptr);
+        EXPECT_TRUE(movedFile.IsOpen());
+        EXPECT_EQ(movedFile.GetView(), "Hello world");
+
+        // Discarded pages are reloaded from file.
+        movedFile.Discard(movedFile.GetData(), movedFile.GetSize());
+        EXPECT_EQ(movedFile.GetView(), "Hello world");
+
+        movedFile.Close();
+        EXPECT_FALSE(movedFile.IsOpen());
+        EXPECT_EQ(movedFile.GetSize(), size_t{ 0 });
+
+        std::filesystem::remove(filename);
+    }
+
+    TEST(System, MemoryMappedFile_EmptyAndMissing)
+    {
+        const std::filesystem::path filename = "MemoryMappedFileTestEmpty.txt";
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        }
+
+        MemoryMappedFile mappedFile;
+        ASSERT_TRUE(mappedFile.Open(filename));
+        EXPECT_EQ(mappedFile.GetData(), nullptr);
+        EXPECT_EQ(mappedFile.GetSize(), size_t{ 0 });
+        EXPECT_TRUE(mappedFile.GetView().empty());
+        mappedFile.Close();
+
+        std::filesystem::remove(filename);
+
+        EXPECT_FALSE(mappedFile.Open("ThisFileDoesNotExist.txt"));
+        EXPECT_FALSE(mappedFile.IsOpen());
+    }
+
+}
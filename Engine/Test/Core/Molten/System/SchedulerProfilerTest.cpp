@@ -0,0 +1,133 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/System/SchedulerProfiler.hpp"
+#include "Molten/System/Task.hpp"
+#include <sstream>
+#include <algorithm>
+
+namespace Molten
+{
+
+    TEST(System, SchedulerProfiler)
+    {
+        SchedulerProfiler profiler;
+        profiler.SetThreadName("Main \"thread\"");
+
+        {
+            SchedulerProfiler::ScopedSpan span(&profiler, "Span", SchedulerProfiler::TaskCategory);
+            SleepThreadFor(Milliseconds(2));
+        }
+        profiler.RecordCounter("Counter", 5);
+
+        auto spanEvents = profiler.GetSpanEvents();
+        ASSERT_EQ(spanEvents.size(), size_t{ 1 });
+        EXPECT_EQ(spanEvents[0].name, "Span");
+        EXPECT_GE(spanEvents[0].end - spanEvents[0].start, Milliseconds(2));
+
+        auto counterEvents = profiler.GetCounterEvents();
+        ASSERT_EQ(counterEvents.size(), size_t{ 1 });
+        EXPECT_EQ(counterEvents[0].value, int64_t{ 5 });
+
+        auto statistics = profiler.GetThreadStatistics();
+        ASSERT_EQ(statistics.size(), size_t{ 1 });
+        EXPECT_EQ(statistics[0].name, "Main \"thread\"");
+        EXPECT_EQ(statistics[0].taskCount, size_t{ 1 });
+        EXPECT_GE(statistics[0].busyTime, Milliseconds(2));
+
+        std::stringstream stream;
+        profiler.ExportChromeTrace(stream);
+        const auto json = stream.str();
+        EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+        EXPECT_NE(json.find("\"name\":\"Main \\\"thread\\\"\""), std::string::npos);
+        EXPECT_NE(json.find("\"name\":\"Span\",\"cat\":\"Task\",\"ph\":\"X\""), std::string::npos);
+        EXPECT_NE(json.find("\"name\":\"Counter\",\"ph\":\"C\""), std::string::npos);
+
+        profiler.SetEnabled(false);
+        profiler.RecordCounter("Counter", 6);
+        EXPECT_EQ(profiler.GetCounterEvents().size(), size_t{ 1 });
+
+        profiler.SetEnabled(true);
+        profiler.Clear();
+        EXPECT_TRUE(profiler.GetSpanEvents().empty());
+        EXPECT_TRUE(profiler.GetCounterEvents().empty());
+    }
+
+    TEST(System, SchedulerProfiler_ThreadPool)
+    {
+        SchedulerProfiler profiler;
+
+        ThreadPoolDescriptor descriptor;
+        descriptor.threadCount = 2;
+        descriptor.threadName = "Worker";
+        descriptor.profiler = &profiler;
+        ThreadPool pool(descriptor);
+        EXPECT_EQ(pool.GetProfiler(), &profiler);
+
+        ParallelTaskGroup parallelGroup(pool);
+        for(size_t i = 0; i < 4; i++)
+        {
+            parallelGroup.Emplace<Task>([]() { SleepThreadFor(Milliseconds(1)); }, "Parallel " + std::to_string(i));
+        }
+        parallelGroup.Execute();
+
+        SerialTaskGroup serialGroup(pool);
+        serialGroup.EmplaceBack<Task>([]() {}, "Serial");
+        serialGroup.Execute();
+
+        auto spanEvents = profiler.GetSpanEvents();
+        auto countSpans = [&](const std::string& name)
+        {
+            return std::count_if(spanEvents.begin(), spanEvents.end(), [&](const auto& event) { return event.name == name; });
+        };
+
+        EXPECT_EQ(countSpans("Parallel 0"), 1);
+        EXPECT_EQ(countSpans("Parallel 3"), 1);
+        EXPECT_EQ(countSpans("Serial"), 1);
+        EXPECT_EQ(std::count_if(spanEvents.begin(), spanEvents.end(), [](const auto& event)
+        {
+            return std::string_view{ event.category } == SchedulerProfiler::JobCategory && event.name == "Frame critical";
+        }), 4);
+
+        auto counterEvents = profiler.GetCounterEvents();
+        EXPECT_TRUE(std::any_of(counterEvents.begin(), counterEvents.end(), [](const auto& event)
+        {
+            return std::string_view{ event.name } == "Queue depth";
+        }));
+
+        size_t workerJobCount = 0;
+        for(const auto& statistics : profiler.GetThreadStatistics())
+        {
+            if(statistics.name.rfind("Worker", 0) == 0)
+            {
+                workerJobCount += statistics.jobCount;
+                EXPECT_GT(statistics.idleTime, Time::Zero);
+            }
+        }
+        EXPECT_EQ(workerJobCount, size_t{ 4 });
+    }
+
+}
@@ -27,6 +27,13 @@
 #include "Molten/System/ThreadPool.hpp"
 #include <array>
 #include <string>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+#include <pthread.h>
+#endif
 
 namespace Molten
 {
@@ -217,4 +224,154 @@ namespace Molten
         }
     }
 
-}
\ No newline at end of file
+    TEST(System, ThreadPool_Descriptor)
+    {
+        ThreadPoolDescriptor descriptor;
+        descriptor.threadCount = 2;
+        descriptor.threadName = "TestWorker";
+        descriptor.cpuAffinity = { 0 };
+
+        ThreadPool pool(descriptor);
+        EXPECT_EQ(pool.GetWorkerCount(), size_t{ 2 });
+        EXPECT_EQ(pool.GetBackgroundWorkerLimit(), size_t{ 1 });
+
+        auto result = pool.Execute([]()
+        {
+            std::string name;
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+            char buffer[16] = {};
+            pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+            name = buffer;
+#endif
+            return name;
+        });
+
+#if MOLTEN_PLATFORM == MOLTEN_PLATFORM_LINUX
+        EXPECT_EQ(result.get().rfind("TestWorker", 0), size_t{ 0 });
+#else
+        result.wait();
+#endif
+    }
+
+    TEST(System, ThreadPool_WorkerSpinCount)
+    {
+        ThreadPoolDescriptor descriptor;
+        descriptor.threadCount = 2;
+        descriptor.workerSpinCount = AdaptiveSemaphore::DefaultSpinCount;
+
+        ThreadPool pool(descriptor);
+        for (size_t i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(pool.Execute([i]() { return i + 1; }).get(), i + 1);
+        }
+    }
+
+    TEST(System, ThreadPool_PriorityOrder)
+    {
+        ThreadPool pool(1);
+
+        Semaphore blockSemaphore;
+        Semaphore startedSemaphore;
+        auto blockingResult = pool.Execute([&]()
+        {
+            startedSemaphore.NotifyOne();
+            blockSemaphore.Wait();
+        });
+        startedSemaphore.Wait();
+
+        std::mutex orderMutex;
+        std::vector<ThreadPool::Priority> order;
+        auto executeWithPriority = [&](const ThreadPool::Priority priority)
+        {
+            return std::thread([&, priority]()
+            {
+                pool.Execute(priority, [&, priority]()
+                {
+                    std::lock_guard lock(orderMutex);
+                    order.push_back(priority);
+                }).wait();
+            });
+        };
+
+        // Lowest priority is waiting the longest time, but should still be executed last.
+        auto backgroundThread = executeWithPriority(ThreadPool::Priority::Background);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto normalThread = executeWithPriority(ThreadPool::Priority::Normal);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto frameCriticalThread = executeWithPriority(ThreadPool::Priority::FrameCritical);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        blockSemaphore.NotifyOne();
+        blockingResult.wait();
+
+        backgroundThread.join();
+        normalThread.join();
+        frameCriticalThread.join();
+
+        ASSERT_EQ(order.size(), size_t{ 3 });
+        EXPECT_EQ(order[0], ThreadPool::Priority::FrameCritical);
+        EXPECT_EQ(order[1], ThreadPool::Priority::Normal);
+        EXPECT_EQ(order[2], ThreadPool::Priority::Background);
+    }
+
+    TEST(System, ThreadPool_BackgroundWorkerLimit)
+    {
+        ThreadPool pool(2);
+        ASSERT_EQ(pool.GetBackgroundWorkerLimit(), size_t{ 1 });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        Semaphore blockSemaphore;
+        auto backgroundResult = pool.TryExecute(ThreadPool::Priority::Background, [&]()
+        {
+            blockSemaphore.Wait();
+        });
+        ASSERT_TRUE(backgroundResult.has_value());
+
+        // Second worker is reserved for non-background work.
+        auto secondBackgroundResult = pool.TryExecute(ThreadPool::Priority::Background, []() {});
+        EXPECT_FALSE(secondBackgroundResult.has_value());
+
+        auto frameCriticalResult = pool.TryExecute(ThreadPool::Priority::FrameCritical, []() { return 1; });
+        ASSERT_TRUE(frameCriticalResult.has_value());
+        EXPECT_EQ(frameCriticalResult.value().get(), 1);
+
+        blockSemaphore.NotifyOne();
+        backgroundResult.value().wait();
+    }
+
+    TEST(System, ThreadPool_ParallelFor)
+    {
+        ThreadPool pool(4);
+
+        std::vector<std::atomic_size_t> counts(1000);
+        pool.ParallelFor(ThreadPool::Priority::Normal, counts.size(), [&](const size_t index)
+        {
+            ++counts[index];
+        });
+
+        for (const auto& count : counts)
+        {
+            EXPECT_EQ(count.load(), size_t{ 1 });
+        }
+
+        // Nested calls from workers must not block waiting for free workers.
+        std::atomic_size_t nestedCount = 0;
+        pool.ParallelFor(ThreadPool::Priority::Normal, 8, [&](const size_t)
+        {
+            pool.ParallelFor(ThreadPool::Priority::Normal, 8, [&](const size_t)
+            {
+                ++nestedCount;
+            });
+        });
+        EXPECT_EQ(nestedCount.load(), size_t{ 64 });
+
+        EXPECT_THROW(pool.ParallelFor(ThreadPool::Priority::Normal, 16, [&](const size_t index)
+        {
+            if (index == 7)
+            {
+                throw std::runtime_error("Parallel for error.");
+            }
+        }), std::runtime_error);
+    }
+
+}
@@ -0,0 +1,142 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/System/VirtualFileSystem.hpp"
+#include <fstream>
+
+namespace Molten
+{
+
+    static void WriteVirtualFileSystemTestFile(const std::filesystem::path& filename, const std::string& content)
+    {
+        std::filesystem::create_directories(filename.parent_path());
+        std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+        file << content;
+    }
+
+    TEST(System, VirtualFileSystem_NormalizePath)
+    {
+        EXPECT_EQ(VirtualFileSystem::NormalizePath(""), "");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("/"), "");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("a/b/c.txt"), "a/b/c.txt");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("/a//b/./c.txt/"), "a/b/c.txt");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("a\\b\\c.txt"), "a/b/c.txt");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("a/d/../b/c.txt"), "a/b/c.txt");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("../../a/../../b"), "b");
+        EXPECT_EQ(VirtualFileSystem::NormalizePath("a/.."), "");
+    }
+
+    TEST(System, VirtualFileSystem_Directory)
+    {
+        const std::filesystem::path directory = "VirtualFileSystemTest";
+        std::filesystem::remove_all(directory);
+        WriteVirtualFileSystemTestFile(directory / "a.txt", "File a");
+        WriteVirtualFileSystemTestFile(directory / "sub" / "b.txt", "File b");
+        WriteVirtualFileSystemTestFile(directory / "sub" / "empty.txt", "");
+
+        VirtualFileSystem fileSystem;
+        EXPECT_FALSE(fileSystem.MountDirectory(directory / "missing"));
+        ASSERT_TRUE(fileSystem.MountDirectory(directory, "data"));
+        EXPECT_EQ(fileSystem.GetMountCount(), size_t{ 1 });
+
+        auto fileA = fileSystem.Open("data/a.txt");
+        ASSERT_TRUE(fileA);
+        EXPECT_EQ(fileA->GetView(), "File a");
+        EXPECT_TRUE(fileA->GetMappedFile());
+
+        auto fileB = fileSystem.Open("/data\\sub/./b.txt");
+        ASSERT_TRUE(fileB);
+        EXPECT_EQ(fileB->GetView(), "File b");
+
+        auto emptyFile = fileSystem.Open("data/sub/empty.txt");
+        ASSERT_TRUE(emptyFile);
+        EXPECT_EQ(emptyFile->GetSize(), size_t{ 0 });
+
+        EXPECT_FALSE(fileSystem.Open("a.txt"));
+        EXPECT_FALSE(fileSystem.Open("data/missing.txt"));
+        EXPECT_FALSE(fileSystem.Open("database/a.txt"));
+        EXPECT_TRUE(fileSystem.Exists("data/sub/b.txt"));
+        EXPECT_FALSE(fileSystem.Exists("data/sub"));
+
+        const auto names = fileSystem.ListDirectory("data/sub");
+        ASSERT_TRUE(names);
+        EXPECT_EQ(*names, (std::vector<std::string>{ "b.txt", "empty.txt" }));
+        EXPECT_FALSE(fileSystem.ListDirectory("data/missing"));
+
+        // Opened files outlive their mounts.
+        fileSystem.UnmountAll();
+        EXPECT_EQ(fileSystem.GetMountCount(), size_t{ 0 });
+        EXPECT_FALSE(fileSystem.Open("data/a.txt"));
+        EXPECT_EQ(fileA->GetView(), "File a");
+
+        fileA.reset();
+        fileB.reset();
+        emptyFile.reset();
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST(System, VirtualFileSystem_MountPrecedence)
+    {
+        const std::filesystem::path baseDirectory = "VirtualFileSystemTestBase";
+        const std::filesystem::path patchDirectory = "VirtualFileSystemTestPatch";
+        std::filesystem::remove_all(baseDirectory);
+        std::filesystem::remove_all(patchDirectory);
+        WriteVirtualFileSystemTestFile(baseDirectory / "a.txt", "Base a");
+        WriteVirtualFileSystemTestFile(baseDirectory / "b.txt", "Base b");
+        WriteVirtualFileSystemTestFile(patchDirectory / "b.txt", "Patch b");
+        WriteVirtualFileSystemTestFile(patchDirectory / "c.txt", "Patch c");
+
+        VirtualFileSystem fileSystem;
+        ASSERT_TRUE(fileSystem.MountDirectory(baseDirectory));
+        auto patchMount = std::make_shared<VirtualFileSystemDirectory>(patchDirectory);
+        fileSystem.Mount(patchMount);
+
+        auto expectFile = [&](const std::string& path, const std::string& content)
+        {
+            const auto file = fileSystem.Open(path);
+            ASSERT_TRUE(file) << path;
+            EXPECT_EQ(file->GetView(), content);
+        };
+
+        expectFile("a.txt", "Base a");
+        expectFile("b.txt", "Patch b");
+        expectFile("c.txt", "Patch c");
+
+        const auto names = fileSystem.ListDirectory("");
+        ASSERT_TRUE(names);
+        EXPECT_EQ(*names, (std::vector<std::string>{ "a.txt", "b.txt", "c.txt" }));
+
+        EXPECT_TRUE(fileSystem.Unmount(patchMount));
+        EXPECT_FALSE(fileSystem.Unmount(patchMount));
+        expectFile("b.txt", "Base b");
+        EXPECT_FALSE(fileSystem.Exists("c.txt"));
+
+        std::filesystem::remove_all(baseDirectory);
+        std::filesystem::remove_all(patchDirectory);
+    }
+
+}
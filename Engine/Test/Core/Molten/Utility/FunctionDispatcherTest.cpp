@@ -0,0 +1,167 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/Utility/FunctionDispatcher.hpp"
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace Molten
+{
+    TEST(Utility, FunctionDispatcher)
+    {
+        FunctionDispatcher dispatcher;
+        EXPECT_EQ(dispatcher.Dispatch(), size_t{ 0 });
+
+        std::vector<size_t> order;
+        for(size_t i = 0; i < 10; i++)
+        {
+            dispatcher.Add([&order, i]()
+            {
+                order.push_back(i);
+            });
+        }
+
+        EXPECT_EQ(dispatcher.Dispatch(), size_t{ 10 });
+        ASSERT_EQ(order.size(), size_t{ 10 });
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            EXPECT_EQ(order[i], i);
+        }
+
+        EXPECT_EQ(dispatcher.Dispatch(), size_t{ 0 });
+    }
+
+    TEST(Utility, FunctionDispatcher_LargeCallable)
+    {
+        FunctionDispatcher dispatcher;
+
+        std::array<size_t, 32> values = {};
+        size_t sum = 0;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            values[i] = i + 1;
+        }
+
+        static_assert(sizeof(values) > FunctionDispatcher::InlineStorageSize);
+        dispatcher.Add([values, &sum]()
+        {
+            for(auto value : values)
+            {
+                sum += value;
+            }
+        });
+
+        EXPECT_EQ(dispatcher.Dispatch(), size_t{ 1 });
+        EXPECT_EQ(sum, size_t{ 528 });
+    }
+
+    TEST(Utility, FunctionDispatcher_AddWhileDispatching)
+    {
+        FunctionDispatcher dispatcher;
+        size_t calls = 0;
+
+        dispatcher.Add([&]()
+        {
+            ++calls;
+            dispatcher.Add([&]()
+            {
+                ++calls;
+            });
+        });
+
+        EXPECT_EQ(dispatcher.Dispatch(), size_t{ 1 });
+        EXPECT_EQ(calls, size_t{ 1 });
+        EXPECT_EQ(dispatcher.Dispatch(), size_t{ 1 });
+        EXPECT_EQ(calls, size_t{ 2 });
+    }
+
+    TEST(Utility, FunctionDispatcher_DestroyWithoutDispatch)
+    {
+        auto counter = std::make_shared<size_t>(0);
+        {
+            FunctionDispatcher dispatcher;
+            dispatcher.Add([counter]() { ++(*counter); });
+            dispatcher.Add([counter]() { ++(*counter); });
+            EXPECT_EQ(counter.use_count(), long{ 3 });
+        }
+        EXPECT_EQ(counter.use_count(), long{ 1 });
+        EXPECT_EQ(*counter, size_t{ 0 });
+    }
+
+    TEST(Utility, FunctionDispatcher_MultipleProducers)
+    {
+        FunctionDispatcher dispatcher;
+
+        const size_t threadCount = 4;
+        const size_t functionsPerThread = 10000;
+
+        std::atomic_bool producersDone = false;
+        std::array<size_t, threadCount> lastValues = {};
+        std::array<bool, threadCount> outOfOrder = {};
+        size_t dispatchCount = 0;
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (size_t i = 1; i <= functionsPerThread; i++)
+                {
+                    dispatcher.Add([&, t, i]()
+                    {
+                        outOfOrder[t] |= lastValues[t] + 1 != i;
+                        lastValues[t] = i;
+                    });
+                }
+            });
+        }
+
+        std::thread joiner([&]()
+        {
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            producersDone = true;
+        });
+
+        while(!producersDone)
+        {
+            dispatchCount += dispatcher.Dispatch();
+        }
+        dispatchCount += dispatcher.Dispatch();
+        joiner.join();
+
+        EXPECT_EQ(dispatchCount, threadCount * functionsPerThread);
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            EXPECT_EQ(lastValues[t], functionsPerThread);
+            EXPECT_FALSE(outOfOrder[t]);
+        }
+    }
+
+}
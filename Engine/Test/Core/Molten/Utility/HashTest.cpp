@@ -0,0 +1,54 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Utility/Hash.hpp"
+#include <string>
+#include <vector>
+
+namespace Molten
+{
+    TEST(Utility, Hash64)
+    {
+        // Reference values of XXH64.
+        EXPECT_EQ(Hash64(nullptr, 0), uint64_t{ 0xEF46DB3751D8E999ULL });
+        EXPECT_EQ(Hash64("abc", 3), uint64_t{ 0x44BC2CF5AD770999ULL });
+
+        std::vector<uint8_t> data(1000);
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] = static_cast<uint8_t>(i * 31);
+        }
+
+        const auto hash = Hash64(data.data(), data.size());
+        EXPECT_EQ(Hash64(data.data(), data.size()), hash);
+        EXPECT_NE(Hash64(data.data(), data.size(), 1), hash);
+        EXPECT_NE(Hash64(data.data(), data.size() - 1), hash);
+
+        data[999] ^= 1;
+        EXPECT_NE(Hash64(data.data(), data.size()), hash);
+    }
+}
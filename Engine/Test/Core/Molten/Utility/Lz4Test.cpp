@@ -0,0 +1,215 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+
+#include "Test.hpp"
+#include "Molten/Utility/Lz4.hpp"
+#include "Molten/System/ThreadPool.hpp"
+#include <random>
+#include <sstream>
+
+namespace Molten
+{
+
+    static std::vector<uint8_t> CreateLz4TestData(const size_t size, const size_t pattern, const uint32_t seed = 1)
+    {
+        std::mt19937 random(seed);
+        std::vector<uint8_t> data(size);
+        for(size_t i = 0; i < size; i++)
+        {
+            switch(pattern)
+            {
+                case 0: data[i] = static_cast<uint8_t>(random()); break; ///< Incompressible.
+                case 1: data[i] = static_cast<uint8_t>("abcdefg"[i % (1 + i / 100 % 7)]); break; ///< Runs of short offsets.
+                case 2: data[i] = i >= 300 && random() % 8 != 0 ? data[i - 300 + random() % 3] : static_cast<uint8_t>(random() % 16); break; ///< Mixed.
+                default: data[i] = 7; break; ///< Single value.
+            }
+        }
+        return data;
+    }
+
+    TEST(Utility, Lz4_Block)
+    {
+        for(size_t pattern = 0; pattern < 4; pattern++)
+        {
+            for(const size_t size : { 0, 1, 12, 13, 17, 100, 1000, 70000, 300000 })
+            {
+                const auto data = CreateLz4TestData(size, pattern);
+
+                std::vector<uint8_t> compressed(Lz4::GetMaxCompressedBlockSize(size));
+                const auto compressedSize = Lz4::CompressBlock(data.data(), data.size(), compressed.data(), compressed.size());
+                ASSERT_GT(compressedSize, size_t{ 0 });
+                if((pattern == 1 || pattern == 3) && size >= 1000)
+                {
+                    EXPECT_LT(compressedSize, size / 4) << pattern << ", " << size;
+                }
+
+                std::vector<uint8_t> decompressed(size);
+                const auto decompressedSize = Lz4::DecompressBlock(compressed.data(), compressedSize, decompressed.data(), decompressed.size());
+                ASSERT_TRUE(decompressedSize.has_value()) << pattern << ", " << size;
+                EXPECT_EQ(*decompressedSize, size);
+                EXPECT_EQ(decompressed, data) << pattern << ", " << size;
+
+                // Too small capacities fail.
+                EXPECT_EQ(Lz4::CompressBlock(data.data(), data.size(), compressed.data(), compressedSize - 1), size_t{ 0 });
+                if(size > 0)
+                {
+                    EXPECT_FALSE(Lz4::DecompressBlock(compressed.data(), compressedSize, decompressed.data(), size - 1));
+                }
+            }
+        }
+    }
+
+    TEST(Utility, Lz4_BlockCorrupt)
+    {
+        const auto data = CreateLz4TestData(5000, 2);
+        std::vector<uint8_t> compressed(Lz4::GetMaxCompressedBlockSize(data.size()));
+        compressed.resize(Lz4::CompressBlock(data.data(), data.size(), compressed.data(), compressed.size()));
+        ASSERT_FALSE(compressed.empty());
+
+        // Corrupt and truncated blocks must never be read or written out of bounds, which sanitizers of debug builds would detect.
+        std::mt19937 random(2);
+        std::vector<uint8_t> decompressed(data.size());
+        for(size_t i = 0; i < 2000; i++)
+        {
+            auto corrupt = compressed;
+            corrupt[random() % corrupt.size()] ^= static_cast<uint8_t>(1 << (random() % 8));
+            corrupt.resize(corrupt.size() - random() % 3);
+            [[maybe_unused]] const auto result = Lz4::DecompressBlock(corrupt.data(), corrupt.size(), decompressed.data(), decompressed.size());
+        }
+
+        EXPECT_FALSE(Lz4::DecompressBlock(compressed.data(), 0, decompressed.data(), decompressed.size()));
+        EXPECT_FALSE(Lz4::DecompressBlock(compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size()));
+    }
+
+    TEST(Utility, Lz4_Frame)
+    {
+        ThreadPool threadPool;
+
+        for(const size_t size : { 0, 1, 4096, 1000000 })
+        {
+            for(const bool checksum : { false, true })
+            {
+                const auto data = CreateLz4TestData(size, 2, static_cast<uint32_t>(size));
+
+                for(auto* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+                {
+                    const auto frame = Lz4::CompressFrame(data.data(), data.size(), 65536, checksum, pool);
+                    EXPECT_TRUE(Lz4::IsFrame(frame.data(), frame.size()));
+                    ASSERT_EQ(Lz4::GetFrameContentSize(frame.data(), frame.size()), std::optional<size_t>{ size });
+
+                    const auto decompressed = Lz4::DecompressFrame(frame.data(), frame.size(), pool);
+                    ASSERT_TRUE(decompressed.has_value()) << size;
+                    EXPECT_EQ(*decompressed, data);
+                }
+            }
+        }
+
+        // Incompressible blocks are stored.
+        const auto randomData = CreateLz4TestData(100000, 0);
+        const auto randomFrame = Lz4::CompressFrame(randomData.data(), randomData.size());
+        EXPECT_LT(randomFrame.size(), randomData.size() + 64);
+        EXPECT_EQ(Lz4::DecompressFrame(randomFrame.data(), randomFrame.size()), randomData);
+
+        EXPECT_FALSE(Lz4::IsFrame(randomData.data(), randomData.size()));
+        EXPECT_FALSE(Lz4::DecompressFrame(randomData.data(), randomData.size()));
+    }
+
+    TEST(Utility, Lz4_FrameCorrupt)
+    {
+        const auto data = CreateLz4TestData(200000, 2);
+        const auto frame = Lz4::CompressFrame(data.data(), data.size(), 65536, true);
+
+        // Checksums detect corrupt content.
+        auto corrupt = frame;
+        corrupt[corrupt.size() / 2] ^= 0x10;
+        EXPECT_FALSE(Lz4::DecompressFrame(corrupt.data(), corrupt.size()));
+
+        // Content size must match blocks.
+        corrupt = frame;
+        corrupt[corrupt.size() - 8] ^= 0x01;
+        EXPECT_FALSE(Lz4::DecompressFrame(corrupt.data(), corrupt.size()));
+
+        for(const size_t size : { size_t{ 0 }, size_t{ 20 }, frame.size() / 2, frame.size() - 1 })
+        {
+            EXPECT_FALSE(Lz4::DecompressFrame(frame.data(), size)) << size;
+        }
+    }
+
+    TEST(Utility, Lz4_FrameStream)
+    {
+        const auto data = CreateLz4TestData(300000, 2);
+
+        std::stringstream stream;
+        {
+            Lz4::FrameWriter writer(stream, 50000);
+            for(size_t position = 0, chunkSize = 1; position < data.size(); chunkSize = chunkSize * 3 + 1)
+            {
+                const auto size = std::min(chunkSize, data.size() - position);
+                ASSERT_TRUE(writer.Write(data.data() + position, size));
+                position += size;
+            }
+            ASSERT_TRUE(writer.Finish());
+            EXPECT_FALSE(writer.Finish());
+            EXPECT_FALSE(writer.Write(data.data(), 1));
+        }
+
+        // Streamed frames are complete frames.
+        const auto frameString = stream.str();
+        const auto decompressed = Lz4::DecompressFrame(frameString.data(), frameString.size());
+        ASSERT_TRUE(decompressed.has_value());
+        EXPECT_EQ(*decompressed, data);
+
+        Lz4::FrameReader reader(stream);
+        std::vector<uint8_t> readData(data.size() + 100);
+        size_t readSize = 0;
+        for(size_t chunkSize = 7; readSize < readData.size(); chunkSize = chunkSize * 2)
+        {
+            const auto size = std::min(chunkSize, readData.size() - readSize);
+            const auto result = reader.Read(readData.data() + readSize, size);
+            readSize += result;
+            if(result < size)
+            {
+                break;
+            }
+        }
+
+        EXPECT_TRUE(reader.IsFinished());
+        EXPECT_FALSE(reader.HasError());
+        ASSERT_EQ(readSize, data.size());
+        readData.resize(readSize);
+        EXPECT_EQ(readData, data);
+
+        // Corrupt streams are detected.
+        auto corruptString = frameString;
+        corruptString[corruptString.size() / 3] ^= 0x20;
+        std::stringstream corruptStream(corruptString);
+        Lz4::FrameReader corruptReader(corruptStream);
+        EXPECT_LT(corruptReader.Read(readData.data(), readData.size()), data.size());
+        EXPECT_TRUE(corruptReader.HasError());
+        EXPECT_FALSE(corruptReader.IsFinished());
+    }
+
+}
@@ -0,0 +1,106 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/Utility/MemoryMappedFileLineReader.hpp"
+#include <fstream>
+
+namespace Molten
+{
+
+    static std::vector<std::string> ReadMappedLines(const std::string& content, size_t& bufferCount)
+    {
+        const std::filesystem::path filename = "MemoryMappedFileLineReaderTest.txt";
+        {
+            std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+            file << content;
+        }
+
+        std::vector<std::string> lines;
+        std::vector<MemoryMappedFileLineReader::File> buffers;
+        auto addBuffer = [&](auto& buffer) { buffers.push_back(buffer); };
+
+        {
+            auto mappedFile = std::make_shared<MemoryMappedFile>();
+            EXPECT_TRUE(mappedFile->Open(filename));
+
+            MemoryMappedFileLineReader lineReader(std::move(mappedFile));
+            EXPECT_EQ(lineReader.GetStreamSize(), content.size());
+
+            std::string_view line;
+            while(lineReader.ReadLine(line, addBuffer) == MemoryMappedFileLineReader::LineReadResult::Successful)
+            {
+                lines.emplace_back(line);
+            }
+            EXPECT_EQ(lineReader.GetSizeLeft(), size_t{ 0 });
+        }
+
+        bufferCount = buffers.size();
+        buffers.clear();
+        std::filesystem::remove(filename);
+        return lines;
+    }
+
+    TEST(Utility, MemoryMappedFileLineReader)
+    {
+        size_t bufferCount = 0;
+        const auto lines = ReadMappedLines("Hello first world\nHello second world\r\nHello third world\r\n\r\nFoo\n\nBar\r\r\rEnding\r\n", bufferCount);
+        EXPECT_EQ(bufferCount, size_t{ 1 });
+
+        ASSERT_EQ(lines.size(), size_t{ 11 });
+        EXPECT_STREQ(lines[0].c_str(), "Hello first world");
+        EXPECT_STREQ(lines[1].c_str(), "Hello second world");
+        EXPECT_STREQ(lines[2].c_str(), "Hello third world");
+        EXPECT_STREQ(lines[3].c_str(), "");
+        EXPECT_STREQ(lines[4].c_str(), "Foo");
+        EXPECT_STREQ(lines[5].c_str(), "");
+        EXPECT_STREQ(lines[6].c_str(), "Bar");
+        EXPECT_STREQ(lines[7].c_str(), "");
+        EXPECT_STREQ(lines[8].c_str(), "");
+        EXPECT_STREQ(lines[9].c_str(), "Ending");
+        EXPECT_STREQ(lines[10].c_str(), "");
+    }
+
+    TEST(Utility, MemoryMappedFileLineReader_NoNewlineAtEnd)
+    {
+        size_t bufferCount = 0;
+        const auto lines = ReadMappedLines("Hello first world\r\nHello second world\nHello third world ", bufferCount);
+
+        ASSERT_EQ(lines.size(), size_t{ 3 });
+        EXPECT_STREQ(lines[0].c_str(), "Hello first world");
+        EXPECT_STREQ(lines[1].c_str(), "Hello second world");
+        EXPECT_STREQ(lines[2].c_str(), "Hello third world ");
+    }
+
+    TEST(Utility, MemoryMappedFileLineReader_Empty)
+    {
+        size_t bufferCount = 0;
+        const auto lines = ReadMappedLines("", bufferCount);
+
+        ASSERT_EQ(lines.size(), size_t{ 1 });
+        EXPECT_TRUE(lines[0].empty());
+    }
+
+}
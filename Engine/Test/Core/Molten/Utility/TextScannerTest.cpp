@@ -0,0 +1,98 @@
+/*
+* MIT License
+*
+* Copyright (c) 2022 Jimmie Bergmann
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files(the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions :
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Test.hpp"
+#include "Molten/Utility/TextScanner.hpp"
+#include <string>
+
+namespace Molten
+{
+
+    TEST(Utility, TextScanner_Find)
+    {
+        Molten::Test::PrintInfo(std::string{ "Text scanner instruction set: " } + TextScanner::GetInstructionSet());
+
+        // Match at every position of every length, to cover full vector blocks and scalar tails.
+        for(size_t length = 0; length < 80; length++)
+        {
+            for(size_t position = 0; position <= length; position++)
+            {
+                for(const char match : { '\n', '\r', ' ', '\t', '/', '#' })
+                {
+                    std::string text(length, 'a');
+                    if(position < length)
+                    {
+                        text[position] = match;
+                    }
+
+                    const std::string_view view = text;
+                    EXPECT_EQ(TextScanner::FindNewline(view), view.find_first_of("\r\n"));
+                    EXPECT_EQ(TextScanner::FindWhitespace(view), view.find_first_of(" \t"));
+                    EXPECT_EQ(TextScanner::FindWhitespaceOr(view, '/'), view.find_first_of(" \t/"));
+                    EXPECT_EQ(TextScanner::FindCharacter(view, '#'), view.find('#'));
+
+                    std::string whitespace(length, ' ');
+                    if(position < length)
+                    {
+                        whitespace[position] = match;
+                    }
+
+                    const std::string_view whitespaceView = whitespace;
+                    EXPECT_EQ(TextScanner::FindNonWhitespace(whitespaceView), whitespaceView.find_first_not_of(" \t"));
+                }
+            }
+        }
+    }
+
+    TEST(Utility, TextScanner_Tokens)
+    {
+        std::string_view text = "  \t v  1.0\t-2.5 3   ";
+
+        EXPECT_EQ(TextScanner::NextToken(text), "v");
+        EXPECT_EQ(TextScanner::NextToken(text), "1.0");
+        EXPECT_EQ(TextScanner::NextToken(text), "-2.5");
+        EXPECT_EQ(TextScanner::NextToken(text), "3");
+        EXPECT_TRUE(TextScanner::NextToken(text).empty());
+        EXPECT_TRUE(text.empty());
+
+        std::string_view longText = "                                        token                                        ";
+        TextScanner::TrimWhitespaceFront(longText);
+        EXPECT_EQ(longText.substr(0, 5), "token");
+
+        std::string_view onlyWhitespace = "                                        ";
+        TextScanner::TrimWhitespaceFront(onlyWhitespace);
+        EXPECT_TRUE(onlyWhitespace.empty());
+    }
+
+    TEST(Utility, TextScanner_StripComment)
+    {
+        EXPECT_EQ(TextScanner::StripComment("v 1 2 3 # Comment"), "v 1 2 3");
+        EXPECT_EQ(TextScanner::StripComment("v 1 2 3\t#"), "v 1 2 3");
+        EXPECT_EQ(TextScanner::StripComment("v 1 2 3"), "v 1 2 3");
+        EXPECT_EQ(TextScanner::StripComment("# Comment"), "");
+        EXPECT_EQ(TextScanner::StripComment("v 1 2 3 ; Comment", ';'), "v 1 2 3");
+    }
+
+}